@@ -175,6 +175,28 @@ static eFrameProcessingResult_t prvProcessIPPacket( const IPPacket_t * pxIPPacke
  */
 static void prvHandleEthernetPacket( NetworkBufferDescriptor_t * pxBuffer );
 
+#if ( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigRX_BATCH_BUDGET != 0 ) )
+
+/*
+ * Process at most 'ipconfigRX_BATCH_BUDGET' packets from the RX backlog.
+ */
+    static void prvProcessRxBacklog( void );
+
+/*
+ * Release the packets in the RX backlog that were received by an interface
+ * that goes down.
+ */
+    static void prvFlushRxBacklog( const NetworkInterface_t * pxInterface );
+#endif
+
+#if ( ipconfigSUPPORT_UDP_MULTI_MESSAGES == 1 )
+
+/*
+ * Handle the 'eStackTxChainEvent': send a chain of UDP packets.
+ */
+    static void prvProcessGeneratedUDPChain( NetworkBufferDescriptor_t * pxBuffer );
+#endif
+
 /* Handle the 'eNetworkTxEvent': forward a packet from an application to the NIC. */
 static void prvForwardTxPacket( NetworkBufferDescriptor_t * pxNetworkBuffer,
                                 BaseType_t xReleaseAfterSend );
@@ -198,6 +220,16 @@ const MACAddress_t xBroadcastMACAddress = { { 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
  * full. */
 static volatile BaseType_t xNetworkDownEventPending = pdFALSE;
 
+#if ( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigRX_BATCH_BUDGET != 0 ) )
+
+/** @brief Received packets that were not yet processed because the RX budget
+ * of an iteration of the IP-task was used up. */
+    static NetworkBufferDescriptor_t * pxRxBacklogHead = NULL;
+
+/** @brief The last packet in the RX backlog. */
+    static NetworkBufferDescriptor_t * pxRxBacklogTail = NULL;
+#endif
+
 /** @brief Stores the handle of the task that handles the stack.  The handle is used
  * (indirectly) by some utility function to determine if the utility function is
  * being called by a task (in which case it is ok to block) or by the IP task
@@ -268,6 +300,16 @@ static void prvProcessIPEventsAndTimers( void )
     /* Calculate the acceptable maximum sleep time. */
     xNextIPSleep = xCalculateSleepTime();
 
+    #if ( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigRX_BATCH_BUDGET != 0 ) )
+    {
+        if( pxRxBacklogHead != NULL )
+        {
+            /* There are still received packets waiting, do not block. */
+            xNextIPSleep = 0U;
+        }
+    }
+    #endif
+
     /* Wait until there is something to do. If the following call exits
      * due to a time out rather than a message being received, set a
      * 'NoEvent' value. */
@@ -297,6 +339,12 @@ static void prvProcessIPEventsAndTimers( void )
     switch( xReceivedEvent.eEventType )
     {
         case eNetworkDownEvent:
+            #if ( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigRX_BATCH_BUDGET != 0 ) )
+            {
+                prvFlushRxBacklog( ( ( NetworkInterface_t * ) xReceivedEvent.pvData ) );
+            }
+            #endif
+
             /* Attempt to establish a connection. */
             prvProcessNetworkDownEvent( ( ( NetworkInterface_t * ) xReceivedEvent.pvData ) );
             break;
@@ -394,6 +442,40 @@ static void prvProcessIPEventsAndTimers( void )
             vProcessGeneratedUDPPacket( ( NetworkBufferDescriptor_t * ) xReceivedEvent.pvData );
             break;
 
+        case eStackTxChainEvent:
+
+            /* FreeRTOS_sendto_multi() has generated a chain of packets to
+             * send. */
+            #if ( ipconfigSUPPORT_UDP_MULTI_MESSAGES == 1 )
+            {
+                prvProcessGeneratedUDPChain( ( NetworkBufferDescriptor_t * ) xReceivedEvent.pvData );
+            }
+            #endif /* ipconfigSUPPORT_UDP_MULTI_MESSAGES == 1 */
+            break;
+
+        case eStackTxSegmentsEvent:
+
+            /* FreeRTOS_sendto() has split a large buffer in a chain of
+             * packets for the same destination. */
+            #if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+            {
+                vProcessGeneratedUDPSegments( ( NetworkBufferDescriptor_t * ) xReceivedEvent.pvData );
+            }
+            #endif /* ipconfigUSE_UDP_SEGMENTATION == 1 */
+            break;
+
+        case eTCPHashUpdateEvent:
+
+            /* A user task has changed the state of a TCP socket, e.g. in
+             * FreeRTOS_listen() or FreeRTOS_connect().  The hash tables are
+             * only modified by the IP-task. */
+            #if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) )
+            {
+                vTCPSocketHashUpdate( ( FreeRTOS_Socket_t * ) xReceivedEvent.pvData );
+            }
+            #endif
+            break;
+
         case eDHCPEvent:
             prvCallDHCP_RA_Handler( ( ( NetworkEndPoint_t * ) xReceivedEvent.pvData ) );
             break;
@@ -473,6 +555,24 @@ static void prvProcessIPEventsAndTimers( void )
             #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
             break;
 
+        case eEventPollWaitEvent:
+            #if ( ipconfigSUPPORT_EVENT_POLL == 1 )
+            {
+                /* FreeRTOS_EventPollWait() waits until the ready sockets are
+                 * collected. */
+                vSocketEventPollCollect( ( EventPollMessage_t * ) xReceivedEvent.pvData );
+            }
+            #endif /* ipconfigSUPPORT_EVENT_POLL == 1 */
+            break;
+
+        case eEventPollDeleteEvent:
+            #if ( ipconfigSUPPORT_EVENT_POLL == 1 )
+            {
+                vSocketEventPollDelete( ( EventPollSet_t * ) xReceivedEvent.pvData );
+            }
+            #endif /* ipconfigSUPPORT_EVENT_POLL == 1 */
+            break;
+
         case eNoEvent:
             /* xQueueReceive() returned because of a normal time-out. */
             break;
@@ -482,6 +582,12 @@ static void prvProcessIPEventsAndTimers( void )
             break;
     }
 
+    #if ( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigRX_BATCH_BUDGET != 0 ) )
+    {
+        prvProcessRxBacklog();
+    }
+    #endif
+
     prvIPTask_CheckPendingEvents();
 }
 
@@ -570,6 +676,12 @@ static void prvIPTask_CheckPendingEvents( void )
         {
             if( pxInterface->bits.bCallDownEvent != pdFALSE_UNSIGNED )
             {
+                #if ( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigRX_BATCH_BUDGET != 0 ) )
+                {
+                    prvFlushRxBacklog( pxInterface );
+                }
+                #endif
+
                 prvProcessNetworkDownEvent( pxInterface );
                 pxInterface->bits.bCallDownEvent = pdFALSE_UNSIGNED;
             }
@@ -704,6 +816,30 @@ static void prvHandleEthernetPacket( NetworkBufferDescriptor_t * pxBuffer )
             prvProcessEthernetPacket( pxBuffer );
         }
     }
+    #elif ( ipconfigRX_BATCH_BUDGET != 0 )
+    {
+        /* The chain is appended to the RX backlog. prvProcessRxBacklog() will
+         * process it in portions of at most 'ipconfigRX_BATCH_BUDGET'
+         * packets, so that timers and other events are not starved. */
+        if( pxBuffer != NULL )
+        {
+            if( pxRxBacklogHead == NULL )
+            {
+                pxRxBacklogHead = pxBuffer;
+            }
+            else
+            {
+                pxRxBacklogTail->pxNextBuffer = pxBuffer;
+            }
+
+            while( pxBuffer->pxNextBuffer != NULL )
+            {
+                pxBuffer = pxBuffer->pxNextBuffer;
+            }
+
+            pxRxBacklogTail = pxBuffer;
+        }
+    }
     #else /* ipconfigUSE_LINKED_RX_MESSAGES */
     {
         NetworkBufferDescriptor_t * pxNextBuffer;
@@ -732,6 +868,108 @@ static void prvHandleEthernetPacket( NetworkBufferDescriptor_t * pxBuffer )
 }
 /*-----------------------------------------------------------*/
 
+#if ( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigRX_BATCH_BUDGET != 0 ) )
+
+/**
+ * @brief Process at most 'ipconfigRX_BATCH_BUDGET' packets from the RX backlog.
+ *        Packets that do not fit in the budget stay in the backlog until the
+ *        next iteration of the IP-task.
+ */
+    static void prvProcessRxBacklog( void )
+    {
+        NetworkBufferDescriptor_t * pxBuffer;
+        UBaseType_t uxBudget = ( UBaseType_t ) ipconfigRX_BATCH_BUDGET;
+
+        while( ( pxRxBacklogHead != NULL ) && ( uxBudget > 0U ) )
+        {
+            pxBuffer = pxRxBacklogHead;
+            pxRxBacklogHead = pxBuffer->pxNextBuffer;
+
+            if( pxRxBacklogHead == NULL )
+            {
+                pxRxBacklogTail = NULL;
+            }
+
+            /* Make it NULL to avoid using it later on. */
+            pxBuffer->pxNextBuffer = NULL;
+
+            prvProcessEthernetPacket( pxBuffer );
+            uxBudget--;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Release the packets in the RX backlog that were received by an
+ *        interface that goes down.  They would otherwise be processed after
+ *        the interface has been re-initialised, or hold their network buffers
+ *        for as long as the interface stays down.  Packets of other
+ *        interfaces stay in the backlog, in the same order.
+ *
+ * @param[in] pxInterface The interface that goes down.
+ */
+    static void prvFlushRxBacklog( const NetworkInterface_t * pxInterface )
+    {
+        NetworkBufferDescriptor_t * pxBuffer = pxRxBacklogHead;
+        NetworkBufferDescriptor_t * pxNextBuffer;
+
+        pxRxBacklogHead = NULL;
+        pxRxBacklogTail = NULL;
+
+        while( pxBuffer != NULL )
+        {
+            pxNextBuffer = pxBuffer->pxNextBuffer;
+            pxBuffer->pxNextBuffer = NULL;
+
+            if( pxBuffer->pxInterface == pxInterface )
+            {
+                vReleaseNetworkBufferAndDescriptor( pxBuffer );
+            }
+            else
+            {
+                if( pxRxBacklogHead == NULL )
+                {
+                    pxRxBacklogHead = pxBuffer;
+                }
+                else
+                {
+                    pxRxBacklogTail->pxNextBuffer = pxBuffer;
+                }
+
+                pxRxBacklogTail = pxBuffer;
+            }
+
+            pxBuffer = pxNextBuffer;
+        }
+    }
+#endif /* ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) && ( ipconfigRX_BATCH_BUDGET != 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigSUPPORT_UDP_MULTI_MESSAGES == 1 )
+
+/**
+ * @brief Send the UDP packets that were passed by FreeRTOS_sendto_multi().
+ *
+ * @param[in] pxBuffer The first packet of a chain linked through 'pxNextBuffer'.
+ */
+    static void prvProcessGeneratedUDPChain( NetworkBufferDescriptor_t * pxBuffer )
+    {
+        NetworkBufferDescriptor_t * pxNextBuffer;
+
+        while( pxBuffer != NULL )
+        {
+            pxNextBuffer = pxBuffer->pxNextBuffer;
+
+            /* Make it NULL to avoid using it later on. */
+            pxBuffer->pxNextBuffer = NULL;
+
+            vProcessGeneratedUDPPacket( pxBuffer );
+            pxBuffer = pxNextBuffer;
+        }
+    }
+#endif /* ipconfigSUPPORT_UDP_MULTI_MESSAGES == 1 */
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Send a network packet.
  *
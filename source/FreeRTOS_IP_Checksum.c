@@ -0,0 +1,706 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_IP_Checksum.c
+ * @brief Implements usGenerateChecksum() and usCopyAndChecksum() with SSE2, AVX2
+ *        or NEON instructions, when ipconfigUSE_CHECKSUM_SIMD is enabled.
+ *
+ * The one's complement sum of 16-bit words does not depend on the byte order
+ * in which the words are added (RFC 1071), so the kernels add the words in
+ * the byte order of the host, using unaligned loads. The 16-bit words are
+ * widened to 32-bit lanes, and the lanes are added to a 64-bit sum after at
+ * most ipCHECKSUM_BLOCK_SIZE bytes, long before a lane can overflow.
+ *
+ * The copy kernels store each vector right after loading it, so that the
+ * data is read from memory only once.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_IP_Checksum.h"
+
+#if ( ipconfigUSE_CHECKSUM_SIMD == 1 )
+
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+        #include <immintrin.h>
+    #endif
+
+    #if ( ipCHECKSUM_HAS_NEON == 1 )
+        #include <arm_neon.h>
+    #endif
+
+/** @brief The number of bytes that is summed in the 32-bit lanes, before they are
+ *         added to the 64-bit sum.  Each lane receives 2 words per 16 bytes, so
+ *         the largest lane value is 2 * 0xffff * ( ipCHECKSUM_BLOCK_SIZE / 16 ). */
+    #define ipCHECKSUM_BLOCK_SIZE    ( 65536U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Add the remaining bytes that did not fill a vector.
+ */
+    static uint64_t prvChecksumTail( uint64_t ullSum,
+                                     const uint8_t * pucData,
+                                     size_t uxLength );
+
+/*
+ * Copy and add the remaining bytes that did not fill a vector.
+ */
+    static uint64_t prvCopyChecksumTail( uint64_t ullSum,
+                                         uint8_t * pucDestination,
+                                         const uint8_t * pucSource,
+                                         size_t uxLength );
+
+/*
+ * Fold a 64-bit sum of 16-bit words into 16 bits.
+ */
+    static uint32_t prvChecksumFold( uint64_t ullSum );
+
+/*
+ * Choose the fastest kernel that the CPU supports.
+ */
+    static ChecksumKernel_t prvChecksumSelectKernel( void );
+
+/*
+ * Choose the fastest copy kernel that the CPU supports.
+ */
+    static ChecksumCopyKernel_t prvChecksumSelectCopyKernel( void );
+
+/*-----------------------------------------------------------*/
+
+/** @brief The kernel used by usGenerateChecksum(), selected at the first call. */
+    static ChecksumKernel_t pxSelectedKernel = NULL;
+
+/** @brief Becomes pdTRUE once 'pxSelectedKernel' has been selected. */
+    static BaseType_t xKernelSelected = pdFALSE;
+
+/** @brief The kernel used by usCopyAndChecksum(), selected at the first call. */
+    static ChecksumCopyKernel_t pxSelectedCopyKernel = NULL;
+
+/** @brief Becomes pdTRUE once 'pxSelectedCopyKernel' has been selected. */
+    static BaseType_t xCopyKernelSelected = pdFALSE;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add 16-bit words in host byte order, one at a time.
+ *
+ * @param[in] ullSum The sum so far.
+ * @param[in] pucData The data.
+ * @param[in] uxLength The number of bytes.
+ *
+ * @return The new sum, not folded.
+ */
+    static uint64_t prvChecksumTail( uint64_t ullSum,
+                                     const uint8_t * pucData,
+                                     size_t uxLength )
+    {
+        uint64_t ullResult = ullSum;
+        uint16_t usWord;
+        uint8_t ucLast[ 2 ];
+        size_t uxIndex;
+
+        for( uxIndex = 0U; ( uxIndex + 1U ) < uxLength; uxIndex += 2U )
+        {
+            ( void ) memcpy( &( usWord ), &( pucData[ uxIndex ] ), sizeof( usWord ) );
+            ullResult += usWord;
+        }
+
+        if( ( uxLength & 1U ) != 0U )
+        {
+            /* The last byte is padded with a zero byte. */
+            ucLast[ 0 ] = pucData[ uxLength - 1U ];
+            ucLast[ 1 ] = 0U;
+            ( void ) memcpy( &( usWord ), ucLast, sizeof( usWord ) );
+            ullResult += usWord;
+        }
+
+        return ullResult;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Copy and add the last bytes, see prvChecksumTail().
+ *
+ * @param[in] ullSum The sum so far.
+ * @param[out] pucDestination Where the bytes are copied to.
+ * @param[in] pucSource The data.
+ * @param[in] uxLength The number of bytes.
+ *
+ * @return The new sum, not folded.
+ */
+    static uint64_t prvCopyChecksumTail( uint64_t ullSum,
+                                         uint8_t * pucDestination,
+                                         const uint8_t * pucSource,
+                                         size_t uxLength )
+    {
+        /* Less than a vector is left, it is still in the cache. */
+        ( void ) memcpy( pucDestination, pucSource, uxLength );
+
+        return prvChecksumTail( ullSum, pucDestination, uxLength );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Fold a sum of 16-bit words, adding the carries.
+ *
+ * @param[in] ullSum The sum.
+ *
+ * @return The one's complement sum in 16 bits.
+ */
+    static uint32_t prvChecksumFold( uint64_t ullSum )
+    {
+        uint64_t ullResult = ullSum;
+
+        while( ( ullResult >> 16 ) != 0U )
+        {
+            ullResult = ( ullResult & 0xffffU ) + ( ullResult >> 16 );
+        }
+
+        return ( uint32_t ) ullResult;
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+
+/**
+ * @brief Calculate the checksum with 128-bit SSE2 instructions.
+ *
+ * @param[in] ulSum The initial sum, in host byte order.
+ * @param[in] pucData The data.
+ * @param[in] uxLength The number of bytes.
+ *
+ * @return The sum, folded to 16 bits, in host byte order.
+ */
+        uint32_t ulChecksumSSE2( uint32_t ulSum,
+                                 const uint8_t * pucData,
+                                 size_t uxLength )
+        {
+            uint64_t ullSum = ulSum;
+            size_t uxOffset = 0U;
+            size_t uxBlockEnd;
+            uint32_t ulLanes[ 4 ];
+            const __m128i xZero = _mm_setzero_si128();
+            __m128i xAccumulator;
+            __m128i xData;
+
+            while( ( uxLength - uxOffset ) >= 16U )
+            {
+                uxBlockEnd = uxOffset + ( ( uxLength - uxOffset ) & ~( ( size_t ) 15U ) );
+
+                if( ( uxBlockEnd - uxOffset ) > ipCHECKSUM_BLOCK_SIZE )
+                {
+                    uxBlockEnd = uxOffset + ipCHECKSUM_BLOCK_SIZE;
+                }
+
+                xAccumulator = xZero;
+
+                for( ; uxOffset < uxBlockEnd; uxOffset += 16U )
+                {
+                    xData = _mm_loadu_si128( ( const __m128i * ) &( pucData[ uxOffset ] ) );
+                    xAccumulator = _mm_add_epi32( xAccumulator, _mm_unpacklo_epi16( xData, xZero ) );
+                    xAccumulator = _mm_add_epi32( xAccumulator, _mm_unpackhi_epi16( xData, xZero ) );
+                }
+
+                _mm_storeu_si128( ( __m128i * ) ulLanes, xAccumulator );
+                ullSum += ( uint64_t ) ulLanes[ 0 ] + ulLanes[ 1 ] + ulLanes[ 2 ] + ulLanes[ 3 ];
+            }
+
+            ullSum = prvChecksumTail( ullSum, &( pucData[ uxOffset ] ), uxLength - uxOffset );
+
+            return prvChecksumFold( ullSum );
+        }
+    #endif /* ipCHECKSUM_HAS_X86_64 == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+
+/**
+ * @brief Copy data and calculate its checksum with 128-bit SSE2 instructions.
+ *
+ * @param[in] ulSum The initial sum, in host byte order.
+ * @param[out] pucDestination Where the data is copied to.
+ * @param[in] pucSource The data.
+ * @param[in] uxLength The number of bytes.
+ *
+ * @return The sum, folded to 16 bits, in host byte order.
+ */
+        uint32_t ulCopyChecksumSSE2( uint32_t ulSum,
+                                     uint8_t * pucDestination,
+                                     const uint8_t * pucSource,
+                                     size_t uxLength )
+        {
+            uint64_t ullSum = ulSum;
+            size_t uxOffset = 0U;
+            size_t uxBlockEnd;
+            uint32_t ulLanes[ 4 ];
+            const __m128i xZero = _mm_setzero_si128();
+            __m128i xAccumulator;
+            __m128i xData;
+
+            while( ( uxLength - uxOffset ) >= 16U )
+            {
+                uxBlockEnd = uxOffset + ( ( uxLength - uxOffset ) & ~( ( size_t ) 15U ) );
+
+                if( ( uxBlockEnd - uxOffset ) > ipCHECKSUM_BLOCK_SIZE )
+                {
+                    uxBlockEnd = uxOffset + ipCHECKSUM_BLOCK_SIZE;
+                }
+
+                xAccumulator = xZero;
+
+                for( ; uxOffset < uxBlockEnd; uxOffset += 16U )
+                {
+                    xData = _mm_loadu_si128( ( const __m128i * ) &( pucSource[ uxOffset ] ) );
+                    _mm_storeu_si128( ( __m128i * ) &( pucDestination[ uxOffset ] ), xData );
+                    xAccumulator = _mm_add_epi32( xAccumulator, _mm_unpacklo_epi16( xData, xZero ) );
+                    xAccumulator = _mm_add_epi32( xAccumulator, _mm_unpackhi_epi16( xData, xZero ) );
+                }
+
+                _mm_storeu_si128( ( __m128i * ) ulLanes, xAccumulator );
+                ullSum += ( uint64_t ) ulLanes[ 0 ] + ulLanes[ 1 ] + ulLanes[ 2 ] + ulLanes[ 3 ];
+            }
+
+            ullSum = prvCopyChecksumTail( ullSum, &( pucDestination[ uxOffset ] ), &( pucSource[ uxOffset ] ), uxLength - uxOffset );
+
+            return prvChecksumFold( ullSum );
+        }
+    #endif /* ipCHECKSUM_HAS_X86_64 == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+
+/**
+ * @brief Calculate the checksum with 256-bit AVX2 instructions. Only call it
+ *        when xChecksumHasAVX2() returns pdTRUE.
+ *
+ * @param[in] ulSum The initial sum, in host byte order.
+ * @param[in] pucData The data.
+ * @param[in] uxLength The number of bytes.
+ *
+ * @return The sum, folded to 16 bits, in host byte order.
+ */
+        __attribute__( ( target( "avx2" ) ) )
+        uint32_t ulChecksumAVX2( uint32_t ulSum,
+                                 const uint8_t * pucData,
+                                 size_t uxLength )
+        {
+            uint64_t ullSum = ulSum;
+            size_t uxOffset = 0U;
+            size_t uxBlockEnd;
+            uint32_t ulLanes[ 8 ];
+            const __m256i xZero = _mm256_setzero_si256();
+            __m256i xAccumulator;
+            __m256i xData;
+
+            while( ( uxLength - uxOffset ) >= 32U )
+            {
+                uxBlockEnd = uxOffset + ( ( uxLength - uxOffset ) & ~( ( size_t ) 31U ) );
+
+                if( ( uxBlockEnd - uxOffset ) > ipCHECKSUM_BLOCK_SIZE )
+                {
+                    uxBlockEnd = uxOffset + ipCHECKSUM_BLOCK_SIZE;
+                }
+
+                xAccumulator = xZero;
+
+                for( ; uxOffset < uxBlockEnd; uxOffset += 32U )
+                {
+                    xData = _mm256_loadu_si256( ( const __m256i * ) &( pucData[ uxOffset ] ) );
+                    xAccumulator = _mm256_add_epi32( xAccumulator, _mm256_unpacklo_epi16( xData, xZero ) );
+                    xAccumulator = _mm256_add_epi32( xAccumulator, _mm256_unpackhi_epi16( xData, xZero ) );
+                }
+
+                _mm256_storeu_si256( ( __m256i * ) ulLanes, xAccumulator );
+                ullSum += ( uint64_t ) ulLanes[ 0 ] + ulLanes[ 1 ] + ulLanes[ 2 ] + ulLanes[ 3 ] +
+                          ulLanes[ 4 ] + ulLanes[ 5 ] + ulLanes[ 6 ] + ulLanes[ 7 ];
+            }
+
+            /* Less than 32 bytes are left.  Calling ulChecksumSSE2() here would
+             * mix AVX and legacy SSE instructions, which is slow on many CPUs. */
+            ullSum = prvChecksumTail( ullSum, &( pucData[ uxOffset ] ), uxLength - uxOffset );
+
+            return prvChecksumFold( ullSum );
+        }
+    #endif /* ipCHECKSUM_HAS_X86_64 == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+
+/**
+ * @brief Copy data and calculate its checksum with 256-bit AVX2 instructions.
+ *        Only call it when xChecksumHasAVX2() returns pdTRUE.
+ *
+ * @param[in] ulSum The initial sum, in host byte order.
+ * @param[out] pucDestination Where the data is copied to.
+ * @param[in] pucSource The data.
+ * @param[in] uxLength The number of bytes.
+ *
+ * @return The sum, folded to 16 bits, in host byte order.
+ */
+        __attribute__( ( target( "avx2" ) ) )
+        uint32_t ulCopyChecksumAVX2( uint32_t ulSum,
+                                     uint8_t * pucDestination,
+                                     const uint8_t * pucSource,
+                                     size_t uxLength )
+        {
+            uint64_t ullSum = ulSum;
+            size_t uxOffset = 0U;
+            size_t uxBlockEnd;
+            uint32_t ulLanes[ 8 ];
+            const __m256i xZero = _mm256_setzero_si256();
+            __m256i xAccumulator;
+            __m256i xData;
+
+            while( ( uxLength - uxOffset ) >= 32U )
+            {
+                uxBlockEnd = uxOffset + ( ( uxLength - uxOffset ) & ~( ( size_t ) 31U ) );
+
+                if( ( uxBlockEnd - uxOffset ) > ipCHECKSUM_BLOCK_SIZE )
+                {
+                    uxBlockEnd = uxOffset + ipCHECKSUM_BLOCK_SIZE;
+                }
+
+                xAccumulator = xZero;
+
+                for( ; uxOffset < uxBlockEnd; uxOffset += 32U )
+                {
+                    xData = _mm256_loadu_si256( ( const __m256i * ) &( pucSource[ uxOffset ] ) );
+                    _mm256_storeu_si256( ( __m256i * ) &( pucDestination[ uxOffset ] ), xData );
+                    xAccumulator = _mm256_add_epi32( xAccumulator, _mm256_unpacklo_epi16( xData, xZero ) );
+                    xAccumulator = _mm256_add_epi32( xAccumulator, _mm256_unpackhi_epi16( xData, xZero ) );
+                }
+
+                _mm256_storeu_si256( ( __m256i * ) ulLanes, xAccumulator );
+                ullSum += ( uint64_t ) ulLanes[ 0 ] + ulLanes[ 1 ] + ulLanes[ 2 ] + ulLanes[ 3 ] +
+                          ulLanes[ 4 ] + ulLanes[ 5 ] + ulLanes[ 6 ] + ulLanes[ 7 ];
+            }
+
+            ullSum = prvCopyChecksumTail( ullSum, &( pucDestination[ uxOffset ] ), &( pucSource[ uxOffset ] ), uxLength - uxOffset );
+
+            return prvChecksumFold( ullSum );
+        }
+    #endif /* ipCHECKSUM_HAS_X86_64 == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+
+/**
+ * @brief Check if the CPU supports AVX2 instructions.
+ *
+ * @return pdTRUE when AVX2 can be used.
+ */
+        BaseType_t xChecksumHasAVX2( void )
+        {
+            BaseType_t xReturn = pdFALSE;
+
+            __builtin_cpu_init();
+
+            if( __builtin_cpu_supports( "avx2" ) != 0 )
+            {
+                xReturn = pdTRUE;
+            }
+
+            return xReturn;
+        }
+    #endif /* ipCHECKSUM_HAS_X86_64 == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipCHECKSUM_HAS_NEON == 1 )
+
+/**
+ * @brief Calculate the checksum with 128-bit NEON instructions.
+ *
+ * @param[in] ulSum The initial sum, in host byte order.
+ * @param[in] pucData The data.
+ * @param[in] uxLength The number of bytes.
+ *
+ * @return The sum, folded to 16 bits, in host byte order.
+ */
+        uint32_t ulChecksumNEON( uint32_t ulSum,
+                                 const uint8_t * pucData,
+                                 size_t uxLength )
+        {
+            uint64_t ullSum = ulSum;
+            size_t uxOffset = 0U;
+            size_t uxBlockEnd;
+            uint32x4_t xAccumulator;
+
+            while( ( uxLength - uxOffset ) >= 16U )
+            {
+                uxBlockEnd = uxOffset + ( ( uxLength - uxOffset ) & ~( ( size_t ) 15U ) );
+
+                if( ( uxBlockEnd - uxOffset ) > ipCHECKSUM_BLOCK_SIZE )
+                {
+                    uxBlockEnd = uxOffset + ipCHECKSUM_BLOCK_SIZE;
+                }
+
+                xAccumulator = vdupq_n_u32( 0U );
+
+                for( ; uxOffset < uxBlockEnd; uxOffset += 16U )
+                {
+                    /* Add pairs of adjacent 16-bit words to the 32-bit lanes. */
+                    xAccumulator = vpadalq_u16( xAccumulator, vreinterpretq_u16_u8( vld1q_u8( &( pucData[ uxOffset ] ) ) ) );
+                }
+
+                ullSum += vaddlvq_u32( xAccumulator );
+            }
+
+            ullSum = prvChecksumTail( ullSum, &( pucData[ uxOffset ] ), uxLength - uxOffset );
+
+            return prvChecksumFold( ullSum );
+        }
+    #endif /* ipCHECKSUM_HAS_NEON == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipCHECKSUM_HAS_NEON == 1 )
+
+/**
+ * @brief Copy data and calculate its checksum with 128-bit NEON instructions.
+ *
+ * @param[in] ulSum The initial sum, in host byte order.
+ * @param[out] pucDestination Where the data is copied to.
+ * @param[in] pucSource The data.
+ * @param[in] uxLength The number of bytes.
+ *
+ * @return The sum, folded to 16 bits, in host byte order.
+ */
+        uint32_t ulCopyChecksumNEON( uint32_t ulSum,
+                                     uint8_t * pucDestination,
+                                     const uint8_t * pucSource,
+                                     size_t uxLength )
+        {
+            uint64_t ullSum = ulSum;
+            size_t uxOffset = 0U;
+            size_t uxBlockEnd;
+            uint32x4_t xAccumulator;
+            uint8x16_t xData;
+
+            while( ( uxLength - uxOffset ) >= 16U )
+            {
+                uxBlockEnd = uxOffset + ( ( uxLength - uxOffset ) & ~( ( size_t ) 15U ) );
+
+                if( ( uxBlockEnd - uxOffset ) > ipCHECKSUM_BLOCK_SIZE )
+                {
+                    uxBlockEnd = uxOffset + ipCHECKSUM_BLOCK_SIZE;
+                }
+
+                xAccumulator = vdupq_n_u32( 0U );
+
+                for( ; uxOffset < uxBlockEnd; uxOffset += 16U )
+                {
+                    xData = vld1q_u8( &( pucSource[ uxOffset ] ) );
+                    vst1q_u8( &( pucDestination[ uxOffset ] ), xData );
+                    xAccumulator = vpadalq_u16( xAccumulator, vreinterpretq_u16_u8( xData ) );
+                }
+
+                ullSum += vaddlvq_u32( xAccumulator );
+            }
+
+            ullSum = prvCopyChecksumTail( ullSum, &( pucDestination[ uxOffset ] ), &( pucSource[ uxOffset ] ), uxLength - uxOffset );
+
+            return prvChecksumFold( ullSum );
+        }
+    #endif /* ipCHECKSUM_HAS_NEON == 1 */
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Choose the fastest kernel that can be used on this CPU.
+ *
+ * @return The kernel, or NULL when the portable implementation must be used.
+ */
+    static ChecksumKernel_t prvChecksumSelectKernel( void )
+    {
+        ChecksumKernel_t pxKernel = NULL;
+
+        #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+        {
+            if( xChecksumHasAVX2() != pdFALSE )
+            {
+                pxKernel = ulChecksumAVX2;
+            }
+            else
+            {
+                pxKernel = ulChecksumSSE2;
+            }
+        }
+        #elif ( ipCHECKSUM_HAS_NEON == 1 )
+        {
+            pxKernel = ulChecksumNEON;
+        }
+        #endif
+
+        return pxKernel;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Choose the fastest copy kernel that can be used on this CPU.
+ *
+ * @return The kernel, or NULL when the portable implementation must be used.
+ */
+    static ChecksumCopyKernel_t prvChecksumSelectCopyKernel( void )
+    {
+        ChecksumCopyKernel_t pxKernel = NULL;
+
+        #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+        {
+            if( xChecksumHasAVX2() != pdFALSE )
+            {
+                pxKernel = ulCopyChecksumAVX2;
+            }
+            else
+            {
+                pxKernel = ulCopyChecksumSSE2;
+            }
+        }
+        #elif ( ipCHECKSUM_HAS_NEON == 1 )
+        {
+            pxKernel = ulCopyChecksumNEON;
+        }
+        #endif
+
+        return pxKernel;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the kernel that is used by usGenerateChecksum().
+ *
+ * @return The kernel, or NULL when the portable implementation is used.
+ */
+    ChecksumKernel_t pxChecksumGetKernel( void )
+    {
+        /* Several tasks may get here at the same time, but they will all
+         * store the same value. */
+        if( xKernelSelected == pdFALSE )
+        {
+            pxSelectedKernel = prvChecksumSelectKernel();
+            xKernelSelected = pdTRUE;
+        }
+
+        return pxSelectedKernel;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the kernel that is used by usCopyAndChecksum().
+ *
+ * @return The kernel, or NULL when the portable implementation is used.
+ */
+    ChecksumCopyKernel_t pxChecksumGetCopyKernel( void )
+    {
+        if( xCopyKernelSelected == pdFALSE )
+        {
+            pxSelectedCopyKernel = prvChecksumSelectCopyKernel();
+            xCopyKernelSelected = pdTRUE;
+        }
+
+        return pxSelectedCopyKernel;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Calculates the 16-bit checksum of an array of bytes, using the fastest
+ *        implementation that is available.
+ *
+ * @param[in] usSum The initial sum, obtained from earlier data.
+ * @param[in] pucNextData The actual data.
+ * @param[in] uxByteCount The number of bytes.
+ *
+ * @return The 16-bit one's complement of the one's complement sum of all 16-bit
+ *         words in the header
+ */
+    uint16_t usGenerateChecksum( uint16_t usSum,
+                                 const uint8_t * pucNextData,
+                                 size_t uxByteCount )
+    {
+        uint16_t usResult;
+        uint32_t ulSum;
+        ChecksumKernel_t pxKernel = pxChecksumGetKernel();
+
+        if( pxKernel != NULL )
+        {
+            /* The kernels work in host byte order, like usGenerateChecksumScalar(). */
+            ulSum = ( uint32_t ) FreeRTOS_ntohs( usSum );
+            ulSum = pxKernel( ulSum, pucNextData, uxByteCount );
+            usResult = FreeRTOS_htons( ( uint16_t ) ulSum );
+        }
+        else
+        {
+            usResult = usGenerateChecksumScalar( usSum, pucNextData, uxByteCount );
+        }
+
+        return usResult;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Copy a block of data and calculate its checksum, using the fastest
+ *        implementation that is available.
+ *
+ * @param[in] usSum The initial sum, obtained from earlier data.
+ * @param[out] pucDestination Where the data is copied to.
+ * @param[in] pucSource The data.
+ * @param[in] uxByteCount The number of bytes.
+ *
+ * @return The same value as usGenerateChecksum( usSum, pucSource, uxByteCount ).
+ */
+    uint16_t usCopyAndChecksum( uint16_t usSum,
+                                uint8_t * pucDestination,
+                                const uint8_t * pucSource,
+                                size_t uxByteCount )
+    {
+        uint16_t usResult;
+        uint32_t ulSum;
+        ChecksumCopyKernel_t pxKernel = pxChecksumGetCopyKernel();
+
+        if( pxKernel != NULL )
+        {
+            ulSum = ( uint32_t ) FreeRTOS_ntohs( usSum );
+            ulSum = pxKernel( ulSum, pucDestination, pucSource, uxByteCount );
+            usResult = FreeRTOS_htons( ( uint16_t ) ulSum );
+        }
+        else
+        {
+            usResult = usCopyAndChecksumScalar( usSum, pucDestination, pucSource, uxByteCount );
+        }
+
+        return usResult;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_CHECKSUM_SIMD == 1 */
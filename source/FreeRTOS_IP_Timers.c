@@ -55,6 +55,7 @@
 #include "NetworkBufferManagement.h"
 #include "FreeRTOS_Routing.h"
 #include "FreeRTOS_DNS.h"
+#include "FreeRTOS_TCP_Time_Wait.h"
 /*-----------------------------------------------------------*/
 
 /** @brief 'xAllNetworksUp' becomes pdTRUE when all network interfaces are initialised
@@ -352,6 +353,19 @@ void vCheckNetworkTimers( void )
             /* Attend to the sockets, returning the period after which the
              * check must be repeated. */
             xNextTime = xTCPTimerCheck( xWillSleep );
+
+            #if ( ipconfigUSE_TCP_TIME_WAIT == 1 )
+            {
+                /* Closed connections may have to send their FIN again. */
+                TickType_t xTimeWaitTime = xTCPTimeWaitCheck();
+
+                if( xNextTime > xTimeWaitTime )
+                {
+                    xNextTime = xTimeWaitTime;
+                }
+            }
+            #endif
+
             prvIPTimerStart( &xTCPTimer, xNextTime );
         }
     }
@@ -55,6 +55,7 @@
 #include "NetworkBufferManagement.h"
 #include "FreeRTOS_DNS.h"
 #include "FreeRTOS_Routing.h"
+#include "FreeRTOS_IP_Checksum.h"
 /*-----------------------------------------------------------*/
 
 /* Used to ensure the structure packing is having the desired effect.  The
@@ -118,6 +119,10 @@ static NetworkBufferDescriptor_t * prvPacketBuffer_to_NetworkBuffer( const void
 
 static uintptr_t void_ptr_to_uintptr( const void * pvPointer );
 
+#if ( ipBUFFER_ROOM != 0 )
+    static void prvNetworkBufferStoreOwner( NetworkBufferDescriptor_t * pxNetworkBuffer );
+#endif
+
 static BaseType_t prvChecksumProtocolChecks( size_t uxBufferLength,
                                              struct xPacketSummary * pxSet );
 
@@ -135,6 +140,12 @@ static void prvChecksumProtocolSetChecksum( BaseType_t xOutgoingPacket,
 static void prvSetChecksumInPacket( const struct xPacketSummary * pxSet,
                                     uint16_t usChecksum );
 
+static uint16_t prvGenerateProtocolChecksum( uint8_t * pucEthernetBuffer,
+                                             size_t uxBufferLength,
+                                             BaseType_t xOutgoingPacket,
+                                             size_t uxPayloadSummed,
+                                             uint16_t usPayloadSum );
+
 static uint16_t prvGetChecksumFromPacket( const struct xPacketSummary * pxSet );
 
 /**
@@ -297,6 +308,244 @@ NetworkBufferDescriptor_t * pxDuplicateNetworkBufferWithDescriptor( const Networ
 }
 /*-----------------------------------------------------------*/
 
+#if ( ipBUFFER_ROOM != 0 )
+
+/**
+ * @brief Store a pointer to the descriptor in front of the frame, after the frame
+ *        was moved, so pxPacketBuffer_to_NetworkBuffer() keeps working.
+ *
+ * @param[in] pxNetworkBuffer The network buffer whose frame was moved.
+ */
+    static void prvNetworkBufferStoreOwner( NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        uintptr_t uxBuffer;
+
+        /* MISRA Ref 11.6.2 [Pointer arithmetic and hidden pointer] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-116 */
+        /* coverity[misra_c_2012_rule_11_6_violation] */
+        uxBuffer = void_ptr_to_uintptr( pxNetworkBuffer->pucEthernetBuffer );
+        uxBuffer -= ipBUFFER_PADDING;
+
+        /* The frame is only moved by multiples of ipNETWORK_BUFFER_ROOM_ALIGNMENT,
+         * so the pointer stays aligned. */
+
+        /* MISRA Ref 11.4.2 [Validation of pointer alignment] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-114 */
+        /* coverity[misra_c_2012_rule_11_4_violation] */
+        *( ( NetworkBufferDescriptor_t ** ) uxBuffer ) = pxNetworkBuffer;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Prepend space to the frame of a network buffer, using its headroom.
+ *
+ * @param[in] pxNetworkBuffer The network buffer.
+ * @param[in] uxLength The number of bytes to prepend.
+ *
+ * @return The new start of the frame, or NULL when the headroom is too small, or
+ *         when 'uxLength' is not a multiple of ipNETWORK_BUFFER_ROOM_ALIGNMENT.
+ */
+    uint8_t * pucNetworkBufferPush( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                    size_t uxLength )
+    {
+        uint8_t * pucReturn = NULL;
+
+        if( ( uxLength <= pxNetworkBuffer->uxHeadroom ) &&
+            ( ( uxLength % ipNETWORK_BUFFER_ROOM_ALIGNMENT ) == 0U ) )
+        {
+            /* MISRA Ref 18.4.1 [Usage of +, -, += and -= operators on expression of pointer type]. */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-184. */
+            /* coverity[misra_c_2012_rule_18_4_violation] */
+            pxNetworkBuffer->pucEthernetBuffer -= uxLength;
+            pxNetworkBuffer->uxHeadroom -= uxLength;
+            pxNetworkBuffer->uxBufferSize += uxLength;
+            pxNetworkBuffer->xDataLength += uxLength;
+
+            prvNetworkBufferStoreOwner( pxNetworkBuffer );
+            pucReturn = pxNetworkBuffer->pucEthernetBuffer;
+        }
+
+        return pucReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Remove bytes from the start of the frame of a network buffer.  They
+ *        become part of the headroom.
+ *
+ * @param[in] pxNetworkBuffer The network buffer.
+ * @param[in] uxLength The number of bytes to remove.
+ *
+ * @return The new start of the frame, or NULL when the frame is too short, or
+ *         when 'uxLength' is not a multiple of ipNETWORK_BUFFER_ROOM_ALIGNMENT.
+ */
+    uint8_t * pucNetworkBufferPull( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                    size_t uxLength )
+    {
+        uint8_t * pucReturn = NULL;
+
+        if( ( uxLength <= pxNetworkBuffer->xDataLength ) &&
+            ( ( uxLength % ipNETWORK_BUFFER_ROOM_ALIGNMENT ) == 0U ) )
+        {
+            pxNetworkBuffer->pucEthernetBuffer = &( pxNetworkBuffer->pucEthernetBuffer[ uxLength ] );
+            pxNetworkBuffer->uxHeadroom += uxLength;
+            pxNetworkBuffer->uxBufferSize -= uxLength;
+            pxNetworkBuffer->xDataLength -= uxLength;
+
+            prvNetworkBufferStoreOwner( pxNetworkBuffer );
+            pucReturn = pxNetworkBuffer->pucEthernetBuffer;
+        }
+
+        return pucReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Append space to the frame of a network buffer, using its tailroom.
+ *
+ * @param[in] pxNetworkBuffer The network buffer.
+ * @param[in] uxLength The number of bytes to append.
+ *
+ * @return A pointer to the appended bytes, or NULL when the tailroom is too small.
+ */
+    uint8_t * pucNetworkBufferPut( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                   size_t uxLength )
+    {
+        uint8_t * pucReturn = NULL;
+
+        if( uxLength <= uxNetworkBufferTailroom( pxNetworkBuffer ) )
+        {
+            pucReturn = &( pxNetworkBuffer->pucEthernetBuffer[ pxNetworkBuffer->xDataLength ] );
+            pxNetworkBuffer->xDataLength += uxLength;
+        }
+
+        return pucReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the number of bytes that can be prepended to the frame.
+ *
+ * @param[in] pxNetworkBuffer The network buffer.
+ *
+ * @return The headroom in bytes.
+ */
+    size_t uxNetworkBufferHeadroom( const NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        return pxNetworkBuffer->uxHeadroom;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Get the number of bytes that can be appended to the frame.
+ *
+ * @param[in] pxNetworkBuffer The network buffer.
+ *
+ * @return The tailroom in bytes.
+ */
+    size_t uxNetworkBufferTailroom( const NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        size_t uxReturn = 0U;
+
+        if( pxNetworkBuffer->uxBufferSize > pxNetworkBuffer->xDataLength )
+        {
+            uxReturn = pxNetworkBuffer->uxBufferSize - pxNetworkBuffer->xDataLength;
+        }
+
+        return uxReturn;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipBUFFER_ROOM != 0 */
+
+#if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+
+/**
+ * @brief Get the number of bytes that are stored in the fragments of a network
+ *        buffer.
+ *
+ * @param[in] pxNetworkBuffer The network buffer.
+ *
+ * @return The number of bytes that are sent after the Ethernet buffer.
+ */
+    size_t uxNetworkBufferFragmentBytes( const NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        size_t uxReturn = 0U;
+        UBaseType_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < pxNetworkBuffer->uxFragmentCount; uxIndex++ )
+        {
+            uxReturn += pxNetworkBuffer->xFragments[ uxIndex ].uxLength;
+        }
+
+        return uxReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Copy the fragments of a network buffer behind its Ethernet frame.
+ *
+ * @param[in] pxNetworkBuffer The network buffer.
+ *
+ * @return pdPASS when the frame is contiguous, pdFAIL when the network buffer
+ *         could not be resized. The network buffer is unchanged in that case.
+ */
+    BaseType_t xNetworkBufferLinearise( NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        BaseType_t xReturn = pdPASS;
+        size_t uxOffset = pxNetworkBuffer->xDataLength;
+        size_t uxNeeded = uxOffset + uxNetworkBufferFragmentBytes( pxNetworkBuffer );
+        UBaseType_t uxIndex;
+
+        if( pxNetworkBuffer->uxFragmentCount != 0U )
+        {
+            if( ( ipNETWORK_BUFFER_CAPACITY( pxNetworkBuffer ) < uxNeeded ) &&
+                ( pxResizeNetworkBufferWithDescriptor( pxNetworkBuffer, uxNeeded ) == NULL ) )
+            {
+                xReturn = pdFAIL;
+            }
+            else
+            {
+                for( uxIndex = 0U; uxIndex < pxNetworkBuffer->uxFragmentCount; uxIndex++ )
+                {
+                    ( void ) memcpy( &( pxNetworkBuffer->pucEthernetBuffer[ uxOffset ] ),
+                                     pxNetworkBuffer->xFragments[ uxIndex ].pucData,
+                                     pxNetworkBuffer->xFragments[ uxIndex ].uxLength );
+                    uxOffset += pxNetworkBuffer->xFragments[ uxIndex ].uxLength;
+                }
+
+                pxNetworkBuffer->xDataLength = uxNeeded;
+                vNetworkBufferReleaseFragments( pxNetworkBuffer );
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Forget the fragments of a network buffer, and release the stream
+ *        buffer in which they are stored.
+ *
+ * @param[in] pxNetworkBuffer The network buffer.
+ */
+    void vNetworkBufferReleaseFragments( NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        if( pxNetworkBuffer->uxFragmentCount != 0U )
+        {
+            pxNetworkBuffer->uxFragmentCount = 0U;
+
+            if( pxNetworkBuffer->pxFragmentStream != NULL )
+            {
+                vStreamBufferDereference( pxNetworkBuffer->pxFragmentStream );
+                pxNetworkBuffer->pxFragmentStream = NULL;
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 */
+
 /**
  * @brief Get the network buffer descriptor from the packet buffer.
  *
@@ -585,9 +834,9 @@ static void prvChecksumProtocolCalculate( BaseType_t xOutgoingPacket,
                 case pdTRUE:
                     /* The CRC of the IPv6 pseudo-header has already been calculated. */
                     pxSet->usChecksum = ( uint16_t )
-                                        ( ~usGenerateChecksum( pxSet->usChecksum,
+                                        ( ~usGenerateChecksum( usChecksumAdd( pxSet->usChecksum, pxSet->usPayloadSum ),
                                                                ( uint8_t * ) &( pxSet->pxProtocolHeaders->xUDPHeader.usSourcePort ),
-                                                               ( size_t ) ( pxSet->usProtocolBytes ) ) );
+                                                               ( size_t ) pxSet->usProtocolBytes - pxSet->uxPayloadSummed ) );
                     break;
             #endif /* ( ipconfigUSE_IPv6 != 0 ) */
 
@@ -602,6 +851,10 @@ static void prvChecksumProtocolCalculate( BaseType_t xOutgoingPacket,
                         * fields */
                        pxSet->usChecksum = ( uint16_t ) ( pxSet->usProtocolBytes + ( ( uint16_t ) pxSet->ucProtocol ) );
 
+                       /* The end of the payload might have been summed already. */
+                       pxSet->usChecksum = usChecksumAdd( pxSet->usChecksum, pxSet->usPayloadSum );
+                       ulByteCount -= ( uint32_t ) pxSet->uxPayloadSummed;
+
                        /* And then continue at the IPv4 source and destination addresses. */
                        pxSet->usChecksum = ( uint16_t )
                                            ( ~usGenerateChecksum( pxSet->usChecksum,
@@ -1088,6 +1341,51 @@ void vPreCheckConfigs( void )
 uint16_t usGenerateProtocolChecksum( uint8_t * pucEthernetBuffer,
                                      size_t uxBufferLength,
                                      BaseType_t xOutgoingPacket )
+{
+    return prvGenerateProtocolChecksum( pucEthernetBuffer, uxBufferLength, xOutgoingPacket, 0U, 0U );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Set the protocol checksum of an outgoing packet, of which the sum of
+ *        the last part of the payload is already known, for instance because
+ *        it was calculated while copying the payload with usCopyAndChecksum().
+ *
+ * @param[in] pucEthernetBuffer The Ethernet buffer for which the checksum is to be calculated.
+ * @param[in] uxBufferLength The number of bytes written in the packet buffer.
+ * @param[in] uxPayloadSummed The number of bytes at the end of the protocol
+ *                            payload that were summed already.
+ * @param[in] usPayloadSum The sum of those bytes, as returned by usGenerateChecksum().
+ *
+ * @return Either ipINVALID_LENGTH, ipUNHANDLED_PROTOCOL, or ipCORRECT_CRC.
+ */
+uint16_t usGenerateProtocolChecksumPartial( uint8_t * pucEthernetBuffer,
+                                            size_t uxBufferLength,
+                                            size_t uxPayloadSummed,
+                                            uint16_t usPayloadSum )
+{
+    return prvGenerateProtocolChecksum( pucEthernetBuffer, uxBufferLength, pdTRUE, uxPayloadSummed, usPayloadSum );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The implementation of usGenerateProtocolChecksum() and
+ *        usGenerateProtocolChecksumPartial().
+ *
+ * @param[in] pucEthernetBuffer The Ethernet buffer.
+ * @param[in] uxBufferLength The number of bytes received or written.
+ * @param[in] xOutgoingPacket Whether this is an outgoing packet or not.
+ * @param[in] uxPayloadSummed The number of bytes at the end of the payload
+ *                            that are included in 'usPayloadSum', normally 0.
+ * @param[in] usPayloadSum The sum of those bytes.
+ *
+ * @return See usGenerateProtocolChecksum().
+ */
+static uint16_t prvGenerateProtocolChecksum( uint8_t * pucEthernetBuffer,
+                                             size_t uxBufferLength,
+                                             BaseType_t xOutgoingPacket,
+                                             size_t uxPayloadSummed,
+                                             uint16_t usPayloadSum )
 {
     struct xPacketSummary xSet;
 
@@ -1199,6 +1497,14 @@ uint16_t usGenerateProtocolChecksum( uint8_t * pucEthernetBuffer,
             break;
         }
 
+        if( ( uxPayloadSummed != 0U ) &&
+            ( uxPayloadSummed <= ( ( size_t ) xSet.usProtocolBytes - xSet.uxProtocolHeaderLength ) ) )
+        {
+            /* The sum of the last part of the payload is known already. */
+            xSet.uxPayloadSummed = uxPayloadSummed;
+            xSet.usPayloadSum = usPayloadSum;
+        }
+
         /* Do the actual calculations. */
         prvChecksumProtocolCalculate( xOutgoingPacket, pucEthernetBuffer, &( xSet ) );
 
@@ -1267,9 +1573,17 @@ uint16_t usGenerateProtocolChecksum( uint8_t * pucEthernetBuffer,
  * @return The 16-bit one's complement of the one's complement sum of all 16-bit
  *         words in the header
  */
-uint16_t usGenerateChecksum( uint16_t usSum,
-                             const uint8_t * pucNextData,
-                             size_t uxByteCount )
+#if ( ipconfigUSE_CHECKSUM_SIMD == 1 )
+    /* usGenerateChecksum() is implemented in FreeRTOS_IP_Checksum.c, which
+     * falls back to this function. */
+    uint16_t usGenerateChecksumScalar( uint16_t usSum,
+                                       const uint8_t * pucNextData,
+                                       size_t uxByteCount )
+#else
+    uint16_t usGenerateChecksum( uint16_t usSum,
+                                 const uint8_t * pucNextData,
+                                 size_t uxByteCount )
+#endif
 {
 /* MISRA/PC-lint doesn't like the use of unions. Here, they are a great
  * aid though to optimise the calculations. */
@@ -1436,6 +1750,155 @@ uint16_t usGenerateChecksum( uint16_t usSum,
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Copy a block of data and calculate its checksum in the same pass, so
+ *        that each byte is read only once.
+ *
+ * @param[in] usSum The initial sum, obtained from earlier data.
+ * @param[out] pucDestination Where the data is copied to.
+ * @param[in] pucSource The data.
+ * @param[in] uxByteCount The number of bytes.
+ *
+ * @return The same value as usGenerateChecksum( usSum, pucSource, uxByteCount ).
+ */
+#if ( ipconfigUSE_CHECKSUM_SIMD == 1 )
+    /* usCopyAndChecksum() is implemented in FreeRTOS_IP_Checksum.c, which
+     * falls back to this function. */
+    uint16_t usCopyAndChecksumScalar( uint16_t usSum,
+                                      uint8_t * pucDestination,
+                                      const uint8_t * pucSource,
+                                      size_t uxByteCount )
+#else
+    uint16_t usCopyAndChecksum( uint16_t usSum,
+                                uint8_t * pucDestination,
+                                const uint8_t * pucSource,
+                                size_t uxByteCount )
+#endif
+{
+    uint32_t ulSum = ( uint32_t ) FreeRTOS_ntohs( usSum );
+    uint32_t ulWord;
+    uint16_t usWord;
+    uint8_t ucLast[ 2 ];
+    size_t uxIndex = 0U;
+
+    /* The two halves of a 32-bit word are two 16-bit words in the byte order
+     * of the host, whatever that order is. memcpy() is used for the unaligned
+     * access, the compiler turns it into plain loads and stores. */
+    while( ( uxIndex + 4U ) <= uxByteCount )
+    {
+        ( void ) memcpy( &( ulWord ), &( pucSource[ uxIndex ] ), sizeof( ulWord ) );
+        ( void ) memcpy( &( pucDestination[ uxIndex ] ), &( ulWord ), sizeof( ulWord ) );
+        ulSum += ( ulWord & 0xffffU ) + ( ulWord >> 16 );
+
+        if( ( ulSum & 0x80000000U ) != 0U )
+        {
+            ulSum = ( ulSum & 0xffffU ) + ( ulSum >> 16 );
+        }
+
+        uxIndex += 4U;
+    }
+
+    if( ( uxIndex + 2U ) <= uxByteCount )
+    {
+        ( void ) memcpy( &( usWord ), &( pucSource[ uxIndex ] ), sizeof( usWord ) );
+        ( void ) memcpy( &( pucDestination[ uxIndex ] ), &( usWord ), sizeof( usWord ) );
+        ulSum += usWord;
+        uxIndex += 2U;
+    }
+
+    if( uxIndex < uxByteCount )
+    {
+        /* The last byte is padded with a zero byte. */
+        pucDestination[ uxIndex ] = pucSource[ uxIndex ];
+        ucLast[ 0 ] = pucSource[ uxIndex ];
+        ucLast[ 1 ] = 0U;
+        ( void ) memcpy( &( usWord ), ucLast, sizeof( usWord ) );
+        ulSum += usWord;
+    }
+
+    while( ( ulSum >> 16 ) != 0U )
+    {
+        ulSum = ( ulSum & 0xffffU ) + ( ulSum >> 16 );
+    }
+
+    return FreeRTOS_htons( ( uint16_t ) ulSum );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add two sums, as returned by usGenerateChecksum(), of two blocks of
+ *        data that follow each other. The first block must have an even length.
+ *
+ * @param[in] usSum1 The sum of the first block.
+ * @param[in] usSum2 The sum of the second block.
+ *
+ * @return The sum of both blocks.
+ */
+uint16_t usChecksumAdd( uint16_t usSum1,
+                        uint16_t usSum2 )
+{
+    uint32_t ulSum = ( uint32_t ) usSum1 + ( uint32_t ) usSum2;
+
+    ulSum = ( ulSum & 0xffffU ) + ( ulSum >> 16 );
+
+    return ( uint16_t ) ulSum;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Update a checksum after a 16-bit word in the data has been changed,
+ *        without summing the data again. It uses eqn. 3 of RFC 1624:
+ *        HC' = ~( ~HC + ~m + m' ).
+ *
+ * @param[in] usChecksum The checksum as stored in the packet.
+ * @param[in] usOldValue The old value of the word.
+ * @param[in] usNewValue The new value of the word.
+ *
+ * @return The new value of the checksum field. The three parameters and the
+ *         result share the same byte order, normally network byte order, as
+ *         they are stored in the packet.
+ */
+uint16_t usChecksumAdjust16( uint16_t usChecksum,
+                             uint16_t usOldValue,
+                             uint16_t usNewValue )
+{
+    uint32_t ulSum;
+
+    ulSum = ( uint32_t ) ( ( uint16_t ) ~usChecksum );
+    ulSum += ( uint32_t ) ( ( uint16_t ) ~usOldValue );
+    ulSum += ( uint32_t ) usNewValue;
+
+    /* Fold the carries, the second addition can not overflow any more. */
+    ulSum = ( ulSum & 0xffffU ) + ( ulSum >> 16 );
+    ulSum = ( ulSum & 0xffffU ) + ( ulSum >> 16 );
+
+    return ( uint16_t ) ~( ( uint16_t ) ulSum );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Update a checksum after a 32-bit field in the data has been changed,
+ *        like a sequence number. See usChecksumAdjust16().
+ *
+ * @param[in] usChecksum The checksum as stored in the packet.
+ * @param[in] ulOldValue The old value of the field.
+ * @param[in] ulNewValue The new value of the field.
+ *
+ * @return The new value of the checksum field.
+ */
+uint16_t usChecksumAdjust32( uint16_t usChecksum,
+                             uint32_t ulOldValue,
+                             uint32_t ulNewValue )
+{
+    uint16_t usResult;
+
+    usResult = usChecksumAdjust16( usChecksum, ( uint16_t ) ( ulOldValue >> 16 ), ( uint16_t ) ( ulNewValue >> 16 ) );
+    usResult = usChecksumAdjust16( usResult, ( uint16_t ) ( ulOldValue & 0xffffU ), ( uint16_t ) ( ulNewValue & 0xffffU ) );
+
+    return usResult;
+}
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigHAS_PRINTF != 0 )
 
     #ifndef ipMONITOR_MAX_HEAP
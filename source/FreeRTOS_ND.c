@@ -612,7 +612,7 @@
         {
             uxNeededSize = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + sizeof( ICMPHeader_IPv6_t );
 
-            if( pxDescriptor->xDataLength < uxNeededSize )
+            if( ipNETWORK_BUFFER_CAPACITY( pxDescriptor ) < uxNeededSize )
             {
                 pxNewDescriptor = pxDuplicateNetworkBufferWithDescriptor( pxDescriptor, uxNeededSize );
                 vReleaseNetworkBufferAndDescriptor( pxDescriptor );
@@ -154,7 +154,7 @@
             FreeRTOS_printf( ( "RA: source %pip\n", ( void * ) xSourceAddress.ucBytes ) );
         }
 
-        if( pxDescriptor->xDataLength < uxNeededSize )
+        if( ipNETWORK_BUFFER_CAPACITY( pxDescriptor ) < uxNeededSize )
         {
             pxNewDescriptor = pxDuplicateNetworkBufferWithDescriptor( pxDescriptor, uxNeededSize );
             vReleaseNetworkBufferAndDescriptor( pxDescriptor );
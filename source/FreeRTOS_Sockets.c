@@ -49,9 +49,11 @@
 #include "FreeRTOS_IPv4_Sockets.h"
 #include "FreeRTOS_IPv6_Sockets.h"
 #include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_ARP.h"
 #include "FreeRTOS_DNS.h"
 #include "NetworkBufferManagement.h"
 #include "FreeRTOS_Routing.h"
+#include "FreeRTOS_TCP_Time_Wait.h"
 
 #if ( ipconfigUSE_TCP_MEM_STATS != 0 )
     #include "tcp_mem_stats.h"
@@ -90,6 +92,17 @@
 /** @brief A block time of 0 simply means "don't block". */
 #define socketDONT_BLOCK                         ( ( TickType_t ) 0 )
 
+#if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+
+/** @brief The maximum number of datagrams that FreeRTOS_sendto() makes from one buffer.
+ * One buffer may not hold more than half of the network buffers. */
+    #if ( ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS / 2 ) < 64 )
+        #define socketUDP_MAX_SEGMENTS    ( ( size_t ) ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS / 2 ) )
+    #else
+        #define socketUDP_MAX_SEGMENTS    ( 64U )
+    #endif
+#endif
+
 /** @brief TCP timer period in milliseconds. */
 #if ( ( ipconfigUSE_TCP == 1 ) && !defined( ipTCP_TIMER_PERIOD_MS ) )
     #define ipTCP_TIMER_PERIOD_MS    ( 1000U )
@@ -124,6 +137,14 @@ static uint16_t prvGetPrivatePortNumber( BaseType_t xProtocol );
 static const ListItem_t * pxListFindListItemWithValue( const List_t * pxList,
                                                        TickType_t xWantedItemValue );
 
+#if ( ipconfigUSE_UDP_PORT_HASH == 1 )
+
+/*
+ * Calculate the bucket of a UDP port number in xUDPPortHashTable.
+ */
+    static size_t prvUDPPortHashIndex( TickType_t xPortNumber );
+#endif
+
 /*
  * Return pdTRUE only if pxSocket is valid and bound, as far as can be
  * determined.
@@ -202,6 +223,25 @@ static int32_t prvSendUDPPacket( const FreeRTOS_Socket_t * pxSocket,
     static void prvTCPSetSocketCount( FreeRTOS_Socket_t const * pxSocketToDelete );
 #endif /* ipconfigUSE_TCP == 1 */
 
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TIMER_WHEEL == 1 ) )
+
+/*
+ * Called from an API after setting 'usTimeout': ask the IP-task to schedule
+ * the socket in the timer wheel.
+ */
+    static void prvTCPTimerPoke( FreeRTOS_Socket_t * pxSocket );
+
+/*
+ * A socket is being closed, remove it from the timer wheel and from the
+ * lists of sockets that need attention.
+ */
+    static void prvTCPTimerWheelForget( FreeRTOS_Socket_t * pxSocket );
+
+    #define tcpTIMER_POKE( pxSocket )    prvTCPTimerPoke( pxSocket )
+#else
+    #define tcpTIMER_POKE( pxSocket )    do {} while( ipFALSE_BOOL )
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TIMER_WHEEL == 1 ) */
+
 #if ( ipconfigUSE_TCP == 1 )
 
 /*
@@ -233,6 +273,44 @@ static BaseType_t prvMakeSureSocketIsBound( FreeRTOS_Socket_t * pxSocket );
 
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
 
+#if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
+
+/* Check which of the select events of interest are active for a socket. */
+    static EventBits_t prvSocketSelectBits( FreeRTOS_Socket_t * pxSocket );
+
+#endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
+
+#if ( ipconfigSUPPORT_EVENT_POLL == 1 )
+
+/** @brief The bit in 'xPollGroup' that is set when a socket becomes ready. */
+    #define eventpollREADY_BIT        ( ( EventBits_t ) 0x01U )
+
+/** @brief The bit in 'xPollGroup' that the IP-task sets when it has collected
+ *         the ready sockets for FreeRTOS_EventPollWait(). */
+    #define eventpollCOLLECTED_BIT    ( ( EventBits_t ) 0x02U )
+
+/** @brief The events that can be reported by an event-poll set. */
+    #define eventpollALL_EVENTS       ( ( ( EventBits_t ) eSELECT_READ ) | ( ( EventBits_t ) eSELECT_WRITE ) | ( ( EventBits_t ) eSELECT_EXCEPT ) )
+
+/* Add a socket to the ready list of its event-poll set. */
+    static void prvEventPollQueue( EventPollSet_t * pxSet,
+                                   FreeRTOS_Socket_t * pxSocket );
+
+/* Take a socket out of its event-poll set. */
+    static void prvEventPollUnlink( FreeRTOS_Socket_t * pxSocket );
+
+/* Take the ready sockets from the ready list of an event-poll set. */
+    static BaseType_t prvEventPollCollect( EventPollSet_t * pxSet,
+                                           EventPollResult_t * pxResults,
+                                           BaseType_t xMaxResults );
+
+/* Have the IP-task take the ready sockets from the ready list of a set. */
+    static BaseType_t prvEventPollRequest( EventPollSet_t * pxSet,
+                                           EventPollResult_t * pxResults,
+                                           BaseType_t xMaxResults );
+
+#endif /* ipconfigSUPPORT_EVENT_POLL == 1 */
+
 #if ( ipconfigUSE_TCP == 1 )
 
 /** @brief This routine will wait for data to arrive in the stream buffer.
@@ -299,8 +377,35 @@ static BaseType_t prvMakeSureSocketIsBound( FreeRTOS_Socket_t * pxSocket );
     static BaseType_t prvSetOptionSetFullSize( FreeRTOS_Socket_t * pxSocket,
                                                const void * pvOptionValue );
 
+/**
+ * @brief Handle the socket option FREERTOS_SO_TCP_NODELAY.
+ */
+    static BaseType_t prvSetOptionNoDelay( FreeRTOS_Socket_t * pxSocket,
+                                           const void * pvOptionValue );
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_TCP_CORK.
+ */
+    static BaseType_t prvSetOptionCork( FreeRTOS_Socket_t * pxSocket,
+                                        const void * pvOptionValue );
+
+/*
+ * Let the IP-task check if data that was held back can be sent now.
+ */
+    static void prvTCPWakeForTransmission( FreeRTOS_Socket_t * pxSocket );
+
 #endif /* ( ipconfigUSE_TCP != 0 ) */
 
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_ACK_POLICY == 1 ) )
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_TCP_ACK_POLICY.
+ */
+    static BaseType_t prvSetOptionAckPolicy( FreeRTOS_Socket_t * pxSocket,
+                                             const void * pvOptionValue,
+                                             size_t uxOptionLength );
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_ACK_POLICY == 1 ) */
+
 #if ( ipconfigUSE_TCP != 0 )
 
 /** @brief Handle the socket option FREERTOS_SO_STOP_RX. */
@@ -309,6 +414,16 @@ static BaseType_t prvMakeSureSocketIsBound( FreeRTOS_Socket_t * pxSocket );
 
 #endif /* ( ipconfigUSE_TCP != 0 ) */
 
+#if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+
+/** @brief Handle the socket option FREERTOS_SO_TCP_CONGESTION. */
+    static BaseType_t prvSetOptionTCPCongestion( FreeRTOS_Socket_t * pxSocket,
+                                                 int32_t lLevel,
+                                                 const void * pvOptionValue,
+                                                 size_t uxOptionLength );
+
+#endif /* ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 ) */
+
 /** @brief Handle the socket options FREERTOS_SO_RCVTIMEO and
  *         FREERTOS_SO_SNDTIMEO.
  */
@@ -336,6 +451,35 @@ static void prvSetOptionTimeout( FreeRTOS_Socket_t * pxSocket,
                                         size_t uxSocketSize );
 #endif /* ipconfigUSE_TCP == 1 */
 
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_REUSE_PORT == 1 ) )
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_REUSEPORT.
+ */
+    static BaseType_t prvSetOptionReusePort( FreeRTOS_Socket_t * pxSocket,
+                                             const void * pvOptionValue );
+
+/*
+ * Check if a TCP socket may be bound to a port that is already in use.
+ */
+    static BaseType_t prvTCPReusePortAllowed( const FreeRTOS_Socket_t * pxSocket,
+                                              const List_t * pxSocketList,
+                                              TickType_t xPort );
+
+/*
+ * Scramble the bits of a 32-bit value, for the choice of a listening socket.
+ */
+    static uint32_t prvTCPReusePortMix( uint32_t ulValue );
+
+/*
+ * Choose one of the sockets listening to a shared port.
+ */
+    static FreeRTOS_Socket_t * prvTCPReusePortSelect( const List_t * pxList,
+                                                      UBaseType_t uxLocalPort,
+                                                      const IPv46_Address_t * pxRemoteIP,
+                                                      UBaseType_t uxRemotePort );
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_REUSE_PORT == 1 ) */
+
 
 
 static int32_t prvRecvFrom_CopyPacket( uint8_t * pucEthernetBuffer,
@@ -351,6 +495,35 @@ static int32_t prvSendTo_ActualSend( const FreeRTOS_Socket_t * pxSocket,
                                      const struct freertos_sockaddr * pxDestinationAddress,
                                      size_t uxPayloadOffset );
 
+static size_t prvRecvFrom_PayloadOffset( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                         struct freertos_sockaddr * pxSourceAddress );
+
+static size_t prvSendTo_PayloadOffset( uint8_t ucFamily,
+                                       size_t * puxMaxPayloadLength );
+
+static void prvSendTo_PreparePacket( const FreeRTOS_Socket_t * pxSocket,
+                                     NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                     size_t uxTotalDataLength,
+                                     const struct freertos_sockaddr * pxDestinationAddress,
+                                     size_t uxPayloadOffset );
+
+#if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+/* Called by FreeRTOS_sendto() to send a buffer as a series of datagrams. */
+    static int32_t prvSendTo_Segments( FreeRTOS_Socket_t * pxSocket,
+                                       const void * pvBuffer,
+                                       size_t uxTotalDataLength,
+                                       BaseType_t xFlags,
+                                       const struct freertos_sockaddr * pxDestinationAddress,
+                                       size_t uxPayloadOffset,
+                                       size_t uxMaxPayloadLength );
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+/* Make sure that the MAC address of an IPv4 destination is known. */
+        static BaseType_t prvSendTo_SegmentsResolve( uint32_t ulIPAddress,
+                                                     TickType_t xTicksToWait );
+    #endif
+#endif
+
 #if ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_CALLBACKS == 1 )
 
 /** @brief The application can attach callback functions to a socket. In this function,
@@ -369,6 +542,26 @@ static int32_t prvSendTo_ActualSend( const FreeRTOS_Socket_t * pxSocket,
     static void vTCPNetStat_TCPSocket( const FreeRTOS_Socket_t * pxSocket );
 #endif
 
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) )
+
+/*
+ * Calculate the bucket of a TCP connection in xTCPSocketHashTable.
+ */
+    static size_t prvTCPHashIndex( UBaseType_t uxLocalPort,
+                                   const IPv46_Address_t * pxRemoteIP,
+                                   UBaseType_t uxRemotePort );
+
+/*
+ * Calculate the bucket of a listening TCP socket in xTCPListenHashTable.
+ */
+    static size_t prvTCPListenHashIndex( UBaseType_t uxLocalPort );
+
+/*
+ * Store a TCP socket in the hash tables, called from the IP-task.
+ */
+    static void prvTCPSocketHashStore( FreeRTOS_Socket_t * pxSocket );
+#endif
+
 /*-----------------------------------------------------------*/
 
 /** @brief The list that contains mappings between sockets and port numbers.
@@ -377,6 +570,15 @@ static int32_t prvSendTo_ActualSend( const FreeRTOS_Socket_t * pxSocket,
  */
 List_t xBoundUDPSocketsList;
 
+#if ( ipconfigUSE_UDP_PORT_HASH == 1 )
+
+/** @brief The bound UDP sockets, indexed by a hash of their port number.
+ *         The table is updated at the same moments as xBoundUDPSocketsList,
+ *         and protected in the same way.
+ */
+    static List_t xUDPPortHashTable[ ipconfigUDP_PORT_HASH_SIZE ];
+#endif /* ipconfigUSE_UDP_PORT_HASH == 1 */
+
 #if ipconfigUSE_TCP == 1
 
 /** @brief The list that contains mappings between sockets and port numbers.
@@ -385,6 +587,38 @@ List_t xBoundUDPSocketsList;
  */
     List_t xBoundTCPSocketsList;
 
+    #if ( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+
+/** @brief Bound TCP sockets that are not listening, indexed by a hash of
+ *         their local port, remote IP-address and remote port. The tables
+ *         are only accessed by the IP-task: when a user task changes the
+ *         state of a socket, the update is passed to the IP-task, see
+ *         vTCPSocketHashUpdate().
+ */
+        static List_t xTCPSocketHashTable[ ipconfigTCP_SOCKET_HASH_SIZE ];
+
+/** @brief Listening TCP sockets, indexed by a hash of their local port. */
+        static List_t xTCPListenHashTable[ ipconfigTCP_SOCKET_HASH_SIZE ];
+    #endif /* ipconfigUSE_TCP_SOCKET_HASH == 1 */
+
+    #if ( ipconfigUSE_TCP_TIMER_WHEEL == 1 )
+
+/** @brief The wheel in which the time-outs of the TCP sockets are scheduled.
+ *         It is only accessed by the IP-task. */
+        static TimerWheel_t xTCPTimerWheel;
+
+/** @brief TCP sockets that have events for their owner, only accessed by
+ *         the IP-task. */
+        static FreeRTOS_Socket_t * pxTCPWakeUpList = NULL;
+
+/** @brief TCP sockets whose 'usTimeout' was set by an API. Accesses are
+ *         protected by a critical section. */
+        static FreeRTOS_Socket_t * pxTCPPokedList = NULL;
+
+/** @brief pdTRUE while xTCPTimerCheck() handles the expired timers. */
+        static BaseType_t xTCPTimerWheelBusy = pdFALSE;
+    #endif /* ipconfigUSE_TCP_TIMER_WHEEL == 1 */
+
 #endif /* ipconfigUSE_TCP == 1 */
 
 /*-----------------------------------------------------------*/
@@ -435,9 +669,40 @@ void vNetworkSocketsInit( void )
 {
     vListInitialise( &xBoundUDPSocketsList );
 
+    #if ( ipconfigUSE_UDP_PORT_HASH == 1 )
+    {
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigUDP_PORT_HASH_SIZE; uxIndex++ )
+        {
+            vListInitialise( &( xUDPPortHashTable[ uxIndex ] ) );
+        }
+    }
+    #endif /* ipconfigUSE_UDP_PORT_HASH == 1 */
+
     #if ( ipconfigUSE_TCP == 1 )
     {
         vListInitialise( &xBoundTCPSocketsList );
+
+        #if ( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+        {
+            size_t uxIndex;
+
+            for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigTCP_SOCKET_HASH_SIZE; uxIndex++ )
+            {
+                vListInitialise( &( xTCPSocketHashTable[ uxIndex ] ) );
+                vListInitialise( &( xTCPListenHashTable[ uxIndex ] ) );
+            }
+        }
+        #endif /* ipconfigUSE_TCP_SOCKET_HASH == 1 */
+
+        #if ( ipconfigUSE_TCP_TIMER_WHEEL == 1 )
+        {
+            vTimerWheelInit( &xTCPTimerWheel, xTaskGetTickCount() );
+            pxTCPWakeUpList = NULL;
+            pxTCPPokedList = NULL;
+        }
+        #endif /* ipconfigUSE_TCP_TIMER_WHEEL == 1 */
     }
     #endif /* ipconfigUSE_TCP == 1 */
 }
@@ -593,6 +858,13 @@ static BaseType_t prvDetermineSocketSize( BaseType_t xDomain,
         }
         #endif
 
+        #if ( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+        {
+            vListInitialiseItem( &( pxSocket->u.xTCP.xHashListItem ) );
+            listSET_LIST_ITEM_OWNER( &( pxSocket->u.xTCP.xHashListItem ), ( void * ) pxSocket );
+        }
+        #endif
+
         /* The above values are just defaults, and can be overridden by
          * calling FreeRTOS_setsockopt().  No buffers will be allocated until a
          * socket is connected and data is exchanged. */
@@ -732,6 +1004,13 @@ Socket_t FreeRTOS_socket( BaseType_t xDomain,
 
                 vListInitialise( &( pxSocket->u.xUDP.xWaitingPacketsList ) );
 
+                #if ( ipconfigUSE_UDP_PORT_HASH == 1 )
+                {
+                    vListInitialiseItem( &( pxSocket->u.xUDP.xHashListItem ) );
+                    listSET_LIST_ITEM_OWNER( &( pxSocket->u.xUDP.xHashListItem ), ( void * ) pxSocket );
+                }
+                #endif /* ipconfigUSE_UDP_PORT_HASH == 1 */
+
                 #if ( ipconfigUDP_MAX_RX_PACKETS > 0U )
                 {
                     pxSocket->u.xUDP.uxMaxPackets = ( UBaseType_t ) ipconfigUDP_MAX_RX_PACKETS;
@@ -1240,6 +1519,42 @@ static int32_t prvRecvFrom_CopyPacket( uint8_t * pucEthernetBuffer,
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Called by FreeRTOS_recvfrom(). It stores the source address of a
+ *        received packet, and finds the offset of its UDP payload.
+ * @param[in] pxNetworkBuffer The packet that was received.
+ * @param[out] pxSourceAddress Where the source address will be stored, may be NULL.
+ * @return The offset of the UDP payload, or zero when the IP-version of the
+ *         packet is not known.
+ */
+static size_t prvRecvFrom_PayloadOffset( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                         struct freertos_sockaddr * pxSourceAddress )
+{
+    size_t uxPayloadOffset = 0U;
+
+    switch( uxIPHeaderSizePacket( pxNetworkBuffer ) )
+    {
+        #if ( ipconfigUSE_IPv4 != 0 )
+            case ipSIZE_OF_IPv4_HEADER:
+                uxPayloadOffset = xRecv_Update_IPv4( pxNetworkBuffer, pxSourceAddress );
+                break;
+        #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+
+        #if ( ipconfigUSE_IPv6 != 0 )
+            case ipSIZE_OF_IPv6_HEADER:
+                uxPayloadOffset = xRecv_Update_IPv6( pxNetworkBuffer, pxSourceAddress );
+                break;
+        #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+
+        default:
+            /* MISRA 16.4 Compliance */
+            break;
+    }
+
+    return uxPayloadOffset;
+}
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Receive data from a bound socket. In this library, the function
  *        can only be used with connection-less sockets (UDP). For TCP sockets,
@@ -1291,28 +1606,11 @@ int32_t FreeRTOS_recvfrom( const ConstSocket_t xSocket,
         {
             do
             {
-                switch( uxIPHeaderSizePacket( pxNetworkBuffer ) )
-                {
-                    #if ( ipconfigUSE_IPv4 != 0 )
-                        case ipSIZE_OF_IPv4_HEADER:
-                            uxPayloadOffset = xRecv_Update_IPv4( pxNetworkBuffer, pxSourceAddress );
-                            break;
-                    #endif /* ( ipconfigUSE_IPv4 != 0 ) */
-
-                    #if ( ipconfigUSE_IPv6 != 0 )
-                        case ipSIZE_OF_IPv6_HEADER:
-                            uxPayloadOffset = xRecv_Update_IPv6( pxNetworkBuffer, pxSourceAddress );
-                            break;
-                    #endif /* ( ipconfigUSE_IPv6 != 0 ) */
-
-                    default:
-                        /* MISRA 16.4 Compliance */
-                        lReturn = -pdFREERTOS_ERRNO_EINVAL;
-                        break;
-                }
+                uxPayloadOffset = prvRecvFrom_PayloadOffset( pxNetworkBuffer, pxSourceAddress );
 
-                if( lReturn < 0 )
+                if( uxPayloadOffset == 0U )
                 {
+                    lReturn = -pdFREERTOS_ERRNO_EINVAL;
                     break;
                 }
 
@@ -1407,32 +1705,7 @@ static int32_t prvSendUDPPacket( const FreeRTOS_Socket_t * pxSocket,
     int32_t lReturn = 0;
     IPStackEvent_t xStackTxEvent = { eStackTxEvent, NULL };
 
-    switch( pxDestinationAddress->sin_family ) /* LCOV_EXCL_BR_LINE Exclude this line because default case is checked before calling. */
-    {
-        #if ( ipconfigUSE_IPv6 != 0 )
-            case FREERTOS_AF_INET6:
-                ( void ) xSend_UDP_Update_IPv6( pxNetworkBuffer, pxDestinationAddress );
-                break;
-        #endif /* ( ipconfigUSE_IPv6 != 0 ) */
-
-        #if ( ipconfigUSE_IPv4 != 0 )
-            case FREERTOS_AF_INET4:
-                ( void ) xSend_UDP_Update_IPv4( pxNetworkBuffer, pxDestinationAddress );
-                break;
-        #endif /* ( ipconfigUSE_IPv4 != 0 ) */
-
-        default:   /* LCOV_EXCL_LINE Exclude this line because default case is checked before calling. */
-            /* MISRA 16.4 Compliance */
-            break; /* LCOV_EXCL_LINE Exclude this line because default case is checked before calling. */
-    }
-
-    pxNetworkBuffer->xDataLength = uxTotalDataLength + uxPayloadOffset;
-    pxNetworkBuffer->usPort = pxDestinationAddress->sin_port;
-    pxNetworkBuffer->usBoundPort = ( uint16_t ) socketGET_SOCKET_PORT( pxSocket );
-
-    /* The socket options are passed to the IP layer in the
-     * space that will eventually get used by the Ethernet header. */
-    pxNetworkBuffer->pucEthernetBuffer[ ipSOCKET_OPTIONS_OFFSET ] = pxSocket->ucSocketOptions;
+    prvSendTo_PreparePacket( pxSocket, pxNetworkBuffer, uxTotalDataLength, pxDestinationAddress, uxPayloadOffset );
 
     /* Tell the networking task that the packet needs sending. */
     xStackTxEvent.pvData = pxNetworkBuffer;
@@ -1467,6 +1740,50 @@ static int32_t prvSendUDPPacket( const FreeRTOS_Socket_t * pxSocket,
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Fill in the addresses and ports of a UDP packet that is about to be
+ *        passed to the IP-task.
+ * @param[in] pxSocket  The socket on which a packet is sent.
+ * @param[in] pxNetworkBuffer  The packet to be sent.
+ * @param[in] uxTotalDataLength  The total number of payload bytes in the packet.
+ * @param[in] pxDestinationAddress  The address of the destination.
+ * @param[in] uxPayloadOffset  The number of bytes in the packet before the payload.
+ */
+static void prvSendTo_PreparePacket( const FreeRTOS_Socket_t * pxSocket,
+                                     NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                     size_t uxTotalDataLength,
+                                     const struct freertos_sockaddr * pxDestinationAddress,
+                                     size_t uxPayloadOffset )
+{
+    switch( pxDestinationAddress->sin_family ) /* LCOV_EXCL_BR_LINE Exclude this line because default case is checked before calling. */
+    {
+        #if ( ipconfigUSE_IPv6 != 0 )
+            case FREERTOS_AF_INET6:
+                ( void ) xSend_UDP_Update_IPv6( pxNetworkBuffer, pxDestinationAddress );
+                break;
+        #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+
+        #if ( ipconfigUSE_IPv4 != 0 )
+            case FREERTOS_AF_INET4:
+                ( void ) xSend_UDP_Update_IPv4( pxNetworkBuffer, pxDestinationAddress );
+                break;
+        #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+
+        default:   /* LCOV_EXCL_LINE Exclude this line because default case is checked before calling. */
+            /* MISRA 16.4 Compliance */
+            break; /* LCOV_EXCL_LINE Exclude this line because default case is checked before calling. */
+    }
+
+    pxNetworkBuffer->xDataLength = uxTotalDataLength + uxPayloadOffset;
+    pxNetworkBuffer->usPort = pxDestinationAddress->sin_port;
+    pxNetworkBuffer->usBoundPort = ( uint16_t ) socketGET_SOCKET_PORT( pxSocket );
+
+    /* The socket options are passed to the IP layer in the
+     * space that will eventually get used by the Ethernet header. */
+    pxNetworkBuffer->pucEthernetBuffer[ ipSOCKET_OPTIONS_OFFSET ] = pxSocket->ucSocketOptions;
+}
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Called by FreeRTOS_sendto(), it will actually send a UDP packet.
  * @param[in] pxSocket The socket used for sending.
@@ -1554,6 +1871,43 @@ static int32_t prvSendTo_ActualSend( const FreeRTOS_Socket_t * pxSocket,
 }
 /*-----------------------------------------------------------*/
 
+/**
+ * @brief Called by FreeRTOS_sendto(), it finds the size of the headers that
+ *        precede the UDP payload, and the maximum payload length.
+ * @param[in] ucFamily The family of the destination address.
+ * @param[out] puxMaxPayloadLength The maximum number of bytes in the payload.
+ * @return The offset of the UDP payload, or zero when the family is not supported.
+ */
+static size_t prvSendTo_PayloadOffset( uint8_t ucFamily,
+                                       size_t * puxMaxPayloadLength )
+{
+    size_t uxPayloadOffset = 0U;
+
+    switch( ucFamily )
+    {
+        #if ( ipconfigUSE_IPv6 != 0 )
+            case FREERTOS_AF_INET6:
+                *puxMaxPayloadLength = ipconfigNETWORK_MTU - ( ipSIZE_OF_IPv6_HEADER + ipSIZE_OF_UDP_HEADER );
+                uxPayloadOffset = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + ipSIZE_OF_UDP_HEADER;
+                break;
+        #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+
+        #if ( ipconfigUSE_IPv4 != 0 )
+            case FREERTOS_AF_INET4:
+                *puxMaxPayloadLength = ipconfigNETWORK_MTU - ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER );
+                uxPayloadOffset = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER;
+                break;
+        #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+
+        default:
+            /* MISRA 16.4 Compliance */
+            break;
+    }
+
+    return uxPayloadOffset;
+}
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Send data to a socket. The socket must have already been created by a
  *        successful call to FreeRTOS_socket(). It works for UDP-sockets only.
@@ -1603,30 +1957,27 @@ int32_t FreeRTOS_sendto( Socket_t xSocket,
     configASSERT( pxDestinationAddress != NULL );
     configASSERT( pvBuffer != NULL );
 
-    switch( pxDestinationAddress->sin_family )
-    {
-        #if ( ipconfigUSE_IPv6 != 0 )
-            case FREERTOS_AF_INET6:
-                uxMaxPayloadLength = ipconfigNETWORK_MTU - ( ipSIZE_OF_IPv6_HEADER + ipSIZE_OF_UDP_HEADER );
-                uxPayloadOffset = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + ipSIZE_OF_UDP_HEADER;
-                break;
-        #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+    uxPayloadOffset = prvSendTo_PayloadOffset( pxDestinationAddress->sin_family, &( uxMaxPayloadLength ) );
 
-        #if ( ipconfigUSE_IPv4 != 0 )
-            case FREERTOS_AF_INET4:
-                uxMaxPayloadLength = ipconfigNETWORK_MTU - ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER );
-                uxPayloadOffset = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER;
-                break;
-        #endif /* ( ipconfigUSE_IPv4 != 0 ) */
-
-        default:
-            FreeRTOS_debug_printf( ( "FreeRTOS_sendto: Undefined sin_family \n" ) );
-            lReturn = -pdFREERTOS_ERRNO_EINVAL;
-            break;
-    }
+    if( uxPayloadOffset == 0U )
+    {
+        FreeRTOS_debug_printf( ( "FreeRTOS_sendto: Undefined sin_family \n" ) );
+        lReturn = -pdFREERTOS_ERRNO_EINVAL;
+    }
 
     if( lReturn == 0 )
     {
+        #if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+            if( ( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) == 0U ) &&
+                ( prvValidSocket( pxSocket, FREERTOS_IPPROTO_UDP, pdFALSE ) == pdTRUE ) &&
+                ( pxSocket->u.xUDP.usSegmentSize != 0U ) &&
+                ( uxTotalDataLength > ( size_t ) pxSocket->u.xUDP.usSegmentSize ) )
+            {
+                lReturn = prvSendTo_Segments( pxSocket, pvBuffer, uxTotalDataLength, xFlags, pxDestinationAddress, uxPayloadOffset, uxMaxPayloadLength );
+            }
+            else
+        #endif /* ipconfigUSE_UDP_SEGMENTATION == 1 */
+
         if( uxTotalDataLength <= ( size_t ) uxMaxPayloadLength )
         {
             /* If the socket is not already bound to an address, bind it now.
@@ -1653,6 +2004,512 @@ int32_t FreeRTOS_sendto( Socket_t xSocket,
 } /* Tested */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigSUPPORT_UDP_MULTI_MESSAGES == 1 )
+
+/**
+ * @brief Receive up to 'xMessageCount' datagrams from a bound UDP socket.
+ *        The call blocks like FreeRTOS_recvfrom() until the first datagram
+ *        has arrived, the datagrams that are waiting in the socket are then
+ *        taken in one go.
+ *
+ * @param[in] xSocket The UDP socket.
+ * @param[in,out] pxMessages The datagrams. Without FREERTOS_ZERO_COPY, the
+ *                payload is copied to 'pvBuffer', truncated to 'uxBufferLength'.
+ *                With FREERTOS_ZERO_COPY, 'pvBuffer' is set to the UDP payload
+ *                buffer, which must be released with
+ *                FreeRTOS_ReleaseUDPPayloadBuffer().
+ * @param[in] xMessageCount The number of elements in 'pxMessages'.
+ * @param[in] xFlags FREERTOS_MSG_DONTWAIT and/or FREERTOS_ZERO_COPY.
+ *
+ * @return The number of datagrams received, or a negative error code as found
+ *         in 'FreeRTOS-Kernel/projdefs.h'.
+ */
+    BaseType_t FreeRTOS_recvfrom_multi( Socket_t xSocket,
+                                        FreeRTOS_MMsg_t * pxMessages,
+                                        BaseType_t xMessageCount,
+                                        BaseType_t xFlags )
+    {
+        const FreeRTOS_Socket_t * pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
+        NetworkBufferDescriptor_t * pxNetworkBuffer;
+        List_t xReceivedList;
+        EventBits_t xEventBits = ( EventBits_t ) 0;
+        FreeRTOS_MMsg_t * pxMessage;
+        void * pvDestination;
+        size_t uxPayloadOffset;
+        int32_t lLength;
+        BaseType_t xReturn = 0;
+
+        if( ( prvValidSocket( pxSocket, FREERTOS_IPPROTO_UDP, pdTRUE ) == pdFALSE ) ||
+            ( pxMessages == NULL ) ||
+            ( xMessageCount <= 0 ) ||
+            ( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_MSG_PEEK ) != 0U ) )
+        {
+            xReturn = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            pxNetworkBuffer = prvRecvFromWaitForPacket( pxSocket, xFlags, &( xEventBits ) );
+
+            if( pxNetworkBuffer != NULL )
+            {
+                vListInitialise( &( xReceivedList ) );
+                vListInsertEnd( &( xReceivedList ), &( pxNetworkBuffer->xBufferListItem ) );
+
+                vTaskSuspendAll();
+                {
+                    /* Move the packets that are waiting to a private list. */
+                    while( ( ( BaseType_t ) listCURRENT_LIST_LENGTH( &( xReceivedList ) ) < xMessageCount ) &&
+                           ( listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) > 0U ) )
+                    {
+                        pxNetworkBuffer = ( ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) );
+                        ( void ) uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+                        vListInsertEnd( &( xReceivedList ), &( pxNetworkBuffer->xBufferListItem ) );
+                    }
+                }
+                ( void ) xTaskResumeAll();
+
+                while( listCURRENT_LIST_LENGTH( &( xReceivedList ) ) > 0U )
+                {
+                    pxNetworkBuffer = ( ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &( xReceivedList ) ) );
+                    ( void ) uxListRemove( &( pxNetworkBuffer->xBufferListItem ) );
+
+                    pxMessage = &( pxMessages[ xReturn ] );
+                    uxPayloadOffset = prvRecvFrom_PayloadOffset( pxNetworkBuffer, &( pxMessage->xAddress ) );
+
+                    if( uxPayloadOffset == 0U )
+                    {
+                        /* The IP-version is not known, drop the packet. */
+                        vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                    }
+                    else
+                    {
+                        if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) == 0U )
+                        {
+                            pvDestination = pxMessage->pvBuffer;
+                        }
+                        else
+                        {
+                            pvDestination = ( void * ) &( pxMessage->pvBuffer );
+                        }
+
+                        lLength = prvRecvFrom_CopyPacket( &( pxNetworkBuffer->pucEthernetBuffer[ uxPayloadOffset ] ),
+                                                          pvDestination,
+                                                          pxMessage->uxBufferLength,
+                                                          xFlags,
+                                                          ( int32_t ) ( pxNetworkBuffer->xDataLength - uxPayloadOffset ) );
+                        pxMessage->uxLength = ( size_t ) lLength;
+                        xReturn++;
+
+                        if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) == 0U )
+                        {
+                            vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                        }
+                    }
+                }
+            }
+
+            #if ( ipconfigSUPPORT_SIGNALS != 0 )
+                else if( ( xEventBits & ( EventBits_t ) eSOCKET_INTR ) != 0U )
+                {
+                    xReturn = -pdFREERTOS_ERRNO_EINTR;
+                    iptraceRECVFROM_INTERRUPTED();
+                }
+            #endif /* ipconfigSUPPORT_SIGNALS */
+            else
+            {
+                xReturn = -pdFREERTOS_ERRNO_EWOULDBLOCK;
+                iptraceRECVFROM_TIMEOUT();
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Send 'xMessageCount' datagrams through a UDP socket. The packets are
+ *        passed to the IP-task as a single chain, so only one message is
+ *        posted to the IP-task for all of them. The first datagram that can not
+ *        be sent, because it is too long, has an unknown address family, or no
+ *        network buffer is available, ends the batch.
+ *
+ * @param[in] xSocket The UDP socket, it will be bound when necessary.
+ * @param[in,out] pxMessages The datagrams. With FREERTOS_ZERO_COPY, 'pvBuffer'
+ *                is a UDP payload buffer obtained from
+ *                FreeRTOS_GetUDPPayloadBuffer(). The stack takes ownership of
+ *                the buffers of the datagrams that it has accepted.
+ * @param[in] xMessageCount The number of elements in 'pxMessages'.
+ * @param[in] xFlags FREERTOS_MSG_DONTWAIT and/or FREERTOS_ZERO_COPY.
+ *
+ * @return The number of datagrams that were passed to the IP-task, or
+ *         -pdFREERTOS_ERRNO_EINVAL when a parameter is not valid.
+ */
+    BaseType_t FreeRTOS_sendto_multi( Socket_t xSocket,
+                                      FreeRTOS_MMsg_t * pxMessages,
+                                      BaseType_t xMessageCount,
+                                      BaseType_t xFlags )
+    {
+        FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+        NetworkBufferDescriptor_t * pxNetworkBuffer;
+        NetworkBufferDescriptor_t * pxHead = NULL;
+        NetworkBufferDescriptor_t * pxTail = NULL;
+        IPStackEvent_t xStackTxEvent = { eStackTxChainEvent, NULL };
+        struct freertos_sockaddr xDestinationAddress;
+        const FreeRTOS_MMsg_t * pxMessage;
+        TickType_t xTicksToWait;
+        TimeOut_t xTimeOut;
+        size_t uxPayloadOffset;
+        size_t uxMaxPayloadLength = 0U;
+        BaseType_t xIndex;
+        BaseType_t xReturn = 0;
+
+        if( ( pxMessages == NULL ) ||
+            ( xMessageCount <= 0 ) ||
+            ( prvMakeSureSocketIsBound( pxSocket ) == pdFALSE ) )
+        {
+            xReturn = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            xTicksToWait = pxSocket->xSendBlockTime;
+
+            if( ( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_MSG_DONTWAIT ) != 0U ) ||
+                ( xIsCallingFromIPTask() != pdFALSE ) )
+            {
+                xTicksToWait = ( TickType_t ) 0U;
+            }
+
+            vTaskSetTimeOutState( &xTimeOut );
+
+            while( xReturn < xMessageCount )
+            {
+                pxMessage = &( pxMessages[ xReturn ] );
+                ( void ) memcpy( &( xDestinationAddress ), &( pxMessage->xAddress ), sizeof( xDestinationAddress ) );
+
+                #if ( ipconfigIPv4_BACKWARD_COMPATIBLE == 1 )
+                {
+                    if( ( xDestinationAddress.sin_family != FREERTOS_AF_INET6 ) && ( xDestinationAddress.sin_family != FREERTOS_AF_INET ) )
+                    {
+                        xDestinationAddress.sin_family = FREERTOS_AF_INET;
+                    }
+                }
+                #endif /* ( ipconfigIPv4_BACKWARD_COMPATIBLE == 1 ) */
+
+                uxPayloadOffset = prvSendTo_PayloadOffset( xDestinationAddress.sin_family, &( uxMaxPayloadLength ) );
+
+                if( ( uxPayloadOffset == 0U ) || ( pxMessage->uxBufferLength > uxMaxPayloadLength ) )
+                {
+                    iptraceSENDTO_DATA_TOO_LONG();
+                    break;
+                }
+
+                if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) == 0U )
+                {
+                    pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxPayloadOffset + pxMessage->uxBufferLength, xTicksToWait );
+
+                    if( pxNetworkBuffer != NULL )
+                    {
+                        ( void ) memcpy( &( pxNetworkBuffer->pucEthernetBuffer[ uxPayloadOffset ] ), pxMessage->pvBuffer, pxMessage->uxBufferLength );
+                    }
+
+                    if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdTRUE )
+                    {
+                        /* The entire block time has been used up. */
+                        xTicksToWait = ( TickType_t ) 0;
+                    }
+                }
+                else
+                {
+                    pxNetworkBuffer = pxUDPPayloadBuffer_to_NetworkBuffer( pxMessage->pvBuffer );
+                }
+
+                if( pxNetworkBuffer == NULL )
+                {
+                    iptraceNO_BUFFER_FOR_SENDTO();
+                    break;
+                }
+
+                pxNetworkBuffer->pxEndPoint = pxSocket->pxEndPoint;
+                prvSendTo_PreparePacket( pxSocket, pxNetworkBuffer, pxMessage->uxBufferLength, &( xDestinationAddress ), uxPayloadOffset );
+                pxNetworkBuffer->pxNextBuffer = NULL;
+
+                if( pxTail == NULL )
+                {
+                    pxHead = pxNetworkBuffer;
+                }
+                else
+                {
+                    pxTail->pxNextBuffer = pxNetworkBuffer;
+                }
+
+                pxTail = pxNetworkBuffer;
+                xReturn++;
+            }
+
+            if( pxHead != NULL )
+            {
+                xStackTxEvent.pvData = pxHead;
+
+                if( xSendEventStructToIPTask( &xStackTxEvent, xTicksToWait ) == pdPASS )
+                {
+                    for( xIndex = 0; xIndex < xReturn; xIndex++ )
+                    {
+                        pxMessages[ xIndex ].uxLength = pxMessages[ xIndex ].uxBufferLength;
+
+                        #if ( ipconfigUSE_CALLBACKS == 1 )
+                        {
+                            if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xUDP.pxHandleSent ) )
+                            {
+                                pxSocket->u.xUDP.pxHandleSent( pxSocket, pxMessages[ xIndex ].uxBufferLength );
+                            }
+                        }
+                        #endif /* ipconfigUSE_CALLBACKS */
+                    }
+                }
+                else
+                {
+                    /* Unlink the chain, and release the buffers that were
+                     * allocated in this function. */
+                    while( pxHead != NULL )
+                    {
+                        pxNetworkBuffer = pxHead;
+                        pxHead = pxNetworkBuffer->pxNextBuffer;
+                        pxNetworkBuffer->pxNextBuffer = NULL;
+
+                        if( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_ZERO_COPY ) == 0U )
+                        {
+                            vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                        }
+                    }
+
+                    xReturn = 0;
+                    iptraceSTACK_TX_EVENT_LOST( ipSTACK_TX_EVENT );
+                }
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigSUPPORT_UDP_MULTI_MESSAGES == 1 */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+
+/**
+ * @brief Called by FreeRTOS_sendto() when the socket has a segment size and
+ *        the buffer is longer than a segment. The buffer is copied to a chain
+ *        of packets, which is passed to the IP-task in a single event. Either
+ *        all datagrams are sent, or none. For an IPv4 destination, the MAC
+ *        address is resolved first, because the IP-task drops all segments
+ *        when it has to send an ARP request. Only the first network buffer is
+ *        obtained with a block time, the others are not waited for while
+ *        network buffers are held.
+ * @param[in] pxSocket The socket used for sending.
+ * @param[in] pvBuffer The character buffer as provided by the caller.
+ * @param[in] uxTotalDataLength The number of byte in the buffer.
+ * @param[in] xFlags The flags that were passed to FreeRTOS_sendto().
+ * @param[in] pxDestinationAddress The IP-address to which the packets must be sent.
+ * @param[in] uxPayloadOffset The offset of the UDP payload in each packet.
+ * @param[in] uxMaxPayloadLength The maximum payload of a datagram.
+ * @return The number of bytes passed to the IP-task, either 'uxTotalDataLength'
+ *         or zero. -pdFREERTOS_ERRNO_EADDRNOTAVAIL when the address of the
+ *         destination could not be resolved.
+ */
+    static int32_t prvSendTo_Segments( FreeRTOS_Socket_t * pxSocket,
+                                       const void * pvBuffer,
+                                       size_t uxTotalDataLength,
+                                       BaseType_t xFlags,
+                                       const struct freertos_sockaddr * pxDestinationAddress,
+                                       size_t uxPayloadOffset,
+                                       size_t uxMaxPayloadLength )
+    {
+        int32_t lReturn = 0;
+        size_t uxSegmentSize = ( size_t ) pxSocket->u.xUDP.usSegmentSize;
+        size_t uxOffset = 0U;
+        size_t uxLength;
+        TickType_t xTicksToWait = pxSocket->xSendBlockTime;
+        TimeOut_t xTimeOut;
+        NetworkBufferDescriptor_t * pxNetworkBuffer = NULL;
+        NetworkBufferDescriptor_t * pxHead = NULL;
+        NetworkBufferDescriptor_t * pxTail = NULL;
+        IPStackEvent_t xStackTxEvent = { eStackTxSegmentsEvent, NULL };
+        const uint8_t * pucSource = ( const uint8_t * ) pvBuffer;
+
+        if( ( ( ( UBaseType_t ) xFlags & ( UBaseType_t ) FREERTOS_MSG_DONTWAIT ) != 0U ) ||
+            ( xIsCallingFromIPTask() != pdFALSE ) )
+        {
+            xTicksToWait = ( TickType_t ) 0U;
+        }
+
+        vTaskSetTimeOutState( &xTimeOut );
+
+        if( ( uxSegmentSize > uxMaxPayloadLength ) ||
+            ( uxTotalDataLength > ( uxSegmentSize * socketUDP_MAX_SEGMENTS ) ) )
+        {
+            /* The segments do not fit in a packet, or there are too many. */
+            iptraceSENDTO_DATA_TOO_LONG();
+        }
+        else if( prvMakeSureSocketIsBound( pxSocket ) == pdFALSE )
+        {
+            iptraceSENDTO_SOCKET_NOT_BOUND();
+        }
+
+        #if ( ipconfigUSE_IPv4 != 0 )
+            else if( ( pxDestinationAddress->sin_family == ( uint8_t ) FREERTOS_AF_INET4 ) &&
+                     ( prvSendTo_SegmentsResolve( pxDestinationAddress->sin_address.ulIP_IPv4, xTicksToWait ) == pdFALSE ) )
+            {
+                lReturn = -pdFREERTOS_ERRNO_EADDRNOTAVAIL;
+            }
+        #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+        else
+        {
+            if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdTRUE )
+            {
+                /* The entire block time has been used up. */
+                xTicksToWait = ( TickType_t ) 0;
+            }
+
+            while( uxOffset < uxTotalDataLength )
+            {
+                uxLength = FreeRTOS_min_size_t( uxSegmentSize, uxTotalDataLength - uxOffset );
+
+                /* Do not block while holding network buffers, another task
+                 * might be waiting for them. */
+                pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxPayloadOffset + uxLength,
+                                                                    ( pxHead == NULL ) ? xTicksToWait : ( TickType_t ) 0U );
+
+                if( pxNetworkBuffer == NULL )
+                {
+                    iptraceNO_BUFFER_FOR_SENDTO();
+                    break;
+                }
+
+                ( void ) memcpy( &( pxNetworkBuffer->pucEthernetBuffer[ uxPayloadOffset ] ), &( pucSource[ uxOffset ] ), uxLength );
+
+                if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdTRUE )
+                {
+                    /* The entire block time has been used up. */
+                    xTicksToWait = ( TickType_t ) 0;
+                }
+
+                pxNetworkBuffer->pxEndPoint = pxSocket->pxEndPoint;
+                prvSendTo_PreparePacket( pxSocket, pxNetworkBuffer, uxLength, pxDestinationAddress, uxPayloadOffset );
+                pxNetworkBuffer->pxNextBuffer = NULL;
+
+                if( pxTail == NULL )
+                {
+                    pxHead = pxNetworkBuffer;
+                }
+                else
+                {
+                    pxTail->pxNextBuffer = pxNetworkBuffer;
+                }
+
+                pxTail = pxNetworkBuffer;
+                uxOffset += uxLength;
+            }
+
+            if( pxNetworkBuffer != NULL )
+            {
+                xStackTxEvent.pvData = pxHead;
+
+                if( xSendEventStructToIPTask( &xStackTxEvent, xTicksToWait ) == pdPASS )
+                {
+                    lReturn = ( int32_t ) uxTotalDataLength;
+                    pxHead = NULL;
+
+                    #if ( ipconfigUSE_CALLBACKS == 1 )
+                    {
+                        if( ipconfigIS_VALID_PROG_ADDRESS( pxSocket->u.xUDP.pxHandleSent ) )
+                        {
+                            pxSocket->u.xUDP.pxHandleSent( pxSocket, uxTotalDataLength );
+                        }
+                    }
+                    #endif /* ipconfigUSE_CALLBACKS */
+                }
+                else
+                {
+                    iptraceSTACK_TX_EVENT_LOST( ipSTACK_TX_EVENT );
+                }
+            }
+
+            /* Release the packets when the buffer could not be sent entirely. */
+            while( pxHead != NULL )
+            {
+                pxNetworkBuffer = pxHead;
+                pxHead = pxNetworkBuffer->pxNextBuffer;
+                pxNetworkBuffer->pxNextBuffer = NULL;
+                vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+            }
+        }
+
+        return lReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_IPv4 != 0 )
+
+/**
+ * @brief Make sure that the MAC address of an IPv4 destination is known, before
+ *        the segments of a large buffer are queued.
+ * @param[in] ulIPAddress The IPv4 address of the destination.
+ * @param[in] xTicksToWait The maximum time to wait for an ARP reply. When zero,
+ *                         an ARP request is sent and the function returns
+ *                         immediately.
+ * @return pdTRUE when the address is resolved, or when called from the IP-task,
+ *         which can not wait for an ARP reply.
+ */
+        static BaseType_t prvSendTo_SegmentsResolve( uint32_t ulIPAddress,
+                                                     TickType_t xTicksToWait )
+        {
+            BaseType_t xReturn = pdFALSE;
+            uint32_t ulIPAddressCopy = ulIPAddress;
+            MACAddress_t xMACAddress;
+            NetworkEndPoint_t * pxEndPoint = NULL;
+            eResolutionLookupResult_t eResult;
+
+            if( xIsCallingFromIPTask() != pdFALSE )
+            {
+                xReturn = pdTRUE;
+            }
+            else if( xTicksToWait == ( TickType_t ) 0U )
+            {
+                eResult = eARPGetCacheEntry( &( ulIPAddressCopy ), &( xMACAddress ), &( pxEndPoint ) );
+
+                if( eResult == eResolutionCacheHit )
+                {
+                    xReturn = pdTRUE;
+                }
+                else if( eResult == eResolutionCacheMiss )
+                {
+                    /* A later call may find the address. */
+                    FreeRTOS_OutputARPRequest( ulIPAddressCopy );
+                }
+                else
+                {
+                    /* No route to the destination. */
+                }
+            }
+            else if( xARPWaitResolution( ulIPAddress, xTicksToWait ) == 0 )
+            {
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                /* No ARP reply in time. */
+            }
+
+            return xReturn;
+        }
+/*-----------------------------------------------------------*/
+
+    #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+
+#endif /* ipconfigUSE_UDP_SEGMENTATION == 1 */
+/*-----------------------------------------------------------*/
+
 /**
  * @brief binds a socket to a local port number. If port 0 is provided,
  *        a system provided port number will be assigned. This function
@@ -1789,16 +2646,33 @@ static BaseType_t prvSocketBindAdd( FreeRTOS_Socket_t * pxSocket,
                                     BaseType_t xInternal )
 {
     BaseType_t xReturn = 0;
+    BaseType_t xPortInUse = pdFALSE;
 
     /* Check to ensure the port is not already in use.  If the bind is
      * called internally, a port MAY be used by more than one socket. */
     if( ( ( xInternal == pdFALSE ) || ( pxSocket->ucProtocol != ( uint8_t ) FREERTOS_IPPROTO_TCP ) ) &&
         ( pxListFindListItemWithValue( pxSocketList, ( TickType_t ) pxAddress->sin_port ) != NULL ) )
     {
-        FreeRTOS_debug_printf( ( "vSocketBind: %sP port %d in use\n",
-                                 ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP ) ? "TC" : "UD",
-                                 FreeRTOS_ntohs( pxAddress->sin_port ) ) );
-        xReturn = -pdFREERTOS_ERRNO_EADDRINUSE;
+        xPortInUse = pdTRUE;
+
+        #if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_REUSE_PORT == 1 ) )
+        {
+            /* The port may be shared by sockets that all have set the
+             * option FREERTOS_SO_REUSEPORT. */
+            if( prvTCPReusePortAllowed( pxSocket, pxSocketList, ( TickType_t ) pxAddress->sin_port ) == pdTRUE )
+            {
+                xPortInUse = pdFALSE;
+            }
+        }
+        #endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_REUSE_PORT == 1 ) */
+    }
+
+    if( xPortInUse != pdFALSE )
+    {
+        FreeRTOS_debug_printf( ( "vSocketBind: %sP port %d in use\n",
+                                 ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP ) ? "TC" : "UD",
+                                 FreeRTOS_ntohs( pxAddress->sin_port ) ) );
+        xReturn = -pdFREERTOS_ERRNO_EADDRINUSE;
     }
     else
     {
@@ -1862,11 +2736,31 @@ static BaseType_t prvSocketBindAdd( FreeRTOS_Socket_t * pxSocket,
             /* Add the socket to 'xBoundUDPSocketsList' or 'xBoundTCPSocketsList' */
             vListInsertEnd( pxSocketList, &( pxSocket->xBoundSocketListItem ) );
 
+            #if ( ipconfigUSE_UDP_PORT_HASH == 1 )
+            {
+                if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_UDP )
+                {
+                    listSET_LIST_ITEM_VALUE( &( pxSocket->u.xUDP.xHashListItem ), ( TickType_t ) pxAddress->sin_port );
+                    vListInsertEnd( &( xUDPPortHashTable[ prvUDPPortHashIndex( ( TickType_t ) pxAddress->sin_port ) ] ),
+                                    &( pxSocket->u.xUDP.xHashListItem ) );
+                }
+            }
+            #endif /* ipconfigUSE_UDP_PORT_HASH == 1 */
+
             #if ( ipconfigETHERNET_DRIVER_FILTERS_PACKETS == 1 )
             {
                 ( void ) xTaskResumeAll();
             }
             #endif /* ipconfigETHERNET_DRIVER_FILTERS_PACKETS */
+
+            #if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) )
+            {
+                if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+                {
+                    vTCPSocketHashUpdate( pxSocket );
+                }
+            }
+            #endif
         }
     }
 
@@ -2086,6 +2980,14 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
         /* For TCP: clean up a little more. */
         if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
         {
+            #if ( ipconfigUSE_TCP_TIME_WAIT == 1 )
+            {
+                /* When the connection is closing, remember it so that late
+                 * segments will not be answered with a RST. */
+                ( void ) xTCPTimeWaitAdd( pxSocket );
+            }
+            #endif
+
             #if ( ipconfigUSE_TCP_WIN == 1 )
             {
                 if( pxSocket->u.xTCP.pxAckMessage != NULL )
@@ -2107,17 +3009,48 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
 
             if( pxSocket->u.xTCP.txStream != NULL )
             {
-                iptraceMEM_STATS_DELETE( pxSocket->u.xTCP.txStream );
-                vPortFreeLarge( pxSocket->u.xTCP.txStream );
+                #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+                    /* A network buffer that is still being sent may refer to
+                     * the stream, in which case releasing that network buffer
+                     * frees the stream. */
+                    if( xStreamBufferOrphan( pxSocket->u.xTCP.txStream ) != pdFALSE )
+                #endif
+                {
+                    iptraceMEM_STATS_DELETE( pxSocket->u.xTCP.txStream );
+                    vPortFreeLarge( pxSocket->u.xTCP.txStream );
+                }
             }
 
             /* In case this is a child socket, make sure the child-count of the
              * parent socket is decreased. */
             prvTCPSetSocketCount( pxSocket );
+
+            #if ( ipconfigUSE_TCP_TIMER_WHEEL == 1 )
+            {
+                prvTCPTimerWheelForget( pxSocket );
+            }
+            #endif
         }
     }
     #endif /* ipconfigUSE_TCP == 1 */
 
+    #if ( ipconfigSUPPORT_EVENT_POLL == 1 )
+    {
+        if( pxSocket->pxEventPoll != NULL )
+        {
+            /* Make sure the socket will not be reported any more. */
+            taskENTER_CRITICAL();
+            {
+                if( pxSocket->pxEventPoll != NULL )
+                {
+                    prvEventPollUnlink( pxSocket );
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+    }
+    #endif /* ipconfigSUPPORT_EVENT_POLL */
+
     /* Socket must be unbound first, to ensure no more packets are queued on
      * it. */
     if( socketSOCKET_IS_BOUND( pxSocket ) )
@@ -2133,11 +3066,31 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
 
         ( void ) uxListRemove( &( pxSocket->xBoundSocketListItem ) );
 
+        #if ( ipconfigUSE_UDP_PORT_HASH == 1 )
+        {
+            if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_UDP )
+            {
+                ( void ) uxListRemove( &( pxSocket->u.xUDP.xHashListItem ) );
+            }
+        }
+        #endif /* ipconfigUSE_UDP_PORT_HASH == 1 */
+
         #if ( ipconfigETHERNET_DRIVER_FILTERS_PACKETS == 1 )
         {
             ( void ) xTaskResumeAll();
         }
         #endif /* ipconfigETHERNET_DRIVER_FILTERS_PACKETS */
+
+        #if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) )
+        {
+            if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+            {
+                /* The socket is not bound anymore, so it will be removed
+                 * from the hash tables. */
+                vTCPSocketHashUpdate( pxSocket );
+            }
+        }
+        #endif
     }
 
     /* Now the socket is not bound the list of waiting packets can be
@@ -2620,13 +3573,129 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
                 pxSocket->u.xTCP.xTCPWindow.u.bits.bSendFullSize = pdFALSE_UNSIGNED;
             }
 
-            if( ( pxSocket->u.xTCP.eTCPState >= eESTABLISHED ) &&
-                ( FreeRTOS_outstanding( pxSocket ) != 0 ) )
+            /* There might be some data in the TX-stream, less than full-size,
+             * which equals a MSS.  Wake-up the IP-task to check this. */
+            prvTCPWakeForTransmission( pxSocket );
+
+            xReturn = 0;
+        }
+
+        return xReturn;
+    }
+#endif /* ( ipconfigUSE_TCP != 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP != 0 )
+
+/**
+ * @brief When a connected socket has data in its TX-stream, wake up the
+ *        IP-task so that it checks whether the data can be sent now.
+ *
+ * @param[in] pxSocket The TCP socket.
+ */
+    static void prvTCPWakeForTransmission( FreeRTOS_Socket_t * pxSocket )
+    {
+        if( ( pxSocket->u.xTCP.eTCPState >= eESTABLISHED ) &&
+            ( FreeRTOS_outstanding( pxSocket ) != 0 ) )
+        {
+            pxSocket->u.xTCP.usTimeout = 1U;
+            tcpTIMER_POKE( pxSocket );
+            ( void ) xSendEventToIPTask( eTCPTimerEvent );
+        }
+    }
+#endif /* ( ipconfigUSE_TCP != 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP != 0 )
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_TCP_NODELAY, which works like
+ *        TCP_NODELAY in Linux. When set, a small segment is sent as soon as
+ *        possible, also while sent data has not been acknowledged yet.
+ *        The option can be set at any time, a listening socket passes it
+ *        on to its child sockets.
+ *
+ * @param[in] pxSocket The TCP socket.
+ * @param[in] pvOptionValue A pointer to a binary value of size
+ *            BaseType_t.
+ *
+ * @return 0 when the option was set, otherwise -pdFREERTOS_ERRNO_EINVAL.
+ */
+    static BaseType_t prvSetOptionNoDelay( FreeRTOS_Socket_t * pxSocket,
+                                           const void * pvOptionValue )
+    {
+        BaseType_t xReturn = -pdFREERTOS_ERRNO_EINVAL;
+
+        if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+        {
+            if( *( ( const BaseType_t * ) pvOptionValue ) != 0 )
+            {
+                pxSocket->u.xTCP.bits.bNoDelay = pdTRUE_UNSIGNED;
+                pxSocket->u.xTCP.xTCPWindow.u.bits.bNagle = pdFALSE_UNSIGNED;
+
+                /* A segment that was held back may be sent now. */
+                prvTCPWakeForTransmission( pxSocket );
+            }
+            else
+            {
+                pxSocket->u.xTCP.bits.bNoDelay = pdFALSE_UNSIGNED;
+
+                #if ( ipconfigUSE_TCP_NAGLE == 1 )
+                {
+                    /* The flags of the window are only valid once it has
+                     * been created, otherwise prvTCPCreateWindow() sets it. */
+                    if( pxSocket->u.xTCP.xTCPWindow.u.bits.bHasInit != pdFALSE_UNSIGNED )
+                    {
+                        pxSocket->u.xTCP.xTCPWindow.u.bits.bNagle = pdTRUE_UNSIGNED;
+                    }
+                }
+                #endif /* ipconfigUSE_TCP_NAGLE */
+            }
+
+            xReturn = 0;
+        }
+
+        return xReturn;
+    }
+#endif /* ( ipconfigUSE_TCP != 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP != 0 )
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_TCP_CORK, which works like
+ *        TCP_CORK in Linux. As long as it is set, only segments of MSS bytes
+ *        are sent, so that a message can be composed with many small calls
+ *        to FreeRTOS_send(). Clearing the option sends the remaining data.
+ *        Unlike FREERTOS_SO_SET_FULL_SIZE, the option survives the creation
+ *        of the TCP window, and it is released when the connection is
+ *        shut down, see FreeRTOS_shutdown() and FREERTOS_SO_CLOSE_AFTER_SEND.
+ *
+ * @param[in] pxSocket The TCP socket.
+ * @param[in] pvOptionValue A pointer to a binary value of size
+ *            BaseType_t.
+ *
+ * @return 0 when the option was set, otherwise -pdFREERTOS_ERRNO_EINVAL.
+ */
+    static BaseType_t prvSetOptionCork( FreeRTOS_Socket_t * pxSocket,
+                                        const void * pvOptionValue )
+    {
+        BaseType_t xReturn = -pdFREERTOS_ERRNO_EINVAL;
+
+        if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+        {
+            if( *( ( const BaseType_t * ) pvOptionValue ) != 0 )
             {
-                /* There might be some data in the TX-stream, less than full-size,
-                 * which equals a MSS.  Wake-up the IP-task to check this. */
-                pxSocket->u.xTCP.usTimeout = 1U;
-                ( void ) xSendEventToIPTask( eTCPTimerEvent );
+                pxSocket->u.xTCP.bits.bCork = pdTRUE_UNSIGNED;
+                pxSocket->u.xTCP.xTCPWindow.u.bits.bSendFullSize = pdTRUE_UNSIGNED;
+            }
+            else
+            {
+                pxSocket->u.xTCP.bits.bCork = pdFALSE_UNSIGNED;
+                pxSocket->u.xTCP.xTCPWindow.u.bits.bSendFullSize = pdFALSE_UNSIGNED;
+
+                /* Send the last part of the message. */
+                prvTCPWakeForTransmission( pxSocket );
             }
 
             xReturn = 0;
@@ -2665,6 +3734,7 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
 
             pxSocket->u.xTCP.bits.bWinChange = pdTRUE_UNSIGNED;
             pxSocket->u.xTCP.usTimeout = 1U; /* to set/clear bRxStopped */
+            tcpTIMER_POKE( pxSocket );
             ( void ) xSendEventToIPTask( eTCPTimerEvent );
             xReturn = 0;
         }
@@ -2674,6 +3744,63 @@ void * vSocketClose( FreeRTOS_Socket_t * pxSocket )
 #endif /* ( ipconfigUSE_TCP != 0 ) */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_TCP_CONGESTION.
+ *        Select the congestion control algorithm of a TCP socket by its
+ *        name, e.g. "newreno" or "cubic".  The algorithm can only be
+ *        changed before a connection is made.  A listening socket passes
+ *        its algorithm on to the sockets that it creates.
+ *
+ * @param[in] pxSocket The TCP socket whose algorithm is being set.
+ * @param[in] lLevel The option level, must be FREERTOS_IPPROTO_TCP.
+ * @param[in] pvOptionValue The name of the algorithm.
+ * @param[in] uxOptionLength The length of the name.
+ *
+ * @return 0 when the algorithm has been selected, -pdFREERTOS_ERRNO_ENOENT
+ *         when the name is unknown, -pdFREERTOS_ERRNO_EISCONN when the socket
+ *         is already connected, or else -pdFREERTOS_ERRNO_EINVAL.
+ */
+    static BaseType_t prvSetOptionTCPCongestion( FreeRTOS_Socket_t * pxSocket,
+                                                 int32_t lLevel,
+                                                 const void * pvOptionValue,
+                                                 size_t uxOptionLength )
+    {
+        BaseType_t xReturn = -pdFREERTOS_ERRNO_EINVAL;
+        const TCPCongestionOps_t * pxOps;
+
+        if( ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP ) &&
+            ( lLevel == ( int32_t ) FREERTOS_IPPROTO_TCP ) &&
+            ( pvOptionValue != NULL ) )
+        {
+            if( ( pxSocket->u.xTCP.eTCPState != eCLOSED ) &&
+                ( pxSocket->u.xTCP.eTCPState != eTCP_LISTEN ) )
+            {
+                /* The window is in use by the IP-task. */
+                xReturn = -pdFREERTOS_ERRNO_EISCONN;
+            }
+            else
+            {
+                pxOps = pxTCPWindowFindCongestionOps( ( const char * ) pvOptionValue, uxOptionLength );
+
+                if( pxOps == NULL )
+                {
+                    xReturn = -pdFREERTOS_ERRNO_ENOENT;
+                }
+                else
+                {
+                    pxSocket->u.xTCP.xTCPWindow.pxCongestionOps = pxOps;
+                    xReturn = 0;
+                }
+            }
+        }
+
+        return xReturn;
+    }
+#endif /* ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 ) */
+/*-----------------------------------------------------------*/
+
 
 /**
  * @brief Handle the socket options FREERTOS_SO_RCVTIMEO and
@@ -2755,6 +3882,79 @@ static void prvSetOptionTimeout( FreeRTOS_Socket_t * pxSocket,
 #endif /* ( ipconfigUSE_TCP != 0 ) */
 /*-----------------------------------------------------------*/
 
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_REUSE_PORT == 1 ) )
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_REUSEPORT. The option must be
+ *        set before the socket is bound, because FreeRTOS_bind() checks it.
+ *
+ * @param[in] pxSocket The TCP socket.
+ * @param[in] pvOptionValue A pointer to a binary value of size
+ *            BaseType_t.
+ *
+ * @return 0 when the option was set, otherwise -pdFREERTOS_ERRNO_EINVAL.
+ */
+    static BaseType_t prvSetOptionReusePort( FreeRTOS_Socket_t * pxSocket,
+                                             const void * pvOptionValue )
+    {
+        BaseType_t xReturn = -pdFREERTOS_ERRNO_EINVAL;
+
+        if( ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP ) &&
+            ( !socketSOCKET_IS_BOUND( pxSocket ) ) )
+        {
+            if( *( ( const BaseType_t * ) pvOptionValue ) != 0 )
+            {
+                pxSocket->u.xTCP.bits.bReusePort = pdTRUE_UNSIGNED;
+            }
+            else
+            {
+                pxSocket->u.xTCP.bits.bReusePort = pdFALSE_UNSIGNED;
+            }
+
+            xReturn = 0;
+        }
+
+        return xReturn;
+    }
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_REUSE_PORT == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_ACK_POLICY == 1 ) )
+
+/**
+ * @brief Handle the socket option FREERTOS_SO_TCP_ACK_POLICY, which sets
+ *        the delayed-ACK policy of a TCP socket. A listening socket passes
+ *        the policy on to its child sockets.
+ *
+ * @param[in] pxSocket The TCP socket.
+ * @param[in] pvOptionValue A pointer to a TCPAckPolicy_t.
+ * @param[in] uxOptionLength The size of the structure.
+ *
+ * @return 0 when the option was set, otherwise -pdFREERTOS_ERRNO_EINVAL.
+ */
+    static BaseType_t prvSetOptionAckPolicy( FreeRTOS_Socket_t * pxSocket,
+                                             const void * pvOptionValue,
+                                             size_t uxOptionLength )
+    {
+        BaseType_t xReturn = -pdFREERTOS_ERRNO_EINVAL;
+        const TCPAckPolicy_t * pxPolicy = ( const TCPAckPolicy_t * ) pvOptionValue;
+
+        if( ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP ) &&
+            ( uxOptionLength == sizeof( TCPAckPolicy_t ) ) &&
+            ( pxPolicy->usAckDelayMs <= tcpDELAYED_ACK_MAX_DELAY_MS ) )
+        {
+            ( void ) memcpy( &( pxSocket->u.xTCP.xAckPolicy ), pxPolicy, sizeof( pxSocket->u.xTCP.xAckPolicy ) );
+
+            /* The first segments of a connection are acknowledged at once. */
+            pxSocket->u.xTCP.ucQuickAcks = pxPolicy->ucQuickAckCount;
+            xReturn = 0;
+        }
+
+        return xReturn;
+    }
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_ACK_POLICY == 1 ) */
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigUSE_TCP != 0 )
 
 /**
@@ -2797,12 +3997,14 @@ static void prvSetOptionTimeout( FreeRTOS_Socket_t * pxSocket,
  * @brief Set the socket options for the given socket.
  *
  * @param[in] xSocket The socket for which the options are to be set.
- * @param[in] lLevel Not used. Parameter is used to maintain the Berkeley sockets
- *                    standard.
+ * @param[in] lLevel Only used by FREERTOS_SO_TCP_CONGESTION, which requires
+ *                   FREERTOS_IPPROTO_TCP. Otherwise the parameter is only used
+ *                   to maintain the Berkeley sockets standard.
  * @param[in] lOptionName The name of the option to be set.
  * @param[in] pvOptionValue The value of the option to be set.
- * @param[in] uxOptionLength Not used. Parameter is used to maintain the Berkeley
- *                            sockets standard.
+ * @param[in] uxOptionLength Only used by FREERTOS_SO_TCP_CONGESTION, as the
+ *                           length of the name. Otherwise the parameter is only
+ *                           used to maintain the Berkeley sockets standard.
  *
  * @return If the option can be set with the given value, then 0 is returned. Else,
  *         an error code is returned.
@@ -2852,6 +4054,21 @@ BaseType_t FreeRTOS_setsockopt( Socket_t xSocket,
                         break;
                 #endif /* ipconfigUDP_MAX_RX_PACKETS */
 
+                #if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+                    case FREERTOS_SO_UDP_SEGMENT: /* Let FreeRTOS_sendto() split large buffers in datagrams, like Linux' UDP_SEGMENT. */
+
+                        if( ( pxSocket->ucProtocol != ( uint8_t ) FREERTOS_IPPROTO_UDP ) ||
+                            ( pvOptionValue == NULL ) )
+                        {
+                            break; /* will return -pdFREERTOS_ERRNO_EINVAL */
+                        }
+
+                        /* A value of zero turns it off. */
+                        pxSocket->u.xUDP.usSegmentSize = *( ( const uint16_t * ) pvOptionValue );
+                        xReturn = 0;
+                        break;
+                #endif /* ipconfigUSE_UDP_SEGMENTATION */
+
             case FREERTOS_SO_UDPCKSUM_OUT:
 
                 /* Turn calculating of the UDP checksum on/off for this socket. If pvOptionValue
@@ -2935,6 +4152,12 @@ BaseType_t FreeRTOS_setsockopt( Socket_t xSocket,
                         xReturn = prvSetOptionReuseListenSocket( pxSocket, pvOptionValue );
                         break;
 
+                    #if ( ipconfigUSE_TCP_REUSE_PORT == 1 )
+                        case FREERTOS_SO_REUSEPORT: /* Let several listening sockets share a port, like Linux' SO_REUSEPORT */
+                            xReturn = prvSetOptionReusePort( pxSocket, pvOptionValue );
+                            break;
+                    #endif /* ipconfigUSE_TCP_REUSE_PORT == 1 */
+
                     case FREERTOS_SO_CLOSE_AFTER_SEND: /* As soon as the last byte has been transmitted, finalise the connection */
                         xReturn = prvSetOptionCloseAfterSend( pxSocket, pvOptionValue );
                         break;
@@ -2943,11 +4166,31 @@ BaseType_t FreeRTOS_setsockopt( Socket_t xSocket,
                         xReturn = prvSetOptionSetFullSize( pxSocket, pvOptionValue );
                         break;
 
+                    case FREERTOS_SO_TCP_NODELAY: /* Do not hold back small segments, like Linux' TCP_NODELAY */
+                        xReturn = prvSetOptionNoDelay( pxSocket, pvOptionValue );
+                        break;
+
+                    case FREERTOS_SO_TCP_CORK: /* Only send full-size segments until the option is cleared, like Linux' TCP_CORK */
+                        xReturn = prvSetOptionCork( pxSocket, pvOptionValue );
+                        break;
+
+                    #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+                        case FREERTOS_SO_TCP_ACK_POLICY: /* Set the delayed-ACK policy, parameter is pointer to TCPAckPolicy_t */
+                            xReturn = prvSetOptionAckPolicy( pxSocket, pvOptionValue, uxOptionLength );
+                            break;
+                    #endif /* ipconfigUSE_TCP_ACK_POLICY == 1 */
+
                     case FREERTOS_SO_STOP_RX: /* Refuse to receive more packets. */
                         xReturn = prvSetOptionStopRX( pxSocket, pvOptionValue );
                         break;
                 #endif /* ipconfigUSE_TCP == 1 */
 
+                #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+                    case FREERTOS_SO_TCP_CONGESTION: /* Select a congestion control algorithm by name, like Linux' TCP_CONGESTION */
+                        xReturn = prvSetOptionTCPCongestion( pxSocket, lLevel, pvOptionValue, uxOptionLength );
+                        break;
+                #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+
             default:
                 /* No other options are handled. */
                 xReturn = -pdFREERTOS_ERRNO_ENOPROTOOPT;
@@ -3045,23 +4288,50 @@ static const ListItem_t * pxListFindListItemWithValue( const List_t * pxList,
 {
     const ListItem_t * pxResult = NULL;
 
-    if( ( xIPIsNetworkTaskReady() != pdFALSE ) && ( pxList != NULL ) )
+    if( xIPIsNetworkTaskReady() != pdFALSE )
     {
-        const ListItem_t * pxIterator;
+        #if ( ipconfigUSE_UDP_PORT_HASH == 1 )
+            if( pxList == &xBoundUDPSocketsList )
+            {
+                /* Only inspect the sockets in the bucket of this port number.
+                 * The item value of 'xHashListItem' is the port number. */
+                const List_t * pxBucket = &( xUDPPortHashTable[ prvUDPPortHashIndex( xWantedItemValue ) ] );
+                const ListItem_t * pxIterator;
 
-        /* MISRA Ref 11.3.1 [Misaligned access] */
-        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
-        /* coverity[misra_c_2012_rule_11_3_violation] */
-        const ListItem_t * pxEnd = ( ( const ListItem_t * ) &( pxList->xListEnd ) );
+                for( pxIterator = listGET_HEAD_ENTRY( pxBucket );
+                     pxIterator != listGET_END_MARKER( pxBucket );
+                     pxIterator = listGET_NEXT( pxIterator ) )
+                {
+                    if( listGET_LIST_ITEM_VALUE( pxIterator ) == xWantedItemValue )
+                    {
+                        const FreeRTOS_Socket_t * pxSocket = ( ( const FreeRTOS_Socket_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
 
-        for( pxIterator = listGET_HEAD_ENTRY( pxList );
-             pxIterator != pxEnd;
-             pxIterator = listGET_NEXT( pxIterator ) )
+                        pxResult = &( pxSocket->xBoundSocketListItem );
+                        break;
+                    }
+                }
+            }
+            else
+        #endif /* ipconfigUSE_UDP_PORT_HASH == 1 */
+
+        if( pxList != NULL )
         {
-            if( listGET_LIST_ITEM_VALUE( pxIterator ) == xWantedItemValue )
+            const ListItem_t * pxIterator;
+
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            const ListItem_t * pxEnd = ( ( const ListItem_t * ) &( pxList->xListEnd ) );
+
+            for( pxIterator = listGET_HEAD_ENTRY( pxList );
+                 pxIterator != pxEnd;
+                 pxIterator = listGET_NEXT( pxIterator ) )
             {
-                pxResult = pxIterator;
-                break;
+                if( listGET_LIST_ITEM_VALUE( pxIterator ) == xWantedItemValue )
+                {
+                    pxResult = pxIterator;
+                    break;
+                }
             }
         }
     }
@@ -3071,6 +4341,27 @@ static const ListItem_t * pxListFindListItemWithValue( const List_t * pxList,
 
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_UDP_PORT_HASH == 1 )
+
+/**
+ * @brief Calculate the bucket of a UDP port number in xUDPPortHashTable.
+ *
+ * @param[in] xPortNumber The port number, in network-byte-order.
+ *
+ * @return The index of the hash bucket.
+ */
+    static size_t prvUDPPortHashIndex( TickType_t xPortNumber )
+    {
+        /* Multiplicative hashing: the middle bits of the product depend on
+         * both bytes of the port number. */
+        uint32_t ulHash = ( ( uint32_t ) xPortNumber & 0xffffU ) * 0x9E3779B1U;
+
+        return ( size_t ) ( ( ulHash >> 16 ) & ( ( uint32_t ) ipconfigUDP_PORT_HASH_SIZE - 1U ) );
+    }
+
+#endif /* ipconfigUSE_UDP_PORT_HASH == 1 */
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Find the UDP socket corresponding to the port number.
  *
@@ -3557,10 +4848,10 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 
     #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
     {
+        EventBits_t xSelectBits = ( pxSocket->xEventBits >> SOCKET_EVENT_BIT_COUNT ) & ( ( EventBits_t ) eSELECT_ALL );
+
         if( pxSocket->pxSocketSet != NULL )
         {
-            EventBits_t xSelectBits = ( pxSocket->xEventBits >> SOCKET_EVENT_BIT_COUNT ) & ( ( EventBits_t ) eSELECT_ALL );
-
             if( xSelectBits != 0U )
             {
                 pxSocket->xSocketBits |= xSelectBits;
@@ -3568,6 +4859,15 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
             }
         }
 
+        #if ( ipconfigSUPPORT_EVENT_POLL == 1 )
+        {
+            if( ( pxSocket->pxEventPoll != NULL ) && ( xSelectBits != 0U ) )
+            {
+                vSocketEventPollSignal( pxSocket, xSelectBits );
+            }
+        }
+        #endif /* ipconfigSUPPORT_EVENT_POLL */
+
         pxSocket->xEventBits &= ( EventBits_t ) eSOCKET_ALL;
     }
     #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
@@ -3749,6 +5049,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 
                 /* To start an active connect. */
                 pxSocket->u.xTCP.usTimeout = 1U;
+                tcpTIMER_POKE( pxSocket );
 
                 if( xSendEventToIPTask( eTCPTimerEvent ) != pdPASS )
                 {
@@ -4125,6 +5426,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                     pxSocket->u.xTCP.bits.bLowWater = pdFALSE_UNSIGNED;
                     pxSocket->u.xTCP.bits.bWinChange = pdTRUE_UNSIGNED;
                     pxSocket->u.xTCP.usTimeout = 1U; /* because bLowWater is cleared. */
+                    tcpTIMER_POKE( pxSocket );
                     ( void ) xSendEventToIPTask( eTCPTimerEvent );
                 }
             }
@@ -4565,6 +5867,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                 /* Send a message to the IP-task so it can work on this
                 * socket.  Data is sent, let the IP-task work on it. */
                 pxSocket->u.xTCP.usTimeout = 1U;
+                tcpTIMER_POKE( pxSocket );
 
                 if( xIsCallingFromIPTask() == pdFALSE )
                 {
@@ -4761,7 +6064,28 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
                 }
 
                 ( void ) memset( pxSocket->u.xTCP.xPacket.u.ucLastPacket, 0, sizeof( pxSocket->u.xTCP.xPacket.u.ucLastPacket ) );
-                ( void ) memset( &pxSocket->u.xTCP.xTCPWindow, 0, sizeof( pxSocket->u.xTCP.xTCPWindow ) );
+
+                #if ( ipconfigUSE_TCP_WIN == 1 )
+                {
+                    /* Return the segments and the reservation of the previous
+                     * connection before the window is cleared. */
+                    vTCPWindowDestroy( &pxSocket->u.xTCP.xTCPWindow );
+                }
+                #endif
+
+                #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+                {
+                    /* Keep the congestion control algorithm that was selected. */
+                    const TCPCongestionOps_t * pxCongestionOps = pxSocket->u.xTCP.xTCPWindow.pxCongestionOps;
+
+                    ( void ) memset( &pxSocket->u.xTCP.xTCPWindow, 0, sizeof( pxSocket->u.xTCP.xTCPWindow ) );
+                    pxSocket->u.xTCP.xTCPWindow.pxCongestionOps = pxCongestionOps;
+                }
+                #else
+                {
+                    ( void ) memset( &pxSocket->u.xTCP.xTCPWindow, 0, sizeof( pxSocket->u.xTCP.xTCPWindow ) );
+                }
+                #endif
                 ( void ) memset( &pxSocket->u.xTCP.bits, 0, sizeof( pxSocket->u.xTCP.bits ) );
 
                 /* Now set the bReuseSocket flag again, because the bits have
@@ -4815,6 +6139,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 
             /* Let the IP-task perform the shutdown of the connection. */
             pxSocket->u.xTCP.usTimeout = 1U;
+            tcpTIMER_POKE( pxSocket );
             ( void ) xSendEventToIPTask( eTCPTimerEvent );
             xResult = 0;
         }
@@ -4828,7 +6153,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 #endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
 
-#if ( ipconfigUSE_TCP == 1 )
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TIMER_WHEEL == 0 ) )
 
 /**
  * @brief A TCP timer has expired, now check all TCP sockets for:
@@ -4927,10 +6252,370 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
     }
 
 
-#endif /* ipconfigUSE_TCP */
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TIMER_WHEEL == 0 ) */
 /*-----------------------------------------------------------*/
 
-#if ( ipconfigUSE_TCP == 1 )
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TIMER_WHEEL == 1 ) )
+
+/**
+ * @brief Schedule the time-out of a socket in the TCP timer wheel. A value of
+ *        'usTimeout' that differs from the scheduled value replaces the
+ *        scheduled time-out, like it would when the time-outs are counted down
+ *        by xTCPTimerCheck(). A time-out of 1 means "at the next check".
+ *        Also remember the socket when it has events for its owner.
+ *        Called by the IP-task only.
+ *
+ * @param[in] pxSocket The TCP socket.
+ */
+    void vTCPTimerWheelUpdate( FreeRTOS_Socket_t * pxSocket )
+    {
+        TimerWheelEntry_t * pxEntry = &( pxSocket->u.xTCP.xTimerEntry );
+        TickType_t xDelay;
+
+        if( pxSocket->u.xTCP.usTimeout == 0U )
+        {
+            /* The socket does not need any regular attention. */
+            vTimerWheelRemove( &xTCPTimerWheel, pxEntry );
+        }
+        else if( ( xTimerWheelEntryIsActive( pxEntry ) == pdFALSE ) ||
+                 ( pxSocket->u.xTCP.usWheelTimeout != pxSocket->u.xTCP.usTimeout ) )
+        {
+            xDelay = ( TickType_t ) pxSocket->u.xTCP.usTimeout - 1U;
+
+            if( ( xDelay == 0U ) && ( xTCPTimerWheelBusy != pdFALSE ) )
+            {
+                /* Timers that are set while handling the expired timers
+                 * will expire at the next check, not during this one. */
+                xDelay = 1U;
+            }
+
+            pxEntry->pvOwner = pxSocket;
+            pxSocket->u.xTCP.usWheelTimeout = pxSocket->u.xTCP.usTimeout;
+            vTimerWheelInsert( &xTCPTimerWheel, pxEntry, xTaskGetTickCount() + xDelay );
+        }
+        else
+        {
+            /* The socket is already scheduled with this time-out. */
+        }
+
+        if( ( pxSocket->xEventBits != 0U ) && ( pxSocket->u.xTCP.xWakeUpQueued == pdFALSE ) )
+        {
+            pxSocket->u.xTCP.xWakeUpQueued = pdTRUE;
+            pxSocket->u.xTCP.pxNextWakeUp = pxTCPWakeUpList;
+            pxTCPWakeUpList = pxSocket;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called from an API after setting 'usTimeout' of a socket. The socket
+ *        is added to a list that will be inspected by the IP-task in
+ *        xTCPTimerCheck(). The caller will send an eTCPTimerEvent.
+ *
+ * @param[in] pxSocket The TCP socket.
+ */
+    static void prvTCPTimerPoke( FreeRTOS_Socket_t * pxSocket )
+    {
+        taskENTER_CRITICAL();
+        {
+            if( pxSocket->u.xTCP.xPoked == pdFALSE )
+            {
+                pxSocket->u.xTCP.xPoked = pdTRUE;
+                pxSocket->u.xTCP.pxNextPoked = pxTCPPokedList;
+                pxTCPPokedList = pxSocket;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A socket is being closed: remove it from the timer wheel, and from
+ *        the lists of sockets that need attention.
+ *
+ * @param[in] pxSocket The TCP socket.
+ */
+    static void prvTCPTimerWheelForget( FreeRTOS_Socket_t * pxSocket )
+    {
+        FreeRTOS_Socket_t ** ppxLink;
+
+        vTimerWheelRemove( &xTCPTimerWheel, &( pxSocket->u.xTCP.xTimerEntry ) );
+
+        if( pxSocket->u.xTCP.xWakeUpQueued != pdFALSE )
+        {
+            for( ppxLink = &( pxTCPWakeUpList ); *ppxLink != NULL; ppxLink = &( ( *ppxLink )->u.xTCP.pxNextWakeUp ) )
+            {
+                if( *ppxLink == pxSocket )
+                {
+                    *ppxLink = pxSocket->u.xTCP.pxNextWakeUp;
+                    break;
+                }
+            }
+
+            pxSocket->u.xTCP.xWakeUpQueued = pdFALSE;
+        }
+
+        taskENTER_CRITICAL();
+        {
+            if( pxSocket->u.xTCP.xPoked != pdFALSE )
+            {
+                for( ppxLink = &( pxTCPPokedList ); *ppxLink != NULL; ppxLink = &( ( *ppxLink )->u.xTCP.pxNextPoked ) )
+                {
+                    if( *ppxLink == pxSocket )
+                    {
+                        *ppxLink = pxSocket->u.xTCP.pxNextPoked;
+                        break;
+                    }
+                }
+
+                pxSocket->u.xTCP.xPoked = pdFALSE;
+            }
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A TCP timer has expired, now check the TCP sockets whose time-out
+ *        has expired in the timer wheel, see xTCPSocketCheck(). Only the
+ *        sockets that need attention are visited.
+ *
+ * @param[in] xWillSleep Whether the calling task is going to sleep.
+ *
+ * @return Minimum amount of time before the timer shall expire.
+ */
+    TickType_t xTCPTimerCheck( BaseType_t xWillSleep )
+    {
+        FreeRTOS_Socket_t * pxSocket;
+        FreeRTOS_Socket_t * pxNextSocket;
+        TimerWheelEntry_t * pxEntry;
+        TickType_t xShortest = pdMS_TO_TICKS( ( TickType_t ) ipTCP_TIMER_PERIOD_MS );
+        TickType_t xNow = xTaskGetTickCount();
+        TickType_t xNextTimeout;
+
+        /* Schedule the sockets whose time-out was set by an API. */
+        taskENTER_CRITICAL();
+        {
+            pxSocket = pxTCPPokedList;
+            pxTCPPokedList = NULL;
+        }
+        taskEXIT_CRITICAL();
+
+        while( pxSocket != NULL )
+        {
+            pxNextSocket = pxSocket->u.xTCP.pxNextPoked;
+            pxSocket->u.xTCP.xPoked = pdFALSE;
+            vTCPTimerWheelUpdate( pxSocket );
+            pxSocket = pxNextSocket;
+        }
+
+        xTCPTimerWheelBusy = pdTRUE;
+        pxEntry = pxTimerWheelNextExpired( &xTCPTimerWheel, xNow );
+
+        while( pxEntry != NULL )
+        {
+            pxSocket = ( FreeRTOS_Socket_t * ) pxEntry->pvOwner;
+
+            if( pxSocket->u.xTCP.usTimeout != 0U )
+            {
+                pxSocket->u.xTCP.usTimeout = 0U;
+
+                /* Within this function, the socket might want to send a delayed
+                 * ack or send out data or whatever it needs to do. When the
+                 * socket is still alive, it will call vTCPTimerWheelUpdate(). */
+                ( void ) xTCPSocketCheck( pxSocket );
+            }
+
+            pxEntry = pxTimerWheelNextExpired( &xTCPTimerWheel, xNow );
+        }
+
+        xTCPTimerWheelBusy = pdFALSE;
+
+        /* In xEventBits the driver may indicate that the socket has
+         * important events for the user.  These are only done just before the
+         * IP-task goes to sleep. */
+        if( pxTCPWakeUpList != NULL )
+        {
+            if( xWillSleep != pdFALSE )
+            {
+                while( pxTCPWakeUpList != NULL )
+                {
+                    pxSocket = pxTCPWakeUpList;
+                    pxTCPWakeUpList = pxSocket->u.xTCP.pxNextWakeUp;
+                    pxSocket->u.xTCP.xWakeUpQueued = pdFALSE;
+
+                    /* The IP-task is about to go to sleep, so messages can be
+                     * sent to the socket owners. */
+                    vSocketWakeUpUser( pxSocket );
+                }
+            }
+            else
+            {
+                /* Or else make sure this will be called again to wake-up
+                 * the sockets' owner. */
+                xShortest = ( TickType_t ) 0;
+            }
+        }
+
+        xNextTimeout = xTimerWheelNextTimeout( &xTCPTimerWheel, xNow );
+
+        if( xShortest > xNextTimeout )
+        {
+            xShortest = xNextTimeout;
+        }
+
+        return xShortest;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TIMER_WHEEL == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_REUSE_PORT == 1 ) )
+
+/**
+ * @brief Check if a TCP socket may be bound to a port that is already in use.
+ *        This is allowed when the socket and all sockets that are bound to
+ *        the port have set the option FREERTOS_SO_REUSEPORT.
+ *
+ * @param[in] pxSocket The socket that is being bound.
+ * @param[in] pxSocketList The list of bound sockets.
+ * @param[in] xPort The port number in network-byte-order.
+ *
+ * @return pdTRUE if the port may be shared, otherwise pdFALSE.
+ */
+    static BaseType_t prvTCPReusePortAllowed( const FreeRTOS_Socket_t * pxSocket,
+                                              const List_t * pxSocketList,
+                                              TickType_t xPort )
+    {
+        BaseType_t xReturn = pdFALSE;
+        const ListItem_t * pxIterator;
+
+        if( ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP ) &&
+            ( pxSocket->u.xTCP.bits.bReusePort != pdFALSE_UNSIGNED ) )
+        {
+            xReturn = pdTRUE;
+
+            for( pxIterator = listGET_HEAD_ENTRY( pxSocketList );
+                 pxIterator != listGET_END_MARKER( pxSocketList );
+                 pxIterator = listGET_NEXT( pxIterator ) )
+            {
+                const FreeRTOS_Socket_t * pxOther = ( ( const FreeRTOS_Socket_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+                if( ( listGET_LIST_ITEM_VALUE( pxIterator ) == xPort ) &&
+                    ( pxOther->u.xTCP.bits.bReusePort == pdFALSE_UNSIGNED ) )
+                {
+                    xReturn = pdFALSE;
+                    break;
+                }
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Scramble the bits of a 32-bit value, so that every input bit affects
+ *        every output bit.
+ *
+ * @param[in] ulValue The value to scramble.
+ *
+ * @return The scrambled value.
+ */
+    static uint32_t prvTCPReusePortMix( uint32_t ulValue )
+    {
+        uint32_t ulResult = ulValue;
+
+        ulResult ^= ulResult >> 16;
+        ulResult *= 0x45D9F35BU;
+        ulResult ^= ulResult >> 16;
+
+        return ulResult;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Several sockets may be listening to the same port. Choose one of
+ *        them using a hash of the 4-tuple, so that a new connection is
+ *        always handed to the same socket, and so that the connections are
+ *        spread evenly among the listening sockets.
+ *
+ *        Every listening socket gets a weight, calculated from the hash of
+ *        the 4-tuple and the socket itself, and the socket with the highest
+ *        weight is chosen (rendezvous hashing).  The choice for a 4-tuple
+ *        therefore does not depend on the number of listening sockets, nor on
+ *        their order in the list.  When a listening socket is added, it only
+ *        takes over the connection attempts for which it has the highest
+ *        weight.  When one is removed, only its own connection attempts move
+ *        to other sockets.
+ *
+ * @param[in] pxList The list to search, its items are owned by sockets.
+ * @param[in] uxLocalPort Local port number.
+ * @param[in] pxRemoteIP Remote (peer) IP address.
+ * @param[in] uxRemotePort Remote (peer) port.
+ *
+ * @return One of the sockets listening to uxLocalPort, or NULL.
+ */
+    static FreeRTOS_Socket_t * prvTCPReusePortSelect( const List_t * pxList,
+                                                      UBaseType_t uxLocalPort,
+                                                      const IPv46_Address_t * pxRemoteIP,
+                                                      UBaseType_t uxRemotePort )
+    {
+        FreeRTOS_Socket_t * pxResult = NULL;
+        const ListItem_t * pxIterator;
+        uint32_t ulHash = ( ( ( uint32_t ) uxLocalPort ) << 16 ) ^ ( ( uint32_t ) uxRemotePort );
+        uint32_t ulWeight;
+        uint32_t ulHighestWeight = 0U;
+
+        if( pxRemoteIP->xIs_IPv6 != pdFALSE )
+        {
+            #if ( ipconfigUSE_IPv6 != 0 )
+            {
+                size_t uxIndex;
+
+                for( uxIndex = 0U; uxIndex < ipSIZE_OF_IPv6_ADDRESS; uxIndex++ )
+                {
+                    ulHash = ( ulHash * 31U ) + ( uint32_t ) pxRemoteIP->xIPAddress.xIP_IPv6.ucBytes[ uxIndex ];
+                }
+            }
+            #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+        }
+        else
+        {
+            ulHash ^= pxRemoteIP->xIPAddress.ulIP_IPv4;
+        }
+
+        ulHash = prvTCPReusePortMix( ulHash );
+
+        for( pxIterator = listGET_HEAD_ENTRY( pxList );
+             pxIterator != listGET_END_MARKER( pxList );
+             pxIterator = listGET_NEXT( pxIterator ) )
+        {
+            FreeRTOS_Socket_t * pxSocket = ( ( FreeRTOS_Socket_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+            if( ( pxSocket->usLocalPort == ( uint16_t ) uxLocalPort ) &&
+                ( pxSocket->u.xTCP.eTCPState == eTCP_LISTEN ) )
+            {
+                /* The address of a socket does not change while it is
+                 * listening, it identifies the socket. */
+                ulWeight = prvTCPReusePortMix( ulHash ^ prvTCPReusePortMix( ( uint32_t ) ( ( uintptr_t ) pxSocket ) ) );
+
+                if( ( pxResult == NULL ) || ( ulWeight > ulHighestWeight ) )
+                {
+                    pxResult = pxSocket;
+                    ulHighestWeight = ulWeight;
+                }
+            }
+        }
+
+        return pxResult;
+    }
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_REUSE_PORT == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 0 ) )
 
 /**
  * @brief As multiple sockets may be bound to the same local port number
@@ -5010,70 +6695,329 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
             /* An exact match was not found, maybe a listening socket was
              * found. */
             pxResult = pxListenSocket;
-        }
 
+            #if ( ipconfigUSE_TCP_REUSE_PORT == 1 )
+            {
+                if( ( pxResult != NULL ) && ( pxResult->u.xTCP.bits.bReusePort != pdFALSE_UNSIGNED ) )
+                {
+                    /* The port may be shared by several listening sockets. */
+                    pxResult = prvTCPReusePortSelect( &xBoundTCPSocketsList, uxLocalPort, &( xRemoteIP ), uxRemotePort );
+                }
+            }
+            #endif /* ipconfigUSE_TCP_REUSE_PORT == 1 */
+        }
         return pxResult;
     }
 
-#endif /* ipconfigUSE_TCP */
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 0 ) */
 /*-----------------------------------------------------------*/
 
-#if ( ipconfigUSE_TCP == 1 )
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) )
 
 /**
- * @brief For the web server: borrow the circular Rx buffer for inspection.
- *        HTML driver wants to see if a sequence of 13/10/13/10 is available.
+ * @brief Spread the bits of a 32-bit key over the lower bits, so that the
+ *        key can be masked into a hash bucket index.
  *
- * @param[in] xSocket The socket whose Rx stream is to be returned.
+ * @param[in] ulKey The key to be mixed.
  *
- * @return The Rx stream of the socket if all checks pass, else NULL.
+ * @return The index of a hash bucket.
  */
-    const struct xSTREAM_BUFFER * FreeRTOS_get_rx_buf( ConstSocket_t xSocket )
+    static size_t prvTCPHashMix( uint32_t ulKey )
     {
-        const FreeRTOS_Socket_t * pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
-        const struct xSTREAM_BUFFER * pxReturn = NULL;
-
+        uint32_t ulHash = ulKey;
 
-        /* Confirm that this is a TCP socket before dereferencing structure
-         * member pointers. */
-        if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdFALSE ) == pdTRUE )
-        {
-            pxReturn = pxSocket->u.xTCP.rxStream;
-        }
+        ulHash ^= ulHash >> 16;
+        ulHash *= 0x45D9F35BU;
+        ulHash ^= ulHash >> 16;
 
-        return pxReturn;
+        return ( size_t ) ( ulHash & ( ( uint32_t ) ipconfigTCP_SOCKET_HASH_SIZE - 1U ) );
     }
-
-#endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
 
-#if ( ipconfigUSE_TCP == 1 )
-
 /**
- * @brief Create the stream buffer for the given socket.
+ * @brief Calculate the bucket of a TCP connection in xTCPSocketHashTable.
  *
- * @param[in] pxSocket the socket to create the stream for.
- * @param[in] xIsInputStream Is this input stream? pdTRUE/pdFALSE?
+ * @param[in] uxLocalPort Local port number.
+ * @param[in] pxRemoteIP Remote (peer) IP address.
+ * @param[in] uxRemotePort Remote (peer) port.
  *
- * @return The stream buffer.
+ * @return The index of the hash bucket.
  */
-    static StreamBuffer_t * prvTCPCreateStream( FreeRTOS_Socket_t * pxSocket,
-                                                BaseType_t xIsInputStream )
+    static size_t prvTCPHashIndex( UBaseType_t uxLocalPort,
+                                   const IPv46_Address_t * pxRemoteIP,
+                                   UBaseType_t uxRemotePort )
     {
-        StreamBuffer_t * pxBuffer;
-        size_t uxLength;
-        size_t uxSize;
+        uint32_t ulKey = ( ( ( uint32_t ) uxLocalPort ) << 16 ) ^ ( ( uint32_t ) uxRemotePort );
 
-        /* Now that a stream is created, the maximum size is fixed before
-         * creation, it could still be changed with setsockopt(). */
-        if( xIsInputStream != pdFALSE )
+        if( pxRemoteIP->xIs_IPv6 != pdFALSE )
         {
-            size_t uxLittlePerc = sock20_PERCENT;
-            size_t uxEnoughPerc = sock80_PERCENT;
-            size_t uxSegmentCount = pxSocket->u.xTCP.uxRxStreamSize / pxSocket->u.xTCP.usMSS;
-            static const struct Percent
+            #if ( ipconfigUSE_IPv6 != 0 )
             {
-                size_t uxPercLittle, uxPercEnough;
+                size_t uxIndex;
+
+                for( uxIndex = 0U; uxIndex < ipSIZE_OF_IPv6_ADDRESS; uxIndex++ )
+                {
+                    ulKey = ( ulKey * 31U ) + ( uint32_t ) pxRemoteIP->xIPAddress.xIP_IPv6.ucBytes[ uxIndex ];
+                }
+            }
+            #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+        }
+        else
+        {
+            ulKey ^= pxRemoteIP->xIPAddress.ulIP_IPv4;
+        }
+
+        return prvTCPHashMix( ulKey );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Calculate the bucket of a listening TCP socket in xTCPListenHashTable.
+ *
+ * @param[in] uxLocalPort Local port number.
+ *
+ * @return The index of the hash bucket.
+ */
+    static size_t prvTCPListenHashIndex( UBaseType_t uxLocalPort )
+    {
+        return prvTCPHashMix( ( uint32_t ) uxLocalPort );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Store a TCP socket in the connection hash table or in the listen
+ *        index, depending on its current state. A socket that is not bound
+ *        will only be removed from the tables.
+ *
+ *        A socket may change state from within a user task, e.g. in
+ *        FreeRTOS_connect() or FreeRTOS_listen(). In that case the update is
+ *        sent to the IP-task, so that the tables are never modified while
+ *        the IP-task is inspecting them. The IP-task handles its messages in
+ *        order, so packets received after the call will see the new entry.
+ *
+ * @param[in] pxSocket The socket whose state or remote address has changed.
+ */
+    void vTCPSocketHashUpdate( FreeRTOS_Socket_t * pxSocket )
+    {
+        IPStackEvent_t xUpdateEvent;
+
+        if( ( xIsCallingFromIPTask() == pdFALSE ) && ( xIPIsNetworkTaskReady() != pdFALSE ) )
+        {
+            xUpdateEvent.eEventType = eTCPHashUpdateEvent;
+            xUpdateEvent.pvData = pxSocket;
+
+            /* Block until the message is queued, as FreeRTOS_bind() does. */
+            ( void ) xSendEventStructToIPTask( &( xUpdateEvent ), ( TickType_t ) portMAX_DELAY );
+        }
+        else
+        {
+            prvTCPSocketHashStore( pxSocket );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Store a TCP socket in the hash tables. Only called by the IP-task,
+ *        or before the IP-task is running.
+ *
+ * @param[in] pxSocket The socket whose state or remote address has changed.
+ */
+    static void prvTCPSocketHashStore( FreeRTOS_Socket_t * pxSocket )
+    {
+        ListItem_t * pxHashItem = &( pxSocket->u.xTCP.xHashListItem );
+        List_t * pxList = NULL;
+
+        if( socketSOCKET_IS_BOUND( pxSocket ) )
+        {
+            if( pxSocket->u.xTCP.eTCPState == eTCP_LISTEN )
+            {
+                pxList = &( xTCPListenHashTable[ prvTCPListenHashIndex( ( UBaseType_t ) pxSocket->usLocalPort ) ] );
+            }
+            else
+            {
+                IPv46_Address_t xRemoteIP;
+
+                ( void ) memset( &( xRemoteIP ), 0, sizeof( xRemoteIP ) );
+
+                #if ( ipconfigUSE_IPv6 != 0 )
+                    if( pxSocket->bits.bIsIPv6 != pdFALSE_UNSIGNED )
+                    {
+                        ( void ) memcpy( xRemoteIP.xIPAddress.xIP_IPv6.ucBytes, pxSocket->u.xTCP.xRemoteIP.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                        xRemoteIP.xIs_IPv6 = pdTRUE;
+                    }
+                    else
+                #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+                {
+                    xRemoteIP.xIPAddress.ulIP_IPv4 = pxSocket->u.xTCP.xRemoteIP.ulIP_IPv4;
+                }
+
+                pxList = &( xTCPSocketHashTable[ prvTCPHashIndex( ( UBaseType_t ) pxSocket->usLocalPort,
+                                                                  &( xRemoteIP ),
+                                                                  ( UBaseType_t ) pxSocket->u.xTCP.usRemotePort ) ] );
+            }
+        }
+
+        if( listLIST_ITEM_CONTAINER( pxHashItem ) != NULL )
+        {
+            ( void ) uxListRemove( pxHashItem );
+        }
+
+        if( pxList != NULL )
+        {
+            vListInsertEnd( pxList, pxHashItem );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Look up a TCP socket using the hash tables: only the sockets in the
+ *        bucket of the 4-tuple will be inspected. When there is no exact
+ *        match, a socket listening to the local port is returned.
+ *
+ * @param[in] ulLocalIP Local IP address. Ignored for now.
+ * @param[in] uxLocalPort Local port number.
+ * @param[in] xRemoteIP Remote (peer) IP address.
+ * @param[in] uxRemotePort Remote (peer) port.
+ *
+ * @return The socket which was found, or NULL.
+ */
+    FreeRTOS_Socket_t * pxTCPSocketLookup( uint32_t ulLocalIP,
+                                           UBaseType_t uxLocalPort,
+                                           IPv46_Address_t xRemoteIP,
+                                           UBaseType_t uxRemotePort )
+    {
+        FreeRTOS_Socket_t * pxResult = NULL;
+        const IPv46_Address_t * pxRemoteIP = &( xRemoteIP );
+        const List_t * pxList = &( xTCPSocketHashTable[ prvTCPHashIndex( uxLocalPort, pxRemoteIP, uxRemotePort ) ] );
+        const ListItem_t * pxIterator;
+
+        /* Only the IP-task reads or modifies the tables, no locking is needed. */
+        ( void ) ulLocalIP;
+
+        for( pxIterator = listGET_HEAD_ENTRY( pxList );
+             pxIterator != listGET_END_MARKER( pxList );
+             pxIterator = listGET_NEXT( pxIterator ) )
+        {
+            FreeRTOS_Socket_t * pxSocket = ( ( FreeRTOS_Socket_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+            if( ( pxSocket->usLocalPort == ( uint16_t ) uxLocalPort ) &&
+                ( pxSocket->u.xTCP.usRemotePort == ( uint16_t ) uxRemotePort ) )
+            {
+                if( pxRemoteIP->xIs_IPv6 != pdFALSE )
+                {
+                    #if ( ipconfigUSE_IPv6 != 0 )
+                        pxResult = pxTCPSocketLookup_IPv6( pxSocket, pxRemoteIP );
+                    #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+                }
+                else if( pxSocket->u.xTCP.xRemoteIP.ulIP_IPv4 == pxRemoteIP->xIPAddress.ulIP_IPv4 )
+                {
+                    pxResult = pxSocket;
+                }
+                else
+                {
+                    /* The remote IP-address doesn't match. */
+                }
+
+                if( pxResult != NULL )
+                {
+                    break;
+                }
+            }
+        }
+
+        if( pxResult == NULL )
+        {
+            /* An exact match was not found, maybe there is a socket
+             * listening to uxLocalPort. */
+            pxList = &( xTCPListenHashTable[ prvTCPListenHashIndex( uxLocalPort ) ] );
+
+            for( pxIterator = listGET_HEAD_ENTRY( pxList );
+                 pxIterator != listGET_END_MARKER( pxList );
+                 pxIterator = listGET_NEXT( pxIterator ) )
+            {
+                FreeRTOS_Socket_t * pxSocket = ( ( FreeRTOS_Socket_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+                if( pxSocket->usLocalPort == ( uint16_t ) uxLocalPort )
+                {
+                    pxResult = pxSocket;
+                    break;
+                }
+            }
+
+            #if ( ipconfigUSE_TCP_REUSE_PORT == 1 )
+            {
+                if( ( pxResult != NULL ) && ( pxResult->u.xTCP.bits.bReusePort != pdFALSE_UNSIGNED ) )
+                {
+                    /* The port may be shared by several listening sockets,
+                     * which are all stored in the same bucket. */
+                    pxResult = prvTCPReusePortSelect( pxList, uxLocalPort, pxRemoteIP, uxRemotePort );
+                }
+            }
+            #endif /* ipconfigUSE_TCP_REUSE_PORT == 1 */
+        }
+
+        return pxResult;
+    }
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SOCKET_HASH == 1 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP == 1 )
+
+/**
+ * @brief For the web server: borrow the circular Rx buffer for inspection.
+ *        HTML driver wants to see if a sequence of 13/10/13/10 is available.
+ *
+ * @param[in] xSocket The socket whose Rx stream is to be returned.
+ *
+ * @return The Rx stream of the socket if all checks pass, else NULL.
+ */
+    const struct xSTREAM_BUFFER * FreeRTOS_get_rx_buf( ConstSocket_t xSocket )
+    {
+        const FreeRTOS_Socket_t * pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
+        const struct xSTREAM_BUFFER * pxReturn = NULL;
+
+
+        /* Confirm that this is a TCP socket before dereferencing structure
+         * member pointers. */
+        if( prvValidSocket( pxSocket, FREERTOS_IPPROTO_TCP, pdFALSE ) == pdTRUE )
+        {
+            pxReturn = pxSocket->u.xTCP.rxStream;
+        }
+
+        return pxReturn;
+    }
+
+#endif /* ipconfigUSE_TCP */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP == 1 )
+
+/**
+ * @brief Create the stream buffer for the given socket.
+ *
+ * @param[in] pxSocket the socket to create the stream for.
+ * @param[in] xIsInputStream Is this input stream? pdTRUE/pdFALSE?
+ *
+ * @return The stream buffer.
+ */
+    static StreamBuffer_t * prvTCPCreateStream( FreeRTOS_Socket_t * pxSocket,
+                                                BaseType_t xIsInputStream )
+    {
+        StreamBuffer_t * pxBuffer;
+        size_t uxLength;
+        size_t uxSize;
+
+        /* Now that a stream is created, the maximum size is fixed before
+         * creation, it could still be changed with setsockopt(). */
+        if( xIsInputStream != pdFALSE )
+        {
+            size_t uxLittlePerc = sock20_PERCENT;
+            size_t uxEnoughPerc = sock80_PERCENT;
+            size_t uxSegmentCount = pxSocket->u.xTCP.uxRxStreamSize / pxSocket->u.xTCP.usMSS;
+            static const struct Percent
+            {
+                size_t uxPercLittle, uxPercEnough;
             }
             xPercTable[] =
             {
@@ -5225,6 +7169,7 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 
                 /* bLowWater was reached, send the changed window size. */
                 pxSocket->u.xTCP.usTimeout = 1U;
+                tcpTIMER_POKE( pxSocket );
                 ( void ) xSendEventToIPTask( eTCPTimerEvent );
             }
         }
@@ -5640,6 +7585,32 @@ void vSocketWakeUpUser( FreeRTOS_Socket_t * pxSocket )
 #endif /* ipconfigUSE_TCP */
 /*-----------------------------------------------------------*/
 
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_ACK_POLICY == 1 ) )
+
+/**
+ * @brief Get the number of ACKs that were not sent, because a later ACK
+ *        acknowledged the same data, see FREERTOS_SO_TCP_ACK_POLICY.
+ *
+ * @param[in] xSocket The TCP socket.
+ *
+ * @return The number of ACKs saved, or zero when it is not a TCP socket.
+ */
+    uint32_t FreeRTOS_tcp_acks_saved( ConstSocket_t xSocket )
+    {
+        const FreeRTOS_Socket_t * pxSocket = ( const FreeRTOS_Socket_t * ) xSocket;
+        uint32_t ulReturn = 0U;
+
+        if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+        {
+            ulReturn = pxSocket->u.xTCP.ulAcksSaved;
+        }
+
+        return ulReturn;
+    }
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_ACK_POLICY == 1 ) */
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigUSE_TCP == 1 )
 
 /**
@@ -6059,6 +8030,37 @@ BaseType_t FreeRTOS_GetIPType( ConstSocket_t xSocket )
 
     #endif /* ( ipconfigUSE_TCP == 1 ) */
 
+/**
+ * @brief Check which of the select events of interest are active for a socket.
+ *
+ * @param[in] pxSocket The socket which needs to be checked.
+ * @return An event mask of events that are active for this socket.
+ */
+    static EventBits_t prvSocketSelectBits( FreeRTOS_Socket_t * pxSocket )
+    {
+        EventBits_t xSocketBits = 0;
+
+        #if ( ipconfigUSE_TCP == 1 )
+            if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
+            {
+                xSocketBits |= vSocketSelectTCP( pxSocket );
+            }
+            else
+        #endif /* ipconfigUSE_TCP == 1 */
+        {
+            /* Select events for UDP are simpler. */
+            if( ( ( pxSocket->xSelectBits & ( EventBits_t ) eSELECT_READ ) != 0U ) &&
+                ( listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) > 0U ) )
+            {
+                xSocketBits |= ( EventBits_t ) eSELECT_READ;
+            }
+
+            /* The WRITE and EXCEPT bits are not used for UDP */
+        } /* if( pxSocket->ucProtocol == FREERTOS_IPPROTO_TCP ) */
+
+        return xSocketBits;
+    }
+
 /**
  * @brief This internal non-blocking function will check all sockets that belong
  *        to a select set.  The events bits of each socket will be updated, and it
@@ -6119,25 +8121,7 @@ BaseType_t FreeRTOS_GetIPType( ConstSocket_t xSocket )
                     continue;
                 }
 
-                xSocketBits = 0;
-
-                #if ( ipconfigUSE_TCP == 1 )
-                    if( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP )
-                    {
-                        xSocketBits |= vSocketSelectTCP( pxSocket );
-                    }
-                    else
-                #endif /* ipconfigUSE_TCP == 1 */
-                {
-                    /* Select events for UDP are simpler. */
-                    if( ( ( pxSocket->xSelectBits & ( EventBits_t ) eSELECT_READ ) != 0U ) &&
-                        ( listCURRENT_LIST_LENGTH( &( pxSocket->u.xUDP.xWaitingPacketsList ) ) > 0U ) )
-                    {
-                        xSocketBits |= ( EventBits_t ) eSELECT_READ;
-                    }
-
-                    /* The WRITE and EXCEPT bits are not used for UDP */
-                } /* if( pxSocket->ucProtocol == FREERTOS_IPPROTO_TCP ) */
+                xSocketBits = prvSocketSelectBits( pxSocket );
 
                 /* Each socket keeps its own event flags, which are looked-up
                  * by FreeRTOS_FD_ISSSET() */
@@ -6176,6 +8160,517 @@ BaseType_t FreeRTOS_GetIPType( ConstSocket_t xSocket )
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION == 1 */
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigSUPPORT_EVENT_POLL == 1 )
+
+/**
+ * @brief Add a socket to the end of the ready list of its event-poll set.
+ *        Called from a critical section, the caller sets eventpollREADY_BIT
+ *        after leaving it.
+ *
+ * @param[in] pxSet The event-poll set.
+ * @param[in] pxSocket The socket that has events.
+ */
+    static void prvEventPollQueue( EventPollSet_t * pxSet,
+                                   FreeRTOS_Socket_t * pxSocket )
+    {
+        if( pxSocket->ucPollQueued == 0U )
+        {
+            pxSocket->pxNextPollReady = NULL;
+
+            if( pxSet->pxReadyTail == NULL )
+            {
+                pxSet->pxReadyHead = pxSocket;
+            }
+            else
+            {
+                pxSet->pxReadyTail->pxNextPollReady = pxSocket;
+            }
+
+            pxSet->pxReadyTail = pxSocket;
+            pxSet->uxReadyCount++;
+            pxSocket->ucPollQueued = 1U;
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Take a socket out of its event-poll set. Called from a critical
+ *        section.
+ *
+ * @param[in] pxSocket The socket that belongs to an event-poll set.
+ */
+    static void prvEventPollUnlink( FreeRTOS_Socket_t * pxSocket )
+    {
+        EventPollSet_t * pxSet = pxSocket->pxEventPoll;
+        FreeRTOS_Socket_t ** ppxLink;
+        FreeRTOS_Socket_t * pxPrevious = NULL;
+
+        for( ppxLink = &( pxSet->pxMembers ); *ppxLink != NULL; ppxLink = &( ( *ppxLink )->pxNextPollMember ) )
+        {
+            if( *ppxLink == pxSocket )
+            {
+                *ppxLink = pxSocket->pxNextPollMember;
+                break;
+            }
+        }
+
+        if( pxSocket->ucPollQueued != 0U )
+        {
+            for( ppxLink = &( pxSet->pxReadyHead ); *ppxLink != NULL; ppxLink = &( ( *ppxLink )->pxNextPollReady ) )
+            {
+                if( *ppxLink == pxSocket )
+                {
+                    *ppxLink = pxSocket->pxNextPollReady;
+
+                    if( pxSet->pxReadyTail == pxSocket )
+                    {
+                        pxSet->pxReadyTail = pxPrevious;
+                    }
+
+                    pxSet->uxReadyCount--;
+                    break;
+                }
+
+                pxPrevious = *ppxLink;
+            }
+        }
+
+        pxSocket->pxEventPoll = NULL;
+        pxSocket->pxNextPollMember = NULL;
+        pxSocket->pxNextPollReady = NULL;
+        pxSocket->xPollEvents = 0U;
+        pxSocket->ucPollQueued = 0U;
+        pxSocket->ucPollCheck = 0U;
+        pxSocket->xSelectBits = 0U;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Take at most 'xMaxResults' sockets from the ready list of a set.
+ *        A level-triggered socket that is still ready is put back at the end
+ *        of the list, so it will be reported again by the next call.  Only
+ *        called by the IP-task, which owns the state of the sockets.
+ *
+ * @param[in] pxSet The event-poll set.
+ * @param[out] pxResults The sockets and their events are written here.
+ * @param[in] xMaxResults The maximum number of results.
+ *
+ * @return The number of sockets written to 'pxResults'.
+ */
+    static BaseType_t prvEventPollCollect( EventPollSet_t * pxSet,
+                                           EventPollResult_t * pxResults,
+                                           BaseType_t xMaxResults )
+    {
+        FreeRTOS_Socket_t * pxSocket;
+        EventBits_t xEvents;
+        UBaseType_t uxLeft;
+        BaseType_t xCount = 0;
+
+        /* A user task may add or remove a socket at the same time. */
+        taskENTER_CRITICAL();
+        {
+            /* Sockets that are put back will not be visited twice. */
+            uxLeft = pxSet->uxReadyCount;
+
+            while( ( uxLeft > 0U ) && ( xCount < xMaxResults ) )
+            {
+                uxLeft--;
+                pxSocket = pxSet->pxReadyHead;
+                pxSet->pxReadyHead = pxSocket->pxNextPollReady;
+
+                if( pxSet->pxReadyHead == NULL )
+                {
+                    pxSet->pxReadyTail = NULL;
+                }
+
+                pxSet->uxReadyCount--;
+                pxSocket->pxNextPollReady = NULL;
+                pxSocket->ucPollQueued = 0U;
+
+                xEvents = pxSocket->xPollEvents;
+                pxSocket->xPollEvents = 0U;
+
+                if( pxSocket->ucPollMode == ( uint8_t ) eEventPollLevel )
+                {
+                    /* Report the current state, rather than the events that
+                     * occurred since the last call. */
+                    xEvents = prvSocketSelectBits( pxSocket );
+
+                    if( xEvents != 0U )
+                    {
+                        prvEventPollQueue( pxSet, pxSocket );
+                    }
+                }
+                else if( pxSocket->ucPollCheck != 0U )
+                {
+                    /* The socket was just added, it may be ready already. */
+                    xEvents |= prvSocketSelectBits( pxSocket );
+                }
+                else
+                {
+                    /* Edge-triggered, report the events that occurred. */
+                }
+
+                pxSocket->ucPollCheck = 0U;
+                xEvents &= pxSocket->xSelectBits;
+
+                if( xEvents != 0U )
+                {
+                    pxResults[ xCount ].xSocket = ( Socket_t ) pxSocket;
+                    pxResults[ xCount ].xEvents = xEvents;
+                    xCount++;
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return xCount;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Have the IP-task collect the ready sockets of a set, and wait for it.
+ *        The state of a socket is changed by the IP-task, so it is also
+ *        checked by the IP-task, as FreeRTOS_select() does.
+ *
+ * @param[in] pxSet The event-poll set.
+ * @param[out] pxResults The sockets and their events are written here.
+ * @param[in] xMaxResults The maximum number of results.
+ *
+ * @return The number of sockets written to 'pxResults'.
+ */
+    static BaseType_t prvEventPollRequest( EventPollSet_t * pxSet,
+                                           EventPollResult_t * pxResults,
+                                           BaseType_t xMaxResults )
+    {
+        IPStackEvent_t xEvent;
+        EventPollMessage_t xMessage;
+        BaseType_t xCount = 0;
+
+        if( xIsCallingFromIPTask() != pdFALSE )
+        {
+            xCount = prvEventPollCollect( pxSet, pxResults, xMaxResults );
+        }
+        else
+        {
+            xMessage.pxSet = pxSet;
+            xMessage.pxResults = pxResults;
+            xMessage.xMaxResults = xMaxResults;
+            xMessage.xCount = 0;
+
+            xEvent.eEventType = eEventPollWaitEvent;
+            xEvent.pvData = &( xMessage );
+
+            ( void ) xEventGroupClearBits( pxSet->xPollGroup, eventpollCOLLECTED_BIT );
+
+            if( xSendEventStructToIPTask( &xEvent, ( TickType_t ) portMAX_DELAY ) == pdFAIL )
+            {
+                FreeRTOS_debug_printf( ( "prvEventPollRequest: failed\n" ) );
+            }
+            else
+            {
+                ( void ) xEventGroupWaitBits( pxSet->xPollGroup, eventpollCOLLECTED_BIT, pdTRUE, pdFALSE, portMAX_DELAY );
+                xCount = xMessage.xCount;
+            }
+        }
+
+        return xCount;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Create an event-poll set.
+ *
+ * @return The new event-poll set, or NULL when allocation has failed.
+ */
+    EventPoll_t FreeRTOS_EventPollCreate( void )
+    {
+        EventPollSet_t * pxSet;
+
+        /* MISRA Ref 4.12.1 [Use of dynamic memory]. */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#directive-412. */
+        /* coverity[misra_c_2012_directive_4_12_violation] */
+        pxSet = ( ( EventPollSet_t * ) pvPortMalloc( sizeof( *pxSet ) ) );
+
+        if( pxSet != NULL )
+        {
+            ( void ) memset( pxSet, 0, sizeof( *pxSet ) );
+            pxSet->xPollGroup = xEventGroupCreate();
+
+            if( pxSet->xPollGroup == NULL )
+            {
+                vPortFree( pxSet );
+                pxSet = NULL;
+            }
+        }
+
+        return ( EventPoll_t ) pxSet;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Delete an event-poll set. The sockets that still belong to the set
+ *        are removed from it. No task may be waiting for the set.  The set is
+ *        deleted by the IP-task, which may be signalling one of its sockets.
+ *
+ * @param[in] xEventPoll The event-poll set being deleted.
+ */
+    void FreeRTOS_EventPollDelete( EventPoll_t xEventPoll )
+    {
+        IPStackEvent_t xDeleteEvent;
+
+        configASSERT( xEventPoll != NULL );
+
+        xDeleteEvent.eEventType = eEventPollDeleteEvent;
+        xDeleteEvent.pvData = ( void * ) xEventPoll;
+
+        if( xSendEventStructToIPTask( &xDeleteEvent, ( TickType_t ) portMAX_DELAY ) == pdFAIL )
+        {
+            FreeRTOS_printf( ( "FreeRTOS_EventPollDelete: xSendEventStructToIPTask failed\n" ) );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Add a socket to an event-poll set, or change the events of interest
+ *        of a socket that is already in the set. When the socket is ready
+ *        already, it will be reported by the next FreeRTOS_EventPollWait().
+ *
+ * @param[in] xEventPoll The event-poll set.
+ * @param[in] xSocket The socket being added.
+ * @param[in] xEvents The events of interest, a combination of eSELECT_READ,
+ *                    eSELECT_WRITE and eSELECT_EXCEPT.
+ * @param[in] eMode eEventPollLevel or eEventPollEdge.
+ *
+ * @return 0 on success, -pdFREERTOS_ERRNO_EINVAL when a parameter is not valid,
+ *         or -pdFREERTOS_ERRNO_EEXIST when the socket belongs to another
+ *         event-poll set or to a socket set.
+ */
+    BaseType_t FreeRTOS_EventPollAdd( EventPoll_t xEventPoll,
+                                      Socket_t xSocket,
+                                      EventBits_t xEvents,
+                                      eEventPollMode_t eMode )
+    {
+        EventPollSet_t * pxSet = ( EventPollSet_t * ) xEventPoll;
+        FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+        BaseType_t xReturn = 0;
+
+        if( ( pxSet == NULL ) ||
+            ( xSocketValid( pxSocket ) == pdFALSE ) ||
+            ( ( xEvents & eventpollALL_EVENTS ) == 0U ) )
+        {
+            xReturn = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            taskENTER_CRITICAL();
+            {
+                if( ( pxSocket->pxSocketSet != NULL ) ||
+                    ( ( pxSocket->pxEventPoll != NULL ) && ( pxSocket->pxEventPoll != pxSet ) ) )
+                {
+                    xReturn = -pdFREERTOS_ERRNO_EEXIST;
+                }
+                else
+                {
+                    if( pxSocket->pxEventPoll == NULL )
+                    {
+                        pxSocket->pxEventPoll = pxSet;
+                        pxSocket->pxNextPollMember = pxSet->pxMembers;
+                        pxSet->pxMembers = pxSocket;
+                    }
+
+                    pxSocket->xSelectBits = xEvents & eventpollALL_EVENTS;
+                    pxSocket->ucPollMode = ( uint8_t ) eMode;
+
+                    /* The socket may be ready already.  Its state will be
+                     * checked by the IP-task, in the next call to
+                     * FreeRTOS_EventPollWait(). */
+                    pxSocket->ucPollCheck = 1U;
+                    prvEventPollQueue( pxSet, pxSocket );
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            if( xReturn == 0 )
+            {
+                ( void ) xEventGroupSetBits( pxSet->xPollGroup, eventpollREADY_BIT );
+            }
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Remove a socket from an event-poll set.
+ *
+ * @param[in] xEventPoll The event-poll set.
+ * @param[in] xSocket The socket being removed.
+ *
+ * @return 0 on success, -pdFREERTOS_ERRNO_EINVAL when a parameter is not valid,
+ *         or -pdFREERTOS_ERRNO_ENOENT when the socket does not belong to the
+ *         set.
+ */
+    BaseType_t FreeRTOS_EventPollRemove( EventPoll_t xEventPoll,
+                                         Socket_t xSocket )
+    {
+        EventPollSet_t * pxSet = ( EventPollSet_t * ) xEventPoll;
+        FreeRTOS_Socket_t * pxSocket = ( FreeRTOS_Socket_t * ) xSocket;
+        BaseType_t xReturn = 0;
+
+        if( ( pxSet == NULL ) || ( xSocketValid( pxSocket ) == pdFALSE ) )
+        {
+            xReturn = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            taskENTER_CRITICAL();
+            {
+                if( pxSocket->pxEventPoll != pxSet )
+                {
+                    xReturn = -pdFREERTOS_ERRNO_ENOENT;
+                }
+                else
+                {
+                    prvEventPollUnlink( pxSocket );
+                }
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Wait for sockets in an event-poll set to become ready. Only the
+ *        sockets that signalled an event are visited.
+ *
+ * @param[in] xEventPoll The event-poll set.
+ * @param[out] pxResults An array in which the ready sockets and their events
+ *                       are stored.
+ * @param[in] xMaxResults The number of elements in 'pxResults'.
+ * @param[in] xBlockTimeTicks Maximum time ticks to wait for a socket to
+ *                   become ready.
+ *
+ * @return The number of sockets stored in 'pxResults', zero when the time-out
+ *         was reached, or -pdFREERTOS_ERRNO_EINVAL when a parameter is not
+ *         valid.
+ */
+    BaseType_t FreeRTOS_EventPollWait( EventPoll_t xEventPoll,
+                                       EventPollResult_t * pxResults,
+                                       BaseType_t xMaxResults,
+                                       TickType_t xBlockTimeTicks )
+    {
+        EventPollSet_t * pxSet = ( EventPollSet_t * ) xEventPoll;
+        TimeOut_t xTimeOut;
+        TickType_t xRemainingTime = xBlockTimeTicks;
+        BaseType_t xTimedOut = pdFALSE;
+        BaseType_t xCount;
+
+        if( ( pxSet == NULL ) || ( pxResults == NULL ) || ( xMaxResults <= 0 ) )
+        {
+            xCount = -pdFREERTOS_ERRNO_EINVAL;
+        }
+        else
+        {
+            vTaskSetTimeOutState( &xTimeOut );
+
+            for( ; ; )
+            {
+                xCount = prvEventPollRequest( pxSet, pxResults, xMaxResults );
+
+                if( ( xCount != 0 ) || ( xTimedOut != pdFALSE ) )
+                {
+                    break;
+                }
+
+                /* The bit is set by the IP-task when a socket is added to
+                 * the ready list. */
+                ( void ) xEventGroupWaitBits( pxSet->xPollGroup, eventpollREADY_BIT, pdTRUE, pdFALSE, xRemainingTime );
+
+                xTimedOut = xTaskCheckForTimeOut( &xTimeOut, &xRemainingTime );
+            }
+        }
+
+        return xCount;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by the IP-task when events occurred for a socket. When the
+ *        socket belongs to an event-poll set and the events are of interest,
+ *        the socket is added to the ready list of the set.
+ *
+ * @param[in] pxSocket The socket.
+ * @param[in] xEvents The events that occurred, see eSelectEvent_t.
+ */
+    void vSocketEventPollSignal( FreeRTOS_Socket_t * pxSocket,
+                                 EventBits_t xEvents )
+    {
+        EventPollSet_t * pxSet;
+        EventBits_t xInteresting;
+
+        taskENTER_CRITICAL();
+        {
+            pxSet = pxSocket->pxEventPoll;
+            xInteresting = xEvents & pxSocket->xSelectBits & eventpollALL_EVENTS;
+
+            if( ( pxSet != NULL ) && ( xInteresting != 0U ) )
+            {
+                pxSocket->xPollEvents |= xInteresting;
+                prvEventPollQueue( pxSet, pxSocket );
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        /* The set can only be deleted by the IP-task, it is still valid. */
+        if( ( pxSet != NULL ) && ( xInteresting != 0U ) )
+        {
+            ( void ) xEventGroupSetBits( pxSet->xPollGroup, eventpollREADY_BIT );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by the IP-task to collect the ready sockets of a set for a
+ *        task that is blocked in FreeRTOS_EventPollWait().
+ *
+ * @param[in] pxMessage The request, 'xCount' receives the number of results.
+ */
+    void vSocketEventPollCollect( EventPollMessage_t * pxMessage )
+    {
+        pxMessage->xCount = prvEventPollCollect( pxMessage->pxSet, pxMessage->pxResults, pxMessage->xMaxResults );
+
+        ( void ) xEventGroupSetBits( pxMessage->pxSet->xPollGroup, eventpollCOLLECTED_BIT );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by the IP-task to delete an event-poll set, see
+ *        FreeRTOS_EventPollDelete().
+ *
+ * @param[in] pxSet The event-poll set being deleted.
+ */
+    void vSocketEventPollDelete( EventPollSet_t * pxSet )
+    {
+        taskENTER_CRITICAL();
+        {
+            while( pxSet->pxMembers != NULL )
+            {
+                prvEventPollUnlink( pxSet->pxMembers );
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        vEventGroupDelete( pxSet->xPollGroup );
+        vPortFree( pxSet );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigSUPPORT_EVENT_POLL == 1 */
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigSUPPORT_SIGNALS != 0 )
 
 /**
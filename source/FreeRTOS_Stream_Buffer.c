@@ -40,6 +40,7 @@
 
 /* FreeRTOS+TCP includes. */
 #include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
 
 
 /**
@@ -423,3 +424,157 @@ size_t uxStreamBufferGet( StreamBuffer_t * const pxBuffer,
     return uxCount;
 }
 /*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_TCP_FUSED_COPY_CHECKSUM == 1 )
+
+/**
+ * @brief Read bytes from stream buffer without advancing 'uxTail', like
+ *        uxStreamBufferGet() in peek mode, and calculate their checksum
+ *        while copying them.
+ *
+ * @param[in] pxBuffer The buffer from which the bytes will be read.
+ * @param[in] uxOffset The offset from 'uxTail' where the reading starts.
+ * @param[out] pucData Where the bytes are copied to.
+ * @param[in] uxMaxCount The number of bytes to read.
+ * @param[out] pusSum The sum of the bytes read, as returned by usGenerateChecksum().
+ *
+ * @return The count of the bytes read.
+ */
+    size_t uxStreamBufferPeekChecksum( const StreamBuffer_t * const pxBuffer,
+                                       size_t uxOffset,
+                                       uint8_t * const pucData,
+                                       size_t uxMaxCount,
+                                       uint16_t * pusSum )
+    {
+        size_t uxCount;
+        uint16_t usSum = 0U;
+        uint16_t usSecond;
+
+        /* How much data is available? */
+        size_t uxSize = uxStreamBufferGetSize( pxBuffer );
+
+        if( uxSize > uxOffset )
+        {
+            uxSize -= uxOffset;
+        }
+        else
+        {
+            uxSize = 0U;
+        }
+
+        /* Use the minimum of the wanted bytes and the available bytes. */
+        uxCount = FreeRTOS_min_size_t( uxSize, uxMaxCount );
+
+        if( uxCount != 0U )
+        {
+            const size_t uxLength = pxBuffer->LENGTH;
+            size_t uxNextTail = pxBuffer->uxTail + uxOffset;
+            size_t uxFirst;
+
+            if( uxNextTail >= uxLength )
+            {
+                uxNextTail -= uxLength;
+            }
+
+            uxFirst = FreeRTOS_min_size_t( uxLength - uxNextTail, uxCount );
+            usSum = usCopyAndChecksum( 0U, pucData, &( pxBuffer->ucArray[ uxNextTail ] ), uxFirst );
+
+            if( uxCount > uxFirst )
+            {
+                usSecond = usCopyAndChecksum( 0U, &( pucData[ uxFirst ] ), pxBuffer->ucArray, uxCount - uxFirst );
+
+                if( ( uxFirst & 1U ) != 0U )
+                {
+                    /* The second part starts at an odd offset, the bytes of
+                     * its 16-bit words are in the other half. */
+                    usSecond = ( uint16_t ) ( ( usSecond << 8 ) | ( usSecond >> 8 ) );
+                }
+
+                usSum = usChecksumAdd( usSum, usSecond );
+            }
+        }
+
+        *pusSum = usSum;
+
+        return uxCount;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_TCP_FUSED_COPY_CHECKSUM == 1 */
+
+#if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+
+/**
+ * @brief Register a network buffer that sends data straight from the buffer.
+ *
+ * @param[in] pxBuffer The circular stream buffer.
+ */
+    void vStreamBufferReference( StreamBuffer_t * const pxBuffer )
+    {
+        taskENTER_CRITICAL();
+        {
+            pxBuffer->uxReferences++;
+        }
+        taskEXIT_CRITICAL();
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Drop a reference that was taken by vStreamBufferReference(). The
+ *        last reference to an orphaned stream buffer frees it.
+ *
+ * @param[in] pxBuffer The circular stream buffer.
+ */
+    void vStreamBufferDereference( StreamBuffer_t * const pxBuffer )
+    {
+        BaseType_t xFree = pdFALSE;
+
+        taskENTER_CRITICAL();
+        {
+            configASSERT( pxBuffer->uxReferences != 0U );
+            pxBuffer->uxReferences--;
+
+            if( ( pxBuffer->uxReferences == 0U ) && ( pxBuffer->xOrphaned != pdFALSE ) )
+            {
+                xFree = pdTRUE;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xFree != pdFALSE )
+        {
+            iptraceMEM_STATS_DELETE( pxBuffer );
+            vPortFreeLarge( pxBuffer );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Called by the owner of a stream buffer that does not need it any
+ *        longer.
+ *
+ * @param[in] pxBuffer The circular stream buffer.
+ *
+ * @return pdTRUE when the caller must free the stream buffer now, pdFALSE
+ *         when a network buffer still refers to it, in which case the last
+ *         call to vStreamBufferDereference() will free it.
+ */
+    BaseType_t xStreamBufferOrphan( StreamBuffer_t * const pxBuffer )
+    {
+        BaseType_t xReturn = pdTRUE;
+
+        taskENTER_CRITICAL();
+        {
+            if( pxBuffer->uxReferences != 0U )
+            {
+                pxBuffer->xOrphaned = pdTRUE;
+                xReturn = pdFALSE;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 */
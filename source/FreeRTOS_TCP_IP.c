@@ -59,6 +59,8 @@
 #include "FreeRTOS_TCP_Transmission.h"
 #include "FreeRTOS_TCP_State_Handling.h"
 #include "FreeRTOS_TCP_Utils.h"
+#include "FreeRTOS_TCP_SYN_Cache.h"
+#include "FreeRTOS_TCP_Time_Wait.h"
 
 /* Just make sure the contents doesn't get compiled if TCP is not enabled. */
 #if ipconfigUSE_TCP == 1
@@ -449,6 +451,17 @@
             }
             #endif /* ipconfigUSE_CALLBACKS */
 
+            #if ( ipconfigUSE_TCP_TIMER_WHEEL == 1 )
+            {
+                /* The parent socket may have received events for its owner,
+                 * while it is not handled by the IP-task otherwise. */
+                if( xParent != pxSocket )
+                {
+                    vTCPTimerWheelUpdate( xParent );
+                }
+            }
+            #endif
+
             if( prvTCPSocketIsActive( pxSocket->u.xTCP.eTCPState ) == 0 )
             {
                 /* Now the socket isn't in an active state anymore so it
@@ -537,6 +550,14 @@
             }
         }
 
+        #if ( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+        {
+            /* A listening socket is kept in a separate index. Also the remote
+             * address may have been set just before this state change. */
+            vTCPSocketHashUpdate( pxSocket );
+        }
+        #endif
+
         /* Touch the alive timers because moving to another state. */
         prvTCPTouchSocket( pxSocket );
 
@@ -676,6 +697,13 @@
              * keep-alive/delayed-ACK mechanism). */
         }
 
+        #if ( ipconfigUSE_TCP_TIMER_WHEEL == 1 )
+        {
+            /* Schedule the time-out in the timer wheel. */
+            vTCPTimerWheelUpdate( pxSocket );
+        }
+        #endif
+
         /* Return the number of clock ticks before the timer expires. */
         return ( TickType_t ) pxSocket->u.xTCP.usTimeout;
     }
@@ -775,6 +803,19 @@
              * the destination PORT. */
             FreeRTOS_Socket_t * pxSocket = pxTCPSocketLookup( 0U, usLocalPort, xRemoteIP, usRemotePort );
 
+            #if ( ipconfigUSE_TCP_TIME_WAIT == 1 )
+                if( ( ( pxSocket == NULL ) ||
+                      ( pxSocket->u.xTCP.eTCPState == eTCP_LISTEN ) ||
+                      ( prvTCPSocketIsActive( pxSocket->u.xTCP.eTCPState ) == pdFALSE ) ) &&
+                    ( xTCPTimeWaitProcess( pxNetworkBuffer ) != pdFALSE ) )
+                {
+                    /* The packet belongs to a connection whose socket has been
+                     * closed. It has been answered from the time-wait table. */
+                    xResult = pdFAIL;
+                }
+                else
+            #endif /* ipconfigUSE_TCP_TIME_WAIT == 1 */
+
             if( ( pxSocket == NULL ) || ( prvTCPSocketIsActive( pxSocket->u.xTCP.eTCPState ) == pdFALSE ) )
             {
                 /* A TCP messages is received but either there is no socket with the
@@ -803,6 +844,25 @@
             {
                 pxSocket->u.xTCP.ucRepCount = 0U;
 
+                #if ( ipconfigUSE_TCP_SYN_CACHE == 1 )
+                {
+                    if( ( pxSocket->u.xTCP.eTCPState == eTCP_LISTEN ) &&
+                        ( pxSocket->u.xTCP.bits.bReuseSocket == pdFALSE_UNSIGNED ) &&
+                        ( ( ucTCPFlags & ( tcpTCP_FLAG_SYN | tcpTCP_FLAG_RST | tcpTCP_FLAG_FIN | tcpTCP_FLAG_ACK ) ) == tcpTCP_FLAG_ACK ) )
+                    {
+                        /* This may be the ACK that completes a handshake that was
+                         * answered from the SYN cache. If so, the new socket will
+                         * handle the packet in the state eSYN_RECEIVED. */
+                        FreeRTOS_Socket_t * pxNewSocket = pxTCPSynCacheAccept( pxSocket, pxNetworkBuffer );
+
+                        if( pxNewSocket != NULL )
+                        {
+                            pxSocket = pxNewSocket;
+                        }
+                    }
+                }
+                #endif /* ipconfigUSE_TCP_SYN_CACHE == 1 */
+
                 if( pxSocket->u.xTCP.eTCPState == eTCP_LISTEN )
                 {
                     /* The matching socket is in a listening state.  Test if the peer
@@ -928,11 +988,27 @@
 
                 /* When there are no TCP options, the TCP offset equals 20 bytes, which is stored as
                  * the number 5 (words) in the higher nibble of the TCP-offset byte. */
+                #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                {
+                    /* Forget the time-stamp option of the previous segment. */
+                    pxSocket->u.xTCP.xTCPWindow.xTimeStamps.xReceived = pdFALSE;
+                }
+                #endif
+
                 if( ( pxTCPHeader->ucTCPOffset & tcpTCP_OFFSET_LENGTH_BITS ) > tcpTCP_OFFSET_STANDARD_LENGTH )
                 {
                     xResult = prvCheckOptions( pxSocket, pxNetworkBuffer );
                 }
 
+                #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                {
+                    if( xResult != pdFAIL )
+                    {
+                        xResult = prvCheckTimestamps( pxSocket, pxNetworkBuffer );
+                    }
+                }
+                #endif
+
                 if( xResult != pdFAIL )
                 {
                     usWindow = FreeRTOS_ntohs( pxTCPHeader->usWindow );
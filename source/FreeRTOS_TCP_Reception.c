@@ -57,6 +57,13 @@
 /* Just make sure the contents doesn't get compiled if TCP is not enabled. */
 #if ipconfigUSE_TCP == 1
 
+    #if ( ipconfigUSE_TCP_PAWS == 1 )
+
+/** @brief When TS.Recent has not been updated for 24 days, it is too old to
+ * be compared with a new TSval ( RFC 7323 section 5.5 ). */
+        #define tcpPAWS_IDLE_SECONDS    ( 24U * 24U * 3600U )
+    #endif
+
 /*
  * Identify and deal with a single TCP header option, advancing the pointer to
  * the header. This function returns pdTRUE or pdFALSE depending on whether the
@@ -310,12 +317,38 @@
                         pxTCPWindow->usMSSInit = ( uint16_t ) uxNewMSS;
                         pxTCPWindow->usMSS = ( uint16_t ) uxNewMSS;
                         pxSocket->u.xTCP.usMSS = ( uint16_t ) uxNewMSS;
+
+                        #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+                        {
+                            vTCPWindowCongestionMSSChanged( pxTCPWindow );
+                        }
+                        #endif
                     }
 
                     lIndex = ( int32_t ) tcpTCP_OPT_MSS_LEN;
                 }
             }
         }
+
+        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+            else if( pucPtr[ 0 ] == tcpTCP_OPT_TIMESTAMP )
+            {
+                /* The TCP Timestamps option: TSval and TSecr. */
+                if( ( uxRemainingOptionsBytes < tcpTCP_OPT_TIMESTAMP_LEN ) || ( pucPtr[ 1 ] != tcpTCP_OPT_TIMESTAMP_LEN ) )
+                {
+                    lIndex = -1;
+                }
+                else
+                {
+                    /* prvCheckTimestamps() will decide what to do with it. */
+                    pxTCPWindow->xTimeStamps.ulTSValue = ulChar2u32( &( pucPtr[ 2 ] ) );
+                    pxTCPWindow->xTimeStamps.ulTSEcho = ulChar2u32( &( pucPtr[ 6 ] ) );
+                    pxTCPWindow->xTimeStamps.xReceived = pdTRUE;
+
+                    lIndex = ( int32_t ) tcpTCP_OPT_TIMESTAMP_LEN;
+                }
+            }
+        #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION */
         else
         {
             /* All other options have a length field, so that we easily
@@ -350,6 +383,14 @@
                             ucLen = ( uint8_t ) ( ucLen - 8U );
                         }
 
+                        #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+                        {
+                            /* Congestion control sees one duplicate ACK, no
+                             * matter how many SACK blocks it carries. */
+                            vTCPWindowTxSackDone( &( pxSocket->u.xTCP.xTCPWindow ) );
+                        }
+                        #endif
+
                         /* ucLen should be 0 by now. */
                     }
                 }
@@ -423,6 +464,97 @@
     #endif /* ( ipconfigUSE_TCP_WIN != 0 ) */
     /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/**
+ * @brief Handle the time-stamp option of a received segment, as described in
+ *        RFC 7323. prvCheckOptions() has already stored its TSval and TSecr in
+ *        the TCP window.
+ *
+ * @param[in] pxSocket The socket handling the connection.
+ * @param[in] pxNetworkBuffer The network buffer containing the TCP packet.
+ *
+ * @return pdPASS when the segment may be processed. pdFAIL when it is an old
+ *         duplicate that must be dropped, an ACK has been sent in reply.
+ */
+        BaseType_t prvCheckTimestamps( FreeRTOS_Socket_t * pxSocket,
+                                       NetworkBufferDescriptor_t * pxNetworkBuffer )
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            const ProtocolHeaders_t * pxProtocolHeaders = ( ( ProtocolHeaders_t * )
+                                                            &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizePacket( pxNetworkBuffer ) ] ) );
+            const TCPHeader_t * pxTCPHeader = &( pxProtocolHeaders->xTCPHeader );
+            TCPWindow_t * pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
+            uint32_t ulSequenceNumber = FreeRTOS_ntohl( pxTCPHeader->ulSequenceNumber );
+            BaseType_t xReturn = pdPASS;
+
+            if( ( pxTCPHeader->ucTCPFlags & tcpTCP_FLAG_SYN ) != 0U )
+            {
+                /* Time-stamps will only be used when both the SYN and the SYN+ACK
+                 * carry the option. A connecting socket has always offered it, so
+                 * the received SYN decides. */
+                if( pxTCPWindow->xTimeStamps.xReceived != pdFALSE )
+                {
+                    pxSocket->u.xTCP.bits.bTimeStamps = pdTRUE_UNSIGNED;
+                    pxTCPWindow->xTimeStamps.ulTSRecent = pxTCPWindow->xTimeStamps.ulTSValue;
+                    pxTCPWindow->xTimeStamps.xTSRecentTime = xTaskGetTickCount();
+                }
+                else
+                {
+                    pxSocket->u.xTCP.bits.bTimeStamps = pdFALSE_UNSIGNED;
+                }
+            }
+            else if( pxSocket->u.xTCP.bits.bTimeStamps == pdFALSE_UNSIGNED )
+            {
+                /* The option was not negotiated, its TSecr can not be trusted. */
+                pxTCPWindow->xTimeStamps.xReceived = pdFALSE;
+            }
+            else if( pxTCPWindow->xTimeStamps.xReceived != pdFALSE )
+            {
+                #if ( ipconfigUSE_TCP_PAWS == 1 )
+                {
+                    TickType_t xAge = xTaskGetTickCount() - pxTCPWindow->xTimeStamps.xTSRecentTime;
+
+                    /* RST packets have been handled before, they never get here. */
+                    if( ( ( int32_t ) ( pxTCPWindow->xTimeStamps.ulTSValue - pxTCPWindow->xTimeStamps.ulTSRecent ) < 0 ) &&
+                        ( ( xAge / configTICK_RATE_HZ ) < ( TickType_t ) tcpPAWS_IDLE_SECONDS ) )
+                    {
+                        FreeRTOS_debug_printf( ( "PAWS: drop old segment %u, TSval %u < TS.Recent %u\n",
+                                                 ( unsigned ) ( ulSequenceNumber - pxTCPWindow->rx.ulFirstSequenceNumber ),
+                                                 ( unsigned ) pxTCPWindow->xTimeStamps.ulTSValue,
+                                                 ( unsigned ) pxTCPWindow->xTimeStamps.ulTSRecent ) );
+
+                        /* The ACK must carry TSopt, so the socket builds it. */
+                        prvTCPSendTimestampAck( pxSocket, pxNetworkBuffer );
+                        xReturn = pdFAIL;
+                    }
+                }
+                #endif /* ipconfigUSE_TCP_PAWS == 1 */
+
+                /* TS.Recent follows the segments that do not lie beyond the
+                 * last ACK sent, so a delayed ACK echoes the oldest TSval. */
+                if( ( xReturn != pdFAIL ) &&
+                    ( ( int32_t ) ( pxTCPWindow->xTimeStamps.ulTSValue - pxTCPWindow->xTimeStamps.ulTSRecent ) >= 0 ) &&
+                    ( xSequenceGreaterThan( ulSequenceNumber, pxTCPWindow->rx.ulCurrentSequenceNumber ) == pdFALSE ) )
+                {
+                    pxTCPWindow->xTimeStamps.ulTSRecent = pxTCPWindow->xTimeStamps.ulTSValue;
+                    pxTCPWindow->xTimeStamps.xTSRecentTime = xTaskGetTickCount();
+                }
+            }
+            else
+            {
+                /* RFC 7323 allows to drop a segment without the option, but like
+                 * most stacks, accept it. */
+            }
+
+            return xReturn;
+        }
+
+    #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+    /*-----------------------------------------------------------*/
+
 /**
  * @brief prvCheckRxData(): called from prvTCPHandleState(). The
  *        first thing that will be done is find the TCP payload data
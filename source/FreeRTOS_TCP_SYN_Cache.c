@@ -0,0 +1,912 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_TCP_SYN_Cache.c
+ * @brief A table of half-open TCP connections, used by listening sockets
+ *        when ipconfigUSE_TCP_SYN_CACHE is enabled.
+ *
+ * A SYN that arrives at a listening socket is stored in a small entry of
+ * xSynCache[], and answered with a SYN+ACK. Only when the peer sends the
+ * ACK that completes the handshake, a socket with its TCP window and stream
+ * buffers is created. A SYN flood can therefore not use up the memory and
+ * the backlog of the listening socket.
+ *
+ * When ipconfigUSE_TCP_SYN_COOKIES is enabled and the table is full, the
+ * connection is encoded in our initial sequence number (a "SYN cookie"):
+ *
+ *     bits 31..27 : a counter that increments every 64 seconds
+ *     bits 26..24 : an index in the table usCookieMSS[]
+ *     bits 23..0  : a keyed hash of the connection, the counter and the index
+ *
+ * The ACK returns the cookie plus one, from which the connection can be
+ * recreated without having stored anything.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkBufferManagement.h"
+
+#include "FreeRTOS_TCP_Transmission.h"
+#include "FreeRTOS_TCP_State_Handling.h"
+#include "FreeRTOS_TCP_Utils.h"
+#include "FreeRTOS_TCP_SYN_Cache.h"
+
+#if ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SYN_CACHE == 1 )
+
+/** @brief The time after which an entry that was not acknowledged may be reused. */
+    #if ( ipconfigTCP_HANG_PROTECTION_TIME > 0 )
+        #define synENTRY_LIFETIME    pdMS_TO_TICKS( ( uint32_t ) ipconfigTCP_HANG_PROTECTION_TIME * 1000U )
+    #else
+        #define synENTRY_LIFETIME    pdMS_TO_TICKS( 30000U )
+    #endif
+
+/** @brief The maximum length of the options in a SYN+ACK: MSS, window scaling and SACK. */
+    #define synMAX_OPTIONS_LENGTH    12U
+
+/** @brief The entry is in use. */
+    #define synFLAG_IN_USE           0x01U
+
+/** @brief The peer has an IPv6 address. */
+    #define synFLAG_IPv6             0x02U
+
+/** @brief The peer has sent the window scaling option. */
+    #define synFLAG_WIN_SCALING      0x04U
+
+    #if ( ipconfigUSE_TCP_SYN_COOKIES == 1 )
+/** @brief The period after which the counter in a cookie increments. */
+        #define synCOOKIE_PERIOD           pdMS_TO_TICKS( 64000U )
+
+/** @brief The position and the size of the counter in a cookie. */
+        #define synCOOKIE_COUNTER_SHIFT    27U
+        #define synCOOKIE_COUNTER_MASK     0x1FU
+
+/** @brief The position and the size of the MSS index in a cookie. */
+        #define synCOOKIE_MSS_SHIFT        24U
+        #define synCOOKIE_MSS_MASK         0x07U
+
+/** @brief The bits of a cookie that are filled with the hash. */
+        #define synCOOKIE_HASH_MASK        0x00FFFFFFU
+    #endif /* ipconfigUSE_TCP_SYN_COOKIES == 1 */
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Read the addresses, the port numbers and the sequence numbers of a packet
+ * into an entry, seen from the side of this host.
+ */
+    static void prvSynCacheReadPacket( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                       SynCacheEntry_t * pxEntry );
+
+/*
+ * Read the MSS and the window scaling option of a SYN into an entry.
+ */
+    static void prvSynCacheReadOptions( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                        SynCacheEntry_t * pxEntry );
+
+/*
+ * Return the entry that is in use for the same connection as 'pxKey', or NULL.
+ */
+    static SynCacheEntry_t * prvSynCacheFind( const SynCacheEntry_t * pxKey );
+
+/*
+ * Return an entry that is free or expired. When there is none, the oldest
+ * entry is returned, or NULL when SYN cookies are used.
+ */
+    static SynCacheEntry_t * prvSynCacheAllocate( TickType_t xNow );
+
+/*
+ * Send a SYN+ACK for the connection in 'pxEntry'.
+ */
+    static void prvSynCacheReply( const FreeRTOS_Socket_t * pxSocket,
+                                  NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                  const SynCacheEntry_t * pxEntry );
+
+/*
+ * Create the socket for a connection whose handshake has been completed.
+ */
+    static FreeRTOS_Socket_t * prvSynCacheCreateSocket( FreeRTOS_Socket_t * pxSocket,
+                                                        const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                                        const SynCacheEntry_t * pxEntry );
+
+    #if ( ipconfigUSE_TCP_SYN_COOKIES == 1 )
+
+/*
+ * Return the hash that protects a SYN cookie.
+ */
+        static uint32_t prvSynCookieHash( const SynCacheEntry_t * pxEntry,
+                                          uint32_t ulCounter,
+                                          uint32_t ulMSSIndex );
+
+/*
+ * Return a SYN cookie for the connection in 'pxEntry'.
+ */
+        static uint32_t prvSynCookieMake( const SynCacheEntry_t * pxEntry,
+                                          TickType_t xNow );
+
+/*
+ * Check the cookie in 'pxEntry->ulOurSequenceNumber'. When it is valid, the
+ * MSS that it carries is stored and pdTRUE is returned.
+ */
+        static BaseType_t prvSynCookieCheck( SynCacheEntry_t * pxEntry,
+                                             TickType_t xNow );
+    #endif /* ipconfigUSE_TCP_SYN_COOKIES == 1 */
+
+/*-----------------------------------------------------------*/
+
+/** @brief The half-open connections of all listening sockets. */
+    static SynCacheEntry_t xSynCache[ ipconfigTCP_SYN_CACHE_SIZE ];
+
+    #if ( ipconfigUSE_TCP_SYN_COOKIES == 1 )
+
+/** @brief The MSS values that can be encoded in a cookie, in increasing order. */
+        static const uint16_t usCookieMSS[ synCOOKIE_MSS_MASK + 1U ] = { 536U, 1024U, 1220U, 1300U, 1360U, 1400U, 1440U, 1460U };
+
+/** @brief The secret that protects the cookies. */
+        static uint32_t ulCookieSecret = 0U;
+
+/** @brief pdTRUE when ulCookieSecret has been initialised. */
+        static BaseType_t xCookieSecretSet = pdFALSE;
+    #endif
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Read the addresses, the port numbers and the sequence numbers of a
+ *        received packet into an entry.
+ *
+ * @param[in] pxNetworkBuffer The network buffer carrying the packet.
+ * @param[out] pxEntry The entry to be filled.
+ */
+    static void prvSynCacheReadPacket( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                       SynCacheEntry_t * pxEntry )
+    {
+        /* MISRA Ref 11.3.1 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        const TCPHeader_t * pxTCPHeader = ( ( const TCPHeader_t * )
+                                            &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizePacket( pxNetworkBuffer ) ] ) );
+
+        ( void ) memset( pxEntry, 0, sizeof( *pxEntry ) );
+
+        #if ( ipconfigUSE_IPv6 != 0 )
+            if( uxIPHeaderSizePacket( pxNetworkBuffer ) == ipSIZE_OF_IPv6_HEADER )
+            {
+                /* MISRA Ref 11.3.1 [Misaligned access] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                /* coverity[misra_c_2012_rule_11_3_violation] */
+                const IPHeader_IPv6_t * pxIPHeader = ( ( const IPHeader_IPv6_t * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+
+                ( void ) memcpy( pxEntry->xRemoteIP.xIP_IPv6.ucBytes, pxIPHeader->xSourceAddress.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                pxEntry->ucFlags = synFLAG_IPv6;
+            }
+            else
+        #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            const IPHeader_t * pxIPHeader = ( ( const IPHeader_t * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+
+            pxEntry->xRemoteIP.ulIP_IPv4 = FreeRTOS_ntohl( pxIPHeader->ulSourceIPAddress );
+        }
+
+        pxEntry->usLocalPort = FreeRTOS_ntohs( pxTCPHeader->usDestinationPort );
+        pxEntry->usRemotePort = FreeRTOS_ntohs( pxTCPHeader->usSourcePort );
+        pxEntry->ulPeerSequenceNumber = FreeRTOS_ntohl( pxTCPHeader->ulSequenceNumber );
+        pxEntry->ulOurSequenceNumber = FreeRTOS_ntohl( pxTCPHeader->ulAckNr );
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Read the MSS and the window scaling option of a received SYN.
+ *
+ * @param[in] pxNetworkBuffer The network buffer carrying the SYN.
+ * @param[in,out] pxEntry The entry in which the options are stored.
+ */
+    static void prvSynCacheReadOptions( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                        SynCacheEntry_t * pxEntry )
+    {
+        size_t uxTCPOffset = ipSIZE_OF_ETH_HEADER + uxIPHeaderSizePacket( pxNetworkBuffer );
+        const uint8_t * pucOptions = &( pxNetworkBuffer->pucEthernetBuffer[ uxTCPOffset + ipSIZE_OF_TCP_HEADER ] );
+        size_t uxHeaderLength = ( ( size_t ) pxNetworkBuffer->pucEthernetBuffer[ uxTCPOffset + 12U ] >> 4 ) << 2;
+        size_t uxLength = 0U;
+        size_t uxIndex = 0U;
+
+        if( ( uxHeaderLength > ipSIZE_OF_TCP_HEADER ) &&
+            ( ( uxTCPOffset + uxHeaderLength ) <= pxNetworkBuffer->xDataLength ) )
+        {
+            uxLength = uxHeaderLength - ipSIZE_OF_TCP_HEADER;
+        }
+
+        while( uxIndex < uxLength )
+        {
+            uint8_t ucOption = pucOptions[ uxIndex ];
+            size_t uxOptionLength;
+
+            if( ucOption == tcpTCP_OPT_END )
+            {
+                break;
+            }
+
+            if( ucOption == tcpTCP_OPT_NOOP )
+            {
+                uxOptionLength = 1U;
+            }
+            else if( ( uxIndex + 1U ) < uxLength )
+            {
+                uxOptionLength = pucOptions[ uxIndex + 1U ];
+            }
+            else
+            {
+                /* Truncated option. */
+                uxOptionLength = 0U;
+            }
+
+            if( ( uxOptionLength == 0U ) || ( ( uxIndex + uxOptionLength ) > uxLength ) )
+            {
+                break;
+            }
+
+            if( ( ucOption == tcpTCP_OPT_MSS ) && ( uxOptionLength == tcpTCP_OPT_MSS_LEN ) )
+            {
+                pxEntry->usPeerMSS = usChar2u16( &( pucOptions[ uxIndex + 2U ] ) );
+            }
+            else if( ( ucOption == tcpTCP_OPT_WSOPT ) && ( uxOptionLength == tcpTCP_OPT_WSOPT_LEN ) )
+            {
+                pxEntry->ucPeerWinScaleFactor = ( uint8_t ) FreeRTOS_min_uint32( pucOptions[ uxIndex + 2U ], tcpTCP_OPT_WSOPT_MAXIMUM_VALUE );
+                pxEntry->ucFlags |= synFLAG_WIN_SCALING;
+            }
+            else
+            {
+                /* Other options are not negotiated by a SYN+ACK from the cache. */
+            }
+
+            uxIndex += uxOptionLength;
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Look up the entry of a connection.
+ *
+ * @param[in] pxKey An entry filled by prvSynCacheReadPacket().
+ *
+ * @return The entry that is in use for the same connection, or NULL.
+ */
+    static SynCacheEntry_t * prvSynCacheFind( const SynCacheEntry_t * pxKey )
+    {
+        SynCacheEntry_t * pxReturn = NULL;
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigTCP_SYN_CACHE_SIZE; uxIndex++ )
+        {
+            const SynCacheEntry_t * pxEntry = &( xSynCache[ uxIndex ] );
+
+            if( ( ( pxEntry->ucFlags & synFLAG_IN_USE ) != 0U ) &&
+                ( pxEntry->usLocalPort == pxKey->usLocalPort ) &&
+                ( pxEntry->usRemotePort == pxKey->usRemotePort ) &&
+                ( ( pxEntry->ucFlags & synFLAG_IPv6 ) == ( pxKey->ucFlags & synFLAG_IPv6 ) ) &&
+                ( memcmp( pxEntry->xRemoteIP.xIP_IPv6.ucBytes, pxKey->xRemoteIP.xIP_IPv6.ucBytes, sizeof( pxEntry->xRemoteIP ) ) == 0 ) )
+            {
+                pxReturn = &( xSynCache[ uxIndex ] );
+                break;
+            }
+        }
+
+        return pxReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Find an entry for a new connection.
+ *
+ * @param[in] xNow The current time.
+ *
+ * @return An entry that is free or expired. If there is none, the oldest
+ *         entry, or NULL when SYN cookies will be used.
+ */
+    static SynCacheEntry_t * prvSynCacheAllocate( TickType_t xNow )
+    {
+        SynCacheEntry_t * pxReturn = NULL;
+        SynCacheEntry_t * pxOldest = NULL;
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigTCP_SYN_CACHE_SIZE; uxIndex++ )
+        {
+            SynCacheEntry_t * pxEntry = &( xSynCache[ uxIndex ] );
+            TickType_t xAge = xNow - pxEntry->xCreationTime;
+
+            if( ( ( pxEntry->ucFlags & synFLAG_IN_USE ) == 0U ) || ( xAge >= synENTRY_LIFETIME ) )
+            {
+                pxReturn = pxEntry;
+                break;
+            }
+
+            if( ( pxOldest == NULL ) || ( xAge > ( xNow - pxOldest->xCreationTime ) ) )
+            {
+                pxOldest = pxEntry;
+            }
+        }
+
+        #if ( ipconfigUSE_TCP_SYN_COOKIES == 0 )
+        {
+            if( pxReturn == NULL )
+            {
+                /* The table is full, forget the oldest half-open connection. */
+                pxReturn = pxOldest;
+            }
+        }
+        #else
+        {
+            ( void ) pxOldest;
+        }
+        #endif
+
+        return pxReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Send a SYN+ACK for a half-open connection. The received SYN is used
+ *        to build the reply. When it is too short to hold the options, a
+ *        bigger copy is made.
+ *
+ * @param[in] pxSocket The listening socket.
+ * @param[in] pxNetworkBuffer The network buffer carrying the SYN.
+ * @param[in] pxEntry The connection, our sequence number may be a cookie.
+ */
+    static void prvSynCacheReply( const FreeRTOS_Socket_t * pxSocket,
+                                  NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                  const SynCacheEntry_t * pxEntry )
+    {
+        size_t uxIPHeaderSize = uxIPHeaderSizePacket( pxNetworkBuffer );
+        size_t uxNeeded = ipSIZE_OF_ETH_HEADER + uxIPHeaderSize + ipSIZE_OF_TCP_HEADER + synMAX_OPTIONS_LENGTH;
+        NetworkBufferDescriptor_t * pxReply = pxNetworkBuffer;
+        BaseType_t xReleaseAfterSend = pdFALSE;
+
+        if( pxNetworkBuffer->xDataLength < uxNeeded )
+        {
+            pxReply = pxDuplicateNetworkBufferWithDescriptor( pxNetworkBuffer, uxNeeded );
+            xReleaseAfterSend = pdTRUE;
+        }
+
+        if( pxReply != NULL )
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            TCPHeader_t * pxTCPHeader = ( ( TCPHeader_t * ) &( pxReply->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSize ] ) );
+            uint16_t usMSS = ( uint16_t ) ipconfigTCP_MSS;
+            size_t uxWinSize = pxSocket->u.xTCP.uxRxWinSize * ( size_t ) ipconfigTCP_MSS;
+            UBaseType_t uxOptionsLength;
+
+            #if ( ipconfigUSE_IPv6 != 0 )
+                if( uxIPHeaderSize == ipSIZE_OF_IPv6_HEADER )
+                {
+                    /* The IPv6 header is 20 bytes longer, see prvSocketSetMSS_IPV6(). */
+                    usMSS = ( uint16_t ) ( usMSS - ( ipSIZE_OF_IPv6_HEADER - ipSIZE_OF_IPv4_HEADER ) );
+                }
+            #endif
+            usMSS = ( uint16_t ) FreeRTOS_max_uint32( usMSS, tcpMINIMUM_SEGMENT_LENGTH );
+
+            pxTCPHeader->ucOptdata[ 0 ] = ( uint8_t ) tcpTCP_OPT_MSS;
+            pxTCPHeader->ucOptdata[ 1 ] = ( uint8_t ) tcpTCP_OPT_MSS_LEN;
+            pxTCPHeader->ucOptdata[ 2 ] = ( uint8_t ) ( usMSS >> 8 );
+            pxTCPHeader->ucOptdata[ 3 ] = ( uint8_t ) ( usMSS & 0xffU );
+            uxOptionsLength = 4U;
+
+            #if ( ipconfigUSE_TCP_WIN != 0 )
+            {
+                if( ( pxEntry->ucFlags & synFLAG_WIN_SCALING ) != 0U )
+                {
+                    pxTCPHeader->ucOptdata[ 4 ] = tcpTCP_OPT_NOOP;
+                    pxTCPHeader->ucOptdata[ 5 ] = ( uint8_t ) ( tcpTCP_OPT_WSOPT );
+                    pxTCPHeader->ucOptdata[ 6 ] = ( uint8_t ) ( tcpTCP_OPT_WSOPT_LEN );
+                    pxTCPHeader->ucOptdata[ 7 ] = pxEntry->ucMyWinScaleFactor;
+                    uxOptionsLength = 8U;
+                }
+
+                pxTCPHeader->ucOptdata[ uxOptionsLength ] = tcpTCP_OPT_NOOP;
+                pxTCPHeader->ucOptdata[ uxOptionsLength + 1U ] = tcpTCP_OPT_NOOP;
+                pxTCPHeader->ucOptdata[ uxOptionsLength + 2U ] = tcpTCP_OPT_SACK_P; /* 4: Sack-Permitted Option. */
+                pxTCPHeader->ucOptdata[ uxOptionsLength + 3U ] = 2U;                /* 2: length of this option. */
+                uxOptionsLength += 4U;
+            }
+            #endif /* ipconfigUSE_TCP_WIN != 0 */
+
+            /* The window in a SYN+ACK is never scaled. */
+            if( ( pxSocket->u.xTCP.uxRxStreamSize != 0U ) && ( uxWinSize > pxSocket->u.xTCP.uxRxStreamSize ) )
+            {
+                uxWinSize = pxSocket->u.xTCP.uxRxStreamSize;
+            }
+
+            if( uxWinSize > 0xfffcU )
+            {
+                uxWinSize = 0xfffcU;
+            }
+
+            pxTCPHeader->usWindow = FreeRTOS_htons( ( uint16_t ) uxWinSize );
+            pxTCPHeader->ucTCPFlags = ( uint8_t ) ( tcpTCP_FLAG_SYN | tcpTCP_FLAG_ACK );
+            pxTCPHeader->ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + uxOptionsLength ) << 2 );
+            pxTCPHeader->usUrgent = 0U;
+
+            /* prvTCPReturnPacket() will swap the two sequence numbers. */
+            pxTCPHeader->ulSequenceNumber = FreeRTOS_htonl( pxEntry->ulPeerSequenceNumber + 1U );
+            pxTCPHeader->ulAckNr = FreeRTOS_htonl( pxEntry->ulOurSequenceNumber );
+
+            #if ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 )
+            {
+                /* The checksum of the SYN can not be adjusted for the new options.
+                 * Clear the length field, so prvTCPReturnPacket() will calculate
+                 * it again. */
+                #if ( ipconfigUSE_IPv6 != 0 )
+                    if( uxIPHeaderSize == ipSIZE_OF_IPv6_HEADER )
+                    {
+                        /* MISRA Ref 11.3.1 [Misaligned access] */
+                        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                        /* coverity[misra_c_2012_rule_11_3_violation] */
+                        IPHeader_IPv6_t * pxIPHeader = ( ( IPHeader_IPv6_t * ) &( pxReply->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+                        pxIPHeader->usPayloadLength = 0U;
+                    }
+                    else
+                #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+                {
+                    /* MISRA Ref 11.3.1 [Misaligned access] */
+                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                    /* coverity[misra_c_2012_rule_11_3_violation] */
+                    IPHeader_t * pxIPHeader = ( ( IPHeader_t * ) &( pxReply->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+                    pxIPHeader->usLength = 0U;
+                }
+            }
+            #endif /* ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 */
+
+            prvTCPReturnPacket( NULL, pxReply, ( uint32_t ) ( uxIPHeaderSize + ipSIZE_OF_TCP_HEADER + uxOptionsLength ), xReleaseAfterSend );
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Create the socket of a connection whose handshake has been completed.
+ *        The socket gets the state that it would have after sending a SYN+ACK
+ *        in the state eSYN_FIRST.
+ *
+ * @param[in] pxSocket The listening socket.
+ * @param[in] pxNetworkBuffer The network buffer carrying the final ACK.
+ * @param[in] pxEntry The connection.
+ *
+ * @return The new socket, or NULL when it could not be created.
+ */
+    static FreeRTOS_Socket_t * prvSynCacheCreateSocket( FreeRTOS_Socket_t * pxSocket,
+                                                        const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                                        const SynCacheEntry_t * pxEntry )
+    {
+        FreeRTOS_Socket_t * pxReturn = NULL;
+        FreeRTOS_Socket_t * pxNewSocket;
+        BaseType_t xFamily = FREERTOS_AF_INET;
+
+        if( ( pxEntry->ucFlags & synFLAG_IPv6 ) != 0U )
+        {
+            xFamily = FREERTOS_AF_INET6;
+        }
+
+        if( pxSocket->u.xTCP.usChildCount >= pxSocket->u.xTCP.usBacklog )
+        {
+            FreeRTOS_printf( ( "Check: Socket %u already has %u / %u child%s\n",
+                               pxSocket->usLocalPort,
+                               pxSocket->u.xTCP.usChildCount,
+                               pxSocket->u.xTCP.usBacklog,
+                               ( pxSocket->u.xTCP.usChildCount == 1U ) ? "" : "ren" ) );
+        }
+        else
+        {
+            pxNewSocket = ( FreeRTOS_Socket_t * ) FreeRTOS_socket( xFamily, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP );
+
+            /* MISRA Ref 11.4.1 [Socket error and integer to pointer conversion] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-114 */
+            /* coverity[misra_c_2012_rule_11_4_violation] */
+            if( ( pxNewSocket == NULL ) || ( pxNewSocket == FREERTOS_INVALID_SOCKET ) )
+            {
+                FreeRTOS_debug_printf( ( "TCP: SYN cache: new socket failed\n" ) );
+            }
+            else if( prvTCPSocketCopy( pxNewSocket, pxSocket ) != pdFALSE )
+            {
+                TCPWindow_t * pxTCPWindow = &( pxNewSocket->u.xTCP.xTCPWindow );
+                size_t uxCopyLength;
+
+                pxNewSocket->pxEndPoint = pxNetworkBuffer->pxEndPoint;
+
+                #if ( ipconfigUSE_IPv6 != 0 )
+                    if( xFamily == FREERTOS_AF_INET6 )
+                    {
+                        pxNewSocket->bits.bIsIPv6 = pdTRUE_UNSIGNED;
+                        ( void ) memcpy( pxNewSocket->u.xTCP.xRemoteIP.xIP_IPv6.ucBytes, pxEntry->xRemoteIP.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                    }
+                    else
+                #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+                {
+                    pxNewSocket->bits.bIsIPv6 = pdFALSE_UNSIGNED;
+                    pxNewSocket->u.xTCP.xRemoteIP.ulIP_IPv4 = pxEntry->xRemoteIP.ulIP_IPv4;
+                }
+
+                pxNewSocket->u.xTCP.usRemotePort = pxEntry->usRemotePort;
+                pxTCPWindow->ulOurSequenceNumber = pxEntry->ulOurSequenceNumber;
+                pxTCPWindow->rx.ulCurrentSequenceNumber = pxEntry->ulPeerSequenceNumber;
+                prvSocketSetMSS( pxNewSocket );
+
+                if( pxEntry->usPeerMSS != 0U )
+                {
+                    /* Do not send segments that are bigger than the peer can receive. */
+                    uint32_t ulPeerMSS = FreeRTOS_max_uint32( pxEntry->usPeerMSS, tcpMINIMUM_SEGMENT_LENGTH );
+                    pxNewSocket->u.xTCP.usMSS = ( uint16_t ) FreeRTOS_min_uint32( pxNewSocket->u.xTCP.usMSS, ulPeerMSS );
+                }
+
+                if( prvTCPCreateWindow( pxNewSocket ) != pdPASS )
+                {
+                    ( void ) vSocketClose( pxNewSocket );
+                }
+                else
+                {
+                    #if ( ipconfigUSE_TCP_WIN != 0 )
+                    {
+                        if( ( pxEntry->ucFlags & synFLAG_WIN_SCALING ) != 0U )
+                        {
+                            pxNewSocket->u.xTCP.bits.bWinScaling = pdTRUE_UNSIGNED;
+                            pxNewSocket->u.xTCP.ucPeerWinScaleFactor = pxEntry->ucPeerWinScaleFactor;
+                            pxNewSocket->u.xTCP.ucMyWinScaleFactor = pxEntry->ucMyWinScaleFactor;
+                        }
+                        else
+                        {
+                            pxNewSocket->u.xTCP.ucMyWinScaleFactor = 0U;
+                        }
+                    }
+                    #endif /* ipconfigUSE_TCP_WIN != 0 */
+
+                    /* The SYN+ACK has been sent already, so continue as
+                     * prvTCPHandleState() would after sending it. */
+                    pxTCPWindow->rx.ulCurrentSequenceNumber = pxEntry->ulPeerSequenceNumber + 1U;
+                    pxTCPWindow->rx.ulHighestSequenceNumber = pxTCPWindow->rx.ulCurrentSequenceNumber;
+                    pxTCPWindow->tx.ulCurrentSequenceNumber = pxTCPWindow->tx.ulFirstSequenceNumber + 1U;
+                    pxTCPWindow->ulNextTxSequenceNumber = pxTCPWindow->tx.ulCurrentSequenceNumber;
+                    vTCPStateChange( pxNewSocket, eSYN_RECEIVED );
+
+                    /* Make a copy of the header up to the TCP header.  It is needed later
+                     * on, whenever data must be sent to the peer. */
+                    uxCopyLength = FreeRTOS_min_size_t( pxNetworkBuffer->xDataLength, sizeof( pxNewSocket->u.xTCP.xPacket.u.ucLastPacket ) );
+                    ( void ) memcpy( ( void * ) pxNewSocket->u.xTCP.xPacket.u.ucLastPacket,
+                                     ( const void * ) pxNetworkBuffer->pucEthernetBuffer,
+                                     uxCopyLength );
+
+                    pxReturn = pxNewSocket;
+                }
+            }
+            else
+            {
+                /* Copying failed somehow, the new socket has been closed. */
+            }
+        }
+
+        return pxReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_SYN_COOKIES == 1 )
+
+/**
+ * @brief A 32-bit finaliser that spreads each input bit over the output.
+ *
+ * @param[in] ulValue The value to be mixed.
+ *
+ * @return The mixed value.
+ */
+        static uint32_t prvSynCookieMix( uint32_t ulValue )
+        {
+            uint32_t ulHash = ulValue;
+
+            ulHash ^= ulHash >> 16;
+            ulHash *= 0x85EBCA6BU;
+            ulHash ^= ulHash >> 13;
+            ulHash *= 0xC2B2AE35U;
+            ulHash ^= ulHash >> 16;
+
+            return ulHash;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Calculate the hash that protects a SYN cookie. It depends on the
+ *        secret, the connection, the initial sequence number of the peer,
+ *        the counter and the MSS index.
+ *
+ * @param[in] pxEntry The connection.
+ * @param[in] ulCounter The counter stored in the cookie.
+ * @param[in] ulMSSIndex The MSS index stored in the cookie.
+ *
+ * @return The hash, of which the lower 24 bits are used.
+ */
+        static uint32_t prvSynCookieHash( const SynCacheEntry_t * pxEntry,
+                                          uint32_t ulCounter,
+                                          uint32_t ulMSSIndex )
+        {
+            uint32_t ulHash;
+            size_t uxIndex;
+
+            ulHash = prvSynCookieMix( ulCookieSecret ^ ( ( ( uint32_t ) pxEntry->usLocalPort << 16 ) | ( uint32_t ) pxEntry->usRemotePort ) );
+
+            if( ( pxEntry->ucFlags & synFLAG_IPv6 ) != 0U )
+            {
+                for( uxIndex = 0U; uxIndex < ipSIZE_OF_IPv6_ADDRESS; uxIndex += 4U )
+                {
+                    const uint8_t * pucBytes = &( pxEntry->xRemoteIP.xIP_IPv6.ucBytes[ uxIndex ] );
+                    uint32_t ulWord = ( ( uint32_t ) pucBytes[ 0 ] << 24 ) | ( ( uint32_t ) pucBytes[ 1 ] << 16 ) |
+                                      ( ( uint32_t ) pucBytes[ 2 ] << 8 ) | ( uint32_t ) pucBytes[ 3 ];
+
+                    ulHash = prvSynCookieMix( ulHash ^ ulWord );
+                }
+            }
+            else
+            {
+                ulHash = prvSynCookieMix( ulHash ^ pxEntry->xRemoteIP.ulIP_IPv4 );
+            }
+
+            ulHash = prvSynCookieMix( ulHash ^ pxEntry->ulPeerSequenceNumber );
+            ulHash = prvSynCookieMix( ulHash ^ ulCookieSecret ^ ( ( ulCounter << 3 ) | ulMSSIndex ) );
+
+            return ulHash;
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Make a SYN cookie, to be used as our initial sequence number.
+ *
+ * @param[in] pxEntry The connection.
+ * @param[in] xNow The current time.
+ *
+ * @return The cookie.
+ */
+        static uint32_t prvSynCookieMake( const SynCacheEntry_t * pxEntry,
+                                          TickType_t xNow )
+        {
+            uint32_t ulCounter = ( uint32_t ) ( xNow / synCOOKIE_PERIOD ) & synCOOKIE_COUNTER_MASK;
+            uint32_t ulMSSIndex = synCOOKIE_MSS_MASK;
+            uint16_t usPeerMSS = pxEntry->usPeerMSS;
+
+            if( usPeerMSS == 0U )
+            {
+                /* RFC 9293: the default MSS is 536 bytes. */
+                usPeerMSS = ( uint16_t ) tcpMINIMUM_SEGMENT_LENGTH;
+            }
+
+            /* Find the biggest MSS that is not bigger than the peer's MSS. */
+            while( ( ulMSSIndex > 0U ) && ( usCookieMSS[ ulMSSIndex ] > usPeerMSS ) )
+            {
+                ulMSSIndex--;
+            }
+
+            return ( ulCounter << synCOOKIE_COUNTER_SHIFT ) |
+                   ( ulMSSIndex << synCOOKIE_MSS_SHIFT ) |
+                   ( prvSynCookieHash( pxEntry, ulCounter, ulMSSIndex ) & synCOOKIE_HASH_MASK );
+        }
+        /*-----------------------------------------------------------*/
+
+/**
+ * @brief Check a SYN cookie that was returned by the peer. A cookie is valid
+ *        during one or two periods of 64 seconds.
+ *
+ * @param[in,out] pxEntry The connection, with the cookie stored in
+ *                        'ulOurSequenceNumber'. The MSS of the cookie will
+ *                        be stored in 'usPeerMSS'.
+ * @param[in] xNow The current time.
+ *
+ * @return pdTRUE when the cookie is valid.
+ */
+        static BaseType_t prvSynCookieCheck( SynCacheEntry_t * pxEntry,
+                                             TickType_t xNow )
+        {
+            BaseType_t xReturn = pdFALSE;
+            uint32_t ulCookie = pxEntry->ulOurSequenceNumber;
+            uint32_t ulCounter = ulCookie >> synCOOKIE_COUNTER_SHIFT;
+            uint32_t ulMSSIndex = ( ulCookie >> synCOOKIE_MSS_SHIFT ) & synCOOKIE_MSS_MASK;
+            uint32_t ulAge = ( ( uint32_t ) ( xNow / synCOOKIE_PERIOD ) - ulCounter ) & synCOOKIE_COUNTER_MASK;
+
+            if( ( xCookieSecretSet != pdFALSE ) &&
+                ( ulAge <= 1U ) &&
+                ( ( prvSynCookieHash( pxEntry, ulCounter, ulMSSIndex ) & synCOOKIE_HASH_MASK ) == ( ulCookie & synCOOKIE_HASH_MASK ) ) )
+            {
+                pxEntry->usPeerMSS = usCookieMSS[ ulMSSIndex ];
+                xReturn = pdTRUE;
+            }
+
+            return xReturn;
+        }
+        /*-----------------------------------------------------------*/
+
+    #endif /* ipconfigUSE_TCP_SYN_COOKIES == 1 */
+
+/**
+ * @brief A listening socket has received a SYN: store the connection in the
+ *        SYN cache, or in a SYN cookie, and reply with a SYN+ACK.
+ *
+ * @param[in] pxSocket The listening socket.
+ * @param[in] pxNetworkBuffer The network buffer carrying the SYN. It is used
+ *                            to send the SYN+ACK, but it stays owned by the
+ *                            caller.
+ * @param[in] ulInitialSequenceNumber A new initial sequence number.
+ *
+ * @return pdTRUE when a SYN+ACK was sent.
+ */
+    BaseType_t xTCPSynCacheAdd( const FreeRTOS_Socket_t * pxSocket,
+                                NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                uint32_t ulInitialSequenceNumber )
+    {
+        BaseType_t xReturn = pdFALSE;
+        SynCacheEntry_t xKey;
+        SynCacheEntry_t * pxEntry;
+        TickType_t xNow = xTaskGetTickCount();
+
+        prvSynCacheReadPacket( pxNetworkBuffer, &xKey );
+        prvSynCacheReadOptions( pxNetworkBuffer, &xKey );
+
+        #if ( ipconfigUSE_TCP_WIN != 0 )
+        {
+            if( ( xKey.ucFlags & synFLAG_WIN_SCALING ) != 0U )
+            {
+                /* Calculate our factor as prvWinScaleFactor() does. */
+                size_t uxWinSize = pxSocket->u.xTCP.uxRxWinSize * ( size_t ) ipconfigTCP_MSS;
+
+                while( uxWinSize > 0xffffU )
+                {
+                    uxWinSize >>= 1;
+                    xKey.ucMyWinScaleFactor++;
+                }
+            }
+        }
+        #else
+        {
+            /* Window scaling is not supported. */
+            xKey.ucFlags &= ( uint8_t ) ~synFLAG_WIN_SCALING;
+        }
+        #endif /* ipconfigUSE_TCP_WIN != 0 */
+
+        pxEntry = prvSynCacheFind( &xKey );
+
+        if( ( pxEntry != NULL ) && ( pxEntry->ulPeerSequenceNumber == xKey.ulPeerSequenceNumber ) )
+        {
+            /* A retransmission of the SYN, send the same SYN+ACK again. */
+        }
+        else
+        {
+            if( pxEntry == NULL )
+            {
+                pxEntry = prvSynCacheAllocate( xNow );
+            }
+
+            if( pxEntry != NULL )
+            {
+                xKey.ucFlags |= synFLAG_IN_USE;
+                xKey.ulOurSequenceNumber = ulInitialSequenceNumber;
+                xKey.xCreationTime = xNow;
+                *pxEntry = xKey;
+            }
+        }
+
+        if( pxEntry != NULL )
+        {
+            prvSynCacheReply( pxSocket, pxNetworkBuffer, pxEntry );
+            xReturn = pdTRUE;
+        }
+
+        #if ( ipconfigUSE_TCP_SYN_COOKIES == 1 )
+            else
+            {
+                if( xCookieSecretSet == pdFALSE )
+                {
+                    xCookieSecretSet = xApplicationGetRandomNumber( &( ulCookieSecret ) );
+                }
+
+                if( xCookieSecretSet != pdFALSE )
+                {
+                    /* The table is full: nothing is stored, and window scaling is not
+                     * negotiated, because a cookie has no room for it. */
+                    xKey.ucFlags &= ( uint8_t ) ~synFLAG_WIN_SCALING;
+                    xKey.ulOurSequenceNumber = prvSynCookieMake( &xKey, xNow );
+                    prvSynCacheReply( pxSocket, pxNetworkBuffer, &xKey );
+                    xReturn = pdTRUE;
+                }
+            }
+        #endif /* ipconfigUSE_TCP_SYN_COOKIES == 1 */
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief A listening socket has received an ACK. If it completes a handshake
+ *        that was started by xTCPSynCacheAdd(), create the new socket.
+ *
+ * @param[in] pxSocket The listening socket.
+ * @param[in] pxNetworkBuffer The network buffer carrying the ACK.
+ *
+ * @return The new socket in the state eSYN_RECEIVED, or NULL.
+ */
+    FreeRTOS_Socket_t * pxTCPSynCacheAccept( FreeRTOS_Socket_t * pxSocket,
+                                             const NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        FreeRTOS_Socket_t * pxReturn = NULL;
+        SynCacheEntry_t xKey;
+        SynCacheEntry_t * pxEntry;
+        BaseType_t xFound = pdFALSE;
+        TickType_t xNow = xTaskGetTickCount();
+
+        prvSynCacheReadPacket( pxNetworkBuffer, &xKey );
+
+        /* The ACK acknowledges our SYN, and its sequence number follows the SYN
+         * of the peer. */
+        xKey.ulOurSequenceNumber--;
+        xKey.ulPeerSequenceNumber--;
+
+        pxEntry = prvSynCacheFind( &xKey );
+
+        if( pxEntry != NULL )
+        {
+            if( ( pxEntry->ulOurSequenceNumber == xKey.ulOurSequenceNumber ) &&
+                ( pxEntry->ulPeerSequenceNumber == xKey.ulPeerSequenceNumber ) &&
+                ( ( xNow - pxEntry->xCreationTime ) < synENTRY_LIFETIME ) )
+            {
+                xKey = *pxEntry;
+                pxEntry->ucFlags = 0U;
+                xFound = pdTRUE;
+            }
+        }
+
+        #if ( ipconfigUSE_TCP_SYN_COOKIES == 1 )
+            else
+            {
+                xFound = prvSynCookieCheck( &xKey, xNow );
+            }
+        #endif
+
+        if( xFound != pdFALSE )
+        {
+            pxReturn = prvSynCacheCreateSocket( pxSocket, pxNetworkBuffer, &xKey );
+        }
+
+        return pxReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SYN_CACHE == 1 ) */
@@ -56,6 +56,7 @@
 #include "FreeRTOS_TCP_Transmission.h"
 #include "FreeRTOS_TCP_State_Handling.h"
 #include "FreeRTOS_TCP_Utils.h"
+#include "FreeRTOS_TCP_Time_Wait.h"
 
 /* Just make sure the contents doesn't get compiled if TCP is not enabled. */
 #if ipconfigUSE_TCP == 1
@@ -243,6 +244,7 @@
         TCPWindow_t * pxTCPWindow = &pxSocket->u.xTCP.xTCPWindow;
         BaseType_t xSendLength = 0;
         uint32_t ulAckNr = FreeRTOS_ntohl( pxTCPHeader->ulAckNr );
+        UBaseType_t uxOptionsLength = pxTCPWindow->ucOptionLength;
 
         if( ( ucTCPFlags & tcpTCP_FLAG_FIN ) != 0U )
         {
@@ -269,8 +271,22 @@
             pxTCPWindow->tx.ulCurrentSequenceNumber = pxTCPWindow->tx.ulFINSequenceNumber;
             pxTCPHeader->ucTCPFlags = ( uint8_t ) tcpTCP_FLAG_ACK | ( uint8_t ) tcpTCP_FLAG_FIN;
 
-            /* And wait for the final ACK. */
-            vTCPStateChange( pxSocket, eLAST_ACK );
+            #if ( ipconfigUSE_TCP_TIME_WAIT == 1 )
+                if( ( ( pxSocket->u.xTCP.bits.bPassQueued != pdFALSE_UNSIGNED ) ||
+                      ( pxSocket->u.xTCP.bits.bPassAccept != pdFALSE_UNSIGNED ) ) &&
+                    ( pxSocket->u.xTCP.bits.bReuseSocket == pdFALSE_UNSIGNED ) )
+                {
+                    /* Nobody owns this socket, so vTCPStateChange() will close
+                     * it after the FIN+ACK has been sent. The final ACK will be
+                     * handled by the time-wait table. */
+                    vTCPStateChange( pxSocket, eCLOSE_WAIT );
+                }
+                else
+            #endif /* ipconfigUSE_TCP_TIME_WAIT == 1 */
+            {
+                /* And wait for the final ACK. */
+                vTCPStateChange( pxSocket, eLAST_ACK );
+            }
         }
         else
         {
@@ -305,13 +321,19 @@
 
         pxTCPWindow->ulOurSequenceNumber = pxTCPWindow->tx.ulCurrentSequenceNumber;
 
+        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+        {
+            uxOptionsLength = prvTCPAddTimestampOption( pxSocket, pxTCPHeader, uxOptionsLength );
+        }
+        #endif
+
         if( pxTCPHeader->ucTCPFlags != 0U )
         {
-            ucIntermediateResult = ( uint8_t ) ( uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER + pxTCPWindow->ucOptionLength );
+            ucIntermediateResult = ( uint8_t ) ( uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER + uxOptionsLength );
             xSendLength = ( BaseType_t ) ucIntermediateResult;
         }
 
-        pxTCPHeader->ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + pxTCPWindow->ucOptionLength ) << 2 );
+        pxTCPHeader->ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + uxOptionsLength ) << 2 );
 
         if( xTCPWindowLoggingLevel != 0 )
         {
@@ -471,6 +493,23 @@
             }
             #endif /* ipconfigUSE_TCP_WIN */
 
+            #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+            {
+                if( pxSocket->u.xTCP.bits.bTimeStamps != pdFALSE_UNSIGNED )
+                {
+                    /* Every segment will carry the time-stamp option, make room
+                     * for it by sending smaller segments. */
+                    pxTCPWindow->usMSS = ( uint16_t ) ( pxTCPWindow->usMSS - tcpTCP_OPT_TIMESTAMP_SPACE );
+
+                    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+                    {
+                        vTCPWindowCongestionMSSChanged( pxTCPWindow );
+                    }
+                    #endif
+                }
+            }
+            #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION */
+
             /* This was the third step of connecting: SYN, SYN+ACK, ACK so now the
              * connection is established. */
             vTCPStateChange( pxSocket, eESTABLISHED );
@@ -512,6 +551,7 @@
         uint32_t ulSequenceNumber = FreeRTOS_ntohl( pxTCPHeader->ulSequenceNumber ), ulCount, ulIntermediateResult = 0;
         BaseType_t xSendLength = 0, xMayClose = pdFALSE, bRxComplete, bTxDone;
         int32_t lDistance, lSendResult;
+        UBaseType_t uxUrgentOptions = uxOptionsLength;
         uint16_t usWindow;
         UBaseType_t uxIntermediateResult = 0;
 
@@ -665,7 +705,18 @@
                  * can not send-out both TCP options and also a full packet. Sending
                  * options (SACK) is always more urgent than sending data, which can be
                  * sent later. */
-                if( uxOptionsLength == 0U )
+                #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                {
+                    /* The time-stamp option is always present, the MSS leaves room
+                     * for it. */
+                    if( pxSocket->u.xTCP.bits.bTimeStamps != pdFALSE_UNSIGNED )
+                    {
+                        uxUrgentOptions -= tcpTCP_OPT_TIMESTAMP_SPACE;
+                    }
+                }
+                #endif
+
+                if( uxUrgentOptions == 0U )
                 {
                     /* prvTCPPrepareSend might allocate a bigger network buffer, if
                      * necessary. */
@@ -741,6 +792,21 @@
          * pucRecvData will point to the first byte of the TCP payload. */
         ulReceiveLength = ( uint32_t ) prvCheckRxData( *ppxNetworkBuffer, &pucRecvData );
 
+        #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+        {
+            /* The flags in the header will be overwritten, remember PSH for
+             * prvSendData(). */
+            if( ( ucTCPFlags & tcpTCP_FLAG_PSH ) != 0U )
+            {
+                pxSocket->u.xTCP.bits.bRxPush = pdTRUE_UNSIGNED;
+            }
+            else
+            {
+                pxSocket->u.xTCP.bits.bRxPush = pdFALSE_UNSIGNED;
+            }
+        }
+        #endif /* ipconfigUSE_TCP_ACK_POLICY */
+
         if( pxSocket->u.xTCP.eTCPState >= eESTABLISHED )
         {
             if( pxTCPWindow->rx.ulCurrentSequenceNumber == ( ulSequenceNumber + 1U ) )
@@ -969,6 +1035,13 @@
         pxNewSocket->u.xTCP.uxRxWinSize = pxSocket->u.xTCP.uxRxWinSize;
         pxNewSocket->u.xTCP.uxTxWinSize = pxSocket->u.xTCP.uxTxWinSize;
 
+        #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+        {
+            /* The child uses the congestion control algorithm of its parent. */
+            pxNewSocket->u.xTCP.xTCPWindow.pxCongestionOps = pxSocket->u.xTCP.xTCPWindow.pxCongestionOps;
+        }
+        #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL */
+
         #if ( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
         {
             pxNewSocket->pxUserSemaphore = pxSocket->pxUserSemaphore;
@@ -984,6 +1057,27 @@
         }
         #endif /* ipconfigUSE_CALLBACKS */
 
+        #if ( ipconfigUSE_TCP_REUSE_PORT == 1 )
+        {
+            /* The child shares the port of its parent, so it must also allow
+             * other sockets to bind to that port. */
+            pxNewSocket->u.xTCP.bits.bReusePort = pxSocket->u.xTCP.bits.bReusePort;
+        }
+        #endif /* ipconfigUSE_TCP_REUSE_PORT */
+
+        /* Like in Linux, the child inherits the options that control
+         * the coalescing of small segments. */
+        pxNewSocket->u.xTCP.bits.bNoDelay = pxSocket->u.xTCP.bits.bNoDelay;
+        pxNewSocket->u.xTCP.bits.bCork = pxSocket->u.xTCP.bits.bCork;
+
+        #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+        {
+            /* The child uses the delayed-ACK policy of its parent. */
+            pxNewSocket->u.xTCP.xAckPolicy = pxSocket->u.xTCP.xAckPolicy;
+            pxNewSocket->u.xTCP.ucQuickAcks = pxSocket->u.xTCP.xAckPolicy.ucQuickAckCount;
+        }
+        #endif /* ipconfigUSE_TCP_ACK_POLICY */
+
         #if ( ipconfigSUPPORT_SELECT_FUNCTION == 1 )
         {
             /* Child socket of listening sockets will inherit the Socket Set
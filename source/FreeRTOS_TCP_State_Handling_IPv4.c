@@ -56,6 +56,7 @@
 #include "FreeRTOS_TCP_Transmission.h"
 #include "FreeRTOS_TCP_State_Handling.h"
 #include "FreeRTOS_TCP_Utils.h"
+#include "FreeRTOS_TCP_SYN_Cache.h"
 
 /* Just make sure the contents doesn't get compiled if TCP is not enabled. */
 /* *INDENT-OFF* */
@@ -135,6 +136,16 @@ FreeRTOS_Socket_t * prvHandleListen_IPV4( FreeRTOS_Socket_t * pxSocket,
                                    ( pxSocket->u.xTCP.usChildCount == 1U ) ? "" : "ren" ) );
                 ( void ) prvTCPSendReset( pxNetworkBuffer );
             }
+
+            #if ( ipconfigUSE_TCP_SYN_CACHE == 1 )
+                else
+                {
+                    /* The connection is kept in the SYN cache until the peer
+                     * has completed the handshake. Only then a socket will be
+                     * created, see pxTCPSynCacheAccept(). */
+                    ( void ) xTCPSynCacheAdd( pxSocket, pxNetworkBuffer, ulInitialSequenceNumber );
+                }
+            #else
             else
             {
                 FreeRTOS_Socket_t * pxNewSocket = ( FreeRTOS_Socket_t * )
@@ -162,6 +173,7 @@ FreeRTOS_Socket_t * prvHandleListen_IPV4( FreeRTOS_Socket_t * pxSocket,
                     /* Copying failed somehow. */
                 }
             }
+            #endif /* ipconfigUSE_TCP_SYN_CACHE == 1 */
         }
     }
 
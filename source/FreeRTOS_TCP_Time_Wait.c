@@ -0,0 +1,719 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_TCP_Time_Wait.c
+ * @brief A table of TCP connections that are closing, used when
+ *        ipconfigUSE_TCP_TIME_WAIT is enabled.
+ *
+ * When a socket is freed after it has sent a FIN, the peer may still send
+ * segments that belong to the closure: the ACK of our FIN, its own FIN, or
+ * retransmissions of those. Without a socket, they would be answered with a
+ * RST. Instead, the connection is stored in a small entry of xTimeWaitTable[],
+ * which holds just enough to answer them:
+ *
+ *     - a FIN from the peer is acknowledged, and when our FIN has not been
+ *       acknowledged yet, it is sent again along with the ACK.
+ *     - an ACK of our FIN is noted, other empty segments are dropped.
+ *     - data that arrives before the FIN of the peer can not be delivered
+ *       anymore, the entry is removed and the segment gets a RST.
+ *     - a RST removes the entry, a new SYN removes it and is passed on to
+ *       the listening socket.
+ *
+ * As long as our FIN has not been acknowledged, xTCPTimeWaitCheck() sends it
+ * again from the TCP timer, so the closure completes when the peer has
+ * nothing more to send. An entry is forgotten after
+ * ipconfigTCP_TIME_WAIT_SECONDS.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_Sockets.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkBufferManagement.h"
+#include "FreeRTOS_ARP.h"
+#include "FreeRTOS_ND.h"
+
+#include "FreeRTOS_TCP_Reception.h"
+#include "FreeRTOS_TCP_Transmission.h"
+#include "FreeRTOS_TCP_State_Handling.h"
+#include "FreeRTOS_TCP_Time_Wait.h"
+
+#if ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TIME_WAIT == 1 )
+
+/** @brief The time after which an entry is forgotten. */
+    #define twENTRY_LIFETIME       pdMS_TO_TICKS( ( uint32_t ) ipconfigTCP_TIME_WAIT_SECONDS * 1000U )
+
+/** @brief The entry is in use. */
+    #define twFLAG_IN_USE          0x01U
+
+/** @brief The peer has an IPv6 address. */
+    #define twFLAG_IPv6            0x02U
+
+/** @brief The peer has acknowledged our FIN. */
+    #define twFLAG_FIN_ACKED       0x04U
+
+/** @brief The FIN of the peer has been received. */
+    #define twFLAG_FIN_RECEIVED    0x08U
+
+/** @brief The time after which our FIN is first sent again, the interval
+ *         doubles with every repetition. */
+    #define twRESEND_TIME          pdMS_TO_TICKS( 1000U )
+
+/** @brief The interval stops doubling after this many repetitions. */
+    #define twRESEND_MAX_SHIFT     4U
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Read the address and the port numbers of a received packet into an entry,
+ * seen from the side of this host.
+ */
+    static void prvTimeWaitReadPacket( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                       TimeWaitEntry_t * pxEntry );
+
+/*
+ * Return the entry that is in use for the same connection as 'pxKey', or
+ * NULL. Entries that have expired are released on the way.
+ */
+    static TimeWaitEntry_t * prvTimeWaitFind( const TimeWaitEntry_t * pxKey,
+                                              TickType_t xNow );
+
+/*
+ * Return an entry for a new connection: the entry of the same connection,
+ * a free entry, or the oldest one.
+ */
+    static TimeWaitEntry_t * prvTimeWaitAllocate( const TimeWaitEntry_t * pxKey,
+                                                  TickType_t xNow );
+
+/*
+ * Answer a segment of the peer with an ACK, or with a FIN+ACK when our FIN
+ * has not been acknowledged yet.
+ */
+    static void prvTimeWaitReply( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                  const TimeWaitEntry_t * pxEntry );
+
+/*
+ * Look up the MAC-address to which packets for the peer must be sent.
+ */
+    static BaseType_t prvTimeWaitLookupMAC( const TimeWaitEntry_t * pxEntry,
+                                            MACAddress_t * pxMACAddress );
+
+/*
+ * Send our FIN again, in a packet that is built from the entry.
+ */
+    static void prvTimeWaitSendFIN( const TimeWaitEntry_t * pxEntry );
+
+/*-----------------------------------------------------------*/
+
+/** @brief The closing connections of all TCP sockets. */
+    static TimeWaitEntry_t xTimeWaitTable[ ipconfigTCP_TIME_WAIT_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Read the address and the port numbers of a received packet into an
+ *        entry.
+ *
+ * @param[in] pxNetworkBuffer The network buffer carrying the packet.
+ * @param[out] pxEntry The entry to be filled.
+ */
+    static void prvTimeWaitReadPacket( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                       TimeWaitEntry_t * pxEntry )
+    {
+        /* MISRA Ref 11.3.1 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        const TCPHeader_t * pxTCPHeader = ( ( const TCPHeader_t * )
+                                            &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizePacket( pxNetworkBuffer ) ] ) );
+
+        ( void ) memset( pxEntry, 0, sizeof( *pxEntry ) );
+
+        #if ( ipconfigUSE_IPv6 != 0 )
+            if( uxIPHeaderSizePacket( pxNetworkBuffer ) == ipSIZE_OF_IPv6_HEADER )
+            {
+                /* MISRA Ref 11.3.1 [Misaligned access] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                /* coverity[misra_c_2012_rule_11_3_violation] */
+                const IPHeader_IPv6_t * pxIPHeader = ( ( const IPHeader_IPv6_t * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+
+                ( void ) memcpy( pxEntry->xRemoteIP.xIP_IPv6.ucBytes, pxIPHeader->xSourceAddress.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                pxEntry->ucFlags = twFLAG_IPv6;
+            }
+            else
+        #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            const IPHeader_t * pxIPHeader = ( ( const IPHeader_t * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+
+            pxEntry->xRemoteIP.ulIP_IPv4 = FreeRTOS_ntohl( pxIPHeader->ulSourceIPAddress );
+        }
+
+        pxEntry->usLocalPort = FreeRTOS_ntohs( pxTCPHeader->usDestinationPort );
+        pxEntry->usRemotePort = FreeRTOS_ntohs( pxTCPHeader->usSourcePort );
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Look up the entry of a connection.
+ *
+ * @param[in] pxKey An entry filled by prvTimeWaitReadPacket().
+ * @param[in] xNow The current time.
+ *
+ * @return The entry that is in use for the same connection, or NULL.
+ */
+    static TimeWaitEntry_t * prvTimeWaitFind( const TimeWaitEntry_t * pxKey,
+                                              TickType_t xNow )
+    {
+        TimeWaitEntry_t * pxReturn = NULL;
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigTCP_TIME_WAIT_SIZE; uxIndex++ )
+        {
+            TimeWaitEntry_t * pxEntry = &( xTimeWaitTable[ uxIndex ] );
+
+            if( ( pxEntry->ucFlags & twFLAG_IN_USE ) != 0U )
+            {
+                if( ( xNow - pxEntry->xCreationTime ) >= twENTRY_LIFETIME )
+                {
+                    /* The closure is over. */
+                    pxEntry->ucFlags = 0U;
+                }
+                else if( ( pxEntry->usLocalPort == pxKey->usLocalPort ) &&
+                         ( pxEntry->usRemotePort == pxKey->usRemotePort ) &&
+                         ( ( pxEntry->ucFlags & twFLAG_IPv6 ) == ( pxKey->ucFlags & twFLAG_IPv6 ) ) &&
+                         ( memcmp( pxEntry->xRemoteIP.xIP_IPv6.ucBytes, pxKey->xRemoteIP.xIP_IPv6.ucBytes, sizeof( pxEntry->xRemoteIP ) ) == 0 ) )
+                {
+                    pxReturn = pxEntry;
+                    break;
+                }
+                else
+                {
+                    /* Another connection. */
+                }
+            }
+        }
+
+        return pxReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Find an entry for a connection that is closing.
+ *
+ * @param[in] pxKey The connection.
+ * @param[in] xNow The current time.
+ *
+ * @return The entry of the same connection, a free or expired entry, or
+ *         else the oldest entry.
+ */
+    static TimeWaitEntry_t * prvTimeWaitAllocate( const TimeWaitEntry_t * pxKey,
+                                                  TickType_t xNow )
+    {
+        TimeWaitEntry_t * pxReturn = prvTimeWaitFind( pxKey, xNow );
+        size_t uxIndex;
+
+        for( uxIndex = 0U; ( pxReturn == NULL ) && ( uxIndex < ( size_t ) ipconfigTCP_TIME_WAIT_SIZE ); uxIndex++ )
+        {
+            if( ( xTimeWaitTable[ uxIndex ].ucFlags & twFLAG_IN_USE ) == 0U )
+            {
+                pxReturn = &( xTimeWaitTable[ uxIndex ] );
+            }
+        }
+
+        if( pxReturn == NULL )
+        {
+            /* The table is full, forget the oldest connection. */
+            pxReturn = &( xTimeWaitTable[ 0 ] );
+
+            for( uxIndex = 1U; uxIndex < ( size_t ) ipconfigTCP_TIME_WAIT_SIZE; uxIndex++ )
+            {
+                if( ( xNow - xTimeWaitTable[ uxIndex ].xCreationTime ) > ( xNow - pxReturn->xCreationTime ) )
+                {
+                    pxReturn = &( xTimeWaitTable[ uxIndex ] );
+                }
+            }
+        }
+
+        return pxReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Answer a segment of a closing connection. The received packet is
+ *        used to build the reply, as prvTCPSendChallengeAck() does.
+ *
+ * @param[in] pxNetworkBuffer The network buffer carrying the segment.
+ * @param[in] pxEntry The connection.
+ */
+    static void prvTimeWaitReply( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                  const TimeWaitEntry_t * pxEntry )
+    {
+        /* MISRA Ref 11.3.1 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        TCPHeader_t * pxTCPHeader = ( ( TCPHeader_t * )
+                                      &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizePacket( pxNetworkBuffer ) ] ) );
+        uint8_t ucTCPFlags = tcpTCP_FLAG_ACK;
+        uint32_t ulOurSequenceNumber = pxEntry->ulFINSequenceNumber + 1U;
+
+        if( ( pxEntry->ucFlags & twFLAG_FIN_ACKED ) == 0U )
+        {
+            /* Our FIN may have been lost, send it again. */
+            ucTCPFlags = ( uint8_t ) tcpTCP_FLAG_ACK | ( uint8_t ) tcpTCP_FLAG_FIN;
+            ulOurSequenceNumber = pxEntry->ulFINSequenceNumber;
+        }
+
+        /* prvTCPReturnPacket() will swap the two sequence numbers. */
+        #if ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 )
+        {
+            uint16_t usChecksum = pxTCPHeader->usChecksum;
+
+            usChecksum = usChecksumAdjust32( usChecksum, pxTCPHeader->ulSequenceNumber, FreeRTOS_htonl( pxEntry->ulPeerSequenceNumber ) );
+            usChecksum = usChecksumAdjust32( usChecksum, pxTCPHeader->ulAckNr, FreeRTOS_htonl( ulOurSequenceNumber ) );
+            pxTCPHeader->usChecksum = usChecksum;
+        }
+        #endif
+        pxTCPHeader->ulSequenceNumber = FreeRTOS_htonl( pxEntry->ulPeerSequenceNumber );
+        pxTCPHeader->ulAckNr = FreeRTOS_htonl( ulOurSequenceNumber );
+
+        /* prvTCPSendSpecialPacketHelper() is not used, because it does not
+         * send anything when ipconfigIGNORE_UNKNOWN_PACKETS is set.  A closing
+         * connection is not unknown. */
+        #if ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 )
+        {
+            /* The offset and the flags share a 16-bit word in the TCP header. */
+            uint16_t usOldWord = FreeRTOS_htons( ( uint16_t ) ( ( ( uint16_t ) pxTCPHeader->ucTCPOffset << 8 ) | pxTCPHeader->ucTCPFlags ) );
+            uint16_t usNewWord = FreeRTOS_htons( ( uint16_t ) ( ( ( uint16_t ) ( ipSIZE_OF_TCP_HEADER << 2 ) << 8 ) | ucTCPFlags ) );
+
+            pxTCPHeader->usChecksum = usChecksumAdjust16( pxTCPHeader->usChecksum, usOldWord, usNewWord );
+        }
+        #endif
+        pxTCPHeader->ucTCPFlags = ucTCPFlags;
+        pxTCPHeader->ucTCPOffset = ( uint8_t ) ( ipSIZE_OF_TCP_HEADER << 2 );
+
+        prvTCPReturnPacket( NULL, pxNetworkBuffer, ( uint32_t ) ( uxIPHeaderSizePacket( pxNetworkBuffer ) + ipSIZE_OF_TCP_HEADER ), pdFALSE );
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Look up the MAC-address of the peer, or of the gateway that leads to
+ *        it, in the ARP or ND cache.
+ *
+ * @param[in] pxEntry The connection.
+ * @param[out] pxMACAddress The MAC-address that was found.
+ *
+ * @return pdTRUE when the cache has an entry for the peer.
+ */
+    static BaseType_t prvTimeWaitLookupMAC( const TimeWaitEntry_t * pxEntry,
+                                            MACAddress_t * pxMACAddress )
+    {
+        eResolutionLookupResult_t eResult = eResolutionFailed;
+        NetworkEndPoint_t * pxEndPoint = pxEntry->pxEndPoint;
+
+        #if ( ipconfigUSE_IPv6 != 0 )
+            if( ( pxEntry->ucFlags & twFLAG_IPv6 ) != 0U )
+            {
+                IPv6_Address_t xIPAddress;
+
+                ( void ) memcpy( xIPAddress.ucBytes, pxEntry->xRemoteIP.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                eResult = eNDGetCacheEntry( &xIPAddress, pxMACAddress, &pxEndPoint );
+            }
+            else
+        #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+        {
+            #if ( ipconfigUSE_IPv4 != 0 )
+            {
+                uint32_t ulIPAddress = FreeRTOS_htonl( pxEntry->xRemoteIP.ulIP_IPv4 );
+
+                eResult = eARPGetCacheEntry( &ulIPAddress, pxMACAddress, &pxEndPoint );
+            }
+            #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+        }
+
+        return ( eResult == eResolutionCacheHit ) ? pdTRUE : pdFALSE;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Send our FIN again without waiting for the peer. A packet is made
+ *        up as if the peer had sent it, so that prvTimeWaitReply() can answer
+ *        it like a received segment.
+ *
+ * When the peer is not in the ARP or ND cache, nothing is sent: the reply
+ * would go to the MAC-address of the made-up packet, which is unknown.  The
+ * FIN will be sent again with the next reply to the peer.
+ *
+ * @param[in] pxEntry The connection.
+ */
+    static void prvTimeWaitSendFIN( const TimeWaitEntry_t * pxEntry )
+    {
+        size_t uxIPHeaderSize = ipSIZE_OF_IPv4_HEADER;
+        NetworkBufferDescriptor_t * pxNetworkBuffer = NULL;
+        MACAddress_t xMACAddress;
+
+        #if ( ipconfigUSE_IPv6 != 0 )
+            if( ( pxEntry->ucFlags & twFLAG_IPv6 ) != 0U )
+            {
+                uxIPHeaderSize = ipSIZE_OF_IPv6_HEADER;
+            }
+        #endif
+
+        if( prvTimeWaitLookupMAC( pxEntry, &xMACAddress ) != pdFALSE )
+        {
+            pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( ipSIZE_OF_ETH_HEADER + uxIPHeaderSize + ipSIZE_OF_TCP_HEADER, 0U );
+        }
+
+        if( pxNetworkBuffer != NULL )
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            EthernetHeader_t * pxEthernetHeader = ( ( EthernetHeader_t * ) pxNetworkBuffer->pucEthernetBuffer );
+
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            TCPHeader_t * pxTCPHeader = ( ( TCPHeader_t * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSize ] ) );
+
+            ( void ) memset( pxNetworkBuffer->pucEthernetBuffer, 0, ipSIZE_OF_ETH_HEADER + uxIPHeaderSize + ipSIZE_OF_TCP_HEADER );
+            ( void ) memcpy( pxEthernetHeader->xSourceAddress.ucBytes, xMACAddress.ucBytes, ipMAC_ADDRESS_LENGTH_BYTES );
+            pxNetworkBuffer->pxEndPoint = pxEntry->pxEndPoint;
+
+            /* The length fields in the IP-header are left zero, so that
+             * prvTCPReturnPacket() will calculate the TCP checksum. */
+            switch( uxIPHeaderSize )
+            {
+                #if ( ipconfigUSE_IPv4 != 0 )
+                    case ipSIZE_OF_IPv4_HEADER:
+                       {
+                           /* MISRA Ref 11.3.1 [Misaligned access] */
+                           /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                           /* coverity[misra_c_2012_rule_11_3_violation] */
+                           IPHeader_t * pxIPHeader = ( ( IPHeader_t * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+
+                           pxEthernetHeader->usFrameType = ipIPv4_FRAME_TYPE;
+                           pxIPHeader->ucVersionHeaderLength = 0x45U;
+                           pxIPHeader->ucProtocol = ipPROTOCOL_TCP;
+                           pxIPHeader->ulSourceIPAddress = FreeRTOS_htonl( pxEntry->xRemoteIP.ulIP_IPv4 );
+                           pxIPHeader->ulDestinationIPAddress = pxEntry->pxEndPoint->ipv4_settings.ulIPAddress;
+                       }
+                       break;
+                #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+
+                #if ( ipconfigUSE_IPv6 != 0 )
+                    case ipSIZE_OF_IPv6_HEADER:
+                       {
+                           /* MISRA Ref 11.3.1 [Misaligned access] */
+                           /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                           /* coverity[misra_c_2012_rule_11_3_violation] */
+                           IPHeader_IPv6_t * pxIPHeader = ( ( IPHeader_IPv6_t * ) &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER ] ) );
+
+                           pxEthernetHeader->usFrameType = ipIPv6_FRAME_TYPE;
+                           pxIPHeader->ucVersionTrafficClass = 0x60U;
+                           pxIPHeader->ucNextHeader = ipPROTOCOL_TCP;
+                           pxIPHeader->ucHopLimit = 128U;
+                           ( void ) memcpy( pxIPHeader->xSourceAddress.ucBytes, pxEntry->xRemoteIP.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                           ( void ) memcpy( pxIPHeader->xDestinationAddress.ucBytes, pxEntry->pxEndPoint->ipv6_settings.xIPAddress.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                       }
+                       break;
+                #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+
+                default:
+                    /* Shouldn't reach here. */
+                    break;
+            }
+
+            pxTCPHeader->usSourcePort = FreeRTOS_htons( pxEntry->usRemotePort );
+            pxTCPHeader->usDestinationPort = FreeRTOS_htons( pxEntry->usLocalPort );
+            pxTCPHeader->ucTCPOffset = ( uint8_t ) ( ipSIZE_OF_TCP_HEADER << 2 );
+
+            prvTimeWaitReply( pxNetworkBuffer, pxEntry );
+            vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Store the connection of a TCP socket that is about to be freed,
+ *        if it is closing.
+ *
+ * @param[in] pxSocket The socket.
+ *
+ * @return pdTRUE when the connection was stored in the table.
+ */
+    BaseType_t xTCPTimeWaitAdd( const FreeRTOS_Socket_t * pxSocket )
+    {
+        BaseType_t xReturn = pdFALSE;
+        BaseType_t xClosing;
+
+        switch( pxSocket->u.xTCP.eTCPState )
+        {
+            case eFIN_WAIT_1:
+            case eFIN_WAIT_2:
+            case eCLOSING:
+            case eLAST_ACK:
+            case eTIME_WAIT:
+            case eCLOSE_WAIT:
+                xClosing = pdTRUE;
+                break;
+
+            default:
+                /* Not connected, or the connection is not closing. */
+                xClosing = pdFALSE;
+                break;
+        }
+
+        /* Without a FIN of our side, the connection is aborted. A RST
+         * is then the right answer to late segments. */
+        if( ( xClosing != pdFALSE ) &&
+            ( pxSocket->ucProtocol == ( uint8_t ) FREERTOS_IPPROTO_TCP ) &&
+            ( pxSocket->u.xTCP.bits.bFinSent != pdFALSE_UNSIGNED ) &&
+            ( pxSocket->u.xTCP.usRemotePort != 0U ) )
+        {
+            const TCPWindow_t * pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
+            TickType_t xNow = xTaskGetTickCount();
+            TimeWaitEntry_t xKey;
+            TimeWaitEntry_t * pxEntry;
+
+            ( void ) memset( &xKey, 0, sizeof( xKey ) );
+
+            #if ( ipconfigUSE_IPv6 != 0 )
+                if( pxSocket->bits.bIsIPv6 != pdFALSE_UNSIGNED )
+                {
+                    ( void ) memcpy( xKey.xRemoteIP.xIP_IPv6.ucBytes, pxSocket->u.xTCP.xRemoteIP.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+                    xKey.ucFlags = twFLAG_IPv6;
+                }
+                else
+            #endif /* ( ipconfigUSE_IPv6 != 0 ) */
+            {
+                xKey.xRemoteIP.ulIP_IPv4 = pxSocket->u.xTCP.xRemoteIP.ulIP_IPv4;
+            }
+
+            xKey.usLocalPort = pxSocket->usLocalPort;
+            xKey.usRemotePort = pxSocket->u.xTCP.usRemotePort;
+            xKey.ulFINSequenceNumber = pxTCPWindow->tx.ulFINSequenceNumber;
+            xKey.ucFlags |= twFLAG_IN_USE;
+            xKey.xCreationTime = xNow;
+            xKey.xLastSendTime = xNow;
+            xKey.pxEndPoint = pxSocket->pxEndPoint;
+
+            if( pxSocket->u.xTCP.bits.bFinAcked != pdFALSE_UNSIGNED )
+            {
+                xKey.ucFlags |= twFLAG_FIN_ACKED;
+            }
+
+            if( pxSocket->u.xTCP.bits.bFinAccepted != pdFALSE_UNSIGNED )
+            {
+                xKey.ulPeerSequenceNumber = pxTCPWindow->rx.ulFINSequenceNumber + 1U;
+                xKey.ucFlags |= twFLAG_FIN_RECEIVED;
+            }
+            else
+            {
+                xKey.ulPeerSequenceNumber = pxTCPWindow->rx.ulCurrentSequenceNumber;
+            }
+
+            pxEntry = prvTimeWaitAllocate( &xKey, xNow );
+            ( void ) memcpy( pxEntry, &xKey, sizeof( *pxEntry ) );
+
+            FreeRTOS_debug_printf( ( "TCP: time-wait: port %u to %u (FIN %s)\n",
+                                     xKey.usLocalPort,
+                                     xKey.usRemotePort,
+                                     ( ( xKey.ucFlags & twFLAG_FIN_ACKED ) != 0U ) ? "acked" : "pending" ) );
+            xReturn = pdTRUE;
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Handle a segment that may belong to a connection that is closing.
+ *
+ * @param[in] pxNetworkBuffer The network buffer carrying the segment.
+ *
+ * @return pdTRUE when the segment was handled, pdFALSE when the caller must
+ *         handle it as usual.
+ */
+    BaseType_t xTCPTimeWaitProcess( NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        BaseType_t xReturn = pdFALSE;
+        TimeWaitEntry_t xKey;
+        TimeWaitEntry_t * pxEntry;
+        TickType_t xNow = xTaskGetTickCount();
+
+        prvTimeWaitReadPacket( pxNetworkBuffer, &xKey );
+        pxEntry = prvTimeWaitFind( &xKey, xNow );
+
+        if( pxEntry != NULL )
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            const TCPHeader_t * pxTCPHeader = ( ( const TCPHeader_t * )
+                                                &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizePacket( pxNetworkBuffer ) ] ) );
+            uint8_t ucTCPFlags = pxTCPHeader->ucTCPFlags;
+            uint32_t ulSequenceNumber = FreeRTOS_ntohl( pxTCPHeader->ulSequenceNumber );
+            uint8_t * pucRecvData;
+            BaseType_t xReceiveLength = prvCheckRxData( pxNetworkBuffer, &pucRecvData );
+
+            xReturn = pdTRUE;
+
+            if( ( ucTCPFlags & tcpTCP_FLAG_RST ) != 0U )
+            {
+                /* The peer has aborted the connection. */
+                pxEntry->ucFlags = 0U;
+            }
+            else if( ( ucTCPFlags & tcpTCP_FLAG_SYN ) != 0U )
+            {
+                if( ( ucTCPFlags & tcpTCP_FLAG_ACK ) == 0U )
+                {
+                    /* The peer wants to use the same port numbers for a new
+                     * connection. Let the listening socket handle the SYN. */
+                    pxEntry->ucFlags = 0U;
+                    xReturn = pdFALSE;
+                }
+            }
+            else
+            {
+                if( ( ( ucTCPFlags & tcpTCP_FLAG_ACK ) != 0U ) &&
+                    ( FreeRTOS_ntohl( pxTCPHeader->ulAckNr ) == ( pxEntry->ulFINSequenceNumber + 1U ) ) )
+                {
+                    pxEntry->ucFlags |= twFLAG_FIN_ACKED;
+                }
+
+                if( ( pxEntry->ucFlags & twFLAG_FIN_RECEIVED ) == 0U )
+                {
+                    if( xReceiveLength > 0 )
+                    {
+                        /* The socket has been closed, the data can not be
+                         * delivered. Let the caller send a RST. */
+                        pxEntry->ucFlags = 0U;
+                        xReturn = pdFALSE;
+                    }
+                    else if( ( ( ucTCPFlags & tcpTCP_FLAG_FIN ) != 0U ) &&
+                             ( ulSequenceNumber == pxEntry->ulPeerSequenceNumber ) )
+                    {
+                        /* The FIN of the peer, which also counts as a byte. */
+                        pxEntry->ulPeerSequenceNumber++;
+                        pxEntry->ucFlags |= twFLAG_FIN_RECEIVED;
+                        pxEntry->xCreationTime = xNow;
+                        prvTimeWaitReply( pxNetworkBuffer, pxEntry );
+                    }
+                    else
+                    {
+                        /* An empty segment, nothing to answer. */
+                    }
+                }
+                else if( ( ( ucTCPFlags & tcpTCP_FLAG_FIN ) != 0U ) || ( xReceiveLength > 0 ) )
+                {
+                    /* A retransmission, our ACK must have been lost. */
+                    pxEntry->xCreationTime = xNow;
+                    prvTimeWaitReply( pxNetworkBuffer, pxEntry );
+                }
+                else
+                {
+                    /* An ACK, nothing to answer. */
+                }
+            }
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Send our FIN again for the connections in which the peer has not
+ *        acknowledged it yet. Without this, a lost FIN would only be repeated
+ *        when the peer happens to send something.
+ *
+ * @return The time after which this function wants to be called again.
+ */
+    TickType_t xTCPTimeWaitCheck( void )
+    {
+        TickType_t xShortest = portMAX_DELAY;
+        TickType_t xNow = xTaskGetTickCount();
+        size_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < ( size_t ) ipconfigTCP_TIME_WAIT_SIZE; uxIndex++ )
+        {
+            TimeWaitEntry_t * pxEntry = &( xTimeWaitTable[ uxIndex ] );
+
+            if( ( pxEntry->ucFlags & twFLAG_IN_USE ) == 0U )
+            {
+                /* A free entry. */
+            }
+            else if( ( xNow - pxEntry->xCreationTime ) >= twENTRY_LIFETIME )
+            {
+                /* The closure is over. */
+                pxEntry->ucFlags = 0U;
+            }
+            else if( ( ( pxEntry->ucFlags & twFLAG_FIN_ACKED ) == 0U ) && ( pxEntry->pxEndPoint != NULL ) )
+            {
+                TickType_t xInterval = twRESEND_TIME << pxEntry->ucRepCount;
+                TickType_t xElapsed = xNow - pxEntry->xLastSendTime;
+
+                if( xElapsed >= xInterval )
+                {
+                    prvTimeWaitSendFIN( pxEntry );
+                    pxEntry->xLastSendTime = xNow;
+
+                    if( pxEntry->ucRepCount < twRESEND_MAX_SHIFT )
+                    {
+                        pxEntry->ucRepCount++;
+                    }
+
+                    xInterval = twRESEND_TIME << pxEntry->ucRepCount;
+                    xElapsed = 0U;
+                }
+
+                if( xShortest > ( xInterval - xElapsed ) )
+                {
+                    xShortest = xInterval - xElapsed;
+                }
+            }
+            else
+            {
+                /* Our FIN has been acknowledged, wait for the peer. */
+            }
+        }
+
+        return xShortest;
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TIME_WAIT == 1 ) */
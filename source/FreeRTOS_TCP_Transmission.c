@@ -72,6 +72,19 @@
         static uint8_t prvWinScaleFactor( const FreeRTOS_Socket_t * pxSocket );
     #endif
 
+    #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+/* Let a network buffer refer to the payload in txStream, instead of copying it. */
+        static uint32_t prvTCPAddFragments( FreeRTOS_Socket_t * pxSocket,
+                                            NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                            size_t uxOffset,
+                                            size_t uxMaxCount );
+    #endif
+
+    #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+/* Apply the delayed-ACK policy of the socket to a received segment. */
+        static BaseType_t prvTCPAckMayBeDelayed( FreeRTOS_Socket_t * pxSocket );
+    #endif
+
 /*------------------------------------------------------------------------*/
 
 /**
@@ -205,6 +218,17 @@
         UBaseType_t uxOptionsLength = 0U;
         int32_t xSendLength;
 
+        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+        {
+            if( pxSocket->u.xTCP.bits.bTimeStamps != pdFALSE_UNSIGNED )
+            {
+                /* Reserve space for the time-stamp option, prvTCPPrepareSend()
+                 * will write it. */
+                uxOptionsLength = tcpTCP_OPT_TIMESTAMP_SPACE;
+            }
+        }
+        #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+
         for( uxIndex = 0U; uxIndex < ( UBaseType_t ) SEND_REPEATED_COUNT; uxIndex++ )
         {
             /* prvTCPPrepareSend() might allocate a network buffer if there is data
@@ -471,6 +495,22 @@
             pxSocket->u.xTCP.xTCPWindow.ulOurSequenceNumber,
             ( uint32_t ) pxSocket->u.xTCP.usMSS );
 
+        /* xTCPWindowCreate() has cleared all flags of the window, apply the
+         * socket options FREERTOS_SO_TCP_NODELAY and FREERTOS_SO_TCP_CORK. */
+        #if ( ipconfigUSE_TCP_NAGLE == 1 )
+        {
+            if( pxSocket->u.xTCP.bits.bNoDelay == pdFALSE_UNSIGNED )
+            {
+                pxSocket->u.xTCP.xTCPWindow.u.bits.bNagle = pdTRUE_UNSIGNED;
+            }
+        }
+        #endif /* ipconfigUSE_TCP_NAGLE */
+
+        if( pxSocket->u.xTCP.bits.bCork != pdFALSE_UNSIGNED )
+        {
+            pxSocket->u.xTCP.xTCPWindow.u.bits.bSendFullSize = pdTRUE_UNSIGNED;
+        }
+
         return xReturn;
     }
     /*-----------------------------------------------------------*/
@@ -606,9 +646,73 @@
             uxOptionsLength += 4U;
         }
         #endif /* ipconfigUSE_TCP_WIN == 0 */
+
+        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+        {
+            if( pxSocket->u.xTCP.eTCPState == eCONNECT_SYN )
+            {
+                /* A connecting socket always offers time-stamps. The SYN+ACK
+                 * will tell if the peer accepts them. TSecr is zero until the
+                 * peer has sent a TSval. */
+                pxSocket->u.xTCP.bits.bTimeStamps = pdTRUE_UNSIGNED;
+                pxSocket->u.xTCP.xTCPWindow.xTimeStamps.ulTSRecent = 0U;
+            }
+
+            uxOptionsLength = prvTCPAddTimestampOption( pxSocket, pxTCPHeader, uxOptionsLength );
+        }
+        #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
         return uxOptionsLength; /* bytes, not words. */
     }
 
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/**
+ * @brief Add the time-stamp option to an outgoing packet, in case the option is
+ *        in use: two NOP's followed by TSval and TSecr ( RFC 7323 appendix A ).
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ * @param[in,out] pxTCPHeader The TCP header of the outgoing packet.
+ * @param[in] uxOptionsLength The length of the options that were already written.
+ *
+ * @return The option length after the time-stamp option was added.
+ */
+        UBaseType_t prvTCPAddTimestampOption( const FreeRTOS_Socket_t * pxSocket,
+                                              TCPHeader_t * pxTCPHeader,
+                                              UBaseType_t uxOptionsLength )
+        {
+            UBaseType_t uxLength = uxOptionsLength;
+            uint8_t * pucPtr;
+            uint32_t ulTSValue;
+            uint32_t ulTSEcho;
+
+            if( pxSocket->u.xTCP.bits.bTimeStamps != pdFALSE_UNSIGNED )
+            {
+                configASSERT( ( uxLength + tcpTCP_OPT_TIMESTAMP_SPACE ) <= ipSIZE_TCP_OPTIONS );
+
+                ulTSValue = ulTCPWindowTimestamp();
+                ulTSEcho = pxSocket->u.xTCP.xTCPWindow.xTimeStamps.ulTSRecent;
+                pucPtr = &( pxTCPHeader->ucOptdata[ uxLength ] );
+
+                pucPtr[ 0 ] = tcpTCP_OPT_NOOP;
+                pucPtr[ 1 ] = tcpTCP_OPT_NOOP;
+                pucPtr[ 2 ] = tcpTCP_OPT_TIMESTAMP;
+                pucPtr[ 3 ] = tcpTCP_OPT_TIMESTAMP_LEN;
+                pucPtr[ 4 ] = ( uint8_t ) ( ulTSValue >> 24 );
+                pucPtr[ 5 ] = ( uint8_t ) ( ( ulTSValue >> 16 ) & 0xffU );
+                pucPtr[ 6 ] = ( uint8_t ) ( ( ulTSValue >> 8 ) & 0xffU );
+                pucPtr[ 7 ] = ( uint8_t ) ( ulTSValue & 0xffU );
+                pucPtr[ 8 ] = ( uint8_t ) ( ulTSEcho >> 24 );
+                pucPtr[ 9 ] = ( uint8_t ) ( ( ulTSEcho >> 16 ) & 0xffU );
+                pucPtr[ 10 ] = ( uint8_t ) ( ( ulTSEcho >> 8 ) & 0xffU );
+                pucPtr[ 11 ] = ( uint8_t ) ( ulTSEcho & 0xffU );
+
+                uxLength += tcpTCP_OPT_TIMESTAMP_SPACE;
+            }
+
+            return uxLength;
+        }
+    #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+
 /**
  * @brief Check if the size of a network buffer is big enough to hold the outgoing message.
  *        Allocate a new bigger network buffer when necessary.
@@ -664,8 +768,9 @@
             }
 
             /* In case we were called from a TCP timer event, a buffer must be
-             *  created.  Otherwise, test 'xDataLength' of the provided buffer. */
-            if( ( pxNetworkBuffer == NULL ) || ( pxNetworkBuffer->xDataLength < uxNeeded ) )
+             *  created.  Otherwise, test the capacity of the provided buffer,
+             *  which includes its tailroom. */
+            if( ( pxNetworkBuffer == NULL ) || ( ipNETWORK_BUFFER_CAPACITY( pxNetworkBuffer ) < uxNeeded ) )
             {
                 xResize = pdTRUE;
             }
@@ -822,6 +927,10 @@
         int32_t lStreamPos;
         UBaseType_t uxIntermediateResult = 0;
 
+        #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+            BaseType_t xUseFragments = pdFALSE;
+        #endif
+
         if( ( *ppxNetworkBuffer ) != NULL )
         {
             /* A network buffer descriptor was already supplied */
@@ -844,6 +953,21 @@
         lStreamPos = 0;
         pxProtocolHeaders->xTCPHeader.ucTCPFlags |= tcpTCP_FLAG_ACK;
 
+        #if ( ipTCP_TX_PAYLOAD_SUM == 1 )
+        {
+            pxSocket->u.xTCP.uxTxPayloadSummed = 0U;
+        }
+        #endif
+
+        if( ( pxSocket->u.xTCP.bits.bCork != pdFALSE_UNSIGNED ) &&
+            ( ( pxSocket->u.xTCP.bits.bUserShutdown != pdFALSE_UNSIGNED ) ||
+              ( pxSocket->u.xTCP.bits.bCloseRequested != pdFALSE_UNSIGNED ) ) )
+        {
+            /* FREERTOS_SO_TCP_CORK: the connection is being closed, the last
+             * segment may be smaller than MSS. */
+            pxTCPWindow->u.bits.bSendFullSize = pdFALSE_UNSIGNED;
+        }
+
         if( pxSocket->u.xTCP.txStream != NULL )
         {
             /* ulTCPWindowTxGet will return the amount of data which may be sent
@@ -857,9 +981,33 @@
 
             if( lDataLen > 0 )
             {
+                #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+                {
+                    /* An interface that can send fragments gets the payload
+                     * straight from txStream, the network buffer only needs
+                     * room for the headers. */
+                    if( ( lDataLen >= ( int32_t ) ipconfigTCP_TX_SCATTER_GATHER_MIN_BYTES ) &&
+                        ( pxSocket->pxEndPoint != NULL ) &&
+                        ( pxSocket->pxEndPoint->pxNetworkInterface != NULL ) &&
+                        ( pxSocket->pxEndPoint->pxNetworkInterface->bits.bTxScatterGather != pdFALSE_UNSIGNED ) )
+                    {
+                        xUseFragments = pdTRUE;
+                    }
+                }
+                #endif /* ipconfigUSE_TCP_TX_SCATTER_GATHER */
+
                 /* Check if the current network buffer is big enough, if not,
                  * resize it. */
-                pxNewBuffer = prvTCPBufferResize( pxSocket, *ppxNetworkBuffer, lDataLen, uxOptionsLength );
+                #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+                    if( xUseFragments != pdFALSE )
+                    {
+                        pxNewBuffer = prvTCPBufferResize( pxSocket, *ppxNetworkBuffer, 0, uxOptionsLength );
+                    }
+                    else
+                #endif
+                {
+                    pxNewBuffer = prvTCPBufferResize( pxSocket, *ppxNetworkBuffer, lDataLen, uxOptionsLength );
+                }
 
                 if( pxNewBuffer != NULL )
                 {
@@ -880,9 +1028,38 @@
                      * marker. */
                     uxOffset = uxStreamBufferDistance( pxSocket->u.xTCP.txStream, pxSocket->u.xTCP.txStream->uxTail, ( size_t ) lStreamPos );
 
+                    #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+                        if( xUseFragments != pdFALSE )
+                        {
+                            /* The network buffer holds the headers only.  The
+                             * payload stays valid in txStream until it is
+                             * acknowledged, because only then the tail marker
+                             * will be updated. */
+                            pxNewBuffer->xDataLength = ( size_t ) ( ipSIZE_OF_ETH_HEADER + uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER + uxOptionsLength );
+                            ulDataGot = prvTCPAddFragments( pxSocket, pxNewBuffer, uxOffset, ( size_t ) lDataLen );
+                        }
+                        else
+                    #endif
+
                     /* Here data is copied from the txStream in 'peek' mode.  Only
                      * when the packets are acked, the tail marker will be updated. */
-                    ulDataGot = ( uint32_t ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, uxOffset, pucSendData, ( size_t ) lDataLen, pdTRUE );
+                    #if ( ( ipconfigUSE_TCP_FUSED_COPY_CHECKSUM == 1 ) && ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 ) )
+                    {
+                        /* Sum the payload while copying it, prvTCPReturnPacket() will
+                         * only have to add the headers. */
+                        ulDataGot = ( uint32_t ) uxStreamBufferPeekChecksum( pxSocket->u.xTCP.txStream, uxOffset, pucSendData, ( size_t ) lDataLen,
+                                                                             &( pxSocket->u.xTCP.usTxPayloadSum ) );
+
+                        if( ulDataGot == ( uint32_t ) lDataLen )
+                        {
+                            pxSocket->u.xTCP.uxTxPayloadSummed = ( size_t ) lDataLen;
+                        }
+                    }
+                    #else
+                    {
+                        ulDataGot = ( uint32_t ) uxStreamBufferGet( pxSocket->u.xTCP.txStream, uxOffset, pucSendData, ( size_t ) lDataLen, pdTRUE );
+                    }
+                    #endif
 
                     #if ( ipconfigHAS_DEBUG_PRINTF != 0 )
                     {
@@ -1000,6 +1177,20 @@
                 ( pxSocket->u.xTCP.bits.bSendKeepAlive != pdFALSE_UNSIGNED ) )
             {
                 pxProtocolHeaders->xTCPHeader.ucTCPFlags &= ( ( uint8_t ) ~tcpTCP_FLAG_PSH );
+
+                #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                {
+                    if( pxSocket->u.xTCP.bits.bTimeStamps != pdFALSE_UNSIGNED )
+                    {
+                        /* The caller has included the time-stamp option, which is
+                         * always the last one, in uxOptionsLength. Write it now,
+                         * the network buffer may have been replaced. */
+                        configASSERT( uxOptionsLength >= tcpTCP_OPT_TIMESTAMP_SPACE );
+                        ( void ) prvTCPAddTimestampOption( pxSocket, &( pxProtocolHeaders->xTCPHeader ), uxOptionsLength - tcpTCP_OPT_TIMESTAMP_SPACE );
+                    }
+                }
+                #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+
                 pxProtocolHeaders->xTCPHeader.ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + uxOptionsLength ) << 2 ); /*_RB_ "2" needs comment. */
 
                 pxProtocolHeaders->xTCPHeader.ucTCPFlags |= ( uint8_t ) tcpTCP_FLAG_ACK;
@@ -1018,6 +1209,104 @@
     }
     /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+
+/**
+ * @brief Let a network buffer refer to the payload in txStream, in one part,
+ *        or in two parts when the data wraps around the end of the stream.
+ *        The stream is kept alive until the network buffer is released.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ * @param[in] pxNetworkBuffer The network buffer that holds the headers.
+ * @param[in] uxOffset The offset of the payload from the tail of txStream.
+ * @param[in] uxMaxCount The number of bytes to be sent.
+ *
+ * @return The number of bytes that were attached.
+ */
+        static uint32_t prvTCPAddFragments( FreeRTOS_Socket_t * pxSocket,
+                                            NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                            size_t uxOffset,
+                                            size_t uxMaxCount )
+        {
+            StreamBuffer_t * pxStream = pxSocket->u.xTCP.txStream;
+            const size_t uxLength = pxStream->LENGTH;
+            size_t uxSize = uxStreamBufferGetSize( pxStream );
+            size_t uxCount;
+            size_t uxStart;
+            size_t uxFirst;
+
+            #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+                uint16_t usSum;
+                uint16_t usSecond;
+            #endif
+
+            if( uxSize > uxOffset )
+            {
+                uxSize -= uxOffset;
+            }
+            else
+            {
+                uxSize = 0U;
+            }
+
+            uxCount = FreeRTOS_min_size_t( uxSize, uxMaxCount );
+
+            if( uxCount != 0U )
+            {
+                uxStart = pxStream->uxTail + uxOffset;
+
+                if( uxStart >= uxLength )
+                {
+                    uxStart -= uxLength;
+                }
+
+                uxFirst = FreeRTOS_min_size_t( uxLength - uxStart, uxCount );
+
+                pxNetworkBuffer->xFragments[ 0 ].pucData = &( pxStream->ucArray[ uxStart ] );
+                pxNetworkBuffer->xFragments[ 0 ].uxLength = uxFirst;
+                pxNetworkBuffer->uxFragmentCount = 1U;
+
+                if( uxCount > uxFirst )
+                {
+                    pxNetworkBuffer->xFragments[ 1 ].pucData = pxStream->ucArray;
+                    pxNetworkBuffer->xFragments[ 1 ].uxLength = uxCount - uxFirst;
+                    pxNetworkBuffer->uxFragmentCount = 2U;
+                }
+
+                vStreamBufferReference( pxStream );
+                pxNetworkBuffer->pxFragmentStream = pxStream;
+
+                #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+                {
+                    /* The payload is not in the network buffer, so sum it here
+                     * for prvTCPReturnPacket(). */
+                    usSum = usGenerateChecksum( 0U, pxNetworkBuffer->xFragments[ 0 ].pucData, uxFirst );
+
+                    if( uxCount > uxFirst )
+                    {
+                        usSecond = usGenerateChecksum( 0U, pxStream->ucArray, uxCount - uxFirst );
+
+                        if( ( uxFirst & 1U ) != 0U )
+                        {
+                            /* The second part starts at an odd offset, the bytes
+                             * of its 16-bit words are in the other half. */
+                            usSecond = ( uint16_t ) ( ( usSecond << 8 ) | ( usSecond >> 8 ) );
+                        }
+
+                        usSum = usChecksumAdd( usSum, usSecond );
+                    }
+
+                    pxSocket->u.xTCP.usTxPayloadSum = usSum;
+                    pxSocket->u.xTCP.uxTxPayloadSummed = uxCount;
+                }
+                #endif /* ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 */
+            }
+
+            return ( uint32_t ) uxCount;
+        }
+    #endif /* ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 */
+    /*-----------------------------------------------------------*/
+
 
 /**
  * @brief The API FreeRTOS_send() adds data to the TX stream. Add
@@ -1139,11 +1428,81 @@
             /* Nothing. */
         }
 
+        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+        {
+            if( pxSocket->u.xTCP.bits.bTimeStamps != pdFALSE_UNSIGNED )
+            {
+                /* The time-stamp option is always the last one. */
+                uxOptionsLength = prvTCPAddTimestampOption( pxSocket, pxTCPHeader, uxOptionsLength );
+                pxTCPHeader->ucTCPOffset = ( uint8_t ) ( ( ipSIZE_OF_TCP_HEADER + uxOptionsLength ) << 2 );
+            }
+        }
+        #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+
         return uxOptionsLength;
     }
     /*-----------------------------------------------------------*/
 
 
+    #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+
+/**
+ * @brief Apply the delayed-ACK policy of a socket, see FREERTOS_SO_TCP_ACK_POLICY,
+ *        to a segment with data that may be acknowledged later.
+ *
+ * @param[in] pxSocket The socket that received the segment.
+ *
+ * @return pdTRUE when the ACK may be delayed, pdFALSE when it must be sent now.
+ */
+        static BaseType_t prvTCPAckMayBeDelayed( FreeRTOS_Socket_t * pxSocket )
+        {
+            const TCPAckPolicy_t * pxPolicy = &( pxSocket->u.xTCP.xAckPolicy );
+            TickType_t xNow = xTaskGetTickCount();
+            BaseType_t xReturn = pdTRUE;
+            uint8_t ucUnacked = 1U;
+
+            if( ( pxPolicy->usQuickAckIdleMs != 0U ) &&
+                ( ( xNow - pxSocket->u.xTCP.xLastRxDataTime ) >= pdMS_TO_TICKS( ( TickType_t ) pxPolicy->usQuickAckIdleMs ) ) )
+            {
+                /* The connection has been idle, the peer has probably reset its
+                 * congestion window: acknowledge the next segments at once. */
+                pxSocket->u.xTCP.ucQuickAcks = pxPolicy->ucQuickAckCount;
+            }
+
+            pxSocket->u.xTCP.xLastRxDataTime = xNow;
+
+            if( pxSocket->u.xTCP.pxAckMessage != NULL )
+            {
+                /* This segment will share the ACK of the earlier ones. */
+                ucUnacked = pxSocket->u.xTCP.ucRxUnacked + 1U;
+            }
+
+            if( pxSocket->u.xTCP.ucQuickAcks != 0U )
+            {
+                pxSocket->u.xTCP.ucQuickAcks--;
+                xReturn = pdFALSE;
+            }
+            else if( ( pxPolicy->xAckOnPush != pdFALSE ) &&
+                     ( pxSocket->u.xTCP.bits.bRxPush != pdFALSE_UNSIGNED ) )
+            {
+                xReturn = pdFALSE;
+            }
+            else if( ( pxPolicy->ucAckEvery != 0U ) &&
+                     ( ucUnacked >= pxPolicy->ucAckEvery ) )
+            {
+                xReturn = pdFALSE;
+            }
+            else
+            {
+                pxSocket->u.xTCP.ucRxUnacked = ucUnacked;
+            }
+
+            return xReturn;
+        }
+
+    #endif /* ipconfigUSE_TCP_ACK_POLICY */
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Called from prvTCPHandleState(). There is data to be sent. If
  *        ipconfigUSE_TCP_WIN is defined, and if only an ACK must be sent, it will be
@@ -1181,6 +1540,7 @@
             BaseType_t xSizeWithoutData = ( BaseType_t ) uxSize;
 
             int32_t lMinLength;
+            BaseType_t xMayDelay = pdFALSE;
         #endif
 
         /* Set the time-out field, so that we'll be called by the IP-task in case no
@@ -1202,20 +1562,56 @@
                 ( xSendLength == xSizeWithoutData ) &&                    /* No Tx data or options to be sent. */
                 ( pxSocket->u.xTCP.eTCPState == eESTABLISHED ) &&         /* Connection established. */
                 ( pxTCPHeader->ucTCPFlags == tcpTCP_FLAG_ACK ) )          /* There are no other flags than an ACK. */
+            {
+                xMayDelay = pdTRUE;
+
+                #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+                {
+                    xMayDelay = prvTCPAckMayBeDelayed( pxSocket );
+                }
+                #endif
+            }
+
+            if( xMayDelay != pdFALSE )
             {
                 uint32_t ulCurMSS = ( uint32_t ) pxSocket->u.xTCP.usMSS;
 
+                #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+                    BaseType_t xAckWasPending = ( pxSocket->u.xTCP.pxAckMessage != NULL ) ? pdTRUE : pdFALSE;
+                #endif
+
                 if( pxSocket->u.xTCP.pxAckMessage != *ppxNetworkBuffer )
                 {
                     /* There was still a delayed in queue, delete it. */
                     if( pxSocket->u.xTCP.pxAckMessage != NULL )
                     {
                         vReleaseNetworkBufferAndDescriptor( pxSocket->u.xTCP.pxAckMessage );
+
+                        #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+                        {
+                            /* The new ACK replaces the delayed one. */
+                            pxSocket->u.xTCP.ulAcksSaved++;
+                        }
+                        #endif
                     }
 
                     pxSocket->u.xTCP.pxAckMessage = *ppxNetworkBuffer;
                 }
 
+                #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+                    if( pxSocket->u.xTCP.xAckPolicy.usAckDelayMs != 0U )
+                    {
+                        /* The delay was chosen by the owner of the socket.  Only arm
+                         * the timer for the first postponed ACK, otherwise a steady
+                         * stream of segments would keep pushing the ACK away. */
+                        if( xAckWasPending == pdFALSE )
+                        {
+                            pxSocket->u.xTCP.usTimeout = ( uint16_t ) ipMS_TO_MIN_TICKS( pxSocket->u.xTCP.xAckPolicy.usAckDelayMs );
+                        }
+                    }
+                    else
+                #endif /* ipconfigUSE_TCP_ACK_POLICY */
+
                 if( ulReceiveLength < ulCurMSS ) /* Received a small message. */
                 {
                     pxSocket->u.xTCP.usTimeout = ( uint16_t ) tcpDELAYED_ACK_SHORT_DELAY_MS;
@@ -1255,6 +1651,13 @@
                 if( pxSocket->u.xTCP.pxAckMessage != *ppxNetworkBuffer )
                 {
                     vReleaseNetworkBufferAndDescriptor( pxSocket->u.xTCP.pxAckMessage );
+
+                    #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+                    {
+                        /* The ACK that is sent now replaces the delayed one. */
+                        pxSocket->u.xTCP.ulAcksSaved++;
+                    }
+                    #endif
                 }
 
                 pxSocket->u.xTCP.pxAckMessage = NULL;
@@ -1374,6 +1777,15 @@
          * The prvTCPSendSpecialPacketHelper function uses the sequence number of the packet as the
          * ACK number and the ACK number as the sequence number, therefore the values are set swapped
          * here to match the RFC. */
+        #if ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 )
+        {
+            uint16_t usChecksum = pxProtocolHeaders->xTCPHeader.usChecksum;
+
+            usChecksum = usChecksumAdjust32( usChecksum, pxProtocolHeaders->xTCPHeader.ulSequenceNumber, FreeRTOS_htonl( ulCurrentSequenceNumber ) );
+            usChecksum = usChecksumAdjust32( usChecksum, pxProtocolHeaders->xTCPHeader.ulAckNr, FreeRTOS_htonl( ulOurSequenceNumber ) );
+            pxProtocolHeaders->xTCPHeader.usChecksum = usChecksum;
+        }
+        #endif
         pxProtocolHeaders->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( ulCurrentSequenceNumber );
         pxProtocolHeaders->xTCPHeader.ulAckNr = FreeRTOS_htonl( ulOurSequenceNumber );
 
@@ -1381,6 +1793,46 @@
     }
     /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/**
+ * @brief Reply with an ACK to a segment that was dropped by PAWS, as described
+ *        in RFC 7323 section 5.3. Unlike prvTCPSendChallengeAck(), the reply is
+ *        built like any other ACK of the connection: prvSetOptions() adds the
+ *        time-stamp option with TSecr set to TS.Recent, and prvTCPReturnPacket()
+ *        fills in the sequence and acknowledgement numbers.
+ *
+ * @param[in] pxSocket The socket owning the connection.
+ * @param[in] pxNetworkBuffer The network buffer with the dropped segment. It
+ *                            will be re-used for the ACK, but not released.
+ */
+        void prvTCPSendTimestampAck( FreeRTOS_Socket_t * pxSocket,
+                                     NetworkBufferDescriptor_t * pxNetworkBuffer )
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            ProtocolHeaders_t * pxProtocolHeaders = ( ( ProtocolHeaders_t * )
+                                                      &( pxNetworkBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + uxIPHeaderSizePacket( pxNetworkBuffer ) ] ) );
+            UBaseType_t uxOptionsLength;
+            UBaseType_t uxSendLength;
+
+            pxProtocolHeaders->xTCPHeader.ucTCPFlags = tcpTCP_FLAG_ACK;
+
+            /* The options of the dropped segment are not echoed, prvSetOptions()
+             * will set a new offset when it writes any option. */
+            pxProtocolHeaders->xTCPHeader.ucTCPOffset = tcpTCP_OFFSET_STANDARD_LENGTH;
+            uxOptionsLength = prvSetOptions( pxSocket, pxNetworkBuffer );
+
+            uxSendLength = uxIPHeaderSizeSocket( pxSocket ) + ipSIZE_OF_TCP_HEADER + uxOptionsLength;
+
+            /* The caller still owns the network buffer and will release it. */
+            prvTCPReturnPacket( pxSocket, pxNetworkBuffer, ( uint32_t ) uxSendLength, pdFALSE );
+        }
+        /*-----------------------------------------------------------*/
+
+    #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+
 /**
  * @brief Send a RST (Reset) to peer in case the packet cannot be handled.
  *
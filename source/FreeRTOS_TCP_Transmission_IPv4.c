@@ -102,6 +102,10 @@ void prvTCPReturnPacket_IPV4( FreeRTOS_Socket_t * pxSocket,
     eResolutionLookupResult_t eResult;
     NetworkEndPoint_t * pxEndPoint = NULL;
 
+    #if ( ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 ) && ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 ) )
+        BaseType_t xChecksumValid = pdFALSE;
+    #endif
+
     do
     {
         /* For sending, a pseudo network buffer will be used, as explained above. */
@@ -190,6 +194,19 @@ void prvTCPReturnPacket_IPV4( FreeRTOS_Socket_t * pxSocket,
                 vFlip_32( pxIPHeader->ulDestinationIPAddress, pxIPHeader->ulSourceIPAddress );
             }
 
+            #if ( ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 ) && ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 ) )
+            {
+                /* A reply to a received packet of the same length: the TCP checksum,
+                 * which was verified at reception, has been kept up-to-date by the
+                 * code that changed the header. Swapping the addresses, the ports and
+                 * the sequence numbers does not change it either. */
+                if( ( pxSocket == NULL ) && ( pxIPHeader->usLength == FreeRTOS_htons( ulLen ) ) )
+                {
+                    xChecksumValid = pdTRUE;
+                }
+            }
+            #endif
+
             pxIPHeader->ucTimeToLive = ( uint8_t ) ipconfigTCP_TIME_TO_LIVE;
             pxIPHeader->usLength = FreeRTOS_htons( ulLen );
 
@@ -214,10 +231,35 @@ void prvTCPReturnPacket_IPV4( FreeRTOS_Socket_t * pxSocket,
                 pxIPHeader->usHeaderChecksum = ( uint16_t ) ~FreeRTOS_htons( pxIPHeader->usHeaderChecksum );
 
                 /* calculate the TCP checksum for an outgoing packet. */
-                ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxTCPPacket, pxNetworkBuffer->xDataLength, pdTRUE );
+                #if ( ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 ) && ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 ) )
+                    if( xChecksumValid == pdFALSE )
+                #endif
+                {
+                    #if ( ipTCP_TX_PAYLOAD_SUM == 1 )
+                        if( ( pxSocket != NULL ) && ( pxSocket->u.xTCP.uxTxPayloadSummed != 0U ) )
+                        {
+                            /* The payload was summed while it was copied, or
+                             * when it was attached as fragments. */
+                            ( void ) usGenerateProtocolChecksumPartial( ( uint8_t * ) pxTCPPacket, ( size_t ) ulLen + ipSIZE_OF_ETH_HEADER,
+                                                                        pxSocket->u.xTCP.uxTxPayloadSummed, pxSocket->u.xTCP.usTxPayloadSum );
+                        }
+                        else
+                    #endif
+                    {
+                        ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxTCPPacket, pxNetworkBuffer->xDataLength, pdTRUE );
+                    }
+                }
             }
             #endif /* if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 ) */
 
+            #if ( ipTCP_TX_PAYLOAD_SUM == 1 )
+                if( pxSocket != NULL )
+                {
+                    /* The sum belongs to this packet only. */
+                    pxSocket->u.xTCP.uxTxPayloadSummed = 0U;
+                }
+            #endif
+
             vFlip_16( pxProtocolHeaders->xTCPHeader.usSourcePort, pxProtocolHeaders->xTCPHeader.usDestinationPort );
 
             /* Important: tell NIC driver how many bytes must be sent. */
@@ -279,6 +321,14 @@ void prvTCPReturnPacket_IPV4( FreeRTOS_Socket_t * pxSocket,
             }
             #endif /* if( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 ) */
 
+            #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+            {
+                /* The payload that is stored in fragments is sent after the
+                 * Ethernet buffer. */
+                pxNetworkBuffer->xDataLength -= uxNetworkBufferFragmentBytes( pxNetworkBuffer );
+            }
+            #endif
+
             /* Send! */
             iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
 
@@ -286,6 +336,20 @@ void prvTCPReturnPacket_IPV4( FreeRTOS_Socket_t * pxSocket,
             configASSERT( pxNetworkBuffer->pxEndPoint->pxNetworkInterface->pfOutput != NULL );
 
             pxInterface = pxNetworkBuffer->pxEndPoint->pxNetworkInterface;
+
+            #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+            {
+                /* The end-point may have changed since the fragments were
+                 * attached, the interface might not be able to send them. */
+                if( ( pxNetworkBuffer->uxFragmentCount != 0U ) &&
+                    ( pxInterface->bits.bTxScatterGather == pdFALSE_UNSIGNED ) &&
+                    ( xNetworkBufferLinearise( pxNetworkBuffer ) == pdFAIL ) )
+                {
+                    break;
+                }
+            }
+            #endif
+
             ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, xDoRelease );
 
             if( xDoRelease == pdFALSE )
@@ -496,9 +560,24 @@ BaseType_t prvTCPSendSpecialPktHelper_IPV4( NetworkBufferDescriptor_t * pxNetwor
             ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER; /* Plus 0 options. */
 
         uint8_t ucFlagsReceived = pxTCPPacket->xTCPHeader.ucTCPFlags;
+
+        #if ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 )
+            uint16_t usOldWord = FreeRTOS_htons( ( uint16_t ) ( ( ( uint16_t ) pxTCPPacket->xTCPHeader.ucTCPOffset << 8 ) | ucFlagsReceived ) );
+        #endif
+
         pxTCPPacket->xTCPHeader.ucTCPFlags = ucTCPFlags;
         pxTCPPacket->xTCPHeader.ucTCPOffset = ( ipSIZE_OF_TCP_HEADER ) << 2;
 
+        #if ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 )
+        {
+            /* The offset and the flags share a 16-bit word in the TCP header.
+             * Keep the checksum of the received packet valid, so that
+             * prvTCPReturnPacket() does not have to calculate it again. */
+            uint16_t usNewWord = FreeRTOS_htons( ( uint16_t ) ( ( ( uint16_t ) pxTCPPacket->xTCPHeader.ucTCPOffset << 8 ) | ucTCPFlags ) );
+            pxTCPPacket->xTCPHeader.usChecksum = usChecksumAdjust16( pxTCPPacket->xTCPHeader.usChecksum, usOldWord, usNewWord );
+        }
+        #endif
+
         if( ( ucFlagsReceived & tcpTCP_FLAG_SYN ) != 0U )
         {
             /* A synchronize packet is received. It counts as 1 pseudo byte of data,
@@ -506,6 +585,15 @@ BaseType_t prvTCPSendSpecialPktHelper_IPV4( NetworkBufferDescriptor_t * pxNetwor
              * 'ulSequenceNumber' and 'ulAckNr' will be swapped. */
             uint32_t ulSequenceNumber = FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulSequenceNumber );
             ulSequenceNumber++;
+
+            #if ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 )
+            {
+                pxTCPPacket->xTCPHeader.usChecksum = usChecksumAdjust32( pxTCPPacket->xTCPHeader.usChecksum,
+                                                                         pxTCPPacket->xTCPHeader.ulSequenceNumber,
+                                                                         FreeRTOS_htonl( ulSequenceNumber ) );
+            }
+            #endif
+
             pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( ulSequenceNumber );
         }
 
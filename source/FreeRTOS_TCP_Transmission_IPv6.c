@@ -100,6 +100,10 @@ void prvTCPReturnPacket_IPV6( FreeRTOS_Socket_t * pxSocket,
     const size_t uxIPHeaderSize = ipSIZE_OF_IPv6_HEADER;
     IPv6_Address_t xDestinationIPAddress;
 
+    #if ( ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 ) && ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 ) )
+        BaseType_t xChecksumValid = pdFALSE;
+    #endif
+
     do
     {
         /* Use do/while to be able to break out of the flow */
@@ -208,6 +212,17 @@ void prvTCPReturnPacket_IPV6( FreeRTOS_Socket_t * pxSocket,
                 ( void ) memcpy( pxIPHeader->xSourceAddress.ucBytes, xTempAddress.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
             }
 
+            #if ( ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 ) && ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 ) )
+            {
+                /* See prvTCPReturnPacket_IPV4(): a reply of the same length still
+                 * carries a valid TCP checksum. */
+                if( ( pxSocket == NULL ) && ( pxIPHeader->usPayloadLength == FreeRTOS_htons( ulLen - sizeof( IPHeader_IPv6_t ) ) ) )
+                {
+                    xChecksumValid = pdTRUE;
+                }
+            }
+            #endif
+
             /* In IPv6, the "payload length" does not include the size of the IP-header */
             pxIPHeader->usPayloadLength = FreeRTOS_htons( ulLen - sizeof( IPHeader_IPv6_t ) );
 
@@ -215,10 +230,36 @@ void prvTCPReturnPacket_IPV6( FreeRTOS_Socket_t * pxSocket,
             {
                 /* calculate the TCP checksum for an outgoing packet. */
                 uint32_t ulTotalLength = ulLen + ipSIZE_OF_ETH_HEADER;
-                ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxNetworkBuffer->pucEthernetBuffer, ulTotalLength, pdTRUE );
+
+                #if ( ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 ) && ( ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM == 0 ) )
+                    if( xChecksumValid == pdFALSE )
+                #endif
+                {
+                    #if ( ipTCP_TX_PAYLOAD_SUM == 1 )
+                        if( ( pxSocket != NULL ) && ( pxSocket->u.xTCP.uxTxPayloadSummed != 0U ) )
+                        {
+                            /* The payload was summed while it was copied, or
+                             * when it was attached as fragments. */
+                            ( void ) usGenerateProtocolChecksumPartial( ( uint8_t * ) pxNetworkBuffer->pucEthernetBuffer, ulTotalLength,
+                                                                        pxSocket->u.xTCP.uxTxPayloadSummed, pxSocket->u.xTCP.usTxPayloadSum );
+                        }
+                        else
+                    #endif
+                    {
+                        ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxNetworkBuffer->pucEthernetBuffer, ulTotalLength, pdTRUE );
+                    }
+                }
             }
             #endif /* ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 */
 
+            #if ( ipTCP_TX_PAYLOAD_SUM == 1 )
+                if( pxSocket != NULL )
+                {
+                    /* The sum belongs to this packet only. */
+                    pxSocket->u.xTCP.uxTxPayloadSummed = 0U;
+                }
+            #endif
+
             vFlip_16( pxProtocolHeaders->xTCPHeader.usSourcePort, pxProtocolHeaders->xTCPHeader.usDestinationPort );
 
             /* Important: tell NIC driver how many bytes must be sent. */
@@ -273,6 +314,14 @@ void prvTCPReturnPacket_IPV6( FreeRTOS_Socket_t * pxSocket,
             }
             #endif /* if( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 ) */
 
+            #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+            {
+                /* The payload that is stored in fragments is sent after the
+                 * Ethernet buffer. */
+                pxNetworkBuffer->xDataLength -= uxNetworkBufferFragmentBytes( pxNetworkBuffer );
+            }
+            #endif
+
             /* Send! */
             iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
 
@@ -280,6 +329,23 @@ void prvTCPReturnPacket_IPV6( FreeRTOS_Socket_t * pxSocket,
             configASSERT( pxNetworkBuffer->pxEndPoint->pxNetworkInterface->pfOutput != NULL );
 
             pxInterface = pxNetworkBuffer->pxEndPoint->pxNetworkInterface;
+
+            #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+            {
+                /* The end-point may have changed since the fragments were
+                 * attached, the interface might not be able to send them. */
+                if( ( pxNetworkBuffer->uxFragmentCount != 0U ) &&
+                    ( pxInterface->bits.bTxScatterGather == pdFALSE_UNSIGNED ) &&
+                    ( xNetworkBufferLinearise( pxNetworkBuffer ) == pdFAIL ) )
+                {
+                    /* Only buffers that were passed with xReleaseAfterSend
+                     * have fragments. */
+                    vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+                    break;
+                }
+            }
+            #endif
+
             ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, xDoRelease );
 
             if( xDoRelease == pdFALSE )
@@ -511,9 +577,24 @@ BaseType_t prvTCPSendSpecialPktHelper_IPV6( NetworkBufferDescriptor_t * pxNetwor
             ipSIZE_OF_IPv6_HEADER + ipSIZE_OF_TCP_HEADER; /* Plus 0 options. */
 
         uint8_t ucFlagsReceived = pxTCPPacket->xTCPHeader.ucTCPFlags;
+
+        #if ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 )
+            uint16_t usOldWord = FreeRTOS_htons( ( uint16_t ) ( ( ( uint16_t ) pxTCPPacket->xTCPHeader.ucTCPOffset << 8 ) | ucFlagsReceived ) );
+        #endif
+
         pxTCPPacket->xTCPHeader.ucTCPFlags = ucTCPFlags;
         pxTCPPacket->xTCPHeader.ucTCPOffset = ( ipSIZE_OF_TCP_HEADER ) << 2;
 
+        #if ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 )
+        {
+            /* The offset and the flags share a 16-bit word in the TCP header.
+             * Keep the checksum of the received packet valid, so that
+             * prvTCPReturnPacket() does not have to calculate it again. */
+            uint16_t usNewWord = FreeRTOS_htons( ( uint16_t ) ( ( ( uint16_t ) pxTCPPacket->xTCPHeader.ucTCPOffset << 8 ) | ucTCPFlags ) );
+            pxTCPPacket->xTCPHeader.usChecksum = usChecksumAdjust16( pxTCPPacket->xTCPHeader.usChecksum, usOldWord, usNewWord );
+        }
+        #endif
+
         if( ( ucFlagsReceived & tcpTCP_FLAG_SYN ) != 0U )
         {
             /* A synchronize packet is received. It counts as 1 pseudo byte of data,
@@ -521,6 +602,15 @@ BaseType_t prvTCPSendSpecialPktHelper_IPV6( NetworkBufferDescriptor_t * pxNetwor
              * 'ulSequenceNumber' and 'ulAckNr' will be swapped. */
             uint32_t ulSequenceNumber = FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulSequenceNumber );
             ulSequenceNumber++;
+
+            #if ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM == 1 )
+            {
+                pxTCPPacket->xTCPHeader.usChecksum = usChecksumAdjust32( pxTCPPacket->xTCPHeader.usChecksum,
+                                                                         pxTCPPacket->xTCPHeader.ulSequenceNumber,
+                                                                         FreeRTOS_htonl( ulSequenceNumber ) );
+            }
+            #endif
+
             pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( ulSequenceNumber );
         }
 
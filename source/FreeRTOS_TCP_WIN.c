@@ -91,6 +91,33 @@
         #define MAX_TRANSMIT_COUNT_USING_LARGE_WINDOW    ( 4U )
 
     #endif /* configUSE_TCP_WIN */
+
+    #if ( ipconfigUSE_TCP_CUBIC == 1 )
+
+/** @brief The multiplicative decrease factor of CUBIC, beta_cubic = 0.7. */
+        #define winCUBIC_BETA_NUMERATOR      ( 7U )
+        #define winCUBIC_BETA_DENOMINATOR    ( 10U )
+
+/** @brief CUBIC calculates with time in units of 1/64 second. */
+        #define winCUBIC_TIME_UNITS          ( 64U )
+
+/** @brief Times in ms are limited to one minute before they are converted. */
+        #define winCUBIC_MAX_TIME_MS         ( 60000U )
+
+/** @brief |t - K| is limited to 25 seconds, so that its cube fits in 32 bits. */
+        #define winCUBIC_MAX_DISTANCE        ( 1600U )
+
+/** @brief K^3 = ( W_max - cwnd ) / C, where C = 0.4.  With ( W_max - cwnd )
+ * in units of 1/256 MSS, and K in units of 1/64 second, the factor becomes
+ * 64^3 / ( 0.4 * 256 ) = 2560. */
+        #define winCUBIC_K_FACTOR            ( 2560U )
+
+/** @brief C * t^3 in bytes is calculated as ( ( t^3 >> 16 ) * MSS ) / 10,
+ * with t in units of 1/64 second: 0.4 / 64^3 = 1 / ( 65536 * 10 ). */
+        #define winCUBIC_C_SHIFT             ( 16U )
+        #define winCUBIC_C_DIVISOR           ( 10U )
+
+    #endif /* ipconfigUSE_TCP_CUBIC == 1 */
 /*-----------------------------------------------------------*/
 
     #if ( ipconfigUSE_TCP_WIN == 1 )
@@ -107,10 +134,55 @@
  * As soon as a package has been confirmed, the descriptor will be returned
  * to the segment pool
  */
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 0 ) )
         static BaseType_t prvCreateSectors( void );
+    #endif
+
+/*
+ * Initialise a number of new segment descriptors and add them to 'xSegmentList'.
+ */
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+        static void prvInitialiseSectors( TCPSegment_t * pxSegments,
+                                          BaseType_t xCount );
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+
+/*
+ * With ipconfigUSE_TCP_WIN_SEGMENT_ARENA, the descriptors are allocated in
+ * chunks, and every socket has a quota and a reservation.
+ */
+    #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
+        static BaseType_t prvTCPWindowGrowArena( void );
+
+        static BaseType_t prvTCPWindowArenaAllow( const TCPWindow_t * pxWindow );
+    #endif /* ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 */
+
+/*
+ * Return a segment of a window to the pool, after removing it from the
+ * administration of the window.
+ */
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+        static void prvTCPWindowRelease( TCPWindow_t * pxWindow,
+                                         TCPSegment_t * pxSegment );
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 
+/*
+ * Maintain and search the segment index: a balanced (AVL) tree of the segments
+ * of a window, ordered by sequence number.
+ */
+    #if ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+        static void prvTCPWindowIndexInsert( TCPSegment_t ** ppxRoot,
+                                             TCPSegment_t * pxSegment );
+
+        static void prvTCPWindowIndexRemove( TCPSegment_t ** ppxRoot,
+                                             TCPSegment_t * pxSegment );
+
+        static TCPSegment_t * prvTCPWindowIndexLowerBound( TCPSegment_t * pxRoot,
+                                                           uint32_t ulSequenceNumber );
+
+        static void prvTCPWindowIndexRebalance( TCPSegment_t ** ppxRoot,
+                                                TCPSegment_t * pxStart );
+    #endif /* ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 */
+
 /*
  * Find a segment with a given sequence number in the list of received
  * segments: 'pxWindow->xRxSegments'.
@@ -197,6 +269,21 @@
                                                 uint32_t ulLast );
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 
+/*
+ * A new round-trip time has been measured, update the smoothed RTT.
+ */
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+        static void prvTCPWindowUpdateSRTT( TCPWindow_t * pxWindow,
+                                            int32_t lRoundTripTime );
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+
+/*
+ * Take a round-trip time sample from the TSecr of an ACK.
+ */
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+        static void prvTCPWindowTimestampRTT( TCPWindow_t * pxWindow );
+    #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+
 /*
  * A higher Tx block has been acknowledged.  Now iterate through the xWaitQueue
  * to find a possible condition for a FAST retransmission.
@@ -206,23 +293,153 @@
                                                     uint32_t ulFirst );
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 
+/*
+ * Use the SACK scoreboard to find all segments that must be considered lost
+ * ( RFC 6675 ) and queue them for an immediate retransmission.
+ */
+    #if ( ipconfigUSE_TCP_SACK_SCOREBOARD == 1 )
+        static uint32_t prvTCPWindowSackScoreboard( TCPWindow_t * pxWindow );
+    #endif /* ipconfigUSE_TCP_SACK_SCOREBOARD == 1 */
+
+/*
+ * Congestion control (RFC 5681 and RFC 6582): initialise cwnd and ssthresh,
+ * let cwnd grow when new data has been acknowledged, and shrink it when a
+ * loss has been detected, either by duplicate ACKs or by the expiry of the
+ * retransmission timer.  How much cwnd grows, and what ssthresh becomes, is
+ * decided by the algorithm that the socket has selected.
+ */
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+        static const TCPCongestionOps_t * prvTCPWindowCongestionOps( const TCPWindow_t * pxWindow );
+
+        static void prvTCPWindowCongestionInit( TCPWindow_t * pxWindow );
+
+        static void prvTCPWindowCongestionOnAck( TCPWindow_t * pxWindow,
+                                                 uint32_t ulBytesAcked );
+
+        static void prvTCPWindowCongestionOnDupAck( TCPWindow_t * pxWindow,
+                                                    uint32_t ulRetransmitCount );
+
+        static void prvTCPWindowCongestionOnTimeout( TCPWindow_t * pxWindow,
+                                                     BaseType_t xFirstTimeout );
+
+        static void prvTCPWindowCongestionSlowStart( TCPWindow_t * pxWindow,
+                                                     uint32_t ulBytesAcked );
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+
+/*
+ * The NewReno congestion control algorithm.
+ */
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+        static void prvTCPNewRenoOnAck( TCPWindow_t * pxWindow,
+                                        uint32_t ulBytesAcked );
+
+        static void prvTCPNewRenoOnLoss( TCPWindow_t * pxWindow );
+
+        static void prvTCPNewRenoOnTimeout( TCPWindow_t * pxWindow,
+                                            BaseType_t xFirstTimeout );
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+
+/*
+ * The CUBIC congestion control algorithm ( RFC 9438 ).
+ */
+    #if ( ipconfigUSE_TCP_CUBIC == 1 )
+        static uint32_t prvTCPCubicRoot( uint32_t ulValue );
+
+        static void prvTCPCubicStartEpoch( TCPWindow_t * pxWindow );
+
+        static uint32_t prvTCPCubicTarget( const TCPWindow_t * pxWindow );
+
+        static void prvTCPCubicInit( TCPWindow_t * pxWindow );
+
+        static void prvTCPCubicOnAck( TCPWindow_t * pxWindow,
+                                      uint32_t ulBytesAcked );
+
+        static void prvTCPCubicOnLoss( TCPWindow_t * pxWindow );
+
+        static void prvTCPCubicOnTimeout( TCPWindow_t * pxWindow,
+                                          BaseType_t xFirstTimeout );
+
+        static void prvTCPCubicOnRTTSample( TCPWindow_t * pxWindow,
+                                            uint32_t ulRoundTripTime );
+    #endif /* ipconfigUSE_TCP_CUBIC == 1 */
+
 /*-----------------------------------------------------------*/
 
 /**< TCP segment pool. */
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 0 ) )
         static TCPSegment_t * xTCPSegments = NULL;
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif
 
 /**< List of free TCP segments. */
     #if ( ipconfigUSE_TCP_WIN == 1 )
         _static List_t xSegmentList;
     #endif
 
+    #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
+/** @brief The number of chunks in an arena that has grown to its maximum. */
+        #define winSEGMENT_CHUNK_MAX    ( ( ipconfigTCP_WIN_SEG_COUNT + ipconfigTCP_WIN_SEG_CHUNK_COUNT - 1 ) / ipconfigTCP_WIN_SEG_CHUNK_COUNT )
+
+/**< The chunks of segment descriptors that have been allocated. */
+        _static TCPSegment_t * pxTCPSegmentChunks[ winSEGMENT_CHUNK_MAX ];
+
+/**< The use of the segment descriptors, as reported by vTCPSegmentGetStats(). */
+        _static TCPSegmentStats_t xTCPSegmentStats;
+    #endif
+
     #if ( ipconfigUSE_TCP_WIN == 1 )
 /** @brief Logging verbosity level. */
         BaseType_t xTCPWindowLoggingLevel = 0;
     #endif
 
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+/** @brief The NewReno congestion control algorithm, used by all sockets that
+ * have not selected another algorithm. */
+        const TCPCongestionOps_t xTCPCongestionNewReno =
+        {
+            "newreno",
+            NULL,
+            prvTCPNewRenoOnAck,
+            prvTCPNewRenoOnLoss,
+            prvTCPNewRenoOnTimeout,
+            NULL
+        };
+    #endif
+
+    #if ( ipconfigUSE_TCP_CUBIC == 1 )
+/** @brief The CUBIC congestion control algorithm. */
+        const TCPCongestionOps_t xTCPCongestionCubic =
+        {
+            "cubic",
+            prvTCPCubicInit,
+            prvTCPCubicOnAck,
+            prvTCPCubicOnLoss,
+            prvTCPCubicOnTimeout,
+            prvTCPCubicOnRTTSample
+        };
+    #endif
+
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+/**< The clock that is sent out as TSval, in ms. */
+        _static uint32_t ulTimestampMS = 0U;
+
+/**< The tick count at which ulTimestampMS was brought up-to-date. */
+        _static TickType_t xTimestampLastTick = 0U;
+
+/**< The part of a ms that was left over, in units of 1 / configTICK_RATE_HZ ms. */
+        _static uint32_t ulTimestampRemainder = 0U;
+    #endif
+
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+/** @brief The congestion control algorithms that can be selected by name. */
+        static const TCPCongestionOps_t * const pxTCPCongestionAlgorithms[] =
+        {
+            &( xTCPCongestionNewReno ),
+            #if ( ipconfigUSE_TCP_CUBIC == 1 )
+                &( xTCPCongestionCubic ),
+            #endif
+        };
+    #endif
+
     #if ( ipconfigUSE_TCP_WIN == 1 )
         /* Some 32-bit arithmetic: comparing sequence numbers */
         static portINLINE BaseType_t xSequenceLessThanOrEqual( uint32_t a,
@@ -411,7 +628,7 @@
     #endif /* if ( ipconfigUSE_TCP_WIN == 1 ) */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 0 ) )
 
 /**
  * @brief Creates a pool of 'ipconfigTCP_WIN_SEG_COUNT' sector buffers. Should be called once only.
@@ -420,7 +637,6 @@
  */
         static BaseType_t prvCreateSectors( void )
         {
-            BaseType_t xIndex;
             BaseType_t xReturn;
 
             /* Allocate space for 'xTCPSegments' and store them in 'xSegmentList'. */
@@ -437,555 +653,533 @@
             }
             else
             {
-                /* Clear the allocated space. */
-                ( void ) memset( xTCPSegments, 0, ( size_t ) ipconfigTCP_WIN_SEG_COUNT * sizeof( xTCPSegments[ 0 ] ) );
-
-                for( xIndex = 0; xIndex < ipconfigTCP_WIN_SEG_COUNT; xIndex++ )
-                {
-                    /* Could call vListInitialiseItem here but all data has been
-                    * nulled already.  Set the owner to a segment descriptor. */
-
-                    #if ( configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES == 1 )
-                    {
-                        vListInitialiseItem( &( xTCPSegments[ xIndex ].xSegmentItem ) );
-                        vListInitialiseItem( &( xTCPSegments[ xIndex ].xQueueItem ) );
-                    }
-                    #endif
-
-                    listSET_LIST_ITEM_OWNER( &( xTCPSegments[ xIndex ].xSegmentItem ), ( void * ) &( xTCPSegments[ xIndex ] ) );
-                    listSET_LIST_ITEM_OWNER( &( xTCPSegments[ xIndex ].xQueueItem ), ( void * ) &( xTCPSegments[ xIndex ] ) );
-
-                    /* And add it to the pool of available segments */
-                    vListInsertFifo( &xSegmentList, &( xTCPSegments[ xIndex ].xSegmentItem ) );
-                }
+                prvInitialiseSectors( xTCPSegments, ipconfigTCP_WIN_SEG_COUNT );
 
                 xReturn = pdPASS;
             }
 
             return xReturn;
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ( ipconfigUSE_TCP_WIN == 1 ) && ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 0 ) */
 /*-----------------------------------------------------------*/
 
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
- * @brief Find a segment with a given sequence number in the list of received segments.
+ * @brief Initialise new segment descriptors and add them to the pool of available segments.
  *
- * @param[in] pxWindow The descriptor of the TCP sliding windows.
- * @param[in] ulSequenceNumber the sequence number to look-up
- *
- * @return The address of the segment descriptor found, or NULL when not found.
+ * @param[in] pxSegments An array of segment descriptors.
+ * @param[in] xCount The number of descriptors in the array.
  */
-        static TCPSegment_t * xTCPWindowRxFind( const TCPWindow_t * pxWindow,
-                                                uint32_t ulSequenceNumber )
+        static void prvInitialiseSectors( TCPSegment_t * pxSegments,
+                                          BaseType_t xCount )
         {
-            const ListItem_t * pxIterator;
-            const ListItem_t * pxEnd;
-            TCPSegment_t * pxSegment, * pxReturn = NULL;
-
-            /* Find a segment with a given sequence number in the list of received
-             * segments. */
+            BaseType_t xIndex;
 
-            /* MISRA Ref 11.3.1 [Misaligned access] */
-/* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
-            /* coverity[misra_c_2012_rule_11_3_violation] */
-            pxEnd = ( ( const ListItem_t * ) &( pxWindow->xRxSegments.xListEnd ) );
+            /* Clear the allocated space. */
+            ( void ) memset( pxSegments, 0, ( size_t ) xCount * sizeof( pxSegments[ 0 ] ) );
 
-            for( pxIterator = listGET_NEXT( pxEnd );
-                 pxIterator != pxEnd;
-                 pxIterator = listGET_NEXT( pxIterator ) )
+            for( xIndex = 0; xIndex < xCount; xIndex++ )
             {
-                pxSegment = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+                /* Could call vListInitialiseItem here but all data has been
+                * nulled already.  Set the owner to a segment descriptor. */
 
-                if( pxSegment->ulSequenceNumber == ulSequenceNumber )
+                #if ( configUSE_LIST_DATA_INTEGRITY_CHECK_BYTES == 1 )
                 {
-                    pxReturn = pxSegment;
-                    break;
+                    vListInitialiseItem( &( pxSegments[ xIndex ].xSegmentItem ) );
+                    vListInitialiseItem( &( pxSegments[ xIndex ].xQueueItem ) );
                 }
-            }
+                #endif
 
-            return pxReturn;
+                listSET_LIST_ITEM_OWNER( &( pxSegments[ xIndex ].xSegmentItem ), ( void * ) &( pxSegments[ xIndex ] ) );
+                listSET_LIST_ITEM_OWNER( &( pxSegments[ xIndex ].xQueueItem ), ( void * ) &( pxSegments[ xIndex ] ) );
+
+                /* And add it to the pool of available segments */
+                vListInsertFifo( &xSegmentList, &( pxSegments[ xIndex ].xSegmentItem ) );
+            }
         }
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
 
 /**
- * @brief Allocate a new segment object, either for transmission or reception.
- *
- * @param[in] pxWindow The descriptor of the TCP sliding windows.
- * @param[in] ulSequenceNumber The sequence number.
- * @param[in] lCount The number of bytes stored in this segment.
- * @param[in] xIsForRx True when this is a reception segment.
+ * @brief Let the arena of segment descriptors grow with one chunk of at most
+ *        'ipconfigTCP_WIN_SEG_CHUNK_COUNT' descriptors, as long as the total
+ *        stays within 'ipconfigTCP_WIN_SEG_COUNT'.
  *
- * @return Allocate and initialise a segment descriptor, or NULL when none was available.
+ * @return When a chunk was added: pdPASS, otherwise pdFAIL.
  */
-        static TCPSegment_t * xTCPWindowNew( TCPWindow_t * pxWindow,
-                                             uint32_t ulSequenceNumber,
-                                             int32_t lCount,
-                                             BaseType_t xIsForRx )
+        static BaseType_t prvTCPWindowGrowArena( void )
         {
-            TCPSegment_t * pxSegment;
-            ListItem_t * pxItem;
+            BaseType_t xReturn = pdFAIL;
+            TCPSegment_t * pxSegments = NULL;
+            size_t uxChunk = ( size_t ) xTCPSegmentStats.uxAllocated / ( size_t ) ipconfigTCP_WIN_SEG_CHUNK_COUNT;
+            size_t uxCount = ( size_t ) ipconfigTCP_WIN_SEG_COUNT - ( size_t ) xTCPSegmentStats.uxAllocated;
 
-            /* Allocate a new segment.  The socket will borrow all segments from a
-             * common pool: 'xSegmentList', which is a list of 'TCPSegment_t' */
-            if( listLIST_IS_EMPTY( &xSegmentList ) != pdFALSE )
+            if( uxCount > ( size_t ) ipconfigTCP_WIN_SEG_CHUNK_COUNT )
             {
-                /* If the TCP-stack runs out of segments, you might consider
-                 * increasing 'ipconfigTCP_WIN_SEG_COUNT'. */
-                FreeRTOS_debug_printf( ( "xTCPWindow%cxNew: Error: all segments occupied\n", ( xIsForRx != 0 ) ? 'R' : 'T' ) );
-                pxSegment = NULL;
+                uxCount = ( size_t ) ipconfigTCP_WIN_SEG_CHUNK_COUNT;
             }
-            else
-            {
-                /* Pop the item at the head of the list.  Semaphore protection is
-                * not required as only the IP task will call these functions.  */
-                pxItem = ( ListItem_t * ) listGET_HEAD_ENTRY( &xSegmentList );
-                pxSegment = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxItem ) );
-
-                configASSERT( pxItem != NULL );
-                configASSERT( pxSegment != NULL );
-
-                /* Remove the item from xSegmentList. */
-                ( void ) uxListRemove( pxItem );
 
-                /* Add it to either the connections' Rx or Tx queue. */
-                if( xIsForRx != 0 )
-                {
-                    vListInsertFifo( &pxWindow->xRxSegments, pxItem );
-                }
-                else
+            if( uxCount > 0U )
+            {
+                if( uxChunk == 0U )
                 {
-                    vListInsertFifo( &pxWindow->xTxSegments, pxItem );
+                    vListInitialise( &xSegmentList );
                 }
 
-                /* And set the segment's timer to zero */
-                vTCPTimerSet( &pxSegment->xTransmitTimer );
+                pxSegments = ( ( TCPSegment_t * ) pvPortMallocLarge( uxCount * sizeof( pxSegments[ 0 ] ) ) );
 
-                pxSegment->u.ulFlags = 0;
-                pxSegment->u.bits.bIsForRx = ( xIsForRx != 0 ) ? 1U : 0U;
-                pxSegment->lMaxLength = lCount;
-                pxSegment->lDataLength = lCount;
-                pxSegment->ulSequenceNumber = ulSequenceNumber;
-                #if ( ipconfigHAS_DEBUG_PRINTF != 0 )
+                if( pxSegments == NULL )
                 {
-                    static UBaseType_t xLowestLength = ipconfigTCP_WIN_SEG_COUNT;
-                    UBaseType_t xLength = listCURRENT_LIST_LENGTH( &xSegmentList );
-
-                    if( xLowestLength > xLength )
-                    {
-                        xLowestLength = xLength;
-                    }
+                    FreeRTOS_debug_printf( ( "prvTCPWindowGrowArena: malloc %u failed\n",
+                                             ( unsigned ) ( uxCount * sizeof( pxSegments[ 0 ] ) ) ) );
                 }
-                #endif /* ipconfigHAS_DEBUG_PRINTF */
             }
 
-            return pxSegment;
+            if( pxSegments != NULL )
+            {
+                prvInitialiseSectors( pxSegments, ( BaseType_t ) uxCount );
+
+                pxTCPSegmentChunks[ uxChunk ] = pxSegments;
+                xTCPSegmentStats.uxAllocated += ( UBaseType_t ) uxCount;
+                xReturn = pdPASS;
+            }
+
+            return xReturn;
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
 
 /**
- * @brief See if the peer has more packets for this node, before allowing to shut down the connection.
+ * @brief Check if a window may own another segment descriptor, and let the arena
+ *        grow when there is no free descriptor.
  *
  * @param[in] pxWindow The descriptor of the TCP sliding windows.
  *
- * @return pdTRUE if the connection can be closed. Else, pdFALSE.
+ * @return pdTRUE when the window may take a descriptor from 'xSegmentList'.
  */
-        BaseType_t xTCPWindowRxEmpty( const TCPWindow_t * pxWindow )
+        static BaseType_t prvTCPWindowArenaAllow( const TCPWindow_t * pxWindow )
         {
-            BaseType_t xReturn;
+            BaseType_t xReturn = pdFALSE;
+            UBaseType_t uxFree = ( UBaseType_t ) ipconfigTCP_WIN_SEG_COUNT - xTCPSegmentStats.uxInUse;
 
-            /* When the peer has a close request (FIN flag), the driver will check
-             * if there are missing packets in the Rx-queue.  It will accept the
-             * closure of the connection if both conditions are true:
-             * - the Rx-queue is empty
-             * - the highest Rx sequence number has been ACK'ed */
-            if( listLIST_IS_EMPTY( ( &pxWindow->xRxSegments ) ) == pdFALSE )
+            if( pxWindow->uxSegmentCount >= ( UBaseType_t ) ipconfigTCP_WIN_SEG_QUOTA )
             {
-                /* Rx data has been stored while earlier packets were missing. */
-                xReturn = pdFALSE;
+                xTCPSegmentStats.ulQuotaRefusals++;
             }
-            else if( xSequenceGreaterThanOrEqual( pxWindow->rx.ulCurrentSequenceNumber + 1U, pxWindow->rx.ulHighestSequenceNumber ) != pdFALSE )
+            else if( ( pxWindow->uxSegmentsReserved == 0U ) && ( uxFree <= xTCPSegmentStats.uxReserved ) )
             {
-                /* No Rx packets are being stored and the highest sequence number
-                 * that has been received has been ACKed. */
-                xReturn = pdTRUE;
+                /* The window has used its reservation, and the remaining
+                 * descriptors are reserved for other sockets. */
+                xTCPSegmentStats.ulReserveRefusals++;
             }
             else
             {
-                FreeRTOS_debug_printf( ( "xTCPWindowRxEmpty: cur %u highest %u (empty)\n",
-                                         ( unsigned ) ( pxWindow->rx.ulCurrentSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
-                                         ( unsigned ) ( pxWindow->rx.ulHighestSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ) ) );
-                xReturn = pdFALSE;
+                if( xTCPSegmentStats.uxInUse >= xTCPSegmentStats.uxAllocated )
+                {
+                    /* 'xSegmentList' is empty. */
+                    ( void ) prvTCPWindowGrowArena();
+                }
+
+                xReturn = pdTRUE;
             }
 
             return xReturn;
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
 
 /**
- * @brief Remove the head item of a list (generic function).
+ * @brief Get the height of an index sub-tree.
  *
- * @param[in] pxList The list of segment descriptors.
+ * @param[in] pxNode The root of the sub-tree, may be NULL.
  *
- * @return The address of the segment descriptor, or NULL when not found.
+ * @return The height of the sub-tree, zero when it is empty.
  */
-        static TCPSegment_t * xTCPWindowGetHead( const List_t * pxList )
+        static BaseType_t prvTCPWindowIndexHeight( const TCPSegment_t * pxNode )
         {
-            TCPSegment_t * pxSegment;
-            ListItem_t * pxItem;
+            BaseType_t xHeight = 0;
 
-            /* Detaches and returns the head of a queue. */
-            if( listLIST_IS_EMPTY( pxList ) != pdFALSE )
-            {
-                pxSegment = NULL;
-            }
-            else
+            if( pxNode != NULL )
             {
-                pxItem = ( ListItem_t * ) listGET_HEAD_ENTRY( pxList );
-                pxSegment = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxItem ) );
-
-                ( void ) uxListRemove( pxItem );
+                xHeight = pxNode->xIndexHeight;
             }
 
-            return pxSegment;
+            return xHeight;
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
-
 /**
- * @brief Return the head item of a list (generic function).
+ * @brief Recalculate the height of an index node from the heights of its children.
  *
- * @param[in] pxList The list of segment descriptors.
- *
- * @return The address of the segment descriptor, or NULL when the list is empty.
+ * @param[in] pxNode The index node.
  */
-        static TCPSegment_t * xTCPWindowPeekHead( const List_t * pxList )
+        static void prvTCPWindowIndexUpdateHeight( TCPSegment_t * pxNode )
         {
-            const ListItem_t * pxItem;
-            TCPSegment_t * pxReturn;
+            BaseType_t xLeft = prvTCPWindowIndexHeight( pxNode->pxIndexLeft );
+            BaseType_t xRight = prvTCPWindowIndexHeight( pxNode->pxIndexRight );
 
-            /* Returns the head of a queue but it won't be detached. */
-            if( listLIST_IS_EMPTY( pxList ) != pdFALSE )
+            pxNode->xIndexHeight = ( ( xLeft > xRight ) ? xLeft : xRight ) + 1;
+        }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Let 'pxNew' take the place of the child 'pxOld' of 'pxParent'.
+ *
+ * @param[in] ppxRoot The root of the index, updated when 'pxParent' is NULL.
+ * @param[in] pxParent The parent of 'pxOld'.
+ * @param[in] pxOld The child that is replaced.
+ * @param[in] pxNew The new child, may be NULL.
+ */
+        static void prvTCPWindowIndexReplace( TCPSegment_t ** ppxRoot,
+                                              TCPSegment_t * pxParent,
+                                              const TCPSegment_t * pxOld,
+                                              TCPSegment_t * pxNew )
+        {
+            if( pxParent == NULL )
             {
-                pxReturn = NULL;
+                *ppxRoot = pxNew;
+            }
+            else if( pxParent->pxIndexLeft == pxOld )
+            {
+                pxParent->pxIndexLeft = pxNew;
             }
             else
             {
-                pxItem = ( ListItem_t * ) listGET_HEAD_ENTRY( pxList );
-                pxReturn = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxItem ) );
+                pxParent->pxIndexRight = pxNew;
             }
 
-            return pxReturn;
+            if( pxNew != NULL )
+            {
+                pxNew->pxIndexParent = pxParent;
+            }
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
-
 /**
- * @brief Release a segment object, return it to the list of available segment holders.
+ * @brief Rotate an index sub-tree to the left: the right child becomes its root.
  *
- * @param[in] pxSegment The segment descriptor that must be freed.
+ * @param[in] ppxRoot The root of the index.
+ * @param[in] pxNode The current root of the sub-tree.
+ *
+ * @return The new root of the sub-tree.
  */
-        static void vTCPWindowFree( TCPSegment_t * pxSegment )
+        static TCPSegment_t * prvTCPWindowIndexRotateLeft( TCPSegment_t ** ppxRoot,
+                                                           TCPSegment_t * pxNode )
         {
-            /*  Free entry pxSegment because it's not used any more.  The ownership
-             * will be passed back to the segment pool.
-             *
-             * Unlink it from one of the queues, if any. */
-            if( listLIST_ITEM_CONTAINER( &( pxSegment->xQueueItem ) ) != NULL )
+            TCPSegment_t * pxPivot = pxNode->pxIndexRight;
+
+            prvTCPWindowIndexReplace( ppxRoot, pxNode->pxIndexParent, pxNode, pxPivot );
+
+            pxNode->pxIndexRight = pxPivot->pxIndexLeft;
+
+            if( pxNode->pxIndexRight != NULL )
             {
-                ( void ) uxListRemove( &( pxSegment->xQueueItem ) );
+                pxNode->pxIndexRight->pxIndexParent = pxNode;
             }
 
-            pxSegment->ulSequenceNumber = 0U;
-            pxSegment->lDataLength = 0;
-            pxSegment->u.ulFlags = 0U;
+            pxPivot->pxIndexLeft = pxNode;
+            pxNode->pxIndexParent = pxPivot;
 
-            /* Take it out of xRxSegments/xTxSegments */
-            if( listLIST_ITEM_CONTAINER( &( pxSegment->xSegmentItem ) ) != NULL )
+            prvTCPWindowIndexUpdateHeight( pxNode );
+            prvTCPWindowIndexUpdateHeight( pxPivot );
+
+            return pxPivot;
+        }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Rotate an index sub-tree to the right: the left child becomes its root.
+ *
+ * @param[in] ppxRoot The root of the index.
+ * @param[in] pxNode The current root of the sub-tree.
+ *
+ * @return The new root of the sub-tree.
+ */
+        static TCPSegment_t * prvTCPWindowIndexRotateRight( TCPSegment_t ** ppxRoot,
+                                                            TCPSegment_t * pxNode )
+        {
+            TCPSegment_t * pxPivot = pxNode->pxIndexLeft;
+
+            prvTCPWindowIndexReplace( ppxRoot, pxNode->pxIndexParent, pxNode, pxPivot );
+
+            pxNode->pxIndexLeft = pxPivot->pxIndexRight;
+
+            if( pxNode->pxIndexLeft != NULL )
             {
-                ( void ) uxListRemove( &( pxSegment->xSegmentItem ) );
+                pxNode->pxIndexLeft->pxIndexParent = pxNode;
             }
 
-            /* Return it to xSegmentList */
-            vListInsertFifo( &xSegmentList, &( pxSegment->xSegmentItem ) );
+            pxPivot->pxIndexRight = pxNode;
+            pxNode->pxIndexParent = pxPivot;
+
+            prvTCPWindowIndexUpdateHeight( pxNode );
+            prvTCPWindowIndexUpdateHeight( pxPivot );
+
+            return pxPivot;
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
-
 /**
- * @brief Return all segment descriptor to the poll of descriptors, before deleting a socket.
+ * @brief Restore the AVL property, walking from a changed node up to the root.
+ *        The heights of two sibling sub-trees may differ by at most one.
  *
- * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ppxRoot The root of the index.
+ * @param[in] pxStart The lowest node of which a sub-tree has changed, may be NULL.
  */
-        void vTCPWindowDestroy( TCPWindow_t const * pxWindow )
+        static void prvTCPWindowIndexRebalance( TCPSegment_t ** ppxRoot,
+                                                TCPSegment_t * pxStart )
         {
-            const List_t * pxSegments;
-            BaseType_t xRound;
-            TCPSegment_t * pxSegment;
+            TCPSegment_t * pxNode = pxStart;
+            BaseType_t xBalance;
 
-            /*  Destroy a window.  A TCP window doesn't serve any more.  Return all
-             * owned segments to the pool.  In order to save code, it will make 2 rounds,
-             * one to remove the segments from xRxSegments, and a second round to clear
-             * xTxSegments*/
-            for( xRound = 0; xRound < 2; xRound++ )
+            while( pxNode != NULL )
             {
-                if( xRound != 0 )
-                {
-                    pxSegments = &( pxWindow->xRxSegments );
-                }
-                else
+                prvTCPWindowIndexUpdateHeight( pxNode );
+                xBalance = prvTCPWindowIndexHeight( pxNode->pxIndexLeft ) - prvTCPWindowIndexHeight( pxNode->pxIndexRight );
+
+                if( xBalance > 1 )
                 {
-                    pxSegments = &( pxWindow->xTxSegments );
-                }
+                    /* Left-heavy.  A left-right case needs a double rotation. */
+                    if( prvTCPWindowIndexHeight( pxNode->pxIndexLeft->pxIndexLeft ) < prvTCPWindowIndexHeight( pxNode->pxIndexLeft->pxIndexRight ) )
+                    {
+                        ( void ) prvTCPWindowIndexRotateLeft( ppxRoot, pxNode->pxIndexLeft );
+                    }
 
-                if( listLIST_IS_INITIALISED( pxSegments ) )
+                    pxNode = prvTCPWindowIndexRotateRight( ppxRoot, pxNode );
+                }
+                else if( xBalance < -1 )
                 {
-                    while( listCURRENT_LIST_LENGTH( pxSegments ) > 0U )
+                    /* Right-heavy.  A right-left case needs a double rotation. */
+                    if( prvTCPWindowIndexHeight( pxNode->pxIndexRight->pxIndexRight ) < prvTCPWindowIndexHeight( pxNode->pxIndexRight->pxIndexLeft ) )
                     {
-                        pxSegment = ( ( TCPSegment_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSegments ) );
-                        vTCPWindowFree( pxSegment );
+                        ( void ) prvTCPWindowIndexRotateRight( ppxRoot, pxNode->pxIndexRight );
                     }
+
+                    pxNode = prvTCPWindowIndexRotateLeft( ppxRoot, pxNode );
                 }
+                else
+                {
+                    /* This sub-tree is balanced. */
+                }
+
+                pxNode = pxNode->pxIndexParent;
             }
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
 /**
- * @brief Create a window for TCP.
+ * @brief Add a segment to the index of a window.  The sequence numbers in one
+ *        window are less than 2^31 apart, so they can be compared with
+ *        xSequenceLessThan(), also when they wrap around.
  *
- * @param[in] pxWindow The window to be created.
- * @param[in] ulRxWindowLength The length of the receive window.
- * @param[in] ulTxWindowLength The length of the transmit window.
- * @param[in] ulAckNumber The first ACK number.
- * @param[in] ulSequenceNumber The first sequence number.
- * @param[in] ulMSS The MSS of the connection.
+ * @param[in] ppxRoot The root of the index.
+ * @param[in] pxSegment The segment to be added, with its sequence number set.
  */
-    BaseType_t xTCPWindowCreate( TCPWindow_t * pxWindow,
-                                 uint32_t ulRxWindowLength,
-                                 uint32_t ulTxWindowLength,
-                                 uint32_t ulAckNumber,
-                                 uint32_t ulSequenceNumber,
-                                 uint32_t ulMSS )
-    {
-        BaseType_t xReturn = pdPASS;
+        static void prvTCPWindowIndexInsert( TCPSegment_t ** ppxRoot,
+                                             TCPSegment_t * pxSegment )
+        {
+            TCPSegment_t * pxParent = NULL;
+            TCPSegment_t * pxNode = *ppxRoot;
+            BaseType_t xLower = pdFALSE;
 
-        /* Create and initialize a window. */
+            pxSegment->pxIndexLeft = NULL;
+            pxSegment->pxIndexRight = NULL;
+            pxSegment->xIndexHeight = 1;
 
-        #if ( ipconfigUSE_TCP_WIN == 1 )
-        {
-            if( xTCPSegments == NULL )
+            while( pxNode != NULL )
             {
-                xReturn = prvCreateSectors();
+                pxParent = pxNode;
+                xLower = xSequenceLessThan( pxSegment->ulSequenceNumber, pxNode->ulSequenceNumber );
+
+                if( xLower != pdFALSE )
+                {
+                    pxNode = pxNode->pxIndexLeft;
+                }
+                else
+                {
+                    pxNode = pxNode->pxIndexRight;
+                }
             }
 
-            vListInitialise( &( pxWindow->xTxSegments ) );
-            vListInitialise( &( pxWindow->xRxSegments ) );
+            pxSegment->pxIndexParent = pxParent;
 
-            vListInitialise( &( pxWindow->xPriorityQueue ) ); /* Priority queue: segments which must be sent immediately */
-            vListInitialise( &( pxWindow->xTxQueue ) );       /* Transmit queue: segments queued for transmission */
-            vListInitialise( &( pxWindow->xWaitQueue ) );     /* Waiting queue:  outstanding segments */
-        }
-        #endif /* ipconfigUSE_TCP_WIN == 1 */
+            if( pxParent == NULL )
+            {
+                *ppxRoot = pxSegment;
+            }
+            else if( xLower != pdFALSE )
+            {
+                pxParent->pxIndexLeft = pxSegment;
+            }
+            else
+            {
+                pxParent->pxIndexRight = pxSegment;
+            }
 
-        if( xTCPWindowLoggingLevel != 0 )
-        {
-            FreeRTOS_debug_printf( ( "xTCPWindowCreate: for WinLen = Rx/Tx: %u/%u\n",
-                                     ( unsigned ) ulRxWindowLength, ( unsigned ) ulTxWindowLength ) );
+            prvTCPWindowIndexRebalance( ppxRoot, pxParent );
         }
-
-        pxWindow->xSize.ulRxWindowLength = ulRxWindowLength;
-        pxWindow->xSize.ulTxWindowLength = ulTxWindowLength;
-
-        vTCPWindowInit( pxWindow, ulAckNumber, ulSequenceNumber, ulMSS );
-
-        return xReturn;
-    }
 /*-----------------------------------------------------------*/
 
 /**
- * @brief Initialise a TCP window.
+ * @brief Remove a segment from the index of a window.
  *
- * @param[in] pxWindow The window to be initialised.
- * @param[in] ulAckNumber The number of the first ACK.
- * @param[in] ulSequenceNumber The first sequence number.
- * @param[in] ulMSS The MSS of the connection.
+ * @param[in] ppxRoot The root of the index.
+ * @param[in] pxSegment The segment to be removed.
  */
-    void vTCPWindowInit( TCPWindow_t * pxWindow,
-                         uint32_t ulAckNumber,
-                         uint32_t ulSequenceNumber,
-                         uint32_t ulMSS )
-    {
-        const int32_t l500ms = 500;
-
-        pxWindow->u.ulFlags = 0U;
-        pxWindow->u.bits.bHasInit = pdTRUE_UNSIGNED;
-
-        if( ulMSS != 0U )
+        static void prvTCPWindowIndexRemove( TCPSegment_t ** ppxRoot,
+                                             TCPSegment_t * pxSegment )
         {
-            if( pxWindow->usMSSInit != 0U )
+            TCPSegment_t * pxSuccessor;
+            TCPSegment_t * pxRebalance;
+
+            if( pxSegment->pxIndexLeft == NULL )
             {
-                pxWindow->usMSSInit = ( uint16_t ) ulMSS;
+                pxRebalance = pxSegment->pxIndexParent;
+                prvTCPWindowIndexReplace( ppxRoot, pxSegment->pxIndexParent, pxSegment, pxSegment->pxIndexRight );
             }
-
-            if( ( ulMSS < ( uint32_t ) pxWindow->usMSS ) || ( pxWindow->usMSS == 0U ) )
+            else if( pxSegment->pxIndexRight == NULL )
             {
-                pxWindow->xSize.ulRxWindowLength = ( pxWindow->xSize.ulRxWindowLength / ulMSS ) * ulMSS;
-                pxWindow->usMSS = ( uint16_t ) ulMSS;
+                pxRebalance = pxSegment->pxIndexParent;
+                prvTCPWindowIndexReplace( ppxRoot, pxSegment->pxIndexParent, pxSegment, pxSegment->pxIndexLeft );
             }
-        }
-
-        #if ( ipconfigUSE_TCP_WIN == 0 )
-        {
-            pxWindow->xTxSegment.lMaxLength = ( int32_t ) pxWindow->usMSS;
-        }
-        #endif /* ipconfigUSE_TCP_WIN == 1 */
-
-        /*Start with a timeout of 2 * 500 ms (1 sec). */
-        pxWindow->lSRTT = l500ms;
-
-        /* Just for logging, to print relative sequence numbers. */
-        pxWindow->rx.ulFirstSequenceNumber = ulAckNumber;
-
-        /* The segment asked for in the next transmission. */
-        pxWindow->rx.ulCurrentSequenceNumber = ulAckNumber;
+            else
+            {
+                /* Two children: the lowest segment of the right sub-tree takes its place. */
+                pxSuccessor = pxSegment->pxIndexRight;
 
-        /* The right-hand side of the receive window. */
-        pxWindow->rx.ulHighestSequenceNumber = ulAckNumber;
+                while( pxSuccessor->pxIndexLeft != NULL )
+                {
+                    pxSuccessor = pxSuccessor->pxIndexLeft;
+                }
 
-        pxWindow->tx.ulFirstSequenceNumber = ulSequenceNumber;
+                if( pxSuccessor->pxIndexParent != pxSegment )
+                {
+                    pxRebalance = pxSuccessor->pxIndexParent;
+                    prvTCPWindowIndexReplace( ppxRoot, pxSuccessor->pxIndexParent, pxSuccessor, pxSuccessor->pxIndexRight );
+                    pxSuccessor->pxIndexRight = pxSegment->pxIndexRight;
+                    pxSuccessor->pxIndexRight->pxIndexParent = pxSuccessor;
+                }
+                else
+                {
+                    pxRebalance = pxSuccessor;
+                }
 
-        /* The segment asked for in next transmission. */
-        pxWindow->tx.ulCurrentSequenceNumber = ulSequenceNumber;
+                prvTCPWindowIndexReplace( ppxRoot, pxSegment->pxIndexParent, pxSegment, pxSuccessor );
+                pxSuccessor->pxIndexLeft = pxSegment->pxIndexLeft;
+                pxSuccessor->pxIndexLeft->pxIndexParent = pxSuccessor;
+            }
 
-        /* The sequence number given to the next outgoing byte to be added is
-         * maintained by lTCPWindowTxAdd(). */
-        pxWindow->ulNextTxSequenceNumber = ulSequenceNumber;
+            pxSegment->pxIndexParent = NULL;
+            pxSegment->pxIndexLeft = NULL;
+            pxSegment->pxIndexRight = NULL;
+            pxSegment->xIndexHeight = 0;
 
-        /* The right-hand side of the transmit window. */
-        pxWindow->tx.ulHighestSequenceNumber = ulSequenceNumber;
-        pxWindow->ulOurSequenceNumber = ulSequenceNumber;
-    }
+            prvTCPWindowIndexRebalance( ppxRoot, pxRebalance );
+        }
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
-
 /**
- * @brief Free the space occupied by the pool of segment descriptors, normally never used
+ * @brief Look up the segment with the lowest sequence number that is equal to or
+ *        higher than 'ulSequenceNumber'.
+ *
+ * @param[in] pxRoot The root of the index.
+ * @param[in] ulSequenceNumber The sequence number to look-up.
+ *
+ * @return The segment found, or NULL when all segments have a lower sequence number.
  */
-        void vTCPSegmentCleanup( void )
+        static TCPSegment_t * prvTCPWindowIndexLowerBound( TCPSegment_t * pxRoot,
+                                                           uint32_t ulSequenceNumber )
         {
-            /* Free and clear the TCP segments pointer. This function should only be called
-             * once FreeRTOS+TCP will no longer be used. No thread-safety is provided for this
-             * function. */
-            if( xTCPSegments != NULL )
+            TCPSegment_t * pxNode = pxRoot;
+            TCPSegment_t * pxReturn = NULL;
+
+            while( pxNode != NULL )
             {
-                vPortFreeLarge( xTCPSegments );
-                xTCPSegments = NULL;
+                if( xSequenceLessThan( pxNode->ulSequenceNumber, ulSequenceNumber ) != pdFALSE )
+                {
+                    pxNode = pxNode->pxIndexRight;
+                }
+                else
+                {
+                    pxReturn = pxNode;
+                    pxNode = pxNode->pxIndexLeft;
+                }
             }
+
+            return pxReturn;
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 */
 /*-----------------------------------------------------------*/
 
-/*=============================================================================
+    #if ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+
+/**
+ * @brief Find a segment with a given sequence number in the index of received segments.
  *
- *                ######        #    #
- *                 #    #       #    #
- *                 #    #       #    #
- *                 #    #        ####
- *                 ######         ##
- *                 #  ##         ####
- *                 #   #        #    #
- *                 #    #       #    #
- *                ###  ##       #    #
- * Rx functions
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulSequenceNumber the sequence number to look-up
  *
- *=============================================================================*/
+ * @return The address of the segment descriptor found, or NULL when not found.
+ */
+        static TCPSegment_t * xTCPWindowRxFind( const TCPWindow_t * pxWindow,
+                                                uint32_t ulSequenceNumber )
+        {
+            TCPSegment_t * pxReturn = prvTCPWindowIndexLowerBound( pxWindow->pxRxSegmentIndex, ulSequenceNumber );
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+            if( ( pxReturn != NULL ) && ( pxReturn->ulSequenceNumber != ulSequenceNumber ) )
+            {
+                pxReturn = NULL;
+            }
+
+            return pxReturn;
+        }
+
+    #elif ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
- * @brief A expected segment has been received, see if there is overlap with earlier segments.
+ * @brief Find a segment with a given sequence number in the list of received segments.
  *
  * @param[in] pxWindow The descriptor of the TCP sliding windows.
- * @param[in] ulSequenceNumber The sequence number of the segment that was received.
- * @param[in] ulLength The number of bytes that were received.
+ * @param[in] ulSequenceNumber the sequence number to look-up
  *
- * @return The first segment descriptor involved, or NULL when no matching descriptor was found.
+ * @return The address of the segment descriptor found, or NULL when not found.
  */
-        static TCPSegment_t * xTCPWindowRxConfirm( const TCPWindow_t * pxWindow,
-                                                   uint32_t ulSequenceNumber,
-                                                   uint32_t ulLength )
+        static TCPSegment_t * xTCPWindowRxFind( const TCPWindow_t * pxWindow,
+                                                uint32_t ulSequenceNumber )
         {
-            TCPSegment_t * pxBest = NULL;
             const ListItem_t * pxIterator;
-            uint32_t ulNextSequenceNumber = ulSequenceNumber + ulLength;
+            const ListItem_t * pxEnd;
+            TCPSegment_t * pxSegment, * pxReturn = NULL;
+
+            /* Find a segment with a given sequence number in the list of received
+             * segments. */
 
             /* MISRA Ref 11.3.1 [Misaligned access] */
 /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
             /* coverity[misra_c_2012_rule_11_3_violation] */
-            const ListItem_t * pxEnd = ( ( const ListItem_t * ) &( pxWindow->xRxSegments.xListEnd ) );
-            TCPSegment_t * pxSegment;
+            pxEnd = ( ( const ListItem_t * ) &( pxWindow->xRxSegments.xListEnd ) );
 
-            /* A segment has been received with sequence number 'ulSequenceNumber',
-             * where 'ulCurrentSequenceNumber == ulSequenceNumber', which means that
-             * exactly this segment was expected.  xTCPWindowRxConfirm() will check if
-             * there is already another segment with a sequence number between (ulSequenceNumber)
-             * and (ulSequenceNumber+ulLength).  Normally none will be found, because
-             * the next RX segment should have a sequence number equal to
-             * '(ulSequenceNumber+ulLength)'. */
-
-            /* Iterate through all RX segments that are stored: */
             for( pxIterator = listGET_NEXT( pxEnd );
                  pxIterator != pxEnd;
                  pxIterator = listGET_NEXT( pxIterator ) )
             {
                 pxSegment = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
 
-                /* And see if there is a segment for which:
-                 * 'ulSequenceNumber' <= 'pxSegment->ulSequenceNumber' < 'ulNextSequenceNumber'
-                 * If there are more matching segments, the one with the lowest sequence number
-                 * shall be taken */
-                if( ( xSequenceGreaterThanOrEqual( pxSegment->ulSequenceNumber, ulSequenceNumber ) != 0 ) &&
-                    ( xSequenceLessThan( pxSegment->ulSequenceNumber, ulNextSequenceNumber ) != 0 ) )
+                if( pxSegment->ulSequenceNumber == ulSequenceNumber )
                 {
-                    if( ( pxBest == NULL ) || ( xSequenceLessThan( pxSegment->ulSequenceNumber, pxBest->ulSequenceNumber ) != 0 ) )
-                    {
-                        pxBest = pxSegment;
-                    }
+                    pxReturn = pxSegment;
+                    break;
                 }
             }
 
-            if( ( pxBest != NULL ) &&
-                ( ( pxBest->ulSequenceNumber != ulSequenceNumber ) || ( pxBest->lDataLength != ( int32_t ) ulLength ) ) )
-            {
-                FreeRTOS_debug_printf( ( "xTCPWindowRxConfirm[%u]: search %u (+%u=%u) found %u (+%d=%u)\n",
-                                         pxWindow->usPeerPortNumber,
-                                         ( unsigned ) ( ulSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
-                                         ( unsigned ) ulLength,
-                                         ( unsigned ) ( ulSequenceNumber + ulLength - pxWindow->rx.ulFirstSequenceNumber ),
-                                         ( unsigned ) ( pxBest->ulSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
-                                         ( int ) pxBest->lDataLength,
-                                         ( unsigned ) ( pxBest->ulSequenceNumber + ( ( uint32_t ) pxBest->lDataLength ) - pxWindow->rx.ulFirstSequenceNumber ) ) );
-            }
-
-            return pxBest;
+            return pxReturn;
         }
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
@@ -993,75 +1187,128 @@
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
- * @brief Data has been received with the correct ( expected  ) sequence number.
- *        It can be added to the RX stream buffer.
- * @param[in] pxWindow The TCP sliding window data of the socket.
- * @param[in] ulLength The number of bytes that can be added.
+ * @brief Allocate a new segment object, either for transmission or reception.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulSequenceNumber The sequence number.
+ * @param[in] lCount The number of bytes stored in this segment.
+ * @param[in] xIsForRx True when this is a reception segment.
+ *
+ * @return Allocate and initialise a segment descriptor, or NULL when none was available.
  */
-        static void prvTCPWindowRx_ExpectedRX( TCPWindow_t * pxWindow,
-                                               uint32_t ulLength )
+        static TCPSegment_t * xTCPWindowNew( TCPWindow_t * pxWindow,
+                                             uint32_t ulSequenceNumber,
+                                             int32_t lCount,
+                                             BaseType_t xIsForRx )
         {
-            uint32_t ulSequenceNumber = pxWindow->rx.ulCurrentSequenceNumber;
-            uint32_t ulCurrentSequenceNumber = ulSequenceNumber + ulLength;
+            TCPSegment_t * pxSegment;
+            ListItem_t * pxItem;
+            BaseType_t xAllowed = pdTRUE;
 
-            if( listCURRENT_LIST_LENGTH( &( pxWindow->xRxSegments ) ) != 0U )
+            #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
             {
-                uint32_t ulSavedSequenceNumber = ulCurrentSequenceNumber;
-                TCPSegment_t * pxFound;
+                xAllowed = prvTCPWindowArenaAllow( pxWindow );
+            }
+            #endif
 
-                /* Clean up all sequence received between ulSequenceNumber and ulSequenceNumber + ulLength since they are duplicated.
-                 * If the server is forced to retransmit packets several time in a row it might send a batch of concatenated packet for speed.
-                 * So we cannot rely on the packets between ulSequenceNumber and ulSequenceNumber + ulLength to be sequential and it is better to just
-                 * clean them out. */
-                do
+            /* Allocate a new segment.  The socket will borrow all segments from a
+             * common pool: 'xSegmentList', which is a list of 'TCPSegment_t' */
+            if( xAllowed == pdFALSE )
+            {
+                FreeRTOS_debug_printf( ( "xTCPWindow%cxNew: Error: segment quota reached\n", ( xIsForRx != 0 ) ? 'R' : 'T' ) );
+                pxSegment = NULL;
+            }
+            else if( listLIST_IS_EMPTY( &xSegmentList ) != pdFALSE )
+            {
+                /* If the TCP-stack runs out of segments, you might consider
+                 * increasing 'ipconfigTCP_WIN_SEG_COUNT'. */
+                FreeRTOS_debug_printf( ( "xTCPWindow%cxNew: Error: all segments occupied\n", ( xIsForRx != 0 ) ? 'R' : 'T' ) );
+                pxSegment = NULL;
+
+                #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
                 {
-                    pxFound = xTCPWindowRxConfirm( pxWindow, ulSequenceNumber, ulLength );
+                    xTCPSegmentStats.ulExhausted++;
+                }
+                #endif
+            }
+            else
+            {
+                /* Pop the item at the head of the list.  Semaphore protection is
+                * not required as only the IP task will call these functions.  */
+                pxItem = ( ListItem_t * ) listGET_HEAD_ENTRY( &xSegmentList );
+                pxSegment = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxItem ) );
 
-                    if( pxFound != NULL )
+                configASSERT( pxItem != NULL );
+                configASSERT( pxSegment != NULL );
+
+                /* Remove the item from xSegmentList. */
+                ( void ) uxListRemove( pxItem );
+
+                /* Add it to either the connections' Rx or Tx queue. */
+                if( xIsForRx != 0 )
+                {
+                    vListInsertFifo( &pxWindow->xRxSegments, pxItem );
+                }
+                else
+                {
+                    vListInsertFifo( &pxWindow->xTxSegments, pxItem );
+                }
+
+                /* And set the segment's timer to zero */
+                vTCPTimerSet( &pxSegment->xTransmitTimer );
+
+                pxSegment->u.ulFlags = 0;
+                pxSegment->u.bits.bIsForRx = ( xIsForRx != 0 ) ? 1U : 0U;
+                pxSegment->lMaxLength = lCount;
+                pxSegment->lDataLength = lCount;
+                pxSegment->ulSequenceNumber = ulSequenceNumber;
+
+                #if ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+                {
+                    if( xIsForRx != 0 )
                     {
-                        /* Remove it because it will be passed to user directly. */
-                        vTCPWindowFree( pxFound );
+                        prvTCPWindowIndexInsert( &( pxWindow->pxRxSegmentIndex ), pxSegment );
                     }
-                } while( pxFound != NULL );
+                    else
+                    {
+                        prvTCPWindowIndexInsert( &( pxWindow->pxTxSegmentIndex ), pxSegment );
+                    }
+                }
+                #endif
 
-                /*  Check for following segments that are already in the
-                 * queue and increment ulCurrentSequenceNumber. */
-                for( ; ; )
+                #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
                 {
-                    pxFound = xTCPWindowRxFind( pxWindow, ulCurrentSequenceNumber );
-
-                    if( pxFound == NULL )
+                    /* The first descriptors of a window come out of its reservation. */
+                    if( pxWindow->uxSegmentsReserved > 0U )
                     {
-                        break;
+                        pxWindow->uxSegmentsReserved--;
+                        xTCPSegmentStats.uxReserved--;
                     }
 
-                    ulCurrentSequenceNumber += ( uint32_t ) pxFound->lDataLength;
+                    pxWindow->uxSegmentCount++;
+                    xTCPSegmentStats.uxInUse++;
 
-                    /* As all packet below this one have been passed to the
-                     * user it can be discarded. */
-                    vTCPWindowFree( pxFound );
+                    if( xTCPSegmentStats.uxHighWater < xTCPSegmentStats.uxInUse )
+                    {
+                        xTCPSegmentStats.uxHighWater = xTCPSegmentStats.uxInUse;
+                    }
                 }
+                #endif
 
-                if( ulSavedSequenceNumber != ulCurrentSequenceNumber )
+                #if ( ipconfigHAS_DEBUG_PRINTF != 0 )
                 {
-                    /*  After the current data-package, there is more data
-                     * to be popped. */
-                    pxWindow->ulUserDataLength = ulCurrentSequenceNumber - ulSavedSequenceNumber;
+                    static UBaseType_t xLowestLength = ipconfigTCP_WIN_SEG_COUNT;
+                    UBaseType_t xLength = listCURRENT_LIST_LENGTH( &xSegmentList );
 
-                    if( xTCPWindowLoggingLevel >= 1 )
+                    if( xLowestLength > xLength )
                     {
-                        FreeRTOS_debug_printf( ( "lTCPWindowRxCheck[%u,%u]: retran %u (Found %u bytes at %u cnt %d)\n",
-                                                 pxWindow->usPeerPortNumber,
-                                                 pxWindow->usOurPortNumber,
-                                                 ( unsigned ) ( ulSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
-                                                 ( unsigned ) pxWindow->ulUserDataLength,
-                                                 ( unsigned ) ( ulSavedSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
-                                                 ( int ) listCURRENT_LIST_LENGTH( &pxWindow->xRxSegments ) ) );
+                        xLowestLength = xLength;
                     }
                 }
+                #endif /* ipconfigHAS_DEBUG_PRINTF */
             }
 
-            pxWindow->rx.ulCurrentSequenceNumber = ulCurrentSequenceNumber;
+            return pxSegment;
         }
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
@@ -1069,109 +1316,103 @@
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
- * @brief Data has been received with a non-expected sequence number.
- *        This function will check if the RX data can be accepted.
- * @param[in] pxWindow The TCP sliding window data of the socket.
- * @param[in] ulSequenceNumber The sequence number at which the data should be placed.
- * @param[in] ulLength The number of bytes that can be added.
- * @return Return -1 if the data must be refused, otherwise it returns the
- *         offset ( from the head ) at which the data can be placed.
+ * @brief See if the peer has more packets for this node, before allowing to shut down the connection.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ *
+ * @return pdTRUE if the connection can be closed. Else, pdFALSE.
  */
-        static int32_t prvTCPWindowRx_UnexpectedRX( TCPWindow_t * pxWindow,
-                                                    uint32_t ulSequenceNumber,
-                                                    uint32_t ulLength )
+        BaseType_t xTCPWindowRxEmpty( const TCPWindow_t * pxWindow )
         {
-            int32_t lReturn = -1;
-            uint32_t ulLast = ulSequenceNumber + ulLength;
-            uint32_t ulCurrentSequenceNumber = pxWindow->rx.ulCurrentSequenceNumber;
-            const TCPSegment_t * pxFound;
-
-            /* See if there is more data in a contiguous block to make the
-             * SACK describe a longer range of data. */
+            BaseType_t xReturn;
 
-            /* SACK's may also be delayed for a short period
-             * This is useful because subsequent packets will be SACK'd with
-             * single one message
-             */
-            for( ; ; )
+            /* When the peer has a close request (FIN flag), the driver will check
+             * if there are missing packets in the Rx-queue.  It will accept the
+             * closure of the connection if both conditions are true:
+             * - the Rx-queue is empty
+             * - the highest Rx sequence number has been ACK'ed */
+            if( listLIST_IS_EMPTY( ( &pxWindow->xRxSegments ) ) == pdFALSE )
             {
-                pxFound = xTCPWindowRxFind( pxWindow, ulLast );
-
-                if( pxFound == NULL )
-                {
-                    break;
-                }
-
-                ulLast += ( uint32_t ) pxFound->lDataLength;
+                /* Rx data has been stored while earlier packets were missing. */
+                xReturn = pdFALSE;
             }
-
-            if( xTCPWindowLoggingLevel >= 1 )
+            else if( xSequenceGreaterThanOrEqual( pxWindow->rx.ulCurrentSequenceNumber + 1U, pxWindow->rx.ulHighestSequenceNumber ) != pdFALSE )
             {
-                FreeRTOS_debug_printf( ( "lTCPWindowRxCheck[%d,%d]: seqnr %u exp %u (dist %d) SACK to %u\n",
-                                         ( int ) pxWindow->usPeerPortNumber,
-                                         ( int ) pxWindow->usOurPortNumber,
-                                         ( unsigned ) ( ulSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
-                                         ( unsigned ) ( ulCurrentSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
-                                         ( int ) ( ulSequenceNumber - ulCurrentSequenceNumber ), /* want this signed */
-                                         ( unsigned ) ( ulLast - pxWindow->rx.ulFirstSequenceNumber ) ) );
+                /* No Rx packets are being stored and the highest sequence number
+                 * that has been received has been ACKed. */
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                FreeRTOS_debug_printf( ( "xTCPWindowRxEmpty: cur %u highest %u (empty)\n",
+                                         ( unsigned ) ( pxWindow->rx.ulCurrentSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
+                                         ( unsigned ) ( pxWindow->rx.ulHighestSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ) ) );
+                xReturn = pdFALSE;
             }
 
-            /* Now prepare the SACK message.
-             * Code OPTION_CODE_SINGLE_SACK already in network byte order. */
-            pxWindow->ulOptionsData[ 0 ] = OPTION_CODE_SINGLE_SACK;
-
-            /* First sequence number that we received. */
-            pxWindow->ulOptionsData[ 1 ] = FreeRTOS_htonl( ulSequenceNumber );
-
-            /* Last + 1 */
-            pxWindow->ulOptionsData[ 2 ] = FreeRTOS_htonl( ulLast );
+            return xReturn;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
 
-            /* Which make 12 (3*4) option bytes. */
-            pxWindow->ucOptionLength = ( uint8_t ) ( 3U * sizeof( pxWindow->ulOptionsData[ 0 ] ) );
+    #if ( ipconfigUSE_TCP_WIN == 1 )
 
-            pxFound = xTCPWindowRxFind( pxWindow, ulSequenceNumber );
+/**
+ * @brief Remove the head item of a list (generic function).
+ *
+ * @param[in] pxList The list of segment descriptors.
+ *
+ * @return The address of the segment descriptor, or NULL when not found.
+ */
+        static TCPSegment_t * xTCPWindowGetHead( const List_t * pxList )
+        {
+            TCPSegment_t * pxSegment;
+            ListItem_t * pxItem;
 
-            if( pxFound != NULL )
+            /* Detaches and returns the head of a queue. */
+            if( listLIST_IS_EMPTY( pxList ) != pdFALSE )
             {
-                /* This out-of-sequence packet has been received for a
-                 * second time.  It is already stored but do send a SACK
-                 * again. */
-                /* A negative value will be returned to indicate than error. */
+                pxSegment = NULL;
             }
             else
             {
-                pxFound = xTCPWindowRxNew( pxWindow, ulSequenceNumber, ( int32_t ) ulLength );
+                pxItem = ( ListItem_t * ) listGET_HEAD_ENTRY( pxList );
+                pxSegment = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxItem ) );
 
-                if( pxFound == NULL )
-                {
-                    /* Can not send a SACK, because the segment cannot be
-                     * stored. */
-                    pxWindow->ucOptionLength = 0U;
+                ( void ) uxListRemove( pxItem );
+            }
 
-                    /* Needs to be stored but there is no segment
-                     * available. A negative value will be returned. */
-                }
-                else
-                {
-                    uint32_t ulIntermediateResult;
+            return pxSegment;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
 
-                    if( xTCPWindowLoggingLevel != 0 )
-                    {
-                        FreeRTOS_debug_printf( ( "lTCPWindowRxCheck[%u,%u]: seqnr %u (cnt %u)\n",
-                                                 pxWindow->usPeerPortNumber,
-                                                 pxWindow->usOurPortNumber,
-                                                 ( unsigned ) ( ulSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
-                                                 ( unsigned ) listCURRENT_LIST_LENGTH( &pxWindow->xRxSegments ) ) );
-                    }
+    #if ( ipconfigUSE_TCP_WIN == 1 )
 
-                    /* Return a positive value.  The packet may be accepted
-                    * and stored but an earlier packet is still missing. */
-                    ulIntermediateResult = ulSequenceNumber - ulCurrentSequenceNumber;
-                    lReturn = ( int32_t ) ulIntermediateResult;
-                }
+/**
+ * @brief Return the head item of a list (generic function).
+ *
+ * @param[in] pxList The list of segment descriptors.
+ *
+ * @return The address of the segment descriptor, or NULL when the list is empty.
+ */
+        static TCPSegment_t * xTCPWindowPeekHead( const List_t * pxList )
+        {
+            const ListItem_t * pxItem;
+            TCPSegment_t * pxReturn;
+
+            /* Returns the head of a queue but it won't be detached. */
+            if( listLIST_IS_EMPTY( pxList ) != pdFALSE )
+            {
+                pxReturn = NULL;
+            }
+            else
+            {
+                pxItem = ( ListItem_t * ) listGET_HEAD_ENTRY( pxList );
+                pxReturn = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxItem ) );
             }
 
-            return lReturn;
+            return pxReturn;
         }
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
@@ -1179,762 +1420,2242 @@
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
- * @brief Check what to do with a new incoming packet: store or ignore.
- *
- * @param[in] pxWindow The descriptor of the TCP sliding windows.
- * @param[in] ulSequenceNumber The sequence number of the packet received.
- * @param[in] ulLength The number of bytes received.
- * @param[in] ulSpace The available space in the RX stream buffer.
- * @param[out] pulSkipCount the number of bytes to skip in the receive buffer.
+ * @brief Release a segment object, return it to the list of available segment holders.
  *
- * @return 0 or positive value indicating the offset at which the packet is to
- *         be stored, -1 if the packet is to be ignored.
+ * @param[in] pxSegment The segment descriptor that must be freed.
  */
-        int32_t lTCPWindowRxCheck( TCPWindow_t * pxWindow,
-                                   uint32_t ulSequenceNumber,
-                                   uint32_t ulLength,
-                                   uint32_t ulSpace,
-                                   uint32_t * pulSkipCount )
+        static void vTCPWindowFree( TCPSegment_t * pxSegment )
         {
-            uint32_t ulCurrentSequenceNumber;
-            uint32_t ulIntermediateResult;
-            int32_t lReturn = -1;
-            int32_t lStartDistance;
-            int32_t lLastDistance;
-            uint32_t ulLast;
-            uint32_t ulRxSequenceNumber = ulSequenceNumber;
-            uint32_t ulRxLength = ulLength;
-
-            /* If lTCPWindowRxCheck( ) returns == 0, the packet will be passed
-             * directly to user (segment is expected).  If it returns a positive
-             * number, an earlier packet is missing, but this packet may be stored.
-             * If negative, the packet has already been stored, or it is out-of-order,
-             * or there is not enough space.
+            /*  Free entry pxSegment because it's not used any more.  The ownership
+             * will be passed back to the segment pool.
              *
-             * As a side-effect, pxWindow->ulUserDataLength will get set to non-zero,
-             * if more Rx data may be passed to the user after this packet. */
+             * Unlink it from one of the queues, if any. */
+            if( listLIST_ITEM_CONTAINER( &( pxSegment->xQueueItem ) ) != NULL )
+            {
+                ( void ) uxListRemove( &( pxSegment->xQueueItem ) );
+            }
 
-            /* Only in an exceptional case, where a packet starts before
-             * ulCurrentSequenceNumber, and ends after it, the skip-count
-             * will be set. See below. */
+            pxSegment->ulSequenceNumber = 0U;
+            pxSegment->lDataLength = 0;
+            pxSegment->u.ulFlags = 0U;
 
-            *( pulSkipCount ) = 0U;
+            /* Take it out of xRxSegments/xTxSegments */
+            if( listLIST_ITEM_CONTAINER( &( pxSegment->xSegmentItem ) ) != NULL )
+            {
+                ( void ) uxListRemove( &( pxSegment->xSegmentItem ) );
+            }
 
-            ulCurrentSequenceNumber = pxWindow->rx.ulCurrentSequenceNumber;
+            /* Return it to xSegmentList */
+            vListInsertFifo( &xSegmentList, &( pxSegment->xSegmentItem ) );
 
-            ulLast = ulRxSequenceNumber + ulRxLength;
-            ulIntermediateResult = ulLast - ulCurrentSequenceNumber;
-            /* The cast from unsigned long to signed long is on purpose. */
-            lLastDistance = ( int32_t ) ulIntermediateResult;
+            #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
+            {
+                xTCPSegmentStats.uxInUse--;
+            }
+            #endif
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
 
-            ulIntermediateResult = ulRxSequenceNumber - ulCurrentSequenceNumber;
-            lStartDistance = ( int32_t ) ulIntermediateResult;
+    #if ( ipconfigUSE_TCP_WIN == 1 )
 
-            if( ( lStartDistance < 0 ) && ( lLastDistance > 0 ) )
+/**
+ * @brief Return a segment of a living window to the pool: take it out of the
+ *        segment index and give back the reservation of the window.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] pxSegment The segment descriptor that must be freed.
+ */
+        static void prvTCPWindowRelease( TCPWindow_t * pxWindow,
+                                         TCPSegment_t * pxSegment )
+        {
+            #if ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
             {
-                FreeRTOS_debug_printf( ( "lTCPWindowRxCheck: Received +%u bytes for %u, only using %d\n",
-                                         ( unsigned ) ulRxLength,
-                                         ( unsigned ) ( ulRxSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
-                                         ( int ) lLastDistance ) );
-                /* Increase the sequence number, decrease the length. */
-                ulRxSequenceNumber += ( uint32_t ) ( -lStartDistance );
-                ulRxLength += ( uint32_t ) lStartDistance;
+                if( pxSegment->u.bits.bIsForRx != pdFALSE_UNSIGNED )
+                {
+                    prvTCPWindowIndexRemove( &( pxWindow->pxRxSegmentIndex ), pxSegment );
+                }
+                else
+                {
+                    prvTCPWindowIndexRemove( &( pxWindow->pxTxSegmentIndex ), pxSegment );
+                }
+            }
+            #endif
 
-                /* Tell the caller that the first 'pulSkipCount' bytes don't
-                 * need to be stored. */
-                *( pulSkipCount ) = ( uint32_t ) ( -lStartDistance );
+            #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
+            {
+                pxWindow->uxSegmentCount--;
+
+                /* Descriptors below the reservation become reserved again. */
+                if( pxWindow->uxSegmentCount < ( UBaseType_t ) ipconfigTCP_WIN_SEG_RESERVED )
+                {
+                    pxWindow->uxSegmentsReserved++;
+                    xTCPSegmentStats.uxReserved++;
+                }
             }
+            #endif
 
-            /* For Selective Ack (SACK), used when out-of-sequence data come in. */
-            pxWindow->ucOptionLength = 0U;
+            #if ( ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 0 ) && ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 0 ) )
+            {
+                /* Nothing to administer for the window. */
+                ( void ) pxWindow;
+            }
+            #endif
 
-            /* Non-zero if TCP-windows contains data which must be popped. */
-            pxWindow->ulUserDataLength = 0U;
+            vTCPWindowFree( pxSegment );
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
 
-            if( ulCurrentSequenceNumber == ulRxSequenceNumber )
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Return all segment descriptor to the poll of descriptors, before deleting a socket
+ *        or before the window is used for a new connection.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ */
+        void vTCPWindowDestroy( TCPWindow_t * pxWindow )
+        {
+            const List_t * pxSegments;
+            BaseType_t xRound;
+            TCPSegment_t * pxSegment;
+
+            /*  Destroy a window.  A TCP window doesn't serve any more.  Return all
+             * owned segments to the pool.  In order to save code, it will make 2 rounds,
+             * one to remove the segments from xRxSegments, and a second round to clear
+             * xTxSegments.  The segment indexes are not updated: they will be reset
+             * by xTCPWindowCreate() and every segment by prvTCPWindowIndexInsert(). */
+            #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
             {
-                /* This is the packet with the lowest sequence number we're waiting
-                 * for.  It can be passed directly to the rx stream. */
-                if( ulRxLength > ulSpace )
+                /* The reservation of this window is no longer needed. */
+                xTCPSegmentStats.uxReserved -= pxWindow->uxSegmentsReserved;
+            }
+            #endif
+
+
+            for( xRound = 0; xRound < 2; xRound++ )
+            {
+                if( xRound != 0 )
                 {
-                    FreeRTOS_debug_printf( ( "lTCPWindowRxCheck: Refuse %u bytes, due to lack of space (%u)\n", ( unsigned ) ulRxLength, ( unsigned ) ulSpace ) );
+                    pxSegments = &( pxWindow->xRxSegments );
                 }
                 else
                 {
-                    /* Packet was expected, may be passed directly to the socket
-                     * buffer or application.  Store the packet at offset 0. */
-                    prvTCPWindowRx_ExpectedRX( pxWindow, ulRxLength );
-                    lReturn = 0;
+                    pxSegments = &( pxWindow->xTxSegments );
+                }
+
+                if( listLIST_IS_INITIALISED( pxSegments ) )
+                {
+                    while( listCURRENT_LIST_LENGTH( pxSegments ) > 0U )
+                    {
+                        pxSegment = ( ( TCPSegment_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSegments ) );
+                        vTCPWindowFree( pxSegment );
+                    }
                 }
             }
-            else if( ulCurrentSequenceNumber == ( ulRxSequenceNumber + 1U ) )
+
+            #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
             {
-                /* Looks like a TCP keep-alive message.  Do not accept/store Rx data
-                 * ulUserDataLength = 0. Not packet out-of-sync.  Just reply to it. */
+                /* The window may be created again, e.g. by FreeRTOS_listen()
+                 * or a new FreeRTOS_connect(), it owns nothing now. */
+                pxWindow->uxSegmentCount = 0U;
+                pxWindow->uxSegmentsReserved = 0U;
             }
-            else
-            {
-                /* The packet is not the one expected.  See if it falls within the Rx
-                 * window so it can be stored. */
+            #endif
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
 
-                /*  An "out-of-sequence" segment was received, must have missed one.
-                 * Prepare a SACK (Selective ACK). */
+/**
+ * @brief Create a window for TCP.
+ *
+ * @param[in] pxWindow The window to be created.
+ * @param[in] ulRxWindowLength The length of the receive window.
+ * @param[in] ulTxWindowLength The length of the transmit window.
+ * @param[in] ulAckNumber The first ACK number.
+ * @param[in] ulSequenceNumber The first sequence number.
+ * @param[in] ulMSS The MSS of the connection.
+ */
+    BaseType_t xTCPWindowCreate( TCPWindow_t * pxWindow,
+                                 uint32_t ulRxWindowLength,
+                                 uint32_t ulTxWindowLength,
+                                 uint32_t ulAckNumber,
+                                 uint32_t ulSequenceNumber,
+                                 uint32_t ulMSS )
+    {
+        BaseType_t xReturn = pdPASS;
 
-                if( lLastDistance <= 0 )
+        /* Create and initialize a window. */
+
+        #if ( ipconfigUSE_TCP_WIN == 1 )
+        {
+            #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
+            {
+                if( pxTCPSegmentChunks[ 0 ] == NULL )
                 {
-                    /* An earlier packet has been received, must be a retransmission of a
-                     * packet that has been accepted already.  No need to send out a
-                     * Selective ACK (SACK). */
+                    xReturn = prvTCPWindowGrowArena();
                 }
-                else if( lLastDistance > ( int32_t ) ulSpace )
+
+                /* A socket that connects again still owns the descriptors and
+                 * the reservation of its previous connection. */
+                if( ( pxWindow->uxSegmentsReserved != 0U ) || ( pxWindow->uxSegmentCount != 0U ) )
                 {
-                    /* The new segment is ahead of rx.ulCurrentSequenceNumber.  The
-                     * sequence number of this packet is too far ahead, ignore it. */
-                    FreeRTOS_debug_printf( ( "lTCPWindowRxCheck: Refuse %d+%u bytes, due to lack of space (%u)\n",
-                                             ( int ) lLastDistance,
-                                             ( unsigned ) ulRxLength,
-                                             ( unsigned ) ulSpace ) );
+                    vTCPWindowDestroy( pxWindow );
                 }
-                else
+
+                /* Every window starts with a reservation of descriptors. */
+                pxWindow->uxSegmentsReserved = ( UBaseType_t ) ipconfigTCP_WIN_SEG_RESERVED;
+                xTCPSegmentStats.uxReserved += pxWindow->uxSegmentsReserved;
+            }
+            #else
+            {
+                if( xTCPSegments == NULL )
                 {
-                    lReturn = prvTCPWindowRx_UnexpectedRX( pxWindow, ulRxSequenceNumber, ulRxLength );
+                    xReturn = prvCreateSectors();
                 }
             }
+            #endif
+
+            vListInitialise( &( pxWindow->xTxSegments ) );
+            vListInitialise( &( pxWindow->xRxSegments ) );
+
+            vListInitialise( &( pxWindow->xPriorityQueue ) ); /* Priority queue: segments which must be sent immediately */
+            vListInitialise( &( pxWindow->xTxQueue ) );       /* Transmit queue: segments queued for transmission */
+            vListInitialise( &( pxWindow->xWaitQueue ) );     /* Waiting queue:  outstanding segments */
+
+            #if ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+            {
+                pxWindow->pxTxSegmentIndex = NULL;
+                pxWindow->pxRxSegmentIndex = NULL;
+            }
+            #endif
+        }
+        #endif /* ipconfigUSE_TCP_WIN == 1 */
+
+        if( xTCPWindowLoggingLevel != 0 )
+        {
+            FreeRTOS_debug_printf( ( "xTCPWindowCreate: for WinLen = Rx/Tx: %u/%u\n",
+                                     ( unsigned ) ulRxWindowLength, ( unsigned ) ulTxWindowLength ) );
+        }
+
+        pxWindow->xSize.ulRxWindowLength = ulRxWindowLength;
+        pxWindow->xSize.ulTxWindowLength = ulTxWindowLength;
+
+        vTCPWindowInit( pxWindow, ulAckNumber, ulSequenceNumber, ulMSS );
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Initialise a TCP window.
+ *
+ * @param[in] pxWindow The window to be initialised.
+ * @param[in] ulAckNumber The number of the first ACK.
+ * @param[in] ulSequenceNumber The first sequence number.
+ * @param[in] ulMSS The MSS of the connection.
+ */
+    void vTCPWindowInit( TCPWindow_t * pxWindow,
+                         uint32_t ulAckNumber,
+                         uint32_t ulSequenceNumber,
+                         uint32_t ulMSS )
+    {
+        const int32_t l500ms = 500;
+
+        pxWindow->u.ulFlags = 0U;
+        pxWindow->u.bits.bHasInit = pdTRUE_UNSIGNED;
+
+        if( ulMSS != 0U )
+        {
+            if( pxWindow->usMSSInit != 0U )
+            {
+                pxWindow->usMSSInit = ( uint16_t ) ulMSS;
+            }
+
+            if( ( ulMSS < ( uint32_t ) pxWindow->usMSS ) || ( pxWindow->usMSS == 0U ) )
+            {
+                pxWindow->xSize.ulRxWindowLength = ( pxWindow->xSize.ulRxWindowLength / ulMSS ) * ulMSS;
+                pxWindow->usMSS = ( uint16_t ) ulMSS;
+            }
+        }
+
+        #if ( ipconfigUSE_TCP_WIN == 0 )
+        {
+            pxWindow->xTxSegment.lMaxLength = ( int32_t ) pxWindow->usMSS;
+        }
+        #endif /* ipconfigUSE_TCP_WIN == 1 */
+
+        /*Start with a timeout of 2 * 500 ms (1 sec). */
+        pxWindow->lSRTT = l500ms;
+
+        /* Just for logging, to print relative sequence numbers. */
+        pxWindow->rx.ulFirstSequenceNumber = ulAckNumber;
+
+        /* The segment asked for in the next transmission. */
+        pxWindow->rx.ulCurrentSequenceNumber = ulAckNumber;
+
+        /* The right-hand side of the receive window. */
+        pxWindow->rx.ulHighestSequenceNumber = ulAckNumber;
+
+        pxWindow->tx.ulFirstSequenceNumber = ulSequenceNumber;
+
+        /* The segment asked for in next transmission. */
+        pxWindow->tx.ulCurrentSequenceNumber = ulSequenceNumber;
+
+        /* The sequence number given to the next outgoing byte to be added is
+         * maintained by lTCPWindowTxAdd(). */
+        pxWindow->ulNextTxSequenceNumber = ulSequenceNumber;
+
+        /* The right-hand side of the transmit window. */
+        pxWindow->tx.ulHighestSequenceNumber = ulSequenceNumber;
+        pxWindow->ulOurSequenceNumber = ulSequenceNumber;
+
+        #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+        {
+            prvTCPWindowCongestionInit( pxWindow );
+        }
+        #endif
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Free the space occupied by the pool of segment descriptors, normally never used
+ */
+        void vTCPSegmentCleanup( void )
+        {
+            /* Free and clear the TCP segments pointer. This function should only be called
+             * once FreeRTOS+TCP will no longer be used. No thread-safety is provided for this
+             * function. */
+            #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
+            {
+                size_t uxChunk;
+
+                for( uxChunk = 0U; uxChunk < ( size_t ) winSEGMENT_CHUNK_MAX; uxChunk++ )
+                {
+                    if( pxTCPSegmentChunks[ uxChunk ] != NULL )
+                    {
+                        vPortFreeLarge( pxTCPSegmentChunks[ uxChunk ] );
+                        pxTCPSegmentChunks[ uxChunk ] = NULL;
+                    }
+                }
+
+                ( void ) memset( &( xTCPSegmentStats ), 0, sizeof( xTCPSegmentStats ) );
+            }
+            #else
+            {
+                if( xTCPSegments != NULL )
+                {
+                    vPortFreeLarge( xTCPSegments );
+                    xTCPSegments = NULL;
+                }
+            }
+            #endif
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
+
+/**
+ * @brief Report the use of the segment descriptors.
+ *
+ * @param[out] pxStats Will be filled with a copy of the statistics.
+ */
+        void vTCPSegmentGetStats( TCPSegmentStats_t * pxStats )
+        {
+            ( void ) memcpy( pxStats, &( xTCPSegmentStats ), sizeof( *pxStats ) );
+            pxStats->uxCapacity = ( UBaseType_t ) ipconfigTCP_WIN_SEG_COUNT;
+        }
+    #endif /* ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 */
+/*-----------------------------------------------------------*/
+
+/*=============================================================================
+ *
+ *                ######        #    #
+ *                 #    #       #    #
+ *                 #    #       #    #
+ *                 #    #        ####
+ *                 ######         ##
+ *                 #  ##         ####
+ *                 #   #        #    #
+ *                 #    #       #    #
+ *                ###  ##       #    #
+ * Rx functions
+ *
+ *=============================================================================*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief A expected segment has been received, see if there is overlap with earlier segments.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulSequenceNumber The sequence number of the segment that was received.
+ * @param[in] ulLength The number of bytes that were received.
+ *
+ * @return The first segment descriptor involved, or NULL when no matching descriptor was found.
+ */
+        static TCPSegment_t * xTCPWindowRxConfirm( const TCPWindow_t * pxWindow,
+                                                   uint32_t ulSequenceNumber,
+                                                   uint32_t ulLength )
+        {
+            TCPSegment_t * pxBest = NULL;
+            uint32_t ulNextSequenceNumber = ulSequenceNumber + ulLength;
+
+            #if ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 0 )
+                const ListItem_t * pxIterator;
+
+                /* MISRA Ref 11.3.1 [Misaligned access] */
+/* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                /* coverity[misra_c_2012_rule_11_3_violation] */
+                const ListItem_t * pxEnd = ( ( const ListItem_t * ) &( pxWindow->xRxSegments.xListEnd ) );
+                TCPSegment_t * pxSegment;
+            #endif
+
+            /* A segment has been received with sequence number 'ulSequenceNumber',
+             * where 'ulCurrentSequenceNumber == ulSequenceNumber', which means that
+             * exactly this segment was expected.  xTCPWindowRxConfirm() will check if
+             * there is already another segment with a sequence number between (ulSequenceNumber)
+             * and (ulSequenceNumber+ulLength).  Normally none will be found, because
+             * the next RX segment should have a sequence number equal to
+             * '(ulSequenceNumber+ulLength)'. */
+
+            #if ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+            {
+                /* The index returns the segment with the lowest sequence number
+                 * which is not below 'ulSequenceNumber'. */
+                pxBest = prvTCPWindowIndexLowerBound( pxWindow->pxRxSegmentIndex, ulSequenceNumber );
+
+                if( ( pxBest != NULL ) && ( xSequenceLessThan( pxBest->ulSequenceNumber, ulNextSequenceNumber ) == 0 ) )
+                {
+                    pxBest = NULL;
+                }
+            }
+            #else
+            {
+                /* Iterate through all RX segments that are stored: */
+                for( pxIterator = listGET_NEXT( pxEnd );
+                     pxIterator != pxEnd;
+                     pxIterator = listGET_NEXT( pxIterator ) )
+                {
+                    pxSegment = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+                    /* And see if there is a segment for which:
+                     * 'ulSequenceNumber' <= 'pxSegment->ulSequenceNumber' < 'ulNextSequenceNumber'
+                     * If there are more matching segments, the one with the lowest sequence number
+                     * shall be taken */
+                    if( ( xSequenceGreaterThanOrEqual( pxSegment->ulSequenceNumber, ulSequenceNumber ) != 0 ) &&
+                        ( xSequenceLessThan( pxSegment->ulSequenceNumber, ulNextSequenceNumber ) != 0 ) )
+                    {
+                        if( ( pxBest == NULL ) || ( xSequenceLessThan( pxSegment->ulSequenceNumber, pxBest->ulSequenceNumber ) != 0 ) )
+                        {
+                            pxBest = pxSegment;
+                        }
+                    }
+                }
+            }
+            #endif /* ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 */
+
+            if( ( pxBest != NULL ) &&
+                ( ( pxBest->ulSequenceNumber != ulSequenceNumber ) || ( pxBest->lDataLength != ( int32_t ) ulLength ) ) )
+            {
+                FreeRTOS_debug_printf( ( "xTCPWindowRxConfirm[%u]: search %u (+%u=%u) found %u (+%d=%u)\n",
+                                         pxWindow->usPeerPortNumber,
+                                         ( unsigned ) ( ulSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
+                                         ( unsigned ) ulLength,
+                                         ( unsigned ) ( ulSequenceNumber + ulLength - pxWindow->rx.ulFirstSequenceNumber ),
+                                         ( unsigned ) ( pxBest->ulSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
+                                         ( int ) pxBest->lDataLength,
+                                         ( unsigned ) ( pxBest->ulSequenceNumber + ( ( uint32_t ) pxBest->lDataLength ) - pxWindow->rx.ulFirstSequenceNumber ) ) );
+            }
+
+            return pxBest;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Data has been received with the correct ( expected  ) sequence number.
+ *        It can be added to the RX stream buffer.
+ * @param[in] pxWindow The TCP sliding window data of the socket.
+ * @param[in] ulLength The number of bytes that can be added.
+ */
+        static void prvTCPWindowRx_ExpectedRX( TCPWindow_t * pxWindow,
+                                               uint32_t ulLength )
+        {
+            uint32_t ulSequenceNumber = pxWindow->rx.ulCurrentSequenceNumber;
+            uint32_t ulCurrentSequenceNumber = ulSequenceNumber + ulLength;
+
+            if( listCURRENT_LIST_LENGTH( &( pxWindow->xRxSegments ) ) != 0U )
+            {
+                uint32_t ulSavedSequenceNumber = ulCurrentSequenceNumber;
+                TCPSegment_t * pxFound;
+
+                /* Clean up all sequence received between ulSequenceNumber and ulSequenceNumber + ulLength since they are duplicated.
+                 * If the server is forced to retransmit packets several time in a row it might send a batch of concatenated packet for speed.
+                 * So we cannot rely on the packets between ulSequenceNumber and ulSequenceNumber + ulLength to be sequential and it is better to just
+                 * clean them out. */
+                do
+                {
+                    pxFound = xTCPWindowRxConfirm( pxWindow, ulSequenceNumber, ulLength );
+
+                    if( pxFound != NULL )
+                    {
+                        /* Remove it because it will be passed to user directly. */
+                        prvTCPWindowRelease( pxWindow, pxFound );
+                    }
+                } while( pxFound != NULL );
+
+                /*  Check for following segments that are already in the
+                 * queue and increment ulCurrentSequenceNumber. */
+                for( ; ; )
+                {
+                    pxFound = xTCPWindowRxFind( pxWindow, ulCurrentSequenceNumber );
+
+                    if( pxFound == NULL )
+                    {
+                        break;
+                    }
+
+                    ulCurrentSequenceNumber += ( uint32_t ) pxFound->lDataLength;
+
+                    /* As all packet below this one have been passed to the
+                     * user it can be discarded. */
+                    prvTCPWindowRelease( pxWindow, pxFound );
+                }
+
+                if( ulSavedSequenceNumber != ulCurrentSequenceNumber )
+                {
+                    /*  After the current data-package, there is more data
+                     * to be popped. */
+                    pxWindow->ulUserDataLength = ulCurrentSequenceNumber - ulSavedSequenceNumber;
+
+                    if( xTCPWindowLoggingLevel >= 1 )
+                    {
+                        FreeRTOS_debug_printf( ( "lTCPWindowRxCheck[%u,%u]: retran %u (Found %u bytes at %u cnt %d)\n",
+                                                 pxWindow->usPeerPortNumber,
+                                                 pxWindow->usOurPortNumber,
+                                                 ( unsigned ) ( ulSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
+                                                 ( unsigned ) pxWindow->ulUserDataLength,
+                                                 ( unsigned ) ( ulSavedSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
+                                                 ( int ) listCURRENT_LIST_LENGTH( &pxWindow->xRxSegments ) ) );
+                    }
+                }
+            }
+
+            pxWindow->rx.ulCurrentSequenceNumber = ulCurrentSequenceNumber;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Data has been received with a non-expected sequence number.
+ *        This function will check if the RX data can be accepted.
+ * @param[in] pxWindow The TCP sliding window data of the socket.
+ * @param[in] ulSequenceNumber The sequence number at which the data should be placed.
+ * @param[in] ulLength The number of bytes that can be added.
+ * @return Return -1 if the data must be refused, otherwise it returns the
+ *         offset ( from the head ) at which the data can be placed.
+ */
+        static int32_t prvTCPWindowRx_UnexpectedRX( TCPWindow_t * pxWindow,
+                                                    uint32_t ulSequenceNumber,
+                                                    uint32_t ulLength )
+        {
+            int32_t lReturn = -1;
+            uint32_t ulLast = ulSequenceNumber + ulLength;
+            uint32_t ulCurrentSequenceNumber = pxWindow->rx.ulCurrentSequenceNumber;
+            const TCPSegment_t * pxFound;
+
+            /* See if there is more data in a contiguous block to make the
+             * SACK describe a longer range of data. */
+
+            /* SACK's may also be delayed for a short period
+             * This is useful because subsequent packets will be SACK'd with
+             * single one message
+             */
+            for( ; ; )
+            {
+                pxFound = xTCPWindowRxFind( pxWindow, ulLast );
+
+                if( pxFound == NULL )
+                {
+                    break;
+                }
+
+                ulLast += ( uint32_t ) pxFound->lDataLength;
+            }
+
+            if( xTCPWindowLoggingLevel >= 1 )
+            {
+                FreeRTOS_debug_printf( ( "lTCPWindowRxCheck[%d,%d]: seqnr %u exp %u (dist %d) SACK to %u\n",
+                                         ( int ) pxWindow->usPeerPortNumber,
+                                         ( int ) pxWindow->usOurPortNumber,
+                                         ( unsigned ) ( ulSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
+                                         ( unsigned ) ( ulCurrentSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
+                                         ( int ) ( ulSequenceNumber - ulCurrentSequenceNumber ), /* want this signed */
+                                         ( unsigned ) ( ulLast - pxWindow->rx.ulFirstSequenceNumber ) ) );
+            }
+
+            /* Now prepare the SACK message.
+             * Code OPTION_CODE_SINGLE_SACK already in network byte order. */
+            pxWindow->ulOptionsData[ 0 ] = OPTION_CODE_SINGLE_SACK;
+
+            /* First sequence number that we received. */
+            pxWindow->ulOptionsData[ 1 ] = FreeRTOS_htonl( ulSequenceNumber );
+
+            /* Last + 1 */
+            pxWindow->ulOptionsData[ 2 ] = FreeRTOS_htonl( ulLast );
+
+            /* Which make 12 (3*4) option bytes. */
+            pxWindow->ucOptionLength = ( uint8_t ) ( 3U * sizeof( pxWindow->ulOptionsData[ 0 ] ) );
+
+            pxFound = xTCPWindowRxFind( pxWindow, ulSequenceNumber );
+
+            if( pxFound != NULL )
+            {
+                /* This out-of-sequence packet has been received for a
+                 * second time.  It is already stored but do send a SACK
+                 * again. */
+                /* A negative value will be returned to indicate than error. */
+            }
+            else
+            {
+                pxFound = xTCPWindowRxNew( pxWindow, ulSequenceNumber, ( int32_t ) ulLength );
+
+                if( pxFound == NULL )
+                {
+                    /* Can not send a SACK, because the segment cannot be
+                     * stored. */
+                    pxWindow->ucOptionLength = 0U;
+
+                    /* Needs to be stored but there is no segment
+                     * available. A negative value will be returned. */
+                }
+                else
+                {
+                    uint32_t ulIntermediateResult;
+
+                    if( xTCPWindowLoggingLevel != 0 )
+                    {
+                        FreeRTOS_debug_printf( ( "lTCPWindowRxCheck[%u,%u]: seqnr %u (cnt %u)\n",
+                                                 pxWindow->usPeerPortNumber,
+                                                 pxWindow->usOurPortNumber,
+                                                 ( unsigned ) ( ulSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
+                                                 ( unsigned ) listCURRENT_LIST_LENGTH( &pxWindow->xRxSegments ) ) );
+                    }
+
+                    /* Return a positive value.  The packet may be accepted
+                    * and stored but an earlier packet is still missing. */
+                    ulIntermediateResult = ulSequenceNumber - ulCurrentSequenceNumber;
+                    lReturn = ( int32_t ) ulIntermediateResult;
+                }
+            }
+
+            return lReturn;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Check what to do with a new incoming packet: store or ignore.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulSequenceNumber The sequence number of the packet received.
+ * @param[in] ulLength The number of bytes received.
+ * @param[in] ulSpace The available space in the RX stream buffer.
+ * @param[out] pulSkipCount the number of bytes to skip in the receive buffer.
+ *
+ * @return 0 or positive value indicating the offset at which the packet is to
+ *         be stored, -1 if the packet is to be ignored.
+ */
+        int32_t lTCPWindowRxCheck( TCPWindow_t * pxWindow,
+                                   uint32_t ulSequenceNumber,
+                                   uint32_t ulLength,
+                                   uint32_t ulSpace,
+                                   uint32_t * pulSkipCount )
+        {
+            uint32_t ulCurrentSequenceNumber;
+            uint32_t ulIntermediateResult;
+            int32_t lReturn = -1;
+            int32_t lStartDistance;
+            int32_t lLastDistance;
+            uint32_t ulLast;
+            uint32_t ulRxSequenceNumber = ulSequenceNumber;
+            uint32_t ulRxLength = ulLength;
+
+            /* If lTCPWindowRxCheck( ) returns == 0, the packet will be passed
+             * directly to user (segment is expected).  If it returns a positive
+             * number, an earlier packet is missing, but this packet may be stored.
+             * If negative, the packet has already been stored, or it is out-of-order,
+             * or there is not enough space.
+             *
+             * As a side-effect, pxWindow->ulUserDataLength will get set to non-zero,
+             * if more Rx data may be passed to the user after this packet. */
+
+            /* Only in an exceptional case, where a packet starts before
+             * ulCurrentSequenceNumber, and ends after it, the skip-count
+             * will be set. See below. */
+
+            *( pulSkipCount ) = 0U;
+
+            ulCurrentSequenceNumber = pxWindow->rx.ulCurrentSequenceNumber;
+
+            ulLast = ulRxSequenceNumber + ulRxLength;
+            ulIntermediateResult = ulLast - ulCurrentSequenceNumber;
+            /* The cast from unsigned long to signed long is on purpose. */
+            lLastDistance = ( int32_t ) ulIntermediateResult;
+
+            ulIntermediateResult = ulRxSequenceNumber - ulCurrentSequenceNumber;
+            lStartDistance = ( int32_t ) ulIntermediateResult;
+
+            if( ( lStartDistance < 0 ) && ( lLastDistance > 0 ) )
+            {
+                FreeRTOS_debug_printf( ( "lTCPWindowRxCheck: Received +%u bytes for %u, only using %d\n",
+                                         ( unsigned ) ulRxLength,
+                                         ( unsigned ) ( ulRxSequenceNumber - pxWindow->rx.ulFirstSequenceNumber ),
+                                         ( int ) lLastDistance ) );
+                /* Increase the sequence number, decrease the length. */
+                ulRxSequenceNumber += ( uint32_t ) ( -lStartDistance );
+                ulRxLength += ( uint32_t ) lStartDistance;
+
+                /* Tell the caller that the first 'pulSkipCount' bytes don't
+                 * need to be stored. */
+                *( pulSkipCount ) = ( uint32_t ) ( -lStartDistance );
+            }
+
+            /* For Selective Ack (SACK), used when out-of-sequence data come in. */
+            pxWindow->ucOptionLength = 0U;
+
+            /* Non-zero if TCP-windows contains data which must be popped. */
+            pxWindow->ulUserDataLength = 0U;
+
+            if( ulCurrentSequenceNumber == ulRxSequenceNumber )
+            {
+                /* This is the packet with the lowest sequence number we're waiting
+                 * for.  It can be passed directly to the rx stream. */
+                if( ulRxLength > ulSpace )
+                {
+                    FreeRTOS_debug_printf( ( "lTCPWindowRxCheck: Refuse %u bytes, due to lack of space (%u)\n", ( unsigned ) ulRxLength, ( unsigned ) ulSpace ) );
+                }
+                else
+                {
+                    /* Packet was expected, may be passed directly to the socket
+                     * buffer or application.  Store the packet at offset 0. */
+                    prvTCPWindowRx_ExpectedRX( pxWindow, ulRxLength );
+                    lReturn = 0;
+                }
+            }
+            else if( ulCurrentSequenceNumber == ( ulRxSequenceNumber + 1U ) )
+            {
+                /* Looks like a TCP keep-alive message.  Do not accept/store Rx data
+                 * ulUserDataLength = 0. Not packet out-of-sync.  Just reply to it. */
+            }
+            else
+            {
+                /* The packet is not the one expected.  See if it falls within the Rx
+                 * window so it can be stored. */
+
+                /*  An "out-of-sequence" segment was received, must have missed one.
+                 * Prepare a SACK (Selective ACK). */
+
+                if( lLastDistance <= 0 )
+                {
+                    /* An earlier packet has been received, must be a retransmission of a
+                     * packet that has been accepted already.  No need to send out a
+                     * Selective ACK (SACK). */
+                }
+                else if( lLastDistance > ( int32_t ) ulSpace )
+                {
+                    /* The new segment is ahead of rx.ulCurrentSequenceNumber.  The
+                     * sequence number of this packet is too far ahead, ignore it. */
+                    FreeRTOS_debug_printf( ( "lTCPWindowRxCheck: Refuse %d+%u bytes, due to lack of space (%u)\n",
+                                             ( int ) lLastDistance,
+                                             ( unsigned ) ulRxLength,
+                                             ( unsigned ) ulSpace ) );
+                }
+                else
+                {
+                    lReturn = prvTCPWindowRx_UnexpectedRX( pxWindow, ulRxSequenceNumber, ulRxLength );
+                }
+            }
+
+            return lReturn;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+/*=============================================================================
+ *
+ *                    #########   #    #
+ *                    #   #   #   #    #
+ *                        #       #    #
+ *                        #        ####
+ *                        #         ##
+ *                        #        ####
+ *                        #       #    #
+ *                        #       #    #
+ *                      #####     #    #
+ *
+ * Tx functions
+ *
+ *=============================================================================*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Increment the position in a circular buffer of size 'lMax'.
+ *
+ * @param[in] lPosition The current index in the buffer.
+ * @param[in] lMax The total number of items in this buffer.
+ * @param[in] lCount The number of bytes that must be advanced.
+ *
+ * @return The new incremented position, or "( lPosition + lCount ) % lMax".
+ */
+        static int32_t lTCPIncrementTxPosition( int32_t lPosition,
+                                                int32_t lMax,
+                                                int32_t lCount )
+        {
+            int32_t lReturn;
+
+
+            /* +TCP stores data in circular buffers.  Calculate the next position to
+             * store. */
+            lReturn = lPosition + lCount;
+
+            if( lReturn >= lMax )
+            {
+                lReturn -= lMax;
+            }
+
+            return lReturn;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Adding data to a segment that was already in the TX queue.  It
+ *        will be filled-up to a maximum of MSS ( maximum segment size ).
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] pxSegment The TX segment with the highest sequence number,
+ *                       i.e. the "front segment".
+ * @param[in] lBytesLeft The number of bytes that must be added.
+ *
+ * @return lToWrite: the number of bytes added to the segment.
+ */
+        static int32_t prvTCPWindowTxAdd_FrontSegment( TCPWindow_t * pxWindow,
+                                                       TCPSegment_t * pxSegment,
+                                                       int32_t lBytesLeft )
+        {
+            int32_t lToWrite = FreeRTOS_min_int32( lBytesLeft, pxSegment->lMaxLength - pxSegment->lDataLength );
+
+            pxSegment->lDataLength += lToWrite;
+
+            if( pxSegment->lDataLength >= pxSegment->lMaxLength )
+            {
+                /* This segment is full, don't add more bytes. */
+                pxWindow->pxHeadSegment = NULL;
+            }
+
+            /* ulNextTxSequenceNumber is the sequence number of the next byte to
+             * be stored for transmission. */
+            pxWindow->ulNextTxSequenceNumber += ( uint32_t ) lToWrite;
+
+            /* Some detailed logging, for those who're interested. */
+            if( ( xTCPWindowLoggingLevel >= 2 ) && ipconfigTCP_MAY_LOG_PORT( pxWindow->usOurPortNumber ) )
+            {
+                FreeRTOS_debug_printf( ( "lTCPWindowTxAdd: Add %4d bytes for seqNr %u len %4d (nxt %u) pos %d\n",
+                                         ( int ) lBytesLeft,
+                                         ( unsigned ) ( pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
+                                         ( int ) pxSegment->lDataLength,
+                                         ( unsigned ) ( pxWindow->ulNextTxSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
+                                         ( int ) pxSegment->lStreamPos ) );
+            }
+
+            return lToWrite;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Will add data to be transmitted to the front of the segment fifo.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulLength The number of bytes that will be sent.
+ * @param[in] lPosition The index in the TX stream buffer.
+ * @param[in] lMax The size of the ( circular ) TX stream buffer.
+ *
+ * @return The number of bytes added to the sliding window for transmission.
+ *
+ */
+        int32_t lTCPWindowTxAdd( TCPWindow_t * pxWindow,
+                                 uint32_t ulLength,
+                                 int32_t lPosition,
+                                 int32_t lMax )
+        {
+            int32_t lBytesLeft = ( int32_t ) ulLength;
+            int32_t lToWrite;
+            int32_t lDone = 0;
+            int32_t lBufferIndex = lPosition;
+            TCPSegment_t * pxSegment = pxWindow->pxHeadSegment;
+
+            /* Puts a message in the Tx-window (after buffer size has been
+             * verified). */
+            if( ( pxSegment != NULL ) &&
+                ( pxSegment->lDataLength < pxSegment->lMaxLength ) &&
+                ( pxSegment->u.bits.bOutstanding == pdFALSE_UNSIGNED ) &&
+                ( pxSegment->lDataLength != 0 ) )
+            {
+                lToWrite = prvTCPWindowTxAdd_FrontSegment( pxWindow, pxSegment, lBytesLeft );
+                lBytesLeft -= lToWrite;
+                /* Increased the return value. */
+                lDone += lToWrite;
+
+                /* Calculate the next position in the circular data buffer, knowing
+                 * its maximum length 'lMax'. */
+                lBufferIndex = lTCPIncrementTxPosition( lBufferIndex, lMax, lToWrite );
+            }
+
+            while( lBytesLeft > 0 )
+            {
+                /* The current transmission segment is full, create new segments as
+                 * needed. */
+                pxSegment = xTCPWindowTxNew( pxWindow, pxWindow->ulNextTxSequenceNumber, ( int32_t ) pxWindow->usMSS );
+
+                if( pxSegment != NULL )
+                {
+                    /* Store as many as needed, but no more than the maximum
+                     * (MSS). */
+                    lToWrite = FreeRTOS_min_int32( lBytesLeft, pxSegment->lMaxLength );
+
+                    pxSegment->lDataLength = lToWrite;
+                    pxSegment->lStreamPos = lBufferIndex;
+                    lBytesLeft -= lToWrite;
+                    lBufferIndex = lTCPIncrementTxPosition( lBufferIndex, lMax, lToWrite );
+                    pxWindow->ulNextTxSequenceNumber += ( uint32_t ) lToWrite;
+                    lDone += lToWrite;
+
+                    /* Link this segment in the Tx-Queue. */
+                    vListInsertFifo( &( pxWindow->xTxQueue ), &( pxSegment->xQueueItem ) );
+
+                    /* Let 'pxHeadSegment' point to this segment if there is still
+                     * space. */
+                    if( pxSegment->lDataLength < pxSegment->lMaxLength )
+                    {
+                        pxWindow->pxHeadSegment = pxSegment;
+                    }
+                    else
+                    {
+                        pxWindow->pxHeadSegment = NULL;
+                    }
+                }
+                else
+                {
+                    /* A sever situation: running out of segments for transmission.
+                     * No more data can be sent at the moment. */
+                    if( lDone != 0 )
+                    {
+                        FreeRTOS_debug_printf( ( "lTCPWindowTxAdd: Sorry all buffers full (cancel %d bytes)\n", ( int ) lBytesLeft ) );
+                    }
+
+                    break;
+                }
+            }
+
+            return lDone;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Returns true if there are no more outstanding TX segments.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ *
+ * @return pdTRUE if there are no more outstanding Tx segments, else pdFALSE.
+ */
+        BaseType_t xTCPWindowTxDone( const TCPWindow_t * pxWindow )
+        {
+            return listLIST_IS_EMPTY( ( &pxWindow->xTxSegments ) );
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Find out if the peer is able to receive more data.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulWindowSize The number of bytes in this segment.
+ *
+ * @return True if the peer has space in it window to receive more data.
+ */
+        static BaseType_t prvTCPWindowTxHasSpace( TCPWindow_t const * pxWindow,
+                                                  uint32_t ulWindowSize )
+        {
+            uint32_t ulTxOutstanding;
+            BaseType_t xHasSpace;
+            const TCPSegment_t * pxSegment;
+            uint32_t ulNettSize;
+
+            /* This function will look if there is new transmission data.  It will
+             * return true if there is data to be sent. */
+
+            pxSegment = xTCPWindowPeekHead( &( pxWindow->xTxQueue ) );
+
+            if( pxSegment == NULL )
+            {
+                xHasSpace = pdFALSE;
+            }
+            else
+            {
+                /* How much data is outstanding, i.e. how much data has been sent
+                 * but not yet acknowledged ? */
+                if( pxWindow->tx.ulHighestSequenceNumber >= pxWindow->tx.ulCurrentSequenceNumber )
+                {
+                    ulTxOutstanding = pxWindow->tx.ulHighestSequenceNumber - pxWindow->tx.ulCurrentSequenceNumber;
+                }
+                else
+                {
+                    ulTxOutstanding = 0U;
+                }
+
+                /* Subtract this from the peer's space. */
+                ulNettSize = ulWindowSize - FreeRTOS_min_uint32( ulWindowSize, ulTxOutstanding );
+
+                /* See if the next segment may be sent. */
+                if( ulNettSize >= ( uint32_t ) pxSegment->lDataLength )
+                {
+                    xHasSpace = pdTRUE;
+                }
+                else
+                {
+                    xHasSpace = pdFALSE;
+                }
+
+                /* If 'xHasSpace', it looks like the peer has at least space for 1
+                 * more new segment of size MSS.  xSize.ulTxWindowLength is the self-imposed
+                 * limitation of the transmission window (in case of many resends it
+                 * may be decreased). */
+                if( ( ulTxOutstanding != 0U ) &&
+                    ( pxWindow->xSize.ulTxWindowLength <
+                      ( ulTxOutstanding + ( ( uint32_t ) pxSegment->lDataLength ) ) ) )
+                {
+                    xHasSpace = pdFALSE;
+                }
+
+                #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+                {
+                    /* The outstanding data may not exceed the congestion window.
+                     * When nothing is outstanding, one segment may always be sent. */
+                    if( ( ulTxOutstanding != 0U ) &&
+                        ( pxWindow->ulCongestionWindow <
+                          ( ulTxOutstanding + ( ( uint32_t ) pxSegment->lDataLength ) ) ) )
+                    {
+                        xHasSpace = pdFALSE;
+                    }
+                }
+                #endif
+            }
+
+            return xHasSpace;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Returns true if there is TX data that can be sent right now.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulWindowSize The current size of the sliding RX window of the peer.
+ * @param[out] pulDelay The delay before the packet may be sent.
+ *
+ * @return pdTRUE if there is Tx data that can be sent, else pdFALSE.
+ */
+        BaseType_t xTCPWindowTxHasData( TCPWindow_t const * pxWindow,
+                                        uint32_t ulWindowSize,
+                                        TickType_t * pulDelay )
+        {
+            TCPSegment_t const * pxSegment;
+            BaseType_t xReturn;
+            TickType_t ulAge, ulMaxAge;
+
+            *pulDelay = 0U;
+
+            if( listLIST_IS_EMPTY( &pxWindow->xPriorityQueue ) == pdFALSE )
+            {
+                /* No need to look at retransmissions or new transmission as long as
+                 * there are priority segments.  *pulDelay equals zero, meaning it must
+                 * be sent out immediately. */
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                pxSegment = xTCPWindowPeekHead( &( pxWindow->xWaitQueue ) );
+
+                if( pxSegment != NULL )
+                {
+                    uint32_t ulSRTT = ( uint32_t ) pxWindow->lSRTT;
+
+                    /* There is an outstanding segment, see if it is time to resend
+                     * it. */
+                    ulAge = ulTimerGetAge( &pxSegment->xTransmitTimer );
+
+                    /* After a packet has been sent for the first time, it will wait
+                     * '1 * ulSRTT' ms for an ACK. A second time it will wait '2 * ulSRTT' ms,
+                     * each time doubling the time-out */
+                    ulMaxAge = ( ( uint32_t ) 1U << pxSegment->u.bits.ucTransmitCount );
+                    ulMaxAge *= ulSRTT;
+
+                    if( ulMaxAge > ulAge )
+                    {
+                        /* A segment must be sent after this amount of msecs */
+                        *pulDelay = ulMaxAge - ulAge;
+                    }
+
+                    xReturn = pdTRUE;
+                }
+                else
+                {
+                    /* No priority segment, no outstanding data, see if there is new
+                     * transmission data. */
+                    pxSegment = xTCPWindowPeekHead( &pxWindow->xTxQueue );
+
+                    /* See if it fits in the peer's reception window. */
+                    if( pxSegment == NULL )
+                    {
+                        xReturn = pdFALSE;
+                    }
+                    else if( prvTCPWindowTxHasSpace( pxWindow, ulWindowSize ) == pdFALSE )
+                    {
+                        /* Too many outstanding messages. */
+                        xReturn = pdFALSE;
+                    }
+                    else if( ( pxWindow->u.bits.bSendFullSize != pdFALSE_UNSIGNED ) &&
+                             ( pxSegment->lDataLength < pxSegment->lMaxLength ) )
+                    {
+                        /* 'bSendFullSize' is a special optimisation.  If true, the
+                         * driver will only sent completely filled packets (of MSS
+                         * bytes). */
+                        xReturn = pdFALSE;
+                    }
+                    else
+                    {
+                        xReturn = pdTRUE;
+                    }
+                }
+            }
+
+            return xReturn;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Three type of queues are used for transmission: priority, waiting, and
+ *        the normal TX queue of unsent data.  Message in the waiting queue will
+ *        be sent when their timer has expired.
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ */
+        static TCPSegment_t * pxTCPWindowTx_GetWaitQueue( TCPWindow_t * pxWindow )
+        {
+            TCPSegment_t * pxSegment = xTCPWindowPeekHead( &( pxWindow->xWaitQueue ) );
+
+            if( pxSegment != NULL )
+            {
+                /* Do check the timing. */
+                uint32_t ulMaxTime;
+
+                ulMaxTime = ( ( uint32_t ) 1U ) << pxSegment->u.bits.ucTransmitCount;
+                ulMaxTime *= ( uint32_t ) pxWindow->lSRTT;
+
+                if( ulTimerGetAge( &pxSegment->xTransmitTimer ) > ulMaxTime )
+                {
+                    /* A normal (non-fast) retransmission.  Move it from the
+                     * head of the waiting queue. */
+                    pxSegment = xTCPWindowGetHead( &( pxWindow->xWaitQueue ) );
+                    pxSegment->u.bits.ucDupAckCount = ( uint8_t ) pdFALSE_UNSIGNED;
+
+                    #if ( ipconfigUSE_TCP_SACK_SCOREBOARD == 1 )
+                    {
+                        /* Also a lost retransmission may be repaired by SACK later on. */
+                        pxSegment->u.bits.bLost = pdFALSE_UNSIGNED;
+                    }
+                    #endif
+
+                    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+                    {
+                        /* The retransmission timer expired: a strong indication
+                         * of congestion. */
+                        prvTCPWindowCongestionOnTimeout( pxWindow, ( pxSegment->u.bits.ucTransmitCount == 1U ) ? pdTRUE : pdFALSE );
+                    }
+                    #endif
+
+                    /* Some detailed logging. */
+                    if( ( xTCPWindowLoggingLevel != 0 ) && ( ipconfigTCP_MAY_LOG_PORT( pxWindow->usOurPortNumber ) ) )
+                    {
+                        FreeRTOS_debug_printf( ( "ulTCPWindowTxGet[%u,%u]: WaitQueue %d bytes for sequence number %u (0x%X)\n",
+                                                 pxWindow->usPeerPortNumber,
+                                                 pxWindow->usOurPortNumber,
+                                                 ( int ) pxSegment->lDataLength,
+                                                 ( unsigned ) ( pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
+                                                 ( unsigned ) pxSegment->ulSequenceNumber ) );
+                    }
+                }
+                else
+                {
+                    pxSegment = NULL;
+                }
+            }
+
+            return pxSegment;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief See if there is a transmission in the normal TX queue. It is the
+ *        first time these data are being sent. After sending they will move
+ *        the waiting queue.
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulWindowSize The available space that the peer has in his
+ *                          reception window.
+ * @return Either a segment that has to be sent, or NULL.
+ */
+        static TCPSegment_t * pxTCPWindowTx_GetTXQueue( TCPWindow_t * pxWindow,
+                                                        uint32_t ulWindowSize )
+        {
+            TCPSegment_t * pxSegment = xTCPWindowPeekHead( &( pxWindow->xTxQueue ) );
+
+            if( pxSegment == NULL )
+            {
+                /* No segments queued. */
+            }
+            else if( ( pxWindow->u.bits.bSendFullSize != pdFALSE_UNSIGNED ) &&
+                     ( pxSegment->lDataLength < pxSegment->lMaxLength ) )
+            {
+                /* A segment has been queued but the driver waits until it
+                 * has a full size of MSS. */
+                pxSegment = NULL;
+            }
+            else if( ( pxWindow->u.bits.bNagle != pdFALSE_UNSIGNED ) &&
+                     ( pxSegment->lDataLength < pxSegment->lMaxLength ) &&
+                     ( listLIST_IS_EMPTY( &( pxWindow->xWaitQueue ) ) == pdFALSE ) )
+            {
+                /* Nagle algorithm: a small segment is held back as long as
+                 * sent data has not been acknowledged. More data may be added
+                 * to it in the mean time. */
+                pxSegment = NULL;
+            }
+            else if( prvTCPWindowTxHasSpace( pxWindow, ulWindowSize ) == pdFALSE )
+            {
+                /* Peer has no more space at this moment. */
+                pxSegment = NULL;
+            }
+            else
+            {
+                /* pxSegment was just obtained with a peek function,
+                 * now remove it from of the Tx queue. */
+                pxSegment = xTCPWindowGetHead( &( pxWindow->xTxQueue ) );
+
+                /* Don't let pxHeadSegment point to this segment any more,
+                 * so no more data will be added. */
+                if( pxWindow->pxHeadSegment == pxSegment )
+                {
+                    pxWindow->pxHeadSegment = NULL;
+                }
+
+                /* pxWindow->tx.highest registers the highest sequence
+                 * number in our transmission window. */
+                pxWindow->tx.ulHighestSequenceNumber = pxSegment->ulSequenceNumber + ( ( uint32_t ) pxSegment->lDataLength );
+
+                /* ...and more detailed logging */
+                if( ( xTCPWindowLoggingLevel >= 2 ) && ( ipconfigTCP_MAY_LOG_PORT( pxWindow->usOurPortNumber ) ) )
+                {
+                    FreeRTOS_debug_printf( ( "ulTCPWindowTxGet[%u,%u]: XmitQueue %d bytes for sequence number %u (ws %u)\n",
+                                             pxWindow->usPeerPortNumber,
+                                             pxWindow->usOurPortNumber,
+                                             ( int ) pxSegment->lDataLength,
+                                             ( unsigned ) ( pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
+                                             ( unsigned ) ulWindowSize ) );
+                }
+            }
+
+            return pxSegment;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Get data that can be transmitted right now. There are three types of
+ *        outstanding segments: Priority queue, Waiting queue, Normal TX queue.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulWindowSize The current size of the sliding RX window of the peer.
+ * @param[out] plPosition The index within the TX stream buffer of the first byte to be sent.
+ *
+ * @return The amount of data in bytes that can be transmitted right now.
+ */
+        uint32_t ulTCPWindowTxGet( TCPWindow_t * pxWindow,
+                                   uint32_t ulWindowSize,
+                                   int32_t * plPosition )
+        {
+            TCPSegment_t * pxSegment;
+            uint32_t ulReturn = 0U;
+
+            /* Fetches data to be sent-out now.
+             *
+             * Priority messages: segments with a resend need no check current sliding
+             * window size. */
+            pxSegment = xTCPWindowGetHead( &( pxWindow->xPriorityQueue ) );
+            pxWindow->ulOurSequenceNumber = pxWindow->tx.ulHighestSequenceNumber;
+
+            if( pxSegment != NULL )
+            {
+                /* There is a priority segment. It doesn't need any checking for
+                 * space or timeouts. */
+                if( xTCPWindowLoggingLevel != 0 )
+                {
+                    FreeRTOS_debug_printf( ( "ulTCPWindowTxGet[%u,%u]: PrioQueue %d bytes for sequence number %u (ws %u)\n",
+                                             pxWindow->usPeerPortNumber,
+                                             pxWindow->usOurPortNumber,
+                                             ( int ) pxSegment->lDataLength,
+                                             ( unsigned ) ( pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
+                                             ( unsigned ) ulWindowSize ) );
+                }
+            }
+            else
+            {
+                /* Waiting messages: outstanding messages with a running timer
+                 * neither check peer's reception window size because these packets
+                 * have been sent earlier. */
+                pxSegment = pxTCPWindowTx_GetWaitQueue( pxWindow );
+
+                if( pxSegment == NULL )
+                {
+                    /* New messages: sent-out for the first time.  Check current
+                     * sliding window size of peer. */
+                    pxSegment = pxTCPWindowTx_GetTXQueue( pxWindow, ulWindowSize );
+                }
+            }
+
+            /* See if it has already been determined to return 0. */
+            if( pxSegment != NULL )
+            {
+                configASSERT( listLIST_ITEM_CONTAINER( &( pxSegment->xQueueItem ) ) == NULL );
+
+                /* Now that the segment will be transmitted, add it to the tail of
+                 * the waiting queue. */
+                vListInsertFifo( &pxWindow->xWaitQueue, &pxSegment->xQueueItem );
+
+                /* And mark it as outstanding. */
+                pxSegment->u.bits.bOutstanding = pdTRUE_UNSIGNED;
+
+                /* Administer the transmit count, needed for fast
+                 * retransmissions. */
+                ( pxSegment->u.bits.ucTransmitCount )++;
+
+                /* If there have been several retransmissions (4), decrease the
+                 * size of the transmission window to at most 2 times MSS. */
+                if( ( pxSegment->u.bits.ucTransmitCount == MAX_TRANSMIT_COUNT_USING_LARGE_WINDOW ) &&
+                    ( pxWindow->xSize.ulTxWindowLength > ( 2U * ( ( uint32_t ) pxWindow->usMSS ) ) ) )
+                {
+                    uint16_t usMSS2 = ( uint16_t ) ( pxWindow->usMSS * 2U );
+                    FreeRTOS_debug_printf( ( "ulTCPWindowTxGet[%u - %u]: Change Tx window: %u -> %u\n",
+                                             pxWindow->usPeerPortNumber,
+                                             pxWindow->usOurPortNumber,
+                                             ( unsigned ) pxWindow->xSize.ulTxWindowLength,
+                                             usMSS2 ) );
+                    pxWindow->xSize.ulTxWindowLength = usMSS2;
+                }
+
+                /* Clear the transmit timer. */
+                vTCPTimerSet( &( pxSegment->xTransmitTimer ) );
+
+                pxWindow->ulOurSequenceNumber = pxSegment->ulSequenceNumber;
+
+                /* Inform the caller where to find the data within the queue. */
+                *plPosition = pxSegment->lStreamPos;
+
+                /* And return the length of the data segment */
+                ulReturn = ( uint32_t ) pxSegment->lDataLength;
+            }
+
+            return ulReturn;
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief Data has been sent, and an ACK has been received. Make an estimate
+ *        of the round-trip time, and calculate the new timeout for transmissions.
+ *        More explanation in a comment here below.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] pxSegment The segment that was just acknowledged.
+ */
+        static void prvTCPWindowTxCheckAck_CalcSRTT( TCPWindow_t * pxWindow,
+                                                     const TCPSegment_t * pxSegment )
+        {
+            int32_t mS = ( int32_t ) ulTimerGetAge( &( pxSegment->xTransmitTimer ) );
+
+            mS = ( mS < 0 ) ? ipINT32_MAX_VALUE : mS;
+
+            prvTCPWindowUpdateSRTT( pxWindow, mS );
+        }
+    #endif /* ipconfigUSE_TCP_WIN == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_WIN == 1 )
+
+/**
+ * @brief A new round-trip time has been measured: update the smoothed RTT.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] lRoundTripTime The round-trip time in ms, must not be negative.
+ */
+        static void prvTCPWindowUpdateSRTT( TCPWindow_t * pxWindow,
+                                            int32_t lRoundTripTime )
+        {
+            int32_t mS = lRoundTripTime;
+            int32_t lSum = 0;
+            int32_t lWeight = 0;
+            int32_t lDivisor = 0;
+
+            #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+            {
+                const TCPCongestionOps_t * pxOps = prvTCPWindowCongestionOps( pxWindow );
+
+                if( pxOps->fnOnRTTSample != NULL )
+                {
+                    pxOps->fnOnRTTSample( pxWindow, ( uint32_t ) mS );
+                }
+            }
+            #endif
+
+            if( pxWindow->lSRTT >= mS )
+            {
+                /* RTT becomes smaller: adapt slowly. */
+                lWeight = winSRTT_DECREMENT_CURRENT;
+                lDivisor = winSRTT_DECREMENT_NEW + winSRTT_DECREMENT_CURRENT;
+                mS = FreeRTOS_multiply_int32( mS,
+                                              winSRTT_DECREMENT_NEW );
+            }
+            else
+            {
+                /* RTT becomes larger: adapt quicker */
+                lWeight = winSRTT_INCREMENT_CURRENT;
+                lDivisor = winSRTT_INCREMENT_NEW + winSRTT_INCREMENT_CURRENT;
+                mS = FreeRTOS_multiply_int32( mS,
+                                              winSRTT_INCREMENT_NEW );
+            }
 
-            return lReturn;
+            lSum = FreeRTOS_multiply_int32( pxWindow->lSRTT, lWeight );
+            lSum = FreeRTOS_add_int32( lSum, mS );
+            pxWindow->lSRTT = lSum / lDivisor;
+
+            /* Cap to the minimum of 50ms. */
+            if( pxWindow->lSRTT < winSRTT_CAP_mS )
+            {
+                pxWindow->lSRTT = winSRTT_CAP_mS;
+            }
         }
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
-/*=============================================================================
- *
- *                    #########   #    #
- *                    #   #   #   #    #
- *                        #       #    #
- *                        #        ####
- *                        #         ##
- *                        #        ####
- *                        #       #    #
- *                        #       #    #
- *                      #####     #    #
- *
- * Tx functions
- *
- *=============================================================================*/
-
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
 
 /**
- * @brief Increment the position in a circular buffer of size 'lMax'.
+ * @brief Get the number of bytes that have been sent but not yet acknowledged,
+ *        also known as the FlightSize.
  *
- * @param[in] lPosition The current index in the buffer.
- * @param[in] lMax The total number of items in this buffer.
- * @param[in] lCount The number of bytes that must be advanced.
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
  *
- * @return The new incremented position, or "( lPosition + lCount ) % lMax".
+ * @return The number of outstanding bytes.
  */
-        static int32_t lTCPIncrementTxPosition( int32_t lPosition,
-                                                int32_t lMax,
-                                                int32_t lCount )
+        static uint32_t prvTCPWindowCongestionFlightSize( const TCPWindow_t * pxWindow )
         {
-            int32_t lReturn;
-
-
-            /* +TCP stores data in circular buffers.  Calculate the next position to
-             * store. */
-            lReturn = lPosition + lCount;
+            uint32_t ulFlightSize = 0U;
 
-            if( lReturn >= lMax )
+            if( xSequenceGreaterThan( pxWindow->tx.ulHighestSequenceNumber, pxWindow->tx.ulCurrentSequenceNumber ) != pdFALSE )
             {
-                lReturn -= lMax;
+                ulFlightSize = pxWindow->tx.ulHighestSequenceNumber - pxWindow->tx.ulCurrentSequenceNumber;
             }
 
-            return lReturn;
+            return ulFlightSize;
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
 
 /**
- * @brief Adding data to a segment that was already in the TX queue.  It
- *        will be filled-up to a maximum of MSS ( maximum segment size ).
+ * @brief Calculate a new slow start threshold after a loss has been detected:
+ *        half of the FlightSize, but at least 2 times MSS ( RFC 5681 equation 4 ).
  *
  * @param[in] pxWindow The descriptor of the TCP sliding windows.
- * @param[in] pxSegment The TX segment with the highest sequence number,
- *                       i.e. the "front segment".
- * @param[in] lBytesLeft The number of bytes that must be added.
  *
- * @return lToWrite: the number of bytes added to the segment.
+ * @return The new value for ssthresh.
  */
-        static int32_t prvTCPWindowTxAdd_FrontSegment( TCPWindow_t * pxWindow,
-                                                       TCPSegment_t * pxSegment,
-                                                       int32_t lBytesLeft )
+        static uint32_t prvTCPWindowCongestionThreshold( const TCPWindow_t * pxWindow )
         {
-            int32_t lToWrite = FreeRTOS_min_int32( lBytesLeft, pxSegment->lMaxLength - pxSegment->lDataLength );
-
-            pxSegment->lDataLength += lToWrite;
+            uint32_t ulThreshold = prvTCPWindowCongestionFlightSize( pxWindow ) / 2U;
+            uint32_t ulMinimum = 2U * ( ( uint32_t ) pxWindow->usMSS );
 
-            if( pxSegment->lDataLength >= pxSegment->lMaxLength )
+            if( ulThreshold < ulMinimum )
             {
-                /* This segment is full, don't add more bytes. */
-                pxWindow->pxHeadSegment = NULL;
+                ulThreshold = ulMinimum;
             }
 
-            /* ulNextTxSequenceNumber is the sequence number of the next byte to
-             * be stored for transmission. */
-            pxWindow->ulNextTxSequenceNumber += ( uint32_t ) lToWrite;
+            return ulThreshold;
+        }
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+/*-----------------------------------------------------------*/
 
-            /* Some detailed logging, for those who're interested. */
-            if( ( xTCPWindowLoggingLevel >= 2 ) && ipconfigTCP_MAY_LOG_PORT( pxWindow->usOurPortNumber ) )
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+
+/**
+ * @brief Look up a built-in congestion control algorithm by its name, as
+ *        used by the FREERTOS_SO_TCP_CONGESTION socket option.
+ *
+ * @param[in] pcName The name of the algorithm, it does not have to be
+ *                   nul-terminated.
+ * @param[in] uxNameLength The maximum number of characters in pcName.
+ *
+ * @return The algorithm, or NULL when the name is unknown.
+ */
+        const TCPCongestionOps_t * pxTCPWindowFindCongestionOps( const char * pcName,
+                                                                  size_t uxNameLength )
+        {
+            const TCPCongestionOps_t * pxResult = NULL;
+            const char * pcCandidate;
+            size_t uxLength = 0U;
+            size_t uxIndex;
+            UBaseType_t uxAlgorithm;
+
+            if( pcName != NULL )
             {
-                FreeRTOS_debug_printf( ( "lTCPWindowTxAdd: Add %4d bytes for seqNr %u len %4d (nxt %u) pos %d\n",
-                                         ( int ) lBytesLeft,
-                                         ( unsigned ) ( pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
-                                         ( int ) pxSegment->lDataLength,
-                                         ( unsigned ) ( pxWindow->ulNextTxSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
-                                         ( int ) pxSegment->lStreamPos ) );
+                /* The option value may include a terminating nul. */
+                while( ( uxLength < uxNameLength ) && ( pcName[ uxLength ] != '\0' ) )
+                {
+                    uxLength++;
+                }
+
+                for( uxAlgorithm = 0U; uxAlgorithm < ARRAY_USIZE( pxTCPCongestionAlgorithms ); uxAlgorithm++ )
+                {
+                    pcCandidate = pxTCPCongestionAlgorithms[ uxAlgorithm ]->pcName;
+
+                    for( uxIndex = 0U; uxIndex < uxLength; uxIndex++ )
+                    {
+                        if( pcCandidate[ uxIndex ] != pcName[ uxIndex ] )
+                        {
+                            break;
+                        }
+                    }
+
+                    if( ( uxIndex == uxLength ) && ( pcCandidate[ uxIndex ] == '\0' ) )
+                    {
+                        pxResult = pxTCPCongestionAlgorithms[ uxAlgorithm ];
+                        break;
+                    }
+                }
             }
 
-            return lToWrite;
+            return pxResult;
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
 
 /**
- * @brief Will add data to be transmitted to the front of the segment fifo.
+ * @brief Get the congestion control algorithm of a window.
  *
  * @param[in] pxWindow The descriptor of the TCP sliding windows.
- * @param[in] ulLength The number of bytes that will be sent.
- * @param[in] lPosition The index in the TX stream buffer.
- * @param[in] lMax The size of the ( circular ) TX stream buffer.
  *
- * @return The number of bytes added to the sliding window for transmission.
+ * @return The selected algorithm, or NewReno when none was selected.
+ */
+        static const TCPCongestionOps_t * prvTCPWindowCongestionOps( const TCPWindow_t * pxWindow )
+        {
+            const TCPCongestionOps_t * pxOps = pxWindow->pxCongestionOps;
+
+            if( pxOps == NULL )
+            {
+                pxOps = &( xTCPCongestionNewReno );
+            }
+
+            return pxOps;
+        }
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+
+/**
+ * @brief Set the initial values of cwnd and ssthresh, called when a window
+ *        gets initialised or when the MSS has been negotiated.
  *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
  */
-        int32_t lTCPWindowTxAdd( TCPWindow_t * pxWindow,
-                                 uint32_t ulLength,
-                                 int32_t lPosition,
-                                 int32_t lMax )
+        static void prvTCPWindowCongestionInit( TCPWindow_t * pxWindow )
         {
-            int32_t lBytesLeft = ( int32_t ) ulLength;
-            int32_t lToWrite;
-            int32_t lDone = 0;
-            int32_t lBufferIndex = lPosition;
-            TCPSegment_t * pxSegment = pxWindow->pxHeadSegment;
+            const TCPCongestionOps_t * pxOps = prvTCPWindowCongestionOps( pxWindow );
+            uint32_t ulMSS = ( uint32_t ) pxWindow->usMSS;
 
-            /* Puts a message in the Tx-window (after buffer size has been
-             * verified). */
-            if( ( pxSegment != NULL ) &&
-                ( pxSegment->lDataLength < pxSegment->lMaxLength ) &&
-                ( pxSegment->u.bits.bOutstanding == pdFALSE_UNSIGNED ) &&
-                ( pxSegment->lDataLength != 0 ) )
+            /* The initial window as defined in RFC 5681 section 3.1. */
+            if( ulMSS > 2190U )
             {
-                lToWrite = prvTCPWindowTxAdd_FrontSegment( pxWindow, pxSegment, lBytesLeft );
-                lBytesLeft -= lToWrite;
-                /* Increased the return value. */
-                lDone += lToWrite;
+                pxWindow->ulCongestionWindow = 2U * ulMSS;
+            }
+            else if( ulMSS > 1095U )
+            {
+                pxWindow->ulCongestionWindow = 3U * ulMSS;
+            }
+            else
+            {
+                pxWindow->ulCongestionWindow = 4U * ulMSS;
+            }
 
-                /* Calculate the next position in the circular data buffer, knowing
-                 * its maximum length 'lMax'. */
-                lBufferIndex = lTCPIncrementTxPosition( lBufferIndex, lMax, lToWrite );
+            /* ssthresh should start arbitrarily high.  More than the transmission
+             * window can never be outstanding, so that is used here. */
+            pxWindow->ulSlowStartThreshold = pxWindow->xSize.ulTxWindowLength;
+            pxWindow->ulRecoverSequenceNumber = pxWindow->tx.ulHighestSequenceNumber;
+            pxWindow->ulBytesAckedInAvoidance = 0U;
+            pxWindow->ulSackRetransmitCount = 0U;
+            pxWindow->u.bits.bFastRecovery = pdFALSE_UNSIGNED;
+
+            if( pxOps->fnInit != NULL )
+            {
+                pxOps->fnInit( pxWindow );
             }
+        }
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+/*-----------------------------------------------------------*/
 
-            while( lBytesLeft > 0 )
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+
+/**
+ * @brief The MSS of a window has been lowered, either by the MSS option of the
+ *        peer or to make room for the time-stamp option.  As long as no data
+ *        has been sent, cwnd and ssthresh are calculated again for the new MSS.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ */
+        void vTCPWindowCongestionMSSChanged( TCPWindow_t * pxWindow )
+        {
+            /* tx.ulHighestSequenceNumber only advances when a data segment
+             * gets sent. */
+            if( pxWindow->tx.ulHighestSequenceNumber == pxWindow->tx.ulFirstSequenceNumber )
             {
-                /* The current transmission segment is full, create new segments as
-                 * needed. */
-                pxSegment = xTCPWindowTxNew( pxWindow, pxWindow->ulNextTxSequenceNumber, ( int32_t ) pxWindow->usMSS );
+                prvTCPWindowCongestionInit( pxWindow );
+            }
+        }
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+/*-----------------------------------------------------------*/
 
-                if( pxSegment != NULL )
-                {
-                    /* Store as many as needed, but no more than the maximum
-                     * (MSS). */
-                    lToWrite = FreeRTOS_min_int32( lBytesLeft, pxSegment->lMaxLength );
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
 
-                    pxSegment->lDataLength = lToWrite;
-                    pxSegment->lStreamPos = lBufferIndex;
-                    lBytesLeft -= lToWrite;
-                    lBufferIndex = lTCPIncrementTxPosition( lBufferIndex, lMax, lToWrite );
-                    pxWindow->ulNextTxSequenceNumber += ( uint32_t ) lToWrite;
-                    lDone += lToWrite;
+/**
+ * @brief New data has been acknowledged.  Handle the ACK as a full or a partial
+ *        acknowledgement while in fast recovery ( RFC 6582 ), otherwise let the
+ *        algorithm decide how much the congestion window grows.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulBytesAcked The number of bytes by which the left side of the
+ *                         transmission window has advanced.
+ */
+        static void prvTCPWindowCongestionOnAck( TCPWindow_t * pxWindow,
+                                                 uint32_t ulBytesAcked )
+        {
+            uint32_t ulMSS = ( uint32_t ) pxWindow->usMSS;
+            TCPSegment_t * pxSegment;
 
-                    /* Link this segment in the Tx-Queue. */
-                    vListInsertFifo( &( pxWindow->xTxQueue ), &( pxSegment->xQueueItem ) );
+            if( pxWindow->u.bits.bFastRecovery != pdFALSE_UNSIGNED )
+            {
+                if( xSequenceGreaterThanOrEqual( pxWindow->tx.ulCurrentSequenceNumber, pxWindow->ulRecoverSequenceNumber ) != pdFALSE )
+                {
+                    /* A full acknowledgement: all data that was outstanding when
+                     * fast recovery started has been acknowledged.  Deflate the
+                     * window to ssthresh and continue with congestion avoidance. */
+                    pxWindow->ulCongestionWindow = pxWindow->ulSlowStartThreshold;
+                    pxWindow->u.bits.bFastRecovery = pdFALSE_UNSIGNED;
+                    pxWindow->ulBytesAckedInAvoidance = 0U;
+                }
+                else
+                {
+                    /* A partial acknowledgement: the first unacknowledged segment
+                     * is also lost.  Retransmit it right away, instead of waiting
+                     * for 3 more duplicate ACKs or for a timeout. */
+                    pxSegment = xTCPWindowPeekHead( &( pxWindow->xTxSegments ) );
+
+                    if( ( pxSegment != NULL ) &&
+                        ( pxSegment->u.bits.bAcked == pdFALSE_UNSIGNED ) &&
+                        ( listLIST_ITEM_CONTAINER( &( pxSegment->xQueueItem ) ) == &( pxWindow->xWaitQueue ) ) )
+                    {
+                        ( void ) uxListRemove( &( pxSegment->xQueueItem ) );
+                        vListInsertFifo( &( pxWindow->xPriorityQueue ), &( pxSegment->xQueueItem ) );
+                    }
 
-                    /* Let 'pxHeadSegment' point to this segment if there is still
-                     * space. */
-                    if( pxSegment->lDataLength < pxSegment->lMaxLength )
+                    /* Deflate the window by the amount of new data acknowledged,
+                     * and add back one MSS if at least one MSS was acknowledged. */
+                    if( pxWindow->ulCongestionWindow > ulBytesAcked )
                     {
-                        pxWindow->pxHeadSegment = pxSegment;
+                        pxWindow->ulCongestionWindow -= ulBytesAcked;
                     }
                     else
                     {
-                        pxWindow->pxHeadSegment = NULL;
+                        pxWindow->ulCongestionWindow = 0U;
                     }
-                }
-                else
-                {
-                    /* A sever situation: running out of segments for transmission.
-                     * No more data can be sent at the moment. */
-                    if( lDone != 0 )
+
+                    if( ulBytesAcked >= ulMSS )
                     {
-                        FreeRTOS_debug_printf( ( "lTCPWindowTxAdd: Sorry all buffers full (cancel %d bytes)\n", ( int ) lBytesLeft ) );
+                        pxWindow->ulCongestionWindow += ulMSS;
                     }
-
-                    break;
                 }
             }
+            else
+            {
+                prvTCPWindowCongestionOps( pxWindow )->fnOnAck( pxWindow, ulBytesAcked );
+            }
 
-            return lDone;
+            /* More than the transmission window can never be outstanding, but
+             * the window should always allow one full segment. */
+            if( pxWindow->ulCongestionWindow > pxWindow->xSize.ulTxWindowLength )
+            {
+                pxWindow->ulCongestionWindow = pxWindow->xSize.ulTxWindowLength;
+            }
+
+            if( pxWindow->ulCongestionWindow < ulMSS )
+            {
+                pxWindow->ulCongestionWindow = ulMSS;
+            }
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
 
 /**
- * @brief Returns true if there are no more outstanding TX segments.
+ * @brief A SACK was received, which counts as a duplicate ACK.  When it caused
+ *        a fast retransmission, enter fast recovery.  When already in fast
+ *        recovery, inflate the congestion window by one MSS.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulRetransmitCount The number of segments that were just queued
+ *                              for a fast retransmission.
+ */
+        static void prvTCPWindowCongestionOnDupAck( TCPWindow_t * pxWindow,
+                                                    uint32_t ulRetransmitCount )
+        {
+            uint32_t ulMSS = ( uint32_t ) pxWindow->usMSS;
+
+            if( pxWindow->u.bits.bFastRecovery != pdFALSE_UNSIGNED )
+            {
+                /* Every duplicate ACK means that a segment has left the network. */
+                pxWindow->ulCongestionWindow += ulMSS;
+            }
+            else if( ( ulRetransmitCount != 0U ) &&
+                     ( xSequenceGreaterThan( pxWindow->tx.ulCurrentSequenceNumber, pxWindow->ulRecoverSequenceNumber ) != pdFALSE ) )
+            {
+                /* Only react once to losses within the same window of data:
+                 * the ACK must cover more than 'recover' ( RFC 6582 section 3.2 ).
+                 * The algorithm sets the new value of ssthresh. */
+                prvTCPWindowCongestionOps( pxWindow )->fnOnLoss( pxWindow );
+
+                pxWindow->ulCongestionWindow = pxWindow->ulSlowStartThreshold + ( 3U * ulMSS );
+                pxWindow->ulRecoverSequenceNumber = pxWindow->tx.ulHighestSequenceNumber;
+                pxWindow->ulBytesAckedInAvoidance = 0U;
+                pxWindow->u.bits.bFastRecovery = pdTRUE_UNSIGNED;
+
+                if( ( xTCPWindowLoggingLevel >= 1 ) && ( ipconfigTCP_MAY_LOG_PORT( pxWindow->usOurPortNumber ) ) )
+                {
+                    FreeRTOS_debug_printf( ( "prvTCPWindowCongestionOnDupAck[%u,%u]: fast recovery, ssthresh %u cwnd %u\n",
+                                             pxWindow->usPeerPortNumber,
+                                             pxWindow->usOurPortNumber,
+                                             ( unsigned ) pxWindow->ulSlowStartThreshold,
+                                             ( unsigned ) pxWindow->ulCongestionWindow ) );
+                }
+            }
+            else
+            {
+                /* Nothing to do. */
+            }
+        }
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+
+/**
+ * @brief The retransmission timer of an outstanding segment has expired.
+ *        Fall back to a congestion window of one MSS and restart slow start.
  *
  * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] xFirstTimeout pdTRUE when the segment had only been sent once.
+ *                          When a segment times out again, ssthresh is kept.
+ */
+        static void prvTCPWindowCongestionOnTimeout( TCPWindow_t * pxWindow,
+                                                     BaseType_t xFirstTimeout )
+        {
+            prvTCPWindowCongestionOps( pxWindow )->fnOnTimeout( pxWindow, xFirstTimeout );
+
+            /* The loss window is one MSS ( RFC 5681 section 3.1 ). */
+            pxWindow->ulCongestionWindow = ( uint32_t ) pxWindow->usMSS;
+            pxWindow->ulRecoverSequenceNumber = pxWindow->tx.ulHighestSequenceNumber;
+            pxWindow->ulBytesAckedInAvoidance = 0U;
+            pxWindow->u.bits.bFastRecovery = pdFALSE_UNSIGNED;
+        }
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+
+/**
+ * @brief Slow start, shared by all algorithms: grow cwnd by the number of
+ *        bytes acknowledged, but by at most one MSS for every ACK.
  *
- * @return pdTRUE if there are no more outstanding Tx segments, else pdFALSE.
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulBytesAcked The number of bytes that were acknowledged.
  */
-        BaseType_t xTCPWindowTxDone( const TCPWindow_t * pxWindow )
+        static void prvTCPWindowCongestionSlowStart( TCPWindow_t * pxWindow,
+                                                     uint32_t ulBytesAcked )
         {
-            return listLIST_IS_EMPTY( ( &pxWindow->xTxSegments ) );
+            uint32_t ulMSS = ( uint32_t ) pxWindow->usMSS;
+
+            if( ulBytesAcked < ulMSS )
+            {
+                pxWindow->ulCongestionWindow += ulBytesAcked;
+            }
+            else
+            {
+                pxWindow->ulCongestionWindow += ulMSS;
+            }
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
 
 /**
- * @brief Find out if the peer is able to receive more data.
+ * @brief NewReno: let cwnd grow with slow start below ssthresh, and with
+ *        congestion avoidance above it.
  *
  * @param[in] pxWindow The descriptor of the TCP sliding windows.
- * @param[in] ulWindowSize The number of bytes in this segment.
- *
- * @return True if the peer has space in it window to receive more data.
+ * @param[in] ulBytesAcked The number of bytes that were acknowledged.
  */
-        static BaseType_t prvTCPWindowTxHasSpace( TCPWindow_t const * pxWindow,
-                                                  uint32_t ulWindowSize )
+        static void prvTCPNewRenoOnAck( TCPWindow_t * pxWindow,
+                                        uint32_t ulBytesAcked )
         {
-            uint32_t ulTxOutstanding;
-            BaseType_t xHasSpace;
-            const TCPSegment_t * pxSegment;
-            uint32_t ulNettSize;
-
-            /* This function will look if there is new transmission data.  It will
-             * return true if there is data to be sent. */
-
-            pxSegment = xTCPWindowPeekHead( &( pxWindow->xTxQueue ) );
-
-            if( pxSegment == NULL )
+            if( pxWindow->ulCongestionWindow < pxWindow->ulSlowStartThreshold )
             {
-                xHasSpace = pdFALSE;
+                prvTCPWindowCongestionSlowStart( pxWindow, ulBytesAcked );
             }
             else
             {
-                /* How much data is outstanding, i.e. how much data has been sent
-                 * but not yet acknowledged ? */
-                if( pxWindow->tx.ulHighestSequenceNumber >= pxWindow->tx.ulCurrentSequenceNumber )
-                {
-                    ulTxOutstanding = pxWindow->tx.ulHighestSequenceNumber - pxWindow->tx.ulCurrentSequenceNumber;
-                }
-                else
-                {
-                    ulTxOutstanding = 0U;
-                }
-
-                /* Subtract this from the peer's space. */
-                ulNettSize = ulWindowSize - FreeRTOS_min_uint32( ulWindowSize, ulTxOutstanding );
-
-                /* See if the next segment may be sent. */
-                if( ulNettSize >= ( uint32_t ) pxSegment->lDataLength )
-                {
-                    xHasSpace = pdTRUE;
-                }
-                else
-                {
-                    xHasSpace = pdFALSE;
-                }
+                /* Congestion avoidance: grow by one MSS for every window's worth
+                 * of acknowledged data, i.e. by one MSS per round-trip. */
+                pxWindow->ulBytesAckedInAvoidance += ulBytesAcked;
 
-                /* If 'xHasSpace', it looks like the peer has at least space for 1
-                 * more new segment of size MSS.  xSize.ulTxWindowLength is the self-imposed
-                 * limitation of the transmission window (in case of many resends it
-                 * may be decreased). */
-                if( ( ulTxOutstanding != 0U ) &&
-                    ( pxWindow->xSize.ulTxWindowLength <
-                      ( ulTxOutstanding + ( ( uint32_t ) pxSegment->lDataLength ) ) ) )
+                if( pxWindow->ulBytesAckedInAvoidance >= pxWindow->ulCongestionWindow )
                 {
-                    xHasSpace = pdFALSE;
+                    pxWindow->ulBytesAckedInAvoidance -= pxWindow->ulCongestionWindow;
+                    pxWindow->ulCongestionWindow += ( uint32_t ) pxWindow->usMSS;
                 }
             }
-
-            return xHasSpace;
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
 
 /**
- * @brief Returns true if there is TX data that can be sent right now.
+ * @brief NewReno: a fast retransmission is about to start, set ssthresh to
+ *        half of the FlightSize.
  *
  * @param[in] pxWindow The descriptor of the TCP sliding windows.
- * @param[in] ulWindowSize The current size of the sliding RX window of the peer.
- * @param[out] pulDelay The delay before the packet may be sent.
- *
- * @return pdTRUE if there is Tx data that can be sent, else pdFALSE.
  */
-        BaseType_t xTCPWindowTxHasData( TCPWindow_t const * pxWindow,
-                                        uint32_t ulWindowSize,
-                                        TickType_t * pulDelay )
+        static void prvTCPNewRenoOnLoss( TCPWindow_t * pxWindow )
         {
-            TCPSegment_t const * pxSegment;
-            BaseType_t xReturn;
-            TickType_t ulAge, ulMaxAge;
+            pxWindow->ulSlowStartThreshold = prvTCPWindowCongestionThreshold( pxWindow );
+        }
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+/*-----------------------------------------------------------*/
 
-            *pulDelay = 0U;
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
 
-            if( listLIST_IS_EMPTY( &pxWindow->xPriorityQueue ) == pdFALSE )
+/**
+ * @brief NewReno: the retransmission timer has expired.  Set ssthresh to half
+ *        of the FlightSize, unless the same segment timed out before.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] xFirstTimeout pdTRUE when the segment had only been sent once.
+ */
+        static void prvTCPNewRenoOnTimeout( TCPWindow_t * pxWindow,
+                                            BaseType_t xFirstTimeout )
+        {
+            if( xFirstTimeout != pdFALSE )
             {
-                /* No need to look at retransmissions or new transmission as long as
-                 * there are priority segments.  *pulDelay equals zero, meaning it must
-                 * be sent out immediately. */
-                xReturn = pdTRUE;
+                pxWindow->ulSlowStartThreshold = prvTCPWindowCongestionThreshold( pxWindow );
             }
-            else
-            {
-                pxSegment = xTCPWindowPeekHead( &( pxWindow->xWaitQueue ) );
-
-                if( pxSegment != NULL )
-                {
-                    uint32_t ulSRTT = ( uint32_t ) pxWindow->lSRTT;
-
-                    /* There is an outstanding segment, see if it is time to resend
-                     * it. */
-                    ulAge = ulTimerGetAge( &pxSegment->xTransmitTimer );
+        }
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+/*-----------------------------------------------------------*/
 
-                    /* After a packet has been sent for the first time, it will wait
-                     * '1 * ulSRTT' ms for an ACK. A second time it will wait '2 * ulSRTT' ms,
-                     * each time doubling the time-out */
-                    ulMaxAge = ( ( uint32_t ) 1U << pxSegment->u.bits.ucTransmitCount );
-                    ulMaxAge *= ulSRTT;
+    #if ( ipconfigUSE_TCP_CUBIC == 1 )
 
-                    if( ulMaxAge > ulAge )
-                    {
-                        /* A segment must be sent after this amount of msecs */
-                        *pulDelay = ulMaxAge - ulAge;
-                    }
+/**
+ * @brief Calculate the integer cube root of a number, rounded down.
+ *
+ * @param[in] ulValue The number.
+ *
+ * @return The largest integer whose cube is not larger than ulValue.
+ */
+        static uint32_t prvTCPCubicRoot( uint32_t ulValue )
+        {
+            uint32_t ulRemainder = ulValue;
+            uint32_t ulRoot = 0U;
+            uint32_t ulTerm;
+            int32_t lShift;
+
+            /* Determine the root bit by bit, starting at the most significant
+             * bit.  Three bits of the value correspond to one bit of the root. */
+            for( lShift = 30; lShift >= 0; lShift -= 3 )
+            {
+                ulRoot = 2U * ulRoot;
+                ulTerm = ( 3U * ulRoot * ( ulRoot + 1U ) ) + 1U;
 
-                    xReturn = pdTRUE;
-                }
-                else
+                if( ( ulRemainder >> lShift ) >= ulTerm )
                 {
-                    /* No priority segment, no outstanding data, see if there is new
-                     * transmission data. */
-                    pxSegment = xTCPWindowPeekHead( &pxWindow->xTxQueue );
-
-                    /* See if it fits in the peer's reception window. */
-                    if( pxSegment == NULL )
-                    {
-                        xReturn = pdFALSE;
-                    }
-                    else if( prvTCPWindowTxHasSpace( pxWindow, ulWindowSize ) == pdFALSE )
-                    {
-                        /* Too many outstanding messages. */
-                        xReturn = pdFALSE;
-                    }
-                    else if( ( pxWindow->u.bits.bSendFullSize != pdFALSE_UNSIGNED ) &&
-                             ( pxSegment->lDataLength < pxSegment->lMaxLength ) )
-                    {
-                        /* 'bSendFullSize' is a special optimisation.  If true, the
-                         * driver will only sent completely filled packets (of MSS
-                         * bytes). */
-                        xReturn = pdFALSE;
-                    }
-                    else
-                    {
-                        xReturn = pdTRUE;
-                    }
+                    ulRemainder -= ulTerm << lShift;
+                    ulRoot++;
                 }
             }
 
-            return xReturn;
+            return ulRoot;
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ipconfigUSE_TCP_CUBIC == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_CUBIC == 1 )
 
 /**
- * @brief Three type of queues are used for transmission: priority, waiting, and
- *        the normal TX queue of unsent data.  Message in the waiting queue will
- *        be sent when their timer has expired.
+ * @brief CUBIC: congestion avoidance starts a new epoch.  Calculate K, the
+ *        time it will take to grow from the current cwnd to W_max again.
+ *
  * @param[in] pxWindow The descriptor of the TCP sliding windows.
  */
-        static TCPSegment_t * pxTCPWindowTx_GetWaitQueue( const TCPWindow_t * pxWindow )
+        static void prvTCPCubicStartEpoch( TCPWindow_t * pxWindow )
         {
-            TCPSegment_t * pxSegment = xTCPWindowPeekHead( &( pxWindow->xWaitQueue ) );
+            uint32_t ulMSS = ( uint32_t ) pxWindow->usMSS;
+            uint32_t ulWindow = pxWindow->ulCongestionWindow;
+            uint32_t ulDistance;
 
-            if( pxSegment != NULL )
-            {
-                /* Do check the timing. */
-                uint32_t ulMaxTime;
+            pxWindow->xCubic.xInEpoch = pdTRUE;
+            pxWindow->xCubic.uxEpochStart = xTaskGetTickCount();
+            pxWindow->xCubic.ulEstimate = ulWindow;
+            pxWindow->xCubic.ulEstimateAcked = 0U;
+            pxWindow->ulBytesAckedInAvoidance = 0U;
 
-                ulMaxTime = ( ( uint32_t ) 1U ) << pxSegment->u.bits.ucTransmitCount;
-                ulMaxTime *= ( uint32_t ) pxWindow->lSRTT;
+            if( pxWindow->xCubic.ulWMax > ulWindow )
+            {
+                /* K = cubic_root( ( W_max - cwnd ) / C ), with the distance
+                 * expressed in units of 1/256 MSS.  Limit the distance so
+                 * that the calculation fits in 32 bits. */
+                ulDistance = pxWindow->xCubic.ulWMax - ulWindow;
 
-                if( ulTimerGetAge( &pxSegment->xTransmitTimer ) > ulMaxTime )
+                if( ulDistance > ( 0xFFFFFFFFU >> 8 ) )
                 {
-                    /* A normal (non-fast) retransmission.  Move it from the
-                     * head of the waiting queue. */
-                    pxSegment = xTCPWindowGetHead( &( pxWindow->xWaitQueue ) );
-                    pxSegment->u.bits.ucDupAckCount = ( uint8_t ) pdFALSE_UNSIGNED;
-
-                    /* Some detailed logging. */
-                    if( ( xTCPWindowLoggingLevel != 0 ) && ( ipconfigTCP_MAY_LOG_PORT( pxWindow->usOurPortNumber ) ) )
-                    {
-                        FreeRTOS_debug_printf( ( "ulTCPWindowTxGet[%u,%u]: WaitQueue %d bytes for sequence number %u (0x%X)\n",
-                                                 pxWindow->usPeerPortNumber,
-                                                 pxWindow->usOurPortNumber,
-                                                 ( int ) pxSegment->lDataLength,
-                                                 ( unsigned ) ( pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
-                                                 ( unsigned ) pxSegment->ulSequenceNumber ) );
-                    }
+                    ulDistance = 0xFFFFFFFFU >> 8;
                 }
-                else
+
+                ulDistance = ( ulDistance << 8 ) / ulMSS;
+
+                if( ulDistance > ( 0xFFFFFFFFU / winCUBIC_K_FACTOR ) )
                 {
-                    pxSegment = NULL;
+                    ulDistance = 0xFFFFFFFFU / winCUBIC_K_FACTOR;
                 }
-            }
 
-            return pxSegment;
+                pxWindow->xCubic.ulK = prvTCPCubicRoot( ulDistance * winCUBIC_K_FACTOR );
+                pxWindow->xCubic.ulOrigin = pxWindow->xCubic.ulWMax;
+            }
+            else
+            {
+                /* Already beyond W_max: probe for more bandwidth right away. */
+                pxWindow->xCubic.ulK = 0U;
+                pxWindow->xCubic.ulOrigin = ulWindow;
+            }
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
-
+    #endif /* ipconfigUSE_TCP_CUBIC == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_CUBIC == 1 )
 
 /**
- * @brief See if there is a transmission in the normal TX queue. It is the
- *        first time these data are being sent. After sending they will move
- *        the waiting queue.
+ * @brief CUBIC: calculate W_cubic( t + RTT ), the size that cwnd should have
+ *        one round-trip from now: W_cubic( t ) = C * ( t - K )^3 + W_max.
+ *
  * @param[in] pxWindow The descriptor of the TCP sliding windows.
- * @param[in] ulWindowSize The available space that the peer has in his
- *                          reception window.
- * @return Either a segment that has to be sent, or NULL.
+ *
+ * @return The target value for cwnd in bytes.
  */
-        static TCPSegment_t * pxTCPWindowTx_GetTXQueue( TCPWindow_t * pxWindow,
-                                                        uint32_t ulWindowSize )
+        static uint32_t prvTCPCubicTarget( const TCPWindow_t * pxWindow )
         {
-            TCPSegment_t * pxSegment = xTCPWindowPeekHead( &( pxWindow->xTxQueue ) );
+            uint32_t ulMSS = ( uint32_t ) pxWindow->usMSS;
+            uint32_t ulElapsed = ( uint32_t ) pdTICKS_TO_MS( xTaskGetTickCount() - pxWindow->xCubic.uxEpochStart );
+            uint32_t ulRoundTrip = pxWindow->xCubic.ulMinRTT;
+            uint32_t ulTime;
+            uint32_t ulDistance;
+            uint32_t ulOffset;
+            uint32_t ulTarget;
+
+            if( ulRoundTrip == 0U )
+            {
+                /* No RTT has been measured yet, use the smoothed RTT. */
+                ulRoundTrip = ( uint32_t ) pxWindow->lSRTT;
+            }
 
-            if( pxSegment == NULL )
+            if( ulElapsed > winCUBIC_MAX_TIME_MS )
             {
-                /* No segments queued. */
+                ulElapsed = winCUBIC_MAX_TIME_MS;
             }
-            else if( ( pxWindow->u.bits.bSendFullSize != pdFALSE_UNSIGNED ) &&
-                     ( pxSegment->lDataLength < pxSegment->lMaxLength ) )
+
+            if( ulRoundTrip > winCUBIC_MAX_TIME_MS )
             {
-                /* A segment has been queued but the driver waits until it
-                 * has a full size of MSS. */
-                pxSegment = NULL;
+                ulRoundTrip = winCUBIC_MAX_TIME_MS;
             }
-            else if( prvTCPWindowTxHasSpace( pxWindow, ulWindowSize ) == pdFALSE )
+
+            ulTime = ( ( ulElapsed + ulRoundTrip ) * winCUBIC_TIME_UNITS ) / 1000U;
+
+            if( ulTime >= pxWindow->xCubic.ulK )
             {
-                /* Peer has no more space at this moment. */
-                pxSegment = NULL;
+                ulDistance = ulTime - pxWindow->xCubic.ulK;
             }
             else
             {
-                /* pxSegment was just obtained with a peek function,
-                 * now remove it from of the Tx queue. */
-                pxSegment = xTCPWindowGetHead( &( pxWindow->xTxQueue ) );
+                ulDistance = pxWindow->xCubic.ulK - ulTime;
+            }
 
-                /* Don't let pxHeadSegment point to this segment any more,
-                 * so no more data will be added. */
-                if( pxWindow->pxHeadSegment == pxSegment )
-                {
-                    pxWindow->pxHeadSegment = NULL;
-                }
+            if( ulDistance > winCUBIC_MAX_DISTANCE )
+            {
+                ulDistance = winCUBIC_MAX_DISTANCE;
+            }
 
-                /* pxWindow->tx.highest registers the highest sequence
-                 * number in our transmission window. */
-                pxWindow->tx.ulHighestSequenceNumber = pxSegment->ulSequenceNumber + ( ( uint32_t ) pxSegment->lDataLength );
+            ulOffset = ( ( ( ulDistance * ulDistance * ulDistance ) >> winCUBIC_C_SHIFT ) * ulMSS ) / winCUBIC_C_DIVISOR;
 
-                /* ...and more detailed logging */
-                if( ( xTCPWindowLoggingLevel >= 2 ) && ( ipconfigTCP_MAY_LOG_PORT( pxWindow->usOurPortNumber ) ) )
-                {
-                    FreeRTOS_debug_printf( ( "ulTCPWindowTxGet[%u,%u]: XmitQueue %d bytes for sequence number %u (ws %u)\n",
-                                             pxWindow->usPeerPortNumber,
-                                             pxWindow->usOurPortNumber,
-                                             ( int ) pxSegment->lDataLength,
-                                             ( unsigned ) ( pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
-                                             ( unsigned ) ulWindowSize ) );
-                }
+            if( ulTime >= pxWindow->xCubic.ulK )
+            {
+                /* The convex region: probe for more bandwidth. */
+                ulTarget = pxWindow->xCubic.ulOrigin + ulOffset;
+            }
+            else if( ulOffset < pxWindow->xCubic.ulOrigin )
+            {
+                /* The concave region: approach W_max carefully. */
+                ulTarget = pxWindow->xCubic.ulOrigin - ulOffset;
+            }
+            else
+            {
+                ulTarget = 0U;
             }
 
-            return pxSegment;
+            return ulTarget;
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ipconfigUSE_TCP_CUBIC == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_CUBIC == 1 )
 
 /**
- * @brief Get data that can be transmitted right now. There are three types of
- *        outstanding segments: Priority queue, Waiting queue, Normal TX queue.
+ * @brief CUBIC: reset the private state of the algorithm.
  *
  * @param[in] pxWindow The descriptor of the TCP sliding windows.
- * @param[in] ulWindowSize The current size of the sliding RX window of the peer.
- * @param[out] plPosition The index within the TX stream buffer of the first byte to be sent.
+ */
+        static void prvTCPCubicInit( TCPWindow_t * pxWindow )
+        {
+            ( void ) memset( &( pxWindow->xCubic ), 0, sizeof( pxWindow->xCubic ) );
+            pxWindow->xCubic.xInEpoch = pdFALSE;
+        }
+    #endif /* ipconfigUSE_TCP_CUBIC == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_CUBIC == 1 )
+
+/**
+ * @brief CUBIC: let cwnd grow with slow start below ssthresh.  Above it, let
+ *        cwnd follow the cubic function, but never let it grow slower than
+ *        NewReno would ( the Reno-friendly region ).
  *
- * @return The amount of data in bytes that can be transmitted right now.
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulBytesAcked The number of bytes that were acknowledged.
  */
-        uint32_t ulTCPWindowTxGet( TCPWindow_t * pxWindow,
-                                   uint32_t ulWindowSize,
-                                   int32_t * plPosition )
+        static void prvTCPCubicOnAck( TCPWindow_t * pxWindow,
+                                      uint32_t ulBytesAcked )
         {
-            TCPSegment_t * pxSegment;
-            uint32_t ulReturn = 0U;
-
-            /* Fetches data to be sent-out now.
-             *
-             * Priority messages: segments with a resend need no check current sliding
-             * window size. */
-            pxSegment = xTCPWindowGetHead( &( pxWindow->xPriorityQueue ) );
-            pxWindow->ulOurSequenceNumber = pxWindow->tx.ulHighestSequenceNumber;
+            uint32_t ulMSS = ( uint32_t ) pxWindow->usMSS;
+            uint32_t ulWindow = pxWindow->ulCongestionWindow;
+            uint32_t ulTarget;
+            uint32_t ulThreshold;
 
-            if( pxSegment != NULL )
+            if( ulWindow < pxWindow->ulSlowStartThreshold )
             {
-                /* There is a priority segment. It doesn't need any checking for
-                 * space or timeouts. */
-                if( xTCPWindowLoggingLevel != 0 )
-                {
-                    FreeRTOS_debug_printf( ( "ulTCPWindowTxGet[%u,%u]: PrioQueue %d bytes for sequence number %u (ws %u)\n",
-                                             pxWindow->usPeerPortNumber,
-                                             pxWindow->usOurPortNumber,
-                                             ( int ) pxSegment->lDataLength,
-                                             ( unsigned ) ( pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
-                                             ( unsigned ) ulWindowSize ) );
-                }
+                prvTCPWindowCongestionSlowStart( pxWindow, ulBytesAcked );
             }
             else
             {
-                /* Waiting messages: outstanding messages with a running timer
-                 * neither check peer's reception window size because these packets
-                 * have been sent earlier. */
-                pxSegment = pxTCPWindowTx_GetWaitQueue( pxWindow );
-
-                if( pxSegment == NULL )
+                if( pxWindow->xCubic.xInEpoch == pdFALSE )
                 {
-                    /* New messages: sent-out for the first time.  Check current
-                     * sliding window size of peer. */
-                    pxSegment = pxTCPWindowTx_GetTXQueue( pxWindow, ulWindowSize );
+                    prvTCPCubicStartEpoch( pxWindow );
                 }
-            }
-
-            /* See if it has already been determined to return 0. */
-            if( pxSegment != NULL )
-            {
-                configASSERT( listLIST_ITEM_CONTAINER( &( pxSegment->xQueueItem ) ) == NULL );
-
-                /* Now that the segment will be transmitted, add it to the tail of
-                 * the waiting queue. */
-                vListInsertFifo( &pxWindow->xWaitQueue, &pxSegment->xQueueItem );
-
-                /* And mark it as outstanding. */
-                pxSegment->u.bits.bOutstanding = pdTRUE_UNSIGNED;
 
-                /* Administer the transmit count, needed for fast
-                 * retransmissions. */
-                ( pxSegment->u.bits.ucTransmitCount )++;
+                /* Do not let cwnd grow by more than 50% per round-trip. */
+                ulTarget = prvTCPCubicTarget( pxWindow );
 
-                /* If there have been several retransmissions (4), decrease the
-                 * size of the transmission window to at most 2 times MSS. */
-                if( ( pxSegment->u.bits.ucTransmitCount == MAX_TRANSMIT_COUNT_USING_LARGE_WINDOW ) &&
-                    ( pxWindow->xSize.ulTxWindowLength > ( 2U * ( ( uint32_t ) pxWindow->usMSS ) ) ) )
+                if( ulTarget > ( ulWindow + ( ulWindow / 2U ) ) )
                 {
-                    uint16_t usMSS2 = ( uint16_t ) ( pxWindow->usMSS * 2U );
-                    FreeRTOS_debug_printf( ( "ulTCPWindowTxGet[%u - %u]: Change Tx window: %u -> %u\n",
-                                             pxWindow->usPeerPortNumber,
-                                             pxWindow->usOurPortNumber,
-                                             ( unsigned ) pxWindow->xSize.ulTxWindowLength,
-                                             usMSS2 ) );
-                    pxWindow->xSize.ulTxWindowLength = usMSS2;
+                    ulTarget = ulWindow + ( ulWindow / 2U );
                 }
 
-                /* Clear the transmit timer. */
-                vTCPTimerSet( &( pxSegment->xTransmitTimer ) );
+                if( ulTarget > ulWindow )
+                {
+                    /* Grow by ( target - cwnd ) / cwnd MSS for every MSS that is
+                     * acknowledged, i.e. by one MSS for every 'cwnd / ( target - cwnd )'
+                     * segments.  Below the target, cwnd does not change. */
+                    ulThreshold = ( ulWindow / ( ulTarget - ulWindow ) ) * ulMSS;
+                    pxWindow->ulBytesAckedInAvoidance += ulBytesAcked;
 
-                pxWindow->ulOurSequenceNumber = pxSegment->ulSequenceNumber;
+                    if( pxWindow->ulBytesAckedInAvoidance >= ulThreshold )
+                    {
+                        pxWindow->ulBytesAckedInAvoidance -= ulThreshold;
+                        pxWindow->ulCongestionWindow += ulMSS;
+                    }
+                }
 
-                /* Inform the caller where to find the data within the queue. */
-                *plPosition = pxSegment->lStreamPos;
+                /* W_est grows by alpha_cubic = 3 * ( 1 - beta ) / ( 1 + beta ) = 9/17
+                 * MSS per round-trip, as NewReno would with the same beta. */
+                pxWindow->xCubic.ulEstimateAcked += ulBytesAcked;
+                ulThreshold = ( ulWindow / 9U ) * 17U;
 
-                /* And return the length of the data segment */
-                ulReturn = ( uint32_t ) pxSegment->lDataLength;
-            }
+                if( pxWindow->xCubic.ulEstimateAcked >= ulThreshold )
+                {
+                    pxWindow->xCubic.ulEstimateAcked -= ulThreshold;
+                    pxWindow->xCubic.ulEstimate += ulMSS;
+                }
 
-            return ulReturn;
+                if( pxWindow->xCubic.ulEstimate > pxWindow->ulCongestionWindow )
+                {
+                    pxWindow->ulCongestionWindow = pxWindow->xCubic.ulEstimate;
+                }
+            }
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ipconfigUSE_TCP_CUBIC == 1 */
 /*-----------------------------------------------------------*/
 
-    #if ( ipconfigUSE_TCP_WIN == 1 )
+    #if ( ipconfigUSE_TCP_CUBIC == 1 )
 
 /**
- * @brief Data has been sent, and an ACK has been received. Make an estimate
- *        of the round-trip time, and calculate the new timeout for transmissions.
- *        More explanation in a comment here below.
+ * @brief CUBIC: a fast retransmission is about to start.  Remember W_max and
+ *        set ssthresh to beta_cubic times cwnd.
  *
  * @param[in] pxWindow The descriptor of the TCP sliding windows.
- * @param[in] pxSegment The segment that was just acknowledged.
  */
-        static void prvTCPWindowTxCheckAck_CalcSRTT( TCPWindow_t * pxWindow,
-                                                     const TCPSegment_t * pxSegment )
+        static void prvTCPCubicOnLoss( TCPWindow_t * pxWindow )
         {
-            int32_t mS = ( int32_t ) ulTimerGetAge( &( pxSegment->xTransmitTimer ) );
-            int32_t lSum = 0;
-            int32_t lWeight = 0;
-            int32_t lDivisor = 0;
+            uint32_t ulWindow = pxWindow->ulCongestionWindow;
+            uint32_t ulMinimum = 2U * ( ( uint32_t ) pxWindow->usMSS );
 
-            mS = ( mS < 0 ) ? ipINT32_MAX_VALUE : mS;
+            pxWindow->xCubic.xInEpoch = pdFALSE;
 
-            if( pxWindow->lSRTT >= mS )
+            /* Fast convergence: when cwnd did not get back to the previous W_max,
+             * another flow is probably competing.  Release some bandwidth by
+             * aiming lower: W_max = cwnd * ( 1 + beta ) / 2. */
+            if( ulWindow < pxWindow->xCubic.ulLastWMax )
             {
-                /* RTT becomes smaller: adapt slowly. */
-                lWeight = winSRTT_DECREMENT_CURRENT;
-                lDivisor = winSRTT_DECREMENT_NEW + winSRTT_DECREMENT_CURRENT;
-                mS = FreeRTOS_multiply_int32( mS,
-                                              winSRTT_DECREMENT_NEW );
+                pxWindow->xCubic.ulWMax = ( ulWindow / ( 2U * winCUBIC_BETA_DENOMINATOR ) ) *
+                                          ( winCUBIC_BETA_DENOMINATOR + winCUBIC_BETA_NUMERATOR );
             }
             else
             {
-                /* RTT becomes larger: adapt quicker */
-                lWeight = winSRTT_INCREMENT_CURRENT;
-                lDivisor = winSRTT_INCREMENT_NEW + winSRTT_INCREMENT_CURRENT;
-                mS = FreeRTOS_multiply_int32( mS,
-                                              winSRTT_INCREMENT_NEW );
+                pxWindow->xCubic.ulWMax = ulWindow;
             }
 
-            lSum = FreeRTOS_multiply_int32( pxWindow->lSRTT, lWeight );
-            lSum = FreeRTOS_add_int32( lSum, mS );
-            pxWindow->lSRTT = lSum / lDivisor;
+            pxWindow->xCubic.ulLastWMax = ulWindow;
 
-            /* Cap to the minimum of 50ms. */
-            if( pxWindow->lSRTT < winSRTT_CAP_mS )
+            pxWindow->ulSlowStartThreshold = ( ulWindow / winCUBIC_BETA_DENOMINATOR ) * winCUBIC_BETA_NUMERATOR;
+
+            if( pxWindow->ulSlowStartThreshold < ulMinimum )
             {
-                pxWindow->lSRTT = winSRTT_CAP_mS;
+                pxWindow->ulSlowStartThreshold = ulMinimum;
             }
         }
-    #endif /* ipconfigUSE_TCP_WIN == 1 */
+    #endif /* ipconfigUSE_TCP_CUBIC == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_CUBIC == 1 )
+
+/**
+ * @brief CUBIC: the retransmission timer has expired.  Handle it as a loss,
+ *        unless the same segment timed out before.  A new epoch will start
+ *        when slow start reaches ssthresh.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] xFirstTimeout pdTRUE when the segment had only been sent once.
+ */
+        static void prvTCPCubicOnTimeout( TCPWindow_t * pxWindow,
+                                          BaseType_t xFirstTimeout )
+        {
+            if( xFirstTimeout != pdFALSE )
+            {
+                prvTCPCubicOnLoss( pxWindow );
+            }
+
+            pxWindow->xCubic.xInEpoch = pdFALSE;
+        }
+    #endif /* ipconfigUSE_TCP_CUBIC == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_CUBIC == 1 )
+
+/**
+ * @brief CUBIC: a round-trip time has been measured, remember the lowest one.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ * @param[in] ulRoundTripTime The round-trip time in ms.
+ */
+        static void prvTCPCubicOnRTTSample( TCPWindow_t * pxWindow,
+                                            uint32_t ulRoundTripTime )
+        {
+            if( ( pxWindow->xCubic.ulMinRTT == 0U ) || ( ulRoundTripTime < pxWindow->xCubic.ulMinRTT ) )
+            {
+                pxWindow->xCubic.ulMinRTT = ulRoundTripTime;
+            }
+        }
+    #endif /* ipconfigUSE_TCP_CUBIC == 1 */
 /*-----------------------------------------------------------*/
 
     #if ( ipconfigUSE_TCP_WIN == 1 )
@@ -1988,7 +3709,25 @@
              * A Smoothed RTT will increase quickly, but it is conservative when
              * becoming smaller. */
 
-            pxIterator = listGET_NEXT( pxEnd );
+            #if ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+            {
+                /* Use the index to skip all segments below 'ulFirst'. */
+                pxSegment = prvTCPWindowIndexLowerBound( pxWindow->pxTxSegmentIndex, ulFirst );
+
+                if( pxSegment != NULL )
+                {
+                    pxIterator = &( pxSegment->xSegmentItem );
+                }
+                else
+                {
+                    pxIterator = pxEnd;
+                }
+            }
+            #else
+            {
+                pxIterator = listGET_NEXT( pxEnd );
+            }
+            #endif
 
             while( ( pxIterator != pxEnd ) && ( xSequenceLessThan( ulSequenceNumber, ulLast ) != 0 ) )
             {
@@ -2047,7 +3786,19 @@
                     if( ( pxSegment->u.bits.ucTransmitCount == 1U ) &&
                         ( ( pxSegment->ulSequenceNumber + ulDataLength ) == ulLast ) )
                     {
-                        prvTCPWindowTxCheckAck_CalcSRTT( pxWindow, pxSegment );
+                        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                        {
+                            /* With time-stamps, ulTCPWindowTxAck() takes the sample from TSecr. */
+                            if( pxWindow->xTimeStamps.xReceived == pdFALSE )
+                            {
+                                prvTCPWindowTxCheckAck_CalcSRTT( pxWindow, pxSegment );
+                            }
+                        }
+                        #else
+                        {
+                            prvTCPWindowTxCheckAck_CalcSRTT( pxWindow, pxSegment );
+                        }
+                        #endif
                     }
 
                     /* Unlink it from the 3 queues, but do not destroy it (yet). */
@@ -2074,7 +3825,7 @@
                     ulBytesConfirmed += ulDataLength;
 
                     /* All segments below tx.ulCurrentSequenceNumber may be freed. */
-                    vTCPWindowFree( pxSegment );
+                    prvTCPWindowRelease( pxWindow, pxSegment );
 
                     /* No need to unlink it any more. */
                     xDoUnlink = pdFALSE;
@@ -2089,6 +3840,16 @@
                 ulSequenceNumber += ulDataLength;
             }
 
+            #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+            {
+                if( ulBytesConfirmed != 0U )
+                {
+                    /* The left side of the transmission window has advanced. */
+                    prvTCPWindowCongestionOnAck( pxWindow, ulBytesConfirmed );
+                }
+            }
+            #endif
+
             return ulBytesConfirmed;
         }
     #endif /* ipconfigUSE_TCP_WIN == 1 */
@@ -2170,6 +3931,101 @@
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_SACK_SCOREBOARD == 1 )
+
+/**
+ * @brief Loss detection based on the SACK scoreboard ( RFC 6675 ).  The list
+ *        'xTxSegments' is sorted by sequence number, and every segment that
+ *        was SACK'd by the peer has its 'bAcked' flag set.  An outstanding
+ *        segment is considered lost when either DupThresh ( 3 ) SACK'd
+ *        segments, or more than ( DupThresh - 1 ) * MSS SACK'd bytes have a
+ *        higher sequence number ( IsLost() ).  All lost segments are moved to
+ *        the priority queue at once, so that every hole in the window gets
+ *        repaired within the same round trip.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ *
+ * @return The number of segments that were found lost and will be retransmitted.
+ */
+        static uint32_t prvTCPWindowSackScoreboard( TCPWindow_t * pxWindow )
+        {
+            const ListItem_t * pxIterator;
+            const ListItem_t * pxEnd;
+            TCPSegment_t * pxSegment;
+            uint32_t ulSackedCount = 0U;
+            uint32_t ulSackedBytes = 0U;
+            uint32_t ulCount = 0U;
+            const uint32_t ulLostBytes = ( DUPLICATE_ACKS_BEFORE_FAST_RETRANSMIT - 1U ) * ( uint32_t ) pxWindow->usMSS;
+
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+/* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            pxEnd = ( ( const ListItem_t * ) &( pxWindow->xTxSegments.xListEnd ) );
+
+            /* First count all segments that were SACK'd. */
+            for( pxIterator = listGET_NEXT( pxEnd ); pxIterator != pxEnd; pxIterator = listGET_NEXT( pxIterator ) )
+            {
+                pxSegment = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+                if( pxSegment->u.bits.bAcked != pdFALSE_UNSIGNED )
+                {
+                    ulSackedCount++;
+                    ulSackedBytes += ( uint32_t ) pxSegment->lDataLength;
+                }
+            }
+
+            /* Now walk from low to high sequence numbers.  The amount of SACK'd
+             * data above the current segment can only decrease, so the walk can
+             * stop as soon as a segment does not qualify as lost. */
+            pxIterator = listGET_NEXT( pxEnd );
+
+            while( ( pxIterator != pxEnd ) &&
+                   ( ( ulSackedCount >= DUPLICATE_ACKS_BEFORE_FAST_RETRANSMIT ) || ( ulSackedBytes > ulLostBytes ) ) )
+            {
+                pxSegment = ( ( TCPSegment_t * ) listGET_LIST_ITEM_OWNER( pxIterator ) );
+
+                /* Hop to the next item, the queue item of the current may get unlinked. */
+                pxIterator = listGET_NEXT( pxIterator );
+
+                if( pxSegment->u.bits.bAcked != pdFALSE_UNSIGNED )
+                {
+                    ulSackedCount--;
+                    ulSackedBytes -= ( uint32_t ) pxSegment->lDataLength;
+                }
+                else if( ( pxSegment->u.bits.bLost == pdFALSE_UNSIGNED ) &&
+                         ( listLIST_ITEM_CONTAINER( &( pxSegment->xQueueItem ) ) == &( pxWindow->xWaitQueue ) ) )
+                {
+                    /* The segment was sent, not SACK'd, and not yet marked as lost.
+                     * 'ucTransmitCount' is left as it is: the RTT will not be sampled
+                     * from the retransmission, and a next RTO will back off. */
+                    pxSegment->u.bits.bLost = pdTRUE_UNSIGNED;
+
+                    if( ( xTCPWindowLoggingLevel >= 0 ) && ( ipconfigTCP_MAY_LOG_PORT( pxWindow->usOurPortNumber ) ) )
+                    {
+                        FreeRTOS_debug_printf( ( "prvTCPWindowSackScoreboard: Requeue sequence number %u (%u SACK'd above)\n",
+                                                 ( unsigned ) ( pxSegment->ulSequenceNumber - pxWindow->tx.ulFirstSequenceNumber ),
+                                                 ( unsigned ) ulSackedCount ) );
+                    }
+
+                    /* Remove it from xWaitQueue. */
+                    ( void ) uxListRemove( &pxSegment->xQueueItem );
+
+                    /* Add this segment to the priority queue so it gets
+                     * retransmitted immediately, the lowest hole first. */
+                    vListInsertFifo( &( pxWindow->xPriorityQueue ), &( pxSegment->xQueueItem ) );
+                    ulCount++;
+                }
+                else
+                {
+                    /* Already queued for retransmission, or not sent yet. */
+                }
+            }
+
+            return ulCount;
+        }
+    #endif /* ipconfigUSE_TCP_SACK_SCOREBOARD == 1 */
+/*-----------------------------------------------------------*/
+
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
@@ -2197,6 +4053,15 @@
             else
             {
                 ulReturn = prvTCPWindowTxCheckAck( pxWindow, ulFirstSequence, ulSequenceNumber );
+
+                #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                {
+                    if( ( ulReturn != 0U ) && ( pxWindow->xTimeStamps.xReceived != pdFALSE ) )
+                    {
+                        prvTCPWindowTimestampRTT( pxWindow );
+                    }
+                }
+                #endif
             }
 
             return ulReturn;
@@ -2204,6 +4069,59 @@
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/**
+ * @brief Get the clock that is sent out as TSval. It counts milliseconds,
+ *        which is well within the range of 1 ms to 1 second per tick that
+ *        RFC 7323 recommends.
+ *
+ * The clock adds the ticks that passed since the previous call. Converting
+ * the tick count itself would make TSval jump backwards when the tick count
+ * wraps, unless ms and ticks have the same size.
+ *
+ * @return The current time in ms.
+ */
+        uint32_t ulTCPWindowTimestamp( void )
+        {
+            TickType_t xNow = xTaskGetTickCount();
+            uint64_t ullElapsed;
+
+            /* The unsigned subtraction also works across a wrap of the tick count. */
+            ullElapsed = ( ( ( uint64_t ) ( xNow - xTimestampLastTick ) ) * 1000U ) + ulTimestampRemainder;
+            xTimestampLastTick = xNow;
+
+            ulTimestampMS += ( uint32_t ) ( ullElapsed / ( uint64_t ) configTICK_RATE_HZ );
+            ulTimestampRemainder = ( uint32_t ) ( ullElapsed % ( uint64_t ) configTICK_RATE_HZ );
+
+            return ulTimestampMS;
+        }
+    #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+/*-----------------------------------------------------------*/
+
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/**
+ * @brief An ACK that confirms new data carries a time-stamp option. TSecr
+ *        holds the time at which the acknowledged segment was sent, so every
+ *        such ACK yields an RTT sample, also after a retransmission
+ *        ( RFC 7323 section 4 ).
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ */
+        static void prvTCPWindowTimestampRTT( TCPWindow_t * pxWindow )
+        {
+            int32_t mS = ( int32_t ) ( ulTCPWindowTimestamp() - pxWindow->xTimeStamps.ulTSEcho );
+
+            /* A TSecr from the future is not a valid measurement. */
+            if( mS >= 0 )
+            {
+                prvTCPWindowUpdateSRTT( pxWindow, mS );
+            }
+        }
+    #endif /* ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 */
+/*-----------------------------------------------------------*/
+
     #if ( ipconfigUSE_TCP_WIN == 1 )
 
 /**
@@ -2221,11 +4139,33 @@
                                     uint32_t ulLast )
         {
             uint32_t ulAckCount;
+            uint32_t ulRetransmitCount;
             uint32_t ulCurrentSequenceNumber = pxWindow->tx.ulCurrentSequenceNumber;
 
             /* Receive a SACK option. */
             ulAckCount = prvTCPWindowTxCheckAck( pxWindow, ulFirst, ulLast );
-            ( void ) prvTCPWindowFastRetransmit( pxWindow, ulFirst );
+
+            #if ( ipconfigUSE_TCP_SACK_SCOREBOARD == 1 )
+            {
+                ulRetransmitCount = prvTCPWindowSackScoreboard( pxWindow );
+            }
+            #else
+            {
+                ulRetransmitCount = prvTCPWindowFastRetransmit( pxWindow, ulFirst );
+            }
+            #endif
+
+            #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+            {
+                /* An ACK may carry several SACK blocks. Congestion control
+                 * is informed once, by vTCPWindowTxSackDone(). */
+                pxWindow->ulSackRetransmitCount += ulRetransmitCount;
+            }
+            #else
+            {
+                ( void ) ulRetransmitCount;
+            }
+            #endif
 
             if( ( xTCPWindowLoggingLevel >= 1 ) && ( xSequenceGreaterThan( ulFirst, ulCurrentSequenceNumber ) != pdFALSE ) )
             {
@@ -2242,4 +4182,22 @@
     #endif /* ipconfigUSE_TCP_WIN == 1 */
 /*-----------------------------------------------------------*/
 
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+
+/**
+ * @brief All SACK blocks of an incoming ACK have been passed to
+ *        ulTCPWindowTxSack().  Let congestion control react to the ACK as a
+ *        single duplicate ACK, with the total number of segments that were
+ *        queued for a fast retransmission.
+ *
+ * @param[in] pxWindow The descriptor of the TCP sliding windows.
+ */
+        void vTCPWindowTxSackDone( TCPWindow_t * pxWindow )
+        {
+            prvTCPWindowCongestionOnDupAck( pxWindow, pxWindow->ulSackRetransmitCount );
+            pxWindow->ulSackRetransmitCount = 0U;
+        }
+    #endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+/*-----------------------------------------------------------*/
+
 #endif /* ipconfigUSE_TCP == 1 */
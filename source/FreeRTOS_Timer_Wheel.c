@@ -0,0 +1,447 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @file FreeRTOS_Timer_Wheel.c
+ * @brief A hierarchical timer wheel, used to schedule the TCP socket timers
+ *        when ipconfigUSE_TCP_TIMER_WHEEL is enabled.
+ *
+ * A timer that expires 'd' ticks after the current time of the wheel is
+ * stored in the lowest level 'n' for which d < ipTIMER_WHEEL_SLOTS^(n+1), in
+ * the slot selected by bits 5n .. 5n+4 of its expiry time. So level 0 holds
+ * the timers of the next 32 ticks, one slot per tick.
+ * When the current time reaches a multiple of 32^n, the slot of level n that
+ * starts at that time is emptied, and its timers are placed again, now in a
+ * lower level. The bit-masks 'ulOccupied' make it possible to find the next
+ * time at which something has to be done without visiting the timers.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "FreeRTOS_Timer_Wheel.h"
+
+#if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TIMER_WHEEL != 0 ) )
+
+/** @brief The mask to get a slot index from a time. */
+    #define twSLOT_MASK      ( ( TickType_t ) ipTIMER_WHEEL_SLOTS - 1U )
+
+/** @brief The largest delay that can be stored, longer delays are truncated. */
+    #define twMAX_DELAY      ( ( ( TickType_t ) 1U << ( ipTIMER_WHEEL_SLOT_BITS * ipTIMER_WHEEL_LEVELS ) ) - 1U )
+
+/** @brief A difference between two times that is at least this big, is
+ *         considered to be negative. */
+    #define twHALF_RANGE     ( ( portMAX_DELAY >> 1 ) + 1U )
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Store an entry in the slot that corresponds with its expiry time.
+ */
+    static void prvTimerWheelPlace( TimerWheel_t * pxWheel,
+                                    TimerWheelEntry_t * pxEntry );
+
+/*
+ * Take an entry out of its slot.
+ */
+    static void prvTimerWheelUnlink( TimerWheel_t * pxWheel,
+                                     TimerWheelEntry_t * pxEntry );
+
+/*
+ * Move the timers of the higher level slots that start at the current time
+ * to the lower levels.
+ */
+    static void prvTimerWheelCascade( TimerWheel_t * pxWheel );
+
+/*
+ * Return the index of the first bit in 'ulBits' at or above 'uxFrom', or
+ * ipTIMER_WHEEL_SLOTS when there is none.
+ */
+    static UBaseType_t prvNextOccupied( uint32_t ulBits,
+                                        UBaseType_t uxFrom );
+
+/*
+ * Return the number of ticks after the current time of the wheel at which
+ * the first timer expires, or at which the first cascade with timers occurs.
+ */
+    static TickType_t prvTimerWheelNextEvent( const TimerWheel_t * pxWheel );
+
+/*-----------------------------------------------------------*/
+
+    static UBaseType_t prvNextOccupied( uint32_t ulBits,
+                                        UBaseType_t uxFrom )
+    {
+        UBaseType_t uxIndex;
+
+        for( uxIndex = uxFrom; uxIndex < ( UBaseType_t ) ipTIMER_WHEEL_SLOTS; uxIndex++ )
+        {
+            if( ( ulBits & ( ( uint32_t ) 1U << uxIndex ) ) != 0U )
+            {
+                break;
+            }
+        }
+
+        return uxIndex;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvTimerWheelPlace( TimerWheel_t * pxWheel,
+                                    TimerWheelEntry_t * pxEntry )
+    {
+        TickType_t xDelay = pxEntry->xExpiryTime - pxWheel->xCurrentTime;
+        UBaseType_t uxLevel = 0U;
+        UBaseType_t uxIndex;
+
+        /* Find the lowest level that covers the delay. */
+        while( ( uxLevel < ( ( UBaseType_t ) ipTIMER_WHEEL_LEVELS - 1U ) ) &&
+               ( ( xDelay >> ( ( uxLevel + 1U ) * ipTIMER_WHEEL_SLOT_BITS ) ) != 0U ) )
+        {
+            uxLevel++;
+        }
+
+        uxIndex = ( UBaseType_t ) ( ( pxEntry->xExpiryTime >> ( uxLevel * ipTIMER_WHEEL_SLOT_BITS ) ) & twSLOT_MASK );
+        pxWheel->ulOccupied[ uxLevel ] |= ( uint32_t ) 1U << uxIndex;
+        uxIndex += uxLevel * ( UBaseType_t ) ipTIMER_WHEEL_SLOTS;
+
+        pxEntry->pxPrevious = NULL;
+        pxEntry->pxNext = pxWheel->pxSlots[ uxIndex ];
+
+        if( pxEntry->pxNext != NULL )
+        {
+            pxEntry->pxNext->pxPrevious = pxEntry;
+        }
+
+        pxWheel->pxSlots[ uxIndex ] = pxEntry;
+        pxEntry->uxSlot = uxIndex + 1U;
+        pxWheel->uxCount++;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvTimerWheelUnlink( TimerWheel_t * pxWheel,
+                                     TimerWheelEntry_t * pxEntry )
+    {
+        UBaseType_t uxIndex = pxEntry->uxSlot - 1U;
+
+        if( pxEntry->pxPrevious != NULL )
+        {
+            pxEntry->pxPrevious->pxNext = pxEntry->pxNext;
+        }
+        else
+        {
+            pxWheel->pxSlots[ uxIndex ] = pxEntry->pxNext;
+
+            if( pxEntry->pxNext == NULL )
+            {
+                /* The slot has become empty. */
+                pxWheel->ulOccupied[ uxIndex / ipTIMER_WHEEL_SLOTS ] &= ~( ( uint32_t ) 1U << ( uxIndex % ipTIMER_WHEEL_SLOTS ) );
+            }
+        }
+
+        if( pxEntry->pxNext != NULL )
+        {
+            pxEntry->pxNext->pxPrevious = pxEntry->pxPrevious;
+        }
+
+        pxEntry->pxNext = NULL;
+        pxEntry->pxPrevious = NULL;
+        pxEntry->uxSlot = 0U;
+        pxWheel->uxCount--;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvTimerWheelCascade( TimerWheel_t * pxWheel )
+    {
+        UBaseType_t uxLevel;
+        UBaseType_t uxIndex;
+        TimerWheelEntry_t * pxEntry;
+
+        for( uxLevel = 1U; uxLevel < ( UBaseType_t ) ipTIMER_WHEEL_LEVELS; uxLevel++ )
+        {
+            uxIndex = ( UBaseType_t ) ( ( pxWheel->xCurrentTime >> ( uxLevel * ipTIMER_WHEEL_SLOT_BITS ) ) & twSLOT_MASK );
+
+            /* Empty the slot, the timers are placed again relative to the
+             * current time, which puts them in a lower level. */
+            while( pxWheel->pxSlots[ ( uxLevel * ipTIMER_WHEEL_SLOTS ) + uxIndex ] != NULL )
+            {
+                pxEntry = pxWheel->pxSlots[ ( uxLevel * ipTIMER_WHEEL_SLOTS ) + uxIndex ];
+                prvTimerWheelUnlink( pxWheel, pxEntry );
+                prvTimerWheelPlace( pxWheel, pxEntry );
+            }
+
+            if( uxIndex != 0U )
+            {
+                /* The next level only starts a new slot when this level
+                 * has wrapped around. */
+                break;
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static TickType_t prvTimerWheelNextEvent( const TimerWheel_t * pxWheel )
+    {
+        TickType_t xBest = twMAX_DELAY;
+        TickType_t xDelay;
+        TickType_t xPeriod;
+        UBaseType_t uxLevel;
+        UBaseType_t uxIndex;
+        UBaseType_t uxNext;
+
+        /* In level 0, each slot is exactly one tick. A slot below the
+         * current slot belongs to the next round. */
+        if( pxWheel->ulOccupied[ 0 ] != 0U )
+        {
+            uxIndex = ( UBaseType_t ) ( pxWheel->xCurrentTime & twSLOT_MASK );
+            uxNext = prvNextOccupied( pxWheel->ulOccupied[ 0 ], uxIndex );
+
+            if( uxNext >= ( UBaseType_t ) ipTIMER_WHEEL_SLOTS )
+            {
+                uxNext = prvNextOccupied( pxWheel->ulOccupied[ 0 ], 0U ) + ( UBaseType_t ) ipTIMER_WHEEL_SLOTS;
+            }
+
+            xBest = ( TickType_t ) ( uxNext - uxIndex );
+        }
+
+        /* In the higher levels, the timers of a slot will be cascaded when
+         * the current time reaches the start of the slot. A slot with the
+         * same index as the current slot starts a full round later. */
+        for( uxLevel = 1U; uxLevel < ( UBaseType_t ) ipTIMER_WHEEL_LEVELS; uxLevel++ )
+        {
+            if( pxWheel->ulOccupied[ uxLevel ] != 0U )
+            {
+                uxIndex = ( UBaseType_t ) ( ( pxWheel->xCurrentTime >> ( uxLevel * ipTIMER_WHEEL_SLOT_BITS ) ) & twSLOT_MASK );
+                uxNext = prvNextOccupied( pxWheel->ulOccupied[ uxLevel ], uxIndex + 1U );
+
+                if( uxNext >= ( UBaseType_t ) ipTIMER_WHEEL_SLOTS )
+                {
+                    uxNext = prvNextOccupied( pxWheel->ulOccupied[ uxLevel ], 0U ) + ( UBaseType_t ) ipTIMER_WHEEL_SLOTS;
+                }
+
+                xPeriod = ( TickType_t ) 1U << ( uxLevel * ipTIMER_WHEEL_SLOT_BITS );
+                xDelay = ( ( ( pxWheel->xCurrentTime >> ( uxLevel * ipTIMER_WHEEL_SLOT_BITS ) ) + ( TickType_t ) ( uxNext - uxIndex ) ) * xPeriod ) -
+                         pxWheel->xCurrentTime;
+
+                if( xDelay < xBest )
+                {
+                    xBest = xDelay;
+                }
+            }
+        }
+
+        return xBest;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Initialise an empty timer wheel.
+ *
+ * @param[in] pxWheel The wheel to be initialised.
+ * @param[in] xNow The current tick count.
+ */
+    void vTimerWheelInit( TimerWheel_t * pxWheel,
+                          TickType_t xNow )
+    {
+        UBaseType_t uxIndex;
+
+        /* The wheel covers 2^20 ticks, which needs a 32-bit tick count. */
+        configASSERT( sizeof( TickType_t ) >= sizeof( uint32_t ) );
+
+        for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ( ipTIMER_WHEEL_LEVELS * ipTIMER_WHEEL_SLOTS ); uxIndex++ )
+        {
+            pxWheel->pxSlots[ uxIndex ] = NULL;
+        }
+
+        for( uxIndex = 0U; uxIndex < ( UBaseType_t ) ipTIMER_WHEEL_LEVELS; uxIndex++ )
+        {
+            pxWheel->ulOccupied[ uxIndex ] = 0U;
+        }
+
+        pxWheel->xCurrentTime = xNow;
+        pxWheel->uxCount = 0U;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Schedule a timer, or re-schedule it when it is already active.
+ *
+ * @param[in] pxWheel The timer wheel.
+ * @param[in] pxEntry The timer.
+ * @param[in] xExpiryTime The tick count at which the timer expires. A time
+ *                        before the current time of the wheel expires at
+ *                        the current time.
+ */
+    void vTimerWheelInsert( TimerWheel_t * pxWheel,
+                            TimerWheelEntry_t * pxEntry,
+                            TickType_t xExpiryTime )
+    {
+        TickType_t xDelay = xExpiryTime - pxWheel->xCurrentTime;
+
+        if( pxEntry->uxSlot != 0U )
+        {
+            prvTimerWheelUnlink( pxWheel, pxEntry );
+        }
+
+        if( xDelay >= ( TickType_t ) twHALF_RANGE )
+        {
+            /* The time lies in the past. */
+            xDelay = 0U;
+        }
+        else if( xDelay > twMAX_DELAY )
+        {
+            xDelay = twMAX_DELAY;
+        }
+        else
+        {
+            /* The delay can be stored as it is. */
+        }
+
+        pxEntry->xExpiryTime = pxWheel->xCurrentTime + xDelay;
+        prvTimerWheelPlace( pxWheel, pxEntry );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Cancel a timer.
+ *
+ * @param[in] pxWheel The timer wheel.
+ * @param[in] pxEntry The timer, it does not have to be active.
+ */
+    void vTimerWheelRemove( TimerWheel_t * pxWheel,
+                            TimerWheelEntry_t * pxEntry )
+    {
+        if( pxEntry->uxSlot != 0U )
+        {
+            prvTimerWheelUnlink( pxWheel, pxEntry );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Advance the wheel up to 'xNow', and return the next expired timer.
+ *
+ * @param[in] pxWheel The timer wheel.
+ * @param[in] xNow The current tick count.
+ *
+ * @return A timer that has expired and that is not active any more, or NULL
+ *         when there are no more expired timers.
+ */
+    TimerWheelEntry_t * pxTimerWheelNextExpired( TimerWheel_t * pxWheel,
+                                                 TickType_t xNow )
+    {
+        TimerWheelEntry_t * pxResult = NULL;
+        TickType_t xBehind;
+        TickType_t xStep;
+        UBaseType_t uxIndex;
+
+        for( ; ; )
+        {
+            uxIndex = ( UBaseType_t ) ( pxWheel->xCurrentTime & twSLOT_MASK );
+
+            if( pxWheel->pxSlots[ uxIndex ] != NULL )
+            {
+                /* All timers in this slot expire at the current time. */
+                pxResult = pxWheel->pxSlots[ uxIndex ];
+                prvTimerWheelUnlink( pxWheel, pxResult );
+                break;
+            }
+
+            xBehind = xNow - pxWheel->xCurrentTime;
+
+            if( ( xBehind == 0U ) || ( xBehind >= ( TickType_t ) twHALF_RANGE ) )
+            {
+                /* The wheel has caught up with the clock. */
+                break;
+            }
+
+            if( pxWheel->uxCount == 0U )
+            {
+                /* Nothing to do, jump to the current time. */
+                pxWheel->xCurrentTime = xNow;
+                break;
+            }
+
+            /* Skip the empty slots, but do not go beyond the clock. */
+            xStep = prvTimerWheelNextEvent( pxWheel );
+
+            if( xStep > xBehind )
+            {
+                xStep = xBehind;
+            }
+
+            pxWheel->xCurrentTime += xStep;
+
+            if( ( pxWheel->xCurrentTime & twSLOT_MASK ) == 0U )
+            {
+                prvTimerWheelCascade( pxWheel );
+            }
+        }
+
+        return pxResult;
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Find when the wheel needs attention again.
+ *
+ * @param[in] pxWheel The timer wheel.
+ * @param[in] xNow The current tick count.
+ *
+ * @return The number of clock ticks after 'xNow' at which a timer expires,
+ *         or at which timers must be cascaded. portMAX_DELAY when no timer
+ *         is active.
+ */
+    TickType_t xTimerWheelNextTimeout( const TimerWheel_t * pxWheel,
+                                       TickType_t xNow )
+    {
+        TickType_t xReturn = portMAX_DELAY;
+        TickType_t xDelay;
+
+        if( pxWheel->uxCount != 0U )
+        {
+            /* The time of the event, relative to 'xNow'. */
+            xDelay = ( pxWheel->xCurrentTime + prvTimerWheelNextEvent( pxWheel ) ) - xNow;
+
+            if( xDelay >= ( TickType_t ) twHALF_RANGE )
+            {
+                /* The event lies in the past. */
+                xDelay = 0U;
+            }
+
+            xReturn = xDelay;
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TIMER_WHEEL != 0 ) */
@@ -489,7 +489,7 @@
  *
  * @return Always returns a NULL.
  */
-        void vTCPWindowDestroy( const TCPWindow_t * pxWindow )
+        void vTCPWindowDestroy( TCPWindow_t * pxWindow )
         {
             /* As in tiny TCP there are no shared segments descriptors, there is
              * nothing to release. */
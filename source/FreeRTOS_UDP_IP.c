@@ -97,6 +97,52 @@ void vProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuff
 }
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+
+/**
+ * @brief Process the segments of a large UDP buffer, as generated by
+ *        FreeRTOS_sendto(). IPv4 segments are sent using the headers of the
+ *        first segment, other segments are processed one by one.
+ *
+ * @param[in] pxNetworkBuffer The first segment, the others are linked through
+ *                            'pxNextBuffer'.
+ */
+    void vProcessGeneratedUDPSegments( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+    {
+        const UDPPacket_t * pxUDPPacket;
+        NetworkBufferDescriptor_t * pxBuffer = pxNetworkBuffer;
+        NetworkBufferDescriptor_t * pxNextBuffer;
+
+        if( pxNetworkBuffer != NULL )
+        {
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            pxUDPPacket = ( ( UDPPacket_t * ) pxNetworkBuffer->pucEthernetBuffer );
+
+            #if ( ipconfigUSE_IPv4 != 0 )
+                if( pxUDPPacket->xEthernetHeader.usFrameType == ipIPv4_FRAME_TYPE )
+                {
+                    vProcessGeneratedUDPSegments_IPv4( pxNetworkBuffer );
+                }
+                else
+            #endif /* ( ipconfigUSE_IPv4 != 0 ) */
+            {
+                ( void ) pxUDPPacket;
+
+                while( pxBuffer != NULL )
+                {
+                    pxNextBuffer = pxBuffer->pxNextBuffer;
+                    pxBuffer->pxNextBuffer = NULL;
+                    vProcessGeneratedUDPPacket( pxBuffer );
+                    pxBuffer = pxNextBuffer;
+                }
+            }
+        }
+    }
+#endif /* ipconfigUSE_UDP_SEGMENTATION == 1 */
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Process the received UDP packet.
  *
@@ -64,6 +64,26 @@
     #if( ipconfigUSE_IPv4 != 0 )
 /* *INDENT-ON* */
 
+/* Send a generated UDP packet, followed by the other segments of a large UDP
+ * buffer, if any. */
+static void prvProcessGeneratedUDPPacket_IPv4( NetworkBufferDescriptor_t * const pxNetworkBuffer,
+                                               NetworkBufferDescriptor_t * pxSegments );
+
+#if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+/* Give the other segments the headers of the first segment. */
+    static void prvSegmentsCopyHeaders( const NetworkBufferDescriptor_t * pxFirstSegment,
+                                        NetworkBufferDescriptor_t * pxSegments );
+
+/* Pass the other segments to the network interface. */
+    static void prvSegmentsOutput( NetworkInterface_t * pxInterface,
+                                   NetworkBufferDescriptor_t * pxSegments );
+#endif /* ipconfigUSE_UDP_SEGMENTATION == 1 */
+
+#if ( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 )
+/* Pad a frame with zeros up to ipconfigETHERNET_MINIMUM_PACKET_BYTES. */
+    static void prvPadEthernetFrame( NetworkBufferDescriptor_t * pxNetworkBuffer );
+#endif
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -73,6 +93,23 @@
  * @param[in] pxNetworkBuffer The network buffer carrying the packet.
  */
 void vProcessGeneratedUDPPacket_IPv4( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+    prvProcessGeneratedUDPPacket_IPv4( pxNetworkBuffer, NULL );
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Process the generated UDP packet and do other checks before sending the
+ *        packet such as ARP cache check and address resolution.
+ *
+ * @param[in] pxNetworkBuffer The network buffer carrying the packet.
+ * @param[in] pxSegments The other segments of a large UDP buffer, linked
+ *                       through 'pxNextBuffer', or NULL.  They are sent
+ *                       with the headers of 'pxNetworkBuffer', or released
+ *                       when it can not be sent.
+ */
+static void prvProcessGeneratedUDPPacket_IPv4( NetworkBufferDescriptor_t * const pxNetworkBuffer,
+                                               NetworkBufferDescriptor_t * pxSegments )
 {
     UDPPacket_t * pxUDPPacket;
     IPHeader_t * pxIPHeader;
@@ -84,6 +121,13 @@ void vProcessGeneratedUDPPacket_IPv4( NetworkBufferDescriptor_t * const pxNetwor
     const void * pvCopySource;
     void * pvCopyDest;
 
+    #if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+        NetworkBufferDescriptor_t * pxUnsentSegments = pxSegments;
+        NetworkBufferDescriptor_t * pxBuffer;
+    #else
+        ( void ) pxSegments;
+    #endif
+
     /* Map the UDP packet onto the start of the frame. */
 
     /* MISRA Ref 11.3.1 [Misaligned access] */
@@ -307,26 +351,37 @@ void vProcessGeneratedUDPPacket_IPv4( NetworkBufferDescriptor_t * const pxNetwor
             EthernetHeader_t * pxEthernetHeader = ( ( EthernetHeader_t * ) pxNetworkBuffer->pucEthernetBuffer );
             ( void ) memcpy( pxEthernetHeader->xSourceAddress.ucBytes, pxNetworkBuffer->pxEndPoint->xMACAddress.ucBytes, ( size_t ) ipMAC_ADDRESS_LENGTH_BYTES );
 
-            #if ( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 )
+            #if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
             {
-                if( pxNetworkBuffer->xDataLength < ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES )
+                /* The headers are complete now, the other segments of a
+                 * large UDP buffer get a copy of them. */
+                if( eReturned == eResolutionCacheHit )
                 {
-                    BaseType_t xIndex;
-
-                    for( xIndex = ( BaseType_t ) pxNetworkBuffer->xDataLength; xIndex < ( BaseType_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES; xIndex++ )
-                    {
-                        pxNetworkBuffer->pucEthernetBuffer[ xIndex ] = 0U;
-                    }
-
-                    pxNetworkBuffer->xDataLength = ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES;
+                    prvSegmentsCopyHeaders( pxNetworkBuffer, pxSegments );
                 }
             }
+            #endif /* ipconfigUSE_UDP_SEGMENTATION == 1 */
+
+            #if ( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 )
+            {
+                prvPadEthernetFrame( pxNetworkBuffer );
+            }
             #endif /* if( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 ) */
             iptraceNETWORK_INTERFACE_OUTPUT( pxNetworkBuffer->xDataLength, pxNetworkBuffer->pucEthernetBuffer );
 
             if( ( pxInterface != NULL ) && ( pxInterface->pfOutput != NULL ) )
             {
                 ( void ) pxInterface->pfOutput( pxInterface, pxNetworkBuffer, pdTRUE );
+
+                #if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+                {
+                    if( eReturned == eResolutionCacheHit )
+                    {
+                        prvSegmentsOutput( pxInterface, pxSegments );
+                        pxUnsentSegments = NULL;
+                    }
+                }
+                #endif /* ipconfigUSE_UDP_SEGMENTATION == 1 */
             }
         }
         else
@@ -341,9 +396,162 @@ void vProcessGeneratedUDPPacket_IPv4( NetworkBufferDescriptor_t * const pxNetwor
          * packet. */
         vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
     }
+
+    #if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+    {
+        /* The first segment was not sent, or it has become an ARP request.
+         * The other segments are dropped with it. */
+        while( pxUnsentSegments != NULL )
+        {
+            pxBuffer = pxUnsentSegments;
+            pxUnsentSegments = pxBuffer->pxNextBuffer;
+            pxBuffer->pxNextBuffer = NULL;
+            vReleaseNetworkBufferAndDescriptor( pxBuffer );
+        }
+    }
+    #endif /* ipconfigUSE_UDP_SEGMENTATION == 1 */
 }
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 )
+
+/**
+ * @brief Pad a frame with zeros, when it is shorter than
+ *        ipconfigETHERNET_MINIMUM_PACKET_BYTES.
+ *
+ * @param[in] pxNetworkBuffer The network buffer carrying the frame.
+ */
+    static void prvPadEthernetFrame( NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        if( pxNetworkBuffer->xDataLength < ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES )
+        {
+            BaseType_t xIndex;
+
+            for( xIndex = ( BaseType_t ) pxNetworkBuffer->xDataLength; xIndex < ( BaseType_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES; xIndex++ )
+            {
+                pxNetworkBuffer->pucEthernetBuffer[ xIndex ] = 0U;
+            }
+
+            pxNetworkBuffer->xDataLength = ( size_t ) ipconfigETHERNET_MINIMUM_PACKET_BYTES;
+        }
+    }
+#endif /* if( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+
+/**
+ * @brief Send the segments of a large UDP buffer. The address of the
+ *        destination is resolved for the first segment only, the other
+ *        segments get a copy of its headers. FreeRTOS_sendto() has made
+ *        sure that the address was resolved. When the ARP entry has expired
+ *        in the meantime, the first segment becomes an ARP request and the
+ *        whole buffer is dropped, like a single datagram would be.
+ *
+ * @param[in] pxNetworkBuffer The first segment, the others are linked through
+ *                            'pxNextBuffer'.
+ */
+    void vProcessGeneratedUDPSegments_IPv4( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+    {
+        NetworkBufferDescriptor_t * pxSegments = pxNetworkBuffer->pxNextBuffer;
+
+        pxNetworkBuffer->pxNextBuffer = NULL;
+
+        prvProcessGeneratedUDPPacket_IPv4( pxNetworkBuffer, pxSegments );
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Copy the Ethernet, IP and UDP headers of the first segment to the
+ *        other segments, and set their lengths and checksums.
+ *
+ * @param[in] pxFirstSegment The first segment, its headers are complete.
+ * @param[in] pxSegments The other segments, linked through 'pxNextBuffer'.
+ */
+    static void prvSegmentsCopyHeaders( const NetworkBufferDescriptor_t * pxFirstSegment,
+                                        NetworkBufferDescriptor_t * pxSegments )
+    {
+        NetworkBufferDescriptor_t * pxBuffer;
+        UDPPacket_t * pxUDPPacket;
+        size_t uxPayloadSize;
+
+        #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+            uint8_t ucSocketOptions;
+        #endif
+
+        for( pxBuffer = pxSegments; pxBuffer != NULL; pxBuffer = pxBuffer->pxNextBuffer )
+        {
+            /* Save options now, as they will be overwritten by memcpy */
+            #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+            {
+                ucSocketOptions = pxBuffer->pucEthernetBuffer[ ipSOCKET_OPTIONS_OFFSET ];
+            }
+            #endif
+
+            uxPayloadSize = pxBuffer->xDataLength - sizeof( UDPPacket_t );
+            ( void ) memcpy( pxBuffer->pucEthernetBuffer, pxFirstSegment->pucEthernetBuffer, sizeof( UDPPacket_t ) );
+            pxBuffer->pxEndPoint = pxFirstSegment->pxEndPoint;
+
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            pxUDPPacket = ( ( UDPPacket_t * ) pxBuffer->pucEthernetBuffer );
+
+            pxUDPPacket->xUDPHeader.usLength = FreeRTOS_htons( ( uint16_t ) ( uxPayloadSize + sizeof( UDPHeader_t ) ) );
+            pxUDPPacket->xIPHeader.usLength = FreeRTOS_htons( ( uint16_t ) ( uxPayloadSize + sizeof( IPHeader_t ) + sizeof( UDPHeader_t ) ) );
+
+            #if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 )
+            {
+                pxUDPPacket->xIPHeader.usHeaderChecksum = 0U;
+                pxUDPPacket->xIPHeader.usHeaderChecksum = usGenerateChecksum( 0U, ( uint8_t * ) &( pxUDPPacket->xIPHeader.ucVersionHeaderLength ), uxIPHeaderSizePacket( pxBuffer ) );
+                pxUDPPacket->xIPHeader.usHeaderChecksum = ( uint16_t ) ~FreeRTOS_htons( pxUDPPacket->xIPHeader.usHeaderChecksum );
+
+                if( ( ucSocketOptions & ( uint8_t ) FREERTOS_SO_UDPCKSUM_OUT ) != 0U )
+                {
+                    ( void ) usGenerateProtocolChecksum( ( uint8_t * ) pxUDPPacket, pxBuffer->xDataLength, pdTRUE );
+                }
+                else
+                {
+                    pxUDPPacket->xUDPHeader.usChecksum = 0U;
+                }
+            }
+            #endif /* if ( ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM == 0 ) */
+        }
+    }
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Pass the other segments to the network interface, one after the
+ *        other, without returning to the IP-task in between.
+ *
+ * @param[in] pxInterface The interface that has sent the first segment.
+ * @param[in] pxSegments The other segments, linked through 'pxNextBuffer'.
+ */
+    static void prvSegmentsOutput( NetworkInterface_t * pxInterface,
+                                   NetworkBufferDescriptor_t * pxSegments )
+    {
+        NetworkBufferDescriptor_t * pxBuffer;
+        NetworkBufferDescriptor_t * pxNext = pxSegments;
+
+        while( pxNext != NULL )
+        {
+            pxBuffer = pxNext;
+            pxNext = pxBuffer->pxNextBuffer;
+            pxBuffer->pxNextBuffer = NULL;
+
+            #if ( ipconfigETHERNET_MINIMUM_PACKET_BYTES > 0 )
+            {
+                prvPadEthernetFrame( pxBuffer );
+            }
+            #endif
+            iptraceNETWORK_INTERFACE_OUTPUT( pxBuffer->xDataLength, pxBuffer->pucEthernetBuffer );
+
+            ( void ) pxInterface->pfOutput( pxInterface, pxBuffer, pdTRUE );
+        }
+    }
+#endif /* ipconfigUSE_UDP_SEGMENTATION == 1 */
+/*-----------------------------------------------------------*/
+
 /**
  * @brief Process the received UDP packet.
  *
@@ -481,6 +689,15 @@ BaseType_t xProcessReceivedUDPPacket_IPv4( NetworkBufferDescriptor_t * pxNetwork
                 }
                 #endif
 
+                #if ( ipconfigSUPPORT_EVENT_POLL == 1 )
+                {
+                    if( pxSocket->pxEventPoll != NULL )
+                    {
+                        vSocketEventPollSignal( pxSocket, ( EventBits_t ) eSELECT_READ );
+                    }
+                }
+                #endif
+
                 #if ( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
                 {
                     if( pxSocket->pxUserSemaphore != NULL )
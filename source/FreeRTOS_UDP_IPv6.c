@@ -512,6 +512,15 @@ BaseType_t xProcessReceivedUDPPacket_IPv6( NetworkBufferDescriptor_t * pxNetwork
                 }
                 #endif
 
+                #if ( ipconfigSUPPORT_EVENT_POLL == 1 )
+                {
+                    if( pxSocket->pxEventPoll != NULL )
+                    {
+                        vSocketEventPollSignal( pxSocket, ( EventBits_t ) eSELECT_READ );
+                    }
+                }
+                #endif
+
                 #if ( ipconfigSOCKET_HAS_USER_SEMAPHORE == 1 )
                 {
                     if( pxSocket->pxUserSemaphore != NULL )
@@ -559,6 +559,76 @@ STATIC_ASSERT( ipconfigMAX_IP_TASK_SLEEP_TIME <= portMAX_DELAY );
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigBUFFER_HEADROOM
+ *
+ * Type: size_t
+ * Unit: bytes
+ * Minimum: 0
+ *
+ * The number of bytes that BufferAllocation_2.c and BufferAllocation_3.c
+ * reserve in front of the Ethernet frame of a network buffer.  Headers can
+ * be prepended in that space with pucNetworkBufferPush(), for instance an
+ * 802.1Q tag, without allocating a new buffer and copying the frame.
+ *
+ * BufferAllocation_1.c does not reserve headroom, because its buffers are
+ * laid out by the network interface.  The frame of any buffer can still be
+ * moved with pucNetworkBufferPull() and pucNetworkBufferPush(), by multiples
+ * of the size of a pointer.
+ *
+ * Must be a multiple of 8, so the pointer that is stored in front of the
+ * frame and the IP-header stay aligned.
+ *
+ * See ipconfigBUFFER_TAILROOM.
+ */
+
+#ifndef ipconfigBUFFER_HEADROOM
+    #define ipconfigBUFFER_HEADROOM    ( 0 )
+#endif
+
+#if ( ipconfigBUFFER_HEADROOM < 0 )
+    #error ipconfigBUFFER_HEADROOM must be at least 0
+#endif
+
+#if ( ( ipconfigBUFFER_HEADROOM % 8 ) != 0 )
+    #error ipconfigBUFFER_HEADROOM must be a multiple of 8
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigBUFFER_TAILROOM
+ *
+ * Type: size_t
+ * Unit: bytes
+ * Minimum: 0
+ *
+ * The number of bytes that BufferAllocation_2.c allocates beyond the
+ * requested size of a network buffer.  A received buffer that is reused to
+ * send a longer reply can then grow in place, where it would otherwise be
+ * reallocated and copied by pxResizeNetworkBufferWithDescriptor().
+ *
+ * BufferAllocation_1.c and BufferAllocation_3.c hand out buffers of fixed
+ * sizes, the space that a request does not use is their tailroom.
+ *
+ * When either ipconfigBUFFER_HEADROOM or ipconfigBUFFER_TAILROOM is non-zero,
+ * every network buffer descriptor records the room around its frame.
+ * Network interfaces that swap the Ethernet buffers of descriptors must then
+ * keep those fields consistent, or leave both settings at zero.
+ *
+ * See ipconfigBUFFER_HEADROOM.
+ */
+
+#ifndef ipconfigBUFFER_TAILROOM
+    #define ipconfigBUFFER_TAILROOM    ( 0 )
+#endif
+
+#if ( ipconfigBUFFER_TAILROOM < 0 )
+    #error ipconfigBUFFER_TAILROOM must be at least 0
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigBYTE_ORDER
  *
@@ -641,6 +711,84 @@ STATIC_ASSERT( ipconfigMAX_IP_TASK_SLEEP_TIME <= portMAX_DELAY );
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigUSE_CHECKSUM_SIMD
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, usGenerateChecksum() uses a vectorised implementation of the
+ * internet checksum where one is available: SSE2 or AVX2 on x86-64, and NEON
+ * on little-endian AArch64. The AVX2 version is selected at run-time, when
+ * the CPU supports it. On other targets, or with compilers other than GCC
+ * and Clang, the portable implementation is used.
+ *
+ * Hosted builds, like the POSIX port, spend a large part of their time in
+ * checksum calculations when the driver does not offload them.
+ */
+
+#ifndef ipconfigUSE_CHECKSUM_SIMD
+    #define ipconfigUSE_CHECKSUM_SIMD    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_CHECKSUM_SIMD != ipconfigDISABLE ) && ( ipconfigUSE_CHECKSUM_SIMD != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_CHECKSUM_SIMD configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_INCREMENTAL_CHECKSUM
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When a TCP packet can not be handled by a socket, the stack replies with a
+ * RST or an ACK that is built in the buffer of the received packet. When
+ * enabled, the TCP checksum of such a reply is updated from the old and the
+ * new values of the fields that are rewritten, as described in RFC 1624,
+ * instead of being calculated over the complete segment.
+ *
+ * The update is only used when the reply has the same length as the
+ * received segment, and when the stack has verified the checksums of the
+ * received packet, i.e. when both ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM
+ * and ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM are disabled. In all other
+ * cases the checksum is calculated as usual.
+ */
+
+#ifndef ipconfigUSE_TCP_INCREMENTAL_CHECKSUM
+    #define ipconfigUSE_TCP_INCREMENTAL_CHECKSUM    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM != ipconfigDISABLE ) && ( ipconfigUSE_TCP_INCREMENTAL_CHECKSUM != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_INCREMENTAL_CHECKSUM configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_FUSED_COPY_CHECKSUM
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, the payload of an outgoing TCP packet is summed while it is
+ * copied from the transmission stream into the network buffer, with
+ * usCopyAndChecksum(). The TCP checksum is then completed by summing only the
+ * pseudo header and the TCP header, so every payload byte is read once
+ * instead of twice. With ipconfigUSE_CHECKSUM_SIMD, the copy uses vector
+ * instructions as well.
+ *
+ * Has no effect when ipconfigDRIVER_INCLUDED_TX_IP_CHECKSUM is enabled.
+ */
+
+#ifndef ipconfigUSE_TCP_FUSED_COPY_CHECKSUM
+    #define ipconfigUSE_TCP_FUSED_COPY_CHECKSUM    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_FUSED_COPY_CHECKSUM != ipconfigDISABLE ) && ( ipconfigUSE_TCP_FUSED_COPY_CHECKSUM != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_FUSED_COPY_CHECKSUM configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * A MISRA note: The macros 'ipconfigETHERNET_DRIVER_FILTERS_FRAME_TYPES'
  * and 'ipconfigETHERNET_DRIVER_FILTERS_PACKETS' are too long: the first 32
@@ -859,6 +1007,180 @@ STATIC_ASSERT( ipconfigMAX_IP_TASK_SLEEP_TIME <= portMAX_DELAY );
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigSMALL_NETWORK_BUFFER_SIZE
+ *
+ * Type: size_t
+ * Unit: bytes
+ * Minimum: sizeof( TCPPacket_t ), or sizeof( ARPPacket_t ) without TCP
+ *
+ * Only used by BufferAllocation_3.c. The size of the buffers in the small
+ * size class. Requests up to this size, such as ARP packets, pure TCP ACKs
+ * and ICMP messages, are served from the small class so they do not occupy
+ * a full-MTU buffer.
+ */
+
+#ifndef ipconfigSMALL_NETWORK_BUFFER_SIZE
+    #define ipconfigSMALL_NETWORK_BUFFER_SIZE    ( 128 )
+#endif
+
+#if ( ipconfigSMALL_NETWORK_BUFFER_SIZE < 1 )
+    #error ipconfigSMALL_NETWORK_BUFFER_SIZE must be at least 1
+#endif
+
+#if ( ipconfigSMALL_NETWORK_BUFFER_SIZE > SIZE_MAX )
+    #error ipconfigSMALL_NETWORK_BUFFER_SIZE overflows a size_t
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigNUM_SMALL_NETWORK_BUFFERS
+ *
+ * Type: size_t
+ * Unit: Count of network buffers
+ * Minimum: 1
+ *
+ * Only used by BufferAllocation_3.c. The number of buffers of
+ * ipconfigSMALL_NETWORK_BUFFER_SIZE bytes.
+ */
+
+#ifndef ipconfigNUM_SMALL_NETWORK_BUFFERS
+    #define ipconfigNUM_SMALL_NETWORK_BUFFERS    ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS
+#endif
+
+#if ( ipconfigNUM_SMALL_NETWORK_BUFFERS < 1 )
+    #error ipconfigNUM_SMALL_NETWORK_BUFFERS must be at least 1
+#endif
+
+#if ( ipconfigNUM_SMALL_NETWORK_BUFFERS > SIZE_MAX )
+    #error ipconfigNUM_SMALL_NETWORK_BUFFERS overflows a size_t
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigNUM_LARGE_NETWORK_BUFFERS
+ *
+ * Type: size_t
+ * Unit: Count of network buffers
+ * Minimum: 1
+ *
+ * Only used by BufferAllocation_3.c. The number of buffers that can hold a
+ * complete Ethernet frame of ipconfigNETWORK_MTU bytes. Network interfaces
+ * take their reception buffers from this class, so it must be large enough
+ * for the DMA descriptors of all interfaces plus the packets in transit.
+ */
+
+#ifndef ipconfigNUM_LARGE_NETWORK_BUFFERS
+    #define ipconfigNUM_LARGE_NETWORK_BUFFERS    ( ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS + 1 ) / 2 )
+#endif
+
+#if ( ipconfigNUM_LARGE_NETWORK_BUFFERS < 1 )
+    #error ipconfigNUM_LARGE_NETWORK_BUFFERS must be at least 1
+#endif
+
+#if ( ipconfigNUM_LARGE_NETWORK_BUFFERS > SIZE_MAX )
+    #error ipconfigNUM_LARGE_NETWORK_BUFFERS overflows a size_t
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigJUMBO_NETWORK_BUFFER_SIZE
+ *
+ * Type: size_t
+ * Unit: bytes
+ * Minimum: 0
+ *
+ * Only used by BufferAllocation_3.c. The size of the buffers in the optional
+ * jumbo size class. It must be larger than a full Ethernet frame of
+ * ipconfigNETWORK_MTU bytes. The jumbo class is only created when
+ * ipconfigNUM_JUMBO_NETWORK_BUFFERS is larger than zero.
+ */
+
+#ifndef ipconfigJUMBO_NETWORK_BUFFER_SIZE
+    #define ipconfigJUMBO_NETWORK_BUFFER_SIZE    ( 0 )
+#endif
+
+#if ( ipconfigJUMBO_NETWORK_BUFFER_SIZE < 0 )
+    #error ipconfigJUMBO_NETWORK_BUFFER_SIZE must be at least 0
+#endif
+
+#if ( ipconfigJUMBO_NETWORK_BUFFER_SIZE > SIZE_MAX )
+    #error ipconfigJUMBO_NETWORK_BUFFER_SIZE overflows a size_t
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigNUM_JUMBO_NETWORK_BUFFERS
+ *
+ * Type: size_t
+ * Unit: Count of network buffers
+ * Minimum: 0
+ *
+ * Only used by BufferAllocation_3.c. The number of buffers of
+ * ipconfigJUMBO_NETWORK_BUFFER_SIZE bytes. Zero disables the jumbo class.
+ */
+
+#ifndef ipconfigNUM_JUMBO_NETWORK_BUFFERS
+    #define ipconfigNUM_JUMBO_NETWORK_BUFFERS    ( 0 )
+#endif
+
+#if ( ipconfigNUM_JUMBO_NETWORK_BUFFERS < 0 )
+    #error ipconfigNUM_JUMBO_NETWORK_BUFFERS must be at least 0
+#endif
+
+#if ( ipconfigNUM_JUMBO_NETWORK_BUFFERS > SIZE_MAX )
+    #error ipconfigNUM_JUMBO_NETWORK_BUFFERS overflows a size_t
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigBUFFER_ALLOC_CACHE_SIZE
+ *
+ * Type: size_t
+ * Unit: Count of network buffer descriptors
+ * Minimum: 0
+ *
+ * Only used by BufferAllocation_1.c. The number of free network buffer
+ * descriptors that each core can keep in a private cache. Obtaining and
+ * releasing a descriptor through the cache of the calling core needs neither
+ * the counting semaphore nor the global critical section, which takes away a
+ * contention point on SMP targets. The ISR functions use the cache as well.
+ *
+ * Descriptors are moved between a cache and the global free list in batches
+ * of half the cache size. At most ipconfigBUFFER_ALLOC_CACHE_SIZE descriptors
+ * per core are held back from the global free list. A task that has to block
+ * in pxGetNetworkBufferWithDescriptor() asks every core to return its cache
+ * to the global free list, and while it waits, released descriptors bypass
+ * the caches. A core returns its cache the next time it obtains or releases
+ * a descriptor. Keep the value small compared to
+ * ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS.
+ *
+ * Zero disables the caches.
+ */
+
+#ifndef ipconfigBUFFER_ALLOC_CACHE_SIZE
+    #define ipconfigBUFFER_ALLOC_CACHE_SIZE    ( 0 )
+#endif
+
+#if ( ipconfigBUFFER_ALLOC_CACHE_SIZE < 0 )
+    #error ipconfigBUFFER_ALLOC_CACHE_SIZE must be at least 0
+#endif
+
+#if defined( configNUMBER_OF_CORES ) && ( configNUMBER_OF_CORES > 1 )
+    #if ( ( ipconfigBUFFER_ALLOC_CACHE_SIZE * configNUMBER_OF_CORES ) >= ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS )
+        #error ipconfigBUFFER_ALLOC_CACHE_SIZE * configNUMBER_OF_CORES must be less than ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS
+    #endif
+#elif ( ipconfigBUFFER_ALLOC_CACHE_SIZE >= ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS )
+    #error ipconfigBUFFER_ALLOC_CACHE_SIZE must be less than ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigUSE_LINKED_RX_MESSAGES
  *
@@ -889,6 +1211,41 @@ STATIC_ASSERT( ipconfigMAX_IP_TASK_SLEEP_TIME <= portMAX_DELAY );
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigRX_BATCH_BUDGET
+ *
+ * Type: UBaseType_t
+ * Unit: count of received packets
+ * Minimum: 0
+ *
+ * Advanced users only.
+ *
+ * The maximum number of received packets that the IP-task processes in one
+ * iteration of its main loop. When a driver passes a long chain of linked
+ * packets, the packets beyond the budget are kept in a backlog. The IP-task
+ * will then first check its timers and handle one other event before it
+ * continues with the next packets in the backlog, and it will not block
+ * while the backlog is not empty. This keeps the TCP timers and the user
+ * API's responsive during a burst of traffic.
+ *
+ * Only used when ipconfigUSE_LINKED_RX_MESSAGES is enabled. A value of 0
+ * means that there is no limit: a chain of packets is processed as a whole.
+ */
+
+#ifndef ipconfigRX_BATCH_BUDGET
+    #define ipconfigRX_BATCH_BUDGET    0U
+#endif
+
+#if ( ipconfigRX_BATCH_BUDGET < 0 )
+    #error ipconfigRX_BATCH_BUDGET must be at least 0
+#endif
+
+#if ( ( ipconfigRX_BATCH_BUDGET != 0 ) && ipconfigIS_DISABLED( ipconfigUSE_LINKED_RX_MESSAGES ) )
+    #error ipconfigRX_BATCH_BUDGET can only be used when ipconfigUSE_LINKED_RX_MESSAGES is enabled
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigZERO_COPY_RX_DRIVER
  *
@@ -953,6 +1310,74 @@ STATIC_ASSERT( ipconfigMAX_IP_TASK_SLEEP_TIME <= portMAX_DELAY );
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigUSE_TCP_TX_SCATTER_GATHER
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Advanced users only.
+ *
+ * When enabled, the payload of an outgoing TCP packet is not copied from the
+ * socket's transmission stream into the network buffer. The network buffer
+ * holds the headers only, and 'xFragments[]' in the descriptor points to one
+ * or two parts of the stream that hold the payload. The frame on the wire is
+ * the 'xDataLength' bytes of 'pucEthernetBuffer' followed by the fragments.
+ *
+ * Fragments are only passed to interfaces that set 'bits.bTxScatterGather' in
+ * their NetworkInterface_t, and only for payloads of at least
+ * ipconfigTCP_TX_SCATTER_GATHER_MIN_BYTES. For other interfaces, the payload
+ * is copied into the network buffer before pfOutput() is called, which can
+ * also be done by calling xNetworkBufferLinearise().
+ *
+ * The stream memory stays valid until the network buffer is released, also
+ * when the data is acknowledged or the socket is closed in the meantime. So
+ * the driver must release the network buffer when the transmission is done,
+ * from a task and not from an interrupt.
+ *
+ * Requires ipconfigZERO_COPY_TX_DRIVER.
+ */
+
+#ifndef ipconfigUSE_TCP_TX_SCATTER_GATHER
+    #define ipconfigUSE_TCP_TX_SCATTER_GATHER    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_TX_SCATTER_GATHER != ipconfigDISABLE ) && ( ipconfigUSE_TCP_TX_SCATTER_GATHER != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_TX_SCATTER_GATHER configuration
+#endif
+
+#if ( ( ipconfigUSE_TCP_TX_SCATTER_GATHER != ipconfigDISABLE ) && ( ipconfigZERO_COPY_TX_DRIVER == ipconfigDISABLE ) )
+    #error ipconfigUSE_TCP_TX_SCATTER_GATHER requires ipconfigZERO_COPY_TX_DRIVER
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_TX_SCATTER_GATHER_MIN_BYTES
+ *
+ * Type: size_t
+ * Unit: bytes
+ * Minimum: ipconfigETHERNET_MINIMUM_PACKET_BYTES
+ *
+ * The smallest TCP payload that is sent as fragments when
+ * ipconfigUSE_TCP_TX_SCATTER_GATHER is enabled. Smaller payloads are copied,
+ * which is cheaper than an extra DMA descriptor. The minimum guarantees that
+ * a frame with fragments never needs padding.
+ */
+
+#ifndef ipconfigTCP_TX_SCATTER_GATHER_MIN_BYTES
+    #define ipconfigTCP_TX_SCATTER_GATHER_MIN_BYTES    128
+#endif
+
+#if ( ( ipconfigUSE_TCP_TX_SCATTER_GATHER != ipconfigDISABLE ) && ( ipconfigTCP_TX_SCATTER_GATHER_MIN_BYTES < ipconfigETHERNET_MINIMUM_PACKET_BYTES ) )
+    #error ipconfigTCP_TX_SCATTER_GATHER_MIN_BYTES must be at least ipconfigETHERNET_MINIMUM_PACKET_BYTES
+#endif
+
+#if ( ipconfigTCP_TX_SCATTER_GATHER_MIN_BYTES < 1 )
+    #error ipconfigTCP_TX_SCATTER_GATHER_MIN_BYTES must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigSUPPORT_NETWORK_DOWN_EVENT
  *
@@ -1685,48 +2110,677 @@ STATIC_ASSERT( ipconfigTCP_KEEP_ALIVE_INTERVAL <= ( portMAX_DELAY / configTICK_R
 /*---------------------------------------------------------------------------*/
 
 /*
- * pvPortMallocLarge / vPortFreeLarge
+ * ipconfigUSE_TCP_CONGESTION_CONTROL
  *
- * Malloc functions specific to large TCP buffers for Rx/Tx.
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Without congestion control, the amount of outstanding TCP data is only
+ * limited by the peer's advertised window and by the local transmission
+ * window. On lossy links this may lead to a storm of retransmissions.
+ *
+ * When ipconfigUSE_TCP_CONGESTION_CONTROL is enabled, every sliding window
+ * also keeps a congestion window (cwnd) and a slow start threshold
+ * (ssthresh), which are driven by the NewReno algorithm: slow start,
+ * congestion avoidance, fast retransmit and fast recovery, as described
+ * in RFC 5681 and RFC 6582. New data will only be sent when it fits in
+ * both the peer's window and the congestion window.
+ *
+ * The algorithm is pluggable: a socket may select another one by name,
+ * using FreeRTOS_setsockopt() with level FREERTOS_IPPROTO_TCP and option
+ * FREERTOS_SO_TCP_CONGESTION. Sockets that do not select one use NewReno.
+ *
+ * Congestion control requires ipconfigUSE_TCP_WIN.
  */
 
-#ifndef pvPortMallocLarge
-    #define pvPortMallocLarge( size )    pvPortMalloc( size )
+#ifndef ipconfigUSE_TCP_CONGESTION_CONTROL
+    #define ipconfigUSE_TCP_CONGESTION_CONTROL    ipconfigDISABLE
 #endif
 
-#ifndef vPortFreeLarge
-    #define vPortFreeLarge( ptr )    vPortFree( ptr )
+#if ( ( ipconfigUSE_TCP_CONGESTION_CONTROL != ipconfigDISABLE ) && ( ipconfigUSE_TCP_CONGESTION_CONTROL != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_CONGESTION_CONTROL configuration
 #endif
 
-/*---------------------------------------------------------------------------*/
-
-/*===========================================================================*/
-/*                                TCP CONFIG                                 */
-/*===========================================================================*/
-/*---------------------------------------------------------------------------*/
-/*===========================================================================*/
-/*---------------------------------------------------------------------------*/
-/*===========================================================================*/
-/*                                UDP CONFIG                                 */
-/*===========================================================================*/
+#if ( ipconfigIS_ENABLED( ipconfigUSE_TCP_CONGESTION_CONTROL ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_WIN ) )
+    #error ipconfigUSE_TCP_CONGESTION_CONTROL requires ipconfigUSE_TCP_WIN
+#endif
 
 /*---------------------------------------------------------------------------*/
 
 /*
- * ipconfigUDP_MAX_RX_PACKETS
+ * ipconfigUSE_TCP_CUBIC
  *
- * https://www.freertos.org/FreeRTOS-Plus/FreeRTOS_Plus_TCP/TCP_IP_Configuration.html#ipconfigUDP_MAX_RX_PACKETS
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
  *
- * Type: UBaseType_t
- * Unit: rx packets
- * Minimum: 0
+ * Include the CUBIC congestion control algorithm ( RFC 9438 ), which lets
+ * cwnd grow as a cubic function of the time since the last loss. On paths
+ * with a large bandwidth-delay product it recovers much faster than NewReno,
+ * which only adds one MSS per round-trip.
  *
- * ipconfigUDP_MAX_RX_PACKETS defines the maximum number of packets that can
- * exist in the Rx queue of a UDP socket. For example, if
- * ipconfigUDP_MAX_RX_PACKETS is set to 5 and there are already 5 packets
- * queued on the UDP socket then subsequent packets received on that socket
- * will be dropped until the queue length is less than 5 again.
- * Can be overridden with the socket option 'FREERTOS_SO_UDP_MAX_RX_PACKETS'.
+ * CUBIC is never used by default: a socket selects it by passing the name
+ * "cubic" to the FREERTOS_SO_TCP_CONGESTION socket option.
+ *
+ * CUBIC requires ipconfigUSE_TCP_CONGESTION_CONTROL.
+ */
+
+#ifndef ipconfigUSE_TCP_CUBIC
+    #define ipconfigUSE_TCP_CUBIC    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_CUBIC != ipconfigDISABLE ) && ( ipconfigUSE_TCP_CUBIC != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_CUBIC configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigUSE_TCP_CUBIC ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_CONGESTION_CONTROL ) )
+    #error ipconfigUSE_TCP_CUBIC requires ipconfigUSE_TCP_CONGESTION_CONTROL
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_TIMESTAMP_OPTION
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Offer the TCP Timestamps option ( TSopt, RFC 7323 ) in the SYN phase.
+ * When the peer accepts it, every segment carries a TSval and echoes the
+ * peer's most recent TSval in TSecr. Each ACK that confirms new data then
+ * yields a round-trip time sample, also for retransmitted segments,
+ * instead of a single sample per window.
+ *
+ * Every segment becomes 12 bytes longer, the effective MSS is reduced
+ * accordingly.
+ *
+ * The option requires ipconfigUSE_TCP_WIN.
+ */
+
+#ifndef ipconfigUSE_TCP_TIMESTAMP_OPTION
+    #define ipconfigUSE_TCP_TIMESTAMP_OPTION    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_TIMESTAMP_OPTION != ipconfigDISABLE ) && ( ipconfigUSE_TCP_TIMESTAMP_OPTION != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_TIMESTAMP_OPTION configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigUSE_TCP_TIMESTAMP_OPTION ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_WIN ) )
+    #error ipconfigUSE_TCP_TIMESTAMP_OPTION requires ipconfigUSE_TCP_WIN
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_PAWS
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Protection Against Wrapped Sequences ( RFC 7323 section 5 ). When the
+ * time-stamp option is in use, a segment whose TSval is older than the
+ * last TSval that was accepted, is an old duplicate. It will be dropped and
+ * answered with an ACK. This protects fast connections, where sequence
+ * numbers wrap around quickly, against the delivery of stale data.
+ *
+ * PAWS requires ipconfigUSE_TCP_TIMESTAMP_OPTION.
+ */
+
+#ifndef ipconfigUSE_TCP_PAWS
+    #define ipconfigUSE_TCP_PAWS    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_PAWS != ipconfigDISABLE ) && ( ipconfigUSE_TCP_PAWS != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_PAWS configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigUSE_TCP_PAWS ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_TIMESTAMP_OPTION ) )
+    #error ipconfigUSE_TCP_PAWS requires ipconfigUSE_TCP_TIMESTAMP_OPTION
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_SACK_SCOREBOARD
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * By default, a transmitted segment is retransmitted early ( fast
+ * retransmission ) after the peer has reported 3 times that it received
+ * data with a higher sequence number. Every hole in the window is counted
+ * separately, so recovering from several losses may take many round trips.
+ *
+ * When ipconfigUSE_TCP_SACK_SCOREBOARD is enabled, the SACK information is
+ * kept as a scoreboard of the outstanding segments, as described in
+ * RFC 6675. Each time a SACK block arrives, every outstanding segment that
+ * has at least 3 SACK'd segments, or more than 2 * MSS SACK'd bytes above
+ * it, is considered lost and will be retransmitted immediately. All holes
+ * in a window can thus be repaired within a single round trip.
+ *
+ * The scoreboard requires ipconfigUSE_TCP_WIN.
+ */
+
+#ifndef ipconfigUSE_TCP_SACK_SCOREBOARD
+    #define ipconfigUSE_TCP_SACK_SCOREBOARD    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_SACK_SCOREBOARD != ipconfigDISABLE ) && ( ipconfigUSE_TCP_SACK_SCOREBOARD != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_SACK_SCOREBOARD configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigUSE_TCP_SACK_SCOREBOARD ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_WIN ) )
+    #error ipconfigUSE_TCP_SACK_SCOREBOARD requires ipconfigUSE_TCP_WIN
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_WIN_SEGMENT_INDEX
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * The segments of a TCP sliding window are kept in linked lists. Looking up
+ * a segment by its sequence number, when an ACK, a SACK or an out-of-order
+ * packet arrives, takes a time proportional to the number of segments in
+ * the window.
+ *
+ * When ipconfigUSE_TCP_WIN_SEGMENT_INDEX is enabled, each window also keeps
+ * a balanced binary tree ( AVL ) of its reception and transmission segments,
+ * ordered by sequence number, and these look-ups take a logarithmic time.
+ * This is worth while when ipconfigTCP_WIN_SEG_COUNT is large. Every
+ * segment descriptor becomes 3 pointers and a BaseType_t larger.
+ *
+ * The index requires ipconfigUSE_TCP_WIN.
+ */
+
+#ifndef ipconfigUSE_TCP_WIN_SEGMENT_INDEX
+    #define ipconfigUSE_TCP_WIN_SEGMENT_INDEX    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX != ipconfigDISABLE ) && ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_WIN_SEGMENT_INDEX configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigUSE_TCP_WIN_SEGMENT_INDEX ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_WIN ) )
+    #error ipconfigUSE_TCP_WIN_SEGMENT_INDEX requires ipconfigUSE_TCP_WIN
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_WIN_SEGMENT_ARENA
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * By default, all ipconfigTCP_WIN_SEG_COUNT segment descriptors are
+ * allocated at once, when the first TCP connection is made, and any socket
+ * may use as many of them as it likes.
+ *
+ * When ipconfigUSE_TCP_WIN_SEGMENT_ARENA is enabled, the descriptors are
+ * allocated in chunks of ipconfigTCP_WIN_SEG_CHUNK_COUNT, when they are
+ * needed, and ipconfigTCP_WIN_SEG_COUNT becomes the maximum. A socket may
+ * own at most ipconfigTCP_WIN_SEG_QUOTA descriptors, and
+ * ipconfigTCP_WIN_SEG_RESERVED descriptors are kept available for every
+ * socket that owns less than that number. vTCPSegmentGetStats() reports
+ * the use of the descriptors.
+ *
+ * The arena requires ipconfigUSE_TCP_WIN.
+ */
+
+#ifndef ipconfigUSE_TCP_WIN_SEGMENT_ARENA
+    #define ipconfigUSE_TCP_WIN_SEGMENT_ARENA    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA != ipconfigDISABLE ) && ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_WIN_SEGMENT_ARENA configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigUSE_TCP_WIN_SEGMENT_ARENA ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_WIN ) )
+    #error ipconfigUSE_TCP_WIN_SEGMENT_ARENA requires ipconfigUSE_TCP_WIN
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_WIN_SEG_CHUNK_COUNT
+ *
+ * Type: size_t
+ * Unit: count of segment descriptors
+ * Minimum: 1
+ *
+ * The number of segment descriptors that is allocated at once, each time
+ * the arena of descriptors has to grow. The last chunk is smaller when
+ * ipconfigTCP_WIN_SEG_COUNT is not a multiple of it. Only used when
+ * ipconfigUSE_TCP_WIN_SEGMENT_ARENA is enabled.
+ */
+
+#ifndef ipconfigTCP_WIN_SEG_CHUNK_COUNT
+    #define ipconfigTCP_WIN_SEG_CHUNK_COUNT    ( 16 )
+#endif
+
+#if ( ipconfigTCP_WIN_SEG_CHUNK_COUNT < 1 )
+    #error ipconfigTCP_WIN_SEG_CHUNK_COUNT must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_WIN_SEG_QUOTA
+ *
+ * Type: size_t
+ * Unit: count of segment descriptors
+ * Minimum: 1
+ *
+ * The maximum number of segment descriptors that a single socket may own,
+ * for its reception and transmission windows together. It keeps one bulk
+ * transfer from using all descriptors. Only used when
+ * ipconfigUSE_TCP_WIN_SEGMENT_ARENA is enabled.
+ */
+
+#ifndef ipconfigTCP_WIN_SEG_QUOTA
+    #define ipconfigTCP_WIN_SEG_QUOTA    ipconfigTCP_WIN_SEG_COUNT
+#endif
+
+#if ( ipconfigTCP_WIN_SEG_QUOTA < 1 )
+    #error ipconfigTCP_WIN_SEG_QUOTA must be at least 1
+#endif
+
+#if ( ipconfigTCP_WIN_SEG_QUOTA > ipconfigTCP_WIN_SEG_COUNT )
+    #error ipconfigTCP_WIN_SEG_QUOTA must not be larger than ipconfigTCP_WIN_SEG_COUNT
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_WIN_SEG_RESERVED
+ *
+ * Type: size_t
+ * Unit: count of segment descriptors
+ * Minimum: 0
+ *
+ * The number of segment descriptors that is reserved for each TCP
+ * connection. A socket that owns more descriptors only gets a new one when
+ * enough free descriptors remain for the reservations of the other sockets.
+ * The reservations can only be honoured when ipconfigTCP_WIN_SEG_COUNT is
+ * at least the number of connections times ipconfigTCP_WIN_SEG_RESERVED.
+ * Only used when ipconfigUSE_TCP_WIN_SEGMENT_ARENA is enabled.
+ */
+
+#ifndef ipconfigTCP_WIN_SEG_RESERVED
+    #define ipconfigTCP_WIN_SEG_RESERVED    ( 2 )
+#endif
+
+#if ( ipconfigTCP_WIN_SEG_RESERVED < 0 )
+    #error ipconfigTCP_WIN_SEG_RESERVED must be at least 0
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigUSE_TCP_WIN_SEGMENT_ARENA ) && ( ipconfigTCP_WIN_SEG_RESERVED > ipconfigTCP_WIN_SEG_QUOTA ) )
+    #error ipconfigTCP_WIN_SEG_RESERVED must not be larger than ipconfigTCP_WIN_SEG_QUOTA
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_SOCKET_HASH
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When a TCP packet is received, pxTCPSocketLookup() must find the socket
+ * that matches the local port, the remote IP-address and the remote port.
+ * By default this is done by iterating through the list of all bound TCP
+ * sockets, which becomes costly when there are many connections.
+ *
+ * When ipconfigUSE_TCP_SOCKET_HASH is enabled, the IP-task will also keep
+ * a hash table of all bound sockets, indexed by their local port, remote
+ * IP-address and remote port. Listening sockets are kept in a separate
+ * index, which is consulted when there is no exact match. Each table
+ * has ipconfigTCP_SOCKET_HASH_SIZE entries of type List_t.
+ */
+
+#ifndef ipconfigUSE_TCP_SOCKET_HASH
+    #define ipconfigUSE_TCP_SOCKET_HASH    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_SOCKET_HASH != ipconfigDISABLE ) && ( ipconfigUSE_TCP_SOCKET_HASH != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_SOCKET_HASH configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_SOCKET_HASH_SIZE
+ *
+ * Type: size_t
+ * Unit: count of hash buckets
+ * Minimum: 1
+ *
+ * The number of buckets in the TCP connection hash table and in the index
+ * of listening sockets, see ipconfigUSE_TCP_SOCKET_HASH. The value must be
+ * a power of 2. A value close to the expected number of simultaneous TCP
+ * connections will keep the average bucket length below 1.
+ */
+
+#ifndef ipconfigTCP_SOCKET_HASH_SIZE
+    #define ipconfigTCP_SOCKET_HASH_SIZE    ( 64 )
+#endif
+
+#if ( ipconfigTCP_SOCKET_HASH_SIZE < 1 )
+    #error ipconfigTCP_SOCKET_HASH_SIZE must be at least 1
+#endif
+
+#if ( ( ipconfigTCP_SOCKET_HASH_SIZE & ( ipconfigTCP_SOCKET_HASH_SIZE - 1 ) ) != 0 )
+    #error ipconfigTCP_SOCKET_HASH_SIZE must be a power of 2
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_TIMER_WHEEL
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * By default xTCPTimerCheck() visits every bound TCP socket each time the
+ * IP-task is about to sleep, in order to count down its timer and to find
+ * the next time-out. This becomes costly when there are many (idle)
+ * connections.
+ *
+ * When ipconfigUSE_TCP_TIMER_WHEEL is enabled, the retransmission,
+ * keep-alive, delayed-ACK and hang-protection time-outs of a socket are
+ * scheduled in a hierarchical timer wheel, see FreeRTOS_Timer_Wheel.c. The
+ * IP-task will only visit the sockets whose timer has expired, or that have
+ * an event for their owner. The wheel needs a 32-bit TickType_t.
+ */
+
+#ifndef ipconfigUSE_TCP_TIMER_WHEEL
+    #define ipconfigUSE_TCP_TIMER_WHEEL    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_TIMER_WHEEL != ipconfigDISABLE ) && ( ipconfigUSE_TCP_TIMER_WHEEL != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_TIMER_WHEEL configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_REUSE_PORT
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Include the socket option FREERTOS_SO_REUSEPORT, which works like the
+ * SO_REUSEPORT option in Linux. When it is set on a TCP socket before it is
+ * bound, several sockets may be bound to, and listen on, the same port,
+ * as long as all of them have set the option. Each listening socket can be
+ * owned by a different worker task.
+ *
+ * A new connection is given to one of the listening sockets, chosen by a
+ * hash of the remote IP-address and the remote and local port numbers.
+ * All packets of a connection attempt will therefore reach the same socket.
+ * When a listening socket is added or closed, only the connection attempts
+ * that it takes over or leaves behind move to another socket.
+ */
+
+#ifndef ipconfigUSE_TCP_REUSE_PORT
+    #define ipconfigUSE_TCP_REUSE_PORT    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_REUSE_PORT != ipconfigDISABLE ) && ( ipconfigUSE_TCP_REUSE_PORT != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_REUSE_PORT configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_SYN_CACHE
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * By default a listening TCP socket creates a new socket, with its TCP
+ * window and stream buffers, for every SYN that it receives. A flood of
+ * SYN packets from spoofed addresses will therefore use up the memory and
+ * the backlog of the listening socket.
+ *
+ * When ipconfigUSE_TCP_SYN_CACHE is enabled, a SYN is answered from a small
+ * table of half-open connections, see FreeRTOS_TCP_SYN_Cache.c. The socket
+ * is only created when the peer acknowledges the SYN+ACK. An entry that is
+ * not acknowledged within ipconfigTCP_HANG_PROTECTION_TIME seconds may be
+ * reused. When the table is full, the oldest entry is replaced.
+ */
+
+#ifndef ipconfigUSE_TCP_SYN_CACHE
+    #define ipconfigUSE_TCP_SYN_CACHE    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_SYN_CACHE != ipconfigDISABLE ) && ( ipconfigUSE_TCP_SYN_CACHE != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_SYN_CACHE configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_SYN_CACHE_SIZE
+ *
+ * Type: size_t
+ * Unit: count of half-open connections
+ * Minimum: 1
+ *
+ * The number of entries in the SYN cache, see ipconfigUSE_TCP_SYN_CACHE.
+ * The table is shared by all listening sockets. An entry takes less than 50
+ * bytes, against a few kilobytes for a socket with its buffers.
+ */
+
+#ifndef ipconfigTCP_SYN_CACHE_SIZE
+    #define ipconfigTCP_SYN_CACHE_SIZE    ( 16 )
+#endif
+
+#if ( ipconfigTCP_SYN_CACHE_SIZE < 1 )
+    #error ipconfigTCP_SYN_CACHE_SIZE must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_SYN_COOKIES
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When the SYN cache is full, encode the connection in the initial sequence
+ * number of the SYN+ACK (a "SYN cookie") in stead of replacing the oldest
+ * entry. Nothing is stored; a valid cookie in the final ACK is enough to
+ * create the socket. A cookie can only carry an approximation of the MSS
+ * of the peer, and window scaling is not negotiated.
+ *
+ * The cookies are protected by a secret that is obtained from
+ * xApplicationGetRandomNumber().
+ */
+
+#ifndef ipconfigUSE_TCP_SYN_COOKIES
+    #define ipconfigUSE_TCP_SYN_COOKIES    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_SYN_COOKIES != ipconfigDISABLE ) && ( ipconfigUSE_TCP_SYN_COOKIES != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_SYN_COOKIES configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigUSE_TCP_SYN_COOKIES ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_SYN_CACHE ) )
+    #error ipconfigUSE_TCP_SYN_COOKIES requires ipconfigUSE_TCP_SYN_CACHE
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_TIME_WAIT
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * By default, segments that arrive after a socket has been closed are
+ * answered with a RST, even when they are a normal part of the closure,
+ * such as a retransmitted FIN. A socket that is closing therefore has to
+ * stay allocated until the closure is complete.
+ *
+ * When ipconfigUSE_TCP_TIME_WAIT is enabled, a TCP socket that is closed
+ * while a FIN has been sent is recorded in a small table of closing
+ * connections, see FreeRTOS_TCP_Time_Wait.c. The socket and its buffers are
+ * freed, and late segments are answered from the table: a retransmitted FIN
+ * is acknowledged, other segments are dropped silently. Until the peer
+ * acknowledges our FIN, the TCP timer sends it again after 1, 2, 4, 8 and
+ * then every 16 seconds. A socket that was never accepted by the application
+ * is freed as soon as it has replied to the FIN of the peer.
+ */
+
+#ifndef ipconfigUSE_TCP_TIME_WAIT
+    #define ipconfigUSE_TCP_TIME_WAIT    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_TIME_WAIT != ipconfigDISABLE ) && ( ipconfigUSE_TCP_TIME_WAIT != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_TIME_WAIT configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_TIME_WAIT_SIZE
+ *
+ * Type: size_t
+ * Unit: count of closing connections
+ * Minimum: 1
+ *
+ * The number of entries in the table of closing connections, see
+ * ipconfigUSE_TCP_TIME_WAIT. When the table is full, the oldest entry is
+ * replaced. An entry takes less than 40 bytes.
+ */
+
+#ifndef ipconfigTCP_TIME_WAIT_SIZE
+    #define ipconfigTCP_TIME_WAIT_SIZE    ( 32 )
+#endif
+
+#if ( ipconfigTCP_TIME_WAIT_SIZE < 1 )
+    #error ipconfigTCP_TIME_WAIT_SIZE must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigTCP_TIME_WAIT_SECONDS
+ *
+ * Type: uint32_t
+ * Unit: seconds
+ * Minimum: 1
+ *
+ * The time that a closing connection is remembered, see
+ * ipconfigUSE_TCP_TIME_WAIT. RFC 9293 asks for twice the maximum segment
+ * lifetime, but a smaller value is common on a local network. The time
+ * restarts when a retransmitted FIN is acknowledged.
+ */
+
+#ifndef ipconfigTCP_TIME_WAIT_SECONDS
+    #define ipconfigTCP_TIME_WAIT_SECONDS    ( 30U )
+#endif
+
+#if ( ipconfigTCP_TIME_WAIT_SECONDS < 1 )
+    #error ipconfigTCP_TIME_WAIT_SECONDS must be at least 1
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_NAGLE
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * When enabled, TCP connections use the Nagle algorithm of RFC 896: as long
+ * as sent data has not been acknowledged, a segment smaller than the MSS is
+ * held back, and more data from FreeRTOS_send() is added to it. It is sent
+ * when it is full, or when all outstanding data has been acknowledged.
+ * This saves many small packets when an application sends small amounts
+ * of data.
+ *
+ * The Nagle algorithm can be switched off for a socket with the option
+ * FREERTOS_SO_TCP_NODELAY. Only the sliding window (ipconfigUSE_TCP_WIN)
+ * needs this: without it, a connection never has more than one segment
+ * outstanding.
+ */
+
+#ifndef ipconfigUSE_TCP_NAGLE
+    #define ipconfigUSE_TCP_NAGLE    ipconfigENABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_NAGLE != ipconfigDISABLE ) && ( ipconfigUSE_TCP_NAGLE != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_NAGLE configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_TCP_ACK_POLICY
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * A TCP connection that receives data in segments without options may delay
+ * its ACK, hoping that the next segment arrives soon, so that one ACK
+ * acknowledges both. The built-in policy waits at most 20 ms after a
+ * full-size segment, and 2 clock ticks after a smaller segment.
+ *
+ * Enable ipconfigUSE_TCP_ACK_POLICY to include the socket option
+ * FREERTOS_SO_TCP_ACK_POLICY, which sets a different policy per socket,
+ * see TCPAckPolicy_t: the maximum number of segments that share an ACK, the
+ * maximum delay, a number of segments that are acknowledged at once at the
+ * start of a connection or after an idle period, and an immediate ACK for
+ * segments with the PSH flag. FreeRTOS_tcp_acks_saved() returns the number
+ * of ACKs that were saved by delaying them.
+ */
+
+#ifndef ipconfigUSE_TCP_ACK_POLICY
+    #define ipconfigUSE_TCP_ACK_POLICY    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_TCP_ACK_POLICY != ipconfigDISABLE ) && ( ipconfigUSE_TCP_ACK_POLICY != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_TCP_ACK_POLICY configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigUSE_TCP_ACK_POLICY ) && ipconfigIS_DISABLED( ipconfigUSE_TCP_WIN ) )
+    #error ipconfigUSE_TCP_ACK_POLICY requires ipconfigUSE_TCP_WIN
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * pvPortMallocLarge / vPortFreeLarge
+ *
+ * Malloc functions specific to large TCP buffers for Rx/Tx.
+ */
+
+#ifndef pvPortMallocLarge
+    #define pvPortMallocLarge( size )    pvPortMalloc( size )
+#endif
+
+#ifndef vPortFreeLarge
+    #define vPortFreeLarge( ptr )    vPortFree( ptr )
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*===========================================================================*/
+/*                                TCP CONFIG                                 */
+/*===========================================================================*/
+/*---------------------------------------------------------------------------*/
+/*===========================================================================*/
+/*---------------------------------------------------------------------------*/
+/*===========================================================================*/
+/*                                UDP CONFIG                                 */
+/*===========================================================================*/
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUDP_MAX_RX_PACKETS
+ *
+ * https://www.freertos.org/FreeRTOS-Plus/FreeRTOS_Plus_TCP/TCP_IP_Configuration.html#ipconfigUDP_MAX_RX_PACKETS
+ *
+ * Type: UBaseType_t
+ * Unit: rx packets
+ * Minimum: 0
+ *
+ * ipconfigUDP_MAX_RX_PACKETS defines the maximum number of packets that can
+ * exist in the Rx queue of a UDP socket. For example, if
+ * ipconfigUDP_MAX_RX_PACKETS is set to 5 and there are already 5 packets
+ * queued on the UDP socket then subsequent packets received on that socket
+ * will be dropped until the queue length is less than 5 again.
+ * Can be overridden with the socket option 'FREERTOS_SO_UDP_MAX_RX_PACKETS'.
  */
 
 #ifndef ipconfigUDP_MAX_RX_PACKETS
@@ -1825,6 +2879,122 @@ STATIC_ASSERT( ipconfigUDP_MAX_SEND_BLOCK_TIME_TICKS <= portMAX_DELAY );
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigUSE_UDP_PORT_HASH
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * For every UDP packet received, pxUDPSocketLookup() must find the socket
+ * that is bound to the destination port. By default this is done by
+ * iterating through the list of all bound UDP sockets.
+ *
+ * When ipconfigUSE_UDP_PORT_HASH is enabled, the bound UDP sockets are also
+ * stored in a hash table of ipconfigUDP_PORT_HASH_SIZE entries, indexed by
+ * their port number. The table is updated when a socket is bound or closed.
+ * It is also used by xPortHasUDPSocket(), and when checking if a port
+ * number is already in use.
+ */
+
+#ifndef ipconfigUSE_UDP_PORT_HASH
+    #define ipconfigUSE_UDP_PORT_HASH    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_UDP_PORT_HASH != ipconfigDISABLE ) && ( ipconfigUSE_UDP_PORT_HASH != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_UDP_PORT_HASH configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUDP_PORT_HASH_SIZE
+ *
+ * Type: size_t
+ * Unit: count of hash buckets
+ * Minimum: 1
+ * Maximum: 65536
+ *
+ * The number of buckets in the UDP port hash table, see
+ * ipconfigUSE_UDP_PORT_HASH. The value must be a power of 2. Each bucket
+ * is a List_t.
+ */
+
+#ifndef ipconfigUDP_PORT_HASH_SIZE
+    #define ipconfigUDP_PORT_HASH_SIZE    ( 64 )
+#endif
+
+#if ( ipconfigUDP_PORT_HASH_SIZE < 1 )
+    #error ipconfigUDP_PORT_HASH_SIZE must be at least 1
+#endif
+
+#if ( ipconfigUDP_PORT_HASH_SIZE > 65536 )
+    #error ipconfigUDP_PORT_HASH_SIZE must be at most 65536
+#endif
+
+#if ( ( ipconfigUDP_PORT_HASH_SIZE & ( ipconfigUDP_PORT_HASH_SIZE - 1 ) ) != 0 )
+    #error ipconfigUDP_PORT_HASH_SIZE must be a power of 2
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigSUPPORT_UDP_MULTI_MESSAGES
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Include FreeRTOS_recvfrom_multi() and FreeRTOS_sendto_multi(), which
+ * receive or send several UDP datagrams in one call, like recvmmsg() and
+ * sendmmsg(). FreeRTOS_recvfrom_multi() takes all the packets it needs from
+ * the socket in one go. FreeRTOS_sendto_multi() passes its packets to the
+ * IP-task as a chain, in a single event, which saves a message and possibly a
+ * task switch for each packet. Each network buffer gets a 'pxNextBuffer'
+ * field to make the chain.
+ */
+
+#ifndef ipconfigSUPPORT_UDP_MULTI_MESSAGES
+    #define ipconfigSUPPORT_UDP_MULTI_MESSAGES    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigSUPPORT_UDP_MULTI_MESSAGES != ipconfigDISABLE ) && ( ipconfigSUPPORT_UDP_MULTI_MESSAGES != ipconfigENABLE ) )
+    #error Invalid ipconfigSUPPORT_UDP_MULTI_MESSAGES configuration
+#endif
+
+/*---------------------------------------------------------------------------*/
+
+/*
+ * ipconfigUSE_UDP_SEGMENTATION
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Include the socket option FREERTOS_SO_UDP_SEGMENT, which works like the
+ * UDP_SEGMENT option of Linux. When a segment size is set, FreeRTOS_sendto()
+ * accepts a buffer that is longer than one datagram, and sends it as a series
+ * of datagrams with a payload of the segment size; only the last one may be
+ * shorter. All datagrams are passed to the IP-task in a single event. For
+ * IPv4, FreeRTOS_sendto() first waits, up to the send block time, until the
+ * MAC address of the destination is known. The headers of the other datagrams
+ * are copied from the first one. All datagrams are then passed to the
+ * network interface in one go. A buffer can hold at most 64 segments, and no
+ * more than half of ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS. Only the first
+ * network buffer is waited for.
+ *
+ * The datagrams are chained like the ones of FreeRTOS_sendto_multi(), so
+ * ipconfigSUPPORT_UDP_MULTI_MESSAGES must be enabled as well.
+ */
+
+#ifndef ipconfigUSE_UDP_SEGMENTATION
+    #define ipconfigUSE_UDP_SEGMENTATION    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigUSE_UDP_SEGMENTATION != ipconfigDISABLE ) && ( ipconfigUSE_UDP_SEGMENTATION != ipconfigENABLE ) )
+    #error Invalid ipconfigUSE_UDP_SEGMENTATION configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigUSE_UDP_SEGMENTATION ) && ipconfigIS_DISABLED( ipconfigSUPPORT_UDP_MULTI_MESSAGES ) )
+    #error ipconfigUSE_UDP_SEGMENTATION needs ipconfigSUPPORT_UDP_MULTI_MESSAGES to be enabled
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*===========================================================================*/
 /*                                UDP CONFIG                                 */
 /*===========================================================================*/
@@ -1920,6 +3090,39 @@ STATIC_ASSERT( ipconfigUDP_MAX_SEND_BLOCK_TIME_TICKS <= portMAX_DELAY );
 
 /*---------------------------------------------------------------------------*/
 
+/*
+ * ipconfigSUPPORT_EVENT_POLL
+ *
+ * Type: BaseType_t ( ipconfigENABLE | ipconfigDISABLE )
+ *
+ * Include support for FreeRTOS_EventPollWait() and associated API functions.
+ * Different from FreeRTOS_select(), which lets the IP-task inspect every
+ * bound socket, a socket that belongs to an event-poll set adds itself to a
+ * list of ready sockets when an event occurs. FreeRTOS_EventPollWait() only
+ * visits the sockets in that list. Sockets can be reported edge-triggered
+ * or level-triggered. The list is read by the IP-task, which also checks the
+ * state of level-triggered sockets, so FreeRTOS_EventPollWait() sends it a
+ * message like FreeRTOS_select() does.
+ *
+ * The event-poll sets use the same event bits as FreeRTOS_select(), so
+ * ipconfigSUPPORT_SELECT_FUNCTION must be enabled as well. A socket can
+ * either belong to a socket set or to an event-poll set.
+ */
+
+#ifndef ipconfigSUPPORT_EVENT_POLL
+    #define ipconfigSUPPORT_EVENT_POLL    ipconfigDISABLE
+#endif
+
+#if ( ( ipconfigSUPPORT_EVENT_POLL != ipconfigDISABLE ) && ( ipconfigSUPPORT_EVENT_POLL != ipconfigENABLE ) )
+    #error Invalid ipconfigSUPPORT_EVENT_POLL configuration
+#endif
+
+#if ( ipconfigIS_ENABLED( ipconfigSUPPORT_EVENT_POLL ) && ipconfigIS_DISABLED( ipconfigSUPPORT_SELECT_FUNCTION ) )
+    #error ipconfigSUPPORT_EVENT_POLL needs ipconfigSUPPORT_SELECT_FUNCTION to be enabled
+#endif
+
+/*---------------------------------------------------------------------------*/
+
 /*
  * ipconfigSOCK_DEFAULT_RECEIVE_BLOCK_TIME
  *
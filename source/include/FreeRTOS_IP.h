@@ -128,6 +128,27 @@ extern uint32_t ulApplicationGetNextSequenceNumber( uint32_t ulSourceAddress,
     #define ipBUFFER_PADDING    ( 8U + ipconfigPACKET_FILLER_SIZE )
 #endif
 
+/* Network buffer descriptors record the room around their Ethernet frame
+ * when headroom or tailroom is reserved. */
+#if ( ( ipconfigBUFFER_HEADROOM > 0 ) || ( ipconfigBUFFER_TAILROOM > 0 ) )
+    #define ipBUFFER_ROOM    1
+#else
+    #define ipBUFFER_ROOM    0
+#endif
+
+/* The number of bytes that a network buffer can hold from pucEthernetBuffer
+ * onwards.  Without room tracking, 'xDataLength' is the best estimate. */
+#if ( ipBUFFER_ROOM != 0 )
+    #define ipNETWORK_BUFFER_CAPACITY( pxNetworkBuffer )    ( ( pxNetworkBuffer )->uxBufferSize )
+#else
+    #define ipNETWORK_BUFFER_CAPACITY( pxNetworkBuffer )    ( ( pxNetworkBuffer )->xDataLength )
+#endif
+
+/* pucNetworkBufferPush() and pucNetworkBufferPull() move the frame by multiples
+ * of this number of bytes, so the pointer to the descriptor that is stored in
+ * front of the frame stays aligned. */
+#define ipNETWORK_BUFFER_ROOM_ALIGNMENT    ( sizeof( void * ) )
+
 /* The offset of ucTCPFlags within the TCP header. */
 #define ipTCP_FLAGS_OFFSET      13U
 
@@ -154,6 +175,21 @@ extern uint32_t ulApplicationGetNextSequenceNumber( uint32_t ulSourceAddress,
     #define DEBUG_SET_TRACE_VARIABLE( var, value )                                 /**< Empty definition since ipconfigHAS_PRINTF != 1. */
 #endif
 
+#if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+
+/* A fragment lives in a circular stream buffer, so the data may wrap once. */
+    #define ipNETWORK_BUFFER_MAX_FRAGMENTS    2U
+
+/**
+ * A part of an outgoing frame that is not stored in the network buffer itself.
+ */
+    typedef struct xNETWORK_BUFFER_FRAGMENT
+    {
+        const uint8_t * pucData; /**< The first byte of the fragment. */
+        size_t uxLength;         /**< The number of bytes in the fragment. */
+    } NetworkBufferFragment_t;
+#endif /* ipconfigUSE_TCP_TX_SCATTER_GATHER */
+
 /**
  * The structure used to store buffers and pass them around the network stack.
  * Buffers can be in use by the stack, in use by the network interface hardware
@@ -169,9 +205,18 @@ typedef struct xNETWORK_BUFFER
     struct xNetworkEndPoint * pxEndPoint;      /**< The end-point through which this packet shall be sent. */
     uint16_t usPort;                           /**< Source or destination port, depending on usage scenario. */
     uint16_t usBoundPort;                      /**< The port to which a transmitting socket is bound. */
-    #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+    #if ( ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) || ( ipconfigSUPPORT_UDP_MULTI_MESSAGES != 0 ) )
         struct xNETWORK_BUFFER * pxNextBuffer; /**< Possible optimisation for expert users - requires network driver support. */
     #endif
+    #if ( ipBUFFER_ROOM != 0 )
+        size_t uxHeadroom;                     /**< The number of bytes in front of the pointer to this descriptor that pucNetworkBufferPush() can use. */
+        size_t uxBufferSize;                   /**< The number of bytes that can be stored from pucEthernetBuffer onwards. */
+    #endif
+    #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+        NetworkBufferFragment_t xFragments[ ipNETWORK_BUFFER_MAX_FRAGMENTS ]; /**< Data that follows the 'xDataLength' bytes of pucEthernetBuffer on the wire. */
+        UBaseType_t uxFragmentCount;                                          /**< The number of valid entries in 'xFragments', zero for a contiguous frame. */
+        struct xSTREAM_BUFFER * pxFragmentStream;                             /**< The stream buffer that holds the fragments, it is kept alive until this buffer is released. */
+    #endif
 
 #define ul_IPAddress     xIPAddress.xIP_IPv4
 #define x_IPv6Address    xIPAddress.xIP_IPv6
@@ -0,0 +1,151 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_IP_CHECKSUM_H
+#define FREERTOS_IP_CHECKSUM_H
+
+/**
+ * @file FreeRTOS_IP_Checksum.h
+ * @brief Vectorised implementations of the internet checksum.
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+#if ( ipconfigUSE_CHECKSUM_SIMD == 1 )
+
+/* SSE2 is part of every x86-64 CPU, AVX2 is checked at run-time. */
+    #if defined( __GNUC__ ) && defined( __x86_64__ )
+        #define ipCHECKSUM_HAS_X86_64    1
+    #else
+        #define ipCHECKSUM_HAS_X86_64    0
+    #endif
+
+/* NEON is part of every AArch64 CPU. */
+    #if defined( __GNUC__ ) && defined( __aarch64__ ) && defined( __ARM_NEON ) && !defined( __ARM_BIG_ENDIAN )
+        #define ipCHECKSUM_HAS_NEON    1
+    #else
+        #define ipCHECKSUM_HAS_NEON    0
+    #endif
+
+/*
+ * A checksum kernel adds the 16-bit words of a block of data, in the byte
+ * order of the host, to 'ulSum'. It returns the sum, folded to 16 bits.
+ * An odd last byte is added as if it were followed by a zero byte.
+ */
+    typedef uint32_t ( * ChecksumKernel_t )( uint32_t ulSum,
+                                             const uint8_t * pucData,
+                                             size_t uxLength );
+
+/*
+ * A copy kernel does the same, and also copies the data to 'pucDestination'.
+ */
+    typedef uint32_t ( * ChecksumCopyKernel_t )( uint32_t ulSum,
+                                                 uint8_t * pucDestination,
+                                                 const uint8_t * pucSource,
+                                                 size_t uxLength );
+
+/*
+ * The portable implementations, as found in FreeRTOS_IP_Utils.c. They are
+ * used when no vectorised kernel is available.
+ */
+    uint16_t usGenerateChecksumScalar( uint16_t usSum,
+                                       const uint8_t * pucNextData,
+                                       size_t uxByteCount );
+
+    uint16_t usCopyAndChecksumScalar( uint16_t usSum,
+                                      uint8_t * pucDestination,
+                                      const uint8_t * pucSource,
+                                      size_t uxByteCount );
+
+/*
+ * Return the kernel that is used by usGenerateChecksum(), or NULL when the
+ * portable implementation is used.
+ */
+    ChecksumKernel_t pxChecksumGetKernel( void );
+
+/*
+ * Return the kernel that is used by usCopyAndChecksum(), or NULL when the
+ * portable implementation is used.
+ */
+    ChecksumCopyKernel_t pxChecksumGetCopyKernel( void );
+
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+        uint32_t ulChecksumSSE2( uint32_t ulSum,
+                                 const uint8_t * pucData,
+                                 size_t uxLength );
+
+        uint32_t ulChecksumAVX2( uint32_t ulSum,
+                                 const uint8_t * pucData,
+                                 size_t uxLength );
+
+        uint32_t ulCopyChecksumSSE2( uint32_t ulSum,
+                                     uint8_t * pucDestination,
+                                     const uint8_t * pucSource,
+                                     size_t uxLength );
+
+        uint32_t ulCopyChecksumAVX2( uint32_t ulSum,
+                                     uint8_t * pucDestination,
+                                     const uint8_t * pucSource,
+                                     size_t uxLength );
+
+/* Returns pdTRUE when the CPU supports AVX2. */
+        BaseType_t xChecksumHasAVX2( void );
+    #endif
+
+    #if ( ipCHECKSUM_HAS_NEON == 1 )
+        uint32_t ulChecksumNEON( uint32_t ulSum,
+                                 const uint8_t * pucData,
+                                 size_t uxLength );
+
+        uint32_t ulCopyChecksumNEON( uint32_t ulSum,
+                                     uint8_t * pucDestination,
+                                     const uint8_t * pucSource,
+                                     size_t uxLength );
+    #endif
+
+#endif /* ipconfigUSE_CHECKSUM_SIMD == 1 */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_IP_CHECKSUM_H */
@@ -38,6 +38,10 @@
 #if ( ipconfigUSE_TCP == 1 )
     #include "FreeRTOS_TCP_WIN.h"
     #include "FreeRTOS_TCP_IP.h"
+
+    #if ( ipconfigUSE_TCP_TIMER_WHEEL == 1 )
+        #include "FreeRTOS_Timer_Wheel.h"
+    #endif
 #endif
 
 #include "semphr.h"
@@ -71,21 +75,26 @@ typedef enum eFrameProcessingResult
 typedef enum
 {
     eNoEvent = -1,
-    eNetworkDownEvent,    /* 0: The network interface has been lost and/or needs [re]connecting. */
-    eNetworkRxEvent,      /* 1: The network interface has queued a received Ethernet frame. */
-    eNetworkTxEvent,      /* 2: Let the IP-task send a network packet. */
-    eARPTimerEvent,       /* 3: The ARP timer expired. */
-    eNDTimerEvent,        /* 4: The ND timer expired. */
-    eStackTxEvent,        /* 5: The software stack has queued a packet to transmit. */
-    eDHCPEvent,           /* 6: Process the DHCP state machine. */
-    eTCPTimerEvent,       /* 7: See if any TCP socket needs attention. */
-    eTCPAcceptEvent,      /* 8: Client API FreeRTOS_accept() waiting for client connections. */
-    eTCPNetStat,          /* 9: IP-task is asked to produce a netstat listing. */
-    eSocketBindEvent,     /*10: Send a message to the IP-task to bind a socket to a port. */
-    eSocketCloseEvent,    /*11: Send a message to the IP-task to close a socket. */
-    eSocketSelectEvent,   /*12: Send a message to the IP-task for select(). */
-    eSocketSignalEvent,   /*13: A socket must be signalled. */
-    eSocketSetDeleteEvent /*14: A socket set must be deleted. */
+    eNetworkDownEvent,     /* 0: The network interface has been lost and/or needs [re]connecting. */
+    eNetworkRxEvent,       /* 1: The network interface has queued a received Ethernet frame. */
+    eNetworkTxEvent,       /* 2: Let the IP-task send a network packet. */
+    eARPTimerEvent,        /* 3: The ARP timer expired. */
+    eNDTimerEvent,         /* 4: The ND timer expired. */
+    eStackTxEvent,         /* 5: The software stack has queued a packet to transmit. */
+    eDHCPEvent,            /* 6: Process the DHCP state machine. */
+    eTCPTimerEvent,        /* 7: See if any TCP socket needs attention. */
+    eTCPAcceptEvent,       /* 8: Client API FreeRTOS_accept() waiting for client connections. */
+    eTCPNetStat,           /* 9: IP-task is asked to produce a netstat listing. */
+    eSocketBindEvent,      /*10: Send a message to the IP-task to bind a socket to a port. */
+    eSocketCloseEvent,     /*11: Send a message to the IP-task to close a socket. */
+    eSocketSelectEvent,    /*12: Send a message to the IP-task for select(). */
+    eSocketSignalEvent,    /*13: A socket must be signalled. */
+    eSocketSetDeleteEvent, /*14: A socket set must be deleted. */
+    eStackTxChainEvent,    /*15: The software stack has queued a chain of packets to transmit. */
+    eStackTxSegmentsEvent, /*16: The software stack has queued the segments of a large UDP buffer. */
+    eTCPHashUpdateEvent,   /*17: A user task has changed the state of a TCP socket, update the hash tables. */
+    eEventPollWaitEvent,   /*18: FreeRTOS_EventPollWait() asks the IP-task to collect the ready sockets. */
+    eEventPollDeleteEvent  /*19: An event-poll set must be deleted. */
 } eIPEvent_t;
 
 /**
@@ -256,6 +265,8 @@ struct xPacketSummary
     ProtocolHeaders_t * pxProtocolHeaders; /**< Points to first byte after IP-header */
     uint16_t usPayloadLength;              /**< Property of IP-header (for IPv4: length of IP-header included) */
     uint16_t usProtocolBytes;              /**< The total length of the protocol data. */
+    size_t uxPayloadSummed;                /**< The number of bytes at the end of the payload that are summed already. */
+    uint16_t usPayloadSum;                 /**< The sum of those bytes. */
 };
 
 /* Offset into the Ethernet frame that is used to temporarily store information
@@ -434,6 +445,33 @@ uint16_t usGenerateChecksum( uint16_t usSum,
                              const uint8_t * pucNextData,
                              size_t uxByteCount );
 
+/*
+ * Update a checksum after a field in the data was changed from an old value
+ * to a new value (RFC 1624), without summing the data again.
+ */
+uint16_t usChecksumAdjust16( uint16_t usChecksum,
+                             uint16_t usOldValue,
+                             uint16_t usNewValue );
+
+uint16_t usChecksumAdjust32( uint16_t usChecksum,
+                             uint32_t ulOldValue,
+                             uint32_t ulNewValue );
+
+/*
+ * Copy a block of data, and return the same value as usGenerateChecksum()
+ * would return for it. Each byte is read only once.
+ */
+uint16_t usCopyAndChecksum( uint16_t usSum,
+                            uint8_t * pucDestination,
+                            const uint8_t * pucSource,
+                            size_t uxByteCount );
+
+/*
+ * Add the sums of two consecutive blocks of data.
+ */
+uint16_t usChecksumAdd( uint16_t usSum1,
+                        uint16_t usSum2 );
+
 /* Socket related private functions. */
 
 /*
@@ -467,6 +505,15 @@ BaseType_t xIPIsNetworkTaskReady( void );
  */
     TickType_t xTCPTimerCheck( BaseType_t xWillSleep );
 
+    #if ( ipconfigUSE_TCP_TIMER_WHEEL == 1 )
+
+/*
+ * Schedule the time-out 'usTimeout' of a socket in the TCP timer wheel, and
+ * remember the socket when it has events for its owner.
+ */
+        void vTCPTimerWheelUpdate( struct xSOCKET * pxSocket );
+    #endif
+
 /**
  * About the TCP flags 'bPassQueued' and 'bPassAccept':
  *
@@ -502,6 +549,14 @@ BaseType_t xIPIsNetworkTaskReady( void );
         } u; /**< The structure to give an alignment of 4 + 2 */
     } LastTCPPacket_t;
 
+/* prvTCPPrepareSend() sums the payload of an outgoing packet when it copies
+ * it, or when it attaches it as fragments. */
+    #if ( ( ipconfigUSE_TCP_FUSED_COPY_CHECKSUM == 1 ) || ( ipconfigUSE_TCP_TX_SCATTER_GATHER == 1 ) )
+        #define ipTCP_TX_PAYLOAD_SUM    1
+    #else
+        #define ipTCP_TX_PAYLOAD_SUM    0
+    #endif
+
 /**
  * Note that the values of all short and long integers in these structs
  * are being stored in the native-endian way
@@ -539,6 +594,17 @@ BaseType_t xIPIsNetworkTaskReady( void );
                 bFinLast : 1,          /**< The last ACK (after FIN and FIN+ACK) has been sent or will be sent by the peer */
                 bRxStopped : 1,        /**< Application asked to temporarily stop reception */
                 bMallocError : 1,      /**< There was an error allocating a stream */
+            #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+                bTimeStamps : 1,       /**< The TCP time-stamp option was offered and accepted in the SYN phase. */
+            #endif
+            #if ( ipconfigUSE_TCP_REUSE_PORT == 1 )
+                bReusePort : 1,        /**< The socket may share its local port with other sockets that have this flag set. */
+            #endif
+                bNoDelay : 1,          /**< FREERTOS_SO_TCP_NODELAY: do not use the Nagle algorithm. */
+                bCork : 1,             /**< FREERTOS_SO_TCP_CORK: only send segments of MSS bytes, until the option is cleared. */
+            #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+                bRxPush : 1,           /**< The segment being handled has the PSH flag set. */
+            #endif
                 bWinScaling : 1;       /**< A TCP-Window Scaling option was offered and accepted in the SYN phase. */
         } bits;                        /**< The bits structure */
         uint32_t ulHighestRxAllowed;   /**< The highest sequence number that we can receive at any moment */
@@ -551,6 +617,17 @@ BaseType_t xIPIsNetworkTaskReady( void );
                                         * TCP win segments */
         eIPTCPState_t eTCPState;       /**< TCP state: see eTCP_STATE */
         struct xSOCKET * pxPeerSocket; /**< for server socket: child, for child socket: parent */
+        #if ( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+            ListItem_t xHashListItem;  /**< Used to reference the socket from the connection hash or from the listen index. */
+        #endif /* ipconfigUSE_TCP_SOCKET_HASH */
+        #if ( ipconfigUSE_TCP_TIMER_WHEEL == 1 )
+            TimerWheelEntry_t xTimerEntry; /**< Schedules 'usTimeout' in the TCP timer wheel. */
+            struct xSOCKET * pxNextWakeUp; /**< The next socket that has events for its owner. */
+            struct xSOCKET * pxNextPoked;  /**< The next socket whose 'usTimeout' was set by an API. */
+            BaseType_t xWakeUpQueued;      /**< pdTRUE while the socket is in the list of sockets with events. */
+            volatile BaseType_t xPoked;    /**< pdTRUE while the socket is in the list of poked sockets. */
+            uint16_t usWheelTimeout;       /**< The value of 'usTimeout' when the timer was scheduled. */
+        #endif /* ipconfigUSE_TCP_TIMER_WHEEL */
         #if ( ipconfigTCP_KEEP_ALIVE == 1 )
             uint8_t ucKeepRepCount;
             TickType_t xLastAliveTime; /**< The last value of keepalive time.*/
@@ -567,6 +644,17 @@ BaseType_t xIPIsNetworkTaskReady( void );
         #if ( ipconfigUSE_TCP_WIN == 1 )
             NetworkBufferDescriptor_t * pxAckMessage; /**< The pointer to the ACK message */
         #endif /* ipconfigUSE_TCP_WIN */
+        #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+            TCPAckPolicy_t xAckPolicy;                /**< The delayed-ACK policy, see FREERTOS_SO_TCP_ACK_POLICY. */
+            TickType_t xLastRxDataTime;               /**< The time when the last segment with data was received. */
+            uint32_t ulAcksSaved;                     /**< The number of ACKs that were not sent because a later ACK replaced them. */
+            uint8_t ucRxUnacked;                      /**< The number of received segments covered by 'pxAckMessage'. */
+            uint8_t ucQuickAcks;                      /**< The number of segments that will still be acknowledged immediately. */
+        #endif /* ipconfigUSE_TCP_ACK_POLICY */
+        #if ( ipTCP_TX_PAYLOAD_SUM == 1 )
+            size_t uxTxPayloadSummed;                 /**< The number of payload bytes summed by prvTCPPrepareSend(), or zero. */
+            uint16_t usTxPayloadSum;                  /**< The sum of those bytes. */
+        #endif
         LastTCPPacket_t xPacket;                      /**< Buffer space to store the last TCP header received. */
         uint8_t tcpflags;                             /**< TCP flags */
         #if ( ipconfigUSE_TCP_WIN != 0 )
@@ -596,9 +684,15 @@ BaseType_t xIPIsNetworkTaskReady( void );
 typedef struct UDPSOCKET
 {
     List_t xWaitingPacketsList;   /**< Incoming packets */
+    #if ( ipconfigUSE_UDP_PORT_HASH == 1 )
+        ListItem_t xHashListItem; /**< Used to reference the socket from the UDP port hash table. */
+    #endif /* ipconfigUSE_UDP_PORT_HASH */
     #if ( ipconfigUDP_MAX_RX_PACKETS > 0 )
         UBaseType_t uxMaxPackets; /**< Protection: limits the number of packets buffered per socket */
     #endif /* ipconfigUDP_MAX_RX_PACKETS */
+    #if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+        uint16_t usSegmentSize; /**< The payload size of the datagrams sent by FreeRTOS_sendto(), zero when not used. */
+    #endif /* ipconfigUSE_UDP_SEGMENTATION */
     #if ( ipconfigUSE_CALLBACKS == 1 )
         FOnUDPReceive_t pxHandleReceive; /**<
                                           * In case of a UDP socket:
@@ -660,6 +754,15 @@ struct xSOCKET
         EventBits_t xSocketBits;          /**< These bits indicate the events which have actually occurred.
                                            * They are maintained by the IP-task */
     #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
+    #if ( ipconfigSUPPORT_EVENT_POLL == 1 )
+        struct xEVENT_POLL * pxEventPoll; /**< The event-poll set to which the socket belongs. */
+        struct xSOCKET * pxNextPollMember; /**< The next socket in the same event-poll set. */
+        struct xSOCKET * pxNextPollReady;  /**< The next socket in the list of ready sockets. */
+        EventBits_t xPollEvents;           /**< The events that were not reported yet. */
+        uint8_t ucPollMode;                /**< Either eEventPollLevel or eEventPollEdge. */
+        uint8_t ucPollQueued;              /**< Non-zero while the socket is in the list of ready sockets. */
+        uint8_t ucPollCheck;               /**< Non-zero when the IP-task must check the state of the socket, because it was just added to the set. */
+    #endif /* ipconfigSUPPORT_EVENT_POLL */
     struct xNetworkEndPoint * pxEndPoint; /**< The end-point to which the socket is bound. */
 
     /* This field is only only by the user, and can be accessed with
@@ -703,6 +806,17 @@ struct xSOCKET
                                            IPv46_Address_t xRemoteIP,
                                            UBaseType_t uxRemotePort );
 
+    #if ( ipconfigUSE_TCP_SOCKET_HASH == 1 )
+
+/*
+ * Store a TCP socket in the connection hash table or in the listen index,
+ * depending on its current state. Must be called after the state or the
+ * remote address of a socket has changed. When called from a user task,
+ * the update is passed to the IP-task.
+ */
+        void vTCPSocketHashUpdate( FreeRTOS_Socket_t * pxSocket );
+    #endif
+
 #endif /* ipconfigUSE_TCP */
 
 
@@ -722,6 +836,15 @@ uint16_t usGenerateProtocolChecksum( uint8_t * pucEthernetBuffer,
                                      size_t uxBufferLength,
                                      BaseType_t xOutgoingPacket );
 
+/*
+ * Like usGenerateProtocolChecksum() for an outgoing packet, when the sum of
+ * the last 'uxPayloadSummed' bytes of the payload is known already.
+ */
+uint16_t usGenerateProtocolChecksumPartial( uint8_t * pucEthernetBuffer,
+                                            size_t uxBufferLength,
+                                            size_t uxPayloadSummed,
+                                            uint16_t usPayloadSum );
+
 /*
  * An Ethernet frame has been updated (maybe it was an ARP request or a PING
  * request?) and is to be sent back to its source.
@@ -841,6 +964,41 @@ BaseType_t xIsCallingFromIPTask( void );
 
 #endif /* ipconfigSUPPORT_SELECT_FUNCTION */
 
+#if ( ipconfigSUPPORT_EVENT_POLL == 1 )
+
+/** @brief An event-poll set, see FreeRTOS_EventPollWait(). The lists are
+ *         protected by a critical section.  The state of the member sockets
+ *         is only checked by the IP-task. */
+    typedef struct xEVENT_POLL
+    {
+        EventGroupHandle_t xPollGroup;  /**< Gets a bit set when a socket is added to the ready list. */
+        struct xSOCKET * pxMembers;     /**< The sockets that belong to this set. */
+        struct xSOCKET * pxReadyHead;   /**< The first socket with events that were not reported yet. */
+        struct xSOCKET * pxReadyTail;   /**< The last socket in the ready list. */
+        UBaseType_t uxReadyCount;       /**< The number of sockets in the ready list. */
+    } EventPollSet_t;
+
+/** @brief Define the data that must be passed for an 'eEventPollWaitEvent'. */
+    typedef struct xEVENT_POLL_MESSAGE
+    {
+        EventPollSet_t * pxSet;           /**< The event-poll set. */
+        EventPollResult_t * pxResults;    /**< The ready sockets are written here. */
+        BaseType_t xMaxResults;           /**< The number of elements in 'pxResults'. */
+        BaseType_t xCount;                /**< Set by the IP-task to the number of results. */
+    } EventPollMessage_t;
+
+/* Called by the IP-task when events occurred for a socket in an event-poll set. */
+    void vSocketEventPollSignal( FreeRTOS_Socket_t * pxSocket,
+                                 EventBits_t xEvents );
+
+/* Called by the IP-task to collect the ready sockets for FreeRTOS_EventPollWait(). */
+    void vSocketEventPollCollect( EventPollMessage_t * pxMessage );
+
+/* Called by the IP-task to delete an event-poll set. */
+    void vSocketEventPollDelete( EventPollSet_t * pxSet );
+
+#endif /* ipconfigSUPPORT_EVENT_POLL */
+
 /* Send the network-up event and start the ARP/ND timers. */
 void vIPNetworkUpCalls( struct xNetworkEndPoint * pxEndPoint );
 
@@ -107,7 +107,8 @@
         {
             uint32_t
                 bInterfaceUp : 1,             /**< Non-zero as soon as the interface is up. */
-                bCallDownEvent : 1;           /**< The down-event must be called. */
+                bCallDownEvent : 1,           /**< The down-event must be called. */
+                bTxScatterGather : 1;         /**< Set by the driver when pfOutput() accepts network buffers with fragments, see ipconfigUSE_TCP_TX_SCATTER_GATHER. */
         } bits;                               /**< A collection of boolean flags. */
 
         struct xNetworkEndPoint * pxEndPoint; /**< A list of end-points bound to this interface. */
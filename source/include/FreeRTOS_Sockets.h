@@ -150,6 +150,27 @@
     #if ( ipconfigUSE_TCP == 1 )
         #define FREERTOS_SO_SET_LOW_HIGH_WATER            ( 18 )
     #endif
+
+    #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+        #define FREERTOS_SO_TCP_CONGESTION                ( 19 ) /* Select a congestion control algorithm by name, at level FREERTOS_IPPROTO_TCP. */
+    #endif
+
+    #if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+        #define FREERTOS_SO_UDP_SEGMENT                   ( 20 ) /* Let FreeRTOS_sendto() split large buffers in datagrams of this size, parameter is pointer to uint16_t. */
+    #endif
+
+    #if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_REUSE_PORT == 1 ) )
+        #define FREERTOS_SO_REUSEPORT                     ( 21 ) /* Let several listening sockets share a TCP port, set before binding, parameter is pointer to BaseType_t. */
+    #endif
+
+    #if ( ipconfigUSE_TCP == 1 )
+        #define FREERTOS_SO_TCP_NODELAY                   ( 22 ) /* Do not hold back small segments (Nagle algorithm), parameter is pointer to BaseType_t. */
+        #define FREERTOS_SO_TCP_CORK                      ( 23 ) /* Only send full-size segments until the option is cleared, parameter is pointer to BaseType_t. */
+    #endif
+
+    #if ( ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_ACK_POLICY == 1 ) )
+        #define FREERTOS_SO_TCP_ACK_POLICY                ( 24 ) /* Set the delayed-ACK policy of a TCP socket, parameter is pointer to TCPAckPolicy_t. */
+    #endif
     #define FREERTOS_INADDR_ANY                           ( 0U )           /* The 0.0.0.0 IPv4 address. */
     #define FREERTOS_INADDR_BROADCAST                     ( 0xffffffffUL ) /* 255.255.255.255 is a special broadcast address that represents all host attached to the physical network. */
 
@@ -267,6 +288,33 @@
                                struct freertos_sockaddr * pxSourceAddress,
                                socklen_t * pxSourceAddressLength );
 
+    #if ( ipconfigSUPPORT_UDP_MULTI_MESSAGES == 1 )
+
+/**
+ * One datagram, as received by FreeRTOS_recvfrom_multi() or sent by
+ * FreeRTOS_sendto_multi().
+ */
+        typedef struct xFREERTOS_MMSG
+        {
+            void * pvBuffer;                   /**< The payload. With FREERTOS_ZERO_COPY, a UDP payload buffer of the stack. */
+            size_t uxBufferLength;             /**< Receive: the size of 'pvBuffer'. Send: the number of bytes to send. */
+            struct freertos_sockaddr xAddress; /**< Receive: the source address. Send: the destination address. */
+            size_t uxLength;                   /**< The number of bytes received or sent. */
+        } FreeRTOS_MMsg_t;
+
+/* Receive up to 'xMessageCount' datagrams from a UDP socket. */
+        BaseType_t FreeRTOS_recvfrom_multi( Socket_t xSocket,
+                                            FreeRTOS_MMsg_t * pxMessages,
+                                            BaseType_t xMessageCount,
+                                            BaseType_t xFlags );
+
+/* Send 'xMessageCount' datagrams through a UDP socket, in a single message to the IP-task. */
+        BaseType_t FreeRTOS_sendto_multi( Socket_t xSocket,
+                                          FreeRTOS_MMsg_t * pxMessages,
+                                          BaseType_t xMessageCount,
+                                          BaseType_t xFlags );
+    #endif /* ipconfigSUPPORT_UDP_MULTI_MESSAGES == 1 */
+
 
 /* Function to get the local address and IP port. */
     size_t FreeRTOS_GetLocalAddress( ConstSocket_t xSocket,
@@ -307,6 +355,22 @@
             size_t uxEnoughSpace; /**< Send a GO when buffer space grows above X bytes */
         } LowHighWater_t;
 
+        #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+
+/**
+ * Structure to pass for the 'FREERTOS_SO_TCP_ACK_POLICY' option.
+ * A structure filled with zeros selects the built-in policy.
+ */
+            typedef struct xTCP_ACK_POLICY
+            {
+                uint8_t ucAckEvery;         /**< Send an ACK after at most this many received segments, zero means no limit. */
+                uint8_t ucQuickAckCount;    /**< Acknowledge this many segments immediately at the start of a connection and after an idle period. */
+                uint16_t usAckDelayMs;      /**< The maximum time that an ACK may be delayed, at most 500 ms, zero selects the built-in delays. */
+                uint16_t usQuickAckIdleMs;  /**< Return to quick ACKs when no data was received for this time, zero means never. */
+                BaseType_t xAckOnPush;      /**< When non-zero, a segment with the PSH flag is acknowledged immediately. */
+            } TCPAckPolicy_t;
+        #endif /* ipconfigUSE_TCP_ACK_POLICY */
+
 /* Connect a TCP socket to a remote socket. */
         BaseType_t FreeRTOS_connect( Socket_t xClientSocket,
                                      const struct freertos_sockaddr * pxAddress,
@@ -374,6 +438,11 @@
 /* For internal use only: return the connection status. */
         BaseType_t FreeRTOS_connstatus( ConstSocket_t xSocket );
 
+        #if ( ipconfigUSE_TCP_ACK_POLICY == 1 )
+/* Returns the number of ACKs that were saved by delaying them. */
+            uint32_t FreeRTOS_tcp_acks_saved( ConstSocket_t xSocket );
+        #endif
+
 /* For advanced applications only:
  * Get a direct pointer to the beginning of the circular transmit buffer.
  * In case the buffer was not yet created, it will be created in
@@ -563,6 +632,55 @@
 
     #endif /* ( ipconfigSUPPORT_SELECT_FUNCTION == 1 ) */
 
+    #if ( ipconfigSUPPORT_EVENT_POLL == 1 )
+
+/* An event-poll set is an alternative for a socket set: a socket adds itself
+ * to a list of ready sockets when an event occurs, so that waiting for events
+ * does not need to inspect all sockets. */
+        struct xEVENT_POLL;
+        typedef struct xEVENT_POLL * EventPoll_t;
+
+/* The way in which the events of a socket in an event-poll set are reported. */
+        typedef enum eEVENT_POLL_MODE
+        {
+            eEventPollLevel = 0, /* Report the socket as long as it is readable, writable, or closed. */
+            eEventPollEdge       /* Report the socket once for every new event. */
+        } eEventPollMode_t;
+
+/* A socket that is returned by FreeRTOS_EventPollWait(), along with the
+ * events that occurred, a combination of eSELECT_READ, eSELECT_WRITE and
+ * eSELECT_EXCEPT. */
+        typedef struct xEVENT_POLL_RESULT
+        {
+            Socket_t xSocket;
+            EventBits_t xEvents;
+        } EventPollResult_t;
+
+/* Create an event-poll set. */
+        EventPoll_t FreeRTOS_EventPollCreate( void );
+
+/* Delete an event-poll set, the sockets in the set are removed from it. */
+        void FreeRTOS_EventPollDelete( EventPoll_t xEventPoll );
+
+/* Add a socket to an event-poll set, or change its events of interest. */
+        BaseType_t FreeRTOS_EventPollAdd( EventPoll_t xEventPoll,
+                                          Socket_t xSocket,
+                                          EventBits_t xEvents,
+                                          eEventPollMode_t eMode );
+
+/* Remove a socket from an event-poll set. */
+        BaseType_t FreeRTOS_EventPollRemove( EventPoll_t xEventPoll,
+                                             Socket_t xSocket );
+
+/* Wait until at least one socket in the set is ready, and return at most
+ * 'xMaxResults' ready sockets. */
+        BaseType_t FreeRTOS_EventPollWait( EventPoll_t xEventPoll,
+                                           EventPollResult_t * pxResults,
+                                           BaseType_t xMaxResults,
+                                           TickType_t xBlockTimeTicks );
+
+    #endif /* ( ipconfigSUPPORT_EVENT_POLL == 1 ) */
+
 
     #if ipconfigUSE_IPv4
         /* Translate from dot-decimal notation (example 192.168.1.1) to a 32-bit number. */
@@ -49,6 +49,10 @@ typedef struct xSTREAM_BUFFER
     volatile size_t uxMid;               /**< iterator within the valid items */
     volatile size_t uxHead;              /**< next position store a new item */
     volatile size_t uxFront;             /**< iterator within the free space */
+    #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+        volatile UBaseType_t uxReferences; /**< number of network buffers that send straight from ucArray */
+        volatile BaseType_t xOrphaned;     /**< the owner has gone, the last reference frees the buffer */
+    #endif
     size_t LENGTH;                       /**< const value: number of reserved elements */
     uint8_t ucArray[ sizeof( size_t ) ]; /**< array big enough to store any pointer address */
 } StreamBuffer_t;
@@ -92,6 +96,22 @@ size_t uxStreamBufferGet( StreamBuffer_t * const pxBuffer,
                           size_t uxMaxCount,
                           BaseType_t xPeek );
 
+#if ( ipconfigUSE_TCP_FUSED_COPY_CHECKSUM == 1 )
+    size_t uxStreamBufferPeekChecksum( const StreamBuffer_t * const pxBuffer,
+                                       size_t uxOffset,
+                                       uint8_t * const pucData,
+                                       size_t uxMaxCount,
+                                       uint16_t * pusSum );
+#endif
+
+#if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+    void vStreamBufferReference( StreamBuffer_t * const pxBuffer );
+
+    void vStreamBufferDereference( StreamBuffer_t * const pxBuffer );
+
+    BaseType_t xStreamBufferOrphan( StreamBuffer_t * const pxBuffer );
+#endif
+
 /* *INDENT-OFF* */
 #ifdef __cplusplus
     } /* extern "C" */
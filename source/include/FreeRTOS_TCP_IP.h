@@ -109,7 +109,8 @@ typedef enum eTCP_STATE
 #define tcpTCP_OPT_WSOPT_LEN              3U             /**< Length of TCP WSOPT option. */
 #define tcpTCP_OPT_WSOPT_MAXIMUM_VALUE    ( 14U )        /**< Maximum value of TCP WSOPT option. */
 
-#define tcpTCP_OPT_TIMESTAMP_LEN          10             /**< fixed length of the time-stamp option. */
+#define tcpTCP_OPT_TIMESTAMP_LEN          10U            /**< fixed length of the time-stamp option. */
+#define tcpTCP_OPT_TIMESTAMP_SPACE        12U            /**< The time-stamp option preceded by 2 NOP's, as it is sent. */
 
 /** @brief
  * Minimum segment length as outlined by RFC 791 section 3.1.
@@ -142,6 +143,7 @@ typedef enum eTCP_STATE
  */
 #define tcpDELAYED_ACK_SHORT_DELAY_MS       ( 2 )           /**< Should not become smaller than 1. */
 #define tcpDELAYED_ACK_LONGER_DELAY_MS      ( 20 )          /**< Longer delay for ACK. */
+#define tcpDELAYED_ACK_MAX_DELAY_MS         ( 500U )        /**< RFC 1122: an ACK must not be delayed by more than 0.5 seconds. */
 
 
 /** @brief
@@ -41,6 +41,17 @@
 BaseType_t prvCheckOptions( FreeRTOS_Socket_t * pxSocket,
                             const NetworkBufferDescriptor_t * pxNetworkBuffer );
 
+#if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/*
+ * Called from xProcessReceivedTCPPacket, after prvCheckOptions(). Negotiate
+ * the time-stamp option, update TS.Recent and apply PAWS. This function
+ * returns pdFAIL if the segment is an old duplicate that must be dropped.
+ */
+    BaseType_t prvCheckTimestamps( FreeRTOS_Socket_t * pxSocket,
+                                   NetworkBufferDescriptor_t * pxNetworkBuffer );
+#endif
+
 /*
  * Called from prvTCPHandleState().  Find the TCP payload data and check and
  * return its length.
@@ -0,0 +1,99 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_TCP_SYN_CACHE_H
+#define FREERTOS_TCP_SYN_CACHE_H
+
+/**
+ * @file FreeRTOS_TCP_SYN_Cache.h
+ * @brief A table of half-open TCP connections, and SYN cookies.
+ *
+ * When ipconfigUSE_TCP_SYN_CACHE is enabled, a listening socket does not
+ * create a new socket when it receives a SYN. The connection is stored in a
+ * small table, and answered with a SYN+ACK. The socket is created when the
+ * peer sends the ACK that completes the three-way handshake.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+#if ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SYN_CACHE == 1 )
+
+/** @brief A half-open connection. */
+    typedef struct xSYN_CACHE_ENTRY
+    {
+        IP_Address_t xRemoteIP;        /**< The IP-address of the peer, an IPv4 address is stored in host-endian notation. */
+        TickType_t xCreationTime;      /**< The time at which the SYN was received. */
+        uint32_t ulOurSequenceNumber;  /**< The initial sequence number of this side. */
+        uint32_t ulPeerSequenceNumber; /**< The initial sequence number of the peer. */
+        uint16_t usLocalPort;          /**< The local port number, host-endian. */
+        uint16_t usRemotePort;         /**< The port number of the peer, host-endian. */
+        uint16_t usPeerMSS;            /**< The MSS announced by the peer, or zero when it was absent. */
+        uint8_t ucPeerWinScaleFactor;  /**< The window scale factor of the peer. */
+        uint8_t ucMyWinScaleFactor;    /**< The window scale factor of this side. */
+        uint8_t ucFlags;               /**< The synFLAG_ bits, see FreeRTOS_TCP_SYN_Cache.c. */
+    } SynCacheEntry_t;
+
+/*
+ * A listening socket has received a SYN. Store the connection in the SYN
+ * cache, or encode it in a SYN cookie, and reply with a SYN+ACK. The reply
+ * is built in the network buffer, which stays owned by the caller. Returns
+ * pdTRUE when a SYN+ACK was sent.
+ */
+    BaseType_t xTCPSynCacheAdd( const FreeRTOS_Socket_t * pxSocket,
+                                NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                uint32_t ulInitialSequenceNumber );
+
+/*
+ * A listening socket has received an ACK. If it completes a handshake that
+ * was started by xTCPSynCacheAdd(), create the new socket in the state
+ * eSYN_RECEIVED and return it. The caller will then handle the ACK as if it
+ * were received by the new socket. NULL is returned when the ACK does not
+ * belong to a known connection, or when the socket can not be created.
+ */
+    FreeRTOS_Socket_t * pxTCPSynCacheAccept( FreeRTOS_Socket_t * pxSocket,
+                                             const NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_SYN_CACHE == 1 ) */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_TCP_SYN_CACHE_H */
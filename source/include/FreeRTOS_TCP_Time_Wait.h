@@ -0,0 +1,102 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_TCP_TIME_WAIT_H
+#define FREERTOS_TCP_TIME_WAIT_H
+
+/**
+ * @file FreeRTOS_TCP_Time_Wait.h
+ * @brief A table of TCP connections that are closing.
+ *
+ * When ipconfigUSE_TCP_TIME_WAIT is enabled, a socket that is closed while
+ * a FIN has been sent leaves a small record of its connection. The socket
+ * can be freed, while segments that arrive later are still handled as part
+ * of the closure.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+#if ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TIME_WAIT == 1 )
+
+/** @brief A connection that is closing. */
+    typedef struct xTIME_WAIT_ENTRY
+    {
+        IP_Address_t xRemoteIP;         /**< The IP-address of the peer, an IPv4 address is stored in host-endian notation. */
+        NetworkEndPoint_t * pxEndPoint; /**< The end-point of the connection, used to send our FIN again. */
+        TickType_t xCreationTime;       /**< The time at which the entry was made or refreshed. */
+        TickType_t xLastSendTime;       /**< The time at which our FIN was last sent. */
+        uint32_t ulFINSequenceNumber;   /**< The sequence number of our FIN. */
+        uint32_t ulPeerSequenceNumber;  /**< The next sequence number expected from the peer. */
+        uint16_t usLocalPort;           /**< The local port number, host-endian. */
+        uint16_t usRemotePort;          /**< The port number of the peer, host-endian. */
+        uint8_t ucFlags;                /**< The twFLAG_ bits, see FreeRTOS_TCP_Time_Wait.c. */
+        uint8_t ucRepCount;             /**< The number of times that our FIN was sent again by xTCPTimeWaitCheck(). */
+    } TimeWaitEntry_t;
+
+/*
+ * A TCP socket is about to be freed. When it has sent a FIN and is in one of
+ * the closing states, store its connection in the table. Returns pdTRUE
+ * when an entry was made.
+ */
+    BaseType_t xTCPTimeWaitAdd( const FreeRTOS_Socket_t * pxSocket );
+
+/*
+ * A TCP packet has arrived for which there is no active socket, or only a
+ * listening socket. If it belongs to a connection in the table, it will be
+ * answered or dropped, and pdTRUE is returned. The network buffer stays
+ * owned by the caller. pdFALSE means that the packet must be handled as
+ * usual.
+ */
+    BaseType_t xTCPTimeWaitProcess( NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+/*
+ * Called from the TCP timer of the IP-task. Our FIN is sent again for every
+ * entry in which it has not been acknowledged yet, with an increasing
+ * interval. Returns the time until the next FIN has to be sent.
+ */
+    TickType_t xTCPTimeWaitCheck( void );
+
+#endif /* ( ipconfigUSE_TCP == 1 ) && ( ipconfigUSE_TCP_TIME_WAIT == 1 ) */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_TCP_TIME_WAIT_H */
@@ -115,6 +115,17 @@ BaseType_t prvTCPCreateWindow( FreeRTOS_Socket_t * pxSocket );
 UBaseType_t prvSetSynAckOptions( FreeRTOS_Socket_t * pxSocket,
                                  TCPHeader_t * pxTCPHeader );
 
+#if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/*
+ * Add the time-stamp option at the end of the options of an outgoing
+ * packet, in case the option was negotiated.
+ */
+    UBaseType_t prvTCPAddTimestampOption( const FreeRTOS_Socket_t * pxSocket,
+                                          TCPHeader_t * pxTCPHeader,
+                                          UBaseType_t uxOptionsLength );
+#endif
+
 /*
  * Prepare an outgoing message, if anything has to be sent.
  */
@@ -153,6 +164,16 @@ BaseType_t prvTCPSendChallengeAck( NetworkBufferDescriptor_t * pxNetworkBuffer,
                                    uint32_t ulCurrentSequenceNumber,
                                    uint32_t ulOurSequenceNumber );
 
+#if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+
+/*
+ * Reply with an ACK to a segment that was dropped by PAWS. The ACK is built
+ * like any other ACK of the connection, so it carries the time-stamp option.
+ */
+    void prvTCPSendTimestampAck( FreeRTOS_Socket_t * pxSocket,
+                                 NetworkBufferDescriptor_t * pxNetworkBuffer );
+#endif
+
 /*
  * Reply to a peer with the RST flag on, in case a packet can not be handled.
  */
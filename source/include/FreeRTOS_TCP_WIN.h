@@ -64,6 +64,9 @@ typedef struct xTCP_SEGMENT
                 bOutstanding : 1,    /**< It the peer's turn, we're just waiting for an ACK */
                 bAcked : 1,          /**< This segment has been acknowledged */
                 bIsForRx : 1;        /**< pdTRUE if segment is used for reception */
+            #if ( ipconfigUSE_TCP_SACK_SCOREBOARD == 1 )
+                uint32_t bLost : 1;  /**< The SACK scoreboard found this segment lost, it has been queued for retransmission */
+            #endif
         } bits;
         uint32_t ulFlags;
     } u;                                /**< A collection of boolean flags. */
@@ -71,6 +74,12 @@ typedef struct xTCP_SEGMENT
         struct xLIST_ITEM xQueueItem;   /**< TX only: segments can be linked in one of three queues: xPriorityQueue, xTxQueue, and xWaitQueue */
         struct xLIST_ITEM xSegmentItem; /**< With this item the segment can be connected to a list, depending on who is owning it */
     #endif
+    #if ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+        struct xTCP_SEGMENT * pxIndexParent; /**< The parent node in the segment index of the window, NULL for the root */
+        struct xTCP_SEGMENT * pxIndexLeft;   /**< Index sub-tree with lower sequence numbers */
+        struct xTCP_SEGMENT * pxIndexRight;  /**< Index sub-tree with higher sequence numbers */
+        BaseType_t xIndexHeight;             /**< The height of the index sub-tree of which this segment is the root */
+    #endif
 } TCPSegment_t;
 
 /** @brief This struct describes the windows sizes, both for incoming and outgoing. */
@@ -84,11 +93,38 @@ typedef struct xTCP_WINSIZE
  * each packet, and thus the message space will become smaller.
  * Keep this as a multiple of 4 */
 #if ( ipconfigUSE_TCP_WIN == 1 )
-    #define ipSIZE_TCP_OPTIONS    16U
+    #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+        /* A SYN carries MSS, WSOPT, SACK_P and the time-stamp option. */
+        #define ipSIZE_TCP_OPTIONS    28U
+    #else
+        #define ipSIZE_TCP_OPTIONS    16U
+    #endif
 #else
     #define ipSIZE_TCP_OPTIONS    12U
 #endif
 
+#if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+    struct xTCP_WINDOW;
+
+/** @brief A congestion control algorithm, described as a table of hooks that
+ * are called by the sliding window.  The window itself takes care of fast
+ * recovery ( RFC 6582 ), the algorithm decides how cwnd grows and what the
+ * value of ssthresh becomes after a loss.
+ */
+    typedef struct xTCP_CONGESTION_OPS
+    {
+        const char * pcName;                                         /**< The name used to select the algorithm with FREERTOS_SO_TCP_CONGESTION */
+        void ( * fnInit )( struct xTCP_WINDOW * pxWindow );          /**< Reset the private state of the algorithm, may be NULL */
+        void ( * fnOnAck )( struct xTCP_WINDOW * pxWindow,
+                            uint32_t ulBytesAcked );                 /**< New data was acknowledged outside fast recovery: let cwnd grow */
+        void ( * fnOnLoss )( struct xTCP_WINDOW * pxWindow );        /**< A fast retransmission is about to start: set ssthresh */
+        void ( * fnOnTimeout )( struct xTCP_WINDOW * pxWindow,
+                                BaseType_t xFirstTimeout );          /**< The retransmission timer has expired: set ssthresh */
+        void ( * fnOnRTTSample )( struct xTCP_WINDOW * pxWindow,
+                                  uint32_t ulRoundTripTime );        /**< A new round-trip time in ms has been measured, may be NULL */
+    } TCPCongestionOps_t;
+#endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+
 /** @brief Every TCP connection owns a TCP window for the administration of all packets
  *  It owns two sets of segment descriptors, incoming and outgoing
  */
@@ -101,8 +137,10 @@ typedef struct xTCP_WINDOW
             uint32_t
                 bHasInit : 1,      /**< The window structure has been initialised */
                 bSendFullSize : 1, /**< May only send packets with a size equal to MSS (for optimisation) */
-                bTimeStamps : 1;   /**< Socket is supposed to use TCP time-stamps. This depends on the */
-        } bits;                    /**< party which opens the connection */
+                bTimeStamps : 1,   /**< Socket is supposed to use TCP time-stamps. This depends on the party which opens the connection */
+                bFastRecovery : 1, /**< Congestion control: a fast retransmission took place, the window is in fast recovery */
+                bNagle : 1;        /**< Hold back a small segment as long as sent data has not been acknowledged (RFC 896) */
+        } bits;                    /**< The flags as bit-fields. */
         uint32_t ulFlags;
     } u;                           /**< A collection of boolean flags. */
     TCPWinSize_t xSize;            /**< The TCP window sizes of the incoming and outgoing streams. */
@@ -130,6 +168,46 @@ typedef struct xTCP_WINDOW
         uint32_t ulOptionsData[ ipSIZE_TCP_OPTIONS / sizeof( uint32_t ) ]; /**< Contains the options we send out */
         List_t xTxSegments;                                                /**< A linked list of all transmission segments, sorted on sequence number */
         List_t xRxSegments;                                                /**< A linked list of reception segments, order depends on sequence of arrival */
+        #if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
+            UBaseType_t uxSegmentCount;                                    /**< The number of segment descriptors owned by this window, at most ipconfigTCP_WIN_SEG_QUOTA */
+            UBaseType_t uxSegmentsReserved;                                /**< The number of descriptors still reserved for this window, up to ipconfigTCP_WIN_SEG_RESERVED */
+        #endif
+        #if ( ipconfigUSE_TCP_WIN_SEGMENT_INDEX == 1 )
+            TCPSegment_t * pxTxSegmentIndex;                               /**< The root of a balanced tree of the segments in xTxSegments, ordered by sequence number */
+            TCPSegment_t * pxRxSegmentIndex;                               /**< The root of a balanced tree of the segments in xRxSegments, ordered by sequence number */
+        #endif
+        #if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+            uint32_t ulCongestionWindow;                                   /**< cwnd: the maximum number of bytes that may be outstanding */
+            uint32_t ulSlowStartThreshold;                                 /**< ssthresh: below this value cwnd grows with slow start, above it with congestion avoidance */
+            uint32_t ulRecoverSequenceNumber;                              /**< NewReno 'recover': the highest sequence number sent when fast recovery was entered */
+            uint32_t ulBytesAckedInAvoidance;                              /**< The number of bytes acknowledged since cwnd was last increased during congestion avoidance */
+            uint32_t ulSackRetransmitCount;                                /**< The number of segments queued for a fast retransmission by the SACK blocks of the current ACK */
+            const TCPCongestionOps_t * pxCongestionOps;                    /**< The congestion control algorithm, NULL selects NewReno */
+            #if ( ipconfigUSE_TCP_CUBIC == 1 )
+                struct
+                {
+                    uint32_t ulWMax;                                       /**< W_max: the size of cwnd just before the last reduction */
+                    uint32_t ulLastWMax;                                   /**< The previous W_max, used for fast convergence */
+                    uint32_t ulOrigin;                                     /**< The plateau of the cubic function in the current epoch */
+                    uint32_t ulK;                                          /**< K: the time needed to reach the plateau, in 1/64 seconds */
+                    uint32_t ulEstimate;                                   /**< W_est: the window that NewReno would have had in this epoch */
+                    uint32_t ulEstimateAcked;                              /**< The number of bytes acknowledged since W_est was last increased */
+                    uint32_t ulMinRTT;                                     /**< The lowest round-trip time measured, in ms, or zero when unknown */
+                    TickType_t uxEpochStart;                               /**< The time at which the current epoch started */
+                    BaseType_t xInEpoch;                                   /**< pdTRUE when an epoch of congestion avoidance has started */
+                } xCubic;                                                  /**< The private state of CUBIC */
+            #endif
+        #endif
+        #if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+            struct
+            {
+                uint32_t ulTSRecent;                                       /**< TS.Recent: the TSval of the peer that will be echoed in TSecr */
+                TickType_t xTSRecentTime;                                  /**< The time at which TS.Recent was last updated */
+                uint32_t ulTSValue;                                        /**< TSval of the segment being processed */
+                uint32_t ulTSEcho;                                         /**< TSecr of the segment being processed */
+                BaseType_t xReceived;                                      /**< pdTRUE when the segment being processed carries a valid time-stamp option */
+            } xTimeStamps;                                                 /**< The state of the TCP Timestamps option ( RFC 7323 ) */
+        #endif
     #else
         /* For tiny TCP, there is only 1 outstanding TX segment */
         TCPSegment_t xTxSegment; /**< Priority queue */
@@ -157,7 +235,7 @@ BaseType_t xTCPWindowCreate( TCPWindow_t * pxWindow,
 
 /* Destroy a window (always returns NULL)
  * It will free some resources: a collection of segments */
-void vTCPWindowDestroy( TCPWindow_t const * pxWindow );
+void vTCPWindowDestroy( TCPWindow_t * pxWindow );
 
 /* Initialize a window */
 void vTCPWindowInit( TCPWindow_t * pxWindow,
@@ -168,6 +246,41 @@ void vTCPWindowInit( TCPWindow_t * pxWindow,
 /* Clean up allocated segments. Should only be called when FreeRTOS+TCP will no longer be used. */
 void vTCPSegmentCleanup( void );
 
+#if ( ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 )
+
+/** @brief Statistics about the use of the arena of TCP segment descriptors. */
+    typedef struct xTCP_SEGMENT_STATS
+    {
+        UBaseType_t uxCapacity;     /**< The maximum number of descriptors: ipconfigTCP_WIN_SEG_COUNT */
+        UBaseType_t uxAllocated;    /**< The number of descriptors that has been allocated so far */
+        UBaseType_t uxInUse;        /**< The number of descriptors owned by sockets */
+        UBaseType_t uxHighWater;    /**< The highest value that uxInUse has had */
+        UBaseType_t uxReserved;     /**< The number of free descriptors that are reserved for sockets */
+        uint32_t ulQuotaRefusals;   /**< Requests refused because a socket owned ipconfigTCP_WIN_SEG_QUOTA descriptors */
+        uint32_t ulReserveRefusals; /**< Requests refused because the free descriptors were reserved for other sockets */
+        uint32_t ulExhausted;       /**< Requests refused because the arena could not grow any further */
+    } TCPSegmentStats_t;
+
+/* Get the statistics of the arena of TCP segment descriptors. */
+    void vTCPSegmentGetStats( TCPSegmentStats_t * pxStats );
+#endif /* ipconfigUSE_TCP_WIN_SEGMENT_ARENA == 1 */
+
+#if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+    /* The congestion control algorithms that are built in. */
+    extern const TCPCongestionOps_t xTCPCongestionNewReno;
+
+    #if ( ipconfigUSE_TCP_CUBIC == 1 )
+        extern const TCPCongestionOps_t xTCPCongestionCubic;
+    #endif
+
+    /* Look up a built-in congestion control algorithm by its name. */
+    const TCPCongestionOps_t * pxTCPWindowFindCongestionOps( const char * pcName,
+                                                              size_t uxNameLength );
+
+    /* The MSS was lowered before any data was sent: set the initial cwnd again. */
+    void vTCPWindowCongestionMSSChanged( TCPWindow_t * pxWindow );
+#endif /* ipconfigUSE_TCP_CONGESTION_CONTROL == 1 */
+
 /*=============================================================================
  *
  * Rx functions
@@ -223,6 +336,16 @@ uint32_t ulTCPWindowTxSack( TCPWindow_t * pxWindow,
                             uint32_t ulFirst,
                             uint32_t ulLast );
 
+#if ( ipconfigUSE_TCP_CONGESTION_CONTROL == 1 )
+    /* All SACK blocks of an ACK have been received */
+    void vTCPWindowTxSackDone( TCPWindow_t * pxWindow );
+#endif
+
+#if ( ipconfigUSE_TCP_TIMESTAMP_OPTION == 1 )
+    /* The clock that is sent out as TSval: a time in ms. */
+    uint32_t ulTCPWindowTimestamp( void );
+#endif
+
 /**
  * @brief Check if a > b, where a and b are rolling counters.
  *
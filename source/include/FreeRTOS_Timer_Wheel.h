@@ -0,0 +1,124 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+#ifndef FREERTOS_TIMER_WHEEL_H
+#define FREERTOS_TIMER_WHEEL_H
+
+/**
+ * @file FreeRTOS_Timer_Wheel.h
+ * @brief A hierarchical timer wheel, used to schedule the TCP socket timers.
+ *
+ * The wheel has ipTIMER_WHEEL_LEVELS levels of ipTIMER_WHEEL_SLOTS slots.
+ * A slot in level 0 holds the timers that expire at one particular tick, a
+ * slot in level 1 holds the timers of a period of ipTIMER_WHEEL_SLOTS ticks,
+ * and so on. When time passes the boundary of a higher level slot, its timers
+ * are moved to a lower level ("cascaded"). Adding and removing a timer takes
+ * a constant time, no matter how many timers are active.
+ */
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/** @brief The number of bits of the time handled by each level. */
+#define ipTIMER_WHEEL_SLOT_BITS    5U
+
+/** @brief The number of slots in each level of the wheel. */
+#define ipTIMER_WHEEL_SLOTS        ( 1U << ipTIMER_WHEEL_SLOT_BITS )
+
+/** @brief The number of levels, together they cover 2^20 clock ticks. */
+#define ipTIMER_WHEEL_LEVELS       4U
+
+/** @brief A timer that is scheduled in a timer wheel. */
+typedef struct xTIMER_WHEEL_ENTRY
+{
+    struct xTIMER_WHEEL_ENTRY * pxNext;     /**< The next timer in the same slot. */
+    struct xTIMER_WHEEL_ENTRY * pxPrevious; /**< The previous timer in the same slot. */
+    void * pvOwner;                         /**< The object that owns the timer, e.g. a socket. */
+    TickType_t xExpiryTime;                 /**< The tick count at which the timer expires. */
+    UBaseType_t uxSlot;                     /**< One more than the index of the slot, or zero when the timer is not active. */
+} TimerWheelEntry_t;
+
+/** @brief A hierarchical timer wheel. */
+typedef struct xTIMER_WHEEL
+{
+    TimerWheelEntry_t * pxSlots[ ipTIMER_WHEEL_LEVELS * ipTIMER_WHEEL_SLOTS ]; /**< The first timer of each slot. */
+    uint32_t ulOccupied[ ipTIMER_WHEEL_LEVELS ];                               /**< One bit for every slot that is not empty. */
+    TickType_t xCurrentTime;                                                   /**< The next tick to be handled. */
+    UBaseType_t uxCount;                                                       /**< The number of active timers. */
+} TimerWheel_t;
+
+/** @brief pdTRUE when the timer is scheduled in a wheel. */
+#define xTimerWheelEntryIsActive( pxEntry )    ( ( ( pxEntry )->uxSlot != 0U ) ? pdTRUE : pdFALSE )
+
+/*
+ * Initialise an empty wheel, time starts at 'xNow'.
+ */
+void vTimerWheelInit( TimerWheel_t * pxWheel,
+                      TickType_t xNow );
+
+/*
+ * Schedule a timer to expire at 'xExpiryTime'. If the timer was active, it is
+ * re-scheduled. A time in the past is treated as the current time.
+ */
+void vTimerWheelInsert( TimerWheel_t * pxWheel,
+                        TimerWheelEntry_t * pxEntry,
+                        TickType_t xExpiryTime );
+
+/*
+ * Cancel a timer. It is allowed to cancel a timer that is not active.
+ */
+void vTimerWheelRemove( TimerWheel_t * pxWheel,
+                        TimerWheelEntry_t * pxEntry );
+
+/*
+ * Advance the wheel up to 'xNow' and return the next timer that has expired,
+ * or NULL when there are no more. The returned timer is no longer active, so
+ * it may be inserted again before the next call.
+ */
+TimerWheelEntry_t * pxTimerWheelNextExpired( TimerWheel_t * pxWheel,
+                                             TickType_t xNow );
+
+/*
+ * Return the number of clock ticks after 'xNow' at which the wheel needs
+ * attention, or portMAX_DELAY when there are no active timers.
+ */
+TickType_t xTimerWheelNextTimeout( const TimerWheel_t * pxWheel,
+                                   TickType_t xNow );
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    } /* extern "C" */
+#endif
+/* *INDENT-ON* */
+
+#endif /* FREERTOS_TIMER_WHEEL_H */
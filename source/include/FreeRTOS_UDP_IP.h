@@ -47,6 +47,17 @@ void vProcessGeneratedUDPPacket( NetworkBufferDescriptor_t * const pxNetworkBuff
 void vProcessGeneratedUDPPacket_IPv4( NetworkBufferDescriptor_t * const pxNetworkBuffer );
 void vProcessGeneratedUDPPacket_IPv6( NetworkBufferDescriptor_t * const pxNetworkBuffer );
 
+#if ( ipconfigUSE_UDP_SEGMENTATION == 1 )
+
+/*
+ * Called when FreeRTOS_sendto() has split a large buffer in a chain of UDP
+ * packets, linked through 'pxNextBuffer', that all go to the same destination.
+ */
+    void vProcessGeneratedUDPSegments( NetworkBufferDescriptor_t * const pxNetworkBuffer );
+
+    void vProcessGeneratedUDPSegments_IPv4( NetworkBufferDescriptor_t * const pxNetworkBuffer );
+#endif
+
 /*
  * The caller must ensure that pxNetworkBuffer->xDataLength is the UDP packet
  * payload size (excluding packet headers) and that the packet in pucEthernetBuffer
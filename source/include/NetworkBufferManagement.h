@@ -61,6 +61,13 @@ UBaseType_t uxGetNumberOfFreeNetworkBuffers( void );
 /* Get the lowest number of free network buffers. */
 UBaseType_t uxGetMinimumFreeNetworkBuffers( void );
 
+/* The definition of the below functions is only available if BufferAllocation_3.c has been linked into the source.
+ * They return the buffer size, the current and the lowest number of free buffers of a size class.
+ * Classes are numbered from 0, the smallest, upwards.  The size of a class that does not exist is 0. */
+size_t uxGetNetworkBufferClassSize( UBaseType_t uxClass );
+UBaseType_t uxGetNumberOfFreeNetworkBuffersInClass( UBaseType_t uxClass );
+UBaseType_t uxGetMinimumFreeNetworkBuffersInClass( UBaseType_t uxClass );
+
 /* Copy a network buffer into a bigger buffer. */
 NetworkBufferDescriptor_t * pxDuplicateNetworkBufferWithDescriptor( const NetworkBufferDescriptor_t * const pxNetworkBuffer,
                                                                     size_t uxNewLength );
@@ -70,6 +77,53 @@ NetworkBufferDescriptor_t * pxDuplicateNetworkBufferWithDescriptor( const Networ
 NetworkBufferDescriptor_t * pxResizeNetworkBufferWithDescriptor( NetworkBufferDescriptor_t * pxNetworkBuffer,
                                                                  size_t xNewSizeBytes );
 
+#if ( ipBUFFER_ROOM != 0 )
+
+/* The stack itself does not use the functions below yet, they are meant for
+ * network interfaces and applications.  'uxLength' of a push or a pull must be
+ * a multiple of ipNETWORK_BUFFER_ROOM_ALIGNMENT, so the pointer to the
+ * descriptor in front of the frame stays valid.  BufferAllocation_1.c reserves
+ * no headroom, a push can only give back what was pulled before. */
+
+/* Move the start of the frame back by 'uxLength' bytes, so a header can be
+ * prepended in place.  Returns the new start of the frame, or NULL when there
+ * is not enough headroom or 'uxLength' is not aligned. */
+    uint8_t * pucNetworkBufferPush( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                    size_t uxLength );
+
+/* Move the start of the frame forward by 'uxLength' bytes, for instance to
+ * strip a header.  Returns the new start of the frame, or NULL when the frame
+ * is shorter than 'uxLength' or 'uxLength' is not aligned. */
+    uint8_t * pucNetworkBufferPull( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                    size_t uxLength );
+
+/* Extend the frame by 'uxLength' bytes at its end.  Returns a pointer to the
+ * added bytes, or NULL when there is not enough tailroom. */
+    uint8_t * pucNetworkBufferPut( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                   size_t uxLength );
+
+/* The number of bytes that can be pushed in front of, or put behind, the frame. */
+    size_t uxNetworkBufferHeadroom( const NetworkBufferDescriptor_t * pxNetworkBuffer );
+    size_t uxNetworkBufferTailroom( const NetworkBufferDescriptor_t * pxNetworkBuffer );
+#endif /* ipBUFFER_ROOM != 0 */
+
+#if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+
+/* The number of bytes that are sent after the 'xDataLength' bytes of the
+ * Ethernet buffer. */
+    size_t uxNetworkBufferFragmentBytes( const NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+/* Copy the fragments behind the Ethernet frame, growing the buffer when
+ * necessary, so that the frame becomes contiguous.  For drivers that can not
+ * send fragments.  Returns pdFAIL when the buffer could not be resized, in
+ * which case it is left unchanged. */
+    BaseType_t xNetworkBufferLinearise( NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+/* Drop the fragments and the reference to the stream that holds them.  The
+ * buffer allocators call this when a network buffer is released. */
+    void vNetworkBufferReleaseFragments( NetworkBufferDescriptor_t * pxNetworkBuffer );
+#endif /* ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 */
+
 #if ipconfigTCP_IP_SANITY
 
 /*
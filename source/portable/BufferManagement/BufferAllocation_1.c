@@ -105,6 +105,91 @@ static void prvShowWarnings( void );
 
 /*-----------------------------------------------------------*/
 
+#if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
+
+/* The user can define their own ipconfigBUFFER_ALLOC_NUM_CACHES and
+ * ipconfigBUFFER_ALLOC_CACHE_INDEX() macros.  If these are not defined then
+ * there is one cache per core, indexed by the ID of the calling core. */
+    #if !defined( ipconfigBUFFER_ALLOC_NUM_CACHES )
+        #if defined( configNUMBER_OF_CORES ) && ( configNUMBER_OF_CORES > 1 )
+            #define ipconfigBUFFER_ALLOC_NUM_CACHES    configNUMBER_OF_CORES
+        #else
+            #define ipconfigBUFFER_ALLOC_NUM_CACHES    1
+        #endif
+    #endif
+
+    #if !defined( ipconfigBUFFER_ALLOC_CACHE_INDEX )
+        #if ( ipconfigBUFFER_ALLOC_NUM_CACHES > 1 )
+            #define ipconfigBUFFER_ALLOC_CACHE_INDEX()    ( ( UBaseType_t ) portGET_CORE_ID() )
+        #else
+            #define ipconfigBUFFER_ALLOC_CACHE_INDEX()    ( 0U )
+        #endif
+    #endif
+
+    #if ( ( ipconfigBUFFER_ALLOC_CACHE_SIZE * ipconfigBUFFER_ALLOC_NUM_CACHES ) >= ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS )
+        #error All caches together must hold less than ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS descriptors
+    #endif
+
+/* The number of descriptors that are moved between a cache and the global
+ * free list at once. */
+    #define baCACHE_BATCH    ( ( ipconfigBUFFER_ALLOC_CACHE_SIZE + 1 ) / 2 )
+
+/** @brief A private stack of free descriptors, owned by one core.  It is only
+ * accessed by the owning core, with its interrupts masked, so no lock is shared
+ * with the other cores.  The descriptors in a cache are not counted by
+ * xNetworkBufferSemaphore. */
+    typedef struct xBUFFER_CACHE
+    {
+        UBaseType_t uxCount;                                                   /**< The number of descriptors in the cache. */
+        NetworkBufferDescriptor_t * pxBuffers[ ipconfigBUFFER_ALLOC_CACHE_SIZE ]; /**< The cached descriptors. */
+    } BufferCache_t;
+
+    static BufferCache_t xBufferCaches[ ipconfigBUFFER_ALLOC_NUM_CACHES ];
+
+/* A task that is about to block on xNetworkBufferSemaphore asks every core to
+ * empty its cache.  A core can only touch its own cache, so it does so during
+ * its next call to this module. */
+    static volatile BaseType_t xCacheDrainRequested[ ipconfigBUFFER_ALLOC_NUM_CACHES ];
+
+/* The number of tasks that are blocked on xNetworkBufferSemaphore.  While it
+ * is non-zero, released descriptors bypass the caches so that the semaphore
+ * is given and a waiting task is woken up. */
+    static volatile UBaseType_t uxWaitingTasks = 0U;
+
+/* pdTRUE for every descriptor that is free, in a cache or in the free list.
+ * Used to detect a descriptor that is released twice. */
+    static volatile uint8_t ucBufferIsFree[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ];
+
+    static BaseType_t prvMarkFree( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                   BaseType_t xIsFree );
+
+    static NetworkBufferDescriptor_t * prvCachePop( void );
+
+    static NetworkBufferDescriptor_t * prvCacheGet( void );
+
+    static BaseType_t prvCacheRelease( NetworkBufferDescriptor_t * const pxNetworkBuffer );
+
+    static void prvCacheFlush( void );
+
+    static BaseType_t prvTakeSemaphore( TickType_t xBlockTimeTicks );
+
+    static void prvReturnToFreeList( NetworkBufferDescriptor_t * const * ppxBuffers,
+                                     UBaseType_t uxCount );
+
+#endif /* ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 */
+
+static void prvResetDescriptor( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                size_t xRequestedSizeBytes );
+
+static void prvInitialiseDescriptor( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                     size_t xRequestedSizeBytes );
+
+#if ( ipBUFFER_ROOM != 0 )
+    static void prvRestoreFrame( NetworkBufferDescriptor_t * pxNetworkBuffer );
+#endif
+
+/*-----------------------------------------------------------*/
+
 #if ( ipconfigTCP_IP_SANITY != 0 )
 
 /* HT: SANITY code will be removed as soon as the library is stable
@@ -121,8 +206,21 @@ static void prvShowWarnings( void );
 
     BaseType_t prvIsFreeBuffer( const NetworkBufferDescriptor_t * pxDescr )
     {
-        return ( bIsValidNetworkDescriptor( pxDescr ) != 0 ) &&
-               ( listIS_CONTAINED_WITHIN( &xFreeBuffersList, &( pxDescr->xBufferListItem ) ) != 0 );
+        BaseType_t xIsFree = ( bIsValidNetworkDescriptor( pxDescr ) != 0 ) &&
+                             ( listIS_CONTAINED_WITHIN( &xFreeBuffersList, &( pxDescr->xBufferListItem ) ) != 0 );
+
+        #if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
+        {
+            /* A descriptor in one of the caches is free as well. */
+            if( ( bIsValidNetworkDescriptor( pxDescr ) != 0 ) &&
+                ( ucBufferIsFree[ pxDescr - xNetworkBuffers ] != 0U ) )
+            {
+                xIsFree = pdTRUE;
+            }
+        }
+        #endif /* ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 */
+
+        return xIsFree;
     }
     /*-----------------------------------------------------------*/
 
@@ -167,6 +265,442 @@ static void prvShowWarnings( void );
 
 #endif /* ipconfigTCP_IP_SANITY */
 
+#if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
+
+/**
+ * @brief Mark a descriptor as free or as in use.
+ *
+ * @param[in] pxNetworkBuffer The descriptor.
+ * @param[in] xIsFree pdTRUE when the descriptor is being released.
+ *
+ * @return pdFALSE when the descriptor was already marked that way, which
+ *         means that it is released twice.
+ */
+    static BaseType_t prvMarkFree( const NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                   BaseType_t xIsFree )
+    {
+        /* MISRA Ref 18.4.1 [Usage of +, -, += and -= operators on expression of pointer type]. */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-184. */
+        /* coverity[misra_c_2012_rule_18_4_violation] */
+        size_t uxIndex = ( size_t ) ( pxNetworkBuffer - xNetworkBuffers );
+        uint8_t ucNewValue = ( xIsFree != pdFALSE ) ? ( uint8_t ) pdTRUE : ( uint8_t ) pdFALSE;
+        BaseType_t xReturn = pdFALSE;
+
+        if( ucBufferIsFree[ uxIndex ] != ucNewValue )
+        {
+            ucBufferIsFree[ uxIndex ] = ucNewValue;
+            xReturn = pdTRUE;
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Take a descriptor from the cache of the calling core.  Can be called
+ *        from a task and from an interrupt.
+ *
+ * @return A free descriptor, or NULL when the cache is empty.
+ */
+    static NetworkBufferDescriptor_t * prvCachePop( void )
+    {
+        NetworkBufferDescriptor_t * pxReturn = NULL;
+        BufferCache_t * pxCache;
+        UBaseType_t uxSavedInterruptStatus;
+
+        /* Masking the interrupts of this core also keeps the calling task
+         * from being moved to another core. */
+        uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            pxCache = &( xBufferCaches[ ipconfigBUFFER_ALLOC_CACHE_INDEX() ] );
+
+            if( pxCache->uxCount > 0U )
+            {
+                pxCache->uxCount--;
+                pxReturn = pxCache->pxBuffers[ pxCache->uxCount ];
+            }
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+        return pxReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Take a descriptor from the cache of the calling core.  When the cache
+ *        is empty, refill it with a batch from the global free list, without
+ *        blocking.  When another task has asked for the caches to be emptied,
+ *        the rest of the cache is returned to the global free list instead.
+ *        Must not be called from an interrupt.
+ *
+ * @return A free descriptor, or NULL when both the cache and the global free
+ *         list are empty, or when another task is waiting for a descriptor.
+ */
+    static NetworkBufferDescriptor_t * prvCacheGet( void )
+    {
+        NetworkBufferDescriptor_t * pxReturn = NULL;
+        NetworkBufferDescriptor_t * pxBatch[ ipconfigBUFFER_ALLOC_CACHE_SIZE ];
+        BufferCache_t * pxCache;
+        UBaseType_t uxSavedInterruptStatus;
+        UBaseType_t uxCore;
+        UBaseType_t uxCount = 0U;
+        UBaseType_t x;
+
+        /* Masking the interrupts of this core also keeps the calling task
+         * from being moved to another core. */
+        uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            uxCore = ipconfigBUFFER_ALLOC_CACHE_INDEX();
+            pxCache = &( xBufferCaches[ uxCore ] );
+
+            if( pxCache->uxCount > 0U )
+            {
+                pxCache->uxCount--;
+                pxReturn = pxCache->pxBuffers[ pxCache->uxCount ];
+            }
+
+            if( xCacheDrainRequested[ uxCore ] != pdFALSE )
+            {
+                xCacheDrainRequested[ uxCore ] = pdFALSE;
+                uxCount = pxCache->uxCount;
+                pxCache->uxCount = 0U;
+
+                for( x = 0U; x < uxCount; x++ )
+                {
+                    pxBatch[ x ] = pxCache->pxBuffers[ x ];
+                }
+            }
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+        if( uxCount > 0U )
+        {
+            prvReturnToFreeList( pxBatch, uxCount );
+        }
+
+        /* Do not hoard descriptors while another task is waiting for one. */
+        if( ( pxReturn == NULL ) && ( uxWaitingTasks == 0U ) )
+        {
+            /* Each descriptor that leaves the global free list must be taken
+             * from the semaphore. */
+            for( uxCount = 0U; uxCount < ( UBaseType_t ) baCACHE_BATCH; uxCount++ )
+            {
+                if( xSemaphoreTake( xNetworkBufferSemaphore, 0U ) != pdPASS )
+                {
+                    break;
+                }
+            }
+
+            if( uxCount > 0U )
+            {
+                /* One critical section for the whole batch. */
+                ipconfigBUFFER_ALLOC_LOCK();
+                {
+                    for( x = 0U; x < uxCount; x++ )
+                    {
+                        pxBatch[ x ] = ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xFreeBuffersList );
+                        ( void ) uxListRemove( &( pxBatch[ x ]->xBufferListItem ) );
+                    }
+                }
+                ipconfigBUFFER_ALLOC_UNLOCK();
+
+                /* Keep one for the caller. */
+                uxCount--;
+                pxReturn = pxBatch[ uxCount ];
+
+                uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+                {
+                    pxCache = &( xBufferCaches[ ipconfigBUFFER_ALLOC_CACHE_INDEX() ] );
+
+                    while( ( uxCount > 0U ) && ( pxCache->uxCount < ( UBaseType_t ) ipconfigBUFFER_ALLOC_CACHE_SIZE ) )
+                    {
+                        uxCount--;
+                        pxCache->pxBuffers[ pxCache->uxCount ] = pxBatch[ uxCount ];
+                        pxCache->uxCount++;
+                    }
+                }
+                portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+                if( uxCount > 0U )
+                {
+                    /* An interrupt on this core has filled the cache in the
+                     * meantime. */
+                    prvReturnToFreeList( pxBatch, uxCount );
+                }
+            }
+        }
+
+        return pxReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Put a released descriptor in the cache of the calling core.  When the
+ *        cache is full, a batch of its descriptors is returned to the global
+ *        free list first.  When a task is waiting for a descriptor, the whole
+ *        cache is returned to the global free list, and the released descriptor
+ *        is left to the caller.  Must not be called from an interrupt.
+ *
+ * @param[in] pxNetworkBuffer The descriptor to be released, already marked
+ *                            as free.
+ *
+ * @return pdTRUE when the descriptor was put in the cache, pdFALSE when the
+ *         caller must put it in the global free list.
+ */
+    static BaseType_t prvCacheRelease( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+    {
+        NetworkBufferDescriptor_t * pxBatch[ ipconfigBUFFER_ALLOC_CACHE_SIZE ];
+        BufferCache_t * pxCache;
+        UBaseType_t uxSavedInterruptStatus;
+        UBaseType_t uxCore;
+        UBaseType_t uxCount = 0U;
+        UBaseType_t x;
+        BaseType_t xReturn = pdTRUE;
+
+        uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            uxCore = ipconfigBUFFER_ALLOC_CACHE_INDEX();
+            pxCache = &( xBufferCaches[ uxCore ] );
+
+            if( ( xCacheDrainRequested[ uxCore ] != pdFALSE ) || ( uxWaitingTasks != 0U ) )
+            {
+                /* Give everything back, so that the semaphore is given. */
+                xCacheDrainRequested[ uxCore ] = pdFALSE;
+                uxCount = pxCache->uxCount;
+                pxCache->uxCount = 0U;
+                xReturn = pdFALSE;
+            }
+            else if( pxCache->uxCount == ( UBaseType_t ) ipconfigBUFFER_ALLOC_CACHE_SIZE )
+            {
+                /* Make room by moving a batch out of the cache. */
+                uxCount = ( UBaseType_t ) baCACHE_BATCH;
+                pxCache->uxCount -= uxCount;
+            }
+            else
+            {
+                /* There is room in the cache. */
+            }
+
+            for( x = 0U; x < uxCount; x++ )
+            {
+                pxBatch[ x ] = pxCache->pxBuffers[ pxCache->uxCount + x ];
+            }
+
+            if( xReturn != pdFALSE )
+            {
+                pxCache->pxBuffers[ pxCache->uxCount ] = pxNetworkBuffer;
+                pxCache->uxCount++;
+            }
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+        if( uxCount > 0U )
+        {
+            prvReturnToFreeList( pxBatch, uxCount );
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Return all descriptors in the cache of the calling core to the global
+ *        free list.  Must not be called from an interrupt.
+ */
+    static void prvCacheFlush( void )
+    {
+        NetworkBufferDescriptor_t * pxBatch[ ipconfigBUFFER_ALLOC_CACHE_SIZE ];
+        BufferCache_t * pxCache;
+        UBaseType_t uxSavedInterruptStatus;
+        UBaseType_t uxCore;
+        UBaseType_t uxCount;
+        UBaseType_t x;
+
+        uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            uxCore = ipconfigBUFFER_ALLOC_CACHE_INDEX();
+            pxCache = &( xBufferCaches[ uxCore ] );
+            xCacheDrainRequested[ uxCore ] = pdFALSE;
+            uxCount = pxCache->uxCount;
+            pxCache->uxCount = 0U;
+
+            for( x = 0U; x < uxCount; x++ )
+            {
+                pxBatch[ x ] = pxCache->pxBuffers[ x ];
+            }
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+
+        if( uxCount > 0U )
+        {
+            prvReturnToFreeList( pxBatch, uxCount );
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Take xNetworkBufferSemaphore.  Before blocking, ask all cores to
+ *        return their cached descriptors to the global free list, and make
+ *        released descriptors bypass the caches while this task waits.
+ *
+ * @param[in] xBlockTimeTicks The maximum time to wait.
+ *
+ * @return pdPASS when the semaphore was taken.
+ */
+    static BaseType_t prvTakeSemaphore( TickType_t xBlockTimeTicks )
+    {
+        BaseType_t xReturn = xSemaphoreTake( xNetworkBufferSemaphore, 0U );
+        UBaseType_t x;
+
+        if( xReturn != pdPASS )
+        {
+            ipconfigBUFFER_ALLOC_LOCK();
+            {
+                uxWaitingTasks++;
+
+                for( x = 0U; x < ( UBaseType_t ) ipconfigBUFFER_ALLOC_NUM_CACHES; x++ )
+                {
+                    xCacheDrainRequested[ x ] = pdTRUE;
+                }
+            }
+            ipconfigBUFFER_ALLOC_UNLOCK();
+
+            /* The cache of this core can be emptied right away. */
+            prvCacheFlush();
+
+            xReturn = xSemaphoreTake( xNetworkBufferSemaphore, xBlockTimeTicks );
+
+            ipconfigBUFFER_ALLOC_LOCK();
+            {
+                uxWaitingTasks--;
+            }
+            ipconfigBUFFER_ALLOC_UNLOCK();
+        }
+
+        return xReturn;
+    }
+    /*-----------------------------------------------------------*/
+
+/**
+ * @brief Return a batch of descriptors from a cache to the global free list.
+ *        Must not be called from an interrupt.
+ *
+ * @param[in] ppxBuffers The descriptors.
+ * @param[in] uxCount The number of descriptors.
+ */
+    static void prvReturnToFreeList( NetworkBufferDescriptor_t * const * ppxBuffers,
+                                     UBaseType_t uxCount )
+    {
+        UBaseType_t x;
+
+        ipconfigBUFFER_ALLOC_LOCK();
+        {
+            for( x = 0U; x < uxCount; x++ )
+            {
+                vListInsertEnd( &xFreeBuffersList, &( ppxBuffers[ x ]->xBufferListItem ) );
+            }
+        }
+        ipconfigBUFFER_ALLOC_UNLOCK();
+
+        for( x = 0U; x < uxCount; x++ )
+        {
+            ( void ) xSemaphoreGive( xNetworkBufferSemaphore );
+        }
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 */
+
+#if ( ipBUFFER_ROOM != 0 )
+
+/**
+ * @brief Move the frame of a descriptor back to the start of its storage, in
+ *        case the previous user called pucNetworkBufferPull().  The storage is
+ *        laid out by the network interface, so there is no headroom in front
+ *        of the frame.
+ *
+ * @param[in] pxNetworkBuffer The descriptor.
+ */
+    static void prvRestoreFrame( NetworkBufferDescriptor_t * pxNetworkBuffer )
+    {
+        /* MISRA Ref 18.4.1 [Usage of +, -, += and -= operators on expression of pointer type]. */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-184. */
+        /* coverity[misra_c_2012_rule_18_4_violation] */
+        pxNetworkBuffer->pucEthernetBuffer -= pxNetworkBuffer->uxHeadroom;
+        pxNetworkBuffer->uxHeadroom = 0U;
+        pxNetworkBuffer->uxBufferSize = uxMaxNetworkInterfaceAllocatedSizeBytes;
+    }
+    /*-----------------------------------------------------------*/
+
+#endif /* ipBUFFER_ROOM != 0 */
+
+/**
+ * @brief Clear the fields of a descriptor that has just been obtained, so that
+ *        nothing of its previous user is handed out.  Can be called from a task
+ *        and from an interrupt.
+ *
+ * @param[in] pxNetworkBuffer The descriptor.
+ * @param[in] xRequestedSizeBytes The requested size.
+ */
+static void prvResetDescriptor( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                size_t xRequestedSizeBytes )
+{
+    #if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
+    {
+        ( void ) prvMarkFree( pxNetworkBuffer, pdFALSE );
+    }
+    #endif /* ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 */
+
+    pxNetworkBuffer->xDataLength = xRequestedSizeBytes;
+    pxNetworkBuffer->pxInterface = NULL;
+    pxNetworkBuffer->pxEndPoint = NULL;
+
+    #if ( ipBUFFER_ROOM != 0 )
+    {
+        prvRestoreFrame( pxNetworkBuffer );
+    }
+    #endif /* ipBUFFER_ROOM != 0 */
+
+    #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+    {
+        /* make sure the buffer is not linked */
+        pxNetworkBuffer->pxNextBuffer = NULL;
+    }
+    #endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Prepare a descriptor that has just been obtained by a task for its
+ *        new user.
+ *
+ * @param[in] pxNetworkBuffer The descriptor.
+ * @param[in] xRequestedSizeBytes The requested size.
+ */
+static void prvInitialiseDescriptor( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                     size_t xRequestedSizeBytes )
+{
+    UBaseType_t uxCount;
+
+    /* For stats, latch the lowest number of network buffers since
+     * booting. */
+    uxCount = uxGetNumberOfFreeNetworkBuffers();
+
+    if( uxMinimumFreeNetworkBuffers > uxCount )
+    {
+        uxMinimumFreeNetworkBuffers = uxCount;
+    }
+
+    prvResetDescriptor( pxNetworkBuffer, xRequestedSizeBytes );
+
+    #if ( ipconfigTCP_IP_SANITY != 0 )
+    {
+        prvShowWarnings();
+    }
+    #endif /* ipconfigTCP_IP_SANITY */
+}
+/*-----------------------------------------------------------*/
+
 BaseType_t xNetworkBuffersInitialise( void )
 {
     BaseType_t xReturn;
@@ -214,8 +748,21 @@ BaseType_t xNetworkBuffersInitialise( void )
                 vListInitialiseItem( &( xNetworkBuffers[ x ].xBufferListItem ) );
                 listSET_LIST_ITEM_OWNER( &( xNetworkBuffers[ x ].xBufferListItem ), &xNetworkBuffers[ x ] );
 
+                #if ( ipBUFFER_ROOM != 0 )
+                {
+                    xNetworkBuffers[ x ].uxHeadroom = 0U;
+                    prvRestoreFrame( &( xNetworkBuffers[ x ] ) );
+                }
+                #endif /* ipBUFFER_ROOM != 0 */
+
                 /* Currently, all buffers are available for use. */
                 vListInsert( &xFreeBuffersList, &( xNetworkBuffers[ x ].xBufferListItem ) );
+
+                #if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
+                {
+                    ucBufferIsFree[ x ] = ( uint8_t ) pdTRUE;
+                }
+                #endif /* ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 */
             }
 
             uxMinimumFreeNetworkBuffers = ( UBaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS;
@@ -240,14 +787,36 @@ NetworkBufferDescriptor_t * pxGetNetworkBufferWithDescriptor( size_t xRequestedS
 {
     NetworkBufferDescriptor_t * pxReturn = NULL;
     BaseType_t xInvalid = pdFALSE;
-    UBaseType_t uxCount;
 
     if( ( xNetworkBufferSemaphore != NULL ) &&
         ( xRequestedSizeBytes <= uxMaxNetworkInterfaceAllocatedSizeBytes ) )
     {
+        #if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
+        {
+            /* The cache of this core needs neither the semaphore nor the
+             * global critical section. */
+            pxReturn = prvCacheGet();
+
+            if( pxReturn != NULL )
+            {
+                prvInitialiseDescriptor( pxReturn, xRequestedSizeBytes );
+                iptraceNETWORK_BUFFER_OBTAINED( pxReturn );
+            }
+        }
+        #endif /* ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 */
+
         /* If there is a semaphore available, there is a network buffer
          * available. */
-        if( xSemaphoreTake( xNetworkBufferSemaphore, xBlockTimeTicks ) == pdPASS )
+        if( pxReturn != NULL )
+        {
+            /* Obtained from the cache. */
+        }
+
+        #if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
+            else if( prvTakeSemaphore( xBlockTimeTicks ) == pdPASS )
+        #else
+            else if( xSemaphoreTake( xNetworkBufferSemaphore, xBlockTimeTicks ) == pdPASS )
+        #endif
         {
             /* Protect the structure as it is accessed from tasks and
              * interrupts. */
@@ -281,32 +850,7 @@ NetworkBufferDescriptor_t * pxGetNetworkBufferWithDescriptor( size_t xRequestedS
             }
             else
             {
-                /* Reading UBaseType_t, no critical section needed. */
-                uxCount = listCURRENT_LIST_LENGTH( &xFreeBuffersList );
-
-                /* For stats, latch the lowest number of network buffers since
-                 * booting. */
-                if( uxMinimumFreeNetworkBuffers > uxCount )
-                {
-                    uxMinimumFreeNetworkBuffers = uxCount;
-                }
-
-                pxReturn->xDataLength = xRequestedSizeBytes;
-                pxReturn->pxInterface = NULL;
-                pxReturn->pxEndPoint = NULL;
-
-                #if ( ipconfigTCP_IP_SANITY != 0 )
-                {
-                    prvShowWarnings();
-                }
-                #endif /* ipconfigTCP_IP_SANITY */
-
-                #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
-                {
-                    /* make sure the buffer is not linked */
-                    pxReturn->pxNextBuffer = NULL;
-                }
-                #endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+                prvInitialiseDescriptor( pxReturn, xRequestedSizeBytes );
             }
 
             iptraceNETWORK_BUFFER_OBTAINED( pxReturn );
@@ -326,19 +870,37 @@ NetworkBufferDescriptor_t * pxGetNetworkBufferWithDescriptor( size_t xRequestedS
 NetworkBufferDescriptor_t * pxNetworkBufferGetFromISR( size_t xRequestedSizeBytes )
 {
     NetworkBufferDescriptor_t * pxReturn = NULL;
+    UBaseType_t uxFree;
 
-    /* The current implementation only has a single size memory block, so
-     * the requested size parameter is not used (yet). */
-    ( void ) xRequestedSizeBytes;
+    uxFree = uxQueueMessagesWaitingFromISR( ( QueueHandle_t ) xNetworkBufferSemaphore );
+
+    #if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
+    {
+        /* The descriptors in the caches are not counted by the semaphore. */
+        uxFree = uxGetNumberOfFreeNetworkBuffers();
+    }
+    #endif /* ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 */
 
     /* If there is a semaphore available then there is a buffer available, but,
      * as this is called from an interrupt, only take a buffer if there are at
      * least baINTERRUPT_BUFFER_GET_THRESHOLD buffers remaining.  This prevents,
      * to a certain degree at least, a rapidly executing interrupt exhausting
      * buffer and in so doing preventing tasks from continuing. */
-    if( uxQueueMessagesWaitingFromISR( ( QueueHandle_t ) xNetworkBufferSemaphore ) > ( UBaseType_t ) baINTERRUPT_BUFFER_GET_THRESHOLD )
+    if( uxFree > ( UBaseType_t ) baINTERRUPT_BUFFER_GET_THRESHOLD )
     {
-        if( xSemaphoreTakeFromISR( xNetworkBufferSemaphore, NULL ) == pdPASS )
+        #if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
+        {
+            /* The cache of this core is the lock-free fast path.  It is never
+             * refilled from an interrupt. */
+            pxReturn = prvCachePop();
+        }
+        #endif /* ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 */
+
+        if( pxReturn != NULL )
+        {
+            /* Obtained from the cache. */
+        }
+        else if( xSemaphoreTakeFromISR( xNetworkBufferSemaphore, NULL ) == pdPASS )
         {
             /* Protect the structure as it is accessed from tasks and interrupts. */
             ipconfigBUFFER_ALLOC_LOCK_FROM_ISR();
@@ -347,7 +909,15 @@ NetworkBufferDescriptor_t * pxNetworkBufferGetFromISR( size_t xRequestedSizeByte
                 uxListRemove( &( pxReturn->xBufferListItem ) );
             }
             ipconfigBUFFER_ALLOC_UNLOCK_FROM_ISR();
+        }
+        else
+        {
+            /* The semaphore was taken by another core in the meantime. */
+        }
 
+        if( pxReturn != NULL )
+        {
+            prvResetDescriptor( pxReturn, xRequestedSizeBytes );
             iptraceNETWORK_BUFFER_OBTAINED_FROM_ISR( pxReturn );
         }
     }
@@ -364,16 +934,66 @@ NetworkBufferDescriptor_t * pxNetworkBufferGetFromISR( size_t xRequestedSizeByte
 BaseType_t vNetworkBufferReleaseFromISR( NetworkBufferDescriptor_t * const pxNetworkBuffer )
 {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    BaseType_t xCached = pdFALSE;
 
-    /* Ensure the buffer is returned to the list of free buffers before the
-     * counting semaphore is 'given' to say a buffer is available. */
-    ipconfigBUFFER_ALLOC_LOCK_FROM_ISR();
+    #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
     {
-        vListInsertEnd( &xFreeBuffersList, &( pxNetworkBuffer->xBufferListItem ) );
+        /* Dropping the fragments may free memory, which is not possible from
+         * an interrupt. */
+        configASSERT( pxNetworkBuffer->uxFragmentCount == 0U );
+    }
+    #endif
+
+    #if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
+    {
+        BufferCache_t * pxCache;
+        UBaseType_t uxSavedInterruptStatus;
+        UBaseType_t uxCore;
+
+        uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+        {
+            if( prvMarkFree( pxNetworkBuffer, pdTRUE ) == pdFALSE )
+            {
+                /* Released twice, it is already in a cache or in the free
+                 * list. */
+                xCached = pdTRUE;
+            }
+            else
+            {
+                /* The lock-free fast path: put the descriptor in the cache of
+                 * this core if there is room, and if no task is waiting for a
+                 * descriptor.  A full cache is never flushed from an
+                 * interrupt. */
+                uxCore = ipconfigBUFFER_ALLOC_CACHE_INDEX();
+                pxCache = &( xBufferCaches[ uxCore ] );
+
+                if( ( xCacheDrainRequested[ uxCore ] == pdFALSE ) &&
+                    ( uxWaitingTasks == 0U ) &&
+                    ( pxCache->uxCount < ( UBaseType_t ) ipconfigBUFFER_ALLOC_CACHE_SIZE ) )
+                {
+                    pxCache->pxBuffers[ pxCache->uxCount ] = pxNetworkBuffer;
+                    pxCache->uxCount++;
+                    xCached = pdTRUE;
+                }
+            }
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+    }
+    #endif /* ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 */
+
+    if( xCached == pdFALSE )
+    {
+        /* Ensure the buffer is returned to the list of free buffers before the
+         * counting semaphore is 'given' to say a buffer is available. */
+        ipconfigBUFFER_ALLOC_LOCK_FROM_ISR();
+        {
+            vListInsertEnd( &xFreeBuffersList, &( pxNetworkBuffer->xBufferListItem ) );
+        }
+        ipconfigBUFFER_ALLOC_UNLOCK_FROM_ISR();
+
+        ( void ) xSemaphoreGiveFromISR( xNetworkBufferSemaphore, &xHigherPriorityTaskWoken );
     }
-    ipconfigBUFFER_ALLOC_UNLOCK_FROM_ISR();
 
-    ( void ) xSemaphoreGiveFromISR( xNetworkBufferSemaphore, &xHigherPriorityTaskWoken );
     iptraceNETWORK_BUFFER_RELEASED( pxNetworkBuffer );
 
     return xHigherPriorityTaskWoken;
@@ -382,7 +1002,8 @@ BaseType_t vNetworkBufferReleaseFromISR( NetworkBufferDescriptor_t * const pxNet
 
 void vReleaseNetworkBufferAndDescriptor( NetworkBufferDescriptor_t * const pxNetworkBuffer )
 {
-    BaseType_t xListItemAlreadyInFreeList;
+    BaseType_t xListItemAlreadyInFreeList = pdFALSE;
+    BaseType_t xCached = pdFALSE;
 
     if( bIsValidNetworkDescriptor( pxNetworkBuffer ) == pdFALSE_UNSIGNED )
     {
@@ -390,31 +1011,70 @@ void vReleaseNetworkBufferAndDescriptor( NetworkBufferDescriptor_t * const pxNet
     }
     else
     {
-        /* Ensure the buffer is returned to the list of free buffers before the
-         * counting semaphore is 'given' to say a buffer is available. */
-        ipconfigBUFFER_ALLOC_LOCK();
+        #if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
+        {
+            UBaseType_t uxSavedInterruptStatus;
+
+            /* A descriptor in a cache is not in the free list, so
+             * listIS_CONTAINED_WITHIN() does not see it. */
+            uxSavedInterruptStatus = ( UBaseType_t ) portSET_INTERRUPT_MASK_FROM_ISR();
+            {
+                if( prvMarkFree( pxNetworkBuffer, pdTRUE ) == pdFALSE )
+                {
+                    xListItemAlreadyInFreeList = pdTRUE;
+                }
+            }
+            portCLEAR_INTERRUPT_MASK_FROM_ISR( uxSavedInterruptStatus );
+        }
+        #endif /* ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 */
+
+        if( xListItemAlreadyInFreeList == pdFALSE )
         {
+            #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+            {
+                /* The stream that holds the fragments may be freed here. */
+                vNetworkBufferReleaseFragments( pxNetworkBuffer );
+            }
+            #endif
+
+            #if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
             {
-                xListItemAlreadyInFreeList = listIS_CONTAINED_WITHIN( &xFreeBuffersList, &( pxNetworkBuffer->xBufferListItem ) );
+                /* The cache of this core needs neither the semaphore nor the
+                 * global critical section. */
+                xCached = prvCacheRelease( pxNetworkBuffer );
+            }
+            #endif /* ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 */
+        }
 
-                if( xListItemAlreadyInFreeList == pdFALSE )
+        if( ( xCached == pdFALSE ) && ( xListItemAlreadyInFreeList == pdFALSE ) )
+        {
+            /* Ensure the buffer is returned to the list of free buffers before the
+             * counting semaphore is 'given' to say a buffer is available. */
+            ipconfigBUFFER_ALLOC_LOCK();
+            {
                 {
-                    vListInsertEnd( &xFreeBuffersList, &( pxNetworkBuffer->xBufferListItem ) );
+                    xListItemAlreadyInFreeList = listIS_CONTAINED_WITHIN( &xFreeBuffersList, &( pxNetworkBuffer->xBufferListItem ) );
+
+                    if( xListItemAlreadyInFreeList == pdFALSE )
+                    {
+                        vListInsertEnd( &xFreeBuffersList, &( pxNetworkBuffer->xBufferListItem ) );
+                    }
                 }
             }
+            ipconfigBUFFER_ALLOC_UNLOCK();
+
+            if( xListItemAlreadyInFreeList == pdFALSE )
+            {
+                ( void ) xSemaphoreGive( xNetworkBufferSemaphore );
+                prvShowWarnings();
+            }
         }
-        ipconfigBUFFER_ALLOC_UNLOCK();
 
-        if( xListItemAlreadyInFreeList )
+        if( xListItemAlreadyInFreeList != pdFALSE )
         {
             FreeRTOS_debug_printf( ( "vReleaseNetworkBufferAndDescriptor: %p ALREADY RELEASED (now %lu)\n",
                                      pxNetworkBuffer, uxGetNumberOfFreeNetworkBuffers() ) );
         }
-        else
-        {
-            ( void ) xSemaphoreGive( xNetworkBufferSemaphore );
-            prvShowWarnings();
-        }
 
         iptraceNETWORK_BUFFER_RELEASED( pxNetworkBuffer );
     }
@@ -429,13 +1089,38 @@ UBaseType_t uxGetMinimumFreeNetworkBuffers( void )
 
 UBaseType_t uxGetNumberOfFreeNetworkBuffers( void )
 {
-    return listCURRENT_LIST_LENGTH( &xFreeBuffersList );
+    UBaseType_t uxCount = listCURRENT_LIST_LENGTH( &xFreeBuffersList );
+
+    #if ( ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 )
+    {
+        UBaseType_t x;
+
+        /* The descriptors in the caches are free as well.  Reading
+         * UBaseType_t, no critical section needed. */
+        for( x = 0U; x < ( UBaseType_t ) ipconfigBUFFER_ALLOC_NUM_CACHES; x++ )
+        {
+            uxCount += xBufferCaches[ x ].uxCount;
+        }
+    }
+    #endif /* ipconfigBUFFER_ALLOC_CACHE_SIZE > 0 */
+
+    return uxCount;
 }
+/*-----------------------------------------------------------*/
 
 NetworkBufferDescriptor_t * pxResizeNetworkBufferWithDescriptor( NetworkBufferDescriptor_t * pxNetworkBuffer,
                                                                  size_t xNewSizeBytes )
 {
-    if( xNewSizeBytes <= uxMaxNetworkInterfaceAllocatedSizeBytes )
+    size_t uxBufferSize = uxMaxNetworkInterfaceAllocatedSizeBytes;
+
+    #if ( ipBUFFER_ROOM != 0 )
+    {
+        /* The frame may have been moved by pucNetworkBufferPull(). */
+        uxBufferSize = pxNetworkBuffer->uxBufferSize;
+    }
+    #endif /* ipBUFFER_ROOM != 0 */
+
+    if( xNewSizeBytes <= uxBufferSize )
     {
         /* In BufferAllocation_1.c all network buffer are allocated with a
          * maximum size of 'ipTOTAL_ETHERNET_FRAME_SIZE'.No need to resize the
@@ -67,6 +67,10 @@
 #define baALIGNMENT_MASK             ( baALIGNMENT_BYTES - 1U )
 #define baADD_WILL_OVERFLOW( a, b )    ( ( a ) > ( SIZE_MAX - ( b ) ) )
 
+/* The room that is reserved around the frame of a network buffer that is
+ * obtained with a descriptor. */
+#define baROOM_BYTES                 ( ( size_t ) ipconfigBUFFER_HEADROOM + ( size_t ) ipconfigBUFFER_TAILROOM )
+
 STATIC_ASSERT( ipconfigETHERNET_MINIMUM_PACKET_BYTES <= baMINIMAL_BUFFER_SIZE );
 
 /* A list of free (available) NetworkBufferDescriptor_t structures. */
@@ -292,9 +296,9 @@ NetworkBufferDescriptor_t * pxGetNetworkBufferWithDescriptor( size_t xRequestedS
         }
     }
 
-    if( baADD_WILL_OVERFLOW( xRequestedSizeBytesCopy, ipBUFFER_PADDING ) == pdFAIL )
+    if( baADD_WILL_OVERFLOW( xRequestedSizeBytesCopy, ipBUFFER_PADDING + baROOM_BYTES ) == pdFAIL )
     {
-        xAllocatedBytes = xRequestedSizeBytesCopy + ipBUFFER_PADDING;
+        xAllocatedBytes = xRequestedSizeBytesCopy + ipBUFFER_PADDING + baROOM_BYTES;
     }
     else
     {
@@ -341,6 +345,16 @@ NetworkBufferDescriptor_t * pxGetNetworkBufferWithDescriptor( size_t xRequestedS
                 }
                 else
                 {
+                    #if ( ipBUFFER_ROOM != 0 )
+                    {
+                        /* The headroom comes first, the tailroom follows the
+                         * requested size. */
+                        pxReturn->pucEthernetBuffer = &( pxReturn->pucEthernetBuffer[ ipconfigBUFFER_HEADROOM ] );
+                        pxReturn->uxHeadroom = ( size_t ) ipconfigBUFFER_HEADROOM;
+                        pxReturn->uxBufferSize = xRequestedSizeBytesCopy + ( size_t ) ipconfigBUFFER_TAILROOM;
+                    }
+                    #endif /* ipBUFFER_ROOM != 0 */
+
                     /* Store a pointer to the network buffer structure in the
                      * buffer storage area, then move the buffer pointer on past the
                      * stored pointer so the pointer value is not overwritten by the
@@ -400,6 +414,27 @@ void vReleaseNetworkBufferAndDescriptor( NetworkBufferDescriptor_t * const pxNet
     * storage allocated to the buffer payload.  THIS FILE SHOULD NOT BE USED
     * IF THE PROJECT INCLUDES A MEMORY ALLOCATOR THAT WILL FRAGMENT THE HEAP
     * MEMORY.  For example, heap_2 must not be used, heap_4 can be used. */
+    #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+    {
+        /* The stream that holds the fragments may be freed here. */
+        vNetworkBufferReleaseFragments( pxNetworkBuffer );
+    }
+    #endif
+
+    #if ( ipBUFFER_ROOM != 0 )
+    {
+        if( pxNetworkBuffer->pucEthernetBuffer != NULL )
+        {
+            /* The storage starts in front of the headroom. */
+
+            /* MISRA Ref 18.4.1 [Usage of +, -, += and -= operators on expression of pointer type]. */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-184. */
+            /* coverity[misra_c_2012_rule_18_4_violation] */
+            pxNetworkBuffer->pucEthernetBuffer -= pxNetworkBuffer->uxHeadroom;
+        }
+    }
+    #endif /* ipBUFFER_ROOM != 0 */
+
     vReleaseNetworkBuffer( pxNetworkBuffer->pucEthernetBuffer );
     pxNetworkBuffer->pucEthernetBuffer = NULL;
     pxNetworkBuffer->xDataLength = 0U;
@@ -456,10 +491,27 @@ NetworkBufferDescriptor_t * pxResizeNetworkBufferWithDescriptor( NetworkBufferDe
     uint8_t * pucBuffer;
     size_t uxSizeBytes = xNewSizeBytes;
     NetworkBufferDescriptor_t * pxNetworkBufferCopy = pxNetworkBuffer;
+    BaseType_t xFits = pdFALSE;
 
     xOriginalLength = pxNetworkBufferCopy->xDataLength + ipBUFFER_PADDING;
 
-    if( baADD_WILL_OVERFLOW( uxSizeBytes, ipBUFFER_PADDING ) == pdFAIL )
+    #if ( ipBUFFER_ROOM != 0 )
+    {
+        if( xNewSizeBytes <= pxNetworkBufferCopy->uxBufferSize )
+        {
+            /* The frame can grow into its tailroom, there is no need to
+             * allocate and copy. */
+            pxNetworkBufferCopy->xDataLength = xNewSizeBytes;
+            xFits = pdTRUE;
+        }
+    }
+    #endif /* ipBUFFER_ROOM != 0 */
+
+    if( xFits != pdFALSE )
+    {
+        /* The buffer was big enough. */
+    }
+    else if( baADD_WILL_OVERFLOW( uxSizeBytes, ipBUFFER_PADDING ) == pdFAIL )
     {
         uxSizeBytes = uxSizeBytes + ipBUFFER_PADDING;
 
@@ -488,6 +540,21 @@ NetworkBufferDescriptor_t * pxResizeNetworkBufferWithDescriptor( NetworkBufferDe
                              /* coverity[misra_c_2012_rule_18_4_violation] */
                              pxNetworkBufferCopy->pucEthernetBuffer - ipBUFFER_PADDING,
                              uxSizeBytes );
+
+            #if ( ipBUFFER_ROOM != 0 )
+            {
+                /* Free the old storage from its start.  The new storage,
+                 * from pucGetNetworkBuffer(), has no headroom. */
+
+                /* MISRA Ref 18.4.1 [Usage of +, -, += and -= operators on expression of pointer type]. */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-184. */
+                /* coverity[misra_c_2012_rule_18_4_violation] */
+                pxNetworkBufferCopy->pucEthernetBuffer -= pxNetworkBufferCopy->uxHeadroom;
+                pxNetworkBufferCopy->uxHeadroom = 0U;
+                pxNetworkBufferCopy->uxBufferSize = pxNetworkBufferCopy->xDataLength;
+            }
+            #endif /* ipBUFFER_ROOM != 0 */
+
             vReleaseNetworkBuffer( pxNetworkBufferCopy->pucEthernetBuffer );
             pxNetworkBufferCopy->pucEthernetBuffer = pucBuffer;
         }
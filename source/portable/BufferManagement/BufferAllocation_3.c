@@ -0,0 +1,812 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/******************************************************************************
+*
+* See the following web page for essential buffer allocation scheme usage and
+* configuration details:
+* https://freertos.org/Documentation/03-Libraries/02-FreeRTOS-plus/02-FreeRTOS-plus-TCP/05-Buffer-management
+*
+******************************************************************************/
+
+/* BufferAllocation_3.c carves its buffers out of statically allocated pools,
+ * one pool per size class:
+ *
+ *  - small: ipconfigSMALL_NETWORK_BUFFER_SIZE bytes, for ARP, pure ACKs,
+ *    ICMP and other control packets.
+ *  - large: a full Ethernet frame of ipconfigNETWORK_MTU bytes.
+ *  - jumbo: ipconfigJUMBO_NETWORK_BUFFER_SIZE bytes, optional.
+ *
+ * A request is served from the smallest class that can hold it.  When that
+ * class is empty, the next larger class is tried.  Each class has its own free
+ * list and keeps track of its lowest number of free buffers.  The heap is
+ * never used, so the memory cannot fragment.
+ *
+ * The counting semaphore counts the free network buffer descriptors, just like
+ * in the other schemes.  A caller only blocks while no descriptor is
+ * available; when all classes that can hold the requested size are empty,
+ * NULL is returned immediately. */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_UDP_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkInterface.h"
+#include "NetworkBufferManagement.h"
+
+/* The obtained network buffer must be large enough to hold a packet that might
+ * replace the packet that was requested to be sent. */
+#if ipconfigUSE_TCP == 1
+    #define baMINIMAL_BUFFER_SIZE    sizeof( TCPPacket_t )
+#else
+    #define baMINIMAL_BUFFER_SIZE    sizeof( ARPPacket_t )
+#endif /* ipconfigUSE_TCP == 1 */
+
+#define baALIGNMENT_BYTES            ( sizeof( size_t ) )
+#define baALIGNMENT_MASK             ( baALIGNMENT_BYTES - 1U )
+
+/* The number of bytes that are reserved in front of the padding of every
+ * slot, see ipconfigBUFFER_HEADROOM. */
+#define baHEADROOM                   ( ( size_t ) ipconfigBUFFER_HEADROOM )
+
+/* The number of bytes that a buffer of 'xSize' bytes occupies in the pool of
+ * its class: the headroom, the padding that holds the pointer to the network
+ * buffer descriptor, followed by the Ethernet frame, rounded up to a multiple
+ * of baALIGNMENT_BYTES. */
+#define baSLOT_SIZE( xSize )         ( ( ( ( size_t ) ( xSize ) ) + baHEADROOM + ipBUFFER_PADDING + baALIGNMENT_MASK ) & ~baALIGNMENT_MASK )
+
+#define baSMALL_BUFFER_SIZE          ( ( size_t ) ipconfigSMALL_NETWORK_BUFFER_SIZE )
+#define baLARGE_BUFFER_SIZE          ( ( size_t ) ipTOTAL_ETHERNET_FRAME_SIZE )
+#define baJUMBO_BUFFER_SIZE          ( ( size_t ) ipconfigJUMBO_NETWORK_BUFFER_SIZE )
+
+#if ( ipconfigNUM_JUMBO_NETWORK_BUFFERS > 0 )
+    #define baNUM_CLASSES            ( 3U )
+#else
+    #define baNUM_CLASSES            ( 2U )
+#endif
+
+STATIC_ASSERT( ipconfigETHERNET_MINIMUM_PACKET_BYTES <= baSMALL_BUFFER_SIZE );
+STATIC_ASSERT( baMINIMAL_BUFFER_SIZE <= baSMALL_BUFFER_SIZE );
+STATIC_ASSERT( baSMALL_BUFFER_SIZE < baLARGE_BUFFER_SIZE );
+
+#if ( ipconfigNUM_JUMBO_NETWORK_BUFFERS > 0 )
+    STATIC_ASSERT( baLARGE_BUFFER_SIZE < baJUMBO_BUFFER_SIZE );
+#endif
+
+/* The user can define their own ipconfigBUFFER_ALLOC_LOCK() and
+ * ipconfigBUFFER_ALLOC_UNLOCK() macros.  If these are not defined then default
+ * them to call the normal enter/exit critical section macros. */
+#if !defined( ipconfigBUFFER_ALLOC_LOCK )
+
+    #define ipconfigBUFFER_ALLOC_INIT()      do {} while( ipFALSE_BOOL )
+    #define ipconfigBUFFER_ALLOC_LOCK()      taskENTER_CRITICAL()
+    #define ipconfigBUFFER_ALLOC_UNLOCK()    taskEXIT_CRITICAL()
+
+#endif /* ipconfigBUFFER_ALLOC_LOCK */
+
+/** @brief A pool of buffers of the same size. */
+typedef struct xBUFFER_CLASS
+{
+    uint8_t * pucStorage;      /**< The first slot of the pool. */
+    size_t uxBufferSize;       /**< The number of bytes available for an Ethernet frame. */
+    size_t uxSlotSize;         /**< The distance between two slots in the pool. */
+    UBaseType_t uxCount;       /**< The number of buffers in the pool. */
+    uint8_t * pucFreeList;     /**< The first free slot.  A free slot starts with a pointer to the next free slot. */
+    UBaseType_t uxFree;        /**< The number of free buffers. */
+    UBaseType_t uxMinimumFree; /**< The lowest value of uxFree since booting. */
+} BufferClass_t;
+
+/* The storage of the pools.  They are declared as arrays of size_t so that
+ * every slot is suitably aligned to store a pointer. */
+static size_t uxSmallStorage[ ( ipconfigNUM_SMALL_NETWORK_BUFFERS * baSLOT_SIZE( baSMALL_BUFFER_SIZE ) ) / sizeof( size_t ) ];
+static size_t uxLargeStorage[ ( ipconfigNUM_LARGE_NETWORK_BUFFERS * baSLOT_SIZE( baLARGE_BUFFER_SIZE ) ) / sizeof( size_t ) ];
+
+#if ( ipconfigNUM_JUMBO_NETWORK_BUFFERS > 0 )
+    static size_t uxJumboStorage[ ( ipconfigNUM_JUMBO_NETWORK_BUFFERS * baSLOT_SIZE( baJUMBO_BUFFER_SIZE ) ) / sizeof( size_t ) ];
+#endif
+
+/* The size classes, ordered from small to large. */
+static BufferClass_t xBufferClasses[ baNUM_CLASSES ];
+
+/* A list of free (available) NetworkBufferDescriptor_t structures. */
+static List_t xFreeBuffersList;
+
+/* Some statistics about the use of buffers. */
+static UBaseType_t uxMinimumFreeNetworkBuffers = 0U;
+
+/* This constant is defined as false to let FreeRTOS_TCP_IP.c know that the
+ * network buffers have a variable size: resizing may be necessary */
+const BaseType_t xBufferAllocFixedSize = pdFALSE;
+
+/* The semaphore used to obtain network buffers. */
+static SemaphoreHandle_t xNetworkBufferSemaphore = NULL;
+
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseClass( BufferClass_t * pxClass,
+                                size_t * puxStorage,
+                                size_t uxBufferSize,
+                                UBaseType_t uxCount );
+
+static BufferClass_t * prvGetClassOfSlot( const uint8_t * pucSlot );
+
+static uint8_t * prvTakeSlot( size_t uxRequestedSizeBytes );
+
+static BaseType_t prvReturnSlot( uint8_t * pucSlot );
+
+static uint8_t * prvGetSlotOfBuffer( const NetworkBufferDescriptor_t * pxNetworkBuffer );
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Fill the free list of a size class with all of its slots.
+ *
+ * @param[in] pxClass The class to be initialised.
+ * @param[in] puxStorage The storage of the pool.
+ * @param[in] uxBufferSize The number of bytes available in each buffer.
+ * @param[in] uxCount The number of buffers in the pool.
+ */
+static void prvInitialiseClass( BufferClass_t * pxClass,
+                                size_t * puxStorage,
+                                size_t uxBufferSize,
+                                UBaseType_t uxCount )
+{
+    UBaseType_t x;
+    uint8_t * pucSlot;
+
+    /* MISRA Ref 11.3.1 [Misaligned access] */
+    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+    /* coverity[misra_c_2012_rule_11_3_violation] */
+    pxClass->pucStorage = ( uint8_t * ) puxStorage;
+    pxClass->uxBufferSize = uxBufferSize;
+    pxClass->uxSlotSize = baSLOT_SIZE( uxBufferSize );
+    pxClass->uxCount = uxCount;
+    pxClass->pucFreeList = NULL;
+
+    /* Push the slots in reverse order, so the first slot will be handed out
+     * first. */
+    for( x = uxCount; x > 0U; x-- )
+    {
+        pucSlot = &( pxClass->pucStorage[ ( x - 1U ) * pxClass->uxSlotSize ] );
+
+        /* MISRA Ref 11.3.1 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        *( ( uint8_t ** ) pucSlot ) = pxClass->pucFreeList;
+        pxClass->pucFreeList = pucSlot;
+    }
+
+    pxClass->uxFree = uxCount;
+    pxClass->uxMinimumFree = uxCount;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the size class that owns a slot.
+ *
+ * @param[in] pucSlot The start of the slot, i.e. the Ethernet buffer minus
+ *                    ipBUFFER_PADDING.
+ *
+ * @return The owning class, or NULL when the slot is not part of any pool.
+ */
+static BufferClass_t * prvGetClassOfSlot( const uint8_t * pucSlot )
+{
+    BufferClass_t * pxReturn = NULL;
+    uintptr_t uxSlot = ( uintptr_t ) pucSlot;
+    uintptr_t uxStart;
+    uintptr_t uxOffset;
+    UBaseType_t x;
+
+    for( x = 0U; x < baNUM_CLASSES; x++ )
+    {
+        uxStart = ( uintptr_t ) xBufferClasses[ x ].pucStorage;
+
+        if( uxSlot >= uxStart )
+        {
+            uxOffset = uxSlot - uxStart;
+
+            if( ( uxOffset < ( ( uintptr_t ) xBufferClasses[ x ].uxCount * xBufferClasses[ x ].uxSlotSize ) ) &&
+                ( ( uxOffset % xBufferClasses[ x ].uxSlotSize ) == 0U ) )
+            {
+                pxReturn = &( xBufferClasses[ x ] );
+                break;
+            }
+        }
+    }
+
+    return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Take a slot from the smallest class that can hold the requested
+ *        size and that has a free buffer.  Must be called with the
+ *        allocator locked.
+ *
+ * @param[in] uxRequestedSizeBytes The size of the Ethernet frame.
+ *
+ * @return The start of the slot, or NULL when no buffer is available.
+ */
+static uint8_t * prvTakeSlot( size_t uxRequestedSizeBytes )
+{
+    uint8_t * pucSlot = NULL;
+    BufferClass_t * pxClass;
+    UBaseType_t x;
+
+    for( x = 0U; x < baNUM_CLASSES; x++ )
+    {
+        pxClass = &( xBufferClasses[ x ] );
+
+        if( ( pxClass->uxBufferSize >= uxRequestedSizeBytes ) && ( pxClass->pucFreeList != NULL ) )
+        {
+            pucSlot = pxClass->pucFreeList;
+
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            pxClass->pucFreeList = *( ( uint8_t ** ) pucSlot );
+            pxClass->uxFree--;
+
+            /* For stats, latch the lowest number of free buffers in this
+             * class since booting. */
+            if( pxClass->uxMinimumFree > pxClass->uxFree )
+            {
+                pxClass->uxMinimumFree = pxClass->uxFree;
+            }
+
+            break;
+        }
+    }
+
+    return pucSlot;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Return a slot to the free list of its class.  Must be called with
+ *        the allocator locked.
+ *
+ * @param[in] pucSlot The start of the slot.
+ *
+ * @return pdPASS when the slot was returned, pdFAIL when it is not part of
+ *         any pool.
+ */
+static BaseType_t prvReturnSlot( uint8_t * pucSlot )
+{
+    BufferClass_t * pxClass = prvGetClassOfSlot( pucSlot );
+    BaseType_t xReturn = pdFAIL;
+
+    if( pxClass != NULL )
+    {
+        /* MISRA Ref 11.3.1 [Misaligned access] */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+        /* coverity[misra_c_2012_rule_11_3_violation] */
+        *( ( uint8_t ** ) pucSlot ) = pxClass->pucFreeList;
+        pxClass->pucFreeList = pucSlot;
+        pxClass->uxFree++;
+        xReturn = pdPASS;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Find the start of the slot that holds the frame of a network buffer.
+ *
+ * @param[in] pxNetworkBuffer The network buffer, which must have storage.
+ *
+ * @return The start of the slot.
+ */
+static uint8_t * prvGetSlotOfBuffer( const NetworkBufferDescriptor_t * pxNetworkBuffer )
+{
+    size_t uxOffset = baHEADROOM + ipBUFFER_PADDING;
+
+    #if ( ipBUFFER_ROOM != 0 )
+    {
+        /* The frame may have been moved with pucNetworkBufferPush() or
+         * pucNetworkBufferPull(). */
+        uxOffset = pxNetworkBuffer->uxHeadroom + ipBUFFER_PADDING;
+    }
+    #endif /* ipBUFFER_ROOM != 0 */
+
+    /* MISRA Ref 18.4.1 [Usage of +, -, += and -= operators on expression of pointer type]. */
+    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-184. */
+    /* coverity[misra_c_2012_rule_18_4_violation] */
+    return pxNetworkBuffer->pucEthernetBuffer - uxOffset;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkBuffersInitialise( void )
+{
+    /* Declares the pool of NetworkBufferDescriptor_t structures that are available
+     * to the system.  All the network buffers referenced from xFreeBuffersList exist
+     * in this array.  The array is not accessed directly except during initialisation,
+     * when the xFreeBuffersList is filled (as all the buffers are free when the system
+     * is booted). */
+    static NetworkBufferDescriptor_t xNetworkBufferDescriptors[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ];
+    BaseType_t xReturn;
+    uint32_t x;
+
+    /* Only initialise the buffers and their associated kernel objects if they
+     * have not been initialised before. */
+    if( xNetworkBufferSemaphore == NULL )
+    {
+        /* In case alternative locking is used, the mutexes can be initialised
+         * here */
+        ipconfigBUFFER_ALLOC_INIT();
+
+        #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+        {
+            static StaticSemaphore_t xNetworkBufferSemaphoreBuffer;
+            xNetworkBufferSemaphore = xSemaphoreCreateCountingStatic(
+                ( UBaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS,
+                ( UBaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS,
+                &xNetworkBufferSemaphoreBuffer );
+        }
+        #else
+        {
+            xNetworkBufferSemaphore = xSemaphoreCreateCounting( ( UBaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, ( UBaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS );
+        }
+        #endif /* configSUPPORT_STATIC_ALLOCATION */
+
+        configASSERT( xNetworkBufferSemaphore != NULL );
+
+        if( xNetworkBufferSemaphore != NULL )
+        {
+            #if ( configQUEUE_REGISTRY_SIZE > 0 )
+            {
+                vQueueAddToRegistry( xNetworkBufferSemaphore, "NetBufSem" );
+            }
+            #endif /* configQUEUE_REGISTRY_SIZE */
+
+            prvInitialiseClass( &( xBufferClasses[ 0 ] ), uxSmallStorage, baSMALL_BUFFER_SIZE, ( UBaseType_t ) ipconfigNUM_SMALL_NETWORK_BUFFERS );
+            prvInitialiseClass( &( xBufferClasses[ 1 ] ), uxLargeStorage, baLARGE_BUFFER_SIZE, ( UBaseType_t ) ipconfigNUM_LARGE_NETWORK_BUFFERS );
+
+            #if ( ipconfigNUM_JUMBO_NETWORK_BUFFERS > 0 )
+            {
+                prvInitialiseClass( &( xBufferClasses[ 2 ] ), uxJumboStorage, baJUMBO_BUFFER_SIZE, ( UBaseType_t ) ipconfigNUM_JUMBO_NETWORK_BUFFERS );
+            }
+            #endif
+
+            vListInitialise( &xFreeBuffersList );
+
+            /* Initialise all the network buffer descriptors.  The storage is
+             * attached to them when they are obtained. */
+            for( x = 0U; x < ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS; x++ )
+            {
+                /* Initialise and set the owner of the buffer list items. */
+                xNetworkBufferDescriptors[ x ].pucEthernetBuffer = NULL;
+                vListInitialiseItem( &( xNetworkBufferDescriptors[ x ].xBufferListItem ) );
+                listSET_LIST_ITEM_OWNER( &( xNetworkBufferDescriptors[ x ].xBufferListItem ), &xNetworkBufferDescriptors[ x ] );
+
+                /* Currently, all buffers are available for use. */
+                vListInsert( &xFreeBuffersList, &( xNetworkBufferDescriptors[ x ].xBufferListItem ) );
+            }
+
+            uxMinimumFreeNetworkBuffers = ( UBaseType_t ) ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS;
+        }
+    }
+
+    if( xNetworkBufferSemaphore == NULL )
+    {
+        xReturn = pdFAIL;
+    }
+    else
+    {
+        xReturn = pdPASS;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+uint8_t * pucGetNetworkBuffer( size_t * pxRequestedSizeBytes )
+{
+    uint8_t * pucEthernetBuffer = NULL;
+    size_t uxSize = *pxRequestedSizeBytes;
+    const BufferClass_t * pxClass;
+
+    if( uxSize < baMINIMAL_BUFFER_SIZE )
+    {
+        /* Buffers must be at least large enough to hold a TCP-packet with
+         * headers, or an ARP packet, in case TCP is not included. */
+        uxSize = baMINIMAL_BUFFER_SIZE;
+    }
+
+    ipconfigBUFFER_ALLOC_LOCK();
+    {
+        pucEthernetBuffer = prvTakeSlot( uxSize );
+    }
+    ipconfigBUFFER_ALLOC_UNLOCK();
+
+    if( pucEthernetBuffer != NULL )
+    {
+        /* Report the actual size of the buffer, which may be greater than the
+         * original requested size. */
+        pxClass = prvGetClassOfSlot( pucEthernetBuffer );
+        *pxRequestedSizeBytes = pxClass->uxBufferSize;
+
+        /* Enough space is left at the start of the buffer to place a pointer to
+         * the network buffer structure that references this Ethernet buffer.
+         * Return a pointer to the start of the Ethernet buffer itself. */
+
+        /* MISRA Ref 18.4.1 [Usage of +, -, += and -= operators on expression of pointer type]. */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-184. */
+        /* coverity[misra_c_2012_rule_18_4_violation] */
+        pucEthernetBuffer += baHEADROOM + ipBUFFER_PADDING;
+    }
+
+    return pucEthernetBuffer;
+}
+/*-----------------------------------------------------------*/
+
+void vReleaseNetworkBuffer( uint8_t * pucEthernetBuffer )
+{
+    uint8_t * pucEthernetBufferCopy = pucEthernetBuffer;
+    BaseType_t xReturned;
+
+    if( pucEthernetBufferCopy != NULL )
+    {
+        /* MISRA Ref 18.4.1 [Usage of +, -, += and -= operators on expression of pointer type]. */
+        /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-184. */
+        /* coverity[misra_c_2012_rule_18_4_violation] */
+        pucEthernetBufferCopy -= baHEADROOM + ipBUFFER_PADDING;
+
+        ipconfigBUFFER_ALLOC_LOCK();
+        {
+            xReturned = prvReturnSlot( pucEthernetBufferCopy );
+        }
+        ipconfigBUFFER_ALLOC_UNLOCK();
+
+        if( xReturned == pdFAIL )
+        {
+            FreeRTOS_debug_printf( ( "vReleaseNetworkBuffer: Invalid buffer %p\n", ( void * ) pucEthernetBuffer ) );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+NetworkBufferDescriptor_t * pxGetNetworkBufferWithDescriptor( size_t xRequestedSizeBytes,
+                                                              TickType_t xBlockTimeTicks )
+{
+    NetworkBufferDescriptor_t * pxReturn = NULL;
+    uint8_t * pucSlot = NULL;
+    size_t uxSize = xRequestedSizeBytes;
+    UBaseType_t uxCount;
+
+    if( uxSize < baMINIMAL_BUFFER_SIZE )
+    {
+        /* ARP packets can replace application packets, so the storage must be
+         * at least large enough to hold an ARP. */
+        uxSize = baMINIMAL_BUFFER_SIZE;
+    }
+
+    if( ( xNetworkBufferSemaphore != NULL ) &&
+        ( uxSize <= xBufferClasses[ baNUM_CLASSES - 1U ].uxBufferSize ) )
+    {
+        /* If there is a semaphore available, there is a network buffer
+         * descriptor available. */
+        if( xSemaphoreTake( xNetworkBufferSemaphore, xBlockTimeTicks ) == pdPASS )
+        {
+            /* Protect the structure as it is accessed from tasks and
+             * interrupts. */
+            ipconfigBUFFER_ALLOC_LOCK();
+            {
+                pucSlot = prvTakeSlot( uxSize );
+
+                if( pucSlot != NULL )
+                {
+                    pxReturn = ( NetworkBufferDescriptor_t * ) listGET_OWNER_OF_HEAD_ENTRY( &xFreeBuffersList );
+                    ( void ) uxListRemove( &( pxReturn->xBufferListItem ) );
+                }
+            }
+            ipconfigBUFFER_ALLOC_UNLOCK();
+
+            if( pxReturn == NULL )
+            {
+                /* None of the classes that can hold the requested size has a
+                 * free buffer.  Give back the descriptor. */
+                ( void ) xSemaphoreGive( xNetworkBufferSemaphore );
+            }
+            else
+            {
+                /* Reading UBaseType_t, no critical section needed. */
+                uxCount = listCURRENT_LIST_LENGTH( &xFreeBuffersList );
+
+                /* For stats, latch the lowest number of network buffers since
+                 * booting. */
+                if( uxMinimumFreeNetworkBuffers > uxCount )
+                {
+                    uxMinimumFreeNetworkBuffers = uxCount;
+                }
+
+                #if ( ipBUFFER_ROOM != 0 )
+                {
+                    pxReturn->uxHeadroom = baHEADROOM;
+                    pxReturn->uxBufferSize = prvGetClassOfSlot( pucSlot )->uxBufferSize;
+                }
+                #endif /* ipBUFFER_ROOM != 0 */
+
+                /* Store a pointer to the network buffer structure in the
+                 * buffer storage area, behind the headroom, then move the
+                 * buffer pointer on past the stored pointer so the pointer
+                 * value is not overwritten by the application when the buffer
+                 * is used. */
+                pucSlot = &( pucSlot[ baHEADROOM ] );
+
+                /* MISRA Ref 11.3.1 [Misaligned access] */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+                /* coverity[misra_c_2012_rule_11_3_violation] */
+                *( ( NetworkBufferDescriptor_t ** ) pucSlot ) = pxReturn;
+
+                /* MISRA Ref 18.4.1 [Usage of +, -, += and -= operators on expression of pointer type]. */
+                /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-184. */
+                /* coverity[misra_c_2012_rule_18_4_violation] */
+                pxReturn->pucEthernetBuffer = pucSlot + ipBUFFER_PADDING;
+                pxReturn->xDataLength = xRequestedSizeBytes;
+                pxReturn->pxInterface = NULL;
+                pxReturn->pxEndPoint = NULL;
+
+                #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+                {
+                    /* make sure the buffer is not linked */
+                    pxReturn->pxNextBuffer = NULL;
+                }
+                #endif /* ipconfigUSE_LINKED_RX_MESSAGES */
+            }
+        }
+    }
+
+    if( pxReturn == NULL )
+    {
+        iptraceFAILED_TO_OBTAIN_NETWORK_BUFFER();
+    }
+    else
+    {
+        /* No action. */
+        iptraceNETWORK_BUFFER_OBTAINED( pxReturn );
+    }
+
+    return pxReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vReleaseNetworkBufferAndDescriptor( NetworkBufferDescriptor_t * const pxNetworkBuffer )
+{
+    BaseType_t xListItemAlreadyInFreeList;
+    BaseType_t xReturned = pdPASS;
+    uint8_t * pucSlot;
+
+    #if ( ipconfigUSE_TCP_TX_SCATTER_GATHER != 0 )
+    {
+        /* The stream that holds the fragments may be freed here, outside
+         * the lock. */
+        vNetworkBufferReleaseFragments( pxNetworkBuffer );
+    }
+    #endif
+
+    /* Ensure the buffer is returned to the list of free buffers before the
+     * counting semaphore is 'given' to say a buffer is available.  The check
+     * for a double release is done first, so the storage is never put on the
+     * free list of its class twice. */
+    ipconfigBUFFER_ALLOC_LOCK();
+    {
+        xListItemAlreadyInFreeList = listIS_CONTAINED_WITHIN( &xFreeBuffersList, &( pxNetworkBuffer->xBufferListItem ) );
+
+        if( xListItemAlreadyInFreeList == pdFALSE )
+        {
+            if( pxNetworkBuffer->pucEthernetBuffer != NULL )
+            {
+                pucSlot = prvGetSlotOfBuffer( pxNetworkBuffer );
+                xReturned = prvReturnSlot( pucSlot );
+                pxNetworkBuffer->pucEthernetBuffer = NULL;
+            }
+
+            pxNetworkBuffer->xDataLength = 0U;
+            vListInsertEnd( &xFreeBuffersList, &( pxNetworkBuffer->xBufferListItem ) );
+        }
+    }
+    ipconfigBUFFER_ALLOC_UNLOCK();
+
+    if( xReturned == pdFAIL )
+    {
+        FreeRTOS_debug_printf( ( "vReleaseNetworkBufferAndDescriptor: Invalid buffer in %p\n", ( void * ) pxNetworkBuffer ) );
+    }
+
+    /*
+     * Update the network state machine, unless the program fails to release its 'xNetworkBufferSemaphore'.
+     * The program should only try to release its semaphore if 'xListItemAlreadyInFreeList' is false.
+     */
+    if( xListItemAlreadyInFreeList == pdFALSE )
+    {
+        if( xSemaphoreGive( xNetworkBufferSemaphore ) == pdTRUE )
+        {
+            iptraceNETWORK_BUFFER_RELEASED( pxNetworkBuffer );
+        }
+    }
+    else
+    {
+        FreeRTOS_debug_printf( ( "vReleaseNetworkBufferAndDescriptor: %p ALREADY RELEASED\n", ( void * ) pxNetworkBuffer ) );
+        iptraceNETWORK_BUFFER_RELEASED( pxNetworkBuffer );
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Returns the number of free network buffers
+ */
+UBaseType_t uxGetNumberOfFreeNetworkBuffers( void )
+{
+    return listCURRENT_LIST_LENGTH( &xFreeBuffersList );
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetMinimumFreeNetworkBuffers( void )
+{
+    return uxMinimumFreeNetworkBuffers;
+}
+/*-----------------------------------------------------------*/
+
+size_t uxGetNetworkBufferClassSize( UBaseType_t uxClass )
+{
+    size_t uxReturn = 0U;
+
+    if( uxClass < baNUM_CLASSES )
+    {
+        uxReturn = xBufferClasses[ uxClass ].uxBufferSize;
+    }
+
+    return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetNumberOfFreeNetworkBuffersInClass( UBaseType_t uxClass )
+{
+    UBaseType_t uxReturn = 0U;
+
+    if( uxClass < baNUM_CLASSES )
+    {
+        /* Reading UBaseType_t, no critical section needed. */
+        uxReturn = xBufferClasses[ uxClass ].uxFree;
+    }
+
+    return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxGetMinimumFreeNetworkBuffersInClass( UBaseType_t uxClass )
+{
+    UBaseType_t uxReturn = 0U;
+
+    if( uxClass < baNUM_CLASSES )
+    {
+        uxReturn = xBufferClasses[ uxClass ].uxMinimumFree;
+    }
+
+    return uxReturn;
+}
+/*-----------------------------------------------------------*/
+
+NetworkBufferDescriptor_t * pxResizeNetworkBufferWithDescriptor( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                                                                 size_t xNewSizeBytes )
+{
+    NetworkBufferDescriptor_t * pxNetworkBufferCopy = pxNetworkBuffer;
+    const BufferClass_t * pxClass = NULL;
+    uint8_t * pucSlot = NULL;
+    uint8_t * pucBuffer;
+    size_t uxSizeBytes = xNewSizeBytes;
+    size_t uxBufferSize = 0U;
+    size_t uxCopyBytes;
+
+    if( pxNetworkBufferCopy->pucEthernetBuffer != NULL )
+    {
+        pucSlot = prvGetSlotOfBuffer( pxNetworkBufferCopy );
+        pxClass = prvGetClassOfSlot( pucSlot );
+    }
+
+    if( pxClass != NULL )
+    {
+        uxBufferSize = pxClass->uxBufferSize;
+
+        #if ( ipBUFFER_ROOM != 0 )
+        {
+            /* The frame may have been moved within its slot. */
+            uxBufferSize = pxNetworkBufferCopy->uxBufferSize;
+        }
+        #endif /* ipBUFFER_ROOM != 0 */
+    }
+
+    if( ( pxClass != NULL ) && ( xNewSizeBytes <= uxBufferSize ) )
+    {
+        /* The buffer that is attached already is big enough. */
+        pxNetworkBufferCopy->xDataLength = xNewSizeBytes;
+    }
+    else
+    {
+        pucBuffer = pucGetNetworkBuffer( &( uxSizeBytes ) );
+
+        if( pucBuffer == NULL )
+        {
+            /* In case the allocation fails, return NULL. */
+            pxNetworkBufferCopy = NULL;
+        }
+        else
+        {
+            if( pxClass != NULL )
+            {
+                /* Copy the data that is already present. */
+                uxCopyBytes = pxNetworkBufferCopy->xDataLength;
+
+                if( uxCopyBytes > xNewSizeBytes )
+                {
+                    uxCopyBytes = xNewSizeBytes;
+                }
+
+                ( void ) memcpy( pucBuffer, pxNetworkBufferCopy->pucEthernetBuffer, uxCopyBytes );
+
+                ipconfigBUFFER_ALLOC_LOCK();
+                {
+                    ( void ) prvReturnSlot( pucSlot );
+                }
+                ipconfigBUFFER_ALLOC_UNLOCK();
+            }
+
+            /* Store a pointer to the descriptor in the padding. */
+
+            /* MISRA Ref 18.4.1 [Usage of +, -, += and -= operators on expression of pointer type]. */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-184. */
+            /* coverity[misra_c_2012_rule_18_4_violation] */
+            /* MISRA Ref 11.3.1 [Misaligned access] */
+            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Plus-TCP/blob/main/MISRA.md#rule-113 */
+            /* coverity[misra_c_2012_rule_11_3_violation] */
+            *( ( NetworkBufferDescriptor_t ** ) ( pucBuffer - ipBUFFER_PADDING ) ) = pxNetworkBufferCopy;
+
+            #if ( ipBUFFER_ROOM != 0 )
+            {
+                pxNetworkBufferCopy->uxHeadroom = baHEADROOM;
+                pxNetworkBufferCopy->uxBufferSize = uxSizeBytes;
+            }
+            #endif /* ipBUFFER_ROOM != 0 */
+
+            pxNetworkBufferCopy->pucEthernetBuffer = pucBuffer;
+            pxNetworkBufferCopy->xDataLength = xNewSizeBytes;
+        }
+    }
+
+    return pxNetworkBufferCopy;
+}
+/*-----------------------------------------------------------*/
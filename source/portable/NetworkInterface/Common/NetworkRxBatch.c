@@ -0,0 +1,157 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @brief
+ * Helper functions that let a network driver pass received packets to the
+ * IP-task in bursts.
+ *
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+
+/* FreeRTOS includes. */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+
+/* FreeRTOS+TCP includes. */
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkBufferManagement.h"
+
+#include "NetworkRxBatch.h"
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Pass a packet, or a chain of linked packets, to the IP-task. When that
+ *        fails, all packets are released.
+ *
+ * @param[in] pxDescriptor The first packet.
+ *
+ * @return pdPASS when the packets were passed to the IP-task, otherwise pdFAIL.
+ */
+static BaseType_t prvSendToIPTask( NetworkBufferDescriptor_t * pxDescriptor )
+{
+    IPStackEvent_t xRxEvent;
+    BaseType_t xReturn = pdPASS;
+
+    xRxEvent.eEventType = eNetworkRxEvent;
+    xRxEvent.pvData = ( void * ) pxDescriptor;
+
+    if( xSendEventStructToIPTask( &xRxEvent, 0 ) == pdFAIL )
+    {
+        NetworkBufferDescriptor_t * pxNext;
+
+        while( pxDescriptor != NULL )
+        {
+            #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+                pxNext = pxDescriptor->pxNextBuffer;
+                pxDescriptor->pxNextBuffer = NULL;
+            #else
+                pxNext = NULL;
+            #endif
+
+            vReleaseNetworkBufferAndDescriptor( pxDescriptor );
+            iptraceETHERNET_RX_EVENT_LOST();
+            pxDescriptor = pxNext;
+        }
+
+        xReturn = pdFAIL;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vNetworkRxBatchInit( NetworkRxBatch_t * pxBatch )
+{
+    configASSERT( pxBatch != NULL );
+
+    pxBatch->pxHead = NULL;
+    pxBatch->pxTail = NULL;
+    pxBatch->uxCount = 0U;
+}
+/*-----------------------------------------------------------*/
+
+void vNetworkRxBatchAdd( NetworkRxBatch_t * pxBatch,
+                         NetworkBufferDescriptor_t * pxDescriptor )
+{
+    configASSERT( pxBatch != NULL );
+    configASSERT( pxDescriptor != NULL );
+
+    #if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 )
+    {
+        pxDescriptor->pxNextBuffer = NULL;
+
+        if( pxBatch->pxHead == NULL )
+        {
+            pxBatch->pxHead = pxDescriptor;
+        }
+        else
+        {
+            pxBatch->pxTail->pxNextBuffer = pxDescriptor;
+        }
+
+        pxBatch->pxTail = pxDescriptor;
+        pxBatch->uxCount++;
+
+        if( pxBatch->uxCount >= rxbatchMAX_PACKETS )
+        {
+            ( void ) xNetworkRxBatchFlush( pxBatch );
+        }
+    }
+    #else /* if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) */
+    {
+        /* Packets can not be linked, pass them one by one. */
+        ( void ) pxBatch;
+        ( void ) prvSendToIPTask( pxDescriptor );
+    }
+    #endif /* if ( ipconfigUSE_LINKED_RX_MESSAGES != 0 ) */
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xNetworkRxBatchFlush( NetworkRxBatch_t * pxBatch )
+{
+    BaseType_t xReturn = pdPASS;
+
+    configASSERT( pxBatch != NULL );
+
+    if( pxBatch->pxHead != NULL )
+    {
+        xReturn = prvSendToIPTask( pxBatch->pxHead );
+
+        pxBatch->pxHead = NULL;
+        pxBatch->pxTail = NULL;
+        pxBatch->uxCount = 0U;
+    }
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
@@ -0,0 +1,77 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/**
+ * @brief
+ * Helper functions that let a network driver pass received packets to the
+ * IP-task in bursts. The packets are linked through 'pxNextBuffer' and sent
+ * as a single 'eNetworkRxEvent', so that the cost of the queue operation and
+ * the context switch is shared by all packets in a burst.
+ *
+ */
+
+#ifndef NETWORK_RX_BATCH_H
+
+    #define NETWORK_RX_BATCH_H
+
+    #ifdef __cplusplus
+    extern "C" {
+    #endif
+
+/* The maximum number of packets in one batch. When it is reached, the batch is
+ * flushed to the IP-task automatically. This macro is not included in
+ * 'FreeRTOSIPConfigDefaults.h', it can be overridden in 'FreeRTOSIPConfig.h'. */
+    #ifndef rxbatchMAX_PACKETS
+        #define rxbatchMAX_PACKETS    32U
+    #endif
+
+    typedef struct xNetworkRxBatch
+    {
+        NetworkBufferDescriptor_t * pxHead; /* The first packet of the batch. */
+        NetworkBufferDescriptor_t * pxTail; /* The last packet of the batch. */
+        UBaseType_t uxCount;                /* The number of packets in the batch. */
+    } NetworkRxBatch_t;
+
+/* Initialise an empty batch. */
+    void vNetworkRxBatchInit( NetworkRxBatch_t * pxBatch );
+
+/* Add a received packet to the batch. The descriptor must have its
+ * 'pxInterface' and 'pxEndPoint' fields set. When 'ipconfigUSE_LINKED_RX_MESSAGES'
+ * is disabled, the packet is passed to the IP-task immediately. */
+    void vNetworkRxBatchAdd( NetworkRxBatch_t * pxBatch,
+                             NetworkBufferDescriptor_t * pxDescriptor );
+
+/* Pass all packets of the batch to the IP-task, call this at the end of a burst.
+ * When the IP-task can not be reached, the packets are released. Returns pdFAIL
+ * when packets were lost. */
+    BaseType_t xNetworkRxBatchFlush( NetworkRxBatch_t * pxBatch );
+
+    #ifdef __cplusplus
+}     /* extern "C" */
+    #endif
+
+#endif /* NETWORK_RX_BATCH_H */
@@ -48,6 +48,7 @@
 #include "FreeRTOS_IP_Private.h"
 #include "NetworkBufferManagement.h"
 #include "FreeRTOS_Stream_Buffer.h"
+#include "NetworkRxBatch.h"
 
 /* ========================== Local includes =================================*/
 #include <utils/wait_for_event.h>
@@ -924,12 +925,14 @@ static void prvInterruptSimulatorTask( void * pvParameters )
     const uint8_t * pucPacketData;
     uint8_t ucRecvBuffer[ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
     NetworkBufferDescriptor_t * pxNetworkBuffer;
-    IPStackEvent_t xRxEvent = { eNetworkRxEvent, NULL };
+    NetworkRxBatch_t xRxBatch;
     eFrameProcessingResult_t eResult;
 
     /* Remove compiler warnings about unused parameters. */
     ( void ) pvParameters;
 
+    vNetworkRxBatchInit( &xRxBatch );
+
     for( ; ; )
     {
         /* Does the circular buffer used to pass data from the pthread thread that
@@ -986,26 +989,15 @@ static void prvInterruptSimulatorTask( void * pvParameters )
 
                         if( pxNetworkBuffer != NULL )
                         {
-                            xRxEvent.pvData = ( void * ) pxNetworkBuffer;
 
                             pxNetworkBuffer->pxInterface = pxMyInterface;
                             pxNetworkBuffer->pxEndPoint = FreeRTOS_MatchingEndpoint( pxMyInterface, pxNetworkBuffer->pucEthernetBuffer );
                             pxNetworkBuffer->pxEndPoint = pxNetworkEndPoints; /*temporary change for single end point */
 
-                            /* Data was received and stored.  Send a message to
-                             * the IP task to let it know. */
-                            if( xSendEventStructToIPTask( &xRxEvent, ( TickType_t ) 0 ) == pdFAIL )
-                            {
-                                /* The buffer could not be sent to the stack so
-                                 * must be released again.  This is only an
-                                 * interrupt simulator, not a real interrupt, so it
-                                 * is ok to use the task level function here, but
-                                 * note no all buffer implementations will allow
-                                 * this function to be executed from a real
-                                 * interrupt. */
-                                vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
-                                iptraceETHERNET_RX_EVENT_LOST();
-                            }
+                            /* Data was received and stored.  Add it to the
+                             * batch, which is passed to the IP task when the
+                             * burst is over, or when the batch is full. */
+                            vNetworkRxBatchAdd( &xRxBatch, pxNetworkBuffer );
                         }
                         else
                         {
@@ -1028,6 +1020,9 @@ static void prvInterruptSimulatorTask( void * pvParameters )
         }
         else
         {
+            /* No more packets, pass the current batch to the IP task. */
+            ( void ) xNetworkRxBatchFlush( &xRxBatch );
+
             /* There is no real way of simulating an interrupt.  Make sure
              * other tasks can run. */
             vTaskDelay( configWINDOWS_MAC_INTERRUPT_SIMULATOR_DELAY );
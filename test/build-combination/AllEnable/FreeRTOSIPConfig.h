@@ -61,6 +61,7 @@
 #define ipconfigIGNORE_UNKNOWN_PACKETS             1
 #define ipconfigCHECK_IP_QUEUE_SPACE               1
 #define ipconfigUDP_MAX_RX_PACKETS                 1
+#define ipconfigUSE_UDP_PORT_HASH                  1
 #define ipconfigETHERNET_MINIMUM_PACKET_BYTES      1
 #define ipconfigTCP_IP_SANITY                      1
 #define ipconfigSUPPORT_NETWORK_DOWN_EVENT         1
@@ -244,6 +245,17 @@
 
 /* USE_WIN: Let TCP use windowing mechanism. */
 #define ipconfigUSE_TCP_WIN                            ( 1 )
+#define ipconfigUSE_TCP_CONGESTION_CONTROL             ( 1 )
+#define ipconfigUSE_TCP_CUBIC                          ( 1 )
+#define ipconfigUSE_TCP_TIMESTAMP_OPTION               ( 1 )
+#define ipconfigUSE_TCP_PAWS                           ( 1 )
+#define ipconfigUSE_TCP_SACK_SCOREBOARD                ( 1 )
+#define ipconfigUSE_TCP_WIN_SEGMENT_INDEX              ( 1 )
+#define ipconfigUSE_TCP_WIN_SEGMENT_ARENA              ( 1 )
+#define ipconfigUSE_CHECKSUM_SIMD                      ( 1 )
+#define ipconfigUSE_TCP_INCREMENTAL_CHECKSUM           ( 1 )
+#define ipconfigUSE_TCP_FUSED_COPY_CHECKSUM            ( 1 )
+#define ipconfigUSE_TCP_TX_SCATTER_GATHER              ( 1 )
 
 /* The MTU is the maximum number of bytes the payload of a network frame can
  * contain.  For normal Ethernet V2 frames the maximum MTU is 1500.  Setting a
@@ -268,6 +280,18 @@
  * (and associated) API function is available. */
 #define ipconfigSUPPORT_SELECT_FUNCTION                1
 
+/* If ipconfigSUPPORT_EVENT_POLL is set to 1 then the FreeRTOS_EventPoll...()
+ * API functions are available. */
+#define ipconfigSUPPORT_EVENT_POLL                     1
+
+/* If ipconfigSUPPORT_UDP_MULTI_MESSAGES is set to 1 then FreeRTOS_recvfrom_multi()
+ * and FreeRTOS_sendto_multi() are available. */
+#define ipconfigSUPPORT_UDP_MULTI_MESSAGES             1
+
+/* If ipconfigUSE_UDP_SEGMENTATION is set to 1 then the socket option
+ * FREERTOS_SO_UDP_SEGMENT is available. */
+#define ipconfigUSE_UDP_SEGMENTATION                   1
+
 /* If ipconfigFILTER_OUT_NON_ETHERNET_II_FRAMES is set to 1 then Ethernet frames
  * that are not in Ethernet II format will be dropped.  This option is included for
  * potential future IP stack developments. */
@@ -299,6 +323,35 @@
  * simultaneously, one could define TCP_WIN_SEG_COUNT as 120. */
 #define ipconfigTCP_WIN_SEG_COUNT                      240
 
+/* Look up TCP sockets in a hash table, in stead of iterating through the
+ * list of bound sockets. */
+#define ipconfigUSE_TCP_SOCKET_HASH                    1
+#define ipconfigTCP_SOCKET_HASH_SIZE                   32
+
+/* Schedule the TCP socket time-outs in a timer wheel. */
+#define ipconfigUSE_TCP_TIMER_WHEEL                    1
+
+/* Let several listening sockets share a TCP port. */
+#define ipconfigUSE_TCP_REUSE_PORT                     1
+
+/* Answer SYN packets from a table of half-open connections, and use SYN
+ * cookies when that table is full. */
+#define ipconfigUSE_TCP_SYN_CACHE                      1
+#define ipconfigTCP_SYN_CACHE_SIZE                     16
+#define ipconfigUSE_TCP_SYN_COOKIES                    1
+
+/* Free closing TCP sockets early, and answer late segments from a table of
+ * closing connections. */
+#define ipconfigUSE_TCP_TIME_WAIT                      1
+#define ipconfigTCP_TIME_WAIT_SIZE                     32
+#define ipconfigTCP_TIME_WAIT_SECONDS                  30
+
+/* Hold back small TCP segments while sent data is not yet acknowledged. */
+#define ipconfigUSE_TCP_NAGLE                          1
+
+/* Let TCP sockets choose their own delayed-ACK policy. */
+#define ipconfigUSE_TCP_ACK_POLICY                     1
+
 /* Each TCP socket has a circular buffers for Rx and Tx, which have a fixed
  * maximum size.  Define the size of Rx buffer for TCP sockets. */
 #define ipconfigTCP_RX_BUFFER_LENGTH                   ( 10000 )
@@ -0,0 +1,227 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkInterface.h"
+#include "NetworkBufferManagement.h"
+
+/*
+ * The stubs below emulate an SMP target on the POSIX port: each emulated core
+ * is a pthread.  The critical section is a single mutex shared by all cores,
+ * like the spinlock of an SMP kernel.  Masking the interrupts of a core has no
+ * effect, because no interrupts are emulated and a core is never shared by
+ * two threads.  The number of critical sections and semaphore calls is counted
+ * to measure the contention.
+ */
+
+/* The emulated core of the calling thread. */
+static __thread unsigned long ulCoreID = 0U;
+
+/* The lock that protects the critical sections and the semaphore. */
+static pthread_mutex_t xStubLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xStubCondition = PTHREAD_COND_INITIALIZER;
+
+/* The count of the network buffer semaphore. */
+static UBaseType_t uxStubSemaphoreCount = 0U;
+
+/* Statistics. */
+volatile unsigned long ulStubCriticalSections = 0U;
+volatile unsigned long ulStubSemaphoreCalls = 0U;
+
+/* The storage of the network buffers. */
+static uint8_t ucStubBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ][ ipBUFFER_PADDING + ipTOTAL_ETHERNET_FRAME_SIZE ];
+
+/* The descriptors of BufferAllocation_1.c. */
+NetworkBufferDescriptor_t * pxStubDescriptors = NULL;
+
+/* The address of the emulated semaphore. */
+static StaticQueue_t xStubSemaphore;
+
+unsigned long ulStubGetCoreID( void )
+{
+    return ulCoreID;
+}
+
+void vStubSetCoreID( unsigned long ulID )
+{
+    ulCoreID = ulID;
+}
+
+void vPortEnterCritical( void )
+{
+    ( void ) pthread_mutex_lock( &xStubLock );
+    ulStubCriticalSections++;
+}
+
+void vPortExitCritical( void )
+{
+    ( void ) pthread_mutex_unlock( &xStubLock );
+}
+
+BaseType_t xPortSetInterruptMask( void )
+{
+    return 0;
+}
+
+void vPortClearInterruptMask( BaseType_t xMask )
+{
+    ( void ) xMask;
+}
+
+QueueHandle_t xQueueCreateCountingSemaphoreStatic( const UBaseType_t uxMaxCount,
+                                                   const UBaseType_t uxInitialCount,
+                                                   StaticQueue_t * pxStaticQueue )
+{
+    ( void ) uxMaxCount;
+    ( void ) pxStaticQueue;
+
+    uxStubSemaphoreCount = uxInitialCount;
+
+    return ( QueueHandle_t ) &xStubSemaphore;
+}
+
+void vQueueAddToRegistry( QueueHandle_t xQueue,
+                          const char * pcQueueName )
+{
+    ( void ) xQueue;
+    ( void ) pcQueueName;
+}
+
+BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
+                                TickType_t xTicksToWait )
+{
+    BaseType_t xReturn = pdFAIL;
+    struct timespec xDeadline;
+
+    ( void ) xQueue;
+
+    ( void ) pthread_mutex_lock( &xStubLock );
+    ulStubSemaphoreCalls++;
+
+    if( ( uxStubSemaphoreCount == 0U ) && ( xTicksToWait > 0U ) )
+    {
+        /* Wait at most 10 ms, whatever the block time is. */
+        ( void ) clock_gettime( CLOCK_REALTIME, &xDeadline );
+        xDeadline.tv_nsec += 10000000L;
+
+        if( xDeadline.tv_nsec >= 1000000000L )
+        {
+            xDeadline.tv_sec++;
+            xDeadline.tv_nsec -= 1000000000L;
+        }
+
+        while( uxStubSemaphoreCount == 0U )
+        {
+            if( pthread_cond_timedwait( &xStubCondition, &xStubLock, &xDeadline ) != 0 )
+            {
+                break;
+            }
+        }
+    }
+
+    if( uxStubSemaphoreCount > 0U )
+    {
+        uxStubSemaphoreCount--;
+        xReturn = pdPASS;
+    }
+
+    ( void ) pthread_mutex_unlock( &xStubLock );
+
+    return xReturn;
+}
+
+BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
+                              const void * const pvItemToQueue,
+                              TickType_t xTicksToWait,
+                              const BaseType_t xCopyPosition )
+{
+    ( void ) xQueue;
+    ( void ) pvItemToQueue;
+    ( void ) xTicksToWait;
+    ( void ) xCopyPosition;
+
+    ( void ) pthread_mutex_lock( &xStubLock );
+    ulStubSemaphoreCalls++;
+    uxStubSemaphoreCount++;
+    ( void ) pthread_cond_signal( &xStubCondition );
+    ( void ) pthread_mutex_unlock( &xStubLock );
+
+    return pdPASS;
+}
+
+BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue,
+                              BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    ( void ) pxHigherPriorityTaskWoken;
+
+    return xQueueGenericSend( xQueue, NULL, 0U, queueSEND_TO_BACK );
+}
+
+BaseType_t xQueueReceiveFromISR( QueueHandle_t xQueue,
+                                 void * const pvBuffer,
+                                 BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    ( void ) pvBuffer;
+    ( void ) pxHigherPriorityTaskWoken;
+
+    return xQueueSemaphoreTake( xQueue, 0U );
+}
+
+UBaseType_t uxQueueMessagesWaitingFromISR( const QueueHandle_t xQueue )
+{
+    ( void ) xQueue;
+
+    return uxStubSemaphoreCount;
+}
+
+size_t uxNetworkInterfaceAllocateRAMToBuffers( NetworkBufferDescriptor_t pxNetworkBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ] )
+{
+    size_t x;
+
+    pxStubDescriptors = pxNetworkBuffers;
+
+    for( x = 0U; x < ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS; x++ )
+    {
+        pxNetworkBuffers[ x ].pucEthernetBuffer = &( ucStubBuffers[ x ][ ipBUFFER_PADDING ] );
+        *( ( NetworkBufferDescriptor_t ** ) ucStubBuffers[ x ] ) = &( pxNetworkBuffers[ x ] );
+    }
+
+    return ipTOTAL_ETHERNET_FRAME_SIZE;
+}
@@ -0,0 +1,435 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "FreeRTOS.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSConfig.h"
+#include "FreeRTOSIPConfig.h"
+
+#include "FreeRTOS_IP.h"
+#include "NetworkBufferManagement.h"
+
+#include "mock_task.h"
+
+/* The number of emulated cores in the stress test. */
+#define TEST_CORES         ( ipconfigBUFFER_ALLOC_NUM_CACHES )
+
+/* The number of iterations of each core in the stress test. */
+#define TEST_ITERATIONS    ( 20000U )
+
+/* The maximum number of buffers a core normally holds at the same time. */
+#define TEST_BURST         ( ipconfigBUFFER_ALLOC_CACHE_SIZE )
+
+/* Every so often a core holds more buffers than its cache can supply. */
+#define TEST_BURST_LARGE   ( ipconfigBUFFER_ALLOC_CACHE_SIZE + 4U )
+#define TEST_LARGE_EVERY   ( 64U )
+
+/* See BufferAllocation_1_stubs.c. */
+extern volatile unsigned long ulStubCriticalSections;
+extern volatile unsigned long ulStubSemaphoreCalls;
+extern NetworkBufferDescriptor_t * pxStubDescriptors;
+void vStubSetCoreID( unsigned long ulID );
+
+/* Set when a descriptor is handed out twice. */
+static volatile int iStressErrors;
+
+/* Marks the descriptors that are in use during the stress test. */
+static volatile char cInUse[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ];
+
+
+/* ============================  Unity Fixtures  ============================ */
+
+void setUp( void )
+{
+    vStubSetCoreID( 0U );
+    TEST_ASSERT_EQUAL( pdPASS, xNetworkBuffersInitialise() );
+}
+
+/* ============================== Test Cases ============================== */
+
+/**
+ * @brief A descriptor that is released goes to the cache of the core, and the
+ *        next request of that core is served from the cache, without the
+ *        semaphore or a critical section.
+ */
+void test_pxGetNetworkBufferWithDescriptor_ServedFromCache( void )
+{
+    NetworkBufferDescriptor_t * pxFirst, * pxSecond;
+    unsigned long ulCritical, ulSemaphore;
+
+    pxFirst = pxGetNetworkBufferWithDescriptor( 100U, 0U );
+    TEST_ASSERT_NOT_NULL( pxFirst );
+    TEST_ASSERT_EQUAL( 100U, pxFirst->xDataLength );
+
+    vReleaseNetworkBufferAndDescriptor( pxFirst );
+
+    ulCritical = ulStubCriticalSections;
+    ulSemaphore = ulStubSemaphoreCalls;
+
+    pxSecond = pxGetNetworkBufferWithDescriptor( 200U, 0U );
+
+    TEST_ASSERT_EQUAL_PTR( pxFirst, pxSecond );
+    TEST_ASSERT_EQUAL( 200U, pxSecond->xDataLength );
+    TEST_ASSERT_EQUAL( ulCritical, ulStubCriticalSections );
+    TEST_ASSERT_EQUAL( ulSemaphore, ulStubSemaphoreCalls );
+
+    vReleaseNetworkBufferAndDescriptor( pxSecond );
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxGetNumberOfFreeNetworkBuffers() );
+}
+
+/**
+ * @brief The caches never hold more than ipconfigBUFFER_ALLOC_CACHE_SIZE
+ *        descriptors, all descriptors can still be obtained, and they are all
+ *        free again after being released.
+ */
+void test_vReleaseNetworkBufferAndDescriptor_CacheOverflow( void )
+{
+    NetworkBufferDescriptor_t * pxBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ];
+    UBaseType_t x;
+
+    for( x = 0U; x < ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS; x++ )
+    {
+        pxBuffers[ x ] = pxGetNetworkBufferWithDescriptor( 100U, 0U );
+        TEST_ASSERT_NOT_NULL( pxBuffers[ x ] );
+    }
+
+    TEST_ASSERT_EQUAL( 0U, uxGetNumberOfFreeNetworkBuffers() );
+    TEST_ASSERT_NULL( pxGetNetworkBufferWithDescriptor( 100U, 0U ) );
+    TEST_ASSERT_EQUAL( 0U, uxGetMinimumFreeNetworkBuffers() );
+
+    for( x = 0U; x < ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS; x++ )
+    {
+        vReleaseNetworkBufferAndDescriptor( pxBuffers[ x ] );
+    }
+
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxGetNumberOfFreeNetworkBuffers() );
+}
+
+/**
+ * @brief Releasing a cached descriptor a second time does not put it in the
+ *        cache twice.
+ */
+void test_vReleaseNetworkBufferAndDescriptor_DoubleRelease( void )
+{
+    NetworkBufferDescriptor_t * pxFirst, * pxSecond;
+
+    pxFirst = pxGetNetworkBufferWithDescriptor( 100U, 0U );
+    TEST_ASSERT_NOT_NULL( pxFirst );
+
+    vReleaseNetworkBufferAndDescriptor( pxFirst );
+    vReleaseNetworkBufferAndDescriptor( pxFirst );
+
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxGetNumberOfFreeNetworkBuffers() );
+
+    pxFirst = pxGetNetworkBufferWithDescriptor( 100U, 0U );
+    pxSecond = pxGetNetworkBufferWithDescriptor( 100U, 0U );
+    TEST_ASSERT_NOT_NULL( pxFirst );
+    TEST_ASSERT_NOT_NULL( pxSecond );
+    TEST_ASSERT_TRUE( pxFirst != pxSecond );
+
+    vReleaseNetworkBufferAndDescriptor( pxFirst );
+    vReleaseNetworkBufferAndDescriptor( pxSecond );
+}
+
+/**
+ * @brief The ISR functions use the cache of the core as well.
+ */
+void test_pxNetworkBufferGetFromISR_ServedFromCache( void )
+{
+    NetworkBufferDescriptor_t * pxBuffer, * pxISRBuffer;
+    unsigned long ulCritical, ulSemaphore;
+
+    pxBuffer = pxGetNetworkBufferWithDescriptor( 100U, 0U );
+    TEST_ASSERT_NOT_NULL( pxBuffer );
+    vReleaseNetworkBufferAndDescriptor( pxBuffer );
+
+    ulCritical = ulStubCriticalSections;
+    ulSemaphore = ulStubSemaphoreCalls;
+
+    pxISRBuffer = pxNetworkBufferGetFromISR( 100U );
+    TEST_ASSERT_EQUAL_PTR( pxBuffer, pxISRBuffer );
+
+    ( void ) vNetworkBufferReleaseFromISR( pxISRBuffer );
+
+    TEST_ASSERT_EQUAL( ulCritical, ulStubCriticalSections );
+    TEST_ASSERT_EQUAL( ulSemaphore, ulStubSemaphoreCalls );
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxGetNumberOfFreeNetworkBuffers() );
+}
+
+/**
+ * @brief A descriptor that an interrupt takes from the cache is reset like any
+ *        other descriptor.
+ */
+void test_pxNetworkBufferGetFromISR_ResetsCachedDescriptor( void )
+{
+    NetworkBufferDescriptor_t * pxBuffer, * pxISRBuffer;
+
+    pxBuffer = pxGetNetworkBufferWithDescriptor( 100U, 0U );
+    TEST_ASSERT_NOT_NULL( pxBuffer );
+    pxBuffer->pxEndPoint = ( NetworkEndPoint_t * ) pxBuffer;
+    pxBuffer->pxInterface = ( NetworkInterface_t * ) pxBuffer;
+    vReleaseNetworkBufferAndDescriptor( pxBuffer );
+
+    pxISRBuffer = pxNetworkBufferGetFromISR( 300U );
+
+    TEST_ASSERT_EQUAL_PTR( pxBuffer, pxISRBuffer );
+    TEST_ASSERT_EQUAL( 300U, pxISRBuffer->xDataLength );
+    TEST_ASSERT_NULL( pxISRBuffer->pxEndPoint );
+    TEST_ASSERT_NULL( pxISRBuffer->pxInterface );
+
+    ( void ) vNetworkBufferReleaseFromISR( pxISRBuffer );
+}
+
+/**
+ * @brief An interrupt does not take the last free descriptors, not even when
+ *        they are in the cache of its core.
+ */
+void test_pxNetworkBufferGetFromISR_ThresholdAppliesToCache( void )
+{
+    NetworkBufferDescriptor_t * pxBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ];
+    UBaseType_t x;
+
+    for( x = 0U; x < ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS; x++ )
+    {
+        pxBuffers[ x ] = pxGetNetworkBufferWithDescriptor( 100U, 0U );
+        TEST_ASSERT_NOT_NULL( pxBuffers[ x ] );
+    }
+
+    /* This one goes to the cache of core 0. */
+    vReleaseNetworkBufferAndDescriptor( pxBuffers[ 0 ] );
+    TEST_ASSERT_EQUAL( 1U, uxGetNumberOfFreeNetworkBuffers() );
+
+    TEST_ASSERT_NULL( pxNetworkBufferGetFromISR( 100U ) );
+
+    for( x = 1U; x < ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS; x++ )
+    {
+        vReleaseNetworkBufferAndDescriptor( pxBuffers[ x ] );
+    }
+
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxGetNumberOfFreeNetworkBuffers() );
+}
+
+/**
+ * @brief Releasing a descriptor twice from an interrupt does not put it in a
+ *        cache or in the free list twice.
+ */
+void test_vNetworkBufferReleaseFromISR_DoubleRelease( void )
+{
+    NetworkBufferDescriptor_t * pxFirst, * pxSecond;
+
+    pxFirst = pxGetNetworkBufferWithDescriptor( 100U, 0U );
+    TEST_ASSERT_NOT_NULL( pxFirst );
+
+    ( void ) vNetworkBufferReleaseFromISR( pxFirst );
+    ( void ) vNetworkBufferReleaseFromISR( pxFirst );
+    vReleaseNetworkBufferAndDescriptor( pxFirst );
+
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxGetNumberOfFreeNetworkBuffers() );
+
+    pxFirst = pxGetNetworkBufferWithDescriptor( 100U, 0U );
+    pxSecond = pxGetNetworkBufferWithDescriptor( 100U, 0U );
+    TEST_ASSERT_NOT_NULL( pxFirst );
+    TEST_ASSERT_NOT_NULL( pxSecond );
+    TEST_ASSERT_TRUE( pxFirst != pxSecond );
+
+    vReleaseNetworkBufferAndDescriptor( pxFirst );
+    vReleaseNetworkBufferAndDescriptor( pxSecond );
+}
+
+/**
+ * @brief When a task runs out of descriptors, the other cores return their
+ *        caches to the global free list, so that in the end every descriptor
+ *        can be obtained.
+ */
+void test_pxGetNetworkBufferWithDescriptor_DrainsOtherCaches( void )
+{
+    NetworkBufferDescriptor_t * pxBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ];
+    NetworkBufferDescriptor_t * pxBuffer;
+    UBaseType_t uxCount = 0U;
+    UBaseType_t x;
+
+    /* Fill the cache of core 1. */
+    vStubSetCoreID( 1U );
+
+    for( x = 0U; x < ipconfigBUFFER_ALLOC_CACHE_SIZE; x++ )
+    {
+        pxBuffers[ x ] = pxGetNetworkBufferWithDescriptor( 100U, 0U );
+        TEST_ASSERT_NOT_NULL( pxBuffers[ x ] );
+    }
+
+    for( x = 0U; x < ipconfigBUFFER_ALLOC_CACHE_SIZE; x++ )
+    {
+        vReleaseNetworkBufferAndDescriptor( pxBuffers[ x ] );
+    }
+
+    /* Core 0 takes what it can get.  The cache of core 1 is out of reach. */
+    vStubSetCoreID( 0U );
+
+    while( ( pxBuffer = pxGetNetworkBufferWithDescriptor( 100U, 0U ) ) != NULL )
+    {
+        pxBuffers[ uxCount ] = pxBuffer;
+        uxCount++;
+    }
+
+    TEST_ASSERT_LESS_THAN( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxCount );
+
+    /* The next time core 1 uses this module, it returns its cache.  It does
+     * not keep the released descriptor either. */
+    vStubSetCoreID( 1U );
+    vReleaseNetworkBufferAndDescriptor( pxBuffers[ uxCount - 1U ] );
+    uxCount--;
+
+    vStubSetCoreID( 0U );
+
+    while( ( pxBuffer = pxGetNetworkBufferWithDescriptor( 100U, 0U ) ) != NULL )
+    {
+        pxBuffers[ uxCount ] = pxBuffer;
+        uxCount++;
+    }
+
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxCount );
+
+    for( x = 0U; x < uxCount; x++ )
+    {
+        vReleaseNetworkBufferAndDescriptor( pxBuffers[ x ] );
+    }
+
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxGetNumberOfFreeNetworkBuffers() );
+}
+
+/**
+ * @brief One emulated core of the stress test: obtain a burst of buffers,
+ *        check that none of them is in use elsewhere, and release them.
+ */
+static void * prvStressCore( void * pvParameter )
+{
+    unsigned long ulCore = ( unsigned long ) ( uintptr_t ) pvParameter;
+    NetworkBufferDescriptor_t * pxBuffers[ TEST_BURST_LARGE ];
+    UBaseType_t uxIteration, x, uxCount;
+    size_t uxIndex;
+
+    vStubSetCoreID( ulCore );
+
+    for( uxIteration = 0U; uxIteration < TEST_ITERATIONS; uxIteration++ )
+    {
+        if( ( uxIteration % TEST_LARGE_EVERY ) == 0U )
+        {
+            uxCount = TEST_BURST_LARGE;
+        }
+        else
+        {
+            uxCount = 1U + ( uxIteration % TEST_BURST );
+        }
+
+        for( x = 0U; x < uxCount; x++ )
+        {
+            pxBuffers[ x ] = pxGetNetworkBufferWithDescriptor( 100U, 1U );
+
+            if( pxBuffers[ x ] == NULL )
+            {
+                break;
+            }
+
+            uxIndex = ( size_t ) ( pxBuffers[ x ] - pxStubDescriptors );
+
+            if( __sync_lock_test_and_set( &( cInUse[ uxIndex ] ), 1 ) != 0 )
+            {
+                iStressErrors++;
+            }
+
+            pxBuffers[ x ]->pucEthernetBuffer[ 0 ] = ( uint8_t ) ulCore;
+        }
+
+        uxCount = x;
+
+        for( x = 0U; x < uxCount; x++ )
+        {
+            if( pxBuffers[ x ]->pucEthernetBuffer[ 0 ] != ( uint8_t ) ulCore )
+            {
+                iStressErrors++;
+            }
+
+            uxIndex = ( size_t ) ( pxBuffers[ x ] - pxStubDescriptors );
+            __sync_lock_release( &( cInUse[ uxIndex ] ) );
+
+            vReleaseNetworkBufferAndDescriptor( pxBuffers[ x ] );
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Run all emulated cores at the same time.  No descriptor may be handed
+ *        out twice, all descriptors must be free at the end, and the caches
+ *        must take away most of the critical sections and semaphore calls.
+ */
+void test_BufferAllocation_Stress( void )
+{
+    pthread_t xThreads[ TEST_CORES ];
+    unsigned long ulCritical, ulSemaphore, ulOperations;
+    unsigned long x;
+
+    iStressErrors = 0;
+    ulCritical = ulStubCriticalSections;
+    ulSemaphore = ulStubSemaphoreCalls;
+
+    for( x = 0U; x < TEST_CORES; x++ )
+    {
+        TEST_ASSERT_EQUAL( 0, pthread_create( &( xThreads[ x ] ), NULL, prvStressCore, ( void * ) ( uintptr_t ) x ) );
+    }
+
+    for( x = 0U; x < TEST_CORES; x++ )
+    {
+        TEST_ASSERT_EQUAL( 0, pthread_join( xThreads[ x ], NULL ) );
+    }
+
+    ulCritical = ulStubCriticalSections - ulCritical;
+    ulSemaphore = ulStubSemaphoreCalls - ulSemaphore;
+
+    /* Each iteration obtains and releases 2.5 buffers on average. */
+    ulOperations = TEST_CORES * TEST_ITERATIONS * 5U;
+
+    TEST_ASSERT_EQUAL( 0, iStressErrors );
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxGetNumberOfFreeNetworkBuffers() );
+
+    /* Without the caches, every call takes at least one critical section and
+     * one semaphore call. */
+    TEST_ASSERT_LESS_THAN( ulOperations / 4U, ulCritical );
+    TEST_ASSERT_LESS_THAN( ulOperations / 4U, ulSemaphore );
+}
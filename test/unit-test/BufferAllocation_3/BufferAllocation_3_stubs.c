@@ -0,0 +1,127 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "semphr.h"
+
+#include "FreeRTOS_IP.h"
+#include "FreeRTOS_IP_Private.h"
+#include "NetworkBufferManagement.h"
+
+/*
+ * The stubs below emulate the counting semaphore and the critical sections
+ * that BufferAllocation_3.c uses.  The tests run in a single thread, so the
+ * semaphore never blocks: a take fails at once when the count is zero.
+ */
+
+/* The count of the network buffer semaphore. */
+UBaseType_t uxStubSemaphoreCount = 0U;
+
+/* The nesting depth of the critical sections, which must be zero between
+ * two calls to the allocator. */
+BaseType_t xStubCriticalNesting = 0;
+
+/* The address of the emulated semaphore. */
+static StaticQueue_t xStubSemaphore;
+
+void vPortEnterCritical( void )
+{
+    xStubCriticalNesting++;
+}
+
+void vPortExitCritical( void )
+{
+    xStubCriticalNesting--;
+}
+
+BaseType_t xPortSetInterruptMask( void )
+{
+    return 0;
+}
+
+void vPortClearInterruptMask( BaseType_t xMask )
+{
+    ( void ) xMask;
+}
+
+QueueHandle_t xQueueCreateCountingSemaphoreStatic( const UBaseType_t uxMaxCount,
+                                                   const UBaseType_t uxInitialCount,
+                                                   StaticQueue_t * pxStaticQueue )
+{
+    ( void ) uxMaxCount;
+    ( void ) pxStaticQueue;
+
+    uxStubSemaphoreCount = uxInitialCount;
+
+    return ( QueueHandle_t ) &xStubSemaphore;
+}
+
+void vQueueAddToRegistry( QueueHandle_t xQueue,
+                          const char * pcQueueName )
+{
+    ( void ) xQueue;
+    ( void ) pcQueueName;
+}
+
+BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
+                                TickType_t xTicksToWait )
+{
+    BaseType_t xReturn = pdFAIL;
+
+    ( void ) xQueue;
+    ( void ) xTicksToWait;
+
+    if( uxStubSemaphoreCount > 0U )
+    {
+        uxStubSemaphoreCount--;
+        xReturn = pdPASS;
+    }
+
+    return xReturn;
+}
+
+BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
+                              const void * const pvItemToQueue,
+                              TickType_t xTicksToWait,
+                              const BaseType_t xCopyPosition )
+{
+    ( void ) xQueue;
+    ( void ) pvItemToQueue;
+    ( void ) xTicksToWait;
+    ( void ) xCopyPosition;
+
+    uxStubSemaphoreCount++;
+
+    return pdPASS;
+}
@@ -0,0 +1,462 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSConfig.h"
+#include "FreeRTOSIPConfig.h"
+
+#include "FreeRTOS_IP.h"
+#include "NetworkBufferManagement.h"
+
+#include "mock_task.h"
+
+/* The indexes of the size classes. */
+#define TEST_CLASS_SMALL    ( 0U )
+#define TEST_CLASS_LARGE    ( 1U )
+#define TEST_CLASS_JUMBO    ( 2U )
+#define TEST_NUM_CLASSES    ( 3U )
+
+/* See BufferAllocation_3_stubs.c. */
+extern UBaseType_t uxStubSemaphoreCount;
+extern BaseType_t xStubCriticalNesting;
+
+/* The number of buffers in each class. */
+static const UBaseType_t uxClassCount[ TEST_NUM_CLASSES ] =
+{
+    ipconfigNUM_SMALL_NETWORK_BUFFERS,
+    ipconfigNUM_LARGE_NETWORK_BUFFERS,
+    ipconfigNUM_JUMBO_NETWORK_BUFFERS
+};
+
+/* ============================  Unity Fixtures  ============================ */
+
+void setUp( void )
+{
+    TEST_ASSERT_EQUAL( pdPASS, xNetworkBuffersInitialise() );
+}
+
+/* The pools are static: every test must give back what it took. */
+void tearDown( void )
+{
+    UBaseType_t x;
+
+    TEST_ASSERT_EQUAL( 0, xStubCriticalNesting );
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxGetNumberOfFreeNetworkBuffers() );
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxStubSemaphoreCount );
+
+    for( x = 0U; x < TEST_NUM_CLASSES; x++ )
+    {
+        TEST_ASSERT_EQUAL( uxClassCount[ x ], uxGetNumberOfFreeNetworkBuffersInClass( x ) );
+    }
+}
+
+/* ======================== Test Helper Functions ========================== */
+
+/**
+ * @brief Find the class that served a network buffer, from the capacity
+ *        that is recorded in the descriptor.
+ */
+static UBaseType_t prvGetClassOfBuffer( const NetworkBufferDescriptor_t * pxNetworkBuffer )
+{
+    UBaseType_t x;
+
+    for( x = 0U; x < TEST_NUM_CLASSES; x++ )
+    {
+        if( uxGetNetworkBufferClassSize( x ) == pxNetworkBuffer->uxBufferSize )
+        {
+            break;
+        }
+    }
+
+    TEST_ASSERT_LESS_THAN( TEST_NUM_CLASSES, x );
+
+    return x;
+}
+
+/**
+ * @brief Obtain a network buffer, and check that it is served from the
+ *        expected class and that it is set up correctly.
+ */
+static NetworkBufferDescriptor_t * prvGetFromClass( size_t uxRequestedSize,
+                                                    UBaseType_t uxExpectedClass )
+{
+    NetworkBufferDescriptor_t * pxNetworkBuffer;
+    UBaseType_t uxFree = uxGetNumberOfFreeNetworkBuffersInClass( uxExpectedClass );
+
+    pxNetworkBuffer = pxGetNetworkBufferWithDescriptor( uxRequestedSize, 0U );
+
+    TEST_ASSERT_NOT_NULL( pxNetworkBuffer );
+    TEST_ASSERT_EQUAL( uxExpectedClass, prvGetClassOfBuffer( pxNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( uxFree - 1U, uxGetNumberOfFreeNetworkBuffersInClass( uxExpectedClass ) );
+    TEST_ASSERT_EQUAL( uxRequestedSize, pxNetworkBuffer->xDataLength );
+    TEST_ASSERT_EQUAL( ipconfigBUFFER_HEADROOM, pxNetworkBuffer->uxHeadroom );
+
+    /* The padding in front of the frame points back to the descriptor. */
+    TEST_ASSERT_EQUAL_PTR( pxNetworkBuffer, *( ( NetworkBufferDescriptor_t ** ) ( pxNetworkBuffer->pucEthernetBuffer - ipBUFFER_PADDING ) ) );
+
+    return pxNetworkBuffer;
+}
+
+/**
+ * @brief Release a network buffer, and check that its storage goes back to
+ *        the expected class.
+ */
+static void prvReleaseToClass( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                               UBaseType_t uxExpectedClass )
+{
+    UBaseType_t uxFree = uxGetNumberOfFreeNetworkBuffersInClass( uxExpectedClass );
+
+    vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( uxFree + 1U, uxGetNumberOfFreeNetworkBuffersInClass( uxExpectedClass ) );
+    TEST_ASSERT_NULL( pxNetworkBuffer->pucEthernetBuffer );
+}
+
+/* ============================== Test Cases ============================== */
+
+/**
+ * @brief The classes have the configured sizes, ordered from small to large.
+ */
+void test_uxGetNetworkBufferClassSize( void )
+{
+    TEST_ASSERT_EQUAL( ipconfigSMALL_NETWORK_BUFFER_SIZE, uxGetNetworkBufferClassSize( TEST_CLASS_SMALL ) );
+    TEST_ASSERT_EQUAL( ipTOTAL_ETHERNET_FRAME_SIZE, uxGetNetworkBufferClassSize( TEST_CLASS_LARGE ) );
+    TEST_ASSERT_EQUAL( ipconfigJUMBO_NETWORK_BUFFER_SIZE, uxGetNetworkBufferClassSize( TEST_CLASS_JUMBO ) );
+
+    /* There is no fourth class. */
+    TEST_ASSERT_EQUAL( 0U, uxGetNetworkBufferClassSize( TEST_NUM_CLASSES ) );
+    TEST_ASSERT_EQUAL( 0U, uxGetNumberOfFreeNetworkBuffersInClass( TEST_NUM_CLASSES ) );
+    TEST_ASSERT_EQUAL( 0U, uxGetMinimumFreeNetworkBuffersInClass( TEST_NUM_CLASSES ) );
+}
+
+/**
+ * @brief A request is served from the smallest class that can hold it, on
+ *        either side of each class boundary.
+ */
+void test_pxGetNetworkBufferWithDescriptor_ClassBoundaries( void )
+{
+    NetworkBufferDescriptor_t * pxNetworkBuffer;
+
+    /* Requests below the minimum size are rounded up, and still fit. */
+    pxNetworkBuffer = prvGetFromClass( 1U, TEST_CLASS_SMALL );
+    prvReleaseToClass( pxNetworkBuffer, TEST_CLASS_SMALL );
+
+    pxNetworkBuffer = prvGetFromClass( ipconfigSMALL_NETWORK_BUFFER_SIZE, TEST_CLASS_SMALL );
+    prvReleaseToClass( pxNetworkBuffer, TEST_CLASS_SMALL );
+
+    pxNetworkBuffer = prvGetFromClass( ipconfigSMALL_NETWORK_BUFFER_SIZE + 1U, TEST_CLASS_LARGE );
+    prvReleaseToClass( pxNetworkBuffer, TEST_CLASS_LARGE );
+
+    pxNetworkBuffer = prvGetFromClass( ipTOTAL_ETHERNET_FRAME_SIZE, TEST_CLASS_LARGE );
+    prvReleaseToClass( pxNetworkBuffer, TEST_CLASS_LARGE );
+
+    pxNetworkBuffer = prvGetFromClass( ipTOTAL_ETHERNET_FRAME_SIZE + 1U, TEST_CLASS_JUMBO );
+    prvReleaseToClass( pxNetworkBuffer, TEST_CLASS_JUMBO );
+
+    pxNetworkBuffer = prvGetFromClass( ipconfigJUMBO_NETWORK_BUFFER_SIZE, TEST_CLASS_JUMBO );
+    prvReleaseToClass( pxNetworkBuffer, TEST_CLASS_JUMBO );
+
+    /* Larger than the largest class: refused at once, without using up a
+     * descriptor. */
+    TEST_ASSERT_NULL( pxGetNetworkBufferWithDescriptor( ipconfigJUMBO_NETWORK_BUFFER_SIZE + 1U, 0U ) );
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS, uxGetNumberOfFreeNetworkBuffers() );
+}
+
+/**
+ * @brief When a class is empty, the next larger class serves the request.
+ *        When the descriptors run out, NULL is returned even though a
+ *        buffer is still free.  Every buffer goes back to the class that
+ *        served it, not to the class that the size asked for.
+ */
+void test_pxGetNetworkBufferWithDescriptor_FallBackToLargerClass( void )
+{
+    NetworkBufferDescriptor_t * pxBuffers[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ];
+    UBaseType_t uxClasses[ ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS ];
+    UBaseType_t uxExpected;
+    UBaseType_t x;
+
+    /* Small requests only: 4 small, then 3 large, then 1 jumbo buffer. */
+    for( x = 0U; x < ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS; x++ )
+    {
+        if( x < ipconfigNUM_SMALL_NETWORK_BUFFERS )
+        {
+            uxExpected = TEST_CLASS_SMALL;
+        }
+        else if( x < ( ipconfigNUM_SMALL_NETWORK_BUFFERS + ipconfigNUM_LARGE_NETWORK_BUFFERS ) )
+        {
+            uxExpected = TEST_CLASS_LARGE;
+        }
+        else
+        {
+            uxExpected = TEST_CLASS_JUMBO;
+        }
+
+        pxBuffers[ x ] = prvGetFromClass( 100U, uxExpected );
+        uxClasses[ x ] = uxExpected;
+    }
+
+    TEST_ASSERT_EQUAL( 0U, uxGetNumberOfFreeNetworkBuffers() );
+    TEST_ASSERT_EQUAL( 0U, uxGetNumberOfFreeNetworkBuffersInClass( TEST_CLASS_SMALL ) );
+    TEST_ASSERT_EQUAL( 0U, uxGetNumberOfFreeNetworkBuffersInClass( TEST_CLASS_LARGE ) );
+    TEST_ASSERT_EQUAL( 1U, uxGetNumberOfFreeNetworkBuffersInClass( TEST_CLASS_JUMBO ) );
+
+    /* A jumbo buffer is free, but there is no descriptor left. */
+    TEST_ASSERT_NULL( pxGetNetworkBufferWithDescriptor( 100U, 0U ) );
+    TEST_ASSERT_EQUAL( 1U, uxGetNumberOfFreeNetworkBuffersInClass( TEST_CLASS_JUMBO ) );
+
+    /* The low-water marks were latched per class and for the descriptors. */
+    TEST_ASSERT_EQUAL( 0U, uxGetMinimumFreeNetworkBuffersInClass( TEST_CLASS_SMALL ) );
+    TEST_ASSERT_EQUAL( 0U, uxGetMinimumFreeNetworkBuffersInClass( TEST_CLASS_LARGE ) );
+    TEST_ASSERT_LESS_OR_EQUAL( 1U, uxGetMinimumFreeNetworkBuffersInClass( TEST_CLASS_JUMBO ) );
+    TEST_ASSERT_EQUAL( 0U, uxGetMinimumFreeNetworkBuffers() );
+
+    /* Release in a different order than obtained. */
+    for( x = ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS; x > 0U; x-- )
+    {
+        prvReleaseToClass( pxBuffers[ x - 1U ], uxClasses[ x - 1U ] );
+    }
+}
+
+/**
+ * @brief When all classes that can hold a size are empty, NULL is returned
+ *        at once and the descriptor is given back, while smaller requests
+ *        are still served.
+ */
+void test_pxGetNetworkBufferWithDescriptor_ClassesExhausted( void )
+{
+    NetworkBufferDescriptor_t * pxLarge[ ipconfigNUM_LARGE_NETWORK_BUFFERS ];
+    NetworkBufferDescriptor_t * pxJumbo[ ipconfigNUM_JUMBO_NETWORK_BUFFERS ];
+    NetworkBufferDescriptor_t * pxSmall;
+    UBaseType_t uxFreeDescriptors;
+    UBaseType_t x;
+
+    for( x = 0U; x < ipconfigNUM_JUMBO_NETWORK_BUFFERS; x++ )
+    {
+        pxJumbo[ x ] = prvGetFromClass( ipconfigJUMBO_NETWORK_BUFFER_SIZE, TEST_CLASS_JUMBO );
+    }
+
+    /* The jumbo class is empty, and a large buffer cannot hold the request. */
+    TEST_ASSERT_NULL( pxGetNetworkBufferWithDescriptor( ipconfigJUMBO_NETWORK_BUFFER_SIZE, 0U ) );
+
+    for( x = 0U; x < ipconfigNUM_LARGE_NETWORK_BUFFERS; x++ )
+    {
+        pxLarge[ x ] = prvGetFromClass( ipTOTAL_ETHERNET_FRAME_SIZE, TEST_CLASS_LARGE );
+    }
+
+    uxFreeDescriptors = uxGetNumberOfFreeNetworkBuffers();
+    TEST_ASSERT_EQUAL( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS - ipconfigNUM_JUMBO_NETWORK_BUFFERS - ipconfigNUM_LARGE_NETWORK_BUFFERS, uxFreeDescriptors );
+
+    /* Nothing can hold a full frame any more; the descriptor is given back. */
+    TEST_ASSERT_NULL( pxGetNetworkBufferWithDescriptor( ipTOTAL_ETHERNET_FRAME_SIZE, 0U ) );
+    TEST_ASSERT_EQUAL( uxFreeDescriptors, uxGetNumberOfFreeNetworkBuffers() );
+    TEST_ASSERT_EQUAL( uxFreeDescriptors, uxStubSemaphoreCount );
+
+    /* A small request does not need the larger classes. */
+    pxSmall = prvGetFromClass( ipconfigSMALL_NETWORK_BUFFER_SIZE, TEST_CLASS_SMALL );
+    prvReleaseToClass( pxSmall, TEST_CLASS_SMALL );
+
+    for( x = 0U; x < ipconfigNUM_LARGE_NETWORK_BUFFERS; x++ )
+    {
+        prvReleaseToClass( pxLarge[ x ], TEST_CLASS_LARGE );
+    }
+
+    for( x = 0U; x < ipconfigNUM_JUMBO_NETWORK_BUFFERS; x++ )
+    {
+        prvReleaseToClass( pxJumbo[ x ], TEST_CLASS_JUMBO );
+    }
+}
+
+/**
+ * @brief Releasing a descriptor twice does not put its storage on the free
+ *        list of its class twice.
+ */
+void test_vReleaseNetworkBufferAndDescriptor_DoubleRelease( void )
+{
+    NetworkBufferDescriptor_t * pxNetworkBuffer;
+
+    pxNetworkBuffer = prvGetFromClass( ipTOTAL_ETHERNET_FRAME_SIZE, TEST_CLASS_LARGE );
+
+    prvReleaseToClass( pxNetworkBuffer, TEST_CLASS_LARGE );
+    vReleaseNetworkBufferAndDescriptor( pxNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( ipconfigNUM_LARGE_NETWORK_BUFFERS, uxGetNumberOfFreeNetworkBuffersInClass( TEST_CLASS_LARGE ) );
+}
+
+/**
+ * @brief pucGetNetworkBuffer() reports the size of the class that served
+ *        the request, and vReleaseNetworkBuffer() gives the storage back to
+ *        that class.  Pointers outside the pools are ignored.
+ */
+void test_pucGetNetworkBuffer_vReleaseNetworkBuffer( void )
+{
+    uint8_t ucNotPooled[ 64 ];
+    uint8_t * pucBuffer;
+    size_t uxSize;
+
+    uxSize = ipconfigSMALL_NETWORK_BUFFER_SIZE + 1U;
+    pucBuffer = pucGetNetworkBuffer( &uxSize );
+    TEST_ASSERT_NOT_NULL( pucBuffer );
+    TEST_ASSERT_EQUAL( ipTOTAL_ETHERNET_FRAME_SIZE, uxSize );
+    TEST_ASSERT_EQUAL( ipconfigNUM_LARGE_NETWORK_BUFFERS - 1U, uxGetNumberOfFreeNetworkBuffersInClass( TEST_CLASS_LARGE ) );
+
+    vReleaseNetworkBuffer( pucBuffer );
+    TEST_ASSERT_EQUAL( ipconfigNUM_LARGE_NETWORK_BUFFERS, uxGetNumberOfFreeNetworkBuffersInClass( TEST_CLASS_LARGE ) );
+
+    uxSize = ipconfigJUMBO_NETWORK_BUFFER_SIZE + 1U;
+    TEST_ASSERT_NULL( pucGetNetworkBuffer( &uxSize ) );
+
+    /* Neither a NULL pointer nor a foreign buffer changes the pools. */
+    vReleaseNetworkBuffer( NULL );
+    vReleaseNetworkBuffer( &( ucNotPooled[ 32 ] ) );
+}
+
+/**
+ * @brief A resize that fits in the attached buffer only changes the length,
+ *        also when the buffer shrinks.
+ */
+void test_pxResizeNetworkBufferWithDescriptor_FitsInPlace( void )
+{
+    NetworkBufferDescriptor_t * pxNetworkBuffer;
+    uint8_t * pucBuffer;
+
+    pxNetworkBuffer = prvGetFromClass( 100U, TEST_CLASS_SMALL );
+    pucBuffer = pxNetworkBuffer->pucEthernetBuffer;
+
+    TEST_ASSERT_EQUAL_PTR( pxNetworkBuffer, pxResizeNetworkBufferWithDescriptor( pxNetworkBuffer, ipconfigSMALL_NETWORK_BUFFER_SIZE ) );
+    TEST_ASSERT_EQUAL_PTR( pucBuffer, pxNetworkBuffer->pucEthernetBuffer );
+    TEST_ASSERT_EQUAL( ipconfigSMALL_NETWORK_BUFFER_SIZE, pxNetworkBuffer->xDataLength );
+
+    TEST_ASSERT_EQUAL_PTR( pxNetworkBuffer, pxResizeNetworkBufferWithDescriptor( pxNetworkBuffer, 10U ) );
+    TEST_ASSERT_EQUAL_PTR( pucBuffer, pxNetworkBuffer->pucEthernetBuffer );
+    TEST_ASSERT_EQUAL( 10U, pxNetworkBuffer->xDataLength );
+    TEST_ASSERT_EQUAL( TEST_CLASS_SMALL, prvGetClassOfBuffer( pxNetworkBuffer ) );
+
+    prvReleaseToClass( pxNetworkBuffer, TEST_CLASS_SMALL );
+}
+
+/**
+ * @brief Growing beyond the attached buffer moves the data to a buffer of
+ *        a larger class, and gives the old buffer back to its own class.
+ */
+void test_pxResizeNetworkBufferWithDescriptor_MovesToLargerClass( void )
+{
+    NetworkBufferDescriptor_t * pxNetworkBuffer;
+    size_t x;
+
+    pxNetworkBuffer = prvGetFromClass( 100U, TEST_CLASS_SMALL );
+
+    for( x = 0U; x < 100U; x++ )
+    {
+        pxNetworkBuffer->pucEthernetBuffer[ x ] = ( uint8_t ) x;
+    }
+
+    TEST_ASSERT_EQUAL_PTR( pxNetworkBuffer, pxResizeNetworkBufferWithDescriptor( pxNetworkBuffer, ipTOTAL_ETHERNET_FRAME_SIZE ) );
+
+    TEST_ASSERT_EQUAL( ipconfigNUM_SMALL_NETWORK_BUFFERS, uxGetNumberOfFreeNetworkBuffersInClass( TEST_CLASS_SMALL ) );
+    TEST_ASSERT_EQUAL( ipconfigNUM_LARGE_NETWORK_BUFFERS - 1U, uxGetNumberOfFreeNetworkBuffersInClass( TEST_CLASS_LARGE ) );
+    TEST_ASSERT_EQUAL( TEST_CLASS_LARGE, prvGetClassOfBuffer( pxNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( ipTOTAL_ETHERNET_FRAME_SIZE, pxNetworkBuffer->xDataLength );
+    TEST_ASSERT_EQUAL( ipconfigBUFFER_HEADROOM, pxNetworkBuffer->uxHeadroom );
+    TEST_ASSERT_EQUAL_PTR( pxNetworkBuffer, *( ( NetworkBufferDescriptor_t ** ) ( pxNetworkBuffer->pucEthernetBuffer - ipBUFFER_PADDING ) ) );
+
+    for( x = 0U; x < 100U; x++ )
+    {
+        TEST_ASSERT_EQUAL( ( uint8_t ) x, pxNetworkBuffer->pucEthernetBuffer[ x ] );
+    }
+
+    /* And on to the jumbo class. */
+    TEST_ASSERT_EQUAL_PTR( pxNetworkBuffer, pxResizeNetworkBufferWithDescriptor( pxNetworkBuffer, ipconfigJUMBO_NETWORK_BUFFER_SIZE ) );
+    TEST_ASSERT_EQUAL( ipconfigNUM_LARGE_NETWORK_BUFFERS, uxGetNumberOfFreeNetworkBuffersInClass( TEST_CLASS_LARGE ) );
+    TEST_ASSERT_EQUAL( TEST_CLASS_JUMBO, prvGetClassOfBuffer( pxNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( 99U, pxNetworkBuffer->pucEthernetBuffer[ 99 ] );
+
+    prvReleaseToClass( pxNetworkBuffer, TEST_CLASS_JUMBO );
+}
+
+/**
+ * @brief When no larger buffer is free, the resize fails and the original
+ *        buffer stays attached to the descriptor.
+ */
+void test_pxResizeNetworkBufferWithDescriptor_NoLargerBuffer( void )
+{
+    NetworkBufferDescriptor_t * pxJumbo[ ipconfigNUM_JUMBO_NETWORK_BUFFERS ];
+    NetworkBufferDescriptor_t * pxNetworkBuffer;
+    uint8_t * pucBuffer;
+    UBaseType_t x;
+
+    for( x = 0U; x < ipconfigNUM_JUMBO_NETWORK_BUFFERS; x++ )
+    {
+        pxJumbo[ x ] = prvGetFromClass( ipconfigJUMBO_NETWORK_BUFFER_SIZE, TEST_CLASS_JUMBO );
+    }
+
+    pxNetworkBuffer = prvGetFromClass( ipTOTAL_ETHERNET_FRAME_SIZE, TEST_CLASS_LARGE );
+    pucBuffer = pxNetworkBuffer->pucEthernetBuffer;
+
+    TEST_ASSERT_NULL( pxResizeNetworkBufferWithDescriptor( pxNetworkBuffer, ipTOTAL_ETHERNET_FRAME_SIZE + 1U ) );
+    TEST_ASSERT_EQUAL_PTR( pucBuffer, pxNetworkBuffer->pucEthernetBuffer );
+    TEST_ASSERT_EQUAL( ipTOTAL_ETHERNET_FRAME_SIZE, pxNetworkBuffer->xDataLength );
+
+    prvReleaseToClass( pxNetworkBuffer, TEST_CLASS_LARGE );
+
+    for( x = 0U; x < ipconfigNUM_JUMBO_NETWORK_BUFFERS; x++ )
+    {
+        prvReleaseToClass( pxJumbo[ x ], TEST_CLASS_JUMBO );
+    }
+}
+
+/**
+ * @brief A descriptor without storage gets a buffer of the right class.
+ */
+void test_pxResizeNetworkBufferWithDescriptor_NoStorage( void )
+{
+    NetworkBufferDescriptor_t * pxNetworkBuffer;
+
+    pxNetworkBuffer = prvGetFromClass( 100U, TEST_CLASS_SMALL );
+
+    /* Detach the storage, the way a driver does that keeps the buffer for
+     * its DMA. */
+    vReleaseNetworkBuffer( pxNetworkBuffer->pucEthernetBuffer );
+    pxNetworkBuffer->pucEthernetBuffer = NULL;
+
+    TEST_ASSERT_EQUAL_PTR( pxNetworkBuffer, pxResizeNetworkBufferWithDescriptor( pxNetworkBuffer, ipTOTAL_ETHERNET_FRAME_SIZE ) );
+    TEST_ASSERT_NOT_NULL( pxNetworkBuffer->pucEthernetBuffer );
+    TEST_ASSERT_EQUAL( TEST_CLASS_LARGE, prvGetClassOfBuffer( pxNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( ipconfigNUM_SMALL_NETWORK_BUFFERS, uxGetNumberOfFreeNetworkBuffersInClass( TEST_CLASS_SMALL ) );
+
+    prvReleaseToClass( pxNetworkBuffer, TEST_CLASS_LARGE );
+}
@@ -344,6 +344,7 @@
 #define ipconfigCHECK_IP_QUEUE_SPACE               ( 1 )
 #define ipconfigSELECT_USES_NOTIFY                 ( 1 )
 #define ipconfigUSE_LINKED_RX_MESSAGES             ( 1 )
+#define ipconfigRX_BATCH_BUDGET                    ( 2 )
 #define ipconfigIP_PASS_PACKETS_WITH_IP_OPTIONS    ( 0 )
 #define ipconfigZERO_COPY_TX_DRIVER                ( 1 )
 
@@ -48,6 +48,7 @@
 #include "mock_FreeRTOS_DHCPv6.h"
 #include "mock_NetworkBufferManagement.h"
 #include "mock_FreeRTOS_Routing.h"
+#include "mock_FreeRTOS_IP_Utils.h"
 
 #include "FreeRTOS_IP.h"
 
@@ -246,3 +247,162 @@ void test_prvProcessEthernetPacket_IPv4FrameType_CheckFrameFail( void )
 
     prvProcessEthernetPacket( pxNetworkBuffer );
 }
+
+/**
+ * @brief test_prvProcessIPEventsAndTimers_eNetworkRxEvent_Budget
+ * To validate that a chain of packets is processed in portions of
+ * ipconfigRX_BATCH_BUDGET packets, and that the IP-task does not block
+ * while packets are left in the backlog.
+ */
+void test_prvProcessIPEventsAndTimers_eNetworkRxEvent_Budget( void )
+{
+    IPStackEvent_t xReceivedEvent;
+    NetworkBufferDescriptor_t xNetworkBuffers[ 3 ];
+    uint8_t ucEthernetBuffers[ 3 ][ ipconfigTCP_MSS ];
+    struct xNetworkInterface xInterface;
+    NetworkEndPoint_t xNetworkEndPoint = { 0 };
+    EthernetHeader_t * pxEthernetHeader;
+    BaseType_t xIndex;
+
+    memset( xNetworkBuffers, 0, sizeof( xNetworkBuffers ) );
+    memset( ucEthernetBuffers, 0, sizeof( ucEthernetBuffers ) );
+
+    for( xIndex = 0; xIndex < 3; xIndex++ )
+    {
+        xNetworkBuffers[ xIndex ].xDataLength = ipconfigTCP_MSS;
+        xNetworkBuffers[ xIndex ].pucEthernetBuffer = ucEthernetBuffers[ xIndex ];
+        xNetworkBuffers[ xIndex ].pxInterface = &xInterface;
+        xNetworkBuffers[ xIndex ].pxEndPoint = &xNetworkEndPoint;
+
+        pxEthernetHeader = ( EthernetHeader_t * ) ucEthernetBuffers[ xIndex ];
+        pxEthernetHeader->usFrameType = 0xFFFF;
+    }
+
+    xNetworkBuffers[ 0 ].pxNextBuffer = &xNetworkBuffers[ 1 ];
+    xNetworkBuffers[ 1 ].pxNextBuffer = &xNetworkBuffers[ 2 ];
+
+    xReceivedEvent.eEventType = eNetworkRxEvent;
+    xReceivedEvent.pvData = &xNetworkBuffers[ 0 ];
+
+    /* The first iteration processes the first 2 packets. */
+    vCheckNetworkTimers_Expect();
+    xCalculateSleepTime_ExpectAndReturn( 100 );
+    xQueueReceive_ExpectAndReturn( NULL, NULL, 100, pdTRUE );
+    xQueueReceive_IgnoreArg_xQueue();
+    xQueueReceive_IgnoreArg_pvBuffer();
+    xQueueReceive_ReturnMemThruPtr_pvBuffer( &xReceivedEvent, sizeof( xReceivedEvent ) );
+    uxQueueSpacesAvailable_ExpectAnyArgsAndReturn( 100 );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffers[ 0 ] );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffers[ 1 ] );
+
+    prvProcessIPEventsAndTimers();
+
+    TEST_ASSERT_EQUAL_PTR( NULL, xNetworkBuffers[ 0 ].pxNextBuffer );
+    TEST_ASSERT_EQUAL_PTR( NULL, xNetworkBuffers[ 1 ].pxNextBuffer );
+
+    /* The second iteration does not block and processes the last packet. */
+    vCheckNetworkTimers_Expect();
+    xCalculateSleepTime_ExpectAndReturn( 100 );
+    xQueueReceive_ExpectAndReturn( NULL, NULL, 0, pdFALSE );
+    xQueueReceive_IgnoreArg_xQueue();
+    xQueueReceive_IgnoreArg_pvBuffer();
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffers[ 2 ] );
+
+    prvProcessIPEventsAndTimers();
+
+    /* The backlog is empty now, the IP-task may block again. */
+    vCheckNetworkTimers_Expect();
+    xCalculateSleepTime_ExpectAndReturn( 100 );
+    xQueueReceive_ExpectAndReturn( NULL, NULL, 100, pdFALSE );
+    xQueueReceive_IgnoreArg_xQueue();
+    xQueueReceive_IgnoreArg_pvBuffer();
+
+    prvProcessIPEventsAndTimers();
+}
+
+/**
+ * @brief test_prvProcessIPEventsAndTimers_eNetworkDownEvent_FlushesBacklog
+ * To validate that a network down event releases the packets in the RX
+ * backlog that were received by the interface that goes down, and keeps the
+ * packets of other interfaces.
+ */
+void test_prvProcessIPEventsAndTimers_eNetworkDownEvent_FlushesBacklog( void )
+{
+    IPStackEvent_t xReceivedEvent;
+    IPStackEvent_t xDownEvent;
+    NetworkBufferDescriptor_t xNetworkBuffers[ 4 ];
+    uint8_t ucEthernetBuffers[ 4 ][ ipconfigTCP_MSS ];
+    struct xNetworkInterface xInterface;
+    struct xNetworkInterface xOtherInterface;
+    NetworkEndPoint_t xNetworkEndPoint = { 0 };
+    EthernetHeader_t * pxEthernetHeader;
+    BaseType_t xIndex;
+
+    memset( xNetworkBuffers, 0, sizeof( xNetworkBuffers ) );
+    memset( ucEthernetBuffers, 0, sizeof( ucEthernetBuffers ) );
+
+    for( xIndex = 0; xIndex < 4; xIndex++ )
+    {
+        xNetworkBuffers[ xIndex ].xDataLength = ipconfigTCP_MSS;
+        xNetworkBuffers[ xIndex ].pucEthernetBuffer = ucEthernetBuffers[ xIndex ];
+        xNetworkBuffers[ xIndex ].pxInterface = &xInterface;
+        xNetworkBuffers[ xIndex ].pxEndPoint = &xNetworkEndPoint;
+
+        pxEthernetHeader = ( EthernetHeader_t * ) ucEthernetBuffers[ xIndex ];
+        pxEthernetHeader->usFrameType = 0xFFFF;
+
+        if( xIndex > 0 )
+        {
+            xNetworkBuffers[ xIndex - 1 ].pxNextBuffer = &xNetworkBuffers[ xIndex ];
+        }
+    }
+
+    /* The third packet was received by another interface. */
+    xNetworkBuffers[ 2 ].pxInterface = &xOtherInterface;
+
+    xReceivedEvent.eEventType = eNetworkRxEvent;
+    xReceivedEvent.pvData = &xNetworkBuffers[ 0 ];
+
+    xDownEvent.eEventType = eNetworkDownEvent;
+    xDownEvent.pvData = &xInterface;
+
+    /* The first 2 packets are processed, the last 2 stay in the backlog. */
+    vCheckNetworkTimers_Expect();
+    xCalculateSleepTime_ExpectAndReturn( 100 );
+    xQueueReceive_ExpectAndReturn( NULL, NULL, 100, pdTRUE );
+    xQueueReceive_IgnoreArg_xQueue();
+    xQueueReceive_IgnoreArg_pvBuffer();
+    xQueueReceive_ReturnMemThruPtr_pvBuffer( &xReceivedEvent, sizeof( xReceivedEvent ) );
+    uxQueueSpacesAvailable_ExpectAnyArgsAndReturn( 100 );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffers[ 0 ] );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffers[ 1 ] );
+
+    prvProcessIPEventsAndTimers();
+
+    /* The interface goes down: its last packet is released without being
+     * processed, the packet of the other interface is processed. */
+    vCheckNetworkTimers_Expect();
+    xCalculateSleepTime_ExpectAndReturn( 100 );
+    xQueueReceive_ExpectAndReturn( NULL, NULL, 0, pdTRUE );
+    xQueueReceive_IgnoreArg_xQueue();
+    xQueueReceive_IgnoreArg_pvBuffer();
+    xQueueReceive_ReturnMemThruPtr_pvBuffer( &xDownEvent, sizeof( xDownEvent ) );
+    uxQueueSpacesAvailable_ExpectAnyArgsAndReturn( 100 );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffers[ 3 ] );
+    prvProcessNetworkDownEvent_Expect( &xInterface );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffers[ 2 ] );
+
+    prvProcessIPEventsAndTimers();
+
+    TEST_ASSERT_EQUAL_PTR( NULL, xNetworkBuffers[ 2 ].pxNextBuffer );
+    TEST_ASSERT_EQUAL_PTR( NULL, xNetworkBuffers[ 3 ].pxNextBuffer );
+
+    /* The backlog is empty now, the IP-task may block again. */
+    vCheckNetworkTimers_Expect();
+    xCalculateSleepTime_ExpectAndReturn( 100 );
+    xQueueReceive_ExpectAndReturn( NULL, NULL, 100, pdFALSE );
+    xQueueReceive_IgnoreArg_xQueue();
+    xQueueReceive_IgnoreArg_pvBuffer();
+
+    prvProcessIPEventsAndTimers();
+}
@@ -1185,6 +1185,113 @@ void test_usGenerateProtocolChecksum_TCPCorrectCRCOutgoingPacket( void )
     TEST_ASSERT_EQUAL( ipCORRECT_CRC, usReturn );
 }
 
+/**
+ * @brief test_usGenerateProtocolChecksumPartial_TCP
+ * To validate that usGenerateProtocolChecksumPartial sets the same checksum
+ * as usGenerateProtocolChecksum when the end of the payload was summed already.
+ */
+void test_usGenerateProtocolChecksumPartial_TCP( void )
+{
+    uint16_t usReturn;
+    uint16_t usExpected;
+    uint16_t usPayloadSum;
+    uint8_t pucEthernetBuffer[ ipconfigTCP_MSS ];
+    IPPacket_t * pxIPPacket;
+    ProtocolPacket_t * pxProtPack;
+    uint16_t usLength = 100;
+    size_t uxBufferLength = usLength + ipSIZE_OF_ETH_HEADER;
+    size_t uxPayloadOffset = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER;
+    size_t uxIndex;
+
+    memset( pucEthernetBuffer, 0, ipconfigTCP_MSS );
+
+    for( uxIndex = uxPayloadOffset; uxIndex < uxBufferLength; uxIndex++ )
+    {
+        pucEthernetBuffer[ uxIndex ] = ( uint8_t ) ( uxIndex * 7U );
+    }
+
+    pxProtPack = ( ProtocolPacket_t * ) pucEthernetBuffer;
+    pxIPPacket = ( IPPacket_t * ) pucEthernetBuffer;
+    pxIPPacket->xIPHeader.ucVersionHeaderLength = 0x45;
+    pxIPPacket->xEthernetHeader.usFrameType = ipIPv4_FRAME_TYPE;
+    pxIPPacket->xIPHeader.usLength = FreeRTOS_htons( usLength );
+    pxIPPacket->xIPHeader.ucProtocol = ipPROTOCOL_TCP;
+    pxIPPacket->xIPHeader.ulSourceIPAddress = FreeRTOS_htonl( 0xC0A80001 );
+    pxIPPacket->xIPHeader.ulDestinationIPAddress = FreeRTOS_htonl( 0xC0A80002 );
+    pxProtPack->xTCPPacket.xTCPHeader.ucTCPOffset = 0x50;
+    pxProtPack->xTCPPacket.xTCPHeader.usSourcePort = FreeRTOS_htons( 1234 );
+
+    prvChecksumIPv4Checks_Stub( prvChecksumIPv4Checks_Valid );
+    usReturn = usGenerateProtocolChecksum( pucEthernetBuffer, uxBufferLength, pdTRUE );
+    TEST_ASSERT_EQUAL( ipCORRECT_CRC, usReturn );
+    usExpected = pxProtPack->xTCPPacket.xTCPHeader.usChecksum;
+
+    /* The complete payload summed in advance. */
+    pxProtPack->xTCPPacket.xTCPHeader.usChecksum = 0xABCD;
+    usPayloadSum = usGenerateChecksum( 0U, &( pucEthernetBuffer[ uxPayloadOffset ] ), uxBufferLength - uxPayloadOffset );
+    usReturn = usGenerateProtocolChecksumPartial( pucEthernetBuffer, uxBufferLength, uxBufferLength - uxPayloadOffset, usPayloadSum );
+    TEST_ASSERT_EQUAL( ipCORRECT_CRC, usReturn );
+    TEST_ASSERT_EQUAL_HEX16( usExpected, pxProtPack->xTCPPacket.xTCPHeader.usChecksum );
+
+    /* Only the last 10 bytes. */
+    pxProtPack->xTCPPacket.xTCPHeader.usChecksum = 0xABCD;
+    usPayloadSum = usGenerateChecksum( 0U, &( pucEthernetBuffer[ uxBufferLength - 10U ] ), 10U );
+    usReturn = usGenerateProtocolChecksumPartial( pucEthernetBuffer, uxBufferLength, 10U, usPayloadSum );
+    TEST_ASSERT_EQUAL( ipCORRECT_CRC, usReturn );
+    TEST_ASSERT_EQUAL_HEX16( usExpected, pxProtPack->xTCPPacket.xTCPHeader.usChecksum );
+
+    /* More bytes than the payload: the sum is ignored. */
+    pxProtPack->xTCPPacket.xTCPHeader.usChecksum = 0xABCD;
+    usReturn = usGenerateProtocolChecksumPartial( pucEthernetBuffer, uxBufferLength, uxBufferLength, 0x1234U );
+    TEST_ASSERT_EQUAL( ipCORRECT_CRC, usReturn );
+    TEST_ASSERT_EQUAL_HEX16( usExpected, pxProtPack->xTCPPacket.xTCPHeader.usChecksum );
+}
+
+/**
+ * @brief test_usGenerateProtocolChecksumPartial_TCPv6
+ * To validate usGenerateProtocolChecksumPartial for a TCP packet over IPv6.
+ */
+void test_usGenerateProtocolChecksumPartial_TCPv6( void )
+{
+    uint16_t usReturn;
+    uint16_t usExpected;
+    uint16_t usPayloadSum;
+    uint8_t pucEthernetBuffer[ ipconfigTCP_MSS ];
+    IPPacket_IPv6_t * pxIPPacket;
+    TCPPacket_IPv6_t * pxTCPv6Packet;
+    uint16_t usLength = 100;
+    size_t uxBufferLength = usLength + ipSIZE_OF_ETH_HEADER;
+    size_t uxPayloadOffset = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv6_HEADER + ipSIZE_OF_TCP_HEADER;
+    size_t uxIndex;
+
+    memset( pucEthernetBuffer, 0, ipconfigTCP_MSS );
+
+    for( uxIndex = uxPayloadOffset; uxIndex < uxBufferLength; uxIndex++ )
+    {
+        pucEthernetBuffer[ uxIndex ] = ( uint8_t ) ( uxIndex * 13U );
+    }
+
+    pxTCPv6Packet = ( TCPPacket_IPv6_t * ) pucEthernetBuffer;
+    pxIPPacket = ( IPPacket_IPv6_t * ) pucEthernetBuffer;
+    pxIPPacket->xEthernetHeader.usFrameType = ipIPv6_FRAME_TYPE;
+    pxIPPacket->xIPHeader.usPayloadLength = FreeRTOS_htons( usLength - ipSIZE_OF_IPv6_HEADER );
+    pxIPPacket->xIPHeader.ucNextHeader = ipPROTOCOL_TCP;
+    pxIPPacket->xIPHeader.xSourceAddress.ucBytes[ 15 ] = 1;
+    pxIPPacket->xIPHeader.xDestinationAddress.ucBytes[ 15 ] = 2;
+    pxTCPv6Packet->xTCPHeader.ucTCPOffset = 0x50;
+
+    prvChecksumIPv6Checks_Stub( prvChecksumIPv6Checks_Valid );
+    usReturn = usGenerateProtocolChecksum( pucEthernetBuffer, uxBufferLength, pdTRUE );
+    TEST_ASSERT_EQUAL( ipCORRECT_CRC, usReturn );
+    usExpected = pxTCPv6Packet->xTCPHeader.usChecksum;
+
+    pxTCPv6Packet->xTCPHeader.usChecksum = 0xABCD;
+    usPayloadSum = usGenerateChecksum( 0U, &( pucEthernetBuffer[ uxPayloadOffset ] ), uxBufferLength - uxPayloadOffset );
+    usReturn = usGenerateProtocolChecksumPartial( pucEthernetBuffer, uxBufferLength, uxBufferLength - uxPayloadOffset, usPayloadSum );
+    TEST_ASSERT_EQUAL( ipCORRECT_CRC, usReturn );
+    TEST_ASSERT_EQUAL_HEX16( usExpected, pxTCPv6Packet->xTCPHeader.usChecksum );
+}
+
 /**
  * @brief test_usGenerateProtocolChecksum_TCPCorrectCRCOutgoingPacketZeroChecksum
  * To validate usGenerateProtocolChecksum returns ipCORRECT_CRC if
@@ -2349,6 +2456,123 @@ void test_usGenerateChecksum_FourByteAlignedSumOverflow2( void )
     TEST_ASSERT_EQUAL( 21759, usResult );
 }
 
+/**
+ * @brief test_usCopyAndChecksum
+ * To validate that usCopyAndChecksum copies the data and returns the same
+ * value as usGenerateChecksum, for all small lengths and alignments.
+ */
+void test_usCopyAndChecksum( void )
+{
+    uint8_t ucData[ 80 ];
+    uint8_t ucCopy[ 88 ];
+    size_t uxLength;
+    size_t uxOffset;
+    size_t uxIndex;
+
+    for( uxIndex = 0; uxIndex < sizeof( ucData ); uxIndex++ )
+    {
+        ucData[ uxIndex ] = ( uint8_t ) ( ( uxIndex * 37U ) + 0xF0U );
+    }
+
+    for( uxOffset = 0; uxOffset < 4U; uxOffset++ )
+    {
+        for( uxLength = 0; uxLength <= ( sizeof( ucData ) - 4U ); uxLength++ )
+        {
+            memset( ucCopy, 0x5A, sizeof( ucCopy ) );
+
+            TEST_ASSERT_EQUAL_HEX16( usGenerateChecksum( 0xFFF0U, &( ucData[ uxOffset ] ), uxLength ),
+                                     usCopyAndChecksum( 0xFFF0U, &( ucCopy[ 3U - uxOffset ] ), &( ucData[ uxOffset ] ), uxLength ) );
+            TEST_ASSERT_EQUAL_MEMORY( &( ucData[ uxOffset ] ), &( ucCopy[ 3U - uxOffset ] ), uxLength );
+            TEST_ASSERT_EQUAL_HEX8( 0x5A, ucCopy[ 3U - uxOffset + uxLength ] );
+        }
+    }
+
+    /* Many words of 0xFFFF, to exercise the carries. */
+    memset( ucData, 0xFF, sizeof( ucData ) );
+    TEST_ASSERT_EQUAL_HEX16( usGenerateChecksum( 0xFFFFU, ucData, sizeof( ucData ) ),
+                             usCopyAndChecksum( 0xFFFFU, ucCopy, ucData, sizeof( ucData ) ) );
+}
+
+/**
+ * @brief test_usChecksumAdd
+ * To validate that the sums of two consecutive blocks can be added.
+ */
+void test_usChecksumAdd( void )
+{
+    uint8_t ucData[ 64 ];
+    size_t uxIndex;
+    uint16_t usFirst;
+    uint16_t usSecond;
+
+    for( uxIndex = 0; uxIndex < sizeof( ucData ); uxIndex++ )
+    {
+        ucData[ uxIndex ] = ( uint8_t ) ( 0xFFU - uxIndex );
+    }
+
+    usFirst = usGenerateChecksum( 0U, ucData, 22U );
+    usSecond = usGenerateChecksum( 0U, &( ucData[ 22 ] ), sizeof( ucData ) - 22U );
+
+    TEST_ASSERT_EQUAL_HEX16( usGenerateChecksum( 0U, ucData, sizeof( ucData ) ), usChecksumAdd( usFirst, usSecond ) );
+    TEST_ASSERT_EQUAL_HEX16( usFirst, usChecksumAdd( usFirst, 0U ) );
+}
+
+/**
+ * @brief test_usChecksumAdjust16
+ * To validate that usChecksumAdjust16 gives the same checksum as a full
+ * calculation after a 16-bit word has been changed.
+ */
+void test_usChecksumAdjust16( void )
+{
+    uint16_t usWords[ 10 ];
+    uint16_t usChecksum;
+    uint16_t usOldValue;
+    size_t uxIndex;
+
+    for( uxIndex = 0; uxIndex < 10U; uxIndex++ )
+    {
+        usWords[ uxIndex ] = ( uint16_t ) ( 0x1234U * ( uxIndex + 1U ) );
+    }
+
+    usWords[ 5 ] = 0U;
+    usWords[ 5 ] = ( uint16_t ) ~FreeRTOS_htons( usGenerateChecksum( 0U, ( const uint8_t * ) usWords, sizeof( usWords ) ) );
+
+    usOldValue = usWords[ 3 ];
+    usWords[ 3 ] = 0xABCDU;
+    usChecksum = usChecksumAdjust16( usWords[ 5 ], usOldValue, usWords[ 3 ] );
+
+    usWords[ 5 ] = 0U;
+    TEST_ASSERT_EQUAL_HEX16( ( uint16_t ) ~FreeRTOS_htons( usGenerateChecksum( 0U, ( const uint8_t * ) usWords, sizeof( usWords ) ) ), usChecksum );
+
+    usWords[ 5 ] = usChecksum;
+    TEST_ASSERT_EQUAL_HEX16( ipCORRECT_CRC, usGenerateChecksum( 0U, ( const uint8_t * ) usWords, sizeof( usWords ) ) );
+}
+
+/**
+ * @brief test_usChecksumAdjust32
+ * To validate that usChecksumAdjust32 keeps a checksum valid after a 32-bit
+ * field has been changed, also when the one's complement sum has to wrap.
+ */
+void test_usChecksumAdjust32( void )
+{
+    uint32_t ulWords[ 5 ] = { 0xFFFFFFFFU, 0x00000001U, 0x80008000U, 0U, 0x7FFF7FFFU };
+    uint16_t * pusChecksum = ( uint16_t * ) &( ulWords[ 3 ] );
+    uint32_t ulOldValue;
+
+    pusChecksum[ 0 ] = ( uint16_t ) ~FreeRTOS_htons( usGenerateChecksum( 0U, ( const uint8_t * ) ulWords, sizeof( ulWords ) ) );
+
+    ulOldValue = ulWords[ 1 ];
+    ulWords[ 1 ] = FreeRTOS_htonl( 0xFFFF0002U );
+    pusChecksum[ 0 ] = usChecksumAdjust32( pusChecksum[ 0 ], ulOldValue, ulWords[ 1 ] );
+
+    TEST_ASSERT_EQUAL_HEX16( ipCORRECT_CRC, usGenerateChecksum( 0U, ( const uint8_t * ) ulWords, sizeof( ulWords ) ) );
+
+    ulOldValue = ulWords[ 0 ];
+    ulWords[ 0 ] = 0U;
+    pusChecksum[ 0 ] = usChecksumAdjust32( pusChecksum[ 0 ], ulOldValue, ulWords[ 0 ] );
+
+    TEST_ASSERT_EQUAL_HEX16( ipCORRECT_CRC, usGenerateChecksum( 0U, ( const uint8_t * ) ulWords, sizeof( ulWords ) ) );
+}
+
 /**
  * @brief test_vPrintResourceStats_BufferCountMore
  * To validate vPrintResourceStats when minimum free network buffer
@@ -65,6 +65,9 @@
  * stack repeating the checksum calculations. */
 #define ipconfigDRIVER_INCLUDED_RX_IP_CHECKSUM     0
 
+/* Use SSE2, AVX2 or NEON instructions to calculate checksums. */
+#define ipconfigUSE_CHECKSUM_SIMD                  1
+
 /* Several API's will block until the result is known, or the action has been
  * performed, for example FreeRTOS_send() and FreeRTOS_recv().  The timeouts can be
  * set per socket, using setsockopt().  If not set, the times below will be
@@ -334,4 +337,10 @@
 #define ipconfigCHECK_IP_QUEUE_SPACE    ( 1 )
 #define ipconfigZERO_COPY_TX_DRIVER     ( 1 )
 
+#define ipconfigBUFFER_HEADROOM         ( 16 )
+#define ipconfigBUFFER_TAILROOM         ( 32 )
+
+#define ipconfigUSE_TCP_TX_SCATTER_GATHER          ( 1 )
+#define ipconfigTCP_TX_SCATTER_GATHER_MIN_BYTES    ( 256 )
+
 #endif /* FREERTOS_IP_CONFIG_H */
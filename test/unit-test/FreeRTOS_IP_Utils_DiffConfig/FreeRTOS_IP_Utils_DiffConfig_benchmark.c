@@ -0,0 +1,186 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Benchmark of the checksum kernels, built only when UNITTEST_BENCHMARKS is
+ * ON.  It is not registered with CTest: the speeds depend on the machine and
+ * its load, so they are printed, not checked.
+ */
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "mock_task.h"
+#include "mock_list.h"
+
+/* This must come after list.h is included (in this case, indirectly
+ * by mock_list.h). */
+#include "mock_IP_Utils_DiffConfig_list_macros.h"
+#include "mock_queue.h"
+#include "mock_event_groups.h"
+
+#include "FreeRTOSIPConfig.h"
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_IP_Timers.h"
+#include "mock_FreeRTOS_ARP.h"
+#include "mock_FreeRTOS_DHCP.h"
+#include "mock_FreeRTOS_Sockets.h"
+#include "mock_FreeRTOS_Routing.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_FreeRTOS_IPv4_Utils.h"
+
+#include "FreeRTOS_IP_Utils.h"
+#include "FreeRTOS_IP_Checksum.h"
+#include "FreeRTOS_IP_Utils_DiffConfig_stubs.c"
+
+#include "catch_assert.h"
+
+#if ( ipCHECKSUM_HAS_X86_64 == 1 )
+    #include <x86intrin.h>
+#endif
+
+/* The size of a full TCP payload. */
+#define BENCHMARK_PAYLOAD_SIZE    ( 1460U )
+
+/* The number of checksums calculated per implementation. */
+#define BENCHMARK_LOOPS           ( 20000U )
+
+/* Let a kernel calculate a checksum, in the same way as usGenerateChecksum(). */
+static uint16_t prvKernelChecksum( ChecksumKernel_t pxKernel,
+                                   uint16_t usSum,
+                                   const uint8_t * pucData,
+                                   size_t uxLength )
+{
+    uint32_t ulSum = pxKernel( ( uint32_t ) FreeRTOS_ntohs( usSum ), pucData, uxLength );
+
+    return FreeRTOS_htons( ( uint16_t ) ulSum );
+}
+
+/* Read a counter: the time-stamp counter on x86-64, otherwise a clock in
+ * nanoseconds. */
+static uint64_t prvReadCounter( void )
+{
+    uint64_t ullCounter;
+
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+        ullCounter = __rdtsc();
+    #else
+        struct timespec xTime;
+
+        ( void ) clock_gettime( CLOCK_MONOTONIC, &xTime );
+        ullCounter = ( ( uint64_t ) xTime.tv_sec * 1000000000U ) + ( uint64_t ) xTime.tv_nsec;
+    #endif
+
+    return ullCounter;
+}
+
+/* Print the number of bytes checked per counter tick, and return the
+ * checksum of the last loop. */
+static uint16_t prvBenchmarkKernel( const char * pcName,
+                                    ChecksumKernel_t pxKernel,
+                                    const uint8_t * pucData )
+{
+    uint64_t ullStart;
+    uint64_t ullTicks;
+    uint32_t ulLoop;
+    uint16_t usResult = 0U;
+
+    ullStart = prvReadCounter();
+
+    for( ulLoop = 0U; ulLoop < BENCHMARK_LOOPS; ulLoop++ )
+    {
+        if( pxKernel != NULL )
+        {
+            usResult = prvKernelChecksum( pxKernel, ( uint16_t ) ulLoop, pucData, BENCHMARK_PAYLOAD_SIZE );
+        }
+        else
+        {
+            usResult = usGenerateChecksumScalar( ( uint16_t ) ulLoop, pucData, BENCHMARK_PAYLOAD_SIZE );
+        }
+    }
+
+    ullTicks = prvReadCounter() - ullStart;
+
+    if( ullTicks == 0U )
+    {
+        ullTicks = 1U;
+    }
+
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+        printf( "Checksum %-6s: %.2f bytes per cycle\n", pcName,
+                ( double ) BENCHMARK_PAYLOAD_SIZE * BENCHMARK_LOOPS / ( double ) ullTicks );
+    #else
+        printf( "Checksum %-6s: %.2f bytes per ns\n", pcName,
+                ( double ) BENCHMARK_PAYLOAD_SIZE * BENCHMARK_LOOPS / ( double ) ullTicks );
+    #endif
+
+    return usResult;
+}
+
+/**
+ * @brief test_usGenerateChecksum_SIMD_Benchmark
+ * Report the speed of every implementation that runs on this CPU, for
+ * checksums over a full TCP payload.
+ */
+void test_usGenerateChecksum_SIMD_Benchmark( void )
+{
+    static uint8_t ucData[ BENCHMARK_PAYLOAD_SIZE ];
+    uint16_t usExpected;
+    size_t uxIndex;
+
+    srand( 1234 );
+
+    for( uxIndex = 0U; uxIndex < sizeof( ucData ); uxIndex++ )
+    {
+        ucData[ uxIndex ] = ( uint8_t ) rand();
+    }
+
+    usExpected = prvBenchmarkKernel( "scalar", NULL, ucData );
+
+    /* The results are compared, so the loops can not be optimised away. */
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+        TEST_ASSERT_EQUAL_HEX16( usExpected, prvBenchmarkKernel( "SSE2", ulChecksumSSE2, ucData ) );
+
+        if( xChecksumHasAVX2() != pdFALSE )
+        {
+            TEST_ASSERT_EQUAL_HEX16( usExpected, prvBenchmarkKernel( "AVX2", ulChecksumAVX2, ucData ) );
+        }
+    #endif
+
+    #if ( ipCHECKSUM_HAS_NEON == 1 )
+        TEST_ASSERT_EQUAL_HEX16( usExpected, prvBenchmarkKernel( "NEON", ulChecksumNEON, ucData ) );
+    #endif
+}
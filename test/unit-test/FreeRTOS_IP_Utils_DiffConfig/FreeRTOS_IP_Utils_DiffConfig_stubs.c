@@ -50,8 +50,17 @@ NetworkInterface_t xInterfaces[ 1 ];
 
 QueueHandle_t xNetworkEventQueue;
 
+/* The number of calls to vStreamBufferDereference(). */
+UBaseType_t uxStreamBufferDereferences;
+
 /* ============================ Stubs Functions =========================== */
 
+void vStreamBufferDereference( StreamBuffer_t * const pxBuffer )
+{
+    ( void ) pxBuffer;
+    uxStreamBufferDereferences++;
+}
+
 static BaseType_t xNetworkInterfaceInitialise_test( struct xNetworkInterface * pxDescriptor )
 {
     return pdPASS;
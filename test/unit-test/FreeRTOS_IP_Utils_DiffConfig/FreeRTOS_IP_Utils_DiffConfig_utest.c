@@ -56,10 +56,22 @@
 #include "mock_FreeRTOS_IPv4_Utils.h"
 
 #include "FreeRTOS_IP_Utils.h"
+#include "FreeRTOS_IP_Checksum.h"
 #include "FreeRTOS_IP_Utils_DiffConfig_stubs.c"
 
 #include "catch_assert.h"
 
+/* The size of the random data used by the checksum tests, large enough to
+ * let the kernels sum more than one block of 64 KB. */
+#define TEST_CHECKSUM_DATA_SIZE         ( 150000U )
+
+/* The longest length checked at every alignment: several blocks of the
+ * widest (AVX2) kernel, plus a tail. */
+#define TEST_CHECKSUM_MAX_LENGTH        ( 520U )
+
+/* The number of start alignments checked, enough for a 16-byte vector. */
+#define TEST_CHECKSUM_ALIGNMENTS        ( 16U )
+
 /* =========================== EXTERN VARIABLES =========================== */
 
 #if ( ipconfigUSE_NETWORK_EVENT_HOOK == 1 )
@@ -335,3 +347,560 @@ void test_pxUDPPayloadBuffer_to_NetworkBuffer_IPv6( void )
 
     TEST_ASSERT_EQUAL( pxNetBufferToReturn, pxNetworkBuffer );
 }
+
+/* ======================== Vectorised checksum tests ======================= */
+
+/* Fill 'pucData' with a repeatable pseudo-random pattern. */
+static void prvFillChecksumData( uint8_t * pucData,
+                                 size_t uxLength )
+{
+    size_t uxIndex;
+
+    srand( 1234 );
+
+    for( uxIndex = 0U; uxIndex < uxLength; uxIndex++ )
+    {
+        pucData[ uxIndex ] = ( uint8_t ) rand();
+    }
+}
+
+/* Let a kernel calculate a checksum, in the same way as usGenerateChecksum(). */
+static uint16_t prvKernelChecksum( ChecksumKernel_t pxKernel,
+                                   uint16_t usSum,
+                                   const uint8_t * pucData,
+                                   size_t uxLength )
+{
+    uint32_t ulSum = pxKernel( ( uint32_t ) FreeRTOS_ntohs( usSum ), pucData, uxLength );
+
+    return FreeRTOS_htons( ( uint16_t ) ulSum );
+}
+
+/* Compare a kernel with the portable implementation, for all lengths up to
+ * 300 bytes, some long lengths, and all alignments of the data. */
+static void prvCrossCheckKernel( ChecksumKernel_t pxKernel )
+{
+    static uint8_t ucData[ TEST_CHECKSUM_DATA_SIZE ];
+    static const size_t uxLongLengths[] = { 1460U, 1461U, 8999U, 65535U, 65536U, 65567U, TEST_CHECKSUM_DATA_SIZE - 8U };
+    size_t uxLength;
+    size_t uxOffset;
+    size_t uxIndex;
+    uint16_t usSum;
+
+    prvFillChecksumData( ucData, sizeof( ucData ) );
+
+    for( uxOffset = 0U; uxOffset < 8U; uxOffset++ )
+    {
+        for( uxLength = 0U; uxLength <= 300U; uxLength++ )
+        {
+            usSum = ( uint16_t ) ( ( uxLength * 0x1021U ) + uxOffset );
+            TEST_ASSERT_EQUAL_HEX16( usGenerateChecksumScalar( usSum, &( ucData[ uxOffset ] ), uxLength ),
+                                     prvKernelChecksum( pxKernel, usSum, &( ucData[ uxOffset ] ), uxLength ) );
+        }
+
+        for( uxIndex = 0U; uxIndex < ( sizeof( uxLongLengths ) / sizeof( uxLongLengths[ 0 ] ) ); uxIndex++ )
+        {
+            uxLength = uxLongLengths[ uxIndex ];
+            TEST_ASSERT_EQUAL_HEX16( usGenerateChecksumScalar( 0U, &( ucData[ uxOffset ] ), uxLength ),
+                                     prvKernelChecksum( pxKernel, 0U, &( ucData[ uxOffset ] ), uxLength ) );
+        }
+    }
+
+    /* All words 0xffff: the largest possible lane values. */
+    memset( ucData, 0xff, sizeof( ucData ) );
+    TEST_ASSERT_EQUAL_HEX16( usGenerateChecksumScalar( 0xffffU, ucData, sizeof( ucData ) ),
+                             prvKernelChecksum( pxKernel, 0xffffU, ucData, sizeof( ucData ) ) );
+
+    /* All words zero. */
+    memset( ucData, 0x00, sizeof( ucData ) );
+    TEST_ASSERT_EQUAL_HEX16( usGenerateChecksumScalar( 0U, ucData, sizeof( ucData ) ),
+                             prvKernelChecksum( pxKernel, 0U, ucData, sizeof( ucData ) ) );
+}
+
+/* Let a copy kernel copy and sum data, in the same way as usCopyAndChecksum(). */
+static uint16_t prvCopyKernelChecksum( ChecksumCopyKernel_t pxKernel,
+                                       uint16_t usSum,
+                                       uint8_t * pucDestination,
+                                       const uint8_t * pucSource,
+                                       size_t uxLength )
+{
+    uint32_t ulSum = pxKernel( ( uint32_t ) FreeRTOS_ntohs( usSum ), pucDestination, pucSource, uxLength );
+
+    return FreeRTOS_htons( ( uint16_t ) ulSum );
+}
+
+/* Compare a copy kernel with the portable checksum, and check the copy, for
+ * all lengths up to 300 bytes and all alignments of source and destination. */
+static void prvCrossCheckCopyKernel( ChecksumCopyKernel_t pxKernel )
+{
+    static uint8_t ucData[ 2048 ];
+    static uint8_t ucCopy[ 2048 ];
+    size_t uxLength;
+    size_t uxOffset;
+    uint16_t usSum;
+
+    prvFillChecksumData( ucData, sizeof( ucData ) );
+
+    for( uxOffset = 0U; uxOffset < 8U; uxOffset++ )
+    {
+        for( uxLength = 0U; uxLength <= 300U; uxLength++ )
+        {
+            memset( ucCopy, 0xa5, sizeof( ucCopy ) );
+            usSum = ( uint16_t ) ( ( uxLength * 0x1021U ) + uxOffset );
+            TEST_ASSERT_EQUAL_HEX16( usGenerateChecksumScalar( usSum, &( ucData[ uxOffset ] ), uxLength ),
+                                     prvCopyKernelChecksum( pxKernel, usSum, &( ucCopy[ 7U - uxOffset ] ), &( ucData[ uxOffset ] ), uxLength ) );
+            TEST_ASSERT_EQUAL_MEMORY( &( ucData[ uxOffset ] ), &( ucCopy[ 7U - uxOffset ] ), uxLength );
+            /* Nothing is written past the end. */
+            TEST_ASSERT_EQUAL_HEX8( 0xa5U, ucCopy[ 7U - uxOffset + uxLength ] );
+        }
+    }
+
+    TEST_ASSERT_EQUAL_HEX16( usGenerateChecksumScalar( 0U, ucData, sizeof( ucData ) ),
+                             prvCopyKernelChecksum( pxKernel, 0U, ucCopy, ucData, sizeof( ucData ) ) );
+}
+
+/**
+ * @brief test_usGenerateChecksum_SIMD_MatchesScalar
+ * The selected kernel must give the same checksums as the portable implementation.
+ */
+void test_usGenerateChecksum_SIMD_MatchesScalar( void )
+{
+    static uint8_t ucData[ 2048 ];
+    size_t uxLength;
+    size_t uxOffset;
+
+    prvFillChecksumData( ucData, sizeof( ucData ) );
+
+    for( uxOffset = 0U; uxOffset < 4U; uxOffset++ )
+    {
+        for( uxLength = 0U; uxLength < ( sizeof( ucData ) - 4U ); uxLength += 7U )
+        {
+            TEST_ASSERT_EQUAL_HEX16( usGenerateChecksumScalar( 0x1234U, &( ucData[ uxOffset ] ), uxLength ),
+                                     usGenerateChecksum( 0x1234U, &( ucData[ uxOffset ] ), uxLength ) );
+        }
+    }
+}
+
+/**
+ * @brief test_usGenerateChecksum_SIMD_IPv4Header
+ * A correct IPv4 header sums up to ipCORRECT_CRC.
+ */
+void test_usGenerateChecksum_SIMD_IPv4Header( void )
+{
+    const uint8_t ucHeader[ ipSIZE_OF_IPv4_HEADER ] =
+    {
+        0x45, 0x00, 0x00, 0x73, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11,
+        0xb8, 0x61, 0xc0, 0xa8, 0x00, 0x01, 0xc0, 0xa8, 0x00, 0xc7
+    };
+
+    TEST_ASSERT_EQUAL_HEX16( ipCORRECT_CRC, usGenerateChecksum( 0U, ucHeader, sizeof( ucHeader ) ) );
+}
+
+/**
+ * @brief test_pxChecksumGetKernel
+ * On x86-64 and AArch64, a vectorised kernel must be selected.
+ */
+void test_pxChecksumGetKernel( void )
+{
+    ChecksumKernel_t pxKernel = pxChecksumGetKernel();
+
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+        if( xChecksumHasAVX2() != pdFALSE )
+        {
+            TEST_ASSERT_EQUAL_PTR( ulChecksumAVX2, pxKernel );
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_PTR( ulChecksumSSE2, pxKernel );
+        }
+    #elif ( ipCHECKSUM_HAS_NEON == 1 )
+        TEST_ASSERT_EQUAL_PTR( ulChecksumNEON, pxKernel );
+    #else
+        TEST_ASSERT_NULL( pxKernel );
+    #endif
+
+    /* The selection is done once. */
+    TEST_ASSERT_EQUAL_PTR( pxKernel, pxChecksumGetKernel() );
+}
+
+/**
+ * @brief test_ChecksumKernels_MatchScalar
+ * Cross-check every kernel that runs on this CPU against the portable
+ * implementation.
+ */
+void test_ChecksumKernels_MatchScalar( void )
+{
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+        prvCrossCheckKernel( ulChecksumSSE2 );
+
+        if( xChecksumHasAVX2() != pdFALSE )
+        {
+            prvCrossCheckKernel( ulChecksumAVX2 );
+        }
+    #endif
+
+    #if ( ipCHECKSUM_HAS_NEON == 1 )
+        prvCrossCheckKernel( ulChecksumNEON );
+    #endif
+}
+
+/**
+ * @brief test_usGenerateChecksum_SIMD_AllLengthsAndAlignments
+ * The selected kernel must give the same checksums as the portable
+ * implementation for every length up to TEST_CHECKSUM_MAX_LENGTH, including
+ * all odd lengths, at every alignment of the data.
+ */
+void test_usGenerateChecksum_SIMD_AllLengthsAndAlignments( void )
+{
+    static uint8_t ucData[ TEST_CHECKSUM_MAX_LENGTH + TEST_CHECKSUM_ALIGNMENTS ];
+    size_t uxLength;
+    size_t uxOffset;
+    uint16_t usSum;
+
+    prvFillChecksumData( ucData, sizeof( ucData ) );
+
+    for( uxOffset = 0U; uxOffset < TEST_CHECKSUM_ALIGNMENTS; uxOffset++ )
+    {
+        for( uxLength = 0U; uxLength <= TEST_CHECKSUM_MAX_LENGTH; uxLength++ )
+        {
+            /* An odd initial sum as well, so the folding of the carries is
+             * exercised too. */
+            usSum = ( uint16_t ) ( ( uxLength * 0x0101U ) ^ uxOffset );
+            TEST_ASSERT_EQUAL_HEX16( usGenerateChecksumScalar( usSum, &( ucData[ uxOffset ] ), uxLength ),
+                                     usGenerateChecksum( usSum, &( ucData[ uxOffset ] ), uxLength ) );
+        }
+    }
+
+    /* An odd length over data with the top byte set: the last byte must be
+     * summed as the high byte of a word, padded with a zero. */
+    memset( ucData, 0xff, sizeof( ucData ) );
+
+    for( uxOffset = 0U; uxOffset < TEST_CHECKSUM_ALIGNMENTS; uxOffset++ )
+    {
+        for( uxLength = 1U; uxLength <= TEST_CHECKSUM_MAX_LENGTH; uxLength += 2U )
+        {
+            TEST_ASSERT_EQUAL_HEX16( usGenerateChecksumScalar( 0U, &( ucData[ uxOffset ] ), uxLength ),
+                                     usGenerateChecksum( 0U, &( ucData[ uxOffset ] ), uxLength ) );
+        }
+    }
+}
+
+/**
+ * @brief test_usCopyAndChecksum_SIMD_MatchesScalar
+ * usCopyAndChecksum() must copy the data and give the same checksum as
+ * the portable implementations.
+ */
+void test_usCopyAndChecksum_SIMD_MatchesScalar( void )
+{
+    static uint8_t ucData[ 2048 ];
+    static uint8_t ucCopy[ 2048 ];
+    static uint8_t ucScalarCopy[ 2048 ];
+    size_t uxLength;
+    size_t uxOffset;
+
+    prvFillChecksumData( ucData, sizeof( ucData ) );
+
+    for( uxOffset = 0U; uxOffset < 4U; uxOffset++ )
+    {
+        for( uxLength = 0U; uxLength < ( sizeof( ucData ) - 4U ); uxLength += 7U )
+        {
+            TEST_ASSERT_EQUAL_HEX16( usCopyAndChecksumScalar( 0x1234U, ucScalarCopy, &( ucData[ uxOffset ] ), uxLength ),
+                                     usCopyAndChecksum( 0x1234U, ucCopy, &( ucData[ uxOffset ] ), uxLength ) );
+            TEST_ASSERT_EQUAL_HEX16( usGenerateChecksumScalar( 0x1234U, &( ucData[ uxOffset ] ), uxLength ),
+                                     usCopyAndChecksum( 0x1234U, ucCopy, &( ucData[ uxOffset ] ), uxLength ) );
+            TEST_ASSERT_EQUAL_MEMORY( &( ucData[ uxOffset ] ), ucCopy, uxLength );
+            TEST_ASSERT_EQUAL_MEMORY( &( ucData[ uxOffset ] ), ucScalarCopy, uxLength );
+        }
+    }
+}
+
+/**
+ * @brief test_CopyChecksumKernels_MatchScalar
+ * Cross-check every copy kernel that runs on this CPU, and check that the
+ * expected copy kernel is selected.
+ */
+void test_CopyChecksumKernels_MatchScalar( void )
+{
+    ChecksumCopyKernel_t pxKernel = pxChecksumGetCopyKernel();
+
+    #if ( ipCHECKSUM_HAS_X86_64 == 1 )
+        prvCrossCheckCopyKernel( ulCopyChecksumSSE2 );
+
+        if( xChecksumHasAVX2() != pdFALSE )
+        {
+            prvCrossCheckCopyKernel( ulCopyChecksumAVX2 );
+            TEST_ASSERT_EQUAL_PTR( ulCopyChecksumAVX2, pxKernel );
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_PTR( ulCopyChecksumSSE2, pxKernel );
+        }
+    #elif ( ipCHECKSUM_HAS_NEON == 1 )
+        prvCrossCheckCopyKernel( ulCopyChecksumNEON );
+        TEST_ASSERT_EQUAL_PTR( ulCopyChecksumNEON, pxKernel );
+    #else
+        TEST_ASSERT_NULL( pxKernel );
+    #endif
+}
+
+/**
+ * @brief test_usCopyAndChecksum_MatchesMemcpy
+ * usCopyAndChecksum() must leave the same bytes as memcpy(), and return the
+ * same checksum as usGenerateChecksum() over the copy, for misaligned source
+ * and destination buffers and for odd lengths.
+ */
+void test_usCopyAndChecksum_MatchesMemcpy( void )
+{
+    static uint8_t ucData[ TEST_CHECKSUM_MAX_LENGTH + TEST_CHECKSUM_ALIGNMENTS ];
+    static uint8_t ucExpected[ TEST_CHECKSUM_MAX_LENGTH + TEST_CHECKSUM_ALIGNMENTS + 1U ];
+    static uint8_t ucCopy[ TEST_CHECKSUM_MAX_LENGTH + TEST_CHECKSUM_ALIGNMENTS + 1U ];
+    size_t uxSourceOffset;
+    size_t uxDestinationOffset;
+    size_t uxLength;
+    uint16_t usSum;
+    uint16_t usResult;
+
+    prvFillChecksumData( ucData, sizeof( ucData ) );
+
+    for( uxSourceOffset = 0U; uxSourceOffset < TEST_CHECKSUM_ALIGNMENTS; uxSourceOffset += 3U )
+    {
+        for( uxDestinationOffset = 0U; uxDestinationOffset < TEST_CHECKSUM_ALIGNMENTS; uxDestinationOffset += 5U )
+        {
+            for( uxLength = 0U; uxLength <= TEST_CHECKSUM_MAX_LENGTH; uxLength++ )
+            {
+                usSum = ( uint16_t ) ( ( uxLength * 0x0101U ) ^ uxSourceOffset );
+
+                memset( ucExpected, 0xa5, sizeof( ucExpected ) );
+                memset( ucCopy, 0xa5, sizeof( ucCopy ) );
+                ( void ) memcpy( &( ucExpected[ uxDestinationOffset ] ), &( ucData[ uxSourceOffset ] ), uxLength );
+
+                usResult = usCopyAndChecksum( usSum, &( ucCopy[ uxDestinationOffset ] ), &( ucData[ uxSourceOffset ] ), uxLength );
+
+                TEST_ASSERT_EQUAL_HEX16( usGenerateChecksum( usSum, &( ucExpected[ uxDestinationOffset ] ), uxLength ), usResult );
+                /* The bytes around the copy are not touched either. */
+                TEST_ASSERT_EQUAL_MEMORY( ucExpected, ucCopy, sizeof( ucCopy ) );
+            }
+        }
+    }
+}
+
+/**
+ * @brief test_pucNetworkBufferPush_Pull
+ * Headers are prepended in the headroom and stripped again, and the pointer to
+ * the descriptor in front of the frame follows the frame.
+ */
+void test_pucNetworkBufferPush_Pull( void )
+{
+    uint64_t ullStorage[ 32 ];
+    uint8_t * pucStorage = ( uint8_t * ) ullStorage;
+    NetworkBufferDescriptor_t xNetworkBuffer;
+    uint8_t * pucReturn;
+
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+    xNetworkBuffer.pucEthernetBuffer = &( pucStorage[ ipconfigBUFFER_HEADROOM + ipBUFFER_PADDING ] );
+    xNetworkBuffer.uxHeadroom = ipconfigBUFFER_HEADROOM;
+    xNetworkBuffer.uxBufferSize = 200U;
+    xNetworkBuffer.xDataLength = 60U;
+
+    pucReturn = pucNetworkBufferPush( &xNetworkBuffer, 8U );
+
+    TEST_ASSERT_EQUAL_PTR( &( pucStorage[ 8 + ipBUFFER_PADDING ] ), pucReturn );
+    TEST_ASSERT_EQUAL_PTR( pucReturn, xNetworkBuffer.pucEthernetBuffer );
+    TEST_ASSERT_EQUAL( 8U, uxNetworkBufferHeadroom( &xNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( 68U, xNetworkBuffer.xDataLength );
+    TEST_ASSERT_EQUAL( 208U, xNetworkBuffer.uxBufferSize );
+    TEST_ASSERT_EQUAL_PTR( &xNetworkBuffer, pxPacketBuffer_to_NetworkBuffer( pucReturn ) );
+
+    /* Not enough headroom left. */
+    pucReturn = pucNetworkBufferPush( &xNetworkBuffer, 16U );
+
+    TEST_ASSERT_EQUAL_PTR( NULL, pucReturn );
+    TEST_ASSERT_EQUAL( 68U, xNetworkBuffer.xDataLength );
+
+    pucReturn = pucNetworkBufferPull( &xNetworkBuffer, 8U );
+
+    TEST_ASSERT_EQUAL_PTR( &( pucStorage[ ipconfigBUFFER_HEADROOM + ipBUFFER_PADDING ] ), pucReturn );
+    TEST_ASSERT_EQUAL( ipconfigBUFFER_HEADROOM, uxNetworkBufferHeadroom( &xNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( 60U, xNetworkBuffer.xDataLength );
+    TEST_ASSERT_EQUAL( 200U, xNetworkBuffer.uxBufferSize );
+    TEST_ASSERT_EQUAL_PTR( &xNetworkBuffer, pxPacketBuffer_to_NetworkBuffer( pucReturn ) );
+
+    /* The frame is shorter than what should be stripped. */
+    pucReturn = pucNetworkBufferPull( &xNetworkBuffer, 61U );
+
+    TEST_ASSERT_EQUAL_PTR( NULL, pucReturn );
+    TEST_ASSERT_EQUAL( 60U, xNetworkBuffer.xDataLength );
+}
+
+/**
+ * @brief test_pucNetworkBufferPush_Unaligned
+ * A push or a pull that is not a multiple of the size of a pointer is refused,
+ * the frame is not moved.
+ */
+void test_pucNetworkBufferPush_Unaligned( void )
+{
+    uint64_t ullStorage[ 32 ];
+    uint8_t * pucStorage = ( uint8_t * ) ullStorage;
+    NetworkBufferDescriptor_t xNetworkBuffer;
+    uint8_t * pucReturn;
+
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+    xNetworkBuffer.pucEthernetBuffer = &( pucStorage[ ipconfigBUFFER_HEADROOM + ipBUFFER_PADDING ] );
+    xNetworkBuffer.uxHeadroom = ipconfigBUFFER_HEADROOM;
+    xNetworkBuffer.uxBufferSize = 200U;
+    xNetworkBuffer.xDataLength = 60U;
+
+    pucReturn = pucNetworkBufferPush( &xNetworkBuffer, sizeof( void * ) - 1U );
+
+    TEST_ASSERT_EQUAL_PTR( NULL, pucReturn );
+    TEST_ASSERT_EQUAL_PTR( &( pucStorage[ ipconfigBUFFER_HEADROOM + ipBUFFER_PADDING ] ), xNetworkBuffer.pucEthernetBuffer );
+    TEST_ASSERT_EQUAL( ipconfigBUFFER_HEADROOM, xNetworkBuffer.uxHeadroom );
+    TEST_ASSERT_EQUAL( 60U, xNetworkBuffer.xDataLength );
+
+    pucReturn = pucNetworkBufferPull( &xNetworkBuffer, sizeof( void * ) + 1U );
+
+    TEST_ASSERT_EQUAL_PTR( NULL, pucReturn );
+    TEST_ASSERT_EQUAL_PTR( &( pucStorage[ ipconfigBUFFER_HEADROOM + ipBUFFER_PADDING ] ), xNetworkBuffer.pucEthernetBuffer );
+    TEST_ASSERT_EQUAL( 60U, xNetworkBuffer.xDataLength );
+}
+
+/**
+ * @brief test_pucNetworkBufferPut
+ * Data is appended in the tailroom.
+ */
+void test_pucNetworkBufferPut( void )
+{
+    uint8_t ucStorage[ 128 ];
+    NetworkBufferDescriptor_t xNetworkBuffer;
+    uint8_t * pucReturn;
+
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+    xNetworkBuffer.pucEthernetBuffer = ucStorage;
+    xNetworkBuffer.uxBufferSize = 100U;
+    xNetworkBuffer.xDataLength = 60U;
+
+    TEST_ASSERT_EQUAL( 40U, uxNetworkBufferTailroom( &xNetworkBuffer ) );
+
+    pucReturn = pucNetworkBufferPut( &xNetworkBuffer, 40U );
+
+    TEST_ASSERT_EQUAL_PTR( &( ucStorage[ 60 ] ), pucReturn );
+    TEST_ASSERT_EQUAL( 100U, xNetworkBuffer.xDataLength );
+    TEST_ASSERT_EQUAL( 0U, uxNetworkBufferTailroom( &xNetworkBuffer ) );
+
+    pucReturn = pucNetworkBufferPut( &xNetworkBuffer, 1U );
+
+    TEST_ASSERT_EQUAL_PTR( NULL, pucReturn );
+    TEST_ASSERT_EQUAL( 100U, xNetworkBuffer.xDataLength );
+
+    /* A frame that is longer than the recorded size has no tailroom. */
+    xNetworkBuffer.xDataLength = 120U;
+
+    TEST_ASSERT_EQUAL( 0U, uxNetworkBufferTailroom( &xNetworkBuffer ) );
+}
+
+/**
+ * @brief test_uxNetworkBufferFragmentBytes
+ * The lengths of all fragments are added.
+ */
+void test_uxNetworkBufferFragmentBytes( void )
+{
+    NetworkBufferDescriptor_t xNetworkBuffer;
+
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+
+    TEST_ASSERT_EQUAL( 0U, uxNetworkBufferFragmentBytes( &xNetworkBuffer ) );
+
+    xNetworkBuffer.xFragments[ 0 ].uxLength = 100U;
+    xNetworkBuffer.xFragments[ 1 ].uxLength = 23U;
+    xNetworkBuffer.uxFragmentCount = 1U;
+
+    TEST_ASSERT_EQUAL( 100U, uxNetworkBufferFragmentBytes( &xNetworkBuffer ) );
+
+    xNetworkBuffer.uxFragmentCount = 2U;
+
+    TEST_ASSERT_EQUAL( 123U, uxNetworkBufferFragmentBytes( &xNetworkBuffer ) );
+}
+
+/**
+ * @brief test_xNetworkBufferLinearise
+ * The fragments are copied behind the headers, and the stream is released.
+ */
+void test_xNetworkBufferLinearise( void )
+{
+    uint8_t ucStorage[ 128 ];
+    uint8_t ucStream[ 16 ];
+    StreamBuffer_t xStream;
+    NetworkBufferDescriptor_t xNetworkBuffer;
+    BaseType_t xReturn;
+    size_t uxIndex;
+
+    for( uxIndex = 0U; uxIndex < sizeof( ucStream ); uxIndex++ )
+    {
+        ucStream[ uxIndex ] = ( uint8_t ) uxIndex;
+    }
+
+    memset( ucStorage, 0xAA, sizeof( ucStorage ) );
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+    xNetworkBuffer.pucEthernetBuffer = ucStorage;
+    xNetworkBuffer.uxBufferSize = sizeof( ucStorage );
+    xNetworkBuffer.xDataLength = 54U;
+
+    /* The data wraps around the end of the stream. */
+    xNetworkBuffer.xFragments[ 0 ].pucData = &( ucStream[ 12 ] );
+    xNetworkBuffer.xFragments[ 0 ].uxLength = 4U;
+    xNetworkBuffer.xFragments[ 1 ].pucData = ucStream;
+    xNetworkBuffer.xFragments[ 1 ].uxLength = 6U;
+    xNetworkBuffer.uxFragmentCount = 2U;
+    xNetworkBuffer.pxFragmentStream = &xStream;
+    uxStreamBufferDereferences = 0U;
+
+    xReturn = xNetworkBufferLinearise( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL( 64U, xNetworkBuffer.xDataLength );
+    TEST_ASSERT_EQUAL( 0U, xNetworkBuffer.uxFragmentCount );
+    TEST_ASSERT_EQUAL_PTR( NULL, xNetworkBuffer.pxFragmentStream );
+    TEST_ASSERT_EQUAL( 1U, uxStreamBufferDereferences );
+    TEST_ASSERT_EQUAL_MEMORY( &( ucStream[ 12 ] ), &( ucStorage[ 54 ] ), 4U );
+    TEST_ASSERT_EQUAL_MEMORY( ucStream, &( ucStorage[ 58 ] ), 6U );
+    TEST_ASSERT_EQUAL( 0xAA, ucStorage[ 64 ] );
+
+    /* A contiguous frame is left alone. */
+    xReturn = xNetworkBufferLinearise( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL( 64U, xNetworkBuffer.xDataLength );
+    TEST_ASSERT_EQUAL( 1U, uxStreamBufferDereferences );
+}
+
+/**
+ * @brief test_xNetworkBufferLinearise_ResizeFails
+ * When the frame does not fit and the buffer can not grow, nothing changes.
+ */
+void test_xNetworkBufferLinearise_ResizeFails( void )
+{
+    uint8_t ucStorage[ 60 ];
+    uint8_t ucStream[ 16 ];
+    StreamBuffer_t xStream;
+    NetworkBufferDescriptor_t xNetworkBuffer;
+    BaseType_t xReturn;
+
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+    xNetworkBuffer.pucEthernetBuffer = ucStorage;
+    xNetworkBuffer.uxBufferSize = sizeof( ucStorage );
+    xNetworkBuffer.xDataLength = 54U;
+    xNetworkBuffer.xFragments[ 0 ].pucData = ucStream;
+    xNetworkBuffer.xFragments[ 0 ].uxLength = sizeof( ucStream );
+    xNetworkBuffer.uxFragmentCount = 1U;
+    xNetworkBuffer.pxFragmentStream = &xStream;
+    uxStreamBufferDereferences = 0U;
+
+    pxResizeNetworkBufferWithDescriptor_ExpectAndReturn( &xNetworkBuffer, 54U + sizeof( ucStream ), NULL );
+
+    xReturn = xNetworkBufferLinearise( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( pdFAIL, xReturn );
+    TEST_ASSERT_EQUAL( 54U, xNetworkBuffer.xDataLength );
+    TEST_ASSERT_EQUAL( 1U, xNetworkBuffer.uxFragmentCount );
+    TEST_ASSERT_EQUAL_PTR( &xStream, xNetworkBuffer.pxFragmentStream );
+    TEST_ASSERT_EQUAL( 0U, uxStreamBufferDereferences );
+}
@@ -51,6 +51,7 @@ set(real_source_files "")
 # list the files you would like to test here
 list(APPEND real_source_files
             ${CMAKE_BINARY_DIR}/Annexed_TCP_Sources/FreeRTOS_IP_Utils.c
+            ${CMAKE_BINARY_DIR}/Annexed_TCP_Sources/FreeRTOS_IP_Checksum.c
             ${MODULE_ROOT_DIR}/test/unit-test/${project_name}/${project_name}_stubs.c
 	)
 
@@ -115,3 +116,15 @@ create_test(${utest_name}
             "${utest_dep_list}"
             "${test_include_directories}"
         )
+
+if( UNITTEST_BENCHMARKS )
+    set(benchmark_name "${project_name}_benchmark")
+    set(benchmark_source "${project_name}/${project_name}_benchmark.c")
+
+    create_benchmark(${benchmark_name}
+                     ${benchmark_source}
+                     "${utest_link_list}"
+                     "${utest_dep_list}"
+                     "${test_include_directories}"
+            )
+endif()
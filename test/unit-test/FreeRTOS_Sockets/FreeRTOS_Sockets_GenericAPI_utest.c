@@ -2108,6 +2108,125 @@ void test_FreeRTOS_setsockopt_SetFullSize_Reset_HappyPath( void )
     TEST_ASSERT_EQUAL( 1, xSocket.u.xTCP.usTimeout );
 }
 
+/**
+ * @brief No-delay option with a UDP socket.
+ */
+void test_FreeRTOS_setsockopt_NoDelay_InvalidProtocol( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    BaseType_t xOptionValue = pdTRUE;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xSocket.ucProtocol = FREERTOS_IPPROTO_UDP;
+
+    xReturn = FreeRTOS_setsockopt( &xSocket, 0, FREERTOS_SO_TCP_NODELAY, &xOptionValue, sizeof( xOptionValue ) );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+}
+
+/**
+ * @brief Setting the no-delay option switches off the Nagle algorithm.
+ */
+void test_FreeRTOS_setsockopt_NoDelay_Set( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    BaseType_t xOptionValue = pdTRUE;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xSocket.ucProtocol = FREERTOS_IPPROTO_TCP;
+    xSocket.u.xTCP.xTCPWindow.u.bits.bHasInit = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.xTCPWindow.u.bits.bNagle = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.eTCPState = eESTABLISHED;
+    xSocket.u.xTCP.txStream = ( StreamBuffer_t * ) 0xABCD;
+
+    uxStreamBufferGetSize_ExpectAndReturn( xSocket.u.xTCP.txStream, 0x12 );
+    xSendEventToIPTask_ExpectAndReturn( eTCPTimerEvent, pdTRUE );
+
+    xReturn = FreeRTOS_setsockopt( &xSocket, 0, FREERTOS_SO_TCP_NODELAY, &xOptionValue, sizeof( xOptionValue ) );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSocket.u.xTCP.bits.bNoDelay );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xSocket.u.xTCP.xTCPWindow.u.bits.bNagle );
+    TEST_ASSERT_EQUAL( 1, xSocket.u.xTCP.usTimeout );
+}
+
+/**
+ * @brief Clearing the no-delay option of a connected socket switches the
+ *        Nagle algorithm back on.
+ */
+void test_FreeRTOS_setsockopt_NoDelay_Reset( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    BaseType_t xOptionValue = pdFALSE;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xSocket.ucProtocol = FREERTOS_IPPROTO_TCP;
+    xSocket.u.xTCP.bits.bNoDelay = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.xTCPWindow.u.bits.bHasInit = pdTRUE_UNSIGNED;
+
+    xReturn = FreeRTOS_setsockopt( &xSocket, 0, FREERTOS_SO_TCP_NODELAY, &xOptionValue, sizeof( xOptionValue ) );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xSocket.u.xTCP.bits.bNoDelay );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSocket.u.xTCP.xTCPWindow.u.bits.bNagle );
+}
+
+/**
+ * @brief Setting the cork option only allows full-size segments.
+ */
+void test_FreeRTOS_setsockopt_Cork_Set( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    BaseType_t xOptionValue = pdTRUE;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xSocket.ucProtocol = FREERTOS_IPPROTO_TCP;
+    xSocket.u.xTCP.eTCPState = eESTABLISHED;
+
+    xReturn = FreeRTOS_setsockopt( &xSocket, 0, FREERTOS_SO_TCP_CORK, &xOptionValue, sizeof( xOptionValue ) );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSocket.u.xTCP.bits.bCork );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSocket.u.xTCP.xTCPWindow.u.bits.bSendFullSize );
+    TEST_ASSERT_EQUAL( 0, xSocket.u.xTCP.usTimeout );
+}
+
+/**
+ * @brief Clearing the cork option sends the remaining data.
+ */
+void test_FreeRTOS_setsockopt_Cork_Reset( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    BaseType_t xOptionValue = pdFALSE;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xSocket.ucProtocol = FREERTOS_IPPROTO_TCP;
+    xSocket.u.xTCP.bits.bCork = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.xTCPWindow.u.bits.bSendFullSize = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.eTCPState = eESTABLISHED;
+    xSocket.u.xTCP.txStream = ( StreamBuffer_t * ) 0xABCD;
+
+    uxStreamBufferGetSize_ExpectAndReturn( xSocket.u.xTCP.txStream, 0x12 );
+    xSendEventToIPTask_ExpectAndReturn( eTCPTimerEvent, pdTRUE );
+
+    xReturn = FreeRTOS_setsockopt( &xSocket, 0, FREERTOS_SO_TCP_CORK, &xOptionValue, sizeof( xOptionValue ) );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xSocket.u.xTCP.bits.bCork );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xSocket.u.xTCP.xTCPWindow.u.bits.bSendFullSize );
+    TEST_ASSERT_EQUAL( 1, xSocket.u.xTCP.usTimeout );
+}
+
 /**
  * @brief Stop receive with a UDP socket.
  */
@@ -48,6 +48,7 @@
 #include "mock_FreeRTOS_IP_Private.h"
 #include "mock_NetworkBufferManagement.h"
 #include "mock_FreeRTOS_Stream_Buffer.h"
+#include "mock_FreeRTOS_TCP_WIN.h"
 
 #include "FreeRTOS_Sockets.h"
 
@@ -1474,6 +1475,8 @@ void test_FreeRTOS_listen_Success_WithReuseSocket( void )
 
     FreeRTOS_min_int32_ExpectAndReturn( ( int32_t ) 0xffff, ( int32_t ) xBacklog, xBacklog );
 
+    vTCPWindowDestroy_Expect( &xSocket.u.xTCP.xTCPWindow );
+
     vTCPStateChange_Expect( &xSocket, eTCP_LISTEN );
 
     xReturn = FreeRTOS_listen( &xSocket, xBacklog );
@@ -1510,6 +1513,8 @@ void test_FreeRTOS_listen_Success_WithReuseSocket_StreamsNonNULL( void )
     vStreamBufferClear_Expect( xSocket.u.xTCP.rxStream );
     vStreamBufferClear_Expect( xSocket.u.xTCP.txStream );
 
+    vTCPWindowDestroy_Expect( &xSocket.u.xTCP.xTCPWindow );
+
     vTCPStateChange_Expect( &xSocket, eTCP_LISTEN );
 
     xReturn = FreeRTOS_listen( &xSocket, xBacklog );
@@ -96,6 +96,9 @@ BaseType_t prvValidSocket( const FreeRTOS_Socket_t * pxSocket,
 
 BaseType_t bMayConnect( FreeRTOS_Socket_t const * pxSocket );
 
+size_t prvSendTo_PayloadOffset( uint8_t ucFamily,
+                                size_t * puxMaxPayloadLength );
+
 extern List_t xBoundUDPSocketsList;
 extern List_t xBoundTCPSocketsList;
 
@@ -1850,6 +1853,30 @@ void test_pxUDPSocketLookup_Found( void )
     TEST_ASSERT_EQUAL( &xLocalSocket, pxReturn );
 }
 
+/**
+ * @brief Without ipconfigUSE_UDP_PORT_HASH, the whole list of bound UDP
+ *        sockets is searched for the port number.
+ */
+void test_pxUDPSocketLookup_WithoutPortHash( void )
+{
+    FreeRTOS_Socket_t * pxReturn;
+    UBaseType_t uxLocalPort = 5000U;
+    ListItem_t xFirstItem = { 0 }, xSecondItem = { 0 };
+    FreeRTOS_Socket_t xLocalSocket;
+
+    xIPIsNetworkTaskReady_ExpectAndReturn( pdTRUE );
+    listGET_HEAD_ENTRY_ExpectAndReturn( &xBoundUDPSocketsList, &xFirstItem );
+    listGET_LIST_ITEM_VALUE_ExpectAndReturn( &xFirstItem, 4000U );
+    listGET_NEXT_ExpectAndReturn( &xFirstItem, &xSecondItem );
+    listGET_LIST_ITEM_VALUE_ExpectAndReturn( &xSecondItem, uxLocalPort );
+
+    listGET_LIST_ITEM_OWNER_ExpectAndReturn( &xSecondItem, &xLocalSocket );
+
+    pxReturn = pxUDPSocketLookup( uxLocalPort );
+
+    TEST_ASSERT_EQUAL( &xLocalSocket, pxReturn );
+}
+
 /**
  * @brief Convert ascii values to hexadecimal values.
  */
@@ -3201,3 +3228,24 @@ void test_FreeRTOS_netstat( void )
     xSendEventStructToIPTask_IgnoreArg_pxEvent();
     FreeRTOS_netstat();
 }
+
+/**
+ * @brief The payload offset and the maximum payload length of each address family.
+ */
+void test_prvSendTo_PayloadOffset( void )
+{
+    size_t uxReturn;
+    size_t uxMaxPayloadLength = 0U;
+
+    uxReturn = prvSendTo_PayloadOffset( FREERTOS_AF_INET4, &uxMaxPayloadLength );
+    TEST_ASSERT_EQUAL( ipUDP_PAYLOAD_OFFSET_IPv4, uxReturn );
+    TEST_ASSERT_EQUAL( ipconfigNETWORK_MTU - ( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER ), uxMaxPayloadLength );
+
+    uxReturn = prvSendTo_PayloadOffset( FREERTOS_AF_INET6, &uxMaxPayloadLength );
+    TEST_ASSERT_EQUAL( ipUDP_PAYLOAD_OFFSET_IPv6, uxReturn );
+    TEST_ASSERT_EQUAL( ipconfigNETWORK_MTU - ( ipSIZE_OF_IPv6_HEADER + ipSIZE_OF_UDP_HEADER ), uxMaxPayloadLength );
+
+    /* An unknown family. */
+    uxReturn = prvSendTo_PayloadOffset( FREERTOS_AF_INET6 + 1, &uxMaxPayloadLength );
+    TEST_ASSERT_EQUAL( 0, uxReturn );
+}
@@ -220,6 +220,21 @@
 /* USE_WIN: Let TCP use windowing mechanism. */
 #define ipconfigUSE_TCP_WIN                            ( 1 )
 
+/* Keep the TCP sockets in hash tables. A single bucket makes all sockets
+ * collide, so that the chains can be tested. */
+#define ipconfigUSE_TCP_SOCKET_HASH                    ( 1 )
+#define ipconfigTCP_SOCKET_HASH_SIZE                   ( 1 )
+
+/* Keep the bound UDP sockets in a hash table, with a single bucket as well. */
+#define ipconfigUSE_UDP_PORT_HASH                      ( 1 )
+#define ipconfigUDP_PORT_HASH_SIZE                     ( 1 )
+
+/* Let several listening sockets share a TCP port. */
+#define ipconfigUSE_TCP_REUSE_PORT                     ( 1 )
+
+/* Let TCP sockets choose their own delayed-ACK policy. */
+#define ipconfigUSE_TCP_ACK_POLICY                     ( 1 )
+
 /* The MTU is the maximum number of bytes the payload of a network frame can
  * contain.  For normal Ethernet V2 frames the maximum MTU is 1500.  Setting a
  * lower value can save RAM, depending on the buffer management scheme used.  If
@@ -243,6 +258,10 @@
  * (and associated) API function is available. */
 #define ipconfigSUPPORT_SELECT_FUNCTION                1
 
+/* If ipconfigSUPPORT_EVENT_POLL is set to 1 then the FreeRTOS_EventPoll...()
+ * API functions are available. */
+#define ipconfigSUPPORT_EVENT_POLL                     1
+
 /* If ipconfigFILTER_OUT_NON_ETHERNET_II_FRAMES is set to 1 then Ethernet frames
  * that are not in Ethernet II format will be dropped.  This option is included for
  * potential future IP stack developments. */
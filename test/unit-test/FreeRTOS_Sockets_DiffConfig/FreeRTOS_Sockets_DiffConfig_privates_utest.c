@@ -51,6 +51,7 @@
 #include "mock_FreeRTOS_Stream_Buffer.h"
 #include "mock_FreeRTOS_TCP_WIN.h"
 #include "mock_FreeRTOS_Routing.h"
+#include "mock_FreeRTOS_IPv6_Sockets.h"
 
 #include "FreeRTOS_Sockets.h"
 
@@ -60,6 +61,159 @@
 
 BaseType_t xTCPWindowLoggingLevel = 0;
 
+/* The list in which vListInsertEnd() has inserted an item. */
+static List_t * pxInsertedList;
+
+/* The event that was sent to the IP-task. */
+static IPStackEvent_t xSentEvent;
+
+/* The number of connection attempts used by the FREERTOS_SO_REUSEPORT tests. */
+#define TEST_REUSE_PORT_FLOWS    ( 256U )
+
+FreeRTOS_Socket_t * prvTCPReusePortSelect( const List_t * pxList,
+                                           UBaseType_t uxLocalPort,
+                                           const IPv46_Address_t * pxRemoteIP,
+                                           UBaseType_t uxRemotePort );
+
+/* ============================== Test Helpers ============================== */
+
+/**
+ * @brief Remember the list in which an item is inserted.
+ */
+static void vListInsertEnd_Capture( List_t * const pxList,
+                                    ListItem_t * const pxNewListItem,
+                                    int cmock_num_calls )
+{
+    ( void ) pxNewListItem;
+    ( void ) cmock_num_calls;
+
+    pxInsertedList = pxList;
+}
+
+/**
+ * @brief Remember the event that is sent to the IP-task.
+ */
+static BaseType_t xSendEventStructToIPTask_Capture( const IPStackEvent_t * pxEvent,
+                                                    TickType_t uxTimeout,
+                                                    int cmock_num_calls )
+{
+    ( void ) uxTimeout;
+    ( void ) cmock_num_calls;
+
+    xSentEvent = *pxEvent;
+
+    return pdPASS;
+}
+
+/**
+ * @brief Let the IP-task handle an 'eEventPollWaitEvent' at once.
+ */
+static BaseType_t xSendEventStructToIPTask_EventPoll( const IPStackEvent_t * pxEvent,
+                                                      TickType_t uxTimeout,
+                                                      int cmock_num_calls )
+{
+    ( void ) uxTimeout;
+    ( void ) cmock_num_calls;
+
+    xSentEvent = *pxEvent;
+    vSocketEventPollCollect( ( EventPollMessage_t * ) pxEvent->pvData );
+
+    return pdPASS;
+}
+
+/**
+ * @brief Prepare a bound TCP socket for the hash table tests.
+ */
+static void prvInitHashSocket( FreeRTOS_Socket_t * pxSocket,
+                               uint16_t usLocalPort,
+                               uint32_t ulRemoteIP,
+                               uint16_t usRemotePort )
+{
+    memset( pxSocket, 0, sizeof( *pxSocket ) );
+
+    pxSocket->ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+    pxSocket->usLocalPort = usLocalPort;
+    pxSocket->u.xTCP.xRemoteIP.ulIP_IPv4 = ulRemoteIP;
+    pxSocket->u.xTCP.usRemotePort = usRemotePort;
+    pxSocket->u.xTCP.eTCPState = eESTABLISHED;
+}
+
+/**
+ * @brief The list macros walk a list that is linked by prvLinkSockets().
+ */
+static ListItem_t * listGET_HEAD_ENTRY_Linked( const List_t * pxList,
+                                               int cmock_num_calls )
+{
+    ( void ) cmock_num_calls;
+
+    return pxList->xListEnd.pxNext;
+}
+
+static ListItem_t * listGET_END_MARKER_Linked( List_t * pxList,
+                                               int cmock_num_calls )
+{
+    ( void ) cmock_num_calls;
+
+    return ( ListItem_t * ) &( pxList->xListEnd );
+}
+
+static ListItem_t * listGET_NEXT_Linked( const ListItem_t * pxListItem,
+                                         int cmock_num_calls )
+{
+    ( void ) cmock_num_calls;
+
+    return pxListItem->pxNext;
+}
+
+static void * listGET_LIST_ITEM_OWNER_Linked( const ListItem_t * pxListItem,
+                                              int cmock_num_calls )
+{
+    ( void ) cmock_num_calls;
+
+    return pxListItem->pvOwner;
+}
+
+/**
+ * @brief Link the bound-socket list items of some sockets into a list, in
+ *        the given order.
+ */
+static void prvLinkSockets( List_t * pxList,
+                            FreeRTOS_Socket_t * const pxSockets[],
+                            size_t uxCount )
+{
+    ListItem_t * pxPrevious = ( ListItem_t * ) &( pxList->xListEnd );
+    size_t uxIndex;
+
+    for( uxIndex = 0U; uxIndex < uxCount; uxIndex++ )
+    {
+        pxSockets[ uxIndex ]->xBoundSocketListItem.pvOwner = pxSockets[ uxIndex ];
+        pxPrevious->pxNext = &( pxSockets[ uxIndex ]->xBoundSocketListItem );
+        pxPrevious = pxPrevious->pxNext;
+    }
+
+    pxPrevious->pxNext = ( ListItem_t * ) &( pxList->xListEnd );
+}
+
+/**
+ * @brief Let prvTCPReusePortSelect() choose a socket for each of the
+ *        connection attempts of the FREERTOS_SO_REUSEPORT tests.
+ */
+static void prvSelectListeners( const List_t * pxList,
+                                FreeRTOS_Socket_t * pxChoices[] )
+{
+    IPv46_Address_t xRemoteIP;
+    UBaseType_t uxFlow;
+
+    memset( &xRemoteIP, 0, sizeof( xRemoteIP ) );
+    xRemoteIP.xIs_IPv6 = pdFALSE;
+
+    for( uxFlow = 0U; uxFlow < TEST_REUSE_PORT_FLOWS; uxFlow++ )
+    {
+        xRemoteIP.xIPAddress.ulIP_IPv4 = 0xC0A80000U + ( uint32_t ) ( uxFlow / 4U );
+        pxChoices[ uxFlow ] = prvTCPReusePortSelect( pxList, 80U, &xRemoteIP, 1024U + ( uxFlow % 4U ) );
+    }
+}
+
 /* =============================== Test Cases =============================== */
 
 /**
@@ -90,6 +244,7 @@ void test_vSocketBind_TCP1( void )
     struct freertos_sockaddr xBindAddress;
     BaseType_t xInternal = pdFALSE;
     NetworkEndPoint_t xEndPoint = { 0 };
+    List_t xBoundList;
 
     memset( &xBindAddress, 0xFC, sizeof( xBindAddress ) );
     memset( &xSocket, 0, sizeof( xSocket ) );
@@ -105,7 +260,826 @@ void test_vSocketBind_TCP1( void )
     vListInsertEnd_Expect( NULL, &( xSocket.xBoundSocketListItem ) );
     vListInsertEnd_IgnoreArg_pxList();
 
+    /* The bound socket is also stored in the hash table. */
+    xIsCallingFromIPTask_ExpectAndReturn( pdTRUE );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), &xBoundList );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), NULL );
+    vListInsertEnd_Expect( NULL, &( xSocket.u.xTCP.xHashListItem ) );
+    vListInsertEnd_IgnoreArg_pxList();
+
     xReturn = vSocketBind( &xSocket, &xBindAddress, sizeof( xBindAddress ), xInternal );
 
     TEST_ASSERT_EQUAL( 0, xReturn );
 }
+
+/**
+ * @brief Creating an event-poll set fails when there is no memory.
+ */
+void test_FreeRTOS_EventPollCreate_NoMemory( void )
+{
+    EventPoll_t xEventPoll;
+
+    pvPortMalloc_ExpectAnyArgsAndReturn( NULL );
+
+    xEventPoll = FreeRTOS_EventPollCreate();
+
+    TEST_ASSERT_EQUAL( NULL, xEventPoll );
+}
+
+/**
+ * @brief Creating an event-poll set fails when the event group cannot be created.
+ */
+void test_FreeRTOS_EventPollCreate_NoEventGroup( void )
+{
+    EventPoll_t xEventPoll;
+    EventPollSet_t xSet;
+
+    pvPortMalloc_ExpectAnyArgsAndReturn( &xSet );
+    xEventGroupCreate_ExpectAndReturn( NULL );
+    vPortFree_Expect( &xSet );
+
+    xEventPoll = FreeRTOS_EventPollCreate();
+
+    TEST_ASSERT_EQUAL( NULL, xEventPoll );
+}
+
+/**
+ * @brief A socket can only be removed from the set that it belongs to.
+ */
+void test_FreeRTOS_EventPollRemove_NotAMember( void )
+{
+    BaseType_t xReturn;
+    EventPollSet_t xSet;
+    FreeRTOS_Socket_t xSocket;
+
+    memset( &xSet, 0, sizeof( xSet ) );
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xReturn = FreeRTOS_EventPollRemove( &xSet, NULL );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+
+    xReturn = FreeRTOS_EventPollRemove( &xSet, &xSocket );
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_ENOENT, xReturn );
+}
+
+/**
+ * @brief An edge-triggered socket is reported once for every event signalled
+ *        by the IP-task.
+ */
+void test_FreeRTOS_EventPollWait_EdgeTriggered( void )
+{
+    BaseType_t xReturn;
+    EventPollSet_t xSet;
+    FreeRTOS_Socket_t xSocket;
+    EventPollResult_t xResults[ 2 ];
+
+    memset( &xSet, 0, sizeof( xSet ) );
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xSocket.pxEventPoll = &xSet;
+    xSocket.xSelectBits = ( EventBits_t ) eSELECT_READ;
+    xSocket.ucPollMode = ( uint8_t ) eEventPollEdge;
+    xSet.pxMembers = &xSocket;
+
+    /* A write event is not of interest. */
+    vSocketEventPollSignal( &xSocket, ( EventBits_t ) eSELECT_WRITE );
+
+    TEST_ASSERT_EQUAL( 0, xSet.uxReadyCount );
+
+    /* Two read events put the socket only once in the ready list. */
+    xEventGroupSetBits_ExpectAnyArgsAndReturn( 0 );
+    xEventGroupSetBits_ExpectAnyArgsAndReturn( 0 );
+
+    vSocketEventPollSignal( &xSocket, ( EventBits_t ) eSELECT_READ );
+    vSocketEventPollSignal( &xSocket, ( EventBits_t ) eSELECT_READ );
+
+    TEST_ASSERT_EQUAL( 1, xSet.uxReadyCount );
+    TEST_ASSERT_EQUAL_PTR( &xSocket, xSet.pxReadyHead );
+
+    /* Called from the IP-task, the set is collected directly. */
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    xIsCallingFromIPTask_ExpectAndReturn( pdTRUE );
+
+    xReturn = FreeRTOS_EventPollWait( &xSet, xResults, 2, 0 );
+
+    TEST_ASSERT_EQUAL( 1, xReturn );
+    TEST_ASSERT_EQUAL_PTR( &xSocket, xResults[ 0 ].xSocket );
+    TEST_ASSERT_EQUAL( eSELECT_READ, xResults[ 0 ].xEvents );
+    TEST_ASSERT_EQUAL( 0, xSet.uxReadyCount );
+    TEST_ASSERT_EQUAL( NULL, xSet.pxReadyHead );
+    TEST_ASSERT_EQUAL( NULL, xSet.pxReadyTail );
+}
+
+/**
+ * @brief A socket that is added to a set is checked by the IP-task, which
+ *        collects the ready sockets for a task in FreeRTOS_EventPollWait().
+ */
+void test_FreeRTOS_EventPollWait_CollectedByIPTask( void )
+{
+    BaseType_t xReturn;
+    EventPollSet_t xSet;
+    FreeRTOS_Socket_t xSocket;
+    EventPollResult_t xResults[ 2 ];
+
+    memset( &xSet, 0, sizeof( xSet ) );
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_UDP;
+
+    /* The state of the socket is not read by the calling task. */
+    xEventGroupSetBits_ExpectAnyArgsAndReturn( 0 );
+
+    xReturn = FreeRTOS_EventPollAdd( &xSet, &xSocket, ( EventBits_t ) eSELECT_READ, eEventPollEdge );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( 1, xSet.uxReadyCount );
+    TEST_ASSERT_EQUAL( 1U, xSocket.ucPollCheck );
+
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    xEventGroupClearBits_ExpectAnyArgsAndReturn( 0 );
+    xSendEventStructToIPTask_Stub( xSendEventStructToIPTask_EventPoll );
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), 1U );
+    xEventGroupSetBits_ExpectAnyArgsAndReturn( 0 );
+    xEventGroupWaitBits_ExpectAnyArgsAndReturn( 0 );
+
+    xReturn = FreeRTOS_EventPollWait( &xSet, xResults, 2, 0 );
+
+    TEST_ASSERT_EQUAL( eEventPollWaitEvent, xSentEvent.eEventType );
+    TEST_ASSERT_EQUAL( 1, xReturn );
+    TEST_ASSERT_EQUAL_PTR( &xSocket, xResults[ 0 ].xSocket );
+    TEST_ASSERT_EQUAL( eSELECT_READ, xResults[ 0 ].xEvents );
+    TEST_ASSERT_EQUAL( 0U, xSocket.ucPollCheck );
+    TEST_ASSERT_EQUAL( 0, xSet.uxReadyCount );
+}
+
+/**
+ * @brief An event-poll set is deleted by the IP-task.
+ */
+void test_FreeRTOS_EventPollDelete( void )
+{
+    EventPollSet_t xSet;
+    FreeRTOS_Socket_t xSocket;
+
+    memset( &xSet, 0, sizeof( xSet ) );
+    memset( &xSocket, 0, sizeof( xSocket ) );
+    memset( &xSentEvent, 0, sizeof( xSentEvent ) );
+
+    xSocket.pxEventPoll = &xSet;
+    xSocket.xSelectBits = ( EventBits_t ) eSELECT_READ;
+    xSet.pxMembers = &xSocket;
+
+    xSendEventStructToIPTask_Stub( xSendEventStructToIPTask_Capture );
+
+    FreeRTOS_EventPollDelete( &xSet );
+
+    TEST_ASSERT_EQUAL( eEventPollDeleteEvent, xSentEvent.eEventType );
+    TEST_ASSERT_EQUAL_PTR( &xSet, xSentEvent.pvData );
+    TEST_ASSERT_EQUAL_PTR( &xSocket, xSet.pxMembers );
+
+    vEventGroupDelete_Expect( xSet.xPollGroup );
+    vPortFree_Expect( &xSet );
+
+    vSocketEventPollDelete( &xSet );
+
+    TEST_ASSERT_EQUAL( NULL, xSet.pxMembers );
+    TEST_ASSERT_EQUAL( NULL, xSocket.pxEventPoll );
+    TEST_ASSERT_EQUAL( 0U, xSocket.xSelectBits );
+}
+
+/**
+ * @brief The option FREERTOS_SO_REUSEPORT is set on an unbound TCP socket.
+ */
+void test_FreeRTOS_setsockopt_ReusePort( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    BaseType_t xValue = pdTRUE;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), NULL );
+
+    xReturn = FreeRTOS_setsockopt( &xSocket, 0, FREERTOS_SO_REUSEPORT, &xValue, sizeof( xValue ) );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSocket.u.xTCP.bits.bReusePort );
+}
+
+/**
+ * @brief The option FREERTOS_SO_REUSEPORT can not be set once the socket is bound.
+ */
+void test_FreeRTOS_setsockopt_ReusePort_Bound( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    BaseType_t xValue = pdTRUE;
+    List_t xBoundList;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), &xBoundList );
+
+    xReturn = FreeRTOS_setsockopt( &xSocket, 0, FREERTOS_SO_REUSEPORT, &xValue, sizeof( xValue ) );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xSocket.u.xTCP.bits.bReusePort );
+}
+
+/**
+ * @brief The option FREERTOS_SO_TCP_ACK_POLICY is copied to the socket.
+ */
+void test_FreeRTOS_setsockopt_AckPolicy( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    TCPAckPolicy_t xPolicy;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+    memset( &xPolicy, 0, sizeof( xPolicy ) );
+
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+    xPolicy.ucAckEvery = 4U;
+    xPolicy.ucQuickAckCount = 8U;
+    xPolicy.usAckDelayMs = 40U;
+    xPolicy.usQuickAckIdleMs = 1000U;
+    xPolicy.xAckOnPush = pdTRUE;
+
+    xReturn = FreeRTOS_setsockopt( &xSocket, 0, FREERTOS_SO_TCP_ACK_POLICY, &xPolicy, sizeof( xPolicy ) );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL_MEMORY( &xPolicy, &( xSocket.u.xTCP.xAckPolicy ), sizeof( xPolicy ) );
+    TEST_ASSERT_EQUAL( 8U, xSocket.u.xTCP.ucQuickAcks );
+}
+
+/**
+ * @brief An ACK may not be delayed by more than 500 ms.
+ */
+void test_FreeRTOS_setsockopt_AckPolicy_DelayTooLong( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    TCPAckPolicy_t xPolicy;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+    memset( &xPolicy, 0, sizeof( xPolicy ) );
+
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+    xPolicy.usAckDelayMs = 501U;
+
+    xReturn = FreeRTOS_setsockopt( &xSocket, 0, FREERTOS_SO_TCP_ACK_POLICY, &xPolicy, sizeof( xPolicy ) );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EINVAL, xReturn );
+    TEST_ASSERT_EQUAL( 0U, xSocket.u.xTCP.xAckPolicy.usAckDelayMs );
+}
+
+/**
+ * @brief FreeRTOS_tcp_acks_saved() only returns a count for TCP sockets.
+ */
+void test_FreeRTOS_tcp_acks_saved( void )
+{
+    FreeRTOS_Socket_t xSocket;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+    xSocket.u.xTCP.ulAcksSaved = 12U;
+
+    TEST_ASSERT_EQUAL_UINT32( 12U, FreeRTOS_tcp_acks_saved( &xSocket ) );
+
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_UDP;
+
+    TEST_ASSERT_EQUAL_UINT32( 0U, FreeRTOS_tcp_acks_saved( &xSocket ) );
+}
+
+/**
+ * @brief A socket that connects is inserted in the connection hash table.
+ */
+void test_vTCPSocketHashUpdate_InsertOnConnect( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    List_t xBoundList;
+
+    prvInitHashSocket( &xSocket, 1024U, 0xC0A80001U, 80U );
+    xSocket.u.xTCP.eTCPState = eCONNECT_SYN;
+
+    xIsCallingFromIPTask_ExpectAndReturn( pdTRUE );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), &xBoundList );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), NULL );
+    vListInsertEnd_Expect( NULL, &( xSocket.u.xTCP.xHashListItem ) );
+    vListInsertEnd_IgnoreArg_pxList();
+
+    vTCPSocketHashUpdate( &xSocket );
+}
+
+/**
+ * @brief A socket that starts listening moves from the connection hash table
+ *        to the listen index.
+ */
+void test_vTCPSocketHashUpdate_RehashOnListen( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    List_t xBoundList;
+    List_t * pxConnectionList;
+
+    prvInitHashSocket( &xSocket, 1024U, 0U, 0U );
+    xSocket.u.xTCP.eTCPState = eCLOSED;
+
+    /* First the bound socket is stored in the connection table. */
+    xIsCallingFromIPTask_ExpectAndReturn( pdTRUE );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), &xBoundList );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), NULL );
+    vListInsertEnd_Stub( vListInsertEnd_Capture );
+
+    vTCPSocketHashUpdate( &xSocket );
+
+    pxConnectionList = pxInsertedList;
+    TEST_ASSERT_NOT_NULL( pxConnectionList );
+
+    /* Now it changes state to eTCP_LISTEN. */
+    xSocket.u.xTCP.eTCPState = eTCP_LISTEN;
+
+    xIsCallingFromIPTask_ExpectAndReturn( pdTRUE );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), &xBoundList );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), pxConnectionList );
+    uxListRemove_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), 0U );
+
+    vTCPSocketHashUpdate( &xSocket );
+
+    TEST_ASSERT_NOT_NULL( pxInsertedList );
+    TEST_ASSERT_NOT_EQUAL( pxConnectionList, pxInsertedList );
+}
+
+/**
+ * @brief A socket that is not bound anymore is removed from the tables and
+ *        not inserted again.
+ */
+void test_vTCPSocketHashUpdate_RemoveOnClose( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    List_t xHashList;
+
+    prvInitHashSocket( &xSocket, 1024U, 0xC0A80001U, 80U );
+
+    xIsCallingFromIPTask_ExpectAndReturn( pdTRUE );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), NULL );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), &xHashList );
+    uxListRemove_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), 0U );
+
+    vTCPSocketHashUpdate( &xSocket );
+}
+
+/**
+ * @brief A state change in a user task is passed to the IP-task, the tables
+ *        are not touched.
+ */
+void test_vTCPSocketHashUpdate_FromUserTask( void )
+{
+    FreeRTOS_Socket_t xSocket;
+
+    prvInitHashSocket( &xSocket, 1024U, 0U, 0U );
+    xSocket.u.xTCP.eTCPState = eTCP_LISTEN;
+    memset( &xSentEvent, 0, sizeof( xSentEvent ) );
+
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    xIPIsNetworkTaskReady_ExpectAndReturn( pdTRUE );
+    xSendEventStructToIPTask_Stub( xSendEventStructToIPTask_Capture );
+
+    vTCPSocketHashUpdate( &xSocket );
+
+    TEST_ASSERT_EQUAL( eTCPHashUpdateEvent, xSentEvent.eEventType );
+    TEST_ASSERT_EQUAL_PTR( &xSocket, xSentEvent.pvData );
+}
+
+/**
+ * @brief Before the IP-task is running, the tables are updated directly.
+ */
+void test_vTCPSocketHashUpdate_IPTaskNotReady( void )
+{
+    FreeRTOS_Socket_t xSocket;
+
+    prvInitHashSocket( &xSocket, 1024U, 0U, 0U );
+
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    xIPIsNetworkTaskReady_ExpectAndReturn( pdFALSE );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), NULL );
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), NULL );
+
+    vTCPSocketHashUpdate( &xSocket );
+}
+
+/**
+ * @brief The connected socket is found in its bucket.
+ */
+void test_pxTCPSocketLookup_Hash_Hit( void )
+{
+    FreeRTOS_Socket_t xSocket, * pxResult;
+    IPv46_Address_t xRemoteIP;
+    ListItem_t xEnd;
+
+    prvInitHashSocket( &xSocket, 1024U, 0xC0A80001U, 80U );
+    memset( &xRemoteIP, 0, sizeof( xRemoteIP ) );
+    xRemoteIP.xIPAddress.ulIP_IPv4 = 0xC0A80001U;
+
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( xSocket.u.xTCP.xHashListItem ) );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_LIST_ITEM_OWNER_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), &xSocket );
+
+    pxResult = pxTCPSocketLookup( 0U, 1024U, xRemoteIP, 80U );
+
+    TEST_ASSERT_EQUAL_PTR( &xSocket, pxResult );
+}
+
+/**
+ * @brief Several connections share a bucket: the chain is followed until the
+ *        4-tuple matches.
+ */
+void test_pxTCPSocketLookup_Hash_CollisionChain( void )
+{
+    FreeRTOS_Socket_t xOtherPort, xOtherIP, xSocket, * pxResult;
+    IPv46_Address_t xRemoteIP;
+    ListItem_t xEnd;
+
+    prvInitHashSocket( &xOtherPort, 1024U, 0xC0A80001U, 81U );
+    prvInitHashSocket( &xOtherIP, 1024U, 0xC0A80002U, 80U );
+    prvInitHashSocket( &xSocket, 1024U, 0xC0A80001U, 80U );
+    memset( &xRemoteIP, 0, sizeof( xRemoteIP ) );
+    xRemoteIP.xIPAddress.ulIP_IPv4 = 0xC0A80001U;
+
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( xOtherPort.u.xTCP.xHashListItem ) );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_LIST_ITEM_OWNER_ExpectAndReturn( &( xOtherPort.u.xTCP.xHashListItem ), &xOtherPort );
+    listGET_NEXT_ExpectAndReturn( &( xOtherPort.u.xTCP.xHashListItem ), &( xOtherIP.u.xTCP.xHashListItem ) );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_LIST_ITEM_OWNER_ExpectAndReturn( &( xOtherIP.u.xTCP.xHashListItem ), &xOtherIP );
+    listGET_NEXT_ExpectAndReturn( &( xOtherIP.u.xTCP.xHashListItem ), &( xSocket.u.xTCP.xHashListItem ) );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_LIST_ITEM_OWNER_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), &xSocket );
+
+    pxResult = pxTCPSocketLookup( 0U, 1024U, xRemoteIP, 80U );
+
+    TEST_ASSERT_EQUAL_PTR( &xSocket, pxResult );
+}
+
+/**
+ * @brief There is no connection, the socket listening to the port is found.
+ */
+void test_pxTCPSocketLookup_Hash_ListenFallback( void )
+{
+    FreeRTOS_Socket_t xListener, * pxResult;
+    IPv46_Address_t xRemoteIP;
+    ListItem_t xEnd;
+
+    prvInitHashSocket( &xListener, 1024U, 0U, 0U );
+    xListener.u.xTCP.eTCPState = eTCP_LISTEN;
+    memset( &xRemoteIP, 0, sizeof( xRemoteIP ) );
+    xRemoteIP.xIPAddress.ulIP_IPv4 = 0xC0A80001U;
+
+    /* The connection bucket is empty. */
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+
+    /* The listen bucket holds the listener. */
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( xListener.u.xTCP.xHashListItem ) );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_LIST_ITEM_OWNER_ExpectAndReturn( &( xListener.u.xTCP.xHashListItem ), &xListener );
+
+    pxResult = pxTCPSocketLookup( 0U, 1024U, xRemoteIP, 80U );
+
+    TEST_ASSERT_EQUAL_PTR( &xListener, pxResult );
+}
+
+/**
+ * @brief Neither a connection nor a listener uses the port.
+ */
+void test_pxTCPSocketLookup_Hash_Miss( void )
+{
+    FreeRTOS_Socket_t xSocket, xListener, * pxResult;
+    IPv46_Address_t xRemoteIP;
+    ListItem_t xEnd;
+
+    prvInitHashSocket( &xSocket, 2048U, 0xC0A80001U, 80U );
+    prvInitHashSocket( &xListener, 2048U, 0U, 0U );
+    xListener.u.xTCP.eTCPState = eTCP_LISTEN;
+    memset( &xRemoteIP, 0, sizeof( xRemoteIP ) );
+    xRemoteIP.xIPAddress.ulIP_IPv4 = 0xC0A80001U;
+
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( xSocket.u.xTCP.xHashListItem ) );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_LIST_ITEM_OWNER_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), &xSocket );
+    listGET_NEXT_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), &xEnd );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( xListener.u.xTCP.xHashListItem ) );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_LIST_ITEM_OWNER_ExpectAndReturn( &( xListener.u.xTCP.xHashListItem ), &xListener );
+    listGET_NEXT_ExpectAndReturn( &( xListener.u.xTCP.xHashListItem ), &xEnd );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+
+    pxResult = pxTCPSocketLookup( 0U, 1024U, xRemoteIP, 80U );
+
+    TEST_ASSERT_NULL( pxResult );
+}
+
+/**
+ * @brief An IPv6 peer address is compared by pxTCPSocketLookup_IPv6().
+ */
+void test_pxTCPSocketLookup_Hash_IPv6( void )
+{
+    FreeRTOS_Socket_t xSocket, * pxResult;
+    IPv46_Address_t xRemoteIP;
+    ListItem_t xEnd;
+
+    prvInitHashSocket( &xSocket, 1024U, 0U, 80U );
+    xSocket.bits.bIsIPv6 = pdTRUE_UNSIGNED;
+    memset( &xRemoteIP, 0, sizeof( xRemoteIP ) );
+    xRemoteIP.xIs_IPv6 = pdTRUE;
+    memset( xRemoteIP.xIPAddress.xIP_IPv6.ucBytes, 0xFE, ipSIZE_OF_IPv6_ADDRESS );
+    memcpy( xSocket.u.xTCP.xRemoteIP.xIP_IPv6.ucBytes, xRemoteIP.xIPAddress.xIP_IPv6.ucBytes, ipSIZE_OF_IPv6_ADDRESS );
+
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( xSocket.u.xTCP.xHashListItem ) );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_LIST_ITEM_OWNER_ExpectAndReturn( &( xSocket.u.xTCP.xHashListItem ), &xSocket );
+    pxTCPSocketLookup_IPv6_ExpectAndReturn( &xSocket, NULL, &xSocket );
+    pxTCPSocketLookup_IPv6_IgnoreArg_pxAddress();
+
+    pxResult = pxTCPSocketLookup( 0U, 1024U, xRemoteIP, 80U );
+
+    TEST_ASSERT_EQUAL_PTR( &xSocket, pxResult );
+}
+
+/**
+ * @brief A bound UDP socket is also stored in the bucket of its port.
+ */
+void test_vSocketBind_UDP_PortHash( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket;
+    struct freertos_sockaddr xBindAddress;
+    NetworkEndPoint_t xEndPoint = { 0 };
+    ListItem_t xEnd;
+
+    memset( &xBindAddress, 0, sizeof( xBindAddress ) );
+    memset( &xSocket, 0, sizeof( xSocket ) );
+
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_UDP;
+    xBindAddress.sin_family = FREERTOS_AF_INET;
+    xBindAddress.sin_port = FreeRTOS_htons( 5000U );
+    xBindAddress.sin_address.ulIP_IPv4 = 0xC0A80001U;
+
+    /* The bucket of the port is empty. */
+    xIPIsNetworkTaskReady_ExpectAndReturn( pdTRUE );
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+
+    listSET_LIST_ITEM_VALUE_Expect( &( xSocket.xBoundSocketListItem ), xBindAddress.sin_port );
+    FreeRTOS_FindEndPointOnIP_IPv4_ExpectAnyArgsAndReturn( &xEndPoint );
+    vListInsertEnd_Expect( NULL, &( xSocket.xBoundSocketListItem ) );
+    vListInsertEnd_IgnoreArg_pxList();
+
+    listSET_LIST_ITEM_VALUE_Expect( &( xSocket.u.xUDP.xHashListItem ), xBindAddress.sin_port );
+    vListInsertEnd_Expect( NULL, &( xSocket.u.xUDP.xHashListItem ) );
+    vListInsertEnd_IgnoreArg_pxList();
+
+    xReturn = vSocketBind( &xSocket, &xBindAddress, sizeof( xBindAddress ), pdFALSE );
+
+    TEST_ASSERT_EQUAL( 0, xReturn );
+    TEST_ASSERT_EQUAL( 5000U, xSocket.usLocalPort );
+}
+
+/**
+ * @brief Binding fails when the bucket already holds a socket with the same
+ *        port number.
+ */
+void test_vSocketBind_UDP_PortHash_InUse( void )
+{
+    BaseType_t xReturn;
+    FreeRTOS_Socket_t xSocket, xOther;
+    struct freertos_sockaddr xBindAddress;
+    ListItem_t xEnd;
+
+    memset( &xBindAddress, 0, sizeof( xBindAddress ) );
+    memset( &xSocket, 0, sizeof( xSocket ) );
+    memset( &xOther, 0, sizeof( xOther ) );
+
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_UDP;
+    xOther.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_UDP;
+    xBindAddress.sin_family = FREERTOS_AF_INET;
+    xBindAddress.sin_port = FreeRTOS_htons( 5000U );
+
+    xIPIsNetworkTaskReady_ExpectAndReturn( pdTRUE );
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( xOther.u.xUDP.xHashListItem ) );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_LIST_ITEM_VALUE_ExpectAndReturn( &( xOther.u.xUDP.xHashListItem ), xBindAddress.sin_port );
+    listGET_LIST_ITEM_OWNER_ExpectAndReturn( &( xOther.u.xUDP.xHashListItem ), &xOther );
+
+    xReturn = vSocketBind( &xSocket, &xBindAddress, sizeof( xBindAddress ), pdFALSE );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EADDRINUSE, xReturn );
+}
+
+/**
+ * @brief Several ports share a bucket: only the socket bound to the wanted
+ *        port is returned.
+ */
+void test_pxUDPSocketLookup_PortHash_SameBucket( void )
+{
+    FreeRTOS_Socket_t xFirst, xSecond, * pxResult;
+    ListItem_t xEnd;
+
+    memset( &xFirst, 0, sizeof( xFirst ) );
+    memset( &xSecond, 0, sizeof( xSecond ) );
+
+    xIPIsNetworkTaskReady_ExpectAndReturn( pdTRUE );
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( xFirst.u.xUDP.xHashListItem ) );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_LIST_ITEM_VALUE_ExpectAndReturn( &( xFirst.u.xUDP.xHashListItem ), 4000U );
+    listGET_NEXT_ExpectAndReturn( &( xFirst.u.xUDP.xHashListItem ), &( xSecond.u.xUDP.xHashListItem ) );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_LIST_ITEM_VALUE_ExpectAndReturn( &( xSecond.u.xUDP.xHashListItem ), 5000U );
+    listGET_LIST_ITEM_OWNER_ExpectAndReturn( &( xSecond.u.xUDP.xHashListItem ), &xSecond );
+
+    listGET_LIST_ITEM_OWNER_ExpectAndReturn( &( xSecond.xBoundSocketListItem ), &xSecond );
+
+    pxResult = pxUDPSocketLookup( 5000U );
+
+    TEST_ASSERT_EQUAL_PTR( &xSecond, pxResult );
+}
+
+/**
+ * @brief Closing a UDP socket removes it from the bucket of its port, after
+ *        which the port can not be found anymore.
+ */
+void test_pxUDPSocketLookup_PortHash_AfterClose( void )
+{
+    FreeRTOS_Socket_t xSocket, * pxResult;
+    List_t xBoundList;
+    ListItem_t xEnd;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_UDP;
+
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), &xBoundList );
+    uxListRemove_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), 0U );
+    uxListRemove_ExpectAndReturn( &( xSocket.u.xUDP.xHashListItem ), 0U );
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( xSocket.u.xUDP.xWaitingPacketsList ), 0U );
+    vPortFree_Expect( &xSocket );
+
+    ( void ) vSocketClose( &xSocket );
+
+    /* The bucket is empty now. */
+    xIPIsNetworkTaskReady_ExpectAndReturn( pdTRUE );
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &xEnd );
+    listGET_END_MARKER_ExpectAnyArgsAndReturn( &xEnd );
+
+    pxResult = pxUDPSocketLookup( 5000U );
+
+    TEST_ASSERT_NULL( pxResult );
+}
+
+/**
+ * @brief A connection attempt is handed to one of the sockets that listen to
+ *        the port.  The choice does not depend on the order of the list, and
+ *        when a listening socket is added or closed, only the attempts that
+ *        it takes over or leaves behind move.
+ */
+void test_prvTCPReusePortSelect_StableChoice( void )
+{
+    FreeRTOS_Socket_t xSockets[ 7 ];
+    FreeRTOS_Socket_t * pxList4[ 6 ];
+    FreeRTOS_Socket_t * pxReversed[ 6 ];
+    FreeRTOS_Socket_t * pxList3[ 5 ];
+    FreeRTOS_Socket_t * pxList5[ 7 ];
+    static FreeRTOS_Socket_t * pxChoices[ TEST_REUSE_PORT_FLOWS ];
+    static FreeRTOS_Socket_t * pxOtherChoices[ TEST_REUSE_PORT_FLOWS ];
+    UBaseType_t uxChosen[ 4 ] = { 0U };
+    List_t xList;
+    UBaseType_t uxFlow;
+    UBaseType_t uxIndex;
+
+    memset( &xList, 0, sizeof( xList ) );
+
+    /* Sockets 0 to 4 listen to port 80.  Socket 5 is connected from port 80,
+     * socket 6 listens to port 81. */
+    for( uxIndex = 0U; uxIndex < 7U; uxIndex++ )
+    {
+        prvInitHashSocket( &( xSockets[ uxIndex ] ), 80U, 0U, 0U );
+        xSockets[ uxIndex ].u.xTCP.eTCPState = eTCP_LISTEN;
+        xSockets[ uxIndex ].u.xTCP.bits.bReusePort = pdTRUE_UNSIGNED;
+    }
+
+    xSockets[ 5 ].u.xTCP.eTCPState = eESTABLISHED;
+    xSockets[ 6 ].usLocalPort = 81U;
+
+    listGET_HEAD_ENTRY_Stub( listGET_HEAD_ENTRY_Linked );
+    listGET_END_MARKER_Stub( listGET_END_MARKER_Linked );
+    listGET_NEXT_Stub( listGET_NEXT_Linked );
+    listGET_LIST_ITEM_OWNER_Stub( listGET_LIST_ITEM_OWNER_Linked );
+
+    /* Four listening sockets: 0 to 3. */
+    for( uxIndex = 0U; uxIndex < 6U; uxIndex++ )
+    {
+        pxList4[ uxIndex ] = &( xSockets[ ( uxIndex < 4U ) ? uxIndex : ( uxIndex + 1U ) ] );
+        pxReversed[ 5U - uxIndex ] = pxList4[ uxIndex ];
+    }
+
+    prvLinkSockets( &xList, pxList4, 6U );
+    prvSelectListeners( &xList, pxChoices );
+
+    for( uxFlow = 0U; uxFlow < TEST_REUSE_PORT_FLOWS; uxFlow++ )
+    {
+        uxIndex = ( UBaseType_t ) ( pxChoices[ uxFlow ] - xSockets );
+        TEST_ASSERT_LESS_THAN( 4U, uxIndex );
+        uxChosen[ uxIndex ]++;
+    }
+
+    /* The connection attempts are spread over all listening sockets. */
+    for( uxIndex = 0U; uxIndex < 4U; uxIndex++ )
+    {
+        TEST_ASSERT_GREATER_THAN( TEST_REUSE_PORT_FLOWS / 32U, uxChosen[ uxIndex ] );
+    }
+
+    /* The order of the list does not matter. */
+    prvLinkSockets( &xList, pxReversed, 6U );
+    prvSelectListeners( &xList, pxOtherChoices );
+    TEST_ASSERT_EQUAL_PTR_ARRAY( pxChoices, pxOtherChoices, TEST_REUSE_PORT_FLOWS );
+
+    /* Socket 2 is closed: only its own connection attempts move. */
+    pxList3[ 0 ] = &( xSockets[ 0 ] );
+    pxList3[ 1 ] = &( xSockets[ 1 ] );
+    pxList3[ 2 ] = &( xSockets[ 3 ] );
+    pxList3[ 3 ] = &( xSockets[ 5 ] );
+    pxList3[ 4 ] = &( xSockets[ 6 ] );
+
+    prvLinkSockets( &xList, pxList3, 5U );
+    prvSelectListeners( &xList, pxOtherChoices );
+
+    for( uxFlow = 0U; uxFlow < TEST_REUSE_PORT_FLOWS; uxFlow++ )
+    {
+        if( pxChoices[ uxFlow ] == &( xSockets[ 2 ] ) )
+        {
+            TEST_ASSERT_NOT_EQUAL( &( xSockets[ 2 ] ), pxOtherChoices[ uxFlow ] );
+            TEST_ASSERT_LESS_THAN( 4U, ( UBaseType_t ) ( pxOtherChoices[ uxFlow ] - xSockets ) );
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_PTR( pxChoices[ uxFlow ], pxOtherChoices[ uxFlow ] );
+        }
+    }
+
+    /* Socket 4 starts listening as well: an attempt either stays where it
+     * was, or moves to socket 4. */
+    for( uxIndex = 0U; uxIndex < 7U; uxIndex++ )
+    {
+        pxList5[ uxIndex ] = &( xSockets[ uxIndex ] );
+    }
+
+    prvLinkSockets( &xList, pxList5, 7U );
+    prvSelectListeners( &xList, pxOtherChoices );
+
+    uxChosen[ 0 ] = 0U;
+
+    for( uxFlow = 0U; uxFlow < TEST_REUSE_PORT_FLOWS; uxFlow++ )
+    {
+        if( pxOtherChoices[ uxFlow ] == &( xSockets[ 4 ] ) )
+        {
+            uxChosen[ 0 ]++;
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL_PTR( pxChoices[ uxFlow ], pxOtherChoices[ uxFlow ] );
+        }
+    }
+
+    TEST_ASSERT_GREATER_THAN( 0U, uxChosen[ 0 ] );
+}
+
+/**
+ * @brief Without a listening socket for the port, there is no choice.
+ */
+void test_prvTCPReusePortSelect_NoListener( void )
+{
+    FreeRTOS_Socket_t xSocket;
+    FreeRTOS_Socket_t * pxSockets[ 1 ];
+    IPv46_Address_t xRemoteIP;
+    List_t xList;
+
+    memset( &xList, 0, sizeof( xList ) );
+    memset( &xRemoteIP, 0, sizeof( xRemoteIP ) );
+
+    prvInitHashSocket( &xSocket, 80U, 0xC0A80001U, 1024U );
+    pxSockets[ 0 ] = &xSocket;
+
+    listGET_HEAD_ENTRY_Stub( listGET_HEAD_ENTRY_Linked );
+    listGET_END_MARKER_Stub( listGET_END_MARKER_Linked );
+    listGET_NEXT_Stub( listGET_NEXT_Linked );
+    listGET_LIST_ITEM_OWNER_Stub( listGET_LIST_ITEM_OWNER_Linked );
+
+    prvLinkSockets( &xList, pxSockets, 1U );
+
+    TEST_ASSERT_NULL( prvTCPReusePortSelect( &xList, 80U, &xRemoteIP, 1024U ) );
+}
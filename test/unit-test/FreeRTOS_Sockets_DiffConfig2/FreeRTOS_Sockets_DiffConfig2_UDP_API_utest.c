@@ -0,0 +1,738 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_list.h"
+
+/* This must come after list.h is included (in this case, indirectly
+ * by mock_list.h). */
+#include "mock_Sockets_DiffConfig2_list_macros.h"
+#include "mock_queue.h"
+#include "mock_event_groups.h"
+#include "mock_portable.h"
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_ARP.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_FreeRTOS_IPv4_Sockets.h"
+
+#include "FreeRTOS_Sockets.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* ============================ EXTERN VARIABLES ============================ */
+
+BaseType_t xTCPWindowLoggingLevel = 0;
+
+/* The segment size used by the tests. */
+#define TEST_SEGMENT_SIZE      ( 100U )
+
+/* The maximum number of network buffers used by a test. */
+#define TEST_MAX_BUFFERS       ( 4U )
+
+/* The offset of the UDP payload in an IPv4 packet. */
+#define TEST_PAYLOAD_OFFSET    ( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_UDP_HEADER )
+
+/* The network buffers handed out by the tests. */
+static NetworkBufferDescriptor_t xNetworkBuffers[ TEST_MAX_BUFFERS ];
+static uint8_t ucEthernetBuffers[ TEST_MAX_BUFFERS ][ ipconfigNETWORK_MTU + ipSIZE_OF_ETH_HEADER ];
+
+/* The event that was sent to the IP-task. */
+static IPStackEvent_t xSentEvent;
+
+/* ============================== Test Helpers ============================== */
+
+/**
+ * @brief Clear the network buffers and the last event.
+ */
+void setUp( void )
+{
+    size_t uxIndex;
+
+    memset( xNetworkBuffers, 0, sizeof( xNetworkBuffers ) );
+    memset( ucEthernetBuffers, 0, sizeof( ucEthernetBuffers ) );
+    memset( &xSentEvent, 0, sizeof( xSentEvent ) );
+
+    for( uxIndex = 0; uxIndex < TEST_MAX_BUFFERS; uxIndex++ )
+    {
+        xNetworkBuffers[ uxIndex ].pucEthernetBuffer = ucEthernetBuffers[ uxIndex ];
+    }
+}
+
+/**
+ * @brief The real implementation of FreeRTOS_min_size_t().
+ */
+static size_t FreeRTOS_min_size_t_Real( size_t a,
+                                        size_t b,
+                                        int cmock_num_calls )
+{
+    ( void ) cmock_num_calls;
+
+    return ( a < b ) ? a : b;
+}
+
+/**
+ * @brief Remember the event that is sent to the IP-task.
+ */
+static BaseType_t xSendEventStructToIPTask_Capture( const IPStackEvent_t * pxEvent,
+                                                    TickType_t uxTimeout,
+                                                    int cmock_num_calls )
+{
+    ( void ) uxTimeout;
+    ( void ) cmock_num_calls;
+
+    xSentEvent = *pxEvent;
+
+    return pdPASS;
+}
+
+/**
+ * @brief Prepare a UDP socket that has a segment size and is bound.
+ */
+static void prvPrepareSegmentSocket( FreeRTOS_Socket_t * pxSocket,
+                                     struct freertos_sockaddr * pxDestinationAddress )
+{
+    memset( pxSocket, 0, sizeof( *pxSocket ) );
+    memset( pxDestinationAddress, 0, sizeof( *pxDestinationAddress ) );
+
+    pxSocket->ucProtocol = FREERTOS_IPPROTO_UDP;
+    pxSocket->u.xUDP.usSegmentSize = TEST_SEGMENT_SIZE;
+    pxSocket->u.xUDP.pxHandleSent = NULL;
+
+    pxDestinationAddress->sin_family = FREERTOS_AF_INET;
+    pxDestinationAddress->sin_port = FreeRTOS_htons( 5000U );
+    pxDestinationAddress->sin_address.ulIP_IPv4 = 0x0A00000AU;
+
+    FreeRTOS_min_size_t_Stub( FreeRTOS_min_size_t_Real );
+}
+
+/**
+ * @brief Expect the calls made before the first segment is allocated, for a
+ *        non-blocking send to an address that is found in the ARP cache.
+ */
+static void prvExpectSegmentsStart( FreeRTOS_Socket_t * pxSocket )
+{
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( pxSocket->xBoundSocketListItem ), ( struct xLIST * ) ( uintptr_t ) 0x11223344 );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    eARPGetCacheEntry_ExpectAnyArgsAndReturn( eResolutionCacheHit );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+}
+
+/**
+ * @brief Expect the calls that fill one segment.
+ */
+static void prvExpectSegment( FreeRTOS_Socket_t * pxSocket,
+                              NetworkBufferDescriptor_t * pxNetworkBuffer,
+                              size_t uxLength )
+{
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( TEST_PAYLOAD_OFFSET + uxLength, 0U, pxNetworkBuffer );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    xSend_UDP_Update_IPv4_ExpectAndReturn( pxNetworkBuffer, NULL, NULL );
+    xSend_UDP_Update_IPv4_IgnoreArg_pxDestinationAddress();
+    listGET_LIST_ITEM_VALUE_ExpectAndReturn( &( pxSocket->xBoundSocketListItem ), 0xAADF );
+}
+
+/**
+ * @brief Prepare a bound UDP socket for the multi-message functions.
+ */
+static void prvPrepareMultiSocket( FreeRTOS_Socket_t * pxSocket,
+                                   FreeRTOS_MMsg_t * pxMessages,
+                                   size_t uxCount )
+{
+    size_t uxIndex;
+
+    memset( pxSocket, 0, sizeof( *pxSocket ) );
+    memset( pxMessages, 0, uxCount * sizeof( *pxMessages ) );
+
+    pxSocket->ucProtocol = FREERTOS_IPPROTO_UDP;
+    pxSocket->u.xUDP.pxHandleSent = NULL;
+
+    for( uxIndex = 0; uxIndex < uxCount; uxIndex++ )
+    {
+        pxMessages[ uxIndex ].xAddress.sin_family = FREERTOS_AF_INET;
+        pxMessages[ uxIndex ].xAddress.sin_port = FreeRTOS_htons( ( uint16_t ) ( 5000U + uxIndex ) );
+        pxMessages[ uxIndex ].xAddress.sin_address.ulIP_IPv4 = 0x0A00000AU;
+    }
+
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( pxSocket->xBoundSocketListItem ), ( struct xLIST * ) ( uintptr_t ) 0x11223344 );
+}
+
+/**
+ * @brief Give a network buffer a UDP payload of 'uxLength' bytes with value
+ *        'ucValue'.
+ */
+static void prvFillPacket( NetworkBufferDescriptor_t * pxNetworkBuffer,
+                           size_t uxLength,
+                           uint8_t ucValue )
+{
+    pxNetworkBuffer->xDataLength = TEST_PAYLOAD_OFFSET + uxLength;
+    memset( &( pxNetworkBuffer->pucEthernetBuffer[ TEST_PAYLOAD_OFFSET ] ), ucValue, uxLength );
+}
+
+/**
+ * @brief Expect the calls that take the first packet from the socket, and
+ *        the calls that move 'uxWaiting' more packets to the private list.
+ */
+static void prvExpectTakePackets( FreeRTOS_Socket_t * pxSocket,
+                                  size_t uxWaiting,
+                                  BaseType_t xMessageCount )
+{
+    size_t uxIndex;
+
+    listCURRENT_LIST_LENGTH_ExpectAndReturn( &( pxSocket->u.xUDP.xWaitingPacketsList ), uxWaiting + 1U );
+
+    vTaskSuspendAll_Expect();
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( pxSocket->u.xUDP.xWaitingPacketsList ), &( xNetworkBuffers[ 0 ] ) );
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffers[ 0 ].xBufferListItem ), 0 );
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+
+    vListInitialise_ExpectAnyArgs();
+    vListInsertEnd_ExpectAnyArgs();
+
+    vTaskSuspendAll_Expect();
+
+    for( uxIndex = 1U; uxIndex <= uxWaiting; uxIndex++ )
+    {
+        listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( uxIndex );
+        listCURRENT_LIST_LENGTH_ExpectAndReturn( &( pxSocket->u.xUDP.xWaitingPacketsList ), uxWaiting + 1U - uxIndex );
+        listGET_OWNER_OF_HEAD_ENTRY_ExpectAndReturn( &( pxSocket->u.xUDP.xWaitingPacketsList ), &( xNetworkBuffers[ uxIndex ] ) );
+        uxListRemove_ExpectAndReturn( &( xNetworkBuffers[ uxIndex ].xBufferListItem ), 0 );
+        vListInsertEnd_ExpectAnyArgs();
+    }
+
+    listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( uxWaiting + 1U );
+
+    if( ( BaseType_t ) ( uxWaiting + 1U ) < xMessageCount )
+    {
+        listCURRENT_LIST_LENGTH_ExpectAndReturn( &( pxSocket->u.xUDP.xWaitingPacketsList ), 0 );
+    }
+
+    xTaskResumeAll_ExpectAndReturn( pdFALSE );
+}
+
+/**
+ * @brief Expect the calls that hand packet 'uxIndex' to message 'pxMessage'.
+ */
+static void prvExpectDeliverPacket( size_t uxIndex,
+                                    size_t uxRemaining,
+                                    FreeRTOS_MMsg_t * pxMessage,
+                                    BaseType_t xRelease )
+{
+    listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( uxRemaining );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( xNetworkBuffers[ uxIndex ] ) );
+    uxListRemove_ExpectAndReturn( &( xNetworkBuffers[ uxIndex ].xBufferListItem ), 0 );
+    uxIPHeaderSizePacket_ExpectAndReturn( &( xNetworkBuffers[ uxIndex ] ), ipSIZE_OF_IPv4_HEADER );
+    xRecv_Update_IPv4_ExpectAndReturn( &( xNetworkBuffers[ uxIndex ] ), &( pxMessage->xAddress ), TEST_PAYLOAD_OFFSET );
+
+    if( xRelease != pdFALSE )
+    {
+        vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ uxIndex ] ) );
+    }
+}
+
+/**
+ * @brief Expect the calls that copy message 'uxIndex' to a network buffer.
+ */
+static void prvExpectSendMessage( FreeRTOS_Socket_t * pxSocket,
+                                  const FreeRTOS_MMsg_t * pxMessage,
+                                  NetworkBufferDescriptor_t * pxNetworkBuffer )
+{
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( TEST_PAYLOAD_OFFSET + pxMessage->uxBufferLength, 0U, pxNetworkBuffer );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+
+    if( pxNetworkBuffer != NULL )
+    {
+        xSend_UDP_Update_IPv4_ExpectAndReturn( pxNetworkBuffer, NULL, NULL );
+        xSend_UDP_Update_IPv4_IgnoreArg_pxDestinationAddress();
+        listGET_LIST_ITEM_VALUE_ExpectAndReturn( &( pxSocket->xBoundSocketListItem ), 0xAADF );
+    }
+}
+
+/* =============================== Test Cases =============================== */
+
+/**
+ * @brief A buffer of three segments is sent as a chain of three packets.
+ */
+void test_FreeRTOS_sendto_Segments_Split( void )
+{
+    int32_t lResult;
+    FreeRTOS_Socket_t xSocket;
+    struct freertos_sockaddr xDestinationAddress;
+    uint8_t ucBuffer[ 3U * TEST_SEGMENT_SIZE ];
+    size_t uxIndex;
+
+    prvPrepareSegmentSocket( &xSocket, &xDestinationAddress );
+
+    for( uxIndex = 0; uxIndex < sizeof( ucBuffer ); uxIndex++ )
+    {
+        ucBuffer[ uxIndex ] = ( uint8_t ) uxIndex;
+    }
+
+    prvExpectSegmentsStart( &xSocket );
+
+    for( uxIndex = 0; uxIndex < 3U; uxIndex++ )
+    {
+        prvExpectSegment( &xSocket, &( xNetworkBuffers[ uxIndex ] ), TEST_SEGMENT_SIZE );
+    }
+
+    xSendEventStructToIPTask_Stub( xSendEventStructToIPTask_Capture );
+
+    lResult = FreeRTOS_sendto( &xSocket, ucBuffer, sizeof( ucBuffer ), 0, &xDestinationAddress, sizeof( xDestinationAddress ) );
+
+    TEST_ASSERT_EQUAL( sizeof( ucBuffer ), lResult );
+    TEST_ASSERT_EQUAL( eStackTxSegmentsEvent, xSentEvent.eEventType );
+    TEST_ASSERT_EQUAL_PTR( &( xNetworkBuffers[ 0 ] ), xSentEvent.pvData );
+    TEST_ASSERT_EQUAL_PTR( &( xNetworkBuffers[ 1 ] ), xNetworkBuffers[ 0 ].pxNextBuffer );
+    TEST_ASSERT_EQUAL_PTR( &( xNetworkBuffers[ 2 ] ), xNetworkBuffers[ 1 ].pxNextBuffer );
+    TEST_ASSERT_NULL( xNetworkBuffers[ 2 ].pxNextBuffer );
+
+    for( uxIndex = 0; uxIndex < 3U; uxIndex++ )
+    {
+        TEST_ASSERT_EQUAL( TEST_PAYLOAD_OFFSET + TEST_SEGMENT_SIZE, xNetworkBuffers[ uxIndex ].xDataLength );
+        TEST_ASSERT_EQUAL( xDestinationAddress.sin_port, xNetworkBuffers[ uxIndex ].usPort );
+        TEST_ASSERT_EQUAL_MEMORY( &( ucBuffer[ uxIndex * TEST_SEGMENT_SIZE ] ), &( ucEthernetBuffers[ uxIndex ][ TEST_PAYLOAD_OFFSET ] ), TEST_SEGMENT_SIZE );
+    }
+}
+
+/**
+ * @brief The last segment of a buffer carries the remaining bytes.
+ */
+void test_FreeRTOS_sendto_Segments_ShortLastSegment( void )
+{
+    int32_t lResult;
+    FreeRTOS_Socket_t xSocket;
+    struct freertos_sockaddr xDestinationAddress;
+    uint8_t ucBuffer[ ( 2U * TEST_SEGMENT_SIZE ) + 50U ];
+
+    prvPrepareSegmentSocket( &xSocket, &xDestinationAddress );
+    memset( ucBuffer, 0xA5, sizeof( ucBuffer ) );
+
+    prvExpectSegmentsStart( &xSocket );
+    prvExpectSegment( &xSocket, &( xNetworkBuffers[ 0 ] ), TEST_SEGMENT_SIZE );
+    prvExpectSegment( &xSocket, &( xNetworkBuffers[ 1 ] ), TEST_SEGMENT_SIZE );
+    prvExpectSegment( &xSocket, &( xNetworkBuffers[ 2 ] ), 50U );
+
+    xSendEventStructToIPTask_Stub( xSendEventStructToIPTask_Capture );
+
+    lResult = FreeRTOS_sendto( &xSocket, ucBuffer, sizeof( ucBuffer ), 0, &xDestinationAddress, sizeof( xDestinationAddress ) );
+
+    TEST_ASSERT_EQUAL( sizeof( ucBuffer ), lResult );
+    TEST_ASSERT_EQUAL_PTR( &( xNetworkBuffers[ 0 ] ), xSentEvent.pvData );
+    TEST_ASSERT_EQUAL( TEST_PAYLOAD_OFFSET + TEST_SEGMENT_SIZE, xNetworkBuffers[ 1 ].xDataLength );
+    TEST_ASSERT_EQUAL( TEST_PAYLOAD_OFFSET + 50U, xNetworkBuffers[ 2 ].xDataLength );
+    TEST_ASSERT_EACH_EQUAL_UINT8( 0xA5, &( ucEthernetBuffers[ 2 ][ TEST_PAYLOAD_OFFSET ] ), 50U );
+    TEST_ASSERT_EACH_EQUAL_UINT8( 0x00, &( ucEthernetBuffers[ 2 ][ TEST_PAYLOAD_OFFSET + 50U ] ), TEST_SEGMENT_SIZE - 50U );
+    TEST_ASSERT_NULL( xNetworkBuffers[ 2 ].pxNextBuffer );
+}
+
+/**
+ * @brief No network buffer is available for the second segment: the first
+ *        segment is released and nothing is sent. Only the first buffer is
+ *        waited for.
+ */
+void test_FreeRTOS_sendto_Segments_NoBufferHalfway( void )
+{
+    int32_t lResult;
+    FreeRTOS_Socket_t xSocket;
+    struct freertos_sockaddr xDestinationAddress;
+    uint8_t ucBuffer[ 3U * TEST_SEGMENT_SIZE ] = { 0 };
+
+    prvPrepareSegmentSocket( &xSocket, &xDestinationAddress );
+    xSocket.xSendBlockTime = 100U;
+
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), ( struct xLIST * ) ( uintptr_t ) 0x11223344 );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    xARPWaitResolution_ExpectAndReturn( xDestinationAddress.sin_address.ulIP_IPv4, 100U, 0 );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( TEST_PAYLOAD_OFFSET + TEST_SEGMENT_SIZE, 100U, &( xNetworkBuffers[ 0 ] ) );
+    xTaskCheckForTimeOut_ExpectAnyArgsAndReturn( pdFALSE );
+    xSend_UDP_Update_IPv4_ExpectAndReturn( &( xNetworkBuffers[ 0 ] ), NULL, NULL );
+    xSend_UDP_Update_IPv4_IgnoreArg_pxDestinationAddress();
+    listGET_LIST_ITEM_VALUE_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), 0xAADF );
+
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( TEST_PAYLOAD_OFFSET + TEST_SEGMENT_SIZE, 0U, NULL );
+
+    vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ 0 ] ) );
+
+    lResult = FreeRTOS_sendto( &xSocket, ucBuffer, sizeof( ucBuffer ), 0, &xDestinationAddress, sizeof( xDestinationAddress ) );
+
+    TEST_ASSERT_EQUAL( 0, lResult );
+    TEST_ASSERT_NULL( xNetworkBuffers[ 0 ].pxNextBuffer );
+}
+
+/**
+ * @brief The IP-task can not accept the chain: all segments are released.
+ */
+void test_FreeRTOS_sendto_Segments_SendingToIPTaskFails( void )
+{
+    int32_t lResult;
+    FreeRTOS_Socket_t xSocket;
+    struct freertos_sockaddr xDestinationAddress;
+    uint8_t ucBuffer[ 2U * TEST_SEGMENT_SIZE ] = { 0 };
+
+    prvPrepareSegmentSocket( &xSocket, &xDestinationAddress );
+
+    prvExpectSegmentsStart( &xSocket );
+    prvExpectSegment( &xSocket, &( xNetworkBuffers[ 0 ] ), TEST_SEGMENT_SIZE );
+    prvExpectSegment( &xSocket, &( xNetworkBuffers[ 1 ] ), TEST_SEGMENT_SIZE );
+
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdFAIL );
+
+    vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ 0 ] ) );
+    vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ 1 ] ) );
+
+    lResult = FreeRTOS_sendto( &xSocket, ucBuffer, sizeof( ucBuffer ), 0, &xDestinationAddress, sizeof( xDestinationAddress ) );
+
+    TEST_ASSERT_EQUAL( 0, lResult );
+    TEST_ASSERT_NULL( xNetworkBuffers[ 0 ].pxNextBuffer );
+    TEST_ASSERT_NULL( xNetworkBuffers[ 1 ].pxNextBuffer );
+}
+
+/**
+ * @brief The MAC address of the destination is not in the ARP cache, and the
+ *        call may not block: an ARP request is sent and no network buffer is
+ *        allocated.
+ */
+void test_FreeRTOS_sendto_Segments_ARPMiss( void )
+{
+    int32_t lResult;
+    FreeRTOS_Socket_t xSocket;
+    struct freertos_sockaddr xDestinationAddress;
+    uint8_t ucBuffer[ 2U * TEST_SEGMENT_SIZE ] = { 0 };
+
+    prvPrepareSegmentSocket( &xSocket, &xDestinationAddress );
+    xSocket.xSendBlockTime = 100U;
+
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), ( struct xLIST * ) ( uintptr_t ) 0x11223344 );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    eARPGetCacheEntry_ExpectAnyArgsAndReturn( eResolutionCacheMiss );
+    FreeRTOS_OutputARPRequest_Expect( xDestinationAddress.sin_address.ulIP_IPv4 );
+
+    lResult = FreeRTOS_sendto( &xSocket, ucBuffer, sizeof( ucBuffer ), FREERTOS_MSG_DONTWAIT, &xDestinationAddress, sizeof( xDestinationAddress ) );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EADDRNOTAVAIL, lResult );
+}
+
+/**
+ * @brief No ARP reply arrives within the block time.
+ */
+void test_FreeRTOS_sendto_Segments_ARPTimeout( void )
+{
+    int32_t lResult;
+    FreeRTOS_Socket_t xSocket;
+    struct freertos_sockaddr xDestinationAddress;
+    uint8_t ucBuffer[ 2U * TEST_SEGMENT_SIZE ] = { 0 };
+
+    prvPrepareSegmentSocket( &xSocket, &xDestinationAddress );
+    xSocket.xSendBlockTime = 100U;
+
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    listLIST_ITEM_CONTAINER_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), ( struct xLIST * ) ( uintptr_t ) 0x11223344 );
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    xARPWaitResolution_ExpectAndReturn( xDestinationAddress.sin_address.ulIP_IPv4, 100U, -pdFREERTOS_ERRNO_EADDRNOTAVAIL );
+
+    lResult = FreeRTOS_sendto( &xSocket, ucBuffer, sizeof( ucBuffer ), 0, &xDestinationAddress, sizeof( xDestinationAddress ) );
+
+    TEST_ASSERT_EQUAL( -pdFREERTOS_ERRNO_EADDRNOTAVAIL, lResult );
+}
+
+/**
+ * @brief A buffer that needs more segments than allowed is not sent.
+ */
+void test_FreeRTOS_sendto_Segments_TooManySegments( void )
+{
+    int32_t lResult;
+    FreeRTOS_Socket_t xSocket;
+    struct freertos_sockaddr xDestinationAddress;
+    static uint8_t ucBuffer[ ( ( ipconfigNUM_NETWORK_BUFFER_DESCRIPTORS / 2 ) * TEST_SEGMENT_SIZE ) + 1U ];
+
+    prvPrepareSegmentSocket( &xSocket, &xDestinationAddress );
+
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+
+    lResult = FreeRTOS_sendto( &xSocket, ucBuffer, sizeof( ucBuffer ), 0, &xDestinationAddress, sizeof( xDestinationAddress ) );
+
+    TEST_ASSERT_EQUAL( 0, lResult );
+}
+
+/**
+ * @brief Two datagrams are waiting and two are asked for: both are copied,
+ *        the second one is truncated to the size of its buffer.
+ */
+void test_FreeRTOS_recvfrom_multi_FullBatch( void )
+{
+    BaseType_t xResult;
+    FreeRTOS_Socket_t xSocket;
+    FreeRTOS_MMsg_t xMessages[ 2 ];
+    uint8_t ucBuffer0[ 64 ];
+    uint8_t ucBuffer1[ 10 ];
+
+    prvPrepareMultiSocket( &xSocket, xMessages, 2U );
+    memset( ucBuffer0, 0, sizeof( ucBuffer0 ) );
+    memset( ucBuffer1, 0, sizeof( ucBuffer1 ) );
+    xMessages[ 0 ].pvBuffer = ucBuffer0;
+    xMessages[ 0 ].uxBufferLength = sizeof( ucBuffer0 );
+    xMessages[ 1 ].pvBuffer = ucBuffer1;
+    xMessages[ 1 ].uxBufferLength = sizeof( ucBuffer1 );
+    prvFillPacket( &( xNetworkBuffers[ 0 ] ), 20U, 0x11 );
+    prvFillPacket( &( xNetworkBuffers[ 1 ] ), 20U, 0x22 );
+
+    prvExpectTakePackets( &xSocket, 1U, 2 );
+    prvExpectDeliverPacket( 0U, 2U, &( xMessages[ 0 ] ), pdTRUE );
+    prvExpectDeliverPacket( 1U, 1U, &( xMessages[ 1 ] ), pdTRUE );
+    listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( 0 );
+
+    xResult = FreeRTOS_recvfrom_multi( &xSocket, xMessages, 2, 0 );
+
+    TEST_ASSERT_EQUAL( 2, xResult );
+    TEST_ASSERT_EQUAL( 20U, xMessages[ 0 ].uxLength );
+    TEST_ASSERT_EQUAL( sizeof( ucBuffer1 ), xMessages[ 1 ].uxLength );
+    TEST_ASSERT_EACH_EQUAL_UINT8( 0x11, ucBuffer0, 20U );
+    TEST_ASSERT_EACH_EQUAL_UINT8( 0x00, &( ucBuffer0[ 20 ] ), sizeof( ucBuffer0 ) - 20U );
+    TEST_ASSERT_EACH_EQUAL_UINT8( 0x22, ucBuffer1, sizeof( ucBuffer1 ) );
+}
+
+/**
+ * @brief Three datagrams are asked for while only one is waiting.
+ */
+void test_FreeRTOS_recvfrom_multi_PartialBatch( void )
+{
+    BaseType_t xResult;
+    FreeRTOS_Socket_t xSocket;
+    FreeRTOS_MMsg_t xMessages[ 3 ];
+    uint8_t ucBuffer0[ 64 ];
+
+    prvPrepareMultiSocket( &xSocket, xMessages, 3U );
+    memset( ucBuffer0, 0, sizeof( ucBuffer0 ) );
+    xMessages[ 0 ].pvBuffer = ucBuffer0;
+    xMessages[ 0 ].uxBufferLength = sizeof( ucBuffer0 );
+    prvFillPacket( &( xNetworkBuffers[ 0 ] ), 30U, 0x33 );
+
+    prvExpectTakePackets( &xSocket, 0U, 3 );
+    prvExpectDeliverPacket( 0U, 1U, &( xMessages[ 0 ] ), pdTRUE );
+    listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( 0 );
+
+    xResult = FreeRTOS_recvfrom_multi( &xSocket, xMessages, 3, 0 );
+
+    TEST_ASSERT_EQUAL( 1, xResult );
+    TEST_ASSERT_EQUAL( 30U, xMessages[ 0 ].uxLength );
+    TEST_ASSERT_EQUAL( 0U, xMessages[ 1 ].uxLength );
+    TEST_ASSERT_EACH_EQUAL_UINT8( 0x33, ucBuffer0, 30U );
+}
+
+/**
+ * @brief With FREERTOS_ZERO_COPY, the messages point to the payload of the
+ *        network buffers, which are not released.
+ */
+void test_FreeRTOS_recvfrom_multi_ZeroCopy( void )
+{
+    BaseType_t xResult;
+    FreeRTOS_Socket_t xSocket;
+    FreeRTOS_MMsg_t xMessages[ 2 ];
+
+    prvPrepareMultiSocket( &xSocket, xMessages, 2U );
+    prvFillPacket( &( xNetworkBuffers[ 0 ] ), 20U, 0x11 );
+    prvFillPacket( &( xNetworkBuffers[ 1 ] ), 40U, 0x22 );
+
+    prvExpectTakePackets( &xSocket, 1U, 2 );
+    prvExpectDeliverPacket( 0U, 2U, &( xMessages[ 0 ] ), pdFALSE );
+    prvExpectDeliverPacket( 1U, 1U, &( xMessages[ 1 ] ), pdFALSE );
+    listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( 0 );
+
+    xResult = FreeRTOS_recvfrom_multi( &xSocket, xMessages, 2, FREERTOS_ZERO_COPY );
+
+    TEST_ASSERT_EQUAL( 2, xResult );
+    TEST_ASSERT_EQUAL_PTR( &( ucEthernetBuffers[ 0 ][ TEST_PAYLOAD_OFFSET ] ), xMessages[ 0 ].pvBuffer );
+    TEST_ASSERT_EQUAL_PTR( &( ucEthernetBuffers[ 1 ][ TEST_PAYLOAD_OFFSET ] ), xMessages[ 1 ].pvBuffer );
+    TEST_ASSERT_EQUAL( 20U, xMessages[ 0 ].uxLength );
+    TEST_ASSERT_EQUAL( 40U, xMessages[ 1 ].uxLength );
+}
+
+/**
+ * @brief All datagrams are passed to the IP-task in a single chain.
+ */
+void test_FreeRTOS_sendto_multi_FullBatch( void )
+{
+    BaseType_t xResult;
+    FreeRTOS_Socket_t xSocket;
+    FreeRTOS_MMsg_t xMessages[ 2 ];
+    uint8_t ucBuffer0[ 20 ];
+    uint8_t ucBuffer1[ 30 ];
+
+    prvPrepareMultiSocket( &xSocket, xMessages, 2U );
+    memset( ucBuffer0, 0x11, sizeof( ucBuffer0 ) );
+    memset( ucBuffer1, 0x22, sizeof( ucBuffer1 ) );
+    xMessages[ 0 ].pvBuffer = ucBuffer0;
+    xMessages[ 0 ].uxBufferLength = sizeof( ucBuffer0 );
+    xMessages[ 1 ].pvBuffer = ucBuffer1;
+    xMessages[ 1 ].uxBufferLength = sizeof( ucBuffer1 );
+
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    prvExpectSendMessage( &xSocket, &( xMessages[ 0 ] ), &( xNetworkBuffers[ 0 ] ) );
+    prvExpectSendMessage( &xSocket, &( xMessages[ 1 ] ), &( xNetworkBuffers[ 1 ] ) );
+    xSendEventStructToIPTask_Stub( xSendEventStructToIPTask_Capture );
+
+    xResult = FreeRTOS_sendto_multi( &xSocket, xMessages, 2, 0 );
+
+    TEST_ASSERT_EQUAL( 2, xResult );
+    TEST_ASSERT_EQUAL( eStackTxChainEvent, xSentEvent.eEventType );
+    TEST_ASSERT_EQUAL_PTR( &( xNetworkBuffers[ 0 ] ), xSentEvent.pvData );
+    TEST_ASSERT_EQUAL_PTR( &( xNetworkBuffers[ 1 ] ), xNetworkBuffers[ 0 ].pxNextBuffer );
+    TEST_ASSERT_NULL( xNetworkBuffers[ 1 ].pxNextBuffer );
+    TEST_ASSERT_EQUAL( sizeof( ucBuffer0 ), xMessages[ 0 ].uxLength );
+    TEST_ASSERT_EQUAL( sizeof( ucBuffer1 ), xMessages[ 1 ].uxLength );
+    TEST_ASSERT_EQUAL( xMessages[ 1 ].xAddress.sin_port, xNetworkBuffers[ 1 ].usPort );
+    TEST_ASSERT_EACH_EQUAL_UINT8( 0x11, &( ucEthernetBuffers[ 0 ][ TEST_PAYLOAD_OFFSET ] ), sizeof( ucBuffer0 ) );
+    TEST_ASSERT_EACH_EQUAL_UINT8( 0x22, &( ucEthernetBuffers[ 1 ][ TEST_PAYLOAD_OFFSET ] ), sizeof( ucBuffer1 ) );
+}
+
+/**
+ * @brief No network buffer is available for the second datagram: the batch
+ *        ends, and the first datagram is sent.
+ */
+void test_FreeRTOS_sendto_multi_PartialBatch( void )
+{
+    BaseType_t xResult;
+    FreeRTOS_Socket_t xSocket;
+    FreeRTOS_MMsg_t xMessages[ 3 ];
+    uint8_t ucBuffer[ 20 ] = { 0 };
+    size_t uxIndex;
+
+    prvPrepareMultiSocket( &xSocket, xMessages, 3U );
+
+    for( uxIndex = 0; uxIndex < 3U; uxIndex++ )
+    {
+        xMessages[ uxIndex ].pvBuffer = ucBuffer;
+        xMessages[ uxIndex ].uxBufferLength = sizeof( ucBuffer );
+    }
+
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    prvExpectSendMessage( &xSocket, &( xMessages[ 0 ] ), &( xNetworkBuffers[ 0 ] ) );
+    prvExpectSendMessage( &xSocket, &( xMessages[ 1 ] ), NULL );
+    xSendEventStructToIPTask_Stub( xSendEventStructToIPTask_Capture );
+
+    xResult = FreeRTOS_sendto_multi( &xSocket, xMessages, 3, 0 );
+
+    TEST_ASSERT_EQUAL( 1, xResult );
+    TEST_ASSERT_EQUAL_PTR( &( xNetworkBuffers[ 0 ] ), xSentEvent.pvData );
+    TEST_ASSERT_NULL( xNetworkBuffers[ 0 ].pxNextBuffer );
+    TEST_ASSERT_EQUAL( sizeof( ucBuffer ), xMessages[ 0 ].uxLength );
+    TEST_ASSERT_EQUAL( 0U, xMessages[ 1 ].uxLength );
+    TEST_ASSERT_EQUAL( 0U, xMessages[ 2 ].uxLength );
+}
+
+/**
+ * @brief The IP-task can not accept the chain: the network buffers that were
+ *        allocated are unlinked and released.
+ */
+void test_FreeRTOS_sendto_multi_SendingToIPTaskFails( void )
+{
+    BaseType_t xResult;
+    FreeRTOS_Socket_t xSocket;
+    FreeRTOS_MMsg_t xMessages[ 2 ];
+    uint8_t ucBuffer[ 20 ] = { 0 };
+
+    prvPrepareMultiSocket( &xSocket, xMessages, 2U );
+    xMessages[ 0 ].pvBuffer = ucBuffer;
+    xMessages[ 0 ].uxBufferLength = sizeof( ucBuffer );
+    xMessages[ 1 ].pvBuffer = ucBuffer;
+    xMessages[ 1 ].uxBufferLength = sizeof( ucBuffer );
+
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    prvExpectSendMessage( &xSocket, &( xMessages[ 0 ] ), &( xNetworkBuffers[ 0 ] ) );
+    prvExpectSendMessage( &xSocket, &( xMessages[ 1 ] ), &( xNetworkBuffers[ 1 ] ) );
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdFAIL );
+    vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ 0 ] ) );
+    vReleaseNetworkBufferAndDescriptor_Expect( &( xNetworkBuffers[ 1 ] ) );
+
+    xResult = FreeRTOS_sendto_multi( &xSocket, xMessages, 2, 0 );
+
+    TEST_ASSERT_EQUAL( 0, xResult );
+    TEST_ASSERT_NULL( xNetworkBuffers[ 0 ].pxNextBuffer );
+    TEST_ASSERT_NULL( xNetworkBuffers[ 1 ].pxNextBuffer );
+    TEST_ASSERT_EQUAL( 0U, xMessages[ 0 ].uxLength );
+    TEST_ASSERT_EQUAL( 0U, xMessages[ 1 ].uxLength );
+}
+
+/**
+ * @brief With FREERTOS_ZERO_COPY, a chain that the IP-task can not accept is
+ *        unlinked, but the buffers stay with the application.
+ */
+void test_FreeRTOS_sendto_multi_ZeroCopy_SendingToIPTaskFails( void )
+{
+    BaseType_t xResult;
+    FreeRTOS_Socket_t xSocket;
+    FreeRTOS_MMsg_t xMessages[ 2 ];
+
+    prvPrepareMultiSocket( &xSocket, xMessages, 2U );
+    xMessages[ 0 ].pvBuffer = &( ucEthernetBuffers[ 0 ][ TEST_PAYLOAD_OFFSET ] );
+    xMessages[ 0 ].uxBufferLength = 20U;
+    xMessages[ 1 ].pvBuffer = &( ucEthernetBuffers[ 1 ][ TEST_PAYLOAD_OFFSET ] );
+    xMessages[ 1 ].uxBufferLength = 30U;
+
+    xIsCallingFromIPTask_ExpectAndReturn( pdFALSE );
+    vTaskSetTimeOutState_ExpectAnyArgs();
+    pxUDPPayloadBuffer_to_NetworkBuffer_ExpectAndReturn( xMessages[ 0 ].pvBuffer, &( xNetworkBuffers[ 0 ] ) );
+    xSend_UDP_Update_IPv4_ExpectAndReturn( &( xNetworkBuffers[ 0 ] ), NULL, NULL );
+    xSend_UDP_Update_IPv4_IgnoreArg_pxDestinationAddress();
+    listGET_LIST_ITEM_VALUE_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), 0xAADF );
+    pxUDPPayloadBuffer_to_NetworkBuffer_ExpectAndReturn( xMessages[ 1 ].pvBuffer, &( xNetworkBuffers[ 1 ] ) );
+    xSend_UDP_Update_IPv4_ExpectAndReturn( &( xNetworkBuffers[ 1 ] ), NULL, NULL );
+    xSend_UDP_Update_IPv4_IgnoreArg_pxDestinationAddress();
+    listGET_LIST_ITEM_VALUE_ExpectAndReturn( &( xSocket.xBoundSocketListItem ), 0xAADF );
+    xSendEventStructToIPTask_ExpectAnyArgsAndReturn( pdFAIL );
+
+    xResult = FreeRTOS_sendto_multi( &xSocket, xMessages, 2, FREERTOS_ZERO_COPY );
+
+    TEST_ASSERT_EQUAL( 0, xResult );
+    TEST_ASSERT_NULL( xNetworkBuffers[ 0 ].pxNextBuffer );
+    TEST_ASSERT_NULL( xNetworkBuffers[ 1 ].pxNextBuffer );
+    TEST_ASSERT_EQUAL( TEST_PAYLOAD_OFFSET + 20U, xNetworkBuffers[ 0 ].xDataLength );
+}
@@ -0,0 +1,439 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_list.h"
+#include "mock_queue.h"
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_Sockets.h"
+#include "mock_FreeRTOS_TCP_Transmission.h"
+#include "mock_FreeRTOS_TCP_State_Handling.h"
+#include "mock_FreeRTOS_TCP_Utils.h"
+#include "mock_NetworkBufferManagement.h"
+
+#include "FreeRTOS_TCP_SYN_Cache.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* ===========================  EXTERN VARIABLES  =========================== */
+
+extern SynCacheEntry_t xSynCache[ ipconfigTCP_SYN_CACHE_SIZE ];
+extern uint32_t ulCookieSecret;
+extern BaseType_t xCookieSecretSet;
+
+/* The local port of the listening socket. */
+#define TEST_LOCAL_PORT     80U
+
+/* The IP-address of the peer, host-endian. */
+#define TEST_REMOTE_IP      0xC0A80105U
+
+static FreeRTOS_Socket_t xListenSocket;
+static FreeRTOS_Socket_t xNewSocket;
+static NetworkBufferDescriptor_t xNetworkBuffer;
+static uint8_t ucEthernetBuffer[ ipconfigNETWORK_MTU ];
+
+/* A copy of the last packet passed to prvTCPReturnPacket(). */
+static uint8_t ucSentPacket[ ipconfigNETWORK_MTU ];
+static uint32_t ulSentLength;
+static TickType_t xTickCount;
+
+/* ============================  Unity Fixtures  ============================ */
+
+void setUp( void )
+{
+    memset( xSynCache, 0, sizeof( xSynCache ) );
+    memset( &xListenSocket, 0, sizeof( xListenSocket ) );
+    memset( &xNewSocket, 0, sizeof( xNewSocket ) );
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+    memset( ucSentPacket, 0, sizeof( ucSentPacket ) );
+    ulSentLength = 0U;
+    xTickCount = 1000U;
+    xCookieSecretSet = pdFALSE;
+
+    xListenSocket.usLocalPort = TEST_LOCAL_PORT;
+    xListenSocket.u.xTCP.eTCPState = eTCP_LISTEN;
+    xListenSocket.u.xTCP.usBacklog = 4U;
+    xListenSocket.u.xTCP.uxRxWinSize = 8U;
+    xListenSocket.u.xTCP.uxRxStreamSize = 8000U;
+}
+
+/* ======================== Stub Callback Functions ========================= */
+
+static TickType_t xStubTaskGetTickCount( int NumCalls )
+{
+    return xTickCount;
+}
+
+static size_t uxStubIPHeaderSizePacket( const NetworkBufferDescriptor_t * pxBuffer,
+                                        int NumCalls )
+{
+    return ipSIZE_OF_IPv4_HEADER;
+}
+
+static uint16_t usStubChar2u16( const uint8_t * pucPtr,
+                                int NumCalls )
+{
+    return ( uint16_t ) ( ( ( uint16_t ) pucPtr[ 0 ] << 8 ) | pucPtr[ 1 ] );
+}
+
+static uint32_t ulStubMinUint32( uint32_t a,
+                                 uint32_t b,
+                                 int NumCalls )
+{
+    return ( a < b ) ? a : b;
+}
+
+static uint32_t ulStubMaxUint32( uint32_t a,
+                                 uint32_t b,
+                                 int NumCalls )
+{
+    return ( a > b ) ? a : b;
+}
+
+static size_t uxStubMinSizeT( size_t a,
+                              size_t b,
+                              int NumCalls )
+{
+    return ( a < b ) ? a : b;
+}
+
+static BaseType_t xStubGetRandomNumber( uint32_t * pulNumber,
+                                        int NumCalls )
+{
+    *pulNumber = 0x5A5AA5A5U;
+    return pdPASS;
+}
+
+static void vStubTCPReturnPacket( FreeRTOS_Socket_t * pxSocket,
+                                  NetworkBufferDescriptor_t * pxDescriptor,
+                                  uint32_t ulLen,
+                                  BaseType_t xReleaseAfterSend,
+                                  int NumCalls )
+{
+    TEST_ASSERT_NULL( pxSocket );
+    TEST_ASSERT_EQUAL( pdFALSE, xReleaseAfterSend );
+    memcpy( ucSentPacket, pxDescriptor->pucEthernetBuffer, ipSIZE_OF_ETH_HEADER + ulLen );
+    ulSentLength = ulLen;
+}
+
+static void vStubSocketSetMSS( FreeRTOS_Socket_t * pxSocket,
+                               int NumCalls )
+{
+    pxSocket->u.xTCP.usMSS = ipconfigTCP_MSS;
+}
+
+static BaseType_t xStubTCPCreateWindow( FreeRTOS_Socket_t * pxSocket,
+                                        int NumCalls )
+{
+    pxSocket->u.xTCP.xTCPWindow.tx.ulFirstSequenceNumber = pxSocket->u.xTCP.xTCPWindow.ulOurSequenceNumber;
+    return pdPASS;
+}
+
+static void vStubTCPStateChange( FreeRTOS_Socket_t * pxSocket,
+                                 enum eTCP_STATE eTCPState,
+                                 int NumCalls )
+{
+    pxSocket->u.xTCP.eTCPState = eTCPState;
+}
+
+/* ============================  Helper Functions  ========================== */
+
+static void vInstallStubs( void )
+{
+    xTaskGetTickCount_Stub( xStubTaskGetTickCount );
+    uxIPHeaderSizePacket_Stub( uxStubIPHeaderSizePacket );
+    usChar2u16_Stub( usStubChar2u16 );
+    FreeRTOS_min_uint32_Stub( ulStubMinUint32 );
+    FreeRTOS_max_uint32_Stub( ulStubMaxUint32 );
+    FreeRTOS_min_size_t_Stub( uxStubMinSizeT );
+    xApplicationGetRandomNumber_Stub( xStubGetRandomNumber );
+    prvTCPReturnPacket_Stub( vStubTCPReturnPacket );
+    prvSocketSetMSS_Stub( vStubSocketSetMSS );
+    prvTCPCreateWindow_Stub( xStubTCPCreateWindow );
+    vTCPStateChange_Stub( vStubTCPStateChange );
+}
+
+/* Fill the network buffer with an IPv4 packet from the peer. A SYN carries
+ * the MSS option (1400), the window scaling option (3) and some padding. */
+static void vMakePacket( uint16_t usRemotePort,
+                         uint32_t ulSequenceNumber,
+                         uint32_t ulAckNr,
+                         BaseType_t xIsSyn )
+{
+    TCPPacket_t * pxTCPPacket = ( TCPPacket_t * ) ucEthernetBuffer;
+
+    memset( ucEthernetBuffer, 0, sizeof( ucEthernetBuffer ) );
+    pxTCPPacket->xIPHeader.ulSourceIPAddress = FreeRTOS_htonl( TEST_REMOTE_IP );
+    pxTCPPacket->xTCPHeader.usSourcePort = FreeRTOS_htons( usRemotePort );
+    pxTCPPacket->xTCPHeader.usDestinationPort = FreeRTOS_htons( TEST_LOCAL_PORT );
+    pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( ulSequenceNumber );
+    pxTCPPacket->xTCPHeader.ulAckNr = FreeRTOS_htonl( ulAckNr );
+
+    if( xIsSyn != pdFALSE )
+    {
+        uint8_t * pucOptions = pxTCPPacket->xTCPHeader.ucOptdata;
+
+        pxTCPPacket->xTCPHeader.ucTCPFlags = tcpTCP_FLAG_SYN;
+        pucOptions[ 0 ] = tcpTCP_OPT_MSS;
+        pucOptions[ 1 ] = tcpTCP_OPT_MSS_LEN;
+        pucOptions[ 2 ] = 0x05U;
+        pucOptions[ 3 ] = 0x78U;
+        pucOptions[ 4 ] = tcpTCP_OPT_NOOP;
+        pucOptions[ 5 ] = tcpTCP_OPT_WSOPT;
+        pucOptions[ 6 ] = tcpTCP_OPT_WSOPT_LEN;
+        pucOptions[ 7 ] = 3U;
+        pucOptions[ 8 ] = tcpTCP_OPT_NOOP;
+        pucOptions[ 9 ] = tcpTCP_OPT_NOOP;
+        pucOptions[ 10 ] = tcpTCP_OPT_NOOP;
+        pucOptions[ 11 ] = tcpTCP_OPT_END;
+        pxTCPPacket->xTCPHeader.ucTCPOffset = ( ipSIZE_OF_TCP_HEADER + 12U ) << 2;
+        xNetworkBuffer.xDataLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + 12U;
+    }
+    else
+    {
+        pxTCPPacket->xTCPHeader.ucTCPFlags = tcpTCP_FLAG_ACK;
+        pxTCPPacket->xTCPHeader.ucTCPOffset = ipSIZE_OF_TCP_HEADER << 2;
+        xNetworkBuffer.xDataLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER;
+    }
+
+    xNetworkBuffer.pucEthernetBuffer = ucEthernetBuffer;
+}
+
+/* Return our initial sequence number from the last SYN+ACK. The stub of
+ * prvTCPReturnPacket() does not swap the sequence numbers. */
+static uint32_t ulSentInitialSequenceNumber( void )
+{
+    const TCPPacket_t * pxTCPPacket = ( const TCPPacket_t * ) ucSentPacket;
+
+    return FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulAckNr );
+}
+
+/* Expect the creation of a new socket for the listening socket. */
+static void vExpectNewSocket( void )
+{
+    FreeRTOS_socket_ExpectAndReturn( FREERTOS_AF_INET, FREERTOS_SOCK_STREAM, FREERTOS_IPPROTO_TCP, &xNewSocket );
+    prvTCPSocketCopy_ExpectAndReturn( &xNewSocket, &xListenSocket, pdTRUE );
+}
+
+/* ==============================  Test Cases  ============================== */
+
+/**
+ * @brief A SYN is stored in the cache and answered with a SYN+ACK that
+ *        carries the MSS, window scaling and SACK options.
+ */
+void test_xTCPSynCacheAdd_SendsSynAck( void )
+{
+    const TCPPacket_t * pxSent = ( const TCPPacket_t * ) ucSentPacket;
+    BaseType_t xResult;
+
+    vInstallStubs();
+    vMakePacket( 5000U, 1000U, 0U, pdTRUE );
+
+    xResult = xTCPSynCacheAdd( &xListenSocket, &xNetworkBuffer, 777U );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xResult );
+    TEST_ASSERT_EQUAL( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + 12U, ulSentLength );
+    TEST_ASSERT_EQUAL( tcpTCP_FLAG_SYN | tcpTCP_FLAG_ACK, pxSent->xTCPHeader.ucTCPFlags );
+    TEST_ASSERT_EQUAL( 1001U, FreeRTOS_ntohl( pxSent->xTCPHeader.ulSequenceNumber ) );
+    TEST_ASSERT_EQUAL( 777U, ulSentInitialSequenceNumber() );
+    TEST_ASSERT_EQUAL( tcpTCP_OPT_MSS, pxSent->xTCPHeader.ucOptdata[ 0 ] );
+    TEST_ASSERT_EQUAL( tcpTCP_OPT_WSOPT, pxSent->xTCPHeader.ucOptdata[ 5 ] );
+    TEST_ASSERT_EQUAL( tcpTCP_OPT_SACK_P, pxSent->xTCPHeader.ucOptdata[ 10 ] );
+    TEST_ASSERT_EQUAL( 8000U, FreeRTOS_ntohs( pxSent->xTCPHeader.usWindow ) );
+
+    TEST_ASSERT_EQUAL( TEST_REMOTE_IP, xSynCache[ 0 ].xRemoteIP.ulIP_IPv4 );
+    TEST_ASSERT_EQUAL( 5000U, xSynCache[ 0 ].usRemotePort );
+    TEST_ASSERT_EQUAL( 1400U, xSynCache[ 0 ].usPeerMSS );
+    TEST_ASSERT_EQUAL( 3U, xSynCache[ 0 ].ucPeerWinScaleFactor );
+}
+
+/**
+ * @brief A retransmitted SYN gets the same SYN+ACK, and does not use a second
+ *        entry.
+ */
+void test_xTCPSynCacheAdd_Retransmission( void )
+{
+    vInstallStubs();
+    vMakePacket( 5000U, 1000U, 0U, pdTRUE );
+    ( void ) xTCPSynCacheAdd( &xListenSocket, &xNetworkBuffer, 777U );
+
+    vMakePacket( 5000U, 1000U, 0U, pdTRUE );
+    ( void ) xTCPSynCacheAdd( &xListenSocket, &xNetworkBuffer, 888U );
+
+    TEST_ASSERT_EQUAL( 777U, ulSentInitialSequenceNumber() );
+    TEST_ASSERT_EQUAL( 0U, xSynCache[ 1 ].ucFlags );
+}
+
+/**
+ * @brief The ACK that completes the handshake creates a socket in the state
+ *        eSYN_RECEIVED, and frees the entry.
+ */
+void test_pxTCPSynCacheAccept_CreatesSocket( void )
+{
+    FreeRTOS_Socket_t * pxResult;
+
+    vInstallStubs();
+    vMakePacket( 5000U, 1000U, 0U, pdTRUE );
+    ( void ) xTCPSynCacheAdd( &xListenSocket, &xNetworkBuffer, 777U );
+
+    vMakePacket( 5000U, 1001U, 778U, pdFALSE );
+    vExpectNewSocket();
+
+    pxResult = pxTCPSynCacheAccept( &xListenSocket, &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL_PTR( &xNewSocket, pxResult );
+    TEST_ASSERT_EQUAL( eSYN_RECEIVED, xNewSocket.u.xTCP.eTCPState );
+    TEST_ASSERT_EQUAL( TEST_REMOTE_IP, xNewSocket.u.xTCP.xRemoteIP.ulIP_IPv4 );
+    TEST_ASSERT_EQUAL( 5000U, xNewSocket.u.xTCP.usRemotePort );
+    TEST_ASSERT_EQUAL( 1400U, xNewSocket.u.xTCP.usMSS );
+    TEST_ASSERT_EQUAL( 1001U, xNewSocket.u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber );
+    TEST_ASSERT_EQUAL( 778U, xNewSocket.u.xTCP.xTCPWindow.tx.ulCurrentSequenceNumber );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xNewSocket.u.xTCP.bits.bWinScaling );
+    TEST_ASSERT_EQUAL( 3U, xNewSocket.u.xTCP.ucPeerWinScaleFactor );
+    TEST_ASSERT_EQUAL( 0U, xSynCache[ 0 ].ucFlags );
+}
+
+/**
+ * @brief An ACK with the wrong acknowledgement number does not create a socket.
+ */
+void test_pxTCPSynCacheAccept_WrongAck( void )
+{
+    FreeRTOS_Socket_t * pxResult;
+
+    vInstallStubs();
+    vMakePacket( 5000U, 1000U, 0U, pdTRUE );
+    ( void ) xTCPSynCacheAdd( &xListenSocket, &xNetworkBuffer, 777U );
+
+    vMakePacket( 5000U, 1001U, 779U, pdFALSE );
+
+    pxResult = pxTCPSynCacheAccept( &xListenSocket, &xNetworkBuffer );
+
+    TEST_ASSERT_NULL( pxResult );
+    TEST_ASSERT_NOT_EQUAL( 0U, xSynCache[ 0 ].ucFlags );
+}
+
+/**
+ * @brief No socket is created when the backlog of the listening socket is full.
+ */
+void test_pxTCPSynCacheAccept_BacklogFull( void )
+{
+    FreeRTOS_Socket_t * pxResult;
+
+    vInstallStubs();
+    vMakePacket( 5000U, 1000U, 0U, pdTRUE );
+    ( void ) xTCPSynCacheAdd( &xListenSocket, &xNetworkBuffer, 777U );
+
+    xListenSocket.u.xTCP.usChildCount = xListenSocket.u.xTCP.usBacklog;
+    vMakePacket( 5000U, 1001U, 778U, pdFALSE );
+
+    pxResult = pxTCPSynCacheAccept( &xListenSocket, &xNetworkBuffer );
+
+    TEST_ASSERT_NULL( pxResult );
+}
+
+/**
+ * @brief When the table is full, a SYN cookie is sent. A valid cookie creates
+ *        a socket without window scaling, a modified cookie is refused.
+ */
+void test_pxTCPSynCacheAccept_Cookie( void )
+{
+    const TCPPacket_t * pxSent = ( const TCPPacket_t * ) ucSentPacket;
+    FreeRTOS_Socket_t * pxResult;
+    uint32_t ulCookie;
+    uint16_t usPort;
+
+    vInstallStubs();
+
+    for( usPort = 6000U; usPort < ( 6000U + ipconfigTCP_SYN_CACHE_SIZE ); usPort++ )
+    {
+        vMakePacket( usPort, 50U, 0U, pdTRUE );
+        ( void ) xTCPSynCacheAdd( &xListenSocket, &xNetworkBuffer, 100U );
+    }
+
+    vMakePacket( 7000U, 3000U, 0U, pdTRUE );
+    TEST_ASSERT_EQUAL( pdTRUE, xTCPSynCacheAdd( &xListenSocket, &xNetworkBuffer, 100U ) );
+    ulCookie = ulSentInitialSequenceNumber();
+
+    /* No window scaling option. */
+    TEST_ASSERT_EQUAL( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + 8U, ulSentLength );
+    TEST_ASSERT_EQUAL( tcpTCP_OPT_SACK_P, pxSent->xTCPHeader.ucOptdata[ 6 ] );
+
+    vMakePacket( 7000U, 3001U, ulCookie + 2U, pdFALSE );
+    TEST_ASSERT_NULL( pxTCPSynCacheAccept( &xListenSocket, &xNetworkBuffer ) );
+
+    vMakePacket( 7001U, 3001U, ulCookie + 1U, pdFALSE );
+    TEST_ASSERT_NULL( pxTCPSynCacheAccept( &xListenSocket, &xNetworkBuffer ) );
+
+    xTickCount += pdMS_TO_TICKS( 10000U );
+    vMakePacket( 7000U, 3001U, ulCookie + 1U, pdFALSE );
+    vExpectNewSocket();
+
+    pxResult = pxTCPSynCacheAccept( &xListenSocket, &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL_PTR( &xNewSocket, pxResult );
+    TEST_ASSERT_EQUAL( 1400U, xNewSocket.u.xTCP.usMSS );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xNewSocket.u.xTCP.bits.bWinScaling );
+    TEST_ASSERT_EQUAL( 3001U, xNewSocket.u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber );
+}
+
+/**
+ * @brief A SYN cookie expires after two periods of 64 seconds.
+ */
+void test_pxTCPSynCacheAccept_CookieExpired( void )
+{
+    uint32_t ulCookie;
+    uint16_t usPort;
+
+    vInstallStubs();
+
+    for( usPort = 6000U; usPort < ( 6000U + ipconfigTCP_SYN_CACHE_SIZE ); usPort++ )
+    {
+        vMakePacket( usPort, 50U, 0U, pdTRUE );
+        ( void ) xTCPSynCacheAdd( &xListenSocket, &xNetworkBuffer, 100U );
+    }
+
+    vMakePacket( 7000U, 3000U, 0U, pdTRUE );
+    ( void ) xTCPSynCacheAdd( &xListenSocket, &xNetworkBuffer, 100U );
+    ulCookie = ulSentInitialSequenceNumber();
+
+    xTickCount += pdMS_TO_TICKS( 130000U );
+    vMakePacket( 7000U, 3001U, ulCookie + 1U, pdFALSE );
+
+    TEST_ASSERT_NULL( pxTCPSynCacheAccept( &xListenSocket, &xNetworkBuffer ) );
+}
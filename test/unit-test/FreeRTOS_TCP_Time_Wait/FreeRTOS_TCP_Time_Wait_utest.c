@@ -0,0 +1,451 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_task.h"
+#include "mock_list.h"
+#include "mock_queue.h"
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_Sockets.h"
+#include "mock_FreeRTOS_ARP.h"
+#include "mock_FreeRTOS_ND.h"
+#include "mock_FreeRTOS_TCP_Reception.h"
+#include "mock_FreeRTOS_TCP_Transmission.h"
+#include "mock_FreeRTOS_TCP_State_Handling.h"
+#include "mock_NetworkBufferManagement.h"
+
+#include "FreeRTOS_TCP_Time_Wait.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* ===========================  EXTERN VARIABLES  =========================== */
+
+extern TimeWaitEntry_t xTimeWaitTable[ ipconfigTCP_TIME_WAIT_SIZE ];
+
+/* The local port of the closed socket. */
+#define TEST_LOCAL_PORT      80U
+
+/* The IP-address of the peer, host-endian. */
+#define TEST_REMOTE_IP       0xC0A80105U
+
+/* The sequence number of our FIN. */
+#define TEST_OUR_FIN         5000U
+
+/* The next sequence number that is expected from the peer. */
+#define TEST_PEER_NEXT       9000U
+
+/* The IP-address of the end-point, network-endian. */
+#define TEST_LOCAL_IP        0x0A01A8C0U
+
+/* The time after which xTCPTimeWaitCheck() first sends our FIN again. */
+#define TEST_RESEND_TIME     pdMS_TO_TICKS( 1000U )
+
+/* The MAC-address of the peer in the ARP cache. */
+static const MACAddress_t xPeerMAC = { { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55 } };
+
+static FreeRTOS_Socket_t xSocket;
+static NetworkEndPoint_t xEndPoint;
+static NetworkBufferDescriptor_t xNetworkBuffer;
+static uint8_t ucEthernetBuffer[ ipconfigNETWORK_MTU ];
+
+/* The length of the TCP payload, as returned by prvCheckRxData(). */
+static BaseType_t xReceiveLength;
+
+/* The last packet passed to prvTCPReturnPacket(). */
+static uint8_t ucSentFlags;
+static uint32_t ulSentSequenceNumber;
+static uint32_t ulSentAckNr;
+static TickType_t xTickCount;
+
+/* ============================  Unity Fixtures  ============================ */
+
+void setUp( void )
+{
+    memset( xTimeWaitTable, 0, sizeof( xTimeWaitTable ) );
+    memset( &xSocket, 0, sizeof( xSocket ) );
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+    memset( &xEndPoint, 0, sizeof( xEndPoint ) );
+    xReceiveLength = 0;
+    ucSentFlags = 0U;
+    ulSentSequenceNumber = 0U;
+    ulSentAckNr = 0U;
+    xTickCount = 1000U;
+
+    xSocket.ucProtocol = ( uint8_t ) FREERTOS_IPPROTO_TCP;
+    xSocket.usLocalPort = TEST_LOCAL_PORT;
+    xSocket.u.xTCP.usRemotePort = 5000U;
+    xSocket.u.xTCP.xRemoteIP.ulIP_IPv4 = TEST_REMOTE_IP;
+    xSocket.u.xTCP.xTCPWindow.tx.ulFINSequenceNumber = TEST_OUR_FIN;
+    xSocket.u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber = TEST_PEER_NEXT;
+
+    xEndPoint.ipv4_settings.ulIPAddress = TEST_LOCAL_IP;
+    xSocket.pxEndPoint = &( xEndPoint );
+}
+
+/* ======================== Stub Callback Functions ========================= */
+
+static TickType_t xStubTaskGetTickCount( int NumCalls )
+{
+    return xTickCount;
+}
+
+static size_t uxStubIPHeaderSizePacket( const NetworkBufferDescriptor_t * pxBuffer,
+                                        int NumCalls )
+{
+    return ipSIZE_OF_IPv4_HEADER;
+}
+
+static BaseType_t xStubCheckRxData( const NetworkBufferDescriptor_t * pxBuffer,
+                                    uint8_t ** ppucRecvData,
+                                    int NumCalls )
+{
+    *ppucRecvData = &( pxBuffer->pucEthernetBuffer[ ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER ] );
+    return xReceiveLength;
+}
+
+/* The reply is sent with the sequence numbers swapped, so the header holds
+ * the ACK number in 'ulSequenceNumber' and our sequence number in 'ulAckNr'. */
+static void vStubTCPReturnPacket( FreeRTOS_Socket_t * pxSocket,
+                                  NetworkBufferDescriptor_t * pxDescriptor,
+                                  uint32_t ulLen,
+                                  BaseType_t xReleaseAfterSend,
+                                  int NumCalls )
+{
+    const TCPPacket_t * pxTCPPacket = ( const TCPPacket_t * ) pxDescriptor->pucEthernetBuffer;
+
+    TEST_ASSERT_EQUAL_PTR( NULL, pxSocket );
+    TEST_ASSERT_EQUAL( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER, ulLen );
+    TEST_ASSERT_EQUAL( pdFALSE, xReleaseAfterSend );
+    TEST_ASSERT_EQUAL( ipSIZE_OF_TCP_HEADER << 2, pxTCPPacket->xTCPHeader.ucTCPOffset );
+
+    ucSentFlags = pxTCPPacket->xTCPHeader.ucTCPFlags;
+    ulSentAckNr = FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulSequenceNumber );
+    ulSentSequenceNumber = FreeRTOS_ntohl( pxTCPPacket->xTCPHeader.ulAckNr );
+}
+
+/* ============================  Helper Functions  ========================== */
+
+static void vInstallStubs( void )
+{
+    xTaskGetTickCount_Stub( xStubTaskGetTickCount );
+    uxIPHeaderSizePacket_Stub( uxStubIPHeaderSizePacket );
+    prvCheckRxData_Stub( xStubCheckRxData );
+    prvTCPReturnPacket_Stub( vStubTCPReturnPacket );
+}
+
+/* Fill the network buffer with an IPv4 packet from the peer. */
+static void vMakePacket( uint16_t usRemotePort,
+                         uint8_t ucTCPFlags,
+                         uint32_t ulSequenceNumber,
+                         uint32_t ulAckNr )
+{
+    TCPPacket_t * pxTCPPacket = ( TCPPacket_t * ) ucEthernetBuffer;
+
+    memset( ucEthernetBuffer, 0, sizeof( ucEthernetBuffer ) );
+    pxTCPPacket->xIPHeader.ulSourceIPAddress = FreeRTOS_htonl( TEST_REMOTE_IP );
+    pxTCPPacket->xTCPHeader.usSourcePort = FreeRTOS_htons( usRemotePort );
+    pxTCPPacket->xTCPHeader.usDestinationPort = FreeRTOS_htons( TEST_LOCAL_PORT );
+    pxTCPPacket->xTCPHeader.ulSequenceNumber = FreeRTOS_htonl( ulSequenceNumber );
+    pxTCPPacket->xTCPHeader.ulAckNr = FreeRTOS_htonl( ulAckNr );
+    pxTCPPacket->xTCPHeader.ucTCPFlags = ucTCPFlags;
+    pxTCPPacket->xTCPHeader.ucTCPOffset = ipSIZE_OF_TCP_HEADER << 2;
+
+    xNetworkBuffer.pucEthernetBuffer = ucEthernetBuffer;
+    xNetworkBuffer.xDataLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER;
+}
+
+/* Record a socket in the state eLAST_ACK: the peer has closed first, and our
+ * FIN has not been acknowledged yet. */
+static void vAddLastAck( void )
+{
+    xSocket.u.xTCP.eTCPState = eLAST_ACK;
+    xSocket.u.xTCP.bits.bFinSent = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.bits.bFinAccepted = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.xTCPWindow.rx.ulFINSequenceNumber = TEST_PEER_NEXT - 1U;
+
+    TEST_ASSERT_EQUAL( pdTRUE, xTCPTimeWaitAdd( &xSocket ) );
+}
+
+/* Record a socket in the state eFIN_WAIT_2: our FIN has been acknowledged,
+ * and the peer has not closed yet. */
+static void vAddFinWait2( void )
+{
+    xSocket.u.xTCP.eTCPState = eFIN_WAIT_2;
+    xSocket.u.xTCP.bits.bFinSent = pdTRUE_UNSIGNED;
+    xSocket.u.xTCP.bits.bFinAcked = pdTRUE_UNSIGNED;
+
+    TEST_ASSERT_EQUAL( pdTRUE, xTCPTimeWaitAdd( &xSocket ) );
+}
+
+/* ==============================  Test Cases  ============================== */
+
+/**
+ * @brief Only a socket that has sent a FIN and is closing is recorded.
+ */
+void test_xTCPTimeWaitAdd_NotClosing( void )
+{
+    vInstallStubs();
+
+    xSocket.u.xTCP.eTCPState = eESTABLISHED;
+    xSocket.u.xTCP.bits.bFinSent = pdTRUE_UNSIGNED;
+    TEST_ASSERT_EQUAL( pdFALSE, xTCPTimeWaitAdd( &xSocket ) );
+
+    /* The peer has closed, but we never sent a FIN: an abortive close. */
+    xSocket.u.xTCP.eTCPState = eCLOSE_WAIT;
+    xSocket.u.xTCP.bits.bFinSent = pdFALSE_UNSIGNED;
+    TEST_ASSERT_EQUAL( pdFALSE, xTCPTimeWaitAdd( &xSocket ) );
+
+    TEST_ASSERT_EQUAL( 0U, xTimeWaitTable[ 0 ].ucFlags );
+}
+
+/**
+ * @brief A packet of an unknown connection is left to the caller.
+ */
+void test_xTCPTimeWaitProcess_UnknownConnection( void )
+{
+    vInstallStubs();
+    vAddLastAck();
+
+    vMakePacket( 5001U, tcpTCP_FLAG_ACK | tcpTCP_FLAG_FIN, TEST_PEER_NEXT - 1U, TEST_OUR_FIN );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xTCPTimeWaitProcess( &xNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( 0U, ucSentFlags );
+}
+
+/**
+ * @brief In eLAST_ACK, a retransmitted FIN of the peer is answered with our
+ *        FIN again. Once our FIN is acknowledged, a plain ACK is sent.
+ */
+void test_xTCPTimeWaitProcess_LastAck( void )
+{
+    vInstallStubs();
+    vAddLastAck();
+
+    vMakePacket( 5000U, tcpTCP_FLAG_ACK | tcpTCP_FLAG_FIN, TEST_PEER_NEXT - 1U, TEST_OUR_FIN );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xTCPTimeWaitProcess( &xNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( tcpTCP_FLAG_ACK | tcpTCP_FLAG_FIN, ucSentFlags );
+    TEST_ASSERT_EQUAL( TEST_OUR_FIN, ulSentSequenceNumber );
+    TEST_ASSERT_EQUAL( TEST_PEER_NEXT, ulSentAckNr );
+
+    /* The final ACK is dropped silently. */
+    ucSentFlags = 0U;
+    vMakePacket( 5000U, tcpTCP_FLAG_ACK, TEST_PEER_NEXT, TEST_OUR_FIN + 1U );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xTCPTimeWaitProcess( &xNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( 0U, ucSentFlags );
+
+    vMakePacket( 5000U, tcpTCP_FLAG_ACK | tcpTCP_FLAG_FIN, TEST_PEER_NEXT - 1U, TEST_OUR_FIN + 1U );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xTCPTimeWaitProcess( &xNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( tcpTCP_FLAG_ACK, ucSentFlags );
+    TEST_ASSERT_EQUAL( TEST_OUR_FIN + 1U, ulSentSequenceNumber );
+}
+
+/**
+ * @brief In eFIN_WAIT_2, the FIN of the peer is acknowledged, but data can
+ *        not be delivered anymore.
+ */
+void test_xTCPTimeWaitProcess_FinWait2( void )
+{
+    vInstallStubs();
+    vAddFinWait2();
+
+    vMakePacket( 5000U, tcpTCP_FLAG_ACK | tcpTCP_FLAG_FIN, TEST_PEER_NEXT, TEST_OUR_FIN + 1U );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xTCPTimeWaitProcess( &xNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( tcpTCP_FLAG_ACK, ucSentFlags );
+    TEST_ASSERT_EQUAL( TEST_OUR_FIN + 1U, ulSentSequenceNumber );
+    TEST_ASSERT_EQUAL( TEST_PEER_NEXT + 1U, ulSentAckNr );
+
+    /* Start again, now the peer sends data. */
+    setUp();
+    vAddFinWait2();
+    vMakePacket( 5000U, tcpTCP_FLAG_ACK, TEST_PEER_NEXT, TEST_OUR_FIN + 1U );
+    xReceiveLength = 100;
+
+    TEST_ASSERT_EQUAL( pdFALSE, xTCPTimeWaitProcess( &xNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( 0U, ucSentFlags );
+    TEST_ASSERT_EQUAL( 0U, xTimeWaitTable[ 0 ].ucFlags );
+}
+
+/**
+ * @brief A RST removes the entry. A new SYN removes it too, and is left to
+ *        the listening socket.
+ */
+void test_xTCPTimeWaitProcess_RstAndSyn( void )
+{
+    vInstallStubs();
+    vAddLastAck();
+
+    vMakePacket( 5000U, tcpTCP_FLAG_RST, TEST_PEER_NEXT, 0U );
+    TEST_ASSERT_EQUAL( pdTRUE, xTCPTimeWaitProcess( &xNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( 0U, xTimeWaitTable[ 0 ].ucFlags );
+
+    vAddLastAck();
+
+    vMakePacket( 5000U, tcpTCP_FLAG_SYN, 123456U, 0U );
+    TEST_ASSERT_EQUAL( pdFALSE, xTCPTimeWaitProcess( &xNetworkBuffer ) );
+    TEST_ASSERT_EQUAL( 0U, xTimeWaitTable[ 0 ].ucFlags );
+    TEST_ASSERT_EQUAL( 0U, ucSentFlags );
+}
+
+/**
+ * @brief An entry is forgotten after ipconfigTCP_TIME_WAIT_SECONDS, and when
+ *        the table is full the oldest entry is replaced.
+ */
+void test_xTCPTimeWaitAdd_ExpiryAndReplacement( void )
+{
+    size_t uxIndex;
+
+    vInstallStubs();
+    vAddLastAck();
+
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_TIME_WAIT_SECONDS * 1000U );
+    vMakePacket( 5000U, tcpTCP_FLAG_ACK | tcpTCP_FLAG_FIN, TEST_PEER_NEXT - 1U, TEST_OUR_FIN );
+
+    TEST_ASSERT_EQUAL( pdFALSE, xTCPTimeWaitProcess( &xNetworkBuffer ) );
+
+    /* Fill the table, the first connection is the oldest. */
+    for( uxIndex = 0U; uxIndex <= ( size_t ) ipconfigTCP_TIME_WAIT_SIZE; uxIndex++ )
+    {
+        xSocket.u.xTCP.usRemotePort = ( uint16_t ) ( 6000U + uxIndex );
+        vAddLastAck();
+        xTickCount++;
+    }
+
+    vMakePacket( 6000U, tcpTCP_FLAG_ACK | tcpTCP_FLAG_FIN, TEST_PEER_NEXT - 1U, TEST_OUR_FIN );
+    TEST_ASSERT_EQUAL( pdFALSE, xTCPTimeWaitProcess( &xNetworkBuffer ) );
+
+    vMakePacket( ( uint16_t ) ( 6000U + ipconfigTCP_TIME_WAIT_SIZE ), tcpTCP_FLAG_ACK | tcpTCP_FLAG_FIN, TEST_PEER_NEXT - 1U, TEST_OUR_FIN );
+    TEST_ASSERT_EQUAL( pdTRUE, xTCPTimeWaitProcess( &xNetworkBuffer ) );
+}
+
+/**
+ * @brief Our FIN is sent again from the timer until it is acknowledged, the
+ *        interval doubles with every repetition.
+ */
+void test_xTCPTimeWaitCheck_ResendsFIN( void )
+{
+    const TCPPacket_t * pxTCPPacket = ( const TCPPacket_t * ) ucEthernetBuffer;
+
+    vInstallStubs();
+    vAddLastAck();
+
+    TEST_ASSERT_EQUAL( TEST_RESEND_TIME, xTCPTimeWaitCheck() );
+    TEST_ASSERT_EQUAL( 0U, ucSentFlags );
+
+    xTickCount += TEST_RESEND_TIME;
+    xNetworkBuffer.pucEthernetBuffer = ucEthernetBuffer;
+    xNetworkBuffer.xDataLength = ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER;
+    eARPGetCacheEntry_ExpectAnyArgsAndReturn( eResolutionCacheHit );
+    eARPGetCacheEntry_ReturnThruPtr_pxMACAddress( &xPeerMAC );
+    pxGetNetworkBufferWithDescriptor_ExpectAndReturn( ipSIZE_OF_ETH_HEADER + ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER, 0U, &xNetworkBuffer );
+    vReleaseNetworkBufferAndDescriptor_Expect( &xNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( 2U * TEST_RESEND_TIME, xTCPTimeWaitCheck() );
+    TEST_ASSERT_EQUAL( tcpTCP_FLAG_ACK | tcpTCP_FLAG_FIN, ucSentFlags );
+    TEST_ASSERT_EQUAL( TEST_OUR_FIN, ulSentSequenceNumber );
+    TEST_ASSERT_EQUAL( TEST_PEER_NEXT, ulSentAckNr );
+    TEST_ASSERT_EQUAL_PTR( &( xEndPoint ), xNetworkBuffer.pxEndPoint );
+
+    /* The packet looks like it came from the peer, prvTCPReturnPacket()
+     * swaps the addresses and the ports. */
+    TEST_ASSERT_EQUAL( ipIPv4_FRAME_TYPE, pxTCPPacket->xEthernetHeader.usFrameType );
+    TEST_ASSERT_EQUAL_MEMORY( xPeerMAC.ucBytes, pxTCPPacket->xEthernetHeader.xSourceAddress.ucBytes, ipMAC_ADDRESS_LENGTH_BYTES );
+    TEST_ASSERT_EQUAL( FreeRTOS_htonl( TEST_REMOTE_IP ), pxTCPPacket->xIPHeader.ulSourceIPAddress );
+    TEST_ASSERT_EQUAL( TEST_LOCAL_IP, pxTCPPacket->xIPHeader.ulDestinationIPAddress );
+    TEST_ASSERT_EQUAL( FreeRTOS_htons( 5000U ), pxTCPPacket->xTCPHeader.usSourcePort );
+    TEST_ASSERT_EQUAL( FreeRTOS_htons( TEST_LOCAL_PORT ), pxTCPPacket->xTCPHeader.usDestinationPort );
+
+    /* Not yet time for the next repetition. */
+    ucSentFlags = 0U;
+    xTickCount += ( 2U * TEST_RESEND_TIME ) - 1U;
+
+    TEST_ASSERT_EQUAL( 1U, xTCPTimeWaitCheck() );
+    TEST_ASSERT_EQUAL( 0U, ucSentFlags );
+
+    /* Once the peer has acknowledged our FIN, the timer leaves it alone. */
+    vMakePacket( 5000U, tcpTCP_FLAG_ACK, TEST_PEER_NEXT, TEST_OUR_FIN + 1U );
+    TEST_ASSERT_EQUAL( pdTRUE, xTCPTimeWaitProcess( &xNetworkBuffer ) );
+
+    xTickCount += TEST_RESEND_TIME;
+    TEST_ASSERT_EQUAL( portMAX_DELAY, xTCPTimeWaitCheck() );
+    TEST_ASSERT_EQUAL( 0U, ucSentFlags );
+}
+
+/**
+ * @brief The timer does not send anything for an acknowledged FIN, and it
+ *        releases the entries that have expired.
+ */
+void test_xTCPTimeWaitCheck_NothingToSend( void )
+{
+    vInstallStubs();
+    vAddFinWait2();
+
+    /* Without an end-point, our FIN can not be sent again. */
+    xSocket.u.xTCP.usRemotePort = 5001U;
+    xSocket.pxEndPoint = NULL;
+    vAddLastAck();
+
+    xTickCount += TEST_RESEND_TIME;
+    TEST_ASSERT_EQUAL( portMAX_DELAY, xTCPTimeWaitCheck() );
+    TEST_ASSERT_EQUAL( 0U, ucSentFlags );
+
+    xTickCount += pdMS_TO_TICKS( ipconfigTCP_TIME_WAIT_SECONDS * 1000U );
+    TEST_ASSERT_EQUAL( portMAX_DELAY, xTCPTimeWaitCheck() );
+    TEST_ASSERT_EQUAL( 0U, xTimeWaitTable[ 0 ].ucFlags );
+    TEST_ASSERT_EQUAL( 0U, xTimeWaitTable[ 1 ].ucFlags );
+}
+
+/**
+ * @brief Our FIN is not sent again while the peer is missing from the ARP
+ *        cache, because the MAC-address that it would be sent to is unknown.
+ */
+void test_xTCPTimeWaitCheck_ARPMiss( void )
+{
+    vInstallStubs();
+    vAddLastAck();
+
+    xTickCount += TEST_RESEND_TIME;
+    eARPGetCacheEntry_ExpectAnyArgsAndReturn( eResolutionCacheMiss );
+
+    TEST_ASSERT_EQUAL( 2U * TEST_RESEND_TIME, xTCPTimeWaitCheck() );
+    TEST_ASSERT_EQUAL( 0U, ucSentFlags );
+    TEST_ASSERT_NOT_EQUAL( 0U, xTimeWaitTable[ 0 ].ucFlags );
+}
@@ -0,0 +1,251 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/*#include "mock_task.h" */
+#include "mock_list.h"
+
+/* This must come after list.h is included (in this case, indirectly
+ * by mock_list.h). */
+#include "mock_queue.h"
+#include "mock_event_groups.h"
+#include "mock_task.h"
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_FreeRTOS_IP_Private.h"
+#include "mock_FreeRTOS_IP_Utils.h"
+#include "mock_FreeRTOS_IP_Timers.h"
+#include "mock_NetworkBufferManagement.h"
+#include "mock_NetworkInterface.h"
+#include "mock_FreeRTOS_Sockets.h"
+#include "mock_FreeRTOS_Stream_Buffer.h"
+#include "mock_FreeRTOS_TCP_WIN.h"
+#include "mock_FreeRTOS_UDP_IP.h"
+#include "mock_FreeRTOS_ARP.h"
+#include "mock_FreeRTOS_TCP_State_Handling.h"
+#include "mock_FreeRTOS_TCP_Reception.h"
+#include "mock_FreeRTOS_TCP_Utils.h"
+#include "mock_FreeRTOS_TCP_WIN.h"
+#include "mock_TCP_Transmission_DiffConfig_list_macros.h"
+
+#include "FreeRTOS_TCP_IP.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSIPConfig.h"
+#include "FreeRTOSIPConfigDefaults.h"
+
+#include "FreeRTOS_TCP_Transmission_DiffConfig_stubs.c"
+#include "FreeRTOS_TCP_Transmission.h"
+
+/* =========================== EXTERN VARIABLES =========================== */
+
+FreeRTOS_Socket_t xSocket, * pxSocket;
+NetworkBufferDescriptor_t xNetworkBuffer, * pxNetworkBuffer;
+uint8_t ucEthernetBuffer[ ipconfigNETWORK_MTU ] =
+{
+    0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x08, 0x00, 0x45, 0x00,
+    0x00, 0x34, 0x15, 0xc2, 0x40, 0x00, 0x40, 0x06, 0xa8, 0x8e, 0xc0, 0xa8, 0x00, 0x08, 0xac, 0xd9,
+    0x0e, 0xea, 0xea, 0xfe, 0x01, 0xbb, 0x8b, 0xaf, 0x8a, 0x24, 0xdc, 0x96, 0x95, 0x7a, 0x80, 0x10,
+    0x01, 0xf5, 0x7c, 0x9a, 0x00, 0x00, 0x01, 0x01, 0x08, 0x0a, 0xb8, 0x53, 0x57, 0x27, 0xb2, 0xce,
+    0xc3, 0x17
+};
+
+/* ============================ Test Helpers ============================ */
+
+/**
+ * @brief Prepare a connected IPv4 socket which has negotiated time-stamps, and
+ *        a network buffer that holds a received segment with the option.
+ */
+static void prvPrepareTimestampSocket( struct xNetworkEndPoint * pxEndPoint )
+{
+    pxSocket = &xSocket;
+    pxNetworkBuffer = &xNetworkBuffer;
+
+    memset( &xSocket, 0, sizeof( xSocket ) );
+    memset( &xNetworkBuffer, 0, sizeof( xNetworkBuffer ) );
+
+    pxNetworkBuffer->pucEthernetBuffer = ucEthernetBuffer;
+    pxNetworkBuffer->xDataLength = sizeof( ucEthernetBuffer );
+    pxNetworkBuffer->pxEndPoint = pxEndPoint;
+
+    pxSocket->pxEndPoint = pxEndPoint;
+    pxSocket->u.xTCP.eTCPState = eESTABLISHED;
+    pxSocket->u.xTCP.usMSS = 1000;
+    pxSocket->u.xTCP.uxRxStreamSize = 1500;
+    pxSocket->u.xTCP.bits.bTimeStamps = pdTRUE_UNSIGNED;
+    pxSocket->u.xTCP.xTCPWindow.xSize.ulRxWindowLength = 1500;
+    pxSocket->u.xTCP.xTCPWindow.ulOurSequenceNumber = 0x11223344U;
+    pxSocket->u.xTCP.xTCPWindow.rx.ulCurrentSequenceNumber = 0x55667788U;
+    pxSocket->u.xTCP.xTCPWindow.xTimeStamps.ulTSRecent = 0xA1B2C3D4U;
+
+    NetworkInterfaceOutputFunction_Stub_Called = 0;
+    pxNetworkInterfaceOutputBuffer = NULL;
+
+    uxIPHeaderSizeSocket_IgnoreAndReturn( ipSIZE_OF_IPv4_HEADER );
+    uxIPHeaderSizePacket_IgnoreAndReturn( ipSIZE_OF_IPv4_HEADER );
+}
+
+/**
+ * @brief Check that the time-stamp option was written at 'uxOffset' of the
+ *        options, with TSval 0x01020304 and TSecr 0xA1B2C3D4.
+ */
+static void prvCheckTimestampOption( const TCPHeader_t * pxTCPHeader,
+                                     size_t uxOffset )
+{
+    const uint8_t ucExpected[ tcpTCP_OPT_TIMESTAMP_SPACE ] =
+    {
+        tcpTCP_OPT_NOOP,      tcpTCP_OPT_NOOP, tcpTCP_OPT_TIMESTAMP, tcpTCP_OPT_TIMESTAMP_LEN,
+        0x01,                 0x02,            0x03,                 0x04,
+        0xA1,                 0xB2,            0xC3,                 0xD4
+    };
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY( ucExpected, &( pxTCPHeader->ucOptdata[ uxOffset ] ), tcpTCP_OPT_TIMESTAMP_SPACE );
+}
+
+/* ============================== Test Cases ============================== */
+
+/**
+ * @brief The ACK that is sent when PAWS drops a segment carries the time-stamp
+ *        option, with TSecr set to TS.Recent.
+ */
+void test_prvTCPSendTimestampAck_CarriesTimestamp( void )
+{
+    struct xNetworkEndPoint xEndPoint = { 0 };
+    struct xNetworkInterface xInterface;
+    struct xNetworkEndPoint * pxEndPoint = &xEndPoint;
+    TCPPacket_t * pxTCPPacket = ( TCPPacket_t * ) ucEthernetBuffer;
+
+    xEndPoint.pxNetworkInterface = &xInterface;
+    xEndPoint.pxNetworkInterface->pfOutput = &NetworkInterfaceOutputFunction_Stub;
+    prvPrepareTimestampSocket( &xEndPoint );
+
+    /* The dropped segment was a PSH+ACK. */
+    pxTCPPacket->xTCPHeader.ucTCPFlags = tcpTCP_FLAG_PSH | tcpTCP_FLAG_ACK;
+
+    ulTCPWindowTimestamp_ExpectAndReturn( 0x01020304U );
+    FreeRTOS_min_uint32_ExpectAnyArgsAndReturn( 1500 );
+    eARPGetCacheEntry_ExpectAnyArgsAndReturn( eResolutionCacheHit );
+    eARPGetCacheEntry_ReturnThruPtr_ppxEndPoint( &pxEndPoint );
+    usGenerateChecksum_ExpectAnyArgsAndReturn( 0x1111 );
+    usGenerateProtocolChecksum_ExpectAnyArgsAndReturn( 0x2222 );
+
+    prvTCPSendTimestampAck( pxSocket, pxNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( 1, NetworkInterfaceOutputFunction_Stub_Called );
+    TEST_ASSERT_EQUAL_PTR( pxNetworkBuffer, pxNetworkInterfaceOutputBuffer );
+    TEST_ASSERT_EQUAL_UINT8( tcpTCP_FLAG_ACK, pxTCPPacket->xTCPHeader.ucTCPFlags );
+    TEST_ASSERT_EQUAL_UINT8( ( ipSIZE_OF_TCP_HEADER + tcpTCP_OPT_TIMESTAMP_SPACE ) << 2, pxTCPPacket->xTCPHeader.ucTCPOffset );
+    TEST_ASSERT_EQUAL_UINT16( FreeRTOS_htons( ipSIZE_OF_IPv4_HEADER + ipSIZE_OF_TCP_HEADER + tcpTCP_OPT_TIMESTAMP_SPACE ),
+                              pxTCPPacket->xIPHeader.usLength );
+    TEST_ASSERT_EQUAL_UINT32( FreeRTOS_htonl( 0x11223344U ), pxTCPPacket->xTCPHeader.ulSequenceNumber );
+    TEST_ASSERT_EQUAL_UINT32( FreeRTOS_htonl( 0x55667788U ), pxTCPPacket->xTCPHeader.ulAckNr );
+    prvCheckTimestampOption( &( pxTCPPacket->xTCPHeader ), 0U );
+}
+
+/**
+ * @brief When SACK options are pending, the time-stamp option follows them.
+ */
+void test_prvTCPSendTimestampAck_AfterSackOption( void )
+{
+    struct xNetworkEndPoint xEndPoint = { 0 };
+    struct xNetworkInterface xInterface;
+    struct xNetworkEndPoint * pxEndPoint = &xEndPoint;
+    TCPPacket_t * pxTCPPacket = ( TCPPacket_t * ) ucEthernetBuffer;
+    TCPWindow_t * pxTCPWindow;
+    const size_t uxSackLength = 12U;
+
+    xEndPoint.pxNetworkInterface = &xInterface;
+    xEndPoint.pxNetworkInterface->pfOutput = &NetworkInterfaceOutputFunction_Stub;
+    prvPrepareTimestampSocket( &xEndPoint );
+
+    pxTCPWindow = &( pxSocket->u.xTCP.xTCPWindow );
+    pxTCPWindow->ucOptionLength = ( uint8_t ) uxSackLength;
+    pxTCPWindow->ulOptionsData[ 0 ] = FreeRTOS_htonl( 0x0101050aU );
+    pxTCPWindow->ulOptionsData[ 1 ] = FreeRTOS_htonl( 0x55667800U );
+    pxTCPWindow->ulOptionsData[ 2 ] = FreeRTOS_htonl( 0x55667900U );
+
+    ulTCPWindowTimestamp_ExpectAndReturn( 0x01020304U );
+    FreeRTOS_min_uint32_ExpectAnyArgsAndReturn( 1500 );
+    eARPGetCacheEntry_ExpectAnyArgsAndReturn( eResolutionCacheHit );
+    eARPGetCacheEntry_ReturnThruPtr_ppxEndPoint( &pxEndPoint );
+    usGenerateChecksum_ExpectAnyArgsAndReturn( 0x1111 );
+    usGenerateProtocolChecksum_ExpectAnyArgsAndReturn( 0x2222 );
+
+    prvTCPSendTimestampAck( pxSocket, pxNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( 1, NetworkInterfaceOutputFunction_Stub_Called );
+    TEST_ASSERT_EQUAL_UINT8( ( ipSIZE_OF_TCP_HEADER + uxSackLength + tcpTCP_OPT_TIMESTAMP_SPACE ) << 2, pxTCPPacket->xTCPHeader.ucTCPOffset );
+    TEST_ASSERT_EQUAL_MEMORY( pxTCPWindow->ulOptionsData, pxTCPPacket->xTCPHeader.ucOptdata, uxSackLength );
+    prvCheckTimestampOption( &( pxTCPPacket->xTCPHeader ), uxSackLength );
+}
+
+/**
+ * @brief prvSetOptions() adds the time-stamp option to every segment of a
+ *        connection that has negotiated it.
+ */
+void test_prvSetOptions_Timestamps( void )
+{
+    UBaseType_t uxOptionsLength;
+    TCPPacket_t * pxTCPPacket = ( TCPPacket_t * ) ucEthernetBuffer;
+
+    prvPrepareTimestampSocket( NULL );
+
+    ulTCPWindowTimestamp_ExpectAndReturn( 0x01020304U );
+
+    uxOptionsLength = prvSetOptions( pxSocket, pxNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( tcpTCP_OPT_TIMESTAMP_SPACE, uxOptionsLength );
+    TEST_ASSERT_EQUAL_UINT8( ( ipSIZE_OF_TCP_HEADER + tcpTCP_OPT_TIMESTAMP_SPACE ) << 2, pxTCPPacket->xTCPHeader.ucTCPOffset );
+    prvCheckTimestampOption( &( pxTCPPacket->xTCPHeader ), 0U );
+}
+
+/**
+ * @brief Without a negotiated time-stamp option, prvSetOptions() writes nothing.
+ */
+void test_prvSetOptions_NoTimestamps( void )
+{
+    UBaseType_t uxOptionsLength;
+    TCPPacket_t * pxTCPPacket = ( TCPPacket_t * ) ucEthernetBuffer;
+
+    prvPrepareTimestampSocket( NULL );
+    pxSocket->u.xTCP.bits.bTimeStamps = pdFALSE_UNSIGNED;
+    pxTCPPacket->xTCPHeader.ucTCPOffset = tcpTCP_OFFSET_STANDARD_LENGTH;
+
+    uxOptionsLength = prvSetOptions( pxSocket, pxNetworkBuffer );
+
+    TEST_ASSERT_EQUAL( 0U, uxOptionsLength );
+    TEST_ASSERT_EQUAL_UINT8( tcpTCP_OFFSET_STANDARD_LENGTH, pxTCPPacket->xTCPHeader.ucTCPOffset );
+}
@@ -1864,6 +1864,44 @@ void test_ulTCPWindowTxGet_empty_wait_queue_4( void )
     TEST_ASSERT_EQUAL( 0, ulReturn );
 }
 
+/**
+ * @brief Nagle algorithm: a small segment is held back while sent data
+ *        has not been acknowledged.
+ */
+void test_ulTCPWindowTxGet_Nagle_HoldSmallSegment( void )
+{
+    uint32_t ulReturn;
+    TCPWindow_t xWindow = { 0 };
+    uint32_t ulWindowSize = 300;
+    int32_t lPosition = 0;
+    TCPSegment_t mockSegment = { 0 };
+    ListItem_t mockListItem;
+
+    mockSegment.lDataLength = 100;
+    mockSegment.lMaxLength = 400;
+    xWindow.pxHeadSegment = &mockSegment;
+    xWindow.u.bits.bNagle = pdTRUE_UNSIGNED;
+
+    /* -> xTCPWindowGetHead */
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdTRUE );
+    /* -> pxTCPWindowTx_GetWaitQueue */
+    /* --> xTCPWindowPeekHead */
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdTRUE );
+    /* -> pxTCPWindowTx_GetTXQueue */
+    /* --> xTCPWindowPeekHead */
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdFALSE );
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &mockListItem );
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &mockSegment );
+    /* --> The waiting queue is not empty: data is outstanding. */
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdFALSE );
+
+    ulReturn = ulTCPWindowTxGet( &xWindow,
+                                 ulWindowSize,
+                                 &lPosition );
+    TEST_ASSERT_EQUAL( 0, ulReturn );
+    TEST_ASSERT_EQUAL_PTR( &mockSegment, xWindow.pxHeadSegment );
+}
+
 void test_ulTCPWindowTxGet_empty_wait_queue_5( void )
 {
     uint32_t ulReturn;
@@ -0,0 +1,163 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+/*
+ * Micro-benchmark of the segment index, built only when UNITTEST_BENCHMARKS
+ * is ON.  It is not registered with CTest: the timings depend on the
+ * machine and its load, so they are printed, not checked.
+ */
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "FreeRTOS.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSConfig.h"
+#include "FreeRTOSIPConfig.h"
+
+#include "FreeRTOS_TCP_WIN.h"
+
+#include "mock_list.h"
+#include "mock_TCP_WIN_DiffConfig_list_macros.h"
+#include "mock_portable.h"
+#include "mock_FreeRTOS_IP.h"
+#include "mock_task.h"
+
+/* The MSS of the segments. */
+#define BENCHMARK_MSS            1000U
+
+/* The number of segments, as in a window with ipconfigTCP_WIN_SEG_COUNT
+ * set to 256. */
+#define BENCHMARK_SEGMENTS       256U
+
+/* The number of look-ups done by each method. */
+#define BENCHMARK_LOOKUPS        200000U
+
+void prvTCPWindowIndexInsert( TCPSegment_t ** ppxRoot,
+                              TCPSegment_t * pxSegment );
+TCPSegment_t * prvTCPWindowIndexLowerBound( TCPSegment_t * pxRoot,
+                                            uint32_t ulSequenceNumber );
+
+/* Give 'uxCount' segments of one MSS each consecutive sequence numbers,
+ * starting at 'ulFirst'. */
+static void prvPrepareIndexSegments( TCPSegment_t * pxSegments,
+                                     size_t uxCount,
+                                     uint32_t ulFirst )
+{
+    size_t uxIndex;
+
+    memset( pxSegments, 0, uxCount * sizeof( *pxSegments ) );
+
+    for( uxIndex = 0U; uxIndex < uxCount; uxIndex++ )
+    {
+        pxSegments[ uxIndex ].ulSequenceNumber = ulFirst + ( ( uint32_t ) uxIndex * BENCHMARK_MSS );
+        pxSegments[ uxIndex ].lDataLength = ( int32_t ) BENCHMARK_MSS;
+    }
+}
+
+/* Convert a number of clock ticks to microseconds. */
+static unsigned long prvClockToMicroseconds( clock_t xTicks )
+{
+    return ( unsigned long ) ( ( ( uint64_t ) xTicks * 1000000U ) / CLOCKS_PER_SEC );
+}
+
+/* Look up out-of-order segments in a window with 256 of them, once by
+ * walking the segments in order of arrival, like the list based
+ * xTCPWindowRxFind() does, and once through the index. */
+void test_prvTCPWindowIndex_MicroBenchmark( void )
+{
+    static TCPSegment_t xSegments[ BENCHMARK_SEGMENTS ];
+    static TCPSegment_t * pxArrival[ BENCHMARK_SEGMENTS ];
+    TCPSegment_t * pxRoot = NULL;
+    TCPSegment_t * pxFound;
+    uint32_t ulFirst = 0xFFFF0000U;
+    uint32_t ulSequenceNumber;
+    uint32_t ulLookup;
+    size_t uxIndex;
+    size_t uxChecksum[ 2 ] = { 0U, 0U };
+    clock_t xLinearTime;
+    clock_t xIndexTime;
+
+    prvPrepareIndexSegments( xSegments, BENCHMARK_SEGMENTS, ulFirst );
+
+    for( uxIndex = 0U; uxIndex < BENCHMARK_SEGMENTS; uxIndex++ )
+    {
+        pxArrival[ uxIndex ] = &( xSegments[ ( uxIndex * 37U ) % BENCHMARK_SEGMENTS ] );
+        prvTCPWindowIndexInsert( &pxRoot, pxArrival[ uxIndex ] );
+    }
+
+    xLinearTime = clock();
+
+    for( ulLookup = 0U; ulLookup < BENCHMARK_LOOKUPS; ulLookup++ )
+    {
+        ulSequenceNumber = ulFirst + ( ( ( ulLookup * 97U ) % BENCHMARK_SEGMENTS ) * BENCHMARK_MSS );
+        pxFound = NULL;
+
+        for( uxIndex = 0U; uxIndex < BENCHMARK_SEGMENTS; uxIndex++ )
+        {
+            if( pxArrival[ uxIndex ]->ulSequenceNumber == ulSequenceNumber )
+            {
+                pxFound = pxArrival[ uxIndex ];
+                break;
+            }
+        }
+
+        uxChecksum[ 0 ] += ( size_t ) ( pxFound - xSegments );
+    }
+
+    xLinearTime = clock() - xLinearTime;
+    xIndexTime = clock();
+
+    for( ulLookup = 0U; ulLookup < BENCHMARK_LOOKUPS; ulLookup++ )
+    {
+        ulSequenceNumber = ulFirst + ( ( ( ulLookup * 97U ) % BENCHMARK_SEGMENTS ) * BENCHMARK_MSS );
+        pxFound = prvTCPWindowIndexLowerBound( pxRoot, ulSequenceNumber );
+
+        uxChecksum[ 1 ] += ( size_t ) ( pxFound - xSegments );
+    }
+
+    xIndexTime = clock() - xIndexTime;
+
+    printf( "Segment index: %u look-ups among %u segments: linear %lu us, index %lu us\n",
+            ( unsigned ) BENCHMARK_LOOKUPS,
+            ( unsigned ) BENCHMARK_SEGMENTS,
+            prvClockToMicroseconds( xLinearTime ),
+            prvClockToMicroseconds( xIndexTime ) );
+
+    /* Both methods found the same segments, so the look-ups were not
+     * optimised away. */
+    TEST_ASSERT_EQUAL( uxChecksum[ 0 ], uxChecksum[ 1 ] );
+}
@@ -0,0 +1,1932 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "FreeRTOS.h"
+
+#include "catch_assert.h"
+
+#include "FreeRTOSConfig.h"
+#include "FreeRTOSIPConfig.h"
+
+#include "FreeRTOS_TCP_WIN.h"
+
+#include "mock_list.h"
+#include "mock_TCP_WIN_DiffConfig_list_macros.h"
+#include "mock_portable.h"
+#include "mock_FreeRTOS_IP.h"
+#include "mock_task.h"
+
+#define winSRTT_INCREMENT_NEW        2 /**< New increment for the smoothed RTT. */
+#define winSRTT_INCREMENT_CURRENT    6 /**< Current increment for the smoothed RTT. */
+#define winSRTT_DECREMENT_NEW        1 /**< New decrement for the smoothed RTT. */
+#define winSRTT_DECREMENT_CURRENT    7 /**< Current decrement for the smoothed RTT. */
+
+/* The MSS used in all tests. */
+#define TEST_MSS                   1000U
+
+/* The size of the transmission window used in all tests. */
+#define TEST_TX_WINDOW_LENGTH      ( 64U * TEST_MSS )
+
+/* The number of round-trips that are simulated after an induced loss. */
+#define TEST_ROUND_TRIP_COUNT      12U
+
+/* The size of the transmission window in the CUBIC tests, large enough
+ * to let cwnd grow beyond W_max. */
+#define TEST_CUBIC_WINDOW_LENGTH   ( 400U * TEST_MSS )
+
+/* The number of segments in the segment index tests, as in a window with
+ * ipconfigTCP_WIN_SEG_COUNT set to 256. */
+#define TEST_INDEX_SEGMENTS        256U
+
+void prvTCPWindowCongestionInit( TCPWindow_t * pxWindow );
+void prvTCPWindowCongestionOnAck( TCPWindow_t * pxWindow,
+                                  uint32_t ulBytesAcked );
+void prvTCPWindowCongestionOnDupAck( TCPWindow_t * pxWindow,
+                                     uint32_t ulRetransmitCount );
+void prvTCPWindowCongestionOnTimeout( TCPWindow_t * pxWindow,
+                                      BaseType_t xFirstTimeout );
+const TCPCongestionOps_t * prvTCPWindowCongestionOps( const TCPWindow_t * pxWindow );
+uint32_t prvTCPCubicRoot( uint32_t ulValue );
+void prvTCPWindowTimestampRTT( TCPWindow_t * pxWindow );
+uint32_t prvTCPWindowSackScoreboard( TCPWindow_t * pxWindow );
+void prvTCPWindowIndexInsert( TCPSegment_t ** ppxRoot,
+                              TCPSegment_t * pxSegment );
+void prvTCPWindowIndexRemove( TCPSegment_t ** ppxRoot,
+                              TCPSegment_t * pxSegment );
+TCPSegment_t * prvTCPWindowIndexLowerBound( TCPSegment_t * pxRoot,
+                                            uint32_t ulSequenceNumber );
+TCPSegment_t * xTCPWindowRxFind( const TCPWindow_t * pxWindow,
+                                 uint32_t ulSequenceNumber );
+TCPSegment_t * xTCPWindowRxConfirm( const TCPWindow_t * pxWindow,
+                                    uint32_t ulSequenceNumber,
+                                    uint32_t ulLength );
+BaseType_t prvTCPWindowGrowArena( void );
+BaseType_t prvTCPWindowArenaAllow( const TCPWindow_t * pxWindow );
+void prvTCPWindowRelease( TCPWindow_t * pxWindow,
+                          TCPSegment_t * pxSegment );
+TCPSegment_t * xTCPWindowNew( TCPWindow_t * pxWindow,
+                              uint32_t ulSequenceNumber,
+                              int32_t lCount,
+                              BaseType_t xIsForRx );
+
+extern List_t xSegmentList;
+extern TCPSegment_t * pxTCPSegmentChunks[ ipconfigTCP_WIN_SEG_COUNT ];
+extern TCPSegmentStats_t xTCPSegmentStats;
+extern uint32_t ulTimestampMS;
+extern TickType_t xTimestampLastTick;
+extern uint32_t ulTimestampRemainder;
+
+static void initializeList( List_t * const pxList );
+
+/**
+ * @brief calls at the beginning of each test case
+ */
+void setUp( void )
+{
+    initializeList( &xSegmentList );
+    memset( pxTCPSegmentChunks, 0, sizeof( pxTCPSegmentChunks ) );
+    memset( &xTCPSegmentStats, 0, sizeof( xTCPSegmentStats ) );
+    ulTimestampMS = 0U;
+    xTimestampLastTick = 0U;
+    ulTimestampRemainder = 0U;
+}
+
+/**
+ * @brief calls at the end of each test case
+ */
+void tearDown( void )
+{
+}
+
+static void initializeList( List_t * const pxList )
+{
+    pxList->pxIndex = ( ListItem_t * ) &( pxList->xListEnd );
+
+    /* The list end value is the highest possible value in the list to
+     * ensure it remains at the end of the list. */
+    pxList->xListEnd.xItemValue = portMAX_DELAY;
+
+    /* The list end next and previous pointers point to itself so we know
+     * when the list is empty. */
+    pxList->xListEnd.pxNext = ( ListItem_t * ) &( pxList->xListEnd );
+    pxList->xListEnd.pxPrevious = ( ListItem_t * ) &( pxList->xListEnd );
+
+    pxList->uxNumberOfItems = ( UBaseType_t ) 0U;
+}
+
+/* Prepare a window that uses the congestion control algorithm 'pxOps',
+ * and that has sent 'ulOutstanding' bytes which are not yet acknowledged. */
+static void prvPrepareWindowWithOps( TCPWindow_t * pxWindow,
+                                     uint32_t ulOutstanding,
+                                     const TCPCongestionOps_t * pxOps )
+{
+    memset( pxWindow, 0, sizeof( *pxWindow ) );
+
+    pxWindow->usMSS = ( uint16_t ) TEST_MSS;
+    pxWindow->xSize.ulTxWindowLength = TEST_TX_WINDOW_LENGTH;
+    pxWindow->tx.ulCurrentSequenceNumber = 1000U;
+    pxWindow->tx.ulHighestSequenceNumber = 1000U;
+    pxWindow->pxCongestionOps = pxOps;
+
+    prvTCPWindowCongestionInit( pxWindow );
+
+    pxWindow->tx.ulHighestSequenceNumber += ulOutstanding;
+}
+
+/* Prepare a window that uses the default algorithm. */
+static void prvPrepareWindow( TCPWindow_t * pxWindow,
+                              uint32_t ulOutstanding )
+{
+    prvPrepareWindowWithOps( pxWindow, ulOutstanding, NULL );
+}
+
+/* Prepare a window that uses CUBIC, in congestion avoidance with cwnd at
+ * 'ulWindow' and with the given W_max, and with a known round-trip time. */
+static void prvPrepareCubicWindow( TCPWindow_t * pxWindow,
+                                   uint32_t ulWindow,
+                                   uint32_t ulWMax,
+                                   uint32_t ulRoundTripTime )
+{
+    prvPrepareWindowWithOps( pxWindow, 0U, &( xTCPCongestionCubic ) );
+
+    pxWindow->xSize.ulTxWindowLength = TEST_CUBIC_WINDOW_LENGTH;
+    pxWindow->ulCongestionWindow = ulWindow;
+    pxWindow->ulSlowStartThreshold = ulWindow;
+    pxWindow->xCubic.ulWMax = ulWMax;
+    pxWindow->xCubic.ulLastWMax = ulWMax;
+    pxWindow->xCubic.ulMinRTT = ulRoundTripTime;
+}
+
+/* Simulate a number of round-trips in which every byte that is allowed by
+ * cwnd is sent and acknowledged, one segment per ACK.  Returns the number
+ * of bytes that were delivered. */
+static uint32_t prvSimulateRoundTrips( TCPWindow_t * pxWindow,
+                                       uint32_t ulCount )
+{
+    uint32_t ulRound;
+    uint32_t ulSegment;
+    uint32_t ulSegmentCount;
+    uint32_t ulDelivered = 0U;
+
+    for( ulRound = 0U; ulRound < ulCount; ulRound++ )
+    {
+        ulSegmentCount = pxWindow->ulCongestionWindow / TEST_MSS;
+        pxWindow->tx.ulHighestSequenceNumber = pxWindow->tx.ulCurrentSequenceNumber + ( ulSegmentCount * TEST_MSS );
+
+        for( ulSegment = 0U; ulSegment < ulSegmentCount; ulSegment++ )
+        {
+            pxWindow->tx.ulCurrentSequenceNumber += TEST_MSS;
+            prvTCPWindowCongestionOnAck( pxWindow, TEST_MSS );
+            ulDelivered += TEST_MSS;
+        }
+    }
+
+    return ulDelivered;
+}
+
+/* Like prvSimulateRoundTrips(), but let the clock advance by one round-trip
+ * time for every round-trip, for algorithms that depend on time. */
+static uint32_t prvSimulateTimedRoundTrips( TCPWindow_t * pxWindow,
+                                            uint32_t ulCount,
+                                            uint32_t ulRoundTripTime,
+                                            TickType_t * pxTime )
+{
+    uint32_t ulRound;
+    uint32_t ulDelivered = 0U;
+
+    for( ulRound = 0U; ulRound < ulCount; ulRound++ )
+    {
+        xTaskGetTickCount_IgnoreAndReturn( *pxTime );
+        ulDelivered += prvSimulateRoundTrips( pxWindow, 1U );
+        *pxTime += pdMS_TO_TICKS( ulRoundTripTime );
+    }
+
+    return ulDelivered;
+}
+
+/* Fill 'xTxSegments' of the window with 'uxCount' segments of one MSS each,
+ * and let the segments that are not SACK'd wait for an ACK.  A 'pdTRUE' in
+ * 'pxSacked' marks a segment as SACK'd by the peer. */
+static void prvPrepareScoreboard( TCPWindow_t * pxWindow,
+                                  TCPSegment_t * pxSegments,
+                                  const BaseType_t * pxSacked,
+                                  size_t uxCount )
+{
+    size_t uxIndex;
+
+    prvPrepareWindow( pxWindow, ( uint32_t ) uxCount * TEST_MSS );
+    initializeList( &( pxWindow->xTxSegments ) );
+    initializeList( &( pxWindow->xPriorityQueue ) );
+    initializeList( &( pxWindow->xWaitQueue ) );
+    memset( pxSegments, 0, uxCount * sizeof( *pxSegments ) );
+
+    for( uxIndex = 0U; uxIndex < uxCount; uxIndex++ )
+    {
+        pxSegments[ uxIndex ].ulSequenceNumber = pxWindow->tx.ulCurrentSequenceNumber + ( ( uint32_t ) uxIndex * TEST_MSS );
+        pxSegments[ uxIndex ].lDataLength = ( int32_t ) TEST_MSS;
+        pxSegments[ uxIndex ].u.bits.ucTransmitCount = 1U;
+        pxSegments[ uxIndex ].u.bits.bOutstanding = pdTRUE_UNSIGNED;
+
+        if( pxSacked[ uxIndex ] != pdFALSE )
+        {
+            pxSegments[ uxIndex ].u.bits.bAcked = pdTRUE_UNSIGNED;
+        }
+        else
+        {
+            pxSegments[ uxIndex ].xQueueItem.pxContainer = &( pxWindow->xWaitQueue );
+        }
+    }
+}
+
+/* Expect a walk through the first 'uxVisited' of 'uxCount' segments. */
+static void prvExpectScoreboardWalk( TCPWindow_t * pxWindow,
+                                     TCPSegment_t * pxSegments,
+                                     ListItem_t * pxItems,
+                                     size_t uxVisited,
+                                     size_t uxCount )
+{
+    size_t uxIndex;
+    ListItem_t * pxEnd = ( ListItem_t * ) &( pxWindow->xTxSegments.xListEnd );
+
+    listGET_NEXT_ExpectAnyArgsAndReturn( ( uxCount > 0U ) ? &( pxItems[ 0 ] ) : pxEnd );
+
+    for( uxIndex = 0U; uxIndex < uxVisited; uxIndex++ )
+    {
+        listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &( pxSegments[ uxIndex ] ) );
+        listGET_NEXT_ExpectAnyArgsAndReturn( ( ( uxIndex + 1U ) < uxCount ) ? &( pxItems[ uxIndex + 1U ] ) : pxEnd );
+    }
+}
+
+/* Check the ordering, the parent links, the heights and the balance of an
+ * index sub-tree.  Returns the number of segments in the sub-tree. */
+static size_t prvCheckIndex( const TCPSegment_t * pxNode,
+                             const TCPSegment_t * pxParent )
+{
+    size_t uxCount = 0U;
+    BaseType_t xLeft = 0;
+    BaseType_t xRight = 0;
+
+    if( pxNode != NULL )
+    {
+        TEST_ASSERT_EQUAL_PTR( pxParent, pxNode->pxIndexParent );
+
+        if( pxNode->pxIndexLeft != NULL )
+        {
+            TEST_ASSERT_TRUE( xSequenceLessThan( pxNode->pxIndexLeft->ulSequenceNumber, pxNode->ulSequenceNumber ) );
+            xLeft = pxNode->pxIndexLeft->xIndexHeight;
+        }
+
+        if( pxNode->pxIndexRight != NULL )
+        {
+            TEST_ASSERT_TRUE( xSequenceGreaterThan( pxNode->pxIndexRight->ulSequenceNumber, pxNode->ulSequenceNumber ) );
+            xRight = pxNode->pxIndexRight->xIndexHeight;
+        }
+
+        TEST_ASSERT_EQUAL( ( ( xLeft > xRight ) ? xLeft : xRight ) + 1, pxNode->xIndexHeight );
+        TEST_ASSERT_LESS_OR_EQUAL( 1, abs( ( int ) ( xLeft - xRight ) ) );
+
+        uxCount = 1U + prvCheckIndex( pxNode->pxIndexLeft, pxNode ) + prvCheckIndex( pxNode->pxIndexRight, pxNode );
+    }
+
+    return uxCount;
+}
+
+/* Store the segments of an index sub-tree in 'pxOrder', in the order of an
+ * in-order walk, starting at 'uxCount'.  Returns the new count. */
+static size_t prvCollectIndex( TCPSegment_t * pxNode,
+                               TCPSegment_t ** pxOrder,
+                               size_t uxCount )
+{
+    size_t uxReturn = uxCount;
+
+    if( pxNode != NULL )
+    {
+        uxReturn = prvCollectIndex( pxNode->pxIndexLeft, pxOrder, uxReturn );
+        pxOrder[ uxReturn ] = pxNode;
+        uxReturn++;
+        uxReturn = prvCollectIndex( pxNode->pxIndexRight, pxOrder, uxReturn );
+    }
+
+    return uxReturn;
+}
+
+/* Give 'uxCount' segments of one MSS each consecutive sequence numbers,
+ * starting at 'ulFirst'. */
+static void prvPrepareIndexSegments( TCPSegment_t * pxSegments,
+                                     size_t uxCount,
+                                     uint32_t ulFirst )
+{
+    size_t uxIndex;
+
+    memset( pxSegments, 0, uxCount * sizeof( *pxSegments ) );
+
+    for( uxIndex = 0U; uxIndex < uxCount; uxIndex++ )
+    {
+        pxSegments[ uxIndex ].ulSequenceNumber = ulFirst + ( ( uint32_t ) uxIndex * TEST_MSS );
+        pxSegments[ uxIndex ].lDataLength = ( int32_t ) TEST_MSS;
+    }
+}
+
+void test_prvTCPWindowCongestionInit_LargeMSS( void )
+{
+    TCPWindow_t xWindow = { 0 };
+
+    xWindow.usMSS = 3000U;
+    xWindow.xSize.ulTxWindowLength = TEST_TX_WINDOW_LENGTH;
+    xWindow.tx.ulHighestSequenceNumber = 5000U;
+    xWindow.u.bits.bFastRecovery = pdTRUE_UNSIGNED;
+
+    prvTCPWindowCongestionInit( &xWindow );
+
+    TEST_ASSERT_EQUAL( 6000U, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( TEST_TX_WINDOW_LENGTH, xWindow.ulSlowStartThreshold );
+    TEST_ASSERT_EQUAL( 5000U, xWindow.ulRecoverSequenceNumber );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bFastRecovery );
+}
+
+void test_prvTCPWindowCongestionInit_MediumMSS( void )
+{
+    TCPWindow_t xWindow = { 0 };
+
+    xWindow.usMSS = 1460U;
+
+    prvTCPWindowCongestionInit( &xWindow );
+
+    TEST_ASSERT_EQUAL( 4380U, xWindow.ulCongestionWindow );
+}
+
+void test_prvTCPWindowCongestionInit_SmallMSS( void )
+{
+    TCPWindow_t xWindow = { 0 };
+
+    xWindow.usMSS = 536U;
+
+    prvTCPWindowCongestionInit( &xWindow );
+
+    TEST_ASSERT_EQUAL( 2144U, xWindow.ulCongestionWindow );
+}
+
+void test_vTCPWindowCongestionMSSChanged_BeforeData( void )
+{
+    TCPWindow_t xWindow = { 0 };
+
+    xWindow.usMSS = 1460U;
+    xWindow.xSize.ulTxWindowLength = TEST_TX_WINDOW_LENGTH;
+    xWindow.tx.ulFirstSequenceNumber = 1000U;
+    xWindow.tx.ulHighestSequenceNumber = 1000U;
+
+    prvTCPWindowCongestionInit( &xWindow );
+    TEST_ASSERT_EQUAL( 4380U, xWindow.ulCongestionWindow );
+
+    /* The peer announced a smaller MSS. */
+    xWindow.usMSS = 536U;
+
+    vTCPWindowCongestionMSSChanged( &xWindow );
+
+    TEST_ASSERT_EQUAL( 2144U, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( TEST_TX_WINDOW_LENGTH, xWindow.ulSlowStartThreshold );
+}
+
+void test_vTCPWindowCongestionMSSChanged_AfterData( void )
+{
+    TCPWindow_t xWindow = { 0 };
+
+    xWindow.usMSS = 536U;
+    xWindow.tx.ulFirstSequenceNumber = 1000U;
+    xWindow.tx.ulHighestSequenceNumber = 1000U + 536U;
+    xWindow.ulCongestionWindow = 10000U;
+    xWindow.ulSlowStartThreshold = 8000U;
+
+    vTCPWindowCongestionMSSChanged( &xWindow );
+
+    /* Data has been sent already, cwnd and ssthresh are left alone. */
+    TEST_ASSERT_EQUAL( 10000U, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( 8000U, xWindow.ulSlowStartThreshold );
+}
+
+void test_vTCPWindowInit_InitialisesCongestionWindow( void )
+{
+    TCPWindow_t xWindow = { 0 };
+
+    xWindow.xSize.ulTxWindowLength = TEST_TX_WINDOW_LENGTH;
+    xWindow.ulCongestionWindow = 12345U;
+
+    vTCPWindowInit( &xWindow, 100U, 200U, 1460U );
+
+    TEST_ASSERT_EQUAL( 4380U, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( TEST_TX_WINDOW_LENGTH, xWindow.ulSlowStartThreshold );
+    TEST_ASSERT_EQUAL( 200U, xWindow.ulRecoverSequenceNumber );
+}
+
+void test_prvTCPWindowCongestionOnAck_SlowStart( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindow( &xWindow, 0U );
+
+    /* A full segment increases cwnd by one MSS. */
+    prvTCPWindowCongestionOnAck( &xWindow, 2U * TEST_MSS );
+    TEST_ASSERT_EQUAL( 5U * TEST_MSS, xWindow.ulCongestionWindow );
+
+    /* A small ACK increases cwnd by the number of bytes acknowledged. */
+    prvTCPWindowCongestionOnAck( &xWindow, 100U );
+    TEST_ASSERT_EQUAL( ( 5U * TEST_MSS ) + 100U, xWindow.ulCongestionWindow );
+}
+
+void test_prvTCPWindowCongestionOnAck_CongestionAvoidance( void )
+{
+    TCPWindow_t xWindow;
+    uint32_t ulIndex;
+
+    prvPrepareWindow( &xWindow, 0U );
+    xWindow.ulCongestionWindow = 10U * TEST_MSS;
+    xWindow.ulSlowStartThreshold = 10U * TEST_MSS;
+
+    /* cwnd only grows after a full window of data has been acknowledged. */
+    for( ulIndex = 0U; ulIndex < 9U; ulIndex++ )
+    {
+        prvTCPWindowCongestionOnAck( &xWindow, TEST_MSS );
+        TEST_ASSERT_EQUAL( 10U * TEST_MSS, xWindow.ulCongestionWindow );
+    }
+
+    prvTCPWindowCongestionOnAck( &xWindow, TEST_MSS );
+    TEST_ASSERT_EQUAL( 11U * TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( 0U, xWindow.ulBytesAckedInAvoidance );
+}
+
+void test_prvTCPWindowCongestionOnAck_LimitedByTxWindow( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindow( &xWindow, 0U );
+    xWindow.ulCongestionWindow = TEST_TX_WINDOW_LENGTH - 10U;
+
+    prvTCPWindowCongestionOnAck( &xWindow, TEST_MSS );
+
+    TEST_ASSERT_EQUAL( TEST_TX_WINDOW_LENGTH, xWindow.ulCongestionWindow );
+}
+
+void test_prvTCPWindowCongestionOnDupAck_EnterFastRecovery( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindow( &xWindow, 20U * TEST_MSS );
+    xWindow.tx.ulCurrentSequenceNumber++;
+    xWindow.tx.ulHighestSequenceNumber++;
+
+    prvTCPWindowCongestionOnDupAck( &xWindow, 1U );
+
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xWindow.u.bits.bFastRecovery );
+    TEST_ASSERT_EQUAL( 10U * TEST_MSS, xWindow.ulSlowStartThreshold );
+    TEST_ASSERT_EQUAL( 13U * TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( xWindow.tx.ulHighestSequenceNumber, xWindow.ulRecoverSequenceNumber );
+}
+
+void test_prvTCPWindowCongestionOnDupAck_MinimumThreshold( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindow( &xWindow, TEST_MSS );
+    xWindow.tx.ulCurrentSequenceNumber++;
+    xWindow.tx.ulHighestSequenceNumber++;
+
+    prvTCPWindowCongestionOnDupAck( &xWindow, 1U );
+
+    TEST_ASSERT_EQUAL( 2U * TEST_MSS, xWindow.ulSlowStartThreshold );
+    TEST_ASSERT_EQUAL( 5U * TEST_MSS, xWindow.ulCongestionWindow );
+}
+
+void test_prvTCPWindowCongestionOnDupAck_NoRetransmission( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindow( &xWindow, 20U * TEST_MSS );
+    xWindow.tx.ulCurrentSequenceNumber++;
+
+    prvTCPWindowCongestionOnDupAck( &xWindow, 0U );
+
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bFastRecovery );
+    TEST_ASSERT_EQUAL( 4U * TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( TEST_TX_WINDOW_LENGTH, xWindow.ulSlowStartThreshold );
+}
+
+void test_prvTCPWindowCongestionOnDupAck_BelowRecoveryPoint( void )
+{
+    TCPWindow_t xWindow;
+
+    /* After a timeout, losses within the same window of data must not
+     * reduce ssthresh again. */
+    prvPrepareWindow( &xWindow, 20U * TEST_MSS );
+    xWindow.ulRecoverSequenceNumber = xWindow.tx.ulHighestSequenceNumber;
+
+    prvTCPWindowCongestionOnDupAck( &xWindow, 1U );
+
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bFastRecovery );
+    TEST_ASSERT_EQUAL( TEST_TX_WINDOW_LENGTH, xWindow.ulSlowStartThreshold );
+}
+
+void test_prvTCPWindowCongestionOnDupAck_InflateInFastRecovery( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindow( &xWindow, 20U * TEST_MSS );
+    xWindow.u.bits.bFastRecovery = pdTRUE_UNSIGNED;
+    xWindow.ulCongestionWindow = 13U * TEST_MSS;
+    xWindow.ulSlowStartThreshold = 10U * TEST_MSS;
+
+    prvTCPWindowCongestionOnDupAck( &xWindow, 0U );
+
+    TEST_ASSERT_EQUAL( 14U * TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( 10U * TEST_MSS, xWindow.ulSlowStartThreshold );
+}
+
+void test_prvTCPWindowCongestionOnAck_FullAcknowledgement( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindow( &xWindow, 20U * TEST_MSS );
+    xWindow.u.bits.bFastRecovery = pdTRUE_UNSIGNED;
+    xWindow.ulCongestionWindow = 15U * TEST_MSS;
+    xWindow.ulSlowStartThreshold = 10U * TEST_MSS;
+    xWindow.ulRecoverSequenceNumber = xWindow.tx.ulHighestSequenceNumber;
+    xWindow.tx.ulCurrentSequenceNumber = xWindow.tx.ulHighestSequenceNumber;
+
+    prvTCPWindowCongestionOnAck( &xWindow, 20U * TEST_MSS );
+
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bFastRecovery );
+    TEST_ASSERT_EQUAL( 10U * TEST_MSS, xWindow.ulCongestionWindow );
+}
+
+void test_prvTCPWindowCongestionOnAck_PartialAcknowledgement( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegment;
+    ListItem_t xSegmentItem;
+
+    prvPrepareWindow( &xWindow, 20U * TEST_MSS );
+    initializeList( &( xWindow.xPriorityQueue ) );
+    initializeList( &( xWindow.xWaitQueue ) );
+    memset( &xSegment, 0, sizeof( xSegment ) );
+
+    xWindow.u.bits.bFastRecovery = pdTRUE_UNSIGNED;
+    xWindow.ulCongestionWindow = 13U * TEST_MSS;
+    xWindow.ulSlowStartThreshold = 10U * TEST_MSS;
+    xWindow.ulRecoverSequenceNumber = xWindow.tx.ulHighestSequenceNumber;
+    xWindow.tx.ulCurrentSequenceNumber += 2U * TEST_MSS;
+    xSegment.xQueueItem.pxContainer = &( xWindow.xWaitQueue );
+
+    /* The first unacknowledged segment is retransmitted right away. */
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdFALSE );
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &xSegmentItem );
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &xSegment );
+    uxListRemove_ExpectAndReturn( &( xSegment.xQueueItem ), 0U );
+
+    prvTCPWindowCongestionOnAck( &xWindow, 2U * TEST_MSS );
+
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xWindow.u.bits.bFastRecovery );
+    TEST_ASSERT_EQUAL( 12U * TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL_PTR( &( xWindow.xPriorityQueue ), xSegment.xQueueItem.pxContainer );
+}
+
+void test_prvTCPWindowCongestionOnAck_PartialAcknowledgement_AlreadyQueued( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegment;
+    ListItem_t xSegmentItem;
+
+    prvPrepareWindow( &xWindow, 20U * TEST_MSS );
+    memset( &xSegment, 0, sizeof( xSegment ) );
+
+    xWindow.u.bits.bFastRecovery = pdTRUE_UNSIGNED;
+    xWindow.ulCongestionWindow = 13U * TEST_MSS;
+    xWindow.ulRecoverSequenceNumber = xWindow.tx.ulHighestSequenceNumber;
+    xWindow.tx.ulCurrentSequenceNumber += 100U;
+    xSegment.xQueueItem.pxContainer = &( xWindow.xPriorityQueue );
+
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdFALSE );
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &xSegmentItem );
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &xSegment );
+
+    /* Less than one MSS was acknowledged: no MSS is added back. */
+    prvTCPWindowCongestionOnAck( &xWindow, 100U );
+
+    TEST_ASSERT_EQUAL( ( 13U * TEST_MSS ) - 100U, xWindow.ulCongestionWindow );
+}
+
+void test_prvTCPWindowCongestionOnTimeout( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindow( &xWindow, 30U * TEST_MSS );
+    xWindow.u.bits.bFastRecovery = pdTRUE_UNSIGNED;
+    xWindow.ulCongestionWindow = 30U * TEST_MSS;
+
+    prvTCPWindowCongestionOnTimeout( &xWindow, pdTRUE );
+
+    TEST_ASSERT_EQUAL( TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( 15U * TEST_MSS, xWindow.ulSlowStartThreshold );
+    TEST_ASSERT_EQUAL( xWindow.tx.ulHighestSequenceNumber, xWindow.ulRecoverSequenceNumber );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bFastRecovery );
+
+    /* A repeated timeout of the same segment keeps ssthresh. */
+    xWindow.tx.ulCurrentSequenceNumber = xWindow.tx.ulHighestSequenceNumber;
+
+    prvTCPWindowCongestionOnTimeout( &xWindow, pdFALSE );
+
+    TEST_ASSERT_EQUAL( TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( 15U * TEST_MSS, xWindow.ulSlowStartThreshold );
+}
+
+/* An induced loss which is repaired by fast retransmit and fast recovery
+ * must deliver more data in the following round-trips than the same loss
+ * repaired by a retransmission timeout, while both back off from the
+ * window that was in use when the loss happened. */
+void test_CongestionControl_InducedLoss_Goodput( void )
+{
+    TCPWindow_t xFastWindow;
+    TCPWindow_t xTimeoutWindow;
+    uint32_t ulFastDelivered;
+    uint32_t ulTimeoutDelivered;
+    uint32_t ulUnlimited = TEST_ROUND_TRIP_COUNT * 32U * TEST_MSS;
+
+    /* Both connections have 32 segments in flight when a segment gets lost. */
+    prvPrepareWindow( &xFastWindow, 32U * TEST_MSS );
+    xFastWindow.tx.ulCurrentSequenceNumber++;
+    xFastWindow.tx.ulHighestSequenceNumber++;
+    xFastWindow.ulCongestionWindow = 32U * TEST_MSS;
+    ( void ) memcpy( &xTimeoutWindow, &xFastWindow, sizeof( xTimeoutWindow ) );
+
+    /* Loss detected by duplicate ACKs, followed by a full acknowledgement. */
+    prvTCPWindowCongestionOnDupAck( &xFastWindow, 1U );
+    xFastWindow.tx.ulCurrentSequenceNumber = xFastWindow.tx.ulHighestSequenceNumber;
+    prvTCPWindowCongestionOnAck( &xFastWindow, 32U * TEST_MSS );
+    TEST_ASSERT_EQUAL( 16U * TEST_MSS, xFastWindow.ulCongestionWindow );
+
+    /* Loss detected by the retransmission timer. */
+    prvTCPWindowCongestionOnTimeout( &xTimeoutWindow, pdTRUE );
+    xTimeoutWindow.tx.ulCurrentSequenceNumber = xTimeoutWindow.tx.ulHighestSequenceNumber;
+    TEST_ASSERT_EQUAL( TEST_MSS, xTimeoutWindow.ulCongestionWindow );
+
+    ulFastDelivered = prvSimulateRoundTrips( &xFastWindow, TEST_ROUND_TRIP_COUNT );
+    ulTimeoutDelivered = prvSimulateRoundTrips( &xTimeoutWindow, TEST_ROUND_TRIP_COUNT );
+
+    TEST_ASSERT_GREATER_THAN( ulTimeoutDelivered, ulFastDelivered );
+    TEST_ASSERT_LESS_THAN( ulUnlimited, ulFastDelivered );
+
+    /* The timeout connection has left slow start at ssthresh, and both
+     * connections are now in congestion avoidance. */
+    TEST_ASSERT_GREATER_OR_EQUAL( xTimeoutWindow.ulSlowStartThreshold, xTimeoutWindow.ulCongestionWindow );
+    TEST_ASSERT_GREATER_OR_EQUAL( xFastWindow.ulSlowStartThreshold, xFastWindow.ulCongestionWindow );
+}
+
+/* Losses that are induced at a regular interval give the congestion window
+ * the well-known saw-tooth shape: it is halved at every loss, and it never
+ * falls back to a single segment while fast recovery can repair the loss. */
+void test_CongestionControl_PeriodicLoss_SawTooth( void )
+{
+    TCPWindow_t xWindow;
+    uint32_t ulLoss;
+    uint32_t ulWindowBeforeLoss;
+
+    prvPrepareWindow( &xWindow, 0U );
+    xWindow.tx.ulCurrentSequenceNumber++;
+    xWindow.tx.ulHighestSequenceNumber++;
+
+    for( ulLoss = 0U; ulLoss < 4U; ulLoss++ )
+    {
+        ( void ) prvSimulateRoundTrips( &xWindow, TEST_ROUND_TRIP_COUNT );
+
+        ulWindowBeforeLoss = xWindow.ulCongestionWindow;
+        xWindow.tx.ulHighestSequenceNumber = xWindow.tx.ulCurrentSequenceNumber + ulWindowBeforeLoss;
+
+        prvTCPWindowCongestionOnDupAck( &xWindow, 1U );
+        TEST_ASSERT_EQUAL( ulWindowBeforeLoss / 2U, xWindow.ulSlowStartThreshold );
+
+        xWindow.tx.ulCurrentSequenceNumber = xWindow.tx.ulHighestSequenceNumber;
+        prvTCPWindowCongestionOnAck( &xWindow, ulWindowBeforeLoss );
+
+        TEST_ASSERT_EQUAL( ulWindowBeforeLoss / 2U, xWindow.ulCongestionWindow );
+        TEST_ASSERT_GREATER_THAN( 2U * TEST_MSS, xWindow.ulCongestionWindow );
+    }
+}
+
+void test_pxTCPWindowFindCongestionOps( void )
+{
+    const char cPadded[ 16 ] = "cubic";
+
+    TEST_ASSERT_EQUAL_PTR( &( xTCPCongestionNewReno ), pxTCPWindowFindCongestionOps( "newreno", 7U ) );
+    TEST_ASSERT_EQUAL_PTR( &( xTCPCongestionCubic ), pxTCPWindowFindCongestionOps( "cubic", 5U ) );
+
+    /* The name may be followed by a terminating nul. */
+    TEST_ASSERT_EQUAL_PTR( &( xTCPCongestionCubic ), pxTCPWindowFindCongestionOps( cPadded, sizeof( cPadded ) ) );
+
+    /* Partial, longer and unknown names are refused. */
+    TEST_ASSERT_NULL( pxTCPWindowFindCongestionOps( "cubic", 3U ) );
+    TEST_ASSERT_NULL( pxTCPWindowFindCongestionOps( "cubical", 7U ) );
+    TEST_ASSERT_NULL( pxTCPWindowFindCongestionOps( "vegas", 5U ) );
+    TEST_ASSERT_NULL( pxTCPWindowFindCongestionOps( "", 0U ) );
+    TEST_ASSERT_NULL( pxTCPWindowFindCongestionOps( NULL, 5U ) );
+}
+
+void test_prvTCPWindowCongestionOps_DefaultIsNewReno( void )
+{
+    TCPWindow_t xWindow = { 0 };
+
+    TEST_ASSERT_EQUAL_PTR( &( xTCPCongestionNewReno ), prvTCPWindowCongestionOps( &xWindow ) );
+
+    xWindow.pxCongestionOps = &( xTCPCongestionCubic );
+
+    TEST_ASSERT_EQUAL_PTR( &( xTCPCongestionCubic ), prvTCPWindowCongestionOps( &xWindow ) );
+}
+
+void test_prvTCPCubicRoot( void )
+{
+    TEST_ASSERT_EQUAL( 0U, prvTCPCubicRoot( 0U ) );
+    TEST_ASSERT_EQUAL( 1U, prvTCPCubicRoot( 7U ) );
+    TEST_ASSERT_EQUAL( 2U, prvTCPCubicRoot( 8U ) );
+    TEST_ASSERT_EQUAL( 2U, prvTCPCubicRoot( 26U ) );
+    TEST_ASSERT_EQUAL( 3U, prvTCPCubicRoot( 27U ) );
+    TEST_ASSERT_EQUAL( 100U, prvTCPCubicRoot( 1000000U ) );
+    TEST_ASSERT_EQUAL( 99U, prvTCPCubicRoot( 999999U ) );
+    TEST_ASSERT_EQUAL( 1625U, prvTCPCubicRoot( 0xFFFFFFFFU ) );
+}
+
+void test_Cubic_Init_ResetsState( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindow( &xWindow, 0U );
+    xWindow.pxCongestionOps = &( xTCPCongestionCubic );
+    xWindow.xCubic.ulWMax = 1234U;
+    xWindow.xCubic.ulMinRTT = 20U;
+    xWindow.xCubic.xInEpoch = pdTRUE;
+
+    prvTCPWindowCongestionInit( &xWindow );
+
+    TEST_ASSERT_EQUAL( 4U * TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( 0U, xWindow.xCubic.ulWMax );
+    TEST_ASSERT_EQUAL( 0U, xWindow.xCubic.ulMinRTT );
+    TEST_ASSERT_EQUAL( pdFALSE, xWindow.xCubic.xInEpoch );
+}
+
+void test_Cubic_OnLoss( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindowWithOps( &xWindow, 100U * TEST_MSS, &( xTCPCongestionCubic ) );
+    xWindow.tx.ulCurrentSequenceNumber++;
+    xWindow.tx.ulHighestSequenceNumber++;
+    xWindow.ulCongestionWindow = 100U * TEST_MSS;
+
+    prvTCPWindowCongestionOnDupAck( &xWindow, 1U );
+
+    /* CUBIC backs off to 0.7 times cwnd, where NewReno would halve it. */
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xWindow.u.bits.bFastRecovery );
+    TEST_ASSERT_EQUAL( 70U * TEST_MSS, xWindow.ulSlowStartThreshold );
+    TEST_ASSERT_EQUAL( 73U * TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( 100U * TEST_MSS, xWindow.xCubic.ulWMax );
+    TEST_ASSERT_EQUAL( 100U * TEST_MSS, xWindow.xCubic.ulLastWMax );
+}
+
+void test_Cubic_OnLoss_FastConvergence( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindowWithOps( &xWindow, 100U * TEST_MSS, &( xTCPCongestionCubic ) );
+    xWindow.tx.ulCurrentSequenceNumber++;
+    xWindow.tx.ulHighestSequenceNumber++;
+    xWindow.ulCongestionWindow = 100U * TEST_MSS;
+    xWindow.xCubic.ulLastWMax = 120U * TEST_MSS;
+
+    prvTCPWindowCongestionOnDupAck( &xWindow, 1U );
+
+    /* cwnd did not reach the previous W_max: aim lower. */
+    TEST_ASSERT_EQUAL( 85U * TEST_MSS, xWindow.xCubic.ulWMax );
+    TEST_ASSERT_EQUAL( 100U * TEST_MSS, xWindow.xCubic.ulLastWMax );
+    TEST_ASSERT_EQUAL( 70U * TEST_MSS, xWindow.ulSlowStartThreshold );
+}
+
+void test_Cubic_OnLoss_MinimumThreshold( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindowWithOps( &xWindow, 2U * TEST_MSS, &( xTCPCongestionCubic ) );
+    xWindow.tx.ulCurrentSequenceNumber++;
+    xWindow.tx.ulHighestSequenceNumber++;
+    xWindow.ulCongestionWindow = 2U * TEST_MSS;
+
+    prvTCPWindowCongestionOnDupAck( &xWindow, 1U );
+
+    TEST_ASSERT_EQUAL( 2U * TEST_MSS, xWindow.ulSlowStartThreshold );
+}
+
+void test_Cubic_OnTimeout( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindowWithOps( &xWindow, 100U * TEST_MSS, &( xTCPCongestionCubic ) );
+    xWindow.ulCongestionWindow = 100U * TEST_MSS;
+    xWindow.xCubic.xInEpoch = pdTRUE;
+
+    prvTCPWindowCongestionOnTimeout( &xWindow, pdTRUE );
+
+    TEST_ASSERT_EQUAL( TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( 70U * TEST_MSS, xWindow.ulSlowStartThreshold );
+    TEST_ASSERT_EQUAL( 100U * TEST_MSS, xWindow.xCubic.ulWMax );
+    TEST_ASSERT_EQUAL( pdFALSE, xWindow.xCubic.xInEpoch );
+
+    /* A repeated timeout of the same segment keeps ssthresh and W_max. */
+    prvTCPWindowCongestionOnTimeout( &xWindow, pdFALSE );
+
+    TEST_ASSERT_EQUAL( TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( 70U * TEST_MSS, xWindow.ulSlowStartThreshold );
+    TEST_ASSERT_EQUAL( 100U * TEST_MSS, xWindow.xCubic.ulWMax );
+}
+
+void test_Cubic_OnRTTSample( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindowWithOps( &xWindow, 0U, &( xTCPCongestionCubic ) );
+
+    xTCPCongestionCubic.fnOnRTTSample( &xWindow, 120U );
+    TEST_ASSERT_EQUAL( 120U, xWindow.xCubic.ulMinRTT );
+
+    xTCPCongestionCubic.fnOnRTTSample( &xWindow, 80U );
+    TEST_ASSERT_EQUAL( 80U, xWindow.xCubic.ulMinRTT );
+
+    xTCPCongestionCubic.fnOnRTTSample( &xWindow, 200U );
+    TEST_ASSERT_EQUAL( 80U, xWindow.xCubic.ulMinRTT );
+}
+
+void test_Cubic_SlowStart( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindowWithOps( &xWindow, 0U, &( xTCPCongestionCubic ) );
+
+    prvTCPWindowCongestionOnAck( &xWindow, 2U * TEST_MSS );
+
+    TEST_ASSERT_EQUAL( 5U * TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( pdFALSE, xWindow.xCubic.xInEpoch );
+}
+
+void test_Cubic_StartEpoch( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareCubicWindow( &xWindow, 70U * TEST_MSS, 100U * TEST_MSS, 0U );
+    xTaskGetTickCount_IgnoreAndReturn( 1000U );
+
+    prvTCPWindowCongestionOnAck( &xWindow, TEST_MSS );
+
+    /* K = cubic_root( 30 / 0.4 ) = 4.22 seconds, or 269 / 64 seconds. */
+    TEST_ASSERT_EQUAL( pdTRUE, xWindow.xCubic.xInEpoch );
+    TEST_ASSERT_EQUAL( 1000U, xWindow.xCubic.uxEpochStart );
+    TEST_ASSERT_EQUAL( 269U, xWindow.xCubic.ulK );
+    TEST_ASSERT_EQUAL( 100U * TEST_MSS, xWindow.xCubic.ulOrigin );
+
+    /* Right after the loss, cwnd grows very slowly. */
+    TEST_ASSERT_EQUAL( 70U * TEST_MSS, xWindow.ulCongestionWindow );
+}
+
+void test_Cubic_StartEpoch_BeyondWMax( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareCubicWindow( &xWindow, 120U * TEST_MSS, 100U * TEST_MSS, 100U );
+    xTaskGetTickCount_IgnoreAndReturn( 0U );
+
+    prvTCPWindowCongestionOnAck( &xWindow, TEST_MSS );
+
+    TEST_ASSERT_EQUAL( 0U, xWindow.xCubic.ulK );
+    TEST_ASSERT_EQUAL( 120U * TEST_MSS, xWindow.xCubic.ulOrigin );
+}
+
+/* After a loss, cwnd follows a concave curve up to W_max, stays close to
+ * W_max for a while, and then follows a convex curve to probe for more. */
+void test_Cubic_ConcaveAndConvexGrowth( void )
+{
+    TCPWindow_t xWindow;
+    TickType_t xTime = 0U;
+    uint32_t ulStart;
+    uint32_t ulEarlyGrowth;
+    uint32_t ulPlateauGrowth;
+    uint32_t ulLateGrowth;
+
+    prvPrepareCubicWindow( &xWindow, 70U * TEST_MSS, 100U * TEST_MSS, 100U );
+
+    /* The first second: the concave region. */
+    ulStart = xWindow.ulCongestionWindow;
+    ( void ) prvSimulateTimedRoundTrips( &xWindow, 10U, 100U, &xTime );
+    ulEarlyGrowth = xWindow.ulCongestionWindow - ulStart;
+
+    /* Around K, 4.2 seconds after the loss: the plateau. */
+    ( void ) prvSimulateTimedRoundTrips( &xWindow, 27U, 100U, &xTime );
+    TEST_ASSERT_LESS_OR_EQUAL( 100U * TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_GREATER_OR_EQUAL( 95U * TEST_MSS, xWindow.ulCongestionWindow );
+    ulStart = xWindow.ulCongestionWindow;
+    ( void ) prvSimulateTimedRoundTrips( &xWindow, 10U, 100U, &xTime );
+    ulPlateauGrowth = xWindow.ulCongestionWindow - ulStart;
+
+    /* Two seconds later: the convex region. */
+    ( void ) prvSimulateTimedRoundTrips( &xWindow, 10U, 100U, &xTime );
+    ulStart = xWindow.ulCongestionWindow;
+    ( void ) prvSimulateTimedRoundTrips( &xWindow, 10U, 100U, &xTime );
+    ulLateGrowth = xWindow.ulCongestionWindow - ulStart;
+
+    TEST_ASSERT_GREATER_THAN( ulPlateauGrowth, ulEarlyGrowth );
+    TEST_ASSERT_GREATER_THAN( ulPlateauGrowth, ulLateGrowth );
+    TEST_ASSERT_GREATER_THAN( 100U * TEST_MSS, xWindow.ulCongestionWindow );
+}
+
+/* With a short round-trip time, NewReno would grow faster than the cubic
+ * function.  CUBIC must then grow at least as fast as NewReno would. */
+void test_Cubic_RenoFriendlyRegion( void )
+{
+    TCPWindow_t xWindow;
+    TickType_t xTime = 0U;
+
+    prvPrepareCubicWindow( &xWindow, 14U * TEST_MSS, 20U * TEST_MSS, 10U );
+
+    ( void ) prvSimulateTimedRoundTrips( &xWindow, 50U, 10U, &xTime );
+
+    /* The cubic function alone would still be below W_max. */
+    TEST_ASSERT_GREATER_THAN( 20U * TEST_MSS, xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( xWindow.xCubic.ulEstimate, xWindow.ulCongestionWindow );
+}
+
+/* On a path with a large bandwidth-delay product, CUBIC recovers from a loss
+ * much faster than NewReno, while a socket that did not select CUBIC keeps
+ * the conservative NewReno behaviour. */
+void test_CongestionControl_Cubic_RecoversFasterThanNewReno( void )
+{
+    TCPWindow_t xRenoWindow;
+    TCPWindow_t xCubicWindow;
+    TickType_t xTime = 0U;
+    uint32_t ulRenoDelivered;
+    uint32_t ulCubicDelivered;
+
+    prvPrepareWindow( &xRenoWindow, 300U * TEST_MSS );
+    prvPrepareWindowWithOps( &xCubicWindow, 300U * TEST_MSS, &( xTCPCongestionCubic ) );
+
+    xRenoWindow.xSize.ulTxWindowLength = TEST_CUBIC_WINDOW_LENGTH;
+    xRenoWindow.tx.ulCurrentSequenceNumber++;
+    xRenoWindow.tx.ulHighestSequenceNumber++;
+    xRenoWindow.ulCongestionWindow = 300U * TEST_MSS;
+
+    xCubicWindow.xSize.ulTxWindowLength = TEST_CUBIC_WINDOW_LENGTH;
+    xCubicWindow.tx.ulCurrentSequenceNumber++;
+    xCubicWindow.tx.ulHighestSequenceNumber++;
+    xCubicWindow.ulCongestionWindow = 300U * TEST_MSS;
+    xCubicWindow.xCubic.ulMinRTT = 100U;
+
+    /* Both lose a segment, which is repaired by fast recovery. */
+    prvTCPWindowCongestionOnDupAck( &xRenoWindow, 1U );
+    xRenoWindow.tx.ulCurrentSequenceNumber = xRenoWindow.tx.ulHighestSequenceNumber;
+    prvTCPWindowCongestionOnAck( &xRenoWindow, 300U * TEST_MSS );
+    TEST_ASSERT_EQUAL( 150U * TEST_MSS, xRenoWindow.ulCongestionWindow );
+
+    prvTCPWindowCongestionOnDupAck( &xCubicWindow, 1U );
+    xCubicWindow.tx.ulCurrentSequenceNumber = xCubicWindow.tx.ulHighestSequenceNumber;
+    prvTCPWindowCongestionOnAck( &xCubicWindow, 300U * TEST_MSS );
+    TEST_ASSERT_EQUAL( 210U * TEST_MSS, xCubicWindow.ulCongestionWindow );
+
+    ulRenoDelivered = prvSimulateRoundTrips( &xRenoWindow, 40U );
+    ulCubicDelivered = prvSimulateTimedRoundTrips( &xCubicWindow, 40U, 100U, &xTime );
+
+    TEST_ASSERT_GREATER_THAN( ulRenoDelivered, ulCubicDelivered );
+    TEST_ASSERT_LESS_THAN( 200U * TEST_MSS, xRenoWindow.ulCongestionWindow );
+    TEST_ASSERT_GREATER_THAN( 280U * TEST_MSS, xCubicWindow.ulCongestionWindow );
+}
+
+void test_ulTCPWindowTimestamp( void )
+{
+    xTaskGetTickCount_ExpectAndReturn( 1234U );
+
+    TEST_ASSERT_EQUAL( pdTICKS_TO_MS( 1234U ), ulTCPWindowTimestamp() );
+}
+
+void test_ulTCPWindowTimestamp_TickCountWraps( void )
+{
+    ulTimestampMS = 5000U;
+    xTimestampLastTick = ( TickType_t ) ( portMAX_DELAY - 9U );
+
+    /* 10 ticks before and 20 ticks after the wrap. */
+    xTaskGetTickCount_ExpectAndReturn( 20U );
+
+    TEST_ASSERT_EQUAL( 5000U + pdTICKS_TO_MS( 30U ), ulTCPWindowTimestamp() );
+}
+
+void test_prvTCPWindowTimestampRTT_SmallerRTT( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindowWithOps( &xWindow, 0U, &( xTCPCongestionCubic ) );
+    xWindow.lSRTT = 500;
+    xWindow.xTimeStamps.ulTSEcho = pdTICKS_TO_MS( 10000U ) - 100U;
+
+    xTaskGetTickCount_ExpectAndReturn( 10000U );
+    FreeRTOS_multiply_int32_ExpectAndReturn( 100, winSRTT_DECREMENT_NEW, 100 * winSRTT_DECREMENT_NEW );
+    FreeRTOS_multiply_int32_ExpectAndReturn( 500, winSRTT_DECREMENT_CURRENT, 500 * winSRTT_DECREMENT_CURRENT );
+    FreeRTOS_add_int32_ExpectAndReturn( 500 * winSRTT_DECREMENT_CURRENT, 100 * winSRTT_DECREMENT_NEW, 500 * winSRTT_DECREMENT_CURRENT + 100 * winSRTT_DECREMENT_NEW );
+
+    prvTCPWindowTimestampRTT( &xWindow );
+
+    TEST_ASSERT_EQUAL( ( 500 * winSRTT_DECREMENT_CURRENT + 100 * winSRTT_DECREMENT_NEW ) / ( winSRTT_DECREMENT_NEW + winSRTT_DECREMENT_CURRENT ), xWindow.lSRTT );
+    /* The sample also reaches the congestion control algorithm. */
+    TEST_ASSERT_EQUAL( 100U, xWindow.xCubic.ulMinRTT );
+}
+
+void test_prvTCPWindowTimestampRTT_LargerRTT( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindow( &xWindow, 0U );
+    xWindow.lSRTT = 500;
+    xWindow.xTimeStamps.ulTSEcho = pdTICKS_TO_MS( 10000U ) - 900U;
+
+    xTaskGetTickCount_ExpectAndReturn( 10000U );
+    FreeRTOS_multiply_int32_ExpectAndReturn( 900, winSRTT_INCREMENT_NEW, 900 * winSRTT_INCREMENT_NEW );
+    FreeRTOS_multiply_int32_ExpectAndReturn( 500, winSRTT_INCREMENT_CURRENT, 500 * winSRTT_INCREMENT_CURRENT );
+    FreeRTOS_add_int32_ExpectAndReturn( 500 * winSRTT_INCREMENT_CURRENT, 900 * winSRTT_INCREMENT_NEW, 500 * winSRTT_INCREMENT_CURRENT + 900 * winSRTT_INCREMENT_NEW );
+
+    prvTCPWindowTimestampRTT( &xWindow );
+
+    TEST_ASSERT_EQUAL( ( 500 * winSRTT_INCREMENT_CURRENT + 900 * winSRTT_INCREMENT_NEW ) / ( winSRTT_INCREMENT_NEW + winSRTT_INCREMENT_CURRENT ), xWindow.lSRTT );
+}
+
+void test_prvTCPWindowTimestampRTT_EchoFromTheFuture( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindowWithOps( &xWindow, 0U, &( xTCPCongestionCubic ) );
+    xWindow.lSRTT = 500;
+    xWindow.xTimeStamps.ulTSEcho = pdTICKS_TO_MS( 10000U ) + 50U;
+
+    xTaskGetTickCount_ExpectAndReturn( 10000U );
+
+    prvTCPWindowTimestampRTT( &xWindow );
+
+    /* A TSecr that was never sent is not a measurement. */
+    TEST_ASSERT_EQUAL( 500, xWindow.lSRTT );
+    TEST_ASSERT_EQUAL( 0U, xWindow.xCubic.ulMinRTT );
+}
+
+void test_ulTCPWindowTxAck_Timestamp_NothingNewAcked( void )
+{
+    TCPWindow_t xWindow;
+
+    prvPrepareWindow( &xWindow, 0U );
+    xWindow.lSRTT = 500;
+    xWindow.xTimeStamps.xReceived = pdTRUE;
+    xWindow.xTimeStamps.ulTSEcho = 0U;
+
+    /* A duplicate ACK does not yield an RTT sample, the clock is not read. */
+    TEST_ASSERT_EQUAL( 0U, ulTCPWindowTxAck( &xWindow, xWindow.tx.ulCurrentSequenceNumber ) );
+    TEST_ASSERT_EQUAL( 500, xWindow.lSRTT );
+}
+
+/* Two holes in the window: both are found lost by the same SACK, and both
+ * are queued for retransmission, the lowest sequence number first. */
+void test_prvTCPWindowSackScoreboard_MultipleHoles( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegments[ 6 ];
+    ListItem_t xItems[ 6 ];
+    const BaseType_t xSacked[ 6 ] = { pdFALSE, pdTRUE, pdFALSE, pdTRUE, pdTRUE, pdTRUE };
+
+    prvPrepareScoreboard( &xWindow, xSegments, xSacked, 6U );
+    xWindow.tx.ulCurrentSequenceNumber++;
+    xWindow.tx.ulHighestSequenceNumber++;
+
+    /* Count the SACK'd segments. */
+    prvExpectScoreboardWalk( &xWindow, xSegments, xItems, 6U, 6U );
+
+    /* Both holes have at least 3 SACK'd segments above them. */
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 0 ] ) );
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &( xSegments[ 0 ] ) );
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 1 ] ) );
+    uxListRemove_ExpectAndReturn( &( xSegments[ 0 ].xQueueItem ), 0U );
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &( xSegments[ 1 ] ) );
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 2 ] ) );
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &( xSegments[ 2 ] ) );
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 3 ] ) );
+    uxListRemove_ExpectAndReturn( &( xSegments[ 2 ].xQueueItem ), 0U );
+
+    /* Above segment 3, only 2 segments are SACK'd: the walk stops. */
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &( xSegments[ 3 ] ) );
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 4 ] ) );
+
+    TEST_ASSERT_EQUAL( 2U, prvTCPWindowSackScoreboard( &xWindow ) );
+
+    TEST_ASSERT_EQUAL( 2U, xWindow.xPriorityQueue.uxNumberOfItems );
+    TEST_ASSERT_EQUAL_PTR( &( xSegments[ 0 ].xQueueItem ), xWindow.xPriorityQueue.xListEnd.pxNext );
+    TEST_ASSERT_EQUAL_PTR( &( xSegments[ 2 ].xQueueItem ), xWindow.xPriorityQueue.xListEnd.pxPrevious );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSegments[ 0 ].u.bits.bLost );
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xSegments[ 2 ].u.bits.bLost );
+
+    /* The transmit count is kept, so that no RTT is sampled from the retransmission. */
+    TEST_ASSERT_EQUAL( 1U, xSegments[ 0 ].u.bits.ucTransmitCount );
+
+    /* Congestion control is only informed when the whole ACK was handled. */
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bFastRecovery );
+}
+
+/* Not enough SACK'd data to consider any segment lost. */
+void test_prvTCPWindowSackScoreboard_BelowThreshold( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegments[ 3 ];
+    ListItem_t xItems[ 3 ];
+    const BaseType_t xSacked[ 3 ] = { pdFALSE, pdTRUE, pdTRUE };
+
+    prvPrepareScoreboard( &xWindow, xSegments, xSacked, 3U );
+
+    prvExpectScoreboardWalk( &xWindow, xSegments, xItems, 3U, 3U );
+
+    /* The second walk does not start: 2 segments of 1 MSS are not enough. */
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 0 ] ) );
+
+    TEST_ASSERT_EQUAL( 0U, prvTCPWindowSackScoreboard( &xWindow ) );
+
+    TEST_ASSERT_EQUAL( 0U, xWindow.xPriorityQueue.uxNumberOfItems );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xSegments[ 0 ].u.bits.bLost );
+    TEST_ASSERT_EQUAL( pdFALSE_UNSIGNED, xWindow.u.bits.bFastRecovery );
+}
+
+/* Less than 3 SACK'd segments, but more than 2 * MSS SACK'd bytes. */
+void test_prvTCPWindowSackScoreboard_SackedBytes( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegments[ 3 ];
+    ListItem_t xItems[ 3 ];
+    const BaseType_t xSacked[ 3 ] = { pdFALSE, pdTRUE, pdTRUE };
+
+    prvPrepareScoreboard( &xWindow, xSegments, xSacked, 3U );
+    xSegments[ 2 ].lDataLength = ( int32_t ) TEST_MSS + 1;
+
+    prvExpectScoreboardWalk( &xWindow, xSegments, xItems, 3U, 3U );
+
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 0 ] ) );
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &( xSegments[ 0 ] ) );
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 1 ] ) );
+    uxListRemove_ExpectAndReturn( &( xSegments[ 0 ].xQueueItem ), 0U );
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &( xSegments[ 1 ] ) );
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 2 ] ) );
+
+    TEST_ASSERT_EQUAL( 1U, prvTCPWindowSackScoreboard( &xWindow ) );
+    TEST_ASSERT_EQUAL_PTR( &( xWindow.xPriorityQueue ), xSegments[ 0 ].xQueueItem.pxContainer );
+}
+
+/* A segment that was already found lost, or that is waiting in the priority
+ * queue, is not queued again when more SACK's come in. */
+void test_prvTCPWindowSackScoreboard_AlreadyQueued( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegments[ 5 ];
+    ListItem_t xItems[ 5 ];
+    const BaseType_t xSacked[ 5 ] = { pdFALSE, pdFALSE, pdTRUE, pdTRUE, pdTRUE };
+
+    prvPrepareScoreboard( &xWindow, xSegments, xSacked, 5U );
+    xSegments[ 0 ].u.bits.bLost = pdTRUE_UNSIGNED;
+    xSegments[ 1 ].xQueueItem.pxContainer = &( xWindow.xPriorityQueue );
+
+    prvExpectScoreboardWalk( &xWindow, xSegments, xItems, 5U, 5U );
+
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 0 ] ) );
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &( xSegments[ 0 ] ) );
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 1 ] ) );
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &( xSegments[ 1 ] ) );
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 2 ] ) );
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( &( xSegments[ 2 ] ) );
+    listGET_NEXT_ExpectAnyArgsAndReturn( &( xItems[ 3 ] ) );
+
+    TEST_ASSERT_EQUAL( 0U, prvTCPWindowSackScoreboard( &xWindow ) );
+    TEST_ASSERT_EQUAL( 0U, xWindow.xPriorityQueue.uxNumberOfItems );
+}
+
+/* An ACK with three SACK blocks that together reveal two losses: fast
+ * recovery is entered once, when the ACK has been handled. */
+void test_vTCPWindowTxSackDone_EnterFastRecovery( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegments[ 1 ];
+    const BaseType_t xSacked[ 1 ] = { pdFALSE };
+    uint32_t ulBlock;
+
+    prvPrepareScoreboard( &xWindow, xSegments, xSacked, 0U );
+    xWindow.tx.ulCurrentSequenceNumber++;
+    xWindow.tx.ulHighestSequenceNumber += 10U * TEST_MSS;
+
+    for( ulBlock = 0U; ulBlock < 3U; ulBlock++ )
+    {
+        /* Nothing new is acknowledged, the scoreboard finds no segments. */
+        prvExpectScoreboardWalk( &xWindow, xSegments, NULL, 0U, 0U );
+        listGET_NEXT_ExpectAnyArgsAndReturn( ( ListItem_t * ) &( xWindow.xTxSegments.xListEnd ) );
+
+        ( void ) ulTCPWindowTxSack( &xWindow, xWindow.tx.ulCurrentSequenceNumber + TEST_MSS, xWindow.tx.ulCurrentSequenceNumber + ( 2U * TEST_MSS ) );
+    }
+
+    /* As if the scoreboard had queued two segments over the three blocks. */
+    xWindow.ulSackRetransmitCount = 2U;
+
+    vTCPWindowTxSackDone( &xWindow );
+
+    TEST_ASSERT_EQUAL( pdTRUE_UNSIGNED, xWindow.u.bits.bFastRecovery );
+    TEST_ASSERT_EQUAL( xWindow.ulSlowStartThreshold + ( 3U * TEST_MSS ), xWindow.ulCongestionWindow );
+    TEST_ASSERT_EQUAL( 0U, xWindow.ulSackRetransmitCount );
+}
+
+/* During fast recovery, an ACK with three SACK blocks inflates cwnd by one
+ * MSS, not by one MSS per block. */
+void test_vTCPWindowTxSackDone_InflateOncePerAck( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegments[ 1 ];
+    const BaseType_t xSacked[ 1 ] = { pdFALSE };
+    uint32_t ulBlock;
+    uint32_t ulWindow;
+
+    prvPrepareScoreboard( &xWindow, xSegments, xSacked, 0U );
+    xWindow.u.bits.bFastRecovery = pdTRUE_UNSIGNED;
+    ulWindow = xWindow.ulCongestionWindow;
+
+    for( ulBlock = 0U; ulBlock < 3U; ulBlock++ )
+    {
+        prvExpectScoreboardWalk( &xWindow, xSegments, NULL, 0U, 0U );
+        listGET_NEXT_ExpectAnyArgsAndReturn( ( ListItem_t * ) &( xWindow.xTxSegments.xListEnd ) );
+
+        ( void ) ulTCPWindowTxSack( &xWindow, xWindow.tx.ulCurrentSequenceNumber + TEST_MSS, xWindow.tx.ulCurrentSequenceNumber + ( 2U * TEST_MSS ) );
+    }
+
+    /* Handling the SACK blocks does not touch cwnd. */
+    TEST_ASSERT_EQUAL( ulWindow, xWindow.ulCongestionWindow );
+
+    vTCPWindowTxSackDone( &xWindow );
+
+    TEST_ASSERT_EQUAL( ulWindow + TEST_MSS, xWindow.ulCongestionWindow );
+}
+
+/* Segments are added to the TX index in ascending order: the tree must stay
+ * balanced. */
+void test_prvTCPWindowIndexInsert_Ascending( void )
+{
+    static TCPSegment_t xSegments[ TEST_INDEX_SEGMENTS ];
+    TCPSegment_t * pxRoot = NULL;
+    size_t uxIndex;
+
+    prvPrepareIndexSegments( xSegments, TEST_INDEX_SEGMENTS, 1000U );
+
+    for( uxIndex = 0U; uxIndex < TEST_INDEX_SEGMENTS; uxIndex++ )
+    {
+        prvTCPWindowIndexInsert( &pxRoot, &( xSegments[ uxIndex ] ) );
+    }
+
+    TEST_ASSERT_EQUAL( TEST_INDEX_SEGMENTS, prvCheckIndex( pxRoot, NULL ) );
+
+    /* 256 segments fit in a tree of height 9. */
+    TEST_ASSERT_EQUAL( 9, pxRoot->xIndexHeight );
+}
+
+/* The TX window frees its segments from the left edge. */
+void test_prvTCPWindowIndexRemove_LeftEdge( void )
+{
+    static TCPSegment_t xSegments[ TEST_INDEX_SEGMENTS ];
+    TCPSegment_t * pxRoot = NULL;
+    size_t uxIndex;
+
+    prvPrepareIndexSegments( xSegments, TEST_INDEX_SEGMENTS, 1000U );
+
+    for( uxIndex = 0U; uxIndex < TEST_INDEX_SEGMENTS; uxIndex++ )
+    {
+        prvTCPWindowIndexInsert( &pxRoot, &( xSegments[ uxIndex ] ) );
+    }
+
+    for( uxIndex = 0U; uxIndex < TEST_INDEX_SEGMENTS; uxIndex++ )
+    {
+        TEST_ASSERT_EQUAL_PTR( &( xSegments[ uxIndex ] ), prvTCPWindowIndexLowerBound( pxRoot, 1000U ) );
+
+        prvTCPWindowIndexRemove( &pxRoot, &( xSegments[ uxIndex ] ) );
+
+        TEST_ASSERT_EQUAL( TEST_INDEX_SEGMENTS - uxIndex - 1U, prvCheckIndex( pxRoot, NULL ) );
+        TEST_ASSERT_NULL( xSegments[ uxIndex ].pxIndexParent );
+    }
+
+    TEST_ASSERT_NULL( pxRoot );
+}
+
+/* Out-of-order arrival and removal, with sequence numbers that wrap around. */
+void test_prvTCPWindowIndex_RandomOrder_WrapAround( void )
+{
+    static TCPSegment_t xSegments[ TEST_INDEX_SEGMENTS ];
+    TCPSegment_t * pxRoot = NULL;
+    uint32_t ulFirst = 0xFFFFFFFFU - ( 100U * TEST_MSS );
+    size_t uxIndex;
+    size_t uxPosition;
+
+    prvPrepareIndexSegments( xSegments, TEST_INDEX_SEGMENTS, ulFirst );
+
+    /* 37 and 256 are co-prime: every segment is inserted exactly once. */
+    for( uxIndex = 0U; uxIndex < TEST_INDEX_SEGMENTS; uxIndex++ )
+    {
+        uxPosition = ( uxIndex * 37U ) % TEST_INDEX_SEGMENTS;
+        prvTCPWindowIndexInsert( &pxRoot, &( xSegments[ uxPosition ] ) );
+    }
+
+    TEST_ASSERT_EQUAL( TEST_INDEX_SEGMENTS, prvCheckIndex( pxRoot, NULL ) );
+
+    /* Remove every segment at an odd position, in a different order. */
+    for( uxIndex = 0U; uxIndex < TEST_INDEX_SEGMENTS; uxIndex++ )
+    {
+        uxPosition = ( uxIndex * 101U ) % TEST_INDEX_SEGMENTS;
+
+        if( ( uxPosition & 1U ) != 0U )
+        {
+            prvTCPWindowIndexRemove( &pxRoot, &( xSegments[ uxPosition ] ) );
+        }
+    }
+
+    TEST_ASSERT_EQUAL( TEST_INDEX_SEGMENTS / 2U, prvCheckIndex( pxRoot, NULL ) );
+
+    /* A look-up for a removed segment finds the next one, also across the wrap. */
+    for( uxIndex = 1U; uxIndex < ( TEST_INDEX_SEGMENTS - 1U ); uxIndex += 2U )
+    {
+        TEST_ASSERT_EQUAL_PTR( &( xSegments[ uxIndex + 1U ] ), prvTCPWindowIndexLowerBound( pxRoot, xSegments[ uxIndex ].ulSequenceNumber ) );
+    }
+
+    TEST_ASSERT_NULL( prvTCPWindowIndexLowerBound( pxRoot, xSegments[ TEST_INDEX_SEGMENTS - 1U ].ulSequenceNumber ) );
+}
+
+void test_xTCPWindowRxFind_Index( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegments[ 3 ];
+
+    memset( &xWindow, 0, sizeof( xWindow ) );
+    prvPrepareIndexSegments( xSegments, 3U, 5000U );
+
+    prvTCPWindowIndexInsert( &( xWindow.pxRxSegmentIndex ), &( xSegments[ 2 ] ) );
+    prvTCPWindowIndexInsert( &( xWindow.pxRxSegmentIndex ), &( xSegments[ 0 ] ) );
+
+    TEST_ASSERT_EQUAL_PTR( &( xSegments[ 0 ] ), xTCPWindowRxFind( &xWindow, 5000U ) );
+    TEST_ASSERT_EQUAL_PTR( &( xSegments[ 2 ] ), xTCPWindowRxFind( &xWindow, 5000U + ( 2U * TEST_MSS ) ) );
+    TEST_ASSERT_NULL( xTCPWindowRxFind( &xWindow, 5000U + TEST_MSS ) );
+    TEST_ASSERT_NULL( xTCPWindowRxFind( &xWindow, 5000U + ( 3U * TEST_MSS ) ) );
+}
+
+void test_xTCPWindowRxConfirm_Index( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegments[ 4 ];
+
+    memset( &xWindow, 0, sizeof( xWindow ) );
+    prvPrepareIndexSegments( xSegments, 4U, 5000U );
+
+    prvTCPWindowIndexInsert( &( xWindow.pxRxSegmentIndex ), &( xSegments[ 3 ] ) );
+    prvTCPWindowIndexInsert( &( xWindow.pxRxSegmentIndex ), &( xSegments[ 1 ] ) );
+
+    /* The lowest stored segment within the received range is returned. */
+    TEST_ASSERT_EQUAL_PTR( &( xSegments[ 1 ] ), xTCPWindowRxConfirm( &xWindow, 5000U, 4U * TEST_MSS ) );
+    TEST_ASSERT_EQUAL_PTR( &( xSegments[ 1 ] ), xTCPWindowRxConfirm( &xWindow, 5000U + TEST_MSS, TEST_MSS ) );
+
+    /* Nothing stored within the range. */
+    TEST_ASSERT_NULL( xTCPWindowRxConfirm( &xWindow, 5000U, TEST_MSS ) );
+    TEST_ASSERT_NULL( xTCPWindowRxConfirm( &xWindow, 5000U + ( 4U * TEST_MSS ), TEST_MSS ) );
+}
+
+/* Segments added in descending order: every insertion needs a right
+ * rotation. */
+void test_prvTCPWindowIndexInsert_Descending( void )
+{
+    static TCPSegment_t xSegments[ TEST_INDEX_SEGMENTS ];
+    static TCPSegment_t * pxOrder[ TEST_INDEX_SEGMENTS ];
+    TCPSegment_t * pxRoot = NULL;
+    size_t uxIndex;
+
+    prvPrepareIndexSegments( xSegments, TEST_INDEX_SEGMENTS, 1000U );
+
+    for( uxIndex = TEST_INDEX_SEGMENTS; uxIndex > 0U; uxIndex-- )
+    {
+        prvTCPWindowIndexInsert( &pxRoot, &( xSegments[ uxIndex - 1U ] ) );
+    }
+
+    TEST_ASSERT_EQUAL( TEST_INDEX_SEGMENTS, prvCheckIndex( pxRoot, NULL ) );
+    TEST_ASSERT_EQUAL( 9, pxRoot->xIndexHeight );
+
+    /* An in-order walk visits the segments in ascending order. */
+    TEST_ASSERT_EQUAL( TEST_INDEX_SEGMENTS, prvCollectIndex( pxRoot, pxOrder, 0U ) );
+
+    for( uxIndex = 0U; uxIndex < TEST_INDEX_SEGMENTS; uxIndex++ )
+    {
+        TEST_ASSERT_EQUAL_PTR( &( xSegments[ uxIndex ] ), pxOrder[ uxIndex ] );
+    }
+}
+
+/* The four rebalancing cases of an AVL tree, each with three segments. */
+void test_prvTCPWindowIndexInsert_Rotations( void )
+{
+    /* The order of insertion for a left-left, right-right, left-right and
+     * right-left imbalance. */
+    static const size_t uxOrders[ 4 ][ 3 ] =
+    {
+        { 2U, 1U, 0U },
+        { 0U, 1U, 2U },
+        { 2U, 0U, 1U },
+        { 0U, 2U, 1U }
+    };
+    TCPSegment_t xSegments[ 3 ];
+    TCPSegment_t * pxRoot;
+    size_t uxCase;
+    size_t uxIndex;
+
+    for( uxCase = 0U; uxCase < 4U; uxCase++ )
+    {
+        pxRoot = NULL;
+        prvPrepareIndexSegments( xSegments, 3U, 1000U );
+
+        for( uxIndex = 0U; uxIndex < 3U; uxIndex++ )
+        {
+            prvTCPWindowIndexInsert( &pxRoot, &( xSegments[ uxOrders[ uxCase ][ uxIndex ] ] ) );
+        }
+
+        /* The middle segment always ends up as the root. */
+        TEST_ASSERT_EQUAL( 3U, prvCheckIndex( pxRoot, NULL ) );
+        TEST_ASSERT_EQUAL_PTR( &( xSegments[ 1 ] ), pxRoot );
+        TEST_ASSERT_EQUAL_PTR( &( xSegments[ 0 ] ), pxRoot->pxIndexLeft );
+        TEST_ASSERT_EQUAL_PTR( &( xSegments[ 2 ] ), pxRoot->pxIndexRight );
+        TEST_ASSERT_EQUAL( 2, pxRoot->xIndexHeight );
+    }
+}
+
+/* Removing a segment with two children, the root in particular, keeps the
+ * tree ordered and balanced. */
+void test_prvTCPWindowIndexRemove_InnerNodes( void )
+{
+    static TCPSegment_t xSegments[ TEST_INDEX_SEGMENTS ];
+    TCPSegment_t * pxRoot = NULL;
+    TCPSegment_t * pxRemoved;
+    size_t uxIndex;
+    size_t uxCount = TEST_INDEX_SEGMENTS;
+
+    prvPrepareIndexSegments( xSegments, TEST_INDEX_SEGMENTS, 1000U );
+
+    for( uxIndex = 0U; uxIndex < TEST_INDEX_SEGMENTS; uxIndex++ )
+    {
+        prvTCPWindowIndexInsert( &pxRoot, &( xSegments[ uxIndex ] ) );
+    }
+
+    while( pxRoot != NULL )
+    {
+        pxRemoved = pxRoot;
+        prvTCPWindowIndexRemove( &pxRoot, pxRemoved );
+        uxCount--;
+
+        TEST_ASSERT_EQUAL( uxCount, prvCheckIndex( pxRoot, NULL ) );
+        TEST_ASSERT_NULL( pxRemoved->pxIndexParent );
+        TEST_ASSERT_NULL( pxRemoved->pxIndexLeft );
+        TEST_ASSERT_NULL( pxRemoved->pxIndexRight );
+    }
+
+    TEST_ASSERT_EQUAL( 0U, uxCount );
+}
+
+/* The lower-bound look-up finds an exact match, or else the next segment. */
+void test_prvTCPWindowIndexLowerBound( void )
+{
+    TCPSegment_t xSegments[ 8 ];
+    TCPSegment_t * pxRoot = NULL;
+    size_t uxIndex;
+
+    TEST_ASSERT_NULL( prvTCPWindowIndexLowerBound( pxRoot, 1000U ) );
+
+    prvPrepareIndexSegments( xSegments, 8U, 1000U );
+
+    for( uxIndex = 0U; uxIndex < 8U; uxIndex++ )
+    {
+        prvTCPWindowIndexInsert( &pxRoot, &( xSegments[ ( uxIndex * 3U ) % 8U ] ) );
+    }
+
+    for( uxIndex = 0U; uxIndex < 8U; uxIndex++ )
+    {
+        TEST_ASSERT_EQUAL_PTR( &( xSegments[ uxIndex ] ), prvTCPWindowIndexLowerBound( pxRoot, xSegments[ uxIndex ].ulSequenceNumber ) );
+        TEST_ASSERT_EQUAL_PTR( &( xSegments[ uxIndex ] ), prvTCPWindowIndexLowerBound( pxRoot, xSegments[ uxIndex ].ulSequenceNumber - 1U ) );
+    }
+
+    /* Below the first segment, and beyond the last one. */
+    TEST_ASSERT_EQUAL_PTR( &( xSegments[ 0 ] ), prvTCPWindowIndexLowerBound( pxRoot, 1U ) );
+    TEST_ASSERT_NULL( prvTCPWindowIndexLowerBound( pxRoot, xSegments[ 7 ].ulSequenceNumber + 1U ) );
+}
+
+/* Segments inserted in ascending order across the 32-bit wrap of the
+ * sequence numbers are kept in sequence order, not in numerical order. */
+void test_prvTCPWindowIndex_Ascending_WrapAround( void )
+{
+    static TCPSegment_t xSegments[ TEST_INDEX_SEGMENTS ];
+    static TCPSegment_t * pxOrder[ TEST_INDEX_SEGMENTS ];
+    TCPSegment_t * pxRoot = NULL;
+    uint32_t ulFirst = 0U - ( ( TEST_INDEX_SEGMENTS / 2U ) * TEST_MSS );
+    size_t uxIndex;
+
+    prvPrepareIndexSegments( xSegments, TEST_INDEX_SEGMENTS, ulFirst );
+
+    /* Half of the segments lie before the wrap. */
+    TEST_ASSERT_EQUAL_UINT32( 0U, xSegments[ TEST_INDEX_SEGMENTS / 2U ].ulSequenceNumber );
+
+    for( uxIndex = 0U; uxIndex < TEST_INDEX_SEGMENTS; uxIndex++ )
+    {
+        prvTCPWindowIndexInsert( &pxRoot, &( xSegments[ uxIndex ] ) );
+    }
+
+    TEST_ASSERT_EQUAL( TEST_INDEX_SEGMENTS, prvCheckIndex( pxRoot, NULL ) );
+    TEST_ASSERT_EQUAL( TEST_INDEX_SEGMENTS, prvCollectIndex( pxRoot, pxOrder, 0U ) );
+
+    for( uxIndex = 0U; uxIndex < TEST_INDEX_SEGMENTS; uxIndex++ )
+    {
+        TEST_ASSERT_EQUAL_PTR( &( xSegments[ uxIndex ] ), pxOrder[ uxIndex ] );
+    }
+
+    /* The look-up of the first sequence number does not jump past the wrap. */
+    TEST_ASSERT_EQUAL_PTR( &( xSegments[ 0 ] ), prvTCPWindowIndexLowerBound( pxRoot, ulFirst ) );
+    TEST_ASSERT_EQUAL_PTR( &( xSegments[ TEST_INDEX_SEGMENTS / 2U ] ), prvTCPWindowIndexLowerBound( pxRoot, 0xFFFFFFFFU ) );
+
+    /* Free the window from its left edge, across the wrap. */
+    for( uxIndex = 0U; uxIndex < TEST_INDEX_SEGMENTS; uxIndex++ )
+    {
+        TEST_ASSERT_EQUAL_PTR( &( xSegments[ uxIndex ] ), prvTCPWindowIndexLowerBound( pxRoot, ulFirst ) );
+        prvTCPWindowIndexRemove( &pxRoot, &( xSegments[ uxIndex ] ) );
+        TEST_ASSERT_EQUAL( TEST_INDEX_SEGMENTS - uxIndex - 1U, prvCheckIndex( pxRoot, NULL ) );
+    }
+
+    TEST_ASSERT_NULL( pxRoot );
+}
+
+void test_prvTCPWindowGrowArena_UpToCapacity( void )
+{
+    TCPSegment_t xSegments[ ipconfigTCP_WIN_SEG_COUNT ];
+    BaseType_t xReturn;
+
+    /* The first chunk also initialises the pool. */
+    vListInitialise_ExpectAnyArgs();
+    pvPortMalloc_ExpectAnyArgsAndReturn( &( xSegments[ 0 ] ) );
+    listSET_LIST_ITEM_OWNER_ExpectAnyArgs();
+    listSET_LIST_ITEM_OWNER_ExpectAnyArgs();
+
+    xReturn = prvTCPWindowGrowArena();
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL_PTR( &( xSegments[ 0 ] ), pxTCPSegmentChunks[ 0 ] );
+    TEST_ASSERT_EQUAL( 1U, xTCPSegmentStats.uxAllocated );
+    TEST_ASSERT_EQUAL( 1U, xSegmentList.uxNumberOfItems );
+
+    pvPortMalloc_ExpectAnyArgsAndReturn( &( xSegments[ 1 ] ) );
+    listSET_LIST_ITEM_OWNER_ExpectAnyArgs();
+    listSET_LIST_ITEM_OWNER_ExpectAnyArgs();
+
+    xReturn = prvTCPWindowGrowArena();
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL_PTR( &( xSegments[ 1 ] ), pxTCPSegmentChunks[ 1 ] );
+    TEST_ASSERT_EQUAL( 2U, xTCPSegmentStats.uxAllocated );
+    TEST_ASSERT_EQUAL( 2U, xSegmentList.uxNumberOfItems );
+
+    /* The arena has reached ipconfigTCP_WIN_SEG_COUNT. */
+    xReturn = prvTCPWindowGrowArena();
+
+    TEST_ASSERT_EQUAL( pdFAIL, xReturn );
+    TEST_ASSERT_EQUAL( 2U, xTCPSegmentStats.uxAllocated );
+}
+
+void test_prvTCPWindowGrowArena_AllocationFailed( void )
+{
+    BaseType_t xReturn;
+
+    vListInitialise_ExpectAnyArgs();
+    pvPortMalloc_ExpectAnyArgsAndReturn( NULL );
+
+    xReturn = prvTCPWindowGrowArena();
+
+    TEST_ASSERT_EQUAL( pdFAIL, xReturn );
+    TEST_ASSERT_NULL( pxTCPSegmentChunks[ 0 ] );
+    TEST_ASSERT_EQUAL( 0U, xTCPSegmentStats.uxAllocated );
+}
+
+void test_prvTCPWindowArenaAllow_QuotaReached( void )
+{
+    TCPWindow_t xWindow;
+
+    memset( &xWindow, 0, sizeof( xWindow ) );
+    xWindow.uxSegmentCount = ipconfigTCP_WIN_SEG_QUOTA;
+    xWindow.uxSegmentsReserved = 1U;
+
+    TEST_ASSERT_EQUAL( pdFALSE, prvTCPWindowArenaAllow( &xWindow ) );
+    TEST_ASSERT_EQUAL( 1U, xTCPSegmentStats.ulQuotaRefusals );
+    TEST_ASSERT_EQUAL( 0U, xTCPSegmentStats.ulReserveRefusals );
+}
+
+void test_prvTCPWindowArenaAllow_Reservation( void )
+{
+    TCPWindow_t xWindow;
+
+    memset( &xWindow, 0, sizeof( xWindow ) );
+
+    /* One descriptor is in use, the other one is reserved for another socket. */
+    xTCPSegmentStats.uxAllocated = 2U;
+    xTCPSegmentStats.uxInUse = 1U;
+    xTCPSegmentStats.uxReserved = 1U;
+    xWindow.uxSegmentCount = 1U;
+
+    TEST_ASSERT_EQUAL( pdFALSE, prvTCPWindowArenaAllow( &xWindow ) );
+    TEST_ASSERT_EQUAL( 1U, xTCPSegmentStats.ulReserveRefusals );
+
+    /* A socket may always use its own reservation. */
+    xWindow.uxSegmentCount = 0U;
+    xWindow.uxSegmentsReserved = 1U;
+
+    TEST_ASSERT_EQUAL( pdTRUE, prvTCPWindowArenaAllow( &xWindow ) );
+    TEST_ASSERT_EQUAL( 1U, xTCPSegmentStats.ulReserveRefusals );
+    TEST_ASSERT_EQUAL( 0U, xTCPSegmentStats.ulQuotaRefusals );
+}
+
+void test_prvTCPWindowArenaAllow_Grows( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegment;
+
+    memset( &xWindow, 0, sizeof( xWindow ) );
+    xWindow.uxSegmentsReserved = 1U;
+
+    /* All allocated descriptors are in use: a new chunk is added. */
+    vListInitialise_ExpectAnyArgs();
+    pvPortMalloc_ExpectAnyArgsAndReturn( &xSegment );
+    listSET_LIST_ITEM_OWNER_ExpectAnyArgs();
+    listSET_LIST_ITEM_OWNER_ExpectAnyArgs();
+
+    TEST_ASSERT_EQUAL( pdTRUE, prvTCPWindowArenaAllow( &xWindow ) );
+    TEST_ASSERT_EQUAL( 1U, xTCPSegmentStats.uxAllocated );
+}
+
+void test_prvTCPWindowRelease_RestoresReservation( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegment;
+
+    memset( &xWindow, 0, sizeof( xWindow ) );
+    prvPrepareIndexSegments( &xSegment, 1U, 5000U );
+    xSegment.u.bits.bIsForRx = pdTRUE_UNSIGNED;
+    prvTCPWindowIndexInsert( &( xWindow.pxRxSegmentIndex ), &xSegment );
+
+    xWindow.uxSegmentCount = 1U;
+    xTCPSegmentStats.uxInUse = 1U;
+
+    prvTCPWindowRelease( &xWindow, &xSegment );
+
+    TEST_ASSERT_NULL( xWindow.pxRxSegmentIndex );
+    TEST_ASSERT_EQUAL( 0U, xWindow.uxSegmentCount );
+    TEST_ASSERT_EQUAL( 1U, xWindow.uxSegmentsReserved );
+    TEST_ASSERT_EQUAL( 1U, xTCPSegmentStats.uxReserved );
+    TEST_ASSERT_EQUAL( 0U, xTCPSegmentStats.uxInUse );
+    TEST_ASSERT_EQUAL( 1U, xSegmentList.uxNumberOfItems );
+}
+
+void test_xTCPWindowCreate_Arena_Reservation( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegment;
+    BaseType_t xReturn;
+    TCPSegmentStats_t xStats;
+
+    memset( &xWindow, 0, sizeof( xWindow ) );
+
+    /* The first window lets the arena grow with one chunk. */
+    vListInitialise_ExpectAnyArgs();
+    pvPortMalloc_ExpectAnyArgsAndReturn( &xSegment );
+    listSET_LIST_ITEM_OWNER_ExpectAnyArgs();
+    listSET_LIST_ITEM_OWNER_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+
+    xReturn = xTCPWindowCreate( &xWindow, TEST_TX_WINDOW_LENGTH, TEST_TX_WINDOW_LENGTH, 1000U, 2000U, TEST_MSS );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL( ipconfigTCP_WIN_SEG_RESERVED, xWindow.uxSegmentsReserved );
+
+    /* Creating the window again does not reserve twice: the old reservation
+     * is given back first. */
+    listLIST_IS_INITIALISED_ExpectAnyArgsAndReturn( pdFALSE );
+    listLIST_IS_INITIALISED_ExpectAnyArgsAndReturn( pdFALSE );
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+
+    xReturn = xTCPWindowCreate( &xWindow, TEST_TX_WINDOW_LENGTH, TEST_TX_WINDOW_LENGTH, 1000U, 2000U, TEST_MSS );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+
+    vTCPSegmentGetStats( &xStats );
+    TEST_ASSERT_EQUAL( ipconfigTCP_WIN_SEG_COUNT, xStats.uxCapacity );
+    TEST_ASSERT_EQUAL( 1U, xStats.uxAllocated );
+    TEST_ASSERT_EQUAL( 0U, xStats.uxInUse );
+    TEST_ASSERT_EQUAL( ipconfigTCP_WIN_SEG_RESERVED, xStats.uxReserved );
+
+    /* Destroying the window gives back its reservation. */
+    listLIST_IS_INITIALISED_ExpectAnyArgsAndReturn( pdFALSE );
+    listLIST_IS_INITIALISED_ExpectAnyArgsAndReturn( pdFALSE );
+
+    vTCPWindowDestroy( &xWindow );
+
+    vTCPSegmentGetStats( &xStats );
+    TEST_ASSERT_EQUAL( 0U, xStats.uxReserved );
+}
+
+/* A stub for uxListRemove() that really unlinks the item. */
+static UBaseType_t prvListRemoveStub( ListItem_t * const pxItemToRemove,
+                                      int cmock_num_calls )
+{
+    List_t * pxList = pxItemToRemove->pxContainer;
+
+    ( void ) cmock_num_calls;
+
+    pxItemToRemove->pxNext->pxPrevious = pxItemToRemove->pxPrevious;
+    pxItemToRemove->pxPrevious->pxNext = pxItemToRemove->pxNext;
+    pxItemToRemove->pxContainer = NULL;
+    pxList->uxNumberOfItems--;
+
+    return pxList->uxNumberOfItems;
+}
+
+/* Create the window of a connecting socket, and let it take the only
+ * descriptor of the arena, out of its reservation. */
+static void prvConnectWindow( TCPWindow_t * pxWindow,
+                              TCPSegment_t * pxSegment,
+                              BaseType_t xFirst )
+{
+    BaseType_t xReturn;
+
+    if( xFirst != pdFALSE )
+    {
+        /* The first window lets the arena grow with one chunk. */
+        vListInitialise_ExpectAnyArgs();
+        pvPortMalloc_ExpectAnyArgsAndReturn( pxSegment );
+        listSET_LIST_ITEM_OWNER_ExpectAnyArgs();
+        listSET_LIST_ITEM_OWNER_ExpectAnyArgs();
+    }
+
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+
+    xReturn = xTCPWindowCreate( pxWindow, TEST_TX_WINDOW_LENGTH, TEST_TX_WINDOW_LENGTH, 1000U, 2000U, TEST_MSS );
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+
+    /* vListInitialise() is mocked. */
+    initializeList( &( pxWindow->xTxSegments ) );
+    initializeList( &( pxWindow->xRxSegments ) );
+
+    listLIST_IS_EMPTY_ExpectAnyArgsAndReturn( pdFALSE );
+    listGET_HEAD_ENTRY_ExpectAnyArgsAndReturn( &( pxSegment->xSegmentItem ) );
+    listGET_LIST_ITEM_OWNER_ExpectAnyArgsAndReturn( pxSegment );
+    xTaskGetTickCount_ExpectAndReturn( 0U );
+    listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( 0U );
+
+    TEST_ASSERT_EQUAL_PTR( pxSegment, xTCPWindowNew( pxWindow, 2000U, ( int32_t ) TEST_MSS, pdFALSE ) );
+    TEST_ASSERT_EQUAL( 1U, xTCPSegmentStats.uxInUse );
+    TEST_ASSERT_EQUAL( 0U, xTCPSegmentStats.uxReserved );
+}
+
+/* Let vTCPWindowDestroy() find 'pxSegment' in the TX segments of a window. */
+static void prvExpectDestroy( TCPSegment_t * pxSegment )
+{
+    listLIST_IS_INITIALISED_ExpectAnyArgsAndReturn( pdTRUE );
+    listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( 1U );
+    listGET_OWNER_OF_HEAD_ENTRY_ExpectAnyArgsAndReturn( pxSegment );
+    listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( 0U );
+    listLIST_IS_INITIALISED_ExpectAnyArgsAndReturn( pdTRUE );
+    listCURRENT_LIST_LENGTH_ExpectAnyArgsAndReturn( 0U );
+}
+
+/* listen -> connect -> close -> listen: FreeRTOS_listen() destroys the window
+ * of a reused socket before clearing it, nothing may leak. */
+void test_vTCPWindowDestroy_ReuseSocket( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegment;
+    TCPSegmentStats_t xStart;
+    TCPSegmentStats_t xStats;
+
+    uxListRemove_Stub( prvListRemoveStub );
+    memset( &xWindow, 0, sizeof( xWindow ) );
+    vTCPSegmentGetStats( &xStart );
+
+    prvConnectWindow( &xWindow, &xSegment, pdTRUE );
+
+    prvExpectDestroy( &xSegment );
+    vTCPWindowDestroy( &xWindow );
+
+    TEST_ASSERT_EQUAL( 0U, xWindow.uxSegmentCount );
+    TEST_ASSERT_EQUAL( 0U, xWindow.uxSegmentsReserved );
+
+    memset( &xWindow, 0, sizeof( xWindow ) );
+
+    vTCPSegmentGetStats( &xStats );
+    TEST_ASSERT_EQUAL( xStart.uxInUse, xStats.uxInUse );
+    TEST_ASSERT_EQUAL( xStart.uxReserved, xStats.uxReserved );
+    TEST_ASSERT_EQUAL( 1U, xSegmentList.uxNumberOfItems );
+
+    /* The next connection finds the descriptor again. */
+    prvConnectWindow( &xWindow, &xSegment, pdFALSE );
+}
+
+/* A socket that connects again, without being closed, gives back the
+ * descriptors of its previous connection when its window is created. */
+void test_xTCPWindowCreate_Arena_OwnsSegments( void )
+{
+    TCPWindow_t xWindow;
+    TCPSegment_t xSegment;
+    TCPSegmentStats_t xStats;
+    BaseType_t xReturn;
+
+    uxListRemove_Stub( prvListRemoveStub );
+    memset( &xWindow, 0, sizeof( xWindow ) );
+
+    prvConnectWindow( &xWindow, &xSegment, pdTRUE );
+
+    prvExpectDestroy( &xSegment );
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+    vListInitialise_ExpectAnyArgs();
+
+    xReturn = xTCPWindowCreate( &xWindow, TEST_TX_WINDOW_LENGTH, TEST_TX_WINDOW_LENGTH, 1000U, 2000U, TEST_MSS );
+
+    TEST_ASSERT_EQUAL( pdPASS, xReturn );
+    TEST_ASSERT_EQUAL( 0U, xWindow.uxSegmentCount );
+    TEST_ASSERT_EQUAL( ipconfigTCP_WIN_SEG_RESERVED, xWindow.uxSegmentsReserved );
+
+    vTCPSegmentGetStats( &xStats );
+    TEST_ASSERT_EQUAL( 0U, xStats.uxInUse );
+    TEST_ASSERT_EQUAL( ipconfigTCP_WIN_SEG_RESERVED, xStats.uxReserved );
+    TEST_ASSERT_EQUAL( 1U, xSegmentList.uxNumberOfItems );
+}
+
+void test_vTCPSegmentGetStats( void )
+{
+    TCPSegmentStats_t xStats;
+
+    xTCPSegmentStats.uxAllocated = 2U;
+    xTCPSegmentStats.uxInUse = 1U;
+    xTCPSegmentStats.uxHighWater = 2U;
+    xTCPSegmentStats.ulQuotaRefusals = 3U;
+    xTCPSegmentStats.ulReserveRefusals = 4U;
+    xTCPSegmentStats.ulExhausted = 5U;
+
+    vTCPSegmentGetStats( &xStats );
+
+    TEST_ASSERT_EQUAL( ipconfigTCP_WIN_SEG_COUNT, xStats.uxCapacity );
+    TEST_ASSERT_EQUAL( 2U, xStats.uxAllocated );
+    TEST_ASSERT_EQUAL( 1U, xStats.uxInUse );
+    TEST_ASSERT_EQUAL( 2U, xStats.uxHighWater );
+    TEST_ASSERT_EQUAL( 3U, xStats.ulQuotaRefusals );
+    TEST_ASSERT_EQUAL( 4U, xStats.ulReserveRefusals );
+    TEST_ASSERT_EQUAL( 5U, xStats.ulExhausted );
+}
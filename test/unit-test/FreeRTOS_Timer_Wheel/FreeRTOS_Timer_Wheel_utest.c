@@ -0,0 +1,242 @@
+/*
+ * FreeRTOS+TCP <DEVELOPMENT BRANCH>
+ * Copyright (C) 2022 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * http://aws.amazon.com/freertos
+ * http://www.FreeRTOS.org
+ */
+
+
+/* Include Unity header */
+#include "unity.h"
+
+/* Include standard libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "mock_FreeRTOS_IP.h"
+#include "mock_task.h"
+#include "mock_queue.h"
+#include "mock_portable.h"
+
+#include "FreeRTOS_Timer_Wheel.h"
+
+#include "mock_list.h"
+
+#include "FreeRTOSIPConfig.h"
+
+/* ===========================  EXTERN VARIABLES  =========================== */
+
+/* The number of timers used in the tests with many timers. */
+#define TEST_TIMER_COUNT    64U
+
+static TimerWheel_t xWheel;
+static TimerWheelEntry_t xEntries[ TEST_TIMER_COUNT ];
+
+/* ============================  Unity Fixtures  ============================ */
+
+void setUp( void )
+{
+    memset( &xWheel, 0xA5, sizeof( xWheel ) );
+    memset( xEntries, 0, sizeof( xEntries ) );
+}
+
+/* ==============================  Test Cases  ============================== */
+
+/**
+ * @brief An empty wheel has no expired timers and does not need attention.
+ */
+void test_vTimerWheelInit_Empty( void )
+{
+    vTimerWheelInit( &xWheel, 1000U );
+
+    TEST_ASSERT_EQUAL( 0U, xWheel.uxCount );
+    TEST_ASSERT_EQUAL( portMAX_DELAY, xTimerWheelNextTimeout( &xWheel, 1000U ) );
+    TEST_ASSERT_NULL( pxTimerWheelNextExpired( &xWheel, 5000U ) );
+    TEST_ASSERT_EQUAL( 5000U, xWheel.xCurrentTime );
+}
+
+/**
+ * @brief A timer in the first level expires exactly at its expiry time.
+ */
+void test_pxTimerWheelNextExpired_ShortDelay( void )
+{
+    vTimerWheelInit( &xWheel, 100U );
+
+    vTimerWheelInsert( &xWheel, &( xEntries[ 0 ] ), 105U );
+
+    TEST_ASSERT_EQUAL( pdTRUE, xTimerWheelEntryIsActive( &( xEntries[ 0 ] ) ) );
+    TEST_ASSERT_EQUAL( 5U, xTimerWheelNextTimeout( &xWheel, 100U ) );
+    TEST_ASSERT_NULL( pxTimerWheelNextExpired( &xWheel, 104U ) );
+    TEST_ASSERT_EQUAL( 1U, xTimerWheelNextTimeout( &xWheel, 104U ) );
+    TEST_ASSERT_EQUAL_PTR( &( xEntries[ 0 ] ), pxTimerWheelNextExpired( &xWheel, 105U ) );
+    TEST_ASSERT_EQUAL( pdFALSE, xTimerWheelEntryIsActive( &( xEntries[ 0 ] ) ) );
+    TEST_ASSERT_NULL( pxTimerWheelNextExpired( &xWheel, 105U ) );
+    TEST_ASSERT_EQUAL( 0U, xWheel.uxCount );
+}
+
+/**
+ * @brief A timer that lies in the past expires at the next check.
+ */
+void test_vTimerWheelInsert_PastTime( void )
+{
+    vTimerWheelInit( &xWheel, 100U );
+
+    vTimerWheelInsert( &xWheel, &( xEntries[ 0 ] ), 90U );
+
+    TEST_ASSERT_EQUAL( 100U, xEntries[ 0 ].xExpiryTime );
+    TEST_ASSERT_EQUAL( 0U, xTimerWheelNextTimeout( &xWheel, 100U ) );
+    TEST_ASSERT_EQUAL_PTR( &( xEntries[ 0 ] ), pxTimerWheelNextExpired( &xWheel, 100U ) );
+}
+
+/**
+ * @brief A timer that is inserted again, is moved to its new expiry time.
+ */
+void test_vTimerWheelInsert_Reschedule( void )
+{
+    vTimerWheelInit( &xWheel, 0U );
+
+    vTimerWheelInsert( &xWheel, &( xEntries[ 0 ] ), 10U );
+    vTimerWheelInsert( &xWheel, &( xEntries[ 0 ] ), 3000U );
+
+    TEST_ASSERT_EQUAL( 1U, xWheel.uxCount );
+    TEST_ASSERT_NULL( pxTimerWheelNextExpired( &xWheel, 2999U ) );
+    TEST_ASSERT_EQUAL_PTR( &( xEntries[ 0 ] ), pxTimerWheelNextExpired( &xWheel, 3000U ) );
+}
+
+/**
+ * @brief A cancelled timer does not expire, cancelling it twice is harmless.
+ */
+void test_vTimerWheelRemove( void )
+{
+    vTimerWheelInit( &xWheel, 0U );
+
+    vTimerWheelInsert( &xWheel, &( xEntries[ 0 ] ), 20U );
+    vTimerWheelInsert( &xWheel, &( xEntries[ 1 ] ), 20U );
+
+    vTimerWheelRemove( &xWheel, &( xEntries[ 0 ] ) );
+    vTimerWheelRemove( &xWheel, &( xEntries[ 0 ] ) );
+
+    TEST_ASSERT_EQUAL( 1U, xWheel.uxCount );
+    TEST_ASSERT_EQUAL_PTR( &( xEntries[ 1 ] ), pxTimerWheelNextExpired( &xWheel, 20U ) );
+    TEST_ASSERT_NULL( pxTimerWheelNextExpired( &xWheel, 20U ) );
+
+    vTimerWheelRemove( &xWheel, &( xEntries[ 1 ] ) );
+    TEST_ASSERT_EQUAL( portMAX_DELAY, xTimerWheelNextTimeout( &xWheel, 20U ) );
+}
+
+/**
+ * @brief A long delay is stored in a higher level and cascaded down. The
+ *        wheel asks for attention before the timer expires, but not at every
+ *        tick, and the timer expires at the exact tick.
+ */
+void test_pxTimerWheelNextExpired_LongDelay( void )
+{
+    TickType_t xNow = 7U;
+    TickType_t xExpiry = 7U + 20000U;
+    TickType_t xNext;
+    UBaseType_t uxWakeUps = 0U;
+
+    vTimerWheelInit( &xWheel, xNow );
+    vTimerWheelInsert( &xWheel, &( xEntries[ 0 ] ), xExpiry );
+
+    for( ; ; )
+    {
+        xNext = xTimerWheelNextTimeout( &xWheel, xNow );
+        TEST_ASSERT_TRUE( xNext <= ( xExpiry - xNow ) );
+        xNow += xNext;
+        uxWakeUps++;
+
+        if( xNow == xExpiry )
+        {
+            break;
+        }
+
+        TEST_ASSERT_NULL( pxTimerWheelNextExpired( &xWheel, xNow ) );
+    }
+
+    TEST_ASSERT_EQUAL_PTR( &( xEntries[ 0 ] ), pxTimerWheelNextExpired( &xWheel, xNow ) );
+    TEST_ASSERT_TRUE( uxWakeUps <= ipTIMER_WHEEL_LEVELS );
+}
+
+/**
+ * @brief Timers expire in the order of their expiry time, also when the
+ *        tick count wraps around, and when the wheel is checked late.
+ */
+void test_pxTimerWheelNextExpired_Order_TickWrap( void )
+{
+    TickType_t xStart = portMAX_DELAY - 500U;
+    TickType_t xNow;
+    TickType_t xPrevious;
+    TimerWheelEntry_t * pxEntry;
+    UBaseType_t uxIndex;
+    UBaseType_t uxCount = 0U;
+
+    vTimerWheelInit( &xWheel, xStart );
+
+    for( uxIndex = 0U; uxIndex < TEST_TIMER_COUNT; uxIndex++ )
+    {
+        /* Spread the timers over the levels, and across the wrap. */
+        vTimerWheelInsert( &xWheel, &( xEntries[ uxIndex ] ), xStart + ( ( ( uxIndex * 7919U ) % 4096U ) + 1U ) );
+    }
+
+    xNow = xStart;
+    xPrevious = xStart;
+
+    while( uxCount < TEST_TIMER_COUNT )
+    {
+        xNow += 100U;
+
+        for( pxEntry = pxTimerWheelNextExpired( &xWheel, xNow );
+             pxEntry != NULL;
+             pxEntry = pxTimerWheelNextExpired( &xWheel, xNow ) )
+        {
+            /* Not early, and in order. */
+            TEST_ASSERT_TRUE( ( TickType_t ) ( xNow - pxEntry->xExpiryTime ) < 100U );
+            TEST_ASSERT_TRUE( ( TickType_t ) ( pxEntry->xExpiryTime - xPrevious ) < 0x80000000U );
+            xPrevious = pxEntry->xExpiryTime;
+            uxCount++;
+        }
+    }
+
+    TEST_ASSERT_EQUAL( 0U, xWheel.uxCount );
+}
+
+/**
+ * @brief An expired timer may be inserted again, it expires at the next check
+ *        when it is inserted at the current time.
+ */
+void test_pxTimerWheelNextExpired_Reinsert( void )
+{
+    vTimerWheelInit( &xWheel, 0U );
+
+    vTimerWheelInsert( &xWheel, &( xEntries[ 0 ] ), 40U );
+    TEST_ASSERT_EQUAL_PTR( &( xEntries[ 0 ] ), pxTimerWheelNextExpired( &xWheel, 50U ) );
+
+    vTimerWheelInsert( &xWheel, &( xEntries[ 0 ] ), 50U );
+    TEST_ASSERT_EQUAL_PTR( &( xEntries[ 0 ] ), pxTimerWheelNextExpired( &xWheel, 50U ) );
+
+    vTimerWheelInsert( &xWheel, &( xEntries[ 0 ] ), 51U );
+    TEST_ASSERT_NULL( pxTimerWheelNextExpired( &xWheel, 50U ) );
+    TEST_ASSERT_EQUAL( 1U, xTimerWheelNextTimeout( &xWheel, 50U ) );
+}
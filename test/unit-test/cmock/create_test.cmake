@@ -55,6 +55,55 @@ function(create_test test_name
             )
 endfunction()
 
+# Create a benchmark: a Unity executable in bin/benchmarks that is built
+# when UNITTEST_BENCHMARKS is ON, but not registered with CTest.
+function(create_benchmark benchmark_name
+                          benchmark_src
+                          link_list
+                          dep_list
+                          include_list)
+    set(mocks_dir "${CMAKE_CURRENT_BINARY_DIR}/mocks")
+    get_filename_component(benchmark_src_absolute ${benchmark_src} ABSOLUTE)
+    add_custom_command(OUTPUT ${benchmark_name}_runner.c
+                  COMMAND ruby
+                    ${CMOCK_DIR}/vendor/unity/auto/generate_test_runner.rb
+                    ${MODULE_ROOT_DIR}/test/unit-test/cmock/project.yml
+                    ${benchmark_src_absolute}
+                    ${benchmark_name}_runner.c
+                  DEPENDS ${benchmark_src}
+        )
+    add_executable(${benchmark_name} ${benchmark_src} ${benchmark_name}_runner.c)
+    set_target_properties(${benchmark_name} PROPERTIES
+            COMPILE_FLAG "-Wall -ggdb3"
+            RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}/bin/benchmarks"
+            INSTALL_RPATH_USE_LINK_PATH TRUE
+            LINK_FLAGS " \
+                -Wl,-rpath,${CMAKE_BINARY_DIR}/lib \
+                -Wl,-rpath,${CMAKE_CURRENT_BINARY_DIR}/lib"
+        )
+    target_include_directories(${benchmark_name} PUBLIC
+                               ${mocks_dir}
+                               ${include_list}
+        )
+
+    target_link_directories(${benchmark_name} PUBLIC
+                            ${CMAKE_CURRENT_BINARY_DIR}
+                            ${CMAKE_CURRENT_BINARY_DIR}/lib
+        )
+
+    # link all libraries sent through parameters
+    foreach(link IN LISTS link_list)
+        target_link_libraries(${benchmark_name} ${link})
+    endforeach()
+
+    # add dependency to all the dep_list parameter
+    foreach(dependency IN LISTS dep_list)
+        add_dependencies(${benchmark_name} ${dependency})
+        target_link_libraries(${benchmark_name} ${dependency})
+    endforeach()
+    target_link_libraries(${benchmark_name} -lgcov unity)
+endfunction()
+
 # Run the C preprocessor on target files.
 # Takes a CMAKE list of arguments to pass to the C compiler
 function(preprocess_mock_list mock_name file_list compiler_args)